@@ -9,6 +9,9 @@
 
 #include <fcntl.h>
 #include <stdio.h>
+#ifdef __linux__
+#include <linux/falloc.h>
+#endif
 #include <sys/dir.h>
 #include <sys/stat.h>
 #include <sys/syscall.h>
@@ -22,9 +25,11 @@
 #include <folly/File.h>
 #include <folly/FileUtil.h>
 #include <folly/fibers/EventBaseLoopController.h>
+#include <folly/hash/SpookyHashV2.h>
 #include <folly/json.h>
 #include <folly/system/ThreadName.h>
 
+#include "mcrouter/AsyncLogFormat.h"
 #include "mcrouter/CarbonRouterInstance.h"
 #include "mcrouter/McrouterLogFailure.h"
 #include "mcrouter/lib/fbi/cpp/util.h"
@@ -55,6 +60,13 @@ void closeFd(int fd) {
   }
 }
 
+/* Duplicate filter sizing: 2^20 bits (128KB) per generation with 4
+   probes keeps the false positive rate well under 1% for the entry
+   counts a single proxy spools within one file window. */
+constexpr uint64_t kDedupBits = 1ULL << 20;
+constexpr size_t kDedupWords = kDedupBits / 64;
+constexpr size_t kDedupProbes = 4;
+
 } // anonymous namespace
 
 bool AsyncLog::openFile() {
@@ -190,6 +202,21 @@ bool AsyncLog::openFile() {
     return false;
   }
 
+#ifdef FALLOC_FL_KEEP_SIZE
+  if (options_.use_asynclog_version3 && options_.asynclog_preallocate_kb > 0) {
+    // Best effort: reserve contiguous space up front so group-committed
+    // appends don't block on block allocation. KEEP_SIZE leaves the file
+    // size unchanged, so consumers tailing the spool never see zero fill.
+    if (fallocate(
+            fd,
+            FALLOC_FL_KEEP_SIZE,
+            0,
+            options_.asynclog_preallocate_kb * 1024) != 0) {
+      VLOG(1) << "asynclog fallocate failed: " << folly::errnoStr(errno);
+    }
+  }
+#endif
+
   file_ = createFile(fd);
   if (!file_) {
     MC_LOG_FAILURE(
@@ -203,6 +230,14 @@ bool AsyncLog::openFile() {
 
   spoolTime_ = now;
 
+  // Rotate the duplicate filter together with the spool file: entries in
+  // older files get replayed on their own schedule, so suppression only
+  // makes sense within roughly one file's worth of spooling.
+  if (!dedupCurrent_.empty()) {
+    dedupPrevious_ = std::move(dedupCurrent_);
+    dedupCurrent_.assign(kDedupWords, 0);
+  }
+
   VLOG(1) << "Opened async store for " << path;
 
   return true;
@@ -210,11 +245,62 @@ bool AsyncLog::openFile() {
 
 AsyncLog::AsyncLog(const McrouterOptions& options) : options_(options) {}
 
+AsyncLog::~AsyncLog() {
+  flushBinaryBuffer();
+}
+
+bool AsyncLog::isDuplicateDelete(
+    const AccessPoint& ap,
+    folly::StringPiece key,
+    folly::StringPiece poolName) {
+  if (dedupCurrent_.empty()) {
+    dedupCurrent_.assign(kDedupWords, 0);
+  }
+
+  const auto& host = ap.getHost();
+  uint64_t h1 = folly::hash::SpookyHashV2::Hash64(key.data(), key.size(), 0);
+  h1 = folly::hash::SpookyHashV2::Hash64(host.data(), host.size(), h1);
+  h1 = folly::hash::SpookyHashV2::Hash64(
+      poolName.data(), poolName.size(), h1 ^ ap.getPort());
+  const uint64_t h2 = folly::hash::SpookyHashV2::Hash64(&h1, sizeof(h1), h1);
+
+  bool inCurrent = true;
+  bool inPrevious = !dedupPrevious_.empty();
+  for (size_t i = 0; i < kDedupProbes; ++i) {
+    const uint64_t bit = (h1 + i * h2) % kDedupBits;
+    const size_t word = bit / 64;
+    const uint64_t mask = 1ULL << (bit % 64);
+    if (!(dedupCurrent_[word] & mask)) {
+      inCurrent = false;
+      dedupCurrent_[word] |= mask;
+    }
+    if (inPrevious && !(dedupPrevious_[word] & mask)) {
+      inPrevious = false;
+    }
+  }
+  return inCurrent || inPrevious;
+}
+
 /** Adds an asynchronous request to the event log. */
 void AsyncLog::writeDelete(
     const AccessPoint& ap,
     folly::StringPiece key,
     folly::StringPiece poolName) {
+  if (options_.asynclog_dedup_deletes && isDuplicateDelete(ap, key, poolName)) {
+    // Already spooled within this window; replaying the first entry
+    // deletes the key, so the repeat adds nothing but replay load.
+    return;
+  }
+
+  auto timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+
+  if (options_.use_asynclog_version3) {
+    writeDeleteBinary(ap, key, poolName, timestamp_ms);
+    return;
+  }
+
   dynamic json = dynamic::array;
   const auto& host = ap.getHost();
   const auto port = options_.asynclog_port_override == 0
@@ -254,9 +340,6 @@ void AsyncLog::writeDelete(
     jsonOut.push_back(kAsyncLogMagic);
   }
 
-  auto timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                          std::chrono::system_clock::now().time_since_epoch())
-                          .count();
   jsonOut.push_back(1e-3 * timestamp_ms);
 
   jsonOut.push_back(std::string("C"));
@@ -276,6 +359,63 @@ void AsyncLog::writeDelete(
   }
 }
 
+void AsyncLog::writeDeleteBinary(
+    const AccessPoint& ap,
+    folly::StringPiece key,
+    folly::StringPiece poolName,
+    uint64_t timestampMs) {
+  asynclog::Record record;
+  record.timestampMs = timestampMs;
+  record.port = options_.asynclog_port_override == 0
+      ? ap.getPort()
+      : options_.asynclog_port_override;
+  record.flavor = options_.flavor_name;
+  record.host = ap.getHost();
+  record.pool = poolName;
+  record.key = key;
+
+  if (bufferedRecords_ == 0) {
+    firstBufferedMs_ = timestampMs;
+  }
+  asynclog::appendRecord(record, buffer_);
+  ++bufferedRecords_;
+
+  if (bufferedRecords_ >= options_.asynclog_batch_size ||
+      timestampMs - firstBufferedMs_ >= options_.asynclog_flush_interval_ms) {
+    flushBinaryBuffer();
+  }
+}
+
+void AsyncLog::flushBinaryBuffer() {
+  if (buffer_.empty()) {
+    return;
+  }
+
+  if (!openFile()) {
+    MC_LOG_FAILURE(
+        options_,
+        memcache::failure::Category::kSystemError,
+        "asynclog_open() failed, dropping batch of {} spooled entries",
+        bufferedRecords_);
+  } else {
+    ssize_t size =
+        folly::writeFull(file_->fd(), buffer_.data(), buffer_.size());
+    if (size == -1 || size_t(size) < buffer_.size()) {
+      MC_LOG_FAILURE(
+          options_,
+          memcache::failure::Category::kSystemError,
+          "Error fully writing asynclog batch of {} entries",
+          bufferedRecords_);
+    }
+  }
+
+  // The batch is gone either way; this matches the JSON path, which also
+  // drops the entry it failed to write, and bounds memory if the spool
+  // stays broken.
+  buffer_.clear();
+  bufferedRecords_ = 0;
+}
+
 } // mcrouter
 } // memcache
 } // facebook
@@ -8,6 +8,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <folly/File.h>
 #include <folly/Range.h>
@@ -23,11 +25,14 @@ namespace mcrouter {
 class AsyncLog {
  public:
   explicit AsyncLog(const McrouterOptions& options);
+  ~AsyncLog();
 
   /**
    * Appends a 'delete' request entry to the asynclog.
-   * This call blocks until the entry is written to the file
-   * or an error occurs.
+   * With the JSON formats this call blocks until the entry is written to
+   * the file or an error occurs; with the version 3 binary format entries
+   * are group-committed, so the write may be deferred until the batch
+   * size or flush interval is reached.
    */
   void writeDelete(
       const AccessPoint& ap,
@@ -39,12 +44,58 @@ class AsyncLog {
   std::unique_ptr<folly::File> file_;
   time_t spoolTime_{0};
 
+  /**
+   * Group commit state for the version 3 binary format: encoded records
+   * accumulate here and are written with a single writeFull() once
+   * asynclog_batch_size entries are buffered or the oldest one is
+   * asynclog_flush_interval_ms old. Only touched by the owning proxy
+   * thread.
+   */
+  std::string buffer_;
+  size_t bufferedRecords_{0};
+  uint64_t firstBufferedMs_{0};
+
+  /**
+   * Two-generation bloom filter over (host, port, pool, key) used to
+   * suppress duplicate spool entries when asynclog_dedup_deletes is set.
+   * The current generation rotates with the spool file in openFile();
+   * the previous one is kept so suppression doesn't reset to zero right
+   * at a file boundary. Allocated lazily on first use.
+   */
+  std::vector<uint64_t> dedupCurrent_;
+  std::vector<uint64_t> dedupPrevious_;
+
+  /**
+   * @return true if an entry with the same destination, pool and key
+   * was already spooled within the current filter window. Inserts the
+   * entry into the current generation as a side effect.
+   */
+  bool isDuplicateDelete(
+      const AccessPoint& ap,
+      folly::StringPiece key,
+      folly::StringPiece poolName);
+
   /**
    * Open async log file.
    *
    * @return True if the file is ready to use. False otherwise.
    */
   bool openFile();
+
+  /**
+   * Append a version 3 binary record, flushing the batch if it's due.
+   */
+  void writeDeleteBinary(
+      const AccessPoint& ap,
+      folly::StringPiece key,
+      folly::StringPiece poolName,
+      uint64_t timestampMs);
+
+  /**
+   * Write all buffered binary records out. Drops them on write error
+   * (same contract as the JSON path, which drops the failing entry).
+   */
+  void flushBinaryBuffer();
 };
 }
 }
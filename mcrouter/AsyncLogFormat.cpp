@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2016-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include "AsyncLogFormat.h"
+
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#include <folly/Format.h>
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+namespace asynclog {
+
+namespace {
+
+template <class T>
+void appendInt(T value, std::string& out) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+T readInt(const char*& cursor) {
+  T value;
+  std::memcpy(&value, cursor, sizeof(T));
+  cursor += sizeof(T);
+  return value;
+}
+
+constexpr size_t kPayloadHeaderSize =
+    sizeof(uint64_t) /* timestampMs */ + 5 * sizeof(uint16_t);
+
+} // anonymous namespace
+
+void appendRecord(const Record& record, std::string& out) {
+  assert(record.flavor.size() <= std::numeric_limits<uint16_t>::max());
+  assert(record.host.size() <= std::numeric_limits<uint16_t>::max());
+  assert(record.pool.size() <= std::numeric_limits<uint16_t>::max());
+  assert(record.key.size() <= std::numeric_limits<uint16_t>::max());
+
+  const uint32_t payloadSize = kPayloadHeaderSize + record.flavor.size() +
+      record.host.size() + record.pool.size() + record.key.size();
+
+  out.reserve(out.size() + 2 * sizeof(uint32_t) + payloadSize);
+  appendInt(kVersion3Magic, out);
+  appendInt(payloadSize, out);
+  appendInt(record.timestampMs, out);
+  appendInt(record.port, out);
+  appendInt(static_cast<uint16_t>(record.flavor.size()), out);
+  appendInt(static_cast<uint16_t>(record.host.size()), out);
+  appendInt(static_cast<uint16_t>(record.pool.size()), out);
+  appendInt(static_cast<uint16_t>(record.key.size()), out);
+  out.append(record.flavor.data(), record.flavor.size());
+  out.append(record.host.data(), record.host.size());
+  out.append(record.pool.data(), record.pool.size());
+  out.append(record.key.data(), record.key.size());
+}
+
+bool decodeRecord(folly::StringPiece buf, Record& record, size_t& consumed) {
+  if (buf.size() < 2 * sizeof(uint32_t)) {
+    return false;
+  }
+  const char* cursor = buf.data();
+  if (readInt<uint32_t>(cursor) != kVersion3Magic) {
+    return false;
+  }
+  const auto payloadSize = readInt<uint32_t>(cursor);
+  if (payloadSize < kPayloadHeaderSize ||
+      buf.size() < 2 * sizeof(uint32_t) + payloadSize) {
+    return false;
+  }
+
+  record.timestampMs = readInt<uint64_t>(cursor);
+  record.port = readInt<uint16_t>(cursor);
+  const auto flavorLength = readInt<uint16_t>(cursor);
+  const auto hostLength = readInt<uint16_t>(cursor);
+  const auto poolLength = readInt<uint16_t>(cursor);
+  const auto keyLength = readInt<uint16_t>(cursor);
+  if (kPayloadHeaderSize + flavorLength + hostLength + poolLength + keyLength !=
+      payloadSize) {
+    return false;
+  }
+
+  record.flavor = folly::StringPiece(cursor, flavorLength);
+  cursor += flavorLength;
+  record.host = folly::StringPiece(cursor, hostLength);
+  cursor += hostLength;
+  record.pool = folly::StringPiece(cursor, poolLength);
+  cursor += poolLength;
+  record.key = folly::StringPiece(cursor, keyLength);
+
+  consumed = 2 * sizeof(uint32_t) + payloadSize;
+  return true;
+}
+
+folly::dynamic toDynamic(const Record& record) {
+  folly::dynamic json = folly::dynamic::object;
+  json["f"] = record.flavor;
+  json["h"] = folly::sformat("[{}]:{}", record.host, record.port);
+  json["p"] = record.pool;
+  json["k"] = record.key;
+
+  folly::dynamic line = folly::dynamic::array;
+  line.push_back("AS2.0");
+  line.push_back(1e-3 * record.timestampMs);
+  line.push_back("C");
+  line.push_back(std::move(json));
+  return line;
+}
+
+} // namespace asynclog
+} // namespace mcrouter
+} // namespace memcache
+} // namespace facebook
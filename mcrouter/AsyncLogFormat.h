@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2016-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <folly/Range.h>
+#include <folly/dynamic.h>
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+namespace asynclog {
+
+/**
+ * Binary asynclog spool format, version 3.
+ *
+ * Each record is length-prefixed:
+ *
+ *   uint32_t magic          kVersion3Magic
+ *   uint32_t payloadSize    bytes following this field
+ *   uint64_t timestampMs    wall clock, ms since epoch
+ *   uint16_t port
+ *   uint16_t flavorLength
+ *   uint16_t hostLength
+ *   uint16_t poolLength
+ *   uint16_t keyLength
+ *   char     flavor[], host[], pool[], key[]
+ *
+ * Integers are in host byte order: spool files are always consumed on
+ * the host that wrote them. Unlike the JSON formats there is no
+ * per-entry formatting cost, and the fixed prefix lets a reader skip or
+ * resynchronize on a truncated tail (the only kind of corruption a
+ * crashed writer can leave behind).
+ */
+constexpr uint32_t kVersion3Magic = 0x41533330; // "AS30"
+
+struct Record {
+  uint64_t timestampMs{0};
+  uint16_t port{0};
+  folly::StringPiece flavor;
+  folly::StringPiece host;
+  folly::StringPiece pool;
+  folly::StringPiece key;
+};
+
+/**
+ * Appends the binary encoding of the record to "out".
+ */
+void appendRecord(const Record& record, std::string& out);
+
+/**
+ * Decodes one record from the front of "buf". On success the string
+ * fields of "record" point into "buf", "consumed" is set to the full
+ * record size and true is returned. Returns false if "buf" does not
+ * start with a complete, well-formed record.
+ */
+bool decodeRecord(folly::StringPiece buf, Record& record, size_t& consumed);
+
+/**
+ * Converts a record to the asynclog version 2.0 JSON line layout
+ * (["AS2.0", ts, "C", {"f", "h", "p", "k"}]), so binary spools can be
+ * replayed through consumers that only understand the JSON formats.
+ */
+folly::dynamic toDynamic(const Record& record);
+
+} // namespace asynclog
+} // namespace mcrouter
+} // namespace memcache
+} // namespace facebook
@@ -7,6 +7,9 @@
  */
 #include "AsyncWriter.h"
 
+#include <stdexcept>
+
+#include <folly/Conv.h>
 #include <folly/Range.h>
 #include <folly/fibers/EventBaseLoopController.h>
 #include <folly/io/async/EventBase.h>
@@ -123,6 +126,29 @@ void AsyncWriter::makeQueueSizeUnlimited() {
   maxQueueSize_ = 0;
 }
 
+AsyncWriterPool::AsyncWriterPool(
+    size_t numWriters,
+    folly::StringPiece threadNamePrefix,
+    size_t maxQueueSize) {
+  assert(numWriters > 0);
+  writers_.reserve(numWriters);
+  for (size_t i = 0; i < numWriters; ++i) {
+    auto writer = std::make_unique<AsyncWriter>(maxQueueSize);
+    auto threadName = folly::to<std::string>(threadNamePrefix, i);
+    if (!writer->start(threadName)) {
+      throw std::runtime_error(folly::to<std::string>(
+          "Failed to spawn async writer thread ", threadName));
+    }
+    writers_.push_back(std::move(writer));
+  }
+}
+
+AsyncWriterPool::~AsyncWriterPool() {
+  for (auto& writer : writers_) {
+    writer->stop();
+  }
+}
+
 bool awriter_queue(AsyncWriter* w, awriter_entry_t* e) {
   return w->run([e, w]() {
     if (!w->isActive()) {
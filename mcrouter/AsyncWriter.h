@@ -13,6 +13,7 @@
 #include <functional>
 #include <memory>
 #include <thread>
+#include <vector>
 
 #include <folly/Range.h>
 #include <folly/fibers/FiberManager.h>
@@ -92,6 +93,49 @@ class AsyncWriter {
   std::thread thread_;
 };
 
+/**
+ * A small pool of AsyncWriter threads sharded by key. The same key always
+ * maps to the same writer, so writes to one spool file stay ordered,
+ * while independent spool files (e.g. different proxies') are written in
+ * parallel instead of serializing on a single thread.
+ */
+class AsyncWriterPool {
+ public:
+  /**
+   * Starts numWriters writer threads eagerly.
+   *
+   * @param numWriters        Number of writer threads, must be > 0.
+   * @param threadNamePrefix  Threads are named "<prefix>0".."<prefix>N-1"
+   *                          (truncated, if length is >15 characters).
+   * @param maxQueueSize      Per-writer queue limit, 0 means unlimited.
+   *
+   * @throws std::runtime_error  if a writer thread can not be started.
+   */
+  AsyncWriterPool(
+      size_t numWriters,
+      folly::StringPiece threadNamePrefix,
+      size_t maxQueueSize = 0);
+
+  /**
+   * Stops all writers and waits for the queued functions to finish.
+   */
+  ~AsyncWriterPool();
+
+  /**
+   * Returns the writer owning the given shard key.
+   */
+  AsyncWriter& writer(size_t shardKey) {
+    return *writers_[shardKey % writers_.size()];
+  }
+
+  size_t numWriters() const {
+    return writers_.size();
+  }
+
+ private:
+  std::vector<std::unique_ptr<AsyncWriter>> writers_;
+};
+
 /**
  * @return true on success, false otherwise
  */
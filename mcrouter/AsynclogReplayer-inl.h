@@ -0,0 +1,226 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <folly/FileUtil.h>
+#include <folly/synchronization/Baton.h>
+
+#include "mcrouter/AsyncLogFormat.h"
+#include "mcrouter/CarbonRouterInstance.h"
+#include "mcrouter/McrouterLogFailure.h"
+#include "mcrouter/TkoTracker.h"
+#include "mcrouter/options.h"
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+namespace detail {
+
+// Slack on top of the spool file rotation lifetime before a file is
+// considered closed and safe to consume.
+constexpr time_t kSpoolAgeSlackSec = 60;
+
+// How often to rescan the spool directory when it is empty.
+constexpr std::chrono::milliseconds kScanInterval{10000};
+
+// Replay pauses while the smoothed soft-error fraction of its own
+// replies is above this, and while paused the fraction decays by
+// kPauseDecay per kHealthPollInterval so replay can probe its way back.
+constexpr double kPauseSoftErrorFraction = 0.5;
+constexpr double kPauseDecay = 0.9;
+constexpr std::chrono::milliseconds kHealthPollInterval{1000};
+
+// Weight of each new reply in the smoothed soft-error fraction.
+constexpr double kSoftErrorSmoothing = 1.0 / 16;
+
+} // namespace detail
+
+template <class RouterInfo>
+AsynclogReplayer<RouterInfo>::AsynclogReplayer(
+    CarbonRouterInstance<RouterInfo>& router)
+    : router_(router) {}
+
+template <class RouterInfo>
+AsynclogReplayer<RouterInfo>::~AsynclogReplayer() {
+  stop();
+}
+
+template <class RouterInfo>
+void AsynclogReplayer<RouterInfo>::start() {
+  if (!carbon::ListContains<
+          typename RouterInfo::RoutableRequests,
+          McDeleteRequest>::value) {
+    MC_LOG_FAILURE(
+        router_.opts(),
+        failure::Category::kInvalidOption,
+        "asynclog-replay requires a router that can route McDeleteRequest");
+    return;
+  }
+  thread_ = std::thread([this]() { run(); });
+}
+
+template <class RouterInfo>
+void AsynclogReplayer<RouterInfo>::stop() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(stopMutex_);
+    stopped_ = true;
+  }
+  stopCv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+template <class RouterInfo>
+void AsynclogReplayer<RouterInfo>::run() {
+  client_ = router_.createClient(/* maximum_outstanding_requests */ 1);
+
+  while (!stopped_) {
+    auto files = detail::collectReplayableSpoolFiles(
+        router_.opts().async_spool,
+        DEFAULT_ASYNCLOG_LIFETIME + detail::kSpoolAgeSlackSec);
+    bool replayedAny = false;
+    for (const auto& file : files) {
+      if (stopped_) {
+        break;
+      }
+      if (undecodableFiles_.count(file)) {
+        continue;
+      }
+      replayedAny = replayFile(file) || replayedAny;
+    }
+    if (!replayedAny && !sleepFor(detail::kScanInterval)) {
+      break;
+    }
+  }
+
+  client_.reset();
+}
+
+template <class RouterInfo>
+bool AsynclogReplayer<RouterInfo>::replayFile(const std::string& path) {
+  std::string contents;
+  if (!folly::readFile(path.c_str(), contents)) {
+    VLOG(1) << "asynclog replay: can't read " << path;
+    undecodableFiles_.insert(path);
+    return false;
+  }
+
+  folly::StringPiece buf(contents);
+  asynclog::Record record;
+  size_t consumed = 0;
+  size_t replayed = 0;
+  while (asynclog::decodeRecord(buf, record, consumed)) {
+    if (!waitUntilHealthy(record.host)) {
+      return false;
+    }
+    const auto result = sendDelete(record.key);
+    ++replayed;
+
+    const double sample = detail::isReplaySoftError(result) ? 1.0 : 0.0;
+    softErrorFraction_ = softErrorFraction_ +
+        detail::kSoftErrorSmoothing * (sample - softErrorFraction_);
+
+    // Pace to the configured rate, scaled down by the soft-error level.
+    const double rate = std::max(
+        1.0, router_.opts().asynclog_replay_rate * (1.0 - softErrorFraction_));
+    if (!sleepFor(std::chrono::milliseconds(
+            static_cast<uint64_t>(1000.0 / rate)))) {
+      return false;
+    }
+    buf.advance(consumed);
+  }
+
+  if (replayed == 0 && !buf.empty()) {
+    // Not a version 3 spool (e.g. JSON format); leave it for external
+    // consumers and don't re-read it on every scan.
+    VLOG(1) << "asynclog replay: " << path << " is not a version 3 spool";
+    undecodableFiles_.insert(path);
+    return false;
+  }
+
+  if (!buf.empty()) {
+    // Truncated tail from a crashed writer; every complete record before
+    // it was replayed, so the file is done.
+    VLOG(1) << "asynclog replay: ignored " << buf.size()
+            << " trailing bytes of " << path;
+  }
+  VLOG(1) << "asynclog replay: replayed " << replayed << " deletes from "
+          << path;
+  if (::unlink(path.c_str()) != 0) {
+    MC_LOG_FAILURE(
+        router_.opts(),
+        failure::Category::kSystemError,
+        "asynclog replay: can't unlink replayed spool {}",
+        path);
+    undecodableFiles_.insert(path);
+  }
+  return true;
+}
+
+template <class RouterInfo>
+bool AsynclogReplayer<RouterInfo>::waitUntilHealthy(folly::StringPiece host) {
+  while (!stopped_) {
+    const auto health = router_.tkoTrackerMap().getServerHealth(host);
+    if (!health.first && softErrorFraction_ < detail::kPauseSoftErrorFraction) {
+      return true;
+    }
+    if (!sleepFor(detail::kHealthPollInterval)) {
+      return false;
+    }
+    softErrorFraction_ *= detail::kPauseDecay;
+  }
+  return false;
+}
+
+template <class RouterInfo>
+template <class RI>
+typename std::enable_if<
+    carbon::ListContains<typename RI::RoutableRequests, McDeleteRequest>::
+        value,
+    mc_res_t>::type
+AsynclogReplayer<RouterInfo>::sendDelete(folly::StringPiece key) {
+  McDeleteRequest req(key);
+  folly::Baton<> reply;
+  mc_res_t result = mc_res_unknown;
+  const bool scheduled = client_->send(
+      req, [&result, &reply](const McDeleteRequest&, McDeleteReply&& r) {
+        result = r.result();
+        reply.post();
+      });
+  if (!scheduled) {
+    return mc_res_local_error;
+  }
+  reply.wait();
+  return result;
+}
+
+template <class RouterInfo>
+template <class RI>
+typename std::enable_if<
+    !carbon::ListContains<typename RI::RoutableRequests, McDeleteRequest>::
+        value,
+    mc_res_t>::type
+AsynclogReplayer<RouterInfo>::sendDelete(folly::StringPiece /* key */) {
+  return mc_res_local_error;
+}
+
+template <class RouterInfo>
+bool AsynclogReplayer<RouterInfo>::sleepFor(
+    std::chrono::milliseconds duration) {
+  std::unique_lock<std::mutex> lock(stopMutex_);
+  return !stopCv_.wait_for(
+      lock, duration, [this]() { return stopped_.load(); });
+}
+
+} // namespace mcrouter
+} // namespace memcache
+} // namespace facebook
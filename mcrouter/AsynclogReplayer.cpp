@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include "AsynclogReplayer.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "mcrouter/lib/McResUtil.h"
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+namespace detail {
+
+namespace {
+
+void listDirectory(
+    const std::string& path,
+    std::vector<std::string>& names) {
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) {
+    return;
+  }
+  while (struct dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+    names.emplace_back(entry->d_name);
+  }
+  closedir(dir);
+}
+
+} // anonymous namespace
+
+std::vector<std::string> collectReplayableSpoolFiles(
+    const std::string& spoolPath,
+    time_t minAgeSec) {
+  const time_t cutoff = time(nullptr) - minAgeSec;
+
+  std::vector<std::string> hourDirs;
+  listDirectory(spoolPath, hourDirs);
+  // Directory and file names start with a timestamp, so a lexicographic
+  // sort replays oldest spools first.
+  std::sort(hourDirs.begin(), hourDirs.end());
+
+  std::vector<std::string> result;
+  for (const auto& hourDir : hourDirs) {
+    const auto dirPath = spoolPath + "/" + hourDir;
+    std::vector<std::string> files;
+    listDirectory(dirPath, files);
+    std::sort(files.begin(), files.end());
+    for (const auto& file : files) {
+      auto filePath = dirPath + "/" + file;
+      struct stat st;
+      if (stat(filePath.c_str(), &st) != 0 || !S_ISREG(st.st_mode) ||
+          st.st_mtime > cutoff) {
+        continue;
+      }
+      result.push_back(std::move(filePath));
+    }
+    if (files.empty()) {
+      // Fully drained hour window; best effort, fails while the writer
+      // still has its file open in there.
+      ::rmdir(dirPath.c_str());
+    }
+  }
+  return result;
+}
+
+bool isReplaySoftError(mc_res_t result) {
+  return isTkoResult(result) || isSoftTkoErrorResult(result) ||
+      isHardTkoErrorResult(result);
+}
+
+} // namespace detail
+} // namespace mcrouter
+} // namespace memcache
+} // namespace facebook
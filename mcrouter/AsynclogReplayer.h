@@ -0,0 +1,161 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <folly/Range.h>
+
+#include "mcrouter/CarbonRouterClient.h"
+#include "mcrouter/lib/carbon/TypeList.h"
+#include "mcrouter/lib/mc/msg.h"
+#include "mcrouter/lib/network/gen/Memcache.h"
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+template <class RouterInfo>
+class CarbonRouterInstance;
+
+namespace detail {
+
+/**
+ * Lists spool files under spoolPath (layout: spoolPath/<hour dir>/<file>,
+ * see AsyncLog::openFile()) whose mtime is at least minAgeSec old, oldest
+ * first.  The age floor keeps the replayer off files a proxy may still
+ * be appending to.
+ */
+std::vector<std::string> collectReplayableSpoolFiles(
+    const std::string& spoolPath,
+    time_t minAgeSec);
+
+/**
+ * @return true if the reply result indicates the destination is
+ * struggling (TKO or a soft/hard TKO error), i.e. replay should back off.
+ */
+bool isReplaySoftError(mc_res_t result);
+
+} // namespace detail
+
+/**
+ * Replays asynclog spool files through the router's own route tree.
+ *
+ * External replayers fight the router: when a destination recovers they
+ * slam it at full speed just as live traffic resumes, often re-TKOing
+ * it. This replayer cooperates instead. Deletes from version 3 binary
+ * spool files are routed through the normal route handles (so prefix
+ * routing, shadowing and rate limiting all apply), the pace is scaled by
+ * the live health of each record's destination as seen by the shared
+ * TkoTrackerMap, and replay pauses entirely while the destination is TKO
+ * or while the replay's own replies show rising soft errors.
+ *
+ * A file is unlinked only after every record in it was replayed; a
+ * restart mid-file replays some deletes twice, which is safe since
+ * deletes are idempotent. Files that do not decode as version 3 records
+ * (e.g. JSON format spools) are left in place for external consumers.
+ *
+ * Enabled with --asynclog-replay; runs one background thread, started
+ * from spawnAuxiliaryThreads().
+ */
+template <class RouterInfo>
+class AsynclogReplayer {
+ public:
+  explicit AsynclogReplayer(CarbonRouterInstance<RouterInfo>& router);
+  ~AsynclogReplayer();
+
+  AsynclogReplayer(const AsynclogReplayer&) = delete;
+  AsynclogReplayer& operator=(const AsynclogReplayer&) = delete;
+
+  void start();
+
+  /**
+   * Stops the replay thread and joins it. Blocks until the in-flight
+   * delete (at most one) completes. Safe to call multiple times.
+   */
+  void stop() noexcept;
+
+ private:
+  CarbonRouterInstance<RouterInfo>& router_;
+  typename CarbonRouterClient<RouterInfo>::Pointer client_;
+  std::thread thread_;
+
+  std::mutex stopMutex_;
+  std::condition_variable stopCv_;
+  std::atomic<bool> stopped_{false};
+
+  /**
+   * Exponentially smoothed fraction of replay replies that came back as
+   * soft errors; scales the replay rate down and pauses replay once it
+   * crosses the pause threshold. Decays while paused so replay can probe
+   * its way back in.
+   */
+  double softErrorFraction_{0.0};
+
+  /**
+   * Files that didn't decode as version 3 spools, so rescans skip them
+   * instead of re-reading them forever.
+   */
+  std::unordered_set<std::string> undecodableFiles_;
+
+  void run();
+
+  /**
+   * @return false if stopped before the whole file was replayed.
+   */
+  bool replayFile(const std::string& path);
+
+  /**
+   * Waits until the destination of the next record looks healthy enough
+   * to replay against (not TKO, soft errors below the pause threshold).
+   *
+   * @return false if stopped while waiting.
+   */
+  bool waitUntilHealthy(folly::StringPiece host);
+
+  /**
+   * Routes one delete for the key through the route tree and blocks for
+   * the reply. Only instantiated for routers that can route
+   * McDeleteRequest; enabling asynclog-replay on any other router fails
+   * at startup with a logged error.
+   */
+  template <class RI = RouterInfo>
+  typename std::enable_if<
+      carbon::ListContains<
+          typename RI::RoutableRequests,
+          McDeleteRequest>::value,
+      mc_res_t>::type
+  sendDelete(folly::StringPiece key);
+
+  template <class RI = RouterInfo>
+  typename std::enable_if<
+      !carbon::ListContains<
+          typename RI::RoutableRequests,
+          McDeleteRequest>::value,
+      mc_res_t>::type
+  sendDelete(folly::StringPiece key);
+
+  /**
+   * Sleeps for the given duration, waking early on stop().
+   *
+   * @return false if stopped.
+   */
+  bool sleepFor(std::chrono::milliseconds duration);
+};
+
+} // namespace mcrouter
+} // namespace memcache
+} // namespace facebook
+
+#include "mcrouter/AsynclogReplayer-inl.h"
@@ -5,6 +5,13 @@
  *  file in the root directory of this source tree.
  *
  */
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include <folly/small_vector.h>
+
 #include "mcrouter/CarbonRouterInstance.h"
 #include "mcrouter/ProxyRequestContextTyped.h"
 
@@ -95,10 +102,12 @@ bool CarbonRouterClient<RouterInfo>::send(
       detail::bumpCarbonRouterClientStats(stats_, request, reply);
       if (disconnected_) {
         // "Cancelled" reply.
-        cb(request, ReplyT<Request>(mc_res_unknown));
-      } else {
-        cb(request, std::move(reply));
+        reply = ReplyT<Request>(mc_res_unknown);
       }
+      postOrRun(
+          [&request, cb = std::move(cb), reply = std::move(reply)]() mutable {
+            cb(request, std::move(reply));
+          });
     });
 
     preq->setRequester(self_);
@@ -112,7 +121,12 @@ bool CarbonRouterClient<RouterInfo>::send(
     callback(req, ReplyT<Request>(mc_res_local_error));
   };
 
-  return sendMultiImpl(1, makePreq, cancelRemaining);
+  return sendMultiImpl(
+      1,
+      makePreq,
+      cancelRemaining,
+      carbon::HighPriority<Request>::value,
+      Request::typeId);
 }
 
 template <class RouterInfo>
@@ -120,7 +134,9 @@ template <class F, class G>
 bool CarbonRouterClient<RouterInfo>::sendMultiImpl(
     size_t nreqs,
     F&& makeNextPreq,
-    G&& failRemaining) {
+    G&& failRemaining,
+    bool highPriority,
+    uint32_t reqTypeId) {
   auto router = router_.lock();
   if (!router) {
     return false;
@@ -132,14 +148,13 @@ bool CarbonRouterClient<RouterInfo>::sendMultiImpl(
         sendSameThread(makeNextPreq());
       }
     } else {
-      for (size_t i = 0; i < nreqs; ++i) {
-        sendRemoteThread(makeNextPreq());
-      }
+      sendRemoteThreadBatch(nreqs, makeNextPreq, highPriority, reqTypeId);
     }
   } else if (maxOutstandingError()) {
     for (size_t begin = 0; begin < nreqs;) {
       auto end = begin +
-          counting_sem_lazy_nonblocking(outstandingReqsSem(), nreqs - begin);
+          counting_sem_sharded_lazy_nonblocking(
+              outstandingReqsSem(), nreqs - begin);
       if (begin == end) {
         failRemaining();
         break;
@@ -150,9 +165,8 @@ bool CarbonRouterClient<RouterInfo>::sendMultiImpl(
           sendSameThread(makeNextPreq());
         }
       } else {
-        for (size_t i = begin; i < end; i++) {
-          sendRemoteThread(makeNextPreq());
-        }
+        sendRemoteThreadBatch(
+            end - begin, makeNextPreq, highPriority, reqTypeId);
       }
 
       begin = end;
@@ -164,10 +178,8 @@ bool CarbonRouterClient<RouterInfo>::sendMultiImpl(
     size_t n = 0;
 
     while (i < nreqs) {
-      n += counting_sem_lazy_wait(outstandingReqsSem(), nreqs - n);
-      for (size_t j = i; j < n; ++j) {
-        sendRemoteThread(makeNextPreq());
-      }
+      n += counting_sem_sharded_lazy_wait(outstandingReqsSem(), nreqs - n);
+      sendRemoteThreadBatch(n - i, makeNextPreq, highPriority, reqTypeId);
       i = n;
     }
   }
@@ -195,10 +207,13 @@ bool CarbonRouterClient<RouterInfo>::send(
           detail::bumpCarbonRouterClientStats(stats_, request, reply);
           if (disconnected_) {
             // "Cancelled" reply.
-            callback(request, ReplyT<Request>(mc_res_unknown));
-          } else {
-            callback(request, std::move(reply));
+            reply = ReplyT<Request>(mc_res_unknown);
           }
+          postOrRun([
+            &request,
+            cb = std::move(callback),
+            reply = std::move(reply)
+          ]() mutable { cb(request, std::move(reply)); });
         });
 
     preq->setRequester(self_);
@@ -221,14 +236,125 @@ bool CarbonRouterClient<RouterInfo>::send(
   return sendMultiImpl(
       std::distance(begin, end),
       std::move(makeNextPreq),
-      std::move(cancelRemaining));
+      std::move(cancelRemaining),
+      carbon::HighPriority<Request>::value,
+      Request::typeId);
+}
+
+template <class RouterInfo>
+template <class InputIt, class F>
+bool CarbonRouterClient<RouterInfo>::sendBatch(
+    InputIt begin,
+    InputIt end,
+    F&& callback,
+    folly::StringPiece ipAddr) {
+  using IterReference = typename std::iterator_traits<InputIt>::reference;
+  using Request = typename std::decay<decltype(
+      detail::unwrapRequest(std::declval<IterReference>()))>::type;
+  using Callback = typename std::decay<F>::type;
+
+  const size_t nreqs = std::distance(begin, end);
+  if (nreqs == 0) {
+    callback(std::vector<ReplyT<Request>>());
+    return true;
+  }
+
+  /* Shared between the per-request completions; the last one to finish
+     (including cancellations) delivers the batch callback. */
+  struct BatchState {
+    BatchState(size_t n, Callback cb)
+        : replies(n), remaining(n), callback(std::move(cb)) {}
+    std::vector<ReplyT<Request>> replies;
+    std::atomic<size_t> remaining;
+    Callback callback;
+  };
+  auto state =
+      std::make_shared<BatchState>(nreqs, Callback(std::forward<F>(callback)));
+
+  size_t index = 0;
+  auto makeNextPreq = [this, ipAddr, state, &begin, &index]() {
+    auto preq = createProxyRequestContext(
+        *proxy_,
+        detail::unwrapRequest(*begin),
+        [this, state, i = index](
+            const Request& request, ReplyT<Request>&& reply) mutable {
+          detail::bumpCarbonRouterClientStats(stats_, request, reply);
+          state->replies[i] = disconnected_
+              ? ReplyT<Request>(mc_res_unknown) /* "Cancelled" reply */
+              : std::move(reply);
+          if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            postOrRun(
+                [state]() { state->callback(std::move(state->replies)); });
+          }
+        });
+
+    preq->setRequester(self_);
+    if (!ipAddr.empty()) {
+      preq->setUserIpAddress(ipAddr);
+    }
+
+    ++begin;
+    ++index;
+    return preq;
+  };
+
+  auto cancelRemaining = [state, &begin, &end, &index]() {
+    size_t canceled = 0;
+    while (begin != end) {
+      state->replies[index++] = ReplyT<Request>(mc_res_local_error);
+      ++begin;
+      ++canceled;
+    }
+    if (canceled > 0 &&
+        state->remaining.fetch_sub(canceled, std::memory_order_acq_rel) ==
+            canceled) {
+      state->callback(std::move(state->replies));
+    }
+  };
+
+  return sendMultiImpl(
+      nreqs,
+      std::move(makeNextPreq),
+      std::move(cancelRemaining),
+      carbon::HighPriority<Request>::value,
+      Request::typeId);
 }
 
 template <class RouterInfo>
 void CarbonRouterClient<RouterInfo>::sendRemoteThread(
-    std::unique_ptr<ProxyRequestContext> req) {
-  proxy_->messageQueue_->blockingWriteRelaxed(
-      ProxyMessage::Type::REQUEST, req.release());
+    std::unique_ptr<ProxyRequestContext> req,
+    bool highPriority,
+    uint32_t reqTypeId) {
+  if (highPriority) {
+    proxy_->messageQueue_->blockingWriteRelaxedHighPriority(
+        ProxyMessage::Type::REQUEST, req.release(), reqTypeId);
+  } else {
+    proxy_->messageQueue_->blockingWriteRelaxed(
+        ProxyMessage::Type::REQUEST, req.release(), reqTypeId);
+  }
+}
+
+template <class RouterInfo>
+template <class F>
+void CarbonRouterClient<RouterInfo>::sendRemoteThreadBatch(
+    size_t nreqs,
+    F&& makeNextPreq,
+    bool highPriority,
+    uint32_t reqTypeId) {
+  if (nreqs == 1) {
+    sendRemoteThread(makeNextPreq(), highPriority, reqTypeId);
+    return;
+  }
+  /* Collect the whole batch locally first, so the proxy message queue is
+     touched once and the proxy thread is woken up at most once. */
+  folly::small_vector<ProxyMessage, 8> batch;
+  batch.reserve(nreqs);
+  for (size_t i = 0; i < nreqs; ++i) {
+    batch.emplace_back(
+        ProxyMessage::Type::REQUEST, makeNextPreq().release(), reqTypeId);
+  }
+  proxy_->messageQueue_->blockingWriteBatchRelaxed(
+      batch.begin(), batch.end(), highPriority);
 }
 
 template <class RouterInfo>
@@ -237,6 +363,20 @@ void CarbonRouterClient<RouterInfo>::sendSameThread(
   proxy_->messageReady(ProxyMessage::Type::REQUEST, req.release());
 }
 
+template <class RouterInfo>
+template <class Fn>
+void CarbonRouterClient<RouterInfo>::postOrRun(Fn&& fn) {
+  if (completionQueue_ == nullptr) {
+    fn();
+    return;
+  }
+  folly::Function<void()> task(std::forward<Fn>(fn));
+  if (!completionQueue_->post(task)) {
+    /* Ring full: run the completion in place rather than blocking. */
+    task();
+  }
+}
+
 template <class RouterInfo>
 CarbonRouterClient<RouterInfo>::CarbonRouterClient(
     std::weak_ptr<CarbonRouterInstance<RouterInfo>> rtr,
@@ -7,7 +7,11 @@
  */
 #pragma once
 
+#include <limits>
+
+#include <folly/Function.h>
 #include <folly/IntrusiveList.h>
+#include <folly/ProducerConsumerQueue.h>
 #include <folly/Range.h>
 
 #include "mcrouter/CarbonRouterClientBase.h"
@@ -27,6 +31,51 @@ class Proxy;
 
 class ProxyRequestContext;
 
+/**
+ * Caller-owned SPSC ring of pending request completions.
+ *
+ * When attached to a CarbonRouterClient, reply callbacks are not invoked
+ * on the proxy thread; the proxy thread instead enqueues the completion
+ * here and the caller runs it from drain() at its convenience. The queue
+ * is single-producer/single-consumer: a client is pinned to one proxy
+ * thread (the producer), and the caller must drain from one thread.
+ *
+ * If the ring is full the completion runs inline on the proxy thread,
+ * degrading to the regular callback behavior instead of blocking the
+ * proxy. Size the ring for the expected number of outstanding requests.
+ */
+class ClientCompletionQueue {
+ public:
+  explicit ClientCompletionQueue(size_t capacity) : queue_(capacity) {}
+
+  /**
+   * Runs up to 'max' pending completions on the calling thread.
+   *
+   * @return number of completions run; 0 if the queue was empty.
+   */
+  size_t drain(size_t max = std::numeric_limits<size_t>::max()) {
+    size_t ndrained = 0;
+    folly::Function<void()> fn;
+    while (ndrained < max && queue_.read(fn)) {
+      fn();
+      ++ndrained;
+    }
+    return ndrained;
+  }
+
+ private:
+  template <class RouterInfo>
+  friend class CarbonRouterClient;
+
+  /* Leaves 'fn' intact when the ring is full, so the producer can still
+     run it inline. */
+  bool post(folly::Function<void()>& fn) {
+    return queue_.write(std::move(fn));
+  }
+
+  folly::ProducerConsumerQueue<folly::Function<void()>> queue_;
+};
+
 /**
  * A mcrouter client is used to communicate with a mcrouter instance.
  * Typically a client is long lived. Request sent through a single client
@@ -105,6 +154,28 @@ class CarbonRouterClient : public CarbonRouterClientBase {
       F&& callback,
       folly::StringPiece ipAddr = folly::StringPiece());
 
+  /**
+   * Batch version of send with a single completion callback.
+   * All requests are routed concurrently; 'callback' is called exactly
+   * once, after the last request completes, with replies in request
+   * order. It should be callable
+   *   f(std::vector<ReplyT<Request>>&& replies)
+   *
+   * A reply with result mc_res_unknown means the request was canceled.
+   *
+   * @return true iff the requests were scheduled for sending,
+   *         false otherwise (e.g. CarbonRouterInstance was destroyed).
+   *
+   * Note: the caller is responsible for keeping requests alive until the
+   *       callback is called.
+   */
+  template <class InputIt, class F>
+  bool sendBatch(
+      InputIt begin,
+      InputIt end,
+      F&& callback,
+      folly::StringPiece ipAddr = folly::StringPiece());
+
   CacheClientCounters getStatCounters() noexcept {
     return stats_.getCounters();
   }
@@ -116,6 +187,20 @@ class CarbonRouterClient : public CarbonRouterClientBase {
     proxy_ = proxy;
   }
 
+  /**
+   * Deliver completions through 'queue' instead of invoking callbacks on
+   * the proxy thread; see ClientCompletionQueue. Requests still execute
+   * on the proxy thread, so this gets caller-thread callbacks without
+   * the inline routing cost of sameThread mode.
+   *
+   * Must be called before any sends. The queue is caller-owned and must
+   * outlive both the client and all outstanding requests; the caller
+   * must keep draining it until all outstanding requests completed.
+   */
+  void setCompletionQueue(ClientCompletionQueue* queue) {
+    completionQueue_ = queue;
+  }
+
   CarbonRouterClient(const CarbonRouterClient<RouterInfo>&) = delete;
   CarbonRouterClient(CarbonRouterClient<RouterInfo>&&) noexcept = delete;
   CarbonRouterClient& operator=(const CarbonRouterClient<RouterInfo>&) = delete;
@@ -129,6 +214,12 @@ class CarbonRouterClient : public CarbonRouterClientBase {
 
   Proxy<RouterInfo>* proxy_{nullptr};
 
+  /**
+   * If set, completions are posted here by the proxy thread instead of
+   * running the user callback in place.
+   */
+  ClientCompletionQueue* completionQueue_{nullptr};
+
   CacheClientStats stats_;
 
   /**
@@ -161,13 +252,46 @@ class CarbonRouterClient : public CarbonRouterClientBase {
    * @param makeNextPreq   proxy request generator.
    * @param failRemaining  will be called if all remaining requests should be
    *                       canceled due to maxOutstandingError_ flag
+   * @param highPriority   route the requests through the proxy queue's
+   *                       high-priority lane (see carbon::HighPriority).
+   * @param reqTypeId      carbon type id of the requests, recorded on the
+   *                       proxy messages for dispatch grouping.
    */
   template <class F, class G>
-  bool sendMultiImpl(size_t nreqs, F&& makeNextPreq, G&& failRemaining);
+  bool sendMultiImpl(
+      size_t nreqs,
+      F&& makeNextPreq,
+      G&& failRemaining,
+      bool highPriority,
+      uint32_t reqTypeId);
+
+  void sendRemoteThread(
+      std::unique_ptr<ProxyRequestContext> req,
+      bool highPriority,
+      uint32_t reqTypeId);
+
+  /**
+   * Enqueue a batch of proxy requests onto the proxy thread with a single
+   * cross-thread notification.
+   *
+   * @param makeNextPreq  proxy request generator, called nreqs times.
+   */
+  template <class F>
+  void sendRemoteThreadBatch(
+      size_t nreqs,
+      F&& makeNextPreq,
+      bool highPriority,
+      uint32_t reqTypeId);
 
-  void sendRemoteThread(std::unique_ptr<ProxyRequestContext> req);
   void sendSameThread(std::unique_ptr<ProxyRequestContext> req);
 
+  /**
+   * Runs 'fn' through the completion queue if one is attached (falling
+   * back to inline execution when the ring is full), inline otherwise.
+   */
+  template <class Fn>
+  void postOrRun(Fn&& fn);
+
   friend class CarbonRouterInstance<RouterInfo>;
 };
 
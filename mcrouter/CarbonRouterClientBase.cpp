@@ -22,7 +22,7 @@ CarbonRouterClientBase::CarbonRouterClientBase(
   clientId_ = nextClientId++;
 
   if (maxOutstanding_ != 0) {
-    counting_sem_init(&outstandingReqsSem_, maxOutstanding_);
+    counting_sem_sharded_init(&outstandingReqsSem_, maxOutstanding_);
   }
 }
 }
@@ -45,7 +45,7 @@ class CarbonRouterClientBase {
     return maxOutstandingError_;
   }
 
-  counting_sem_t* outstandingReqsSem() {
+  counting_sem_sharded_t* outstandingReqsSem() {
     return &outstandingReqsSem_;
   }
 
@@ -61,7 +61,7 @@ class CarbonRouterClientBase {
   /// If true, error is immediately returned when maxOutstanding_ limit is hit
   /// If false, sender thread is blocked when maxOutstanding_ limit is hit
   const bool maxOutstandingError_;
-  counting_sem_t outstandingReqsSem_;
+  counting_sem_sharded_t outstandingReqsSem_;
 };
 
 } // mcrouter
@@ -10,10 +10,14 @@
 #include <boost/filesystem/operations.hpp>
 
 #include <folly/DynamicConverter.h>
+#include <folly/ExceptionWrapper.h>
 #include <folly/MapUtil.h>
+#include <folly/Optional.h>
 #include <folly/Singleton.h>
 #include <folly/fibers/FiberManager.h>
 #include <folly/io/async/EventBase.h>
+#include <folly/json.h>
+#include <folly/synchronization/Baton.h>
 
 #include "mcrouter/AsyncWriter.h"
 #include "mcrouter/CarbonRouterInstanceBase.h"
@@ -26,6 +30,9 @@
 #include "mcrouter/RuntimeVarsData.h"
 #include "mcrouter/ServiceInfo.h"
 #include "mcrouter/ThreadUtil.h"
+#include "mcrouter/flavor.h"
+#include "mcrouter/lib/AuxiliaryCPUThreadPool.h"
+#include "mcrouter/lib/fbi/cpp/util.h"
 #include "mcrouter/stats.h"
 
 namespace facebook {
@@ -252,31 +259,34 @@ CarbonRouterInstance<RouterInfo>::spinUp(
   {
     std::lock_guard<std::mutex> lg(configReconfigLock_);
 
-    auto builder = createConfigBuilder();
-    if (builder.hasError()) {
-      std::string initialError = std::move(builder.error());
-      // If we cannot create ConfigBuilder from normal config,
-      // try creating it from backup files.
-      configApi_->enableReadingFromBackupFiles();
-      configuringFromDisk = true;
-      builder = createConfigBuilder();
-      if (builder.hasError()) {
-        return folly::makeUnexpected(folly::sformat(
-            "Failed to configure, initial error '{}', from backup '{}'",
-            initialError,
-            builder.error()));
-      }
+    // Overlap config fetch/preprocess with spinning up the proxy threads:
+    // createConfigBuilder() only touches ConfigApi and options, while the
+    // spawn loop below only touches proxy state. We hold configReconfigLock_
+    // throughout, so no other config activity can race with the task.
+    folly::Optional<folly::Expected<ProxyConfigBuilder, std::string>>
+        builderResult;
+    folly::Baton<> builderReady;
+    auto buildConfigFn = [this, &builderResult, &builderReady]() {
+      builderResult.emplace(createConfigBuilder());
+      builderReady.post();
+    };
+    if (auto threadPool = AuxiliaryCPUThreadPoolSingleton::try_get()) {
+      threadPool->getThreadPool().add(buildConfigFn);
+    } else {
+      buildConfigFn();
     }
 
     VLOG(2) << "spinning up proxy threads";
-    for (size_t i = 0; i < opts_.num_proxies; i++) {
+    std::string spawnError;
+    for (size_t i = 0; i < opts_.num_proxies && spawnError.empty(); i++) {
       if (evbs.empty()) {
         try {
           proxyThreads_.emplace_back(std::make_unique<ProxyThread>(*this, i));
         } catch (...) {
-          return folly::makeUnexpected(folly::sformat(
+          spawnError = folly::sformat(
               "Failed to start proxy thread: {}",
-              folly::exceptionStr(std::current_exception())));
+              folly::exceptionStr(std::current_exception()));
+          break;
         }
         proxyEvbs_.push_back(std::make_unique<folly::VirtualEventBase>(
             proxyThreads_.back()->getEventBase()));
@@ -290,9 +300,31 @@ CarbonRouterInstance<RouterInfo>::spinUp(
         proxies_.emplace_back(
             Proxy<RouterInfo>::createProxy(*this, *proxyEvbs_[i], i));
       } catch (...) {
-        return folly::makeUnexpected(folly::sformat(
+        spawnError = folly::sformat(
             "Failed to create proxy: {}",
-            folly::exceptionStr(std::current_exception())));
+            folly::exceptionStr(std::current_exception()));
+      }
+    }
+
+    // The background task captures locals, so join it before any return.
+    builderReady.wait();
+    if (!spawnError.empty()) {
+      return folly::makeUnexpected(std::move(spawnError));
+    }
+
+    auto builder = std::move(builderResult).value();
+    if (builder.hasError()) {
+      std::string initialError = std::move(builder.error());
+      // If we cannot create ConfigBuilder from normal config,
+      // try creating it from backup files.
+      configApi_->enableReadingFromBackupFiles();
+      configuringFromDisk = true;
+      builder = createConfigBuilder();
+      if (builder.hasError()) {
+        return folly::makeUnexpected(folly::sformat(
+            "Failed to configure, initial error '{}', from backup '{}'",
+            initialError,
+            builder.error()));
       }
     }
 
@@ -351,6 +383,10 @@ CarbonRouterInstance<RouterInfo>::CarbonRouterInstance(
 template <class RouterInfo>
 void CarbonRouterInstance<RouterInfo>::shutdownImpl() noexcept {
   joinAuxiliaryThreads();
+  // Old configs may still be getting torn down on the auxiliary CPU pool;
+  // those tasks reference proxies, so let them finish before we destroy
+  // the proxy event bases.
+  waitForPendingConfigReclamations();
   // Join all proxy threads
   proxyEvbs_.clear();
   for (auto& pt : proxyThreads_) {
@@ -398,9 +434,16 @@ void CarbonRouterInstance<RouterInfo>::spawnAuxiliaryThreads() {
   subscribeToConfigUpdate();
 
   startObservingRuntimeVarsFile();
+  startObservingFlavorFile();
   registerOnUpdateCallbackForRxmits();
   registerForStatsUpdates();
+  registerForElasticProxyUpdates();
   spawnStatLoggerThread();
+
+  if (opts_.asynclog_replay && !opts_.asynclog_disable) {
+    asynclogReplayer_ = std::make_unique<AsynclogReplayer<RouterInfo>>(*this);
+    asynclogReplayer_->start();
+  }
 }
 
 template <class RouterInfo>
@@ -443,6 +486,50 @@ void CarbonRouterInstance<RouterInfo>::startObservingRuntimeVarsFile() {
   }
 }
 
+template <class RouterInfo>
+void CarbonRouterInstance<RouterInfo>::startObservingFlavorFile() {
+  if (opts_.flavor_name.empty()) {
+    return;
+  }
+
+  boost::system::error_code ec;
+  if (!boost::filesystem::exists(opts_.flavor_name, ec)) {
+    return;
+  }
+
+  auto onUpdate = [this](std::string data) {
+    std::unordered_map<std::string, std::string> newOpts;
+    try {
+      auto json = parseJsonString(folly::json::stripComments(data));
+      if (!parse_json_options(json, "options", newOpts)) {
+        return;
+      }
+    } catch (const std::exception& e) {
+      MC_LOG_FAILURE(
+          opts(),
+          failure::Category::kInvalidConfig,
+          "Ignoring invalid flavor file update: {}",
+          e.what());
+      return;
+    }
+    applyRuntimeMutableOptions(newOpts);
+  };
+
+  if (auto scheduler = functionScheduler()) {
+    flavorObserverHandle_ = startObservingFile(
+        opts_.flavor_name,
+        scheduler,
+        std::chrono::milliseconds(opts_.file_observer_poll_period_ms),
+        std::chrono::milliseconds(opts_.file_observer_sleep_before_update_ms),
+        std::move(onUpdate));
+  } else {
+    MC_LOG_FAILURE(
+        opts(),
+        failure::Category::kSystemError,
+        "Global function scheduler not available");
+  }
+}
+
 template <class RouterInfo>
 void CarbonRouterInstance<RouterInfo>::spawnStatLoggerThread() {
   mcrouterLogger_ = createMcrouterLogger(*this);
@@ -458,12 +545,20 @@ void CarbonRouterInstance<RouterInfo>::joinAuxiliaryThreads() noexcept {
   }
 
   deregisterForStatsUpdates();
+  deregisterForElasticProxyUpdates();
+
+  // The replayer sends requests through the proxies, so it must be
+  // stopped before the proxy threads are joined.
+  if (asynclogReplayer_) {
+    asynclogReplayer_->stop();
+  }
 
   if (mcrouterLogger_) {
     mcrouterLogger_->stop();
   }
 
   runtimeVarsObserverHandle_.reset();
+  flavorObserverHandle_.reset();
 }
 
 template <class RouterInfo>
@@ -485,16 +580,50 @@ template <class RouterInfo>
 folly::Expected<folly::Unit, std::string>
 CarbonRouterInstance<RouterInfo>::configure(const ProxyConfigBuilder& builder) {
   VLOG_IF(0, !opts_.constantly_reload_configs) << "started reconfiguring";
-  std::vector<std::shared_ptr<ProxyConfig<RouterInfo>>> newConfigs;
-  try {
+  std::vector<std::shared_ptr<ProxyConfig<RouterInfo>>> newConfigs(
+      opts_.num_proxies);
+  std::vector<folly::exception_wrapper> buildErrors(opts_.num_proxies);
+  auto threadPool = AuxiliaryCPUThreadPoolSingleton::try_get();
+  if (opts_.num_proxies > 1 && threadPool) {
+    // Each proxy builds an independent route handle tree, so the per-proxy
+    // builds can run in parallel. The only state they share is the builder's
+    // PoolFactory, which serializes parsePool() internally.
+    std::atomic<size_t> remaining(opts_.num_proxies);
+    folly::Baton<> done;
     for (size_t i = 0; i < opts_.num_proxies; i++) {
-      newConfigs.push_back(builder.buildConfig<RouterInfo>(*getProxy(i)));
+      threadPool->getThreadPool().add(
+          [this, &builder, &newConfigs, &buildErrors, &remaining, &done, i]() {
+            try {
+              newConfigs[i] = builder.buildConfig<RouterInfo>(*getProxy(i));
+            } catch (const std::exception& e) {
+              buildErrors[i] = folly::exception_wrapper(
+                  std::current_exception(), e);
+            }
+            if (remaining.fetch_sub(1) == 1) {
+              done.post();
+            }
+          });
     }
-  } catch (const std::exception& e) {
-    std::string error = folly::sformat("Failed to reconfigure: {}", e.what());
-    MC_LOG_FAILURE(opts(), failure::Category::kInvalidConfig, error);
+    done.wait();
+  } else {
+    for (size_t i = 0; i < opts_.num_proxies; i++) {
+      try {
+        newConfigs[i] = builder.buildConfig<RouterInfo>(*getProxy(i));
+      } catch (const std::exception& e) {
+        buildErrors[i] =
+            folly::exception_wrapper(std::current_exception(), e);
+        break;
+      }
+    }
+  }
+  for (const auto& ew : buildErrors) {
+    if (ew) {
+      std::string error =
+          folly::sformat("Failed to reconfigure: {}", ew.what());
+      MC_LOG_FAILURE(opts(), failure::Category::kInvalidConfig, error);
 
-    return folly::makeUnexpected(std::move(error));
+      return folly::makeUnexpected(std::move(error));
+    }
   }
 
   for (size_t i = 0; i < opts_.num_proxies; i++) {
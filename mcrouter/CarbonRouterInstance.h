@@ -17,6 +17,7 @@
 
 #include <folly/Range.h>
 
+#include "mcrouter/AsynclogReplayer.h"
 #include "mcrouter/CallbackPool.h"
 #include "mcrouter/CarbonRouterClient.h"
 #include "mcrouter/CarbonRouterInstanceBase.h"
@@ -153,9 +154,16 @@ class CarbonRouterInstance
    */
   std::unique_ptr<McrouterLogger> mcrouterLogger_;
 
+  /**
+   * Replays asynclog spool files through the route tree when
+   * opts_.asynclog_replay is set.
+   */
+  std::unique_ptr<AsynclogReplayer<RouterInfo>> asynclogReplayer_;
+
   std::atomic<bool> shutdownStarted_{false};
 
   FileObserverHandle runtimeVarsObserverHandle_;
+  FileObserverHandle flavorObserverHandle_;
 
   ConfigApi::CallbackHandle configUpdateHandle_;
 
@@ -196,6 +204,13 @@ class CarbonRouterInstance
   void spawnStatLoggerThread();
   void startObservingRuntimeVarsFile();
 
+  /**
+   * Watches the flavor file this instance was started from (if any) and
+   * applies runtime-mutable option changes in place, so scalar knobs like
+   * timeouts and rate limits can be bumped without a restart.
+   */
+  void startObservingFlavorFile();
+
   folly::Expected<folly::Unit, std::string> configure(
       const ProxyConfigBuilder& builder);
   /** (re)configure the router. true on success, false on error.
@@ -7,6 +7,8 @@
  */
 #include "CarbonRouterInstanceBase.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 
 #include <boost/filesystem/operations.hpp>
@@ -15,6 +17,7 @@
 #include <folly/system/ThreadName.h>
 
 #include "mcrouter/AsyncWriter.h"
+#include "mcrouter/McrouterLogFailure.h"
 #include "mcrouter/ProxyBase.h"
 #include "mcrouter/lib/CompressionCodecManager.h"
 #include "mcrouter/lib/fbi/cpp/util.h"
@@ -49,13 +52,15 @@ folly::Singleton<AsyncWriter, CarbonRouterLoggingAsyncWriter>
     });
 
 struct CarbonRouterAsyncWriter {};
-folly::Singleton<AsyncWriter, CarbonRouterAsyncWriter> sharedAsyncWriter([]() {
-  auto writer = std::make_unique<AsyncWriter>();
-  if (!writer->start("mcrtr-awriter")) {
-    throw std::runtime_error("Failed to spawn mcrouter awriter thread");
-  }
-  return writer.release();
-});
+// Each proxy spools to its own file, so sharding the writers by proxy id
+// lets separate spool files be written in parallel during failover
+// storms while keeping each file single-writer. The writers spend their
+// time blocked in write(), so a few threads go a long way.
+constexpr size_t kAsyncWriterPoolSize = 4;
+folly::Singleton<AsyncWriterPool, CarbonRouterAsyncWriter>
+    sharedAsyncWriterPool([]() {
+      return new AsyncWriterPool(kAsyncWriterPoolSize, "mcrtr-awriter");
+    });
 
 std::string statsUpdateFunctionName(folly::StringPiece routerName) {
   static std::atomic<uint64_t> uniqueId(0);
@@ -63,6 +68,18 @@ std::string statsUpdateFunctionName(folly::StringPiece routerName) {
       "carbon-stats-update-fn-", routerName, "-", uniqueId.fetch_add(1));
 }
 
+std::string elasticProxyFunctionName(folly::StringPiece routerName) {
+  static std::atomic<uint64_t> uniqueId(0);
+  return folly::to<std::string>(
+      "carbon-elastic-proxy-fn-", routerName, "-", uniqueId.fetch_add(1));
+}
+
+/* Elastic proxy scaling cadence: unpark reacts after one evaluation
+   (tens of milliseconds), park only after a full second of sustained
+   low load so short lulls don't cause flapping. */
+constexpr std::chrono::milliseconds kElasticProxyInterval{50};
+constexpr size_t kElasticProxyParkStreak = 20;
+
 McrouterOptions finalizeOpts(McrouterOptions&& opts) {
   facebook::memcache::mcrouter::finalizeOptions(opts);
   return std::move(opts);
@@ -76,6 +93,9 @@ CarbonRouterInstanceBase::CarbonRouterInstanceBase(McrouterOptions inputOptions)
       configApi_(createConfigApi(opts_)),
       rtVarsData_(std::make_shared<ObservableRuntimeVars>()),
       leaseTokenMap_(globalFunctionScheduler.try_get()),
+      activeProxies_(opts_.num_proxies),
+      elasticProxyFunctionHandle_(
+          elasticProxyFunctionName(opts_.router_name)),
       statsUpdateFunctionHandle_(statsUpdateFunctionName(opts_.router_name)) {
   if (auto statsLogger = statsLogWriter()) {
     if (opts_.stats_async_queue_length) {
@@ -107,6 +127,40 @@ CarbonRouterInstanceBase::CarbonRouterInstanceBase(McrouterOptions inputOptions)
   }
 }
 
+void CarbonRouterInstanceBase::applyRuntimeMutableOptions(
+    const std::unordered_map<std::string, std::string>& newOpts) {
+  const auto current = opts_.toDict();
+  std::unordered_map<std::string, std::string> deltas;
+  for (const auto& kv : newOpts) {
+    if (!McrouterOptionsBase::isRuntimeMutable(kv.first)) {
+      continue;
+    }
+    auto it = current.find(kv.first);
+    if (it != current.end() && it->second != kv.second) {
+      deltas.insert(kv);
+    }
+  }
+  if (deltas.empty()) {
+    return;
+  }
+
+  auto errors = opts_.updateRuntimeMutableFromDict(deltas);
+  for (const auto& e : errors) {
+    MC_LOG_FAILURE(
+        opts_,
+        failure::Category::kInvalidOption,
+        "Runtime option update rejected: {}={} ({})",
+        e.requestedName,
+        e.requestedValue,
+        e.errorMsg);
+    deltas.erase(e.requestedName);
+  }
+  for (const auto& kv : deltas) {
+    LOG(INFO) << "Runtime option updated: " << kv.first << ": "
+              << current.at(kv.first) << " -> " << kv.second;
+  }
+}
+
 void CarbonRouterInstanceBase::setUpCompressionDictionaries(
     std::unordered_map<uint32_t, CodecConfigPtr>&& codecConfigs) noexcept {
   if (codecConfigs.empty() || compressionCodecManager_ != nullptr) {
@@ -136,12 +190,120 @@ CarbonRouterInstanceBase::getStartupOpts() const {
 
 size_t CarbonRouterInstanceBase::nextProxyIndex() {
   std::lock_guard<std::mutex> guard(nextProxyMutex_);
-  assert(nextProxy_ < opts().num_proxies);
+  // Parked proxies (elastic scaling) are excluded from placement; they
+  // occupy the tail of the index range.
+  const size_t numActive =
+      std::min<size_t>(activeProxyCount(), opts().num_proxies);
+  assert(numActive >= 1);
+  if (nextProxy_ >= numActive) {
+    nextProxy_ = 0;
+  }
+  // Prefer the proxy with the fewest requests in flight, so a client
+  // created while some proxy chews on a heavy fan-out isn't placed
+  // behind it. Ties (e.g. an idle router) keep round-robin order.
   size_t res = nextProxy_;
-  nextProxy_ = (nextProxy_ + 1) % opts().num_proxies;
+  size_t bestLoad = std::numeric_limits<size_t>::max();
+  for (size_t i = 0; i < numActive; ++i) {
+    size_t idx = (nextProxy_ + i) % numActive;
+    auto* proxy = getProxyBase(idx);
+    if (proxy == nullptr) {
+      continue;
+    }
+    auto load = proxy->requestsInFlight();
+    if (load < bestLoad) {
+      res = idx;
+      bestLoad = load;
+    }
+  }
+  nextProxy_ = (res + 1) % numActive;
   return res;
 }
 
+void CarbonRouterInstanceBase::incPendingConfigReclamations() {
+  std::lock_guard<std::mutex> guard(configReclamationMutex_);
+  ++pendingConfigReclamations_;
+}
+
+void CarbonRouterInstanceBase::decPendingConfigReclamations() {
+  {
+    std::lock_guard<std::mutex> guard(configReclamationMutex_);
+    assert(pendingConfigReclamations_ > 0);
+    --pendingConfigReclamations_;
+  }
+  configReclamationCv_.notify_all();
+}
+
+void CarbonRouterInstanceBase::waitForPendingConfigReclamations() {
+  std::unique_lock<std::mutex> guard(configReclamationMutex_);
+  configReclamationCv_.wait(
+      guard, [this]() { return pendingConfigReclamations_ == 0; });
+}
+
+void CarbonRouterInstanceBase::registerForElasticProxyUpdates() {
+  if (opts_.elastic_proxy_min_active == 0 || opts_.num_proxies <= 1) {
+    return;
+  }
+  if (auto scheduler = functionScheduler()) {
+    scheduler->addFunction(
+        [this]() { updateElasticProxies(); },
+        kElasticProxyInterval,
+        elasticProxyFunctionHandle_,
+        /*startDelay=*/kElasticProxyInterval);
+  }
+}
+
+void CarbonRouterInstanceBase::deregisterForElasticProxyUpdates() {
+  if (opts_.elastic_proxy_min_active == 0 || opts_.num_proxies <= 1) {
+    return;
+  }
+  if (auto scheduler = functionScheduler()) {
+    scheduler->cancelFunctionAndWait(elasticProxyFunctionHandle_);
+  }
+  // New clients may be created while shutting down; let them land
+  // anywhere again.
+  activeProxies_.store(opts_.num_proxies, std::memory_order_relaxed);
+}
+
+void CarbonRouterInstanceBase::updateElasticProxies() {
+  const size_t minActive =
+      std::min<size_t>(std::max<size_t>(opts_.elastic_proxy_min_active, 1),
+                       opts_.num_proxies);
+  const size_t active = activeProxies_.load(std::memory_order_relaxed);
+
+  size_t totalLoad = 0;
+  size_t maxLoad = 0;
+  for (size_t i = 0; i < active; ++i) {
+    if (auto* proxy = getProxyBase(i)) {
+      const auto load = proxy->requestsInFlight();
+      totalLoad += load;
+      maxLoad = std::max(maxLoad, load);
+    }
+  }
+
+  if (active < opts_.num_proxies &&
+      totalLoad > opts_.elastic_proxy_unpark_min_requests * active) {
+    // Unpark after a single high reading: pressure must resolve fast.
+    activeProxies_.store(active + 1, std::memory_order_relaxed);
+    parkStreak_ = 0;
+    VLOG(1) << "Elastic proxy scaling: unparked proxy " << active << " ("
+            << totalLoad << " requests in flight across " << active
+            << " active proxies)";
+    return;
+  }
+
+  if (active > minActive &&
+      maxLoad < opts_.elastic_proxy_park_max_requests) {
+    if (++parkStreak_ >= kElasticProxyParkStreak) {
+      parkStreak_ = 0;
+      activeProxies_.store(active - 1, std::memory_order_relaxed);
+      VLOG(1) << "Elastic proxy scaling: parked proxy " << active - 1
+              << " (max " << maxLoad << " requests in flight)";
+    }
+  } else {
+    parkStreak_ = 0;
+  }
+}
+
 void CarbonRouterInstanceBase::registerForStatsUpdates() {
   if (!opts_.num_proxies) {
     return;
@@ -186,9 +348,9 @@ CarbonRouterInstanceBase::statsLogWriter() {
   return sharedLoggingAsyncWriter.try_get_fast();
 }
 
-folly::ReadMostlySharedPtr<AsyncWriter>
-CarbonRouterInstanceBase::asyncWriter() {
-  return sharedAsyncWriter.try_get_fast();
+folly::ReadMostlySharedPtr<AsyncWriterPool>
+CarbonRouterInstanceBase::asyncWriterPool() {
+  return sharedAsyncWriterPool.try_get_fast();
 }
 
 std::shared_ptr<folly::FunctionScheduler>
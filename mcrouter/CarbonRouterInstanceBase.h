@@ -8,10 +8,12 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <unordered_map>
 
 #include <folly/Synchronized.h>
+#include <folly/TokenBucket.h>
 #include <folly/container/EvictingCacheMap.h>
 #include <folly/experimental/FunctionScheduler.h>
 #include <folly/experimental/ReadMostlySharedPtr.h>
@@ -20,6 +22,8 @@
 #include <folly/synchronization/CallOnce.h>
 
 #include "mcrouter/ConfigApi.h"
+#include "mcrouter/ConfigArtifactCache.h"
+#include "mcrouter/lib/Clocks.h"
 #include "mcrouter/LeaseTokenMap.h"
 #include "mcrouter/Observable.h"
 #include "mcrouter/PoolStats.h"
@@ -38,9 +42,11 @@ namespace mcrouter {
 
 // Forward declarations
 class AsyncWriter;
+class AsyncWriterPool;
 template <class RouterInfo>
 class Proxy;
 class RuntimeVarsData;
+class ShardSplitter;
 using ObservableRuntimeVars =
     Observable<std::shared_ptr<const RuntimeVarsData>>;
 
@@ -67,6 +73,16 @@ class CarbonRouterInstanceBase {
     return opts_;
   }
 
+  /**
+   * Applies the runtime-mutable subset of the given option dict to the
+   * live options in place, skipping entries that match the current value.
+   * Called by the flavor file observer; safe to invoke from any thread
+   * (see McrouterOptionsBase::isRuntimeMutable for why the stores are
+   * safe against concurrent readers).
+   */
+  void applyRuntimeMutableOptions(
+      const std::unordered_map<std::string, std::string>& newOpts);
+
   /**
    * Returns compression codec manager.
    * If compression is disabled, this method will return nullptr.
@@ -82,6 +98,25 @@ class CarbonRouterInstanceBase {
     return tkoTrackerMap_;
   }
 
+  /**
+   * Consumes one token from the instance-wide TKO probe budget.
+   * Per-destination probes already back off with jitter and run on a
+   * single elected proxy, but during a large outage hundreds of TKO'd
+   * destinations still probe independently; this bucket caps their
+   * aggregate rate (--probe-max-per-second) across all proxy threads.
+   *
+   * @return true if the probe may be sent now; false if it should be
+   *         skipped and retried after the destination's backoff.
+   */
+  bool tryTakeProbeToken() {
+    const auto rate = static_cast<double>(opts_.probe_max_per_second);
+    if (rate <= 0.0) {
+      return true;
+    }
+    // One second of burst, so a small outage probes unthrottled.
+    return probeBudget_.consume(1.0, rate, rate);
+  }
+
   ConfigApi& configApi() {
     assert(configApi_.get() != nullptr);
     return *configApi_;
@@ -123,10 +158,22 @@ class CarbonRouterInstanceBase {
   }
 
   /**
-   * Returns an AsyncWriter for mission critical work (use statsLogWriter() for
-   * auxiliary / low priority work).
+   * Returns the AsyncWriter pool for mission critical work (use
+   * statsLogWriter() for auxiliary / low priority work). Writers are
+   * sharded; pass a stable shard key (e.g. the proxy id) to
+   * AsyncWriterPool::writer() so all writes to one spool file stay on
+   * one thread and remain ordered.
+   */
+  folly::ReadMostlySharedPtr<AsyncWriterPool> asyncWriterPool();
+
+  /**
+   * Cache of shard splitters keyed by their config json, shared across
+   * proxy threads and reconfigures so identical "shard_splits" blobs
+   * are built and stored only once per router instance.
    */
-  folly::ReadMostlySharedPtr<AsyncWriter> asyncWriter();
+  ConfigArtifactCache<ShardSplitter>& shardSplitterCache() {
+    return shardSplitterCache_;
+  }
 
   std::unordered_map<std::string, std::string> getStartupOpts() const;
   void addStartupOpts(
@@ -186,6 +233,25 @@ class CarbonRouterInstanceBase {
    */
   std::shared_ptr<folly::FunctionScheduler> functionScheduler();
 
+  /**
+   * Bookkeeping for ProxyConfigs whose destruction was offloaded to the
+   * auxiliary CPU thread pool. Shutdown must wait for these before tearing
+   * down proxy event bases: the displaced route trees reference
+   * ProxyDestinations whose release has to reach the proxy threads first.
+   */
+  void incPendingConfigReclamations();
+  void decPendingConfigReclamations();
+  void waitForPendingConfigReclamations();
+
+  /**
+   * Number of proxies currently eligible for new client placement.
+   * Equals opts().num_proxies unless elastic proxy scaling
+   * (--elastic-proxy-min-active) has parked some of the tail proxies.
+   */
+  size_t activeProxyCount() const {
+    return activeProxies_.load(std::memory_order_relaxed);
+  }
+
  protected:
   /**
    * Register this instance for periodic stats updates.
@@ -197,7 +263,16 @@ class CarbonRouterInstanceBase {
    */
   void deregisterForStatsUpdates();
 
-  const McrouterOptions opts_;
+  /**
+   * Start/stop the periodic queue-depth evaluation that parks and
+   * unparks proxies when elastic proxy scaling is enabled.
+   */
+  void registerForElasticProxyUpdates();
+  void deregisterForElasticProxyUpdates();
+
+  // Immutable after construction except for the runtime-mutable scalar
+  // subset updated through applyRuntimeMutableOptions().
+  McrouterOptions opts_;
   const pid_t pid_;
   const std::unique_ptr<ConfigApi> configApi_;
 
@@ -223,8 +298,16 @@ class CarbonRouterInstanceBase {
     statsIndex_ = newIndex;
   }
 
+  // Keeps the process-wide coarse clock ticking while any router instance
+  // exists, so nowUs() is a plain load on request hot paths.
+  coarse::TickerGuard coarseClockTicker_;
+
   TkoTrackerMap tkoTrackerMap_;
+  // Shared by all proxy threads; folly::DynamicTokenBucket is
+  // thread-safe.
+  folly::DynamicTokenBucket probeBudget_;
   std::unique_ptr<const CompressionCodecManager> compressionCodecManager_;
+  ConfigArtifactCache<ShardSplitter> shardSplitterCache_;
 
   // Stores data for runtime variables.
   const std::shared_ptr<ObservableRuntimeVars> rtVarsData_;
@@ -242,6 +325,20 @@ class CarbonRouterInstanceBase {
   std::mutex nextProxyMutex_;
   size_t nextProxy_{0};
 
+  /* Elastic proxy scaling state. Proxies [0, activeProxies_) accept new
+     client placement; the tail is parked. Parked proxies keep their
+     event bases and timers running (they still own destination
+     connections and TKO probes), they just stop receiving new work. */
+  std::atomic<size_t> activeProxies_;
+  // Consecutive low-load evaluations; guarded by being touched only from
+  // the function scheduler thread.
+  size_t parkStreak_{0};
+  const std::string elasticProxyFunctionHandle_;
+
+  std::mutex configReclamationMutex_;
+  std::condition_variable configReclamationCv_;
+  size_t pendingConfigReclamations_{0};
+
   // Current stats index. Only accessed / updated  by stats background thread.
   size_t statsIndex_{0};
 
@@ -252,6 +349,10 @@ class CarbonRouterInstanceBase {
 
   // Aggregates stats for all associated proxies. Should be called periodically.
   void updateStats();
+
+  // One elastic scaling evaluation; called periodically from the
+  // function scheduler when elastic proxy scaling is enabled.
+  void updateElasticProxies();
 };
 
 } // namespace mcrouter
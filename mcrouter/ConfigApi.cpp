@@ -12,6 +12,7 @@
 #include <boost/filesystem.hpp>
 
 #include <folly/FileUtil.h>
+#include <folly/Random.h>
 #include <folly/String.h>
 #include <folly/dynamic.h>
 
@@ -214,6 +215,51 @@ void ConfigApi::configThreadRun() {
     }
 
     if (hasUpdate) {
+      // A push that touches many imported files rarely lands atomically:
+      // inotify delivers the writes over tens of milliseconds. Keep
+      // polling until a full delay passes with no new events (bounded, so
+      // a constantly-changing file can't starve reconfiguration), and
+      // notify once for the whole batch instead of reconfiguring from a
+      // half-updated source tree several times.
+      constexpr int kMaxSettleRounds = 10;
+      for (int round = 0; round < kMaxSettleRounds && !finish_; ++round) {
+        bool moreUpdates = false;
+        try {
+          moreUpdates = checkFileUpdate();
+        } catch (...) {
+          break;
+        }
+        if (!moreUpdates) {
+          break;
+        }
+        std::unique_lock<std::mutex> lk(finishMutex_);
+        finishCV_.wait_for(
+            lk,
+            std::chrono::milliseconds(opts_.reconfiguration_delay_ms),
+            [this] { return finish_.load(); });
+      }
+      if (finish_) {
+        break;
+      }
+
+      // Smear reconfiguration across co-hosted instances: a config push
+      // typically reaches every process on a host at once, and without
+      // jitter their reconfiguration CPU spikes line up. Each process
+      // draws its own delay, so shutdown still interrupts the wait.
+      if (opts_.reconfiguration_jitter_ms > 0) {
+        std::unique_lock<std::mutex> lk(finishMutex_);
+        finishCV_.wait_for(
+            lk,
+            std::chrono::milliseconds(
+                folly::Random::rand32(
+                    static_cast<uint32_t>(opts_.reconfiguration_jitter_ms) +
+                    1)),
+            [this] { return finish_.load(); });
+        if (finish_) {
+          break;
+        }
+      }
+
       callbacks_.notify();
 
       // waits before checking for config updates again.
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <folly/dynamic.h>
+#include <folly/json.h>
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+/**
+ * Content-addressed cache for immutable route-tree artifacts that are
+ * expensive to build and identical across proxy threads (e.g. shard
+ * split maps).  Without it every one of the N proxy threads builds its
+ * own copy of the same artifact from the same config json on every
+ * reconfigure, multiplying both build time and steady-state memory
+ * by N.
+ *
+ * Keys are the serialized config json the artifact was built from.
+ * Entries are held by weak_ptr, so an artifact lives exactly as long as
+ * some route tree references it: once the last config that used it is
+ * reclaimed, the artifact is freed and the entry is swept on a later
+ * insert.  Safe to call from multiple proxy threads concurrently; the
+ * cached artifacts themselves must be thread-safe to share (i.e. deeply
+ * const).
+ */
+template <class T>
+class ConfigArtifactCache {
+ public:
+  /**
+   * Returns the artifact built from 'json', building it with 'make' on
+   * a miss.  'make' takes const folly::dynamic& and returns
+   * std::shared_ptr<const T>; it may throw, in which case nothing is
+   * cached and the exception propagates.
+   */
+  template <class MakeFunc>
+  std::shared_ptr<const T> get(const folly::dynamic& json, MakeFunc&& make) {
+    folly::json::serialization_opts opts;
+    opts.sort_keys = true;
+    auto key = folly::json::serialize(json, opts);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = entries_.find(key);
+      if (it != entries_.end()) {
+        if (auto artifact = it->second.lock()) {
+          return artifact;
+        }
+      }
+    }
+
+    // Build outside the lock: construction can be slow and two threads
+    // racing on the same key just means one redundant build.
+    auto artifact = make(json);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      it = it->second.expired() ? entries_.erase(it) : std::next(it);
+    }
+    entries_[std::move(key)] = artifact;
+    return artifact;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::weak_ptr<const T>> entries_;
+};
+
+} // namespace mcrouter
+} // namespace memcache
+} // namespace facebook
@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <algorithm>
+
+#include "mcrouter/ExponentialSmoothData.h"
+#include "mcrouter/lib/McResUtil.h"
+#include "mcrouter/lib/mc/msg.h"
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+/**
+ * Fused availability score for a single destination.
+ *
+ * Health signals about a destination used to live in separate places (TKO
+ * state, per-reply error counters, latency average, reported server load);
+ * this class folds them into one number in [0.0, 1.0], where 1.0 is a fully
+ * healthy destination and 0.0 is one that shouldn't receive traffic.
+ * The score is recomputed as part of the per-reply bookkeeping the owning
+ * ProxyDestination already does, so readers just load a cached double.
+ *
+ * Written only from the owning proxy thread. Cross-thread reads (stats
+ * polling) are approximate, like the rest of the destination stats. The
+ * whole state fits in a single cacheline so updates don't bounce the
+ * neighboring hot fields of ProxyDestination.
+ */
+class alignas(64) DestinationHealth {
+ public:
+  /**
+   * Accounts for one reply from the destination.
+   *
+   * @param result       Reply result.
+   * @param slowLatency  True if the reply latency was an outlier relative to
+   *                     this destination's smoothed average.
+   * @param loadPercent  Server load reported with the reply, in [0, 100].
+   *                     0 for servers that don't report load.
+   */
+  void recordReply(mc_res_t result, bool slowLatency, double loadPercent) {
+    errorRate_.insertSample(isErrorResult(result) ? 1.0 : 0.0);
+    slowRate_.insertSample(slowLatency ? 1.0 : 0.0);
+    loadFraction_ = std::min(std::max(loadPercent / 100.0, 0.0), 1.0);
+    recompute();
+  }
+
+  /**
+   * Accounts for a TKO transition. A TKO'd destination scores 0 regardless
+   * of the soft signals; on untko the score recovers as replies come back.
+   */
+  void recordTko(bool isTko) {
+    tko_ = isTko;
+    recompute();
+  }
+
+  /**
+   * Availability score in [0.0, 1.0]. A destination with no traffic yet
+   * scores 1.0, consistent with routes optimistically trying new boxes.
+   */
+  double score() const {
+    return score_;
+  }
+
+ private:
+  // Soft-signal window. Large enough that one bad reply barely moves the
+  // score, small enough that a brownout shows up within ~100 replies.
+  ExponentialSmoothData<64> errorRate_;
+  ExponentialSmoothData<64> slowRate_;
+  double loadFraction_{0.0};
+  double score_{1.0};
+  bool tko_{false};
+
+  void recompute() {
+    if (tko_) {
+      score_ = 0.0;
+      return;
+    }
+    // Errors dominate; slow replies and reported load each scale the score
+    // by at most half, so a loaded-but-correct server still looks better
+    // than an erroring one.
+    score_ = (1.0 - errorRate_.value()) * (1.0 - slowRate_.value() / 2) *
+        (1.0 - loadFraction_ / 2);
+  }
+};
+
+} // mcrouter
+} // memcache
+} // facebook
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2015-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include <folly/lang/Bits.h>
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+/**
+ * Fixed-size log-bucketed latency histogram, in the spirit of HDR
+ * histograms: values below 16 are recorded exactly, larger values fall
+ * into 8 linear sub-buckets per power of two, bounding the relative
+ * error of any percentile estimate at 12.5%.  The bucket array covers
+ * [0, 2^40) which, for microsecond samples, is about 12 days; anything
+ * larger lands in the last bucket.
+ *
+ * Unlike ExponentialSmoothData this keeps the full distribution, so tail
+ * percentiles (p99.9) can be queried directly.  Recording is a couple of
+ * shifts and an increment and is not synchronized: each instance is meant
+ * to be written by its owning proxy thread only.
+ */
+class LatencyHistogram {
+ public:
+  void insertSample(uint64_t value) {
+    ++counts_[bucketOf(value)];
+    ++totalSamples_;
+  }
+
+  uint64_t totalSamples() const {
+    return totalSamples_;
+  }
+
+  /**
+   * Estimate the given percentile (e.g. 99.9) of the recorded samples.
+   * Returns the upper bound of the bucket holding that percentile, or 0
+   * if no samples were recorded.
+   */
+  uint64_t estimatePercentile(double percentile) const {
+    if (totalSamples_ == 0) {
+      return 0;
+    }
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    // Round up so e.g. p100 needs all samples and p0 needs at least one.
+    const uint64_t rank = std::max<uint64_t>(
+        1, static_cast<uint64_t>(totalSamples_ * percentile / 100.0 + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      seen += counts_[i];
+      if (seen >= rank) {
+        return bucketUpperBound(i);
+      }
+    }
+    return bucketUpperBound(kNumBuckets - 1);
+  }
+
+  /**
+   * Add all samples recorded in "other" into this histogram. Used to
+   * aggregate the per-proxy-thread histograms on the polling path; reads
+   * of concurrently updated counters are approximate, like the rest of
+   * the stats pipeline.
+   */
+  void accumulate(const LatencyHistogram& other) {
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      counts_[i] += other.counts_[i];
+    }
+    totalSamples_ += other.totalSamples_;
+  }
+
+ private:
+  // 16 exact buckets + 8 sub-buckets for each octave in [2^4, 2^40).
+  static constexpr size_t kNumBuckets = 16 + 8 * 36;
+
+  static size_t bucketOf(uint64_t value) {
+    if (value < 16) {
+      return value;
+    }
+    // value is in [2^k, 2^(k+1)); index by the 3 bits below the top one.
+    const size_t k = folly::findLastSet(value) - 1;
+    if (k >= 40) {
+      return kNumBuckets - 1;
+    }
+    return 16 + (k - 4) * 8 + ((value >> (k - 3)) & 0x7);
+  }
+
+  static uint64_t bucketUpperBound(size_t bucket) {
+    if (bucket < 16) {
+      return bucket;
+    }
+    const size_t k = (bucket - 16) / 8 + 4;
+    const uint64_t sub = (bucket - 16) % 8;
+    return (uint64_t(1) << k) + (sub + 1) * (uint64_t(1) << (k - 3)) - 1;
+  }
+
+  uint64_t counts_[kNumBuckets]{};
+  uint64_t totalSamples_{0};
+};
+
+} // namespace mcrouter
+} // namespace memcache
+} // namespace facebook
@@ -57,16 +57,30 @@ LeaseTokenMap::~LeaseTokenMap() {
   }
 }
 
+LeaseTokenMap::Shard& LeaseTokenMap::shardForToken(uint64_t token) {
+  return shards_[static_cast<uint32_t>(token) % kNumShards];
+}
+
+const LeaseTokenMap::Shard& LeaseTokenMap::shardForToken(uint64_t token) const {
+  return shards_[static_cast<uint32_t>(token) % kNumShards];
+}
+
 uint64_t LeaseTokenMap::insert(std::string routeName, Item item) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  auto shardId = nextShard_.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+  auto& shard = shards_[shardId];
 
-  uint64_t specialToken = applyMagic(nextId_++);
+  std::lock_guard<std::mutex> lock(shard.mutex);
 
-  auto it = data_.emplace(
+  // Ids issued by shard i are congruent to i modulo kNumShards, so the
+  // token itself identifies the owning shard on lookup.
+  uint64_t specialToken = applyMagic(shardId + shard.nextId * kNumShards);
+  ++shard.nextId;
+
+  auto it = shard.data.emplace(
       specialToken,
       LeaseTokenMap::ListItem(
           specialToken, std::move(routeName), std::move(item), leaseTokenTtl_));
-  invalidationQueue_.push_back(it.first->second);
+  shard.invalidationQueue.push_back(it.first->second);
 
   return specialToken;
 }
@@ -81,11 +95,12 @@ folly::Optional<LeaseTokenMap::Item> LeaseTokenMap::query(
   }
 
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = data_.find(token);
-    if (it != data_.end() && it->second.routeName == routeName) {
+    auto& shard = shardForToken(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.data.find(token);
+    if (it != shard.data.end() && it->second.routeName == routeName) {
       item.emplace(std::move(it->second.item));
-      data_.erase(it);
+      shard.data.erase(it);
     }
   }
 
@@ -100,9 +115,10 @@ uint64_t LeaseTokenMap::getOriginalLeaseToken(
   }
 
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = data_.find(token);
-    if (it != data_.end() && it->second.routeName == routeName) {
+    auto& shard = shardForToken(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.data.find(token);
+    if (it != shard.data.end() && it->second.routeName == routeName) {
       return it->second.item.originalToken;
     }
   }
@@ -111,18 +127,24 @@ uint64_t LeaseTokenMap::getOriginalLeaseToken(
 
 void LeaseTokenMap::tokenCleanupTimeout() {
   const auto now = ListItem::Clock::now();
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto cur = invalidationQueue_.begin();
-  while (cur != invalidationQueue_.end() && cur->tokenTimeout <= now) {
-    uint64_t specialToken = cur->specialToken;
-    cur = invalidationQueue_.erase(cur);
-    data_.erase(specialToken);
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto cur = shard.invalidationQueue.begin();
+    while (cur != shard.invalidationQueue.end() && cur->tokenTimeout <= now) {
+      uint64_t specialToken = cur->specialToken;
+      cur = shard.invalidationQueue.erase(cur);
+      shard.data.erase(specialToken);
+    }
   }
 }
 
 size_t LeaseTokenMap::size() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return data_.size();
+  size_t total = 0;
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    total += shard.data.size();
+  }
+  return total;
 }
 
 bool LeaseTokenMap::conflicts(uint64_t originalToken) {
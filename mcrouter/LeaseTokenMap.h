@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -130,15 +132,35 @@ class LeaseTokenMap {
     folly::IntrusiveListHook listHook;
   };
 
-  // Hold the id of the next element to be inserted in the data structure.
-  uint32_t nextId_{0};
+  // Number of independent shards. Must be a power of two. The shard index
+  // is encoded in the low bits of the id assigned at insert time, so
+  // lookups go straight to the right shard without consulting shared state.
+  constexpr static size_t kNumShards = 16;
 
-  // Underlying data structure.
-  std::unordered_map<uint64_t, ListItem> data_;
-  // Keeps an in-order list of what should be invalidated.
-  folly::IntrusiveList<ListItem, &ListItem::listHook> invalidationQueue_;
-  // Mutex to synchronize access to underlying data structure
-  mutable std::mutex mutex_;
+  /**
+   * One independently locked slice of the map. Proxy threads inserting
+   * concurrently land on different shards (round-robin), so they no longer
+   * serialize on a single lock.
+   */
+  struct alignas(64) Shard {
+    // Underlying data structure.
+    std::unordered_map<uint64_t, ListItem> data;
+    // Keeps an in-order list of what should be invalidated. The TTL is
+    // constant, so insertion order is also expiry order.
+    folly::IntrusiveList<ListItem, &ListItem::listHook> invalidationQueue;
+    // Hold the id of the next element to be inserted in this shard.
+    // Strided by kNumShards so ids never collide across shards.
+    uint32_t nextId{0};
+    // Mutex to synchronize access to this shard's data structure.
+    mutable std::mutex mutex;
+  };
+
+  Shard& shardForToken(uint64_t token);
+  const Shard& shardForToken(uint64_t token) const;
+
+  std::array<Shard, kNumShards> shards_;
+  // Distributes inserts across shards.
+  std::atomic<uint32_t> nextShard_{0};
 
   std::weak_ptr<folly::FunctionScheduler> functionScheduler_;
   const std::string timeoutFunctionName_;
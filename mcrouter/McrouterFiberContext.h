@@ -7,17 +7,22 @@
  */
 #pragma once
 
+#include <cassert>
 #include <memory>
 #include <utility>
 
 #include <folly/Range.h>
 #include <folly/ScopeGuard.h>
 #include <folly/fibers/FiberManager.h>
+#include <folly/memory/Arena.h>
 
 #include "mcrouter/lib/network/ServerLoad.h"
 
 namespace facebook {
 namespace memcache {
+
+struct SerializedRequestBodyCache;
+
 namespace mcrouter {
 
 template <class RouterInfo>
@@ -53,16 +58,38 @@ class RequestClass {
 template <class RouterInfo>
 class fiber_local {
  private:
+  // Copied for every child fiber (failover, shadow, AllRoute variants)
+  // via runWithLocals, so it must stay compact: hot fields first, and
+  // the whole thing inside one cacheline (see the size budget below).
   struct McrouterFiberContext {
     std::shared_ptr<ProxyRequestContextWithInfo<RouterInfo>> sharedCtx;
-    folly::StringPiece asynclogName;
-    ServerLoad load{0};
+    int64_t deadlineUs{0};
     RequestClass requestClass;
+    ServerLoad load{0};
     bool failoverTag{false};
     bool failoverDisabled{false};
+    // Cold: only set by asynclog routes.
+    folly::StringPiece asynclogName;
+    // Cold: only set by FailoverRoute around failover attempts, so that
+    // resends of an unchanged request can reuse the serialized body
+    // (see SerializedRequestBodyCache).
+    SerializedRequestBodyCache* serializedBodyCache{nullptr};
   };
 
+  static_assert(
+      sizeof(McrouterFiberContext) <= 64,
+      "McrouterFiberContext must fit in one cacheline; put new "
+      "rarely-used state behind a pointer instead of growing it");
+
  public:
+  /**
+   * Bytes of fiber-local context initialized per request and copied per
+   * child fiber.  Exported as the fiber_local_context_bytes stat.
+   */
+  static constexpr size_t contextSize() {
+    return sizeof(McrouterFiberContext);
+  }
+
   using ContextTypeTag = folly::fibers::LocalType<McrouterFiberContext>;
 
   /**
@@ -122,6 +149,35 @@ class fiber_local {
     return folly::fibers::local<McrouterFiberContext>().sharedCtx.get();
   }
 
+  /**
+   * Get the bump arena of the current request. All memory drawn from it is
+   * reclaimed at once when the request completes; see
+   * ProxyRequestContext::requestArena() for usage restrictions.
+   * Must only be called while a request context is attached.
+   */
+  static folly::SysArena& getRequestArena() {
+    auto& ctx = folly::fibers::local<McrouterFiberContext>().sharedCtx;
+    assert(ctx);
+    return ctx->requestArena();
+  }
+
+  /**
+   * Set the absolute deadline (in us, same clock as nowUs()) of the
+   * current request. Propagates to failover and shadow sends, since
+   * child fibers copy the context.
+   */
+  static void setDeadlineUs(int64_t value) {
+    folly::fibers::local<McrouterFiberContext>().deadlineUs = value;
+  }
+
+  /**
+   * Get the absolute deadline (in us) of the current request.
+   * 0 means no deadline was set.
+   */
+  static int64_t getDeadlineUs() {
+    return folly::fibers::local<McrouterFiberContext>().deadlineUs;
+  }
+
   /**
    * Add a RequestClass for current fiber (thread, if we're not on fiber)
    */
@@ -171,6 +227,23 @@ class fiber_local {
     return folly::fibers::local<McrouterFiberContext>().failoverTag;
   }
 
+  /**
+   * Set the serialized-body cache for current fiber (thread, if we're not
+   * on fiber). The pointed-to cache must outlive every send that may use
+   * it; pass nullptr to disable reuse.
+   */
+  static void setSerializedBodyCache(SerializedRequestBodyCache* cache) {
+    folly::fibers::local<McrouterFiberContext>().serializedBodyCache = cache;
+  }
+
+  /**
+   * Get the serialized-body cache of current fiber (thread, if we're not
+   * on fiber); nullptr when no resend-capable route is active.
+   */
+  static SerializedRequestBodyCache* getSerializedBodyCache() {
+    return folly::fibers::local<McrouterFiberContext>().serializedBodyCache;
+  }
+
   /**
    * Set failover disabled flag for current fiber (thread, if we're not on
    * fiber)
@@ -80,60 +80,6 @@ void write_stats_file(
   write_file(opts, suffix, statsString);
 }
 
-void write_stats_to_disk(
-    const McrouterOptions& opts,
-    const std::vector<stat_t>& stats,
-    const folly::dynamic& requestStats) {
-  try {
-    std::string prefix = getStatPrefix(opts) + ".";
-    folly::dynamic jstats = folly::dynamic::object;
-
-    for (size_t i = 0; i < stats.size(); ++i) {
-      if (stats[i].group & ods_stats) {
-        auto key = prefix + stats[i].name.str();
-
-        switch (stats[i].type) {
-          case stat_uint64:
-            jstats[key] = stats[i].data.uint64;
-            break;
-
-          case stat_int64:
-            jstats[key] = stats[i].data.int64;
-            break;
-
-          case stat_double:
-            jstats[key] = stats[i].data.dbl;
-            break;
-
-          default:
-            continue;
-        }
-      }
-    }
-
-    for (const auto& kv : requestStats.items()) {
-      jstats[folly::to<std::string>(prefix, kv.first.asString())] = kv.second;
-    }
-
-    write_stats_file(opts, kStatsSfx, jstats);
-  } catch (const std::exception& e) {
-    VLOG(1) << "Failed to write stats to disk: " << e.what();
-  }
-}
-
-void write_config_sources_info_to_disk(CarbonRouterInstanceBase& router) {
-  auto config_info_json = router.configApi().getConfigSourcesInfo();
-
-  try {
-    boost::filesystem::path path(router.opts().stats_root);
-    path /= getStatPrefix(router.opts()) + "." + kConfigSourcesInfoFileName;
-    atomicallyWriteFileToDisk(
-        toPrettySortedJson(config_info_json), path.string());
-  } catch (...) {
-    LOG(ERROR) << "Error occured while writing configuration info to disk";
-  }
-}
-
 std::string statsUpdateFunctionName(folly::StringPiece routerName) {
   static std::atomic<uint64_t> uniqueId(0);
   return folly::to<std::string>(
@@ -147,6 +93,7 @@ McrouterLogger::McrouterLogger(
     std::unique_ptr<AdditionalLoggerIf> additionalLogger)
     : router_(router),
       additionalLogger_(std::move(additionalLogger)),
+      statsFifoStream_(router),
       functionHandle_(statsUpdateFunctionName(router_.opts().router_name)) {}
 
 McrouterLogger::~McrouterLogger() {
@@ -200,13 +147,109 @@ void McrouterLogger::logStartupOptions() {
   write_stats_file(router_.opts(), kStatsStartupOptionsSfx, json_options);
 }
 
+void McrouterLogger::writeStatsToDisk(
+    const std::vector<stat_t>& stats,
+    const folly::dynamic& requestStats) {
+  try {
+    std::string prefix = getStatPrefix(router_.opts()) + ".";
+
+    // The stat array layout only changes when pool stats appear or
+    // disappear across a reconfiguration; rebuild the key cache (and drop
+    // the stale JSON tree) only then.
+    bool keysValid = statKeys_.size() == stats.size();
+    for (size_t i = 0; keysValid && i < stats.size(); ++i) {
+      keysValid = stats[i].name == statKeys_[i].name;
+    }
+    if (!keysValid) {
+      statKeys_.clear();
+      statKeys_.reserve(stats.size());
+      statsJson_ = folly::dynamic::object;
+      requestStatKeys_.clear();
+      for (size_t i = 0; i < stats.size(); ++i) {
+        StatKey sk;
+        sk.name = stats[i].name.str();
+        if (stats[i].group & ods_stats) {
+          sk.key = prefix + sk.name;
+        }
+        statKeys_.push_back(std::move(sk));
+      }
+    }
+
+    for (size_t i = 0; i < stats.size(); ++i) {
+      if (statKeys_[i].key.isNull()) {
+        continue;
+      }
+      const auto& key = statKeys_[i].key;
+
+      switch (stats[i].type) {
+        case stat_uint64:
+          statsJson_[key] = stats[i].data.uint64;
+          break;
+
+        case stat_int64:
+          statsJson_[key] = stats[i].data.int64;
+          break;
+
+        case stat_double:
+          statsJson_[key] = stats[i].data.dbl;
+          break;
+
+        default:
+          continue;
+      }
+    }
+
+    std::vector<folly::dynamic> currentRequestStatKeys;
+    for (const auto& kv : requestStats.items()) {
+      folly::dynamic key = folly::to<std::string>(prefix, kv.first.asString());
+      statsJson_[key] = kv.second;
+      currentRequestStatKeys.push_back(std::move(key));
+    }
+    for (const auto& old : requestStatKeys_) {
+      if (std::find(
+              currentRequestStatKeys.begin(),
+              currentRequestStatKeys.end(),
+              old) == currentRequestStatKeys.end()) {
+        statsJson_.erase(old);
+      }
+    }
+    requestStatKeys_ = std::move(currentRequestStatKeys);
+
+    write_stats_file(router_.opts(), kStatsSfx, statsJson_);
+  } catch (const std::exception& e) {
+    VLOG(1) << "Failed to write stats to disk: " << e.what();
+  }
+}
+
+void McrouterLogger::writeConfigSourcesInfoToDisk() {
+  auto config_info_json = router_.configApi().getConfigSourcesInfo();
+
+  try {
+    auto serialized = toPrettySortedJson(config_info_json);
+    // Config sources rarely change; don't rewrite an identical file every
+    // period.
+    if (serialized == lastConfigSourcesInfo_) {
+      return;
+    }
+    boost::filesystem::path path(router_.opts().stats_root);
+    path /= getStatPrefix(router_.opts()) + "." + kConfigSourcesInfoFileName;
+    atomicallyWriteFileToDisk(serialized, path.string());
+    lastConfigSourcesInfo_ = std::move(serialized);
+  } catch (...) {
+    LOG(ERROR) << "Error occured while writing configuration info to disk";
+  }
+}
+
 void McrouterLogger::log() {
   if (!loggedStartupOptions_) {
     logStartupOptions();
     loggedStartupOptions_ = true;
   }
 
-  std::vector<stat_t> stats(num_stats);
+  // Shrink back to the static stats (pool stats are re-appended below);
+  // capacity is retained, so steady state does no allocation here.
+  statsBuffer_.resize(num_stats);
+  auto& stats = statsBuffer_;
   prepare_stats(router_, stats.data());
   append_pool_stats(router_, stats);
 
@@ -232,8 +275,10 @@ void McrouterLogger::log() {
     }
   }
 
-  write_stats_to_disk(router_.opts(), stats, requestStats);
-  write_config_sources_info_to_disk(router_);
+  statsFifoStream_.writeSnapshot(stats);
+
+  writeStatsToDisk(stats, requestStats);
+  writeConfigSourcesInfoToDisk();
 
   for (const auto& filepath : touchStatsFilepaths_) {
     touchFile(filepath);
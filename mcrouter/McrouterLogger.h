@@ -15,12 +15,16 @@
 #include <thread>
 #include <vector>
 
+#include <folly/dynamic.h>
+
+#include "mcrouter/StatsFifoStream.h"
+#include "mcrouter/stats.h"
+
 namespace facebook {
 namespace memcache {
 namespace mcrouter {
 
 class CarbonRouterInstanceBase;
-struct stat_t;
 
 class AdditionalLoggerIf {
  public:
@@ -62,6 +66,11 @@ class McrouterLogger {
 
   std::unique_ptr<AdditionalLoggerIf> additionalLogger_;
 
+  /**
+   * Binary stats snapshots for local fifo subscribers.
+   */
+  StatsFifoStream statsFifoStream_;
+
   bool loggedStartupOptions_{false};
   // Name of the periodic function registered with the function scheduler.
   const std::string functionHandle_;
@@ -71,6 +80,29 @@ class McrouterLogger {
    */
   std::vector<std::string> touchStatsFilepaths_;
 
+  /**
+   * Reused across periods: the stat array and the JSON tree, whose keys
+   * only change on reconfiguration. Rebuilding both from scratch every
+   * period showed up as allocation spikes at the logging cadence.
+   */
+  std::vector<stat_t> statsBuffer_;
+  folly::dynamic statsJson_ = folly::dynamic::object;
+
+  struct StatKey {
+    std::string name; ///< stat name this key was built from
+    folly::dynamic key{nullptr}; ///< "<prefix><name>"; null if not exported
+  };
+  std::vector<StatKey> statKeys_;
+  // Request stat keys written last period; zero-valued request stats are
+  // filtered out of the dump, so vanished keys must be evicted.
+  std::vector<folly::dynamic> requestStatKeys_;
+
+  /**
+   * Last serialized config sources info; the file is only rewritten when
+   * its content actually changes.
+   */
+  std::string lastConfigSourcesInfo_;
+
   /**
    * Writes router's logs.
    */
@@ -80,6 +112,18 @@ class McrouterLogger {
    * Writes startup options.
    */
   void logStartupOptions();
+
+  /**
+   * Updates the reusable stats JSON tree in place and writes it out.
+   */
+  void writeStatsToDisk(
+      const std::vector<stat_t>& stats,
+      const folly::dynamic& requestStats);
+
+  /**
+   * Writes config sources info, skipping the write if it is unchanged.
+   */
+  void writeConfigSourcesInfoToDisk();
 };
 }
 }
@@ -46,6 +46,10 @@ std::string getClientDebugFifoFullPath(const McrouterOptions& opts) {
 std::string getServerDebugFifoFullPath(const McrouterOptions& opts) {
   return getDebugFifoFullPath(opts, "server");
 }
+
+std::string getStatsDebugFifoFullPath(const McrouterOptions& opts) {
+  return getDebugFifoFullPath(opts, "stats");
+}
 }
 }
 } // facebook::memcache::mcrouter
@@ -38,6 +38,15 @@ std::string getClientDebugFifoFullPath(const McrouterOptions& opts);
  * @return        Full path of the fifo.
  */
 std::string getServerDebugFifoFullPath(const McrouterOptions& opts);
+
+/**
+ * Get the full path of the stats debug fifo (i.e. debug fifo that streams
+ * binary stats snapshots, see StatsFifoStream).
+ *
+ * @param opts    Mcrouter options.
+ * @return        Full path of the fifo.
+ */
+std::string getStatsDebugFifoFullPath(const McrouterOptions& opts);
 }
 }
 } // facebook::memcache::mcrouter
@@ -71,6 +71,7 @@ PoolFactory::PoolJson PoolFactory::parseNamedPool(folly::StringPiece name) {
 }
 
 PoolFactory::PoolJson PoolFactory::parsePool(const folly::dynamic& json) {
+  std::lock_guard<std::mutex> lock(parseMutex_);
   checkLogic(
       json.isString() || json.isObject(),
       "Pool should be a string (name of pool) or an object");
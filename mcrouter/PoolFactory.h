@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <mutex>
+
 #include <folly/dynamic.h>
 #include <folly/experimental/StringKeyedUnorderedMap.h>
 
@@ -38,6 +40,9 @@ class PoolFactory {
 
   /**
    * Loads a pool from ConfigApi, expand `inherit`, etc.
+   * Thread-safe: may be called concurrently when per-proxy configs are
+   * built in parallel. The returned json reference stays valid, parsed
+   * pools are never mutated again.
    *
    * @param json pool json
    *
@@ -49,6 +54,7 @@ class PoolFactory {
   enum class PoolState { NEW, PARSING, PARSED };
   folly::StringKeyedUnorderedMap<std::pair<folly::dynamic, PoolState>> pools_;
   ConfigApiIf& configApi_;
+  std::mutex parseMutex_;
 
   PoolJson parseNamedPool(folly::StringPiece name);
 };
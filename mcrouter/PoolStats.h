@@ -10,20 +10,34 @@
 #include <folly/experimental/StringKeyedUnorderedMap.h>
 
 #include "mcrouter/ExponentialSmoothData.h"
+#include "mcrouter/LatencyHistogram.h"
 #include "mcrouter/stats.h"
 
 namespace facebook {
 namespace memcache {
 namespace mcrouter {
 
+/**
+ * Per-pool counters for one proxy thread. Every proxy owns its own
+ * PoolStats instances (see ProxyStats), and all fibers of a proxy run on
+ * its EventBase thread, so increments are plain stores on purpose - no
+ * atomics or locks belong on this path. Aggregation across proxies
+ * happens only when stats are polled (append_pool_stats in stats.cpp),
+ * which may observe slightly stale values; that's fine for stats.
+ */
 class PoolStats {
  public:
   PoolStats(folly::StringPiece poolName)
-      : requestsCountStatName_(
+      : poolName_(poolName.str()),
+        requestsCountStatName_(
             folly::to<std::string>(poolName, ".requests.sum")),
         finalResultErrorStatName_(
             folly::to<std::string>(poolName, ".final_result_error.sum")),
         nConnectionsStatName_(folly::to<std::string>(poolName, ".connections")),
+        requestBytesStatName_(
+            folly::to<std::string>(poolName, ".request_bytes.sum")),
+        replyBytesStatName_(
+            folly::to<std::string>(poolName, ".reply_bytes.sum")),
         durationUsStatName_(
             folly::to<std::string>(poolName, ".duration_us.avg")),
         totalDurationUsStatName_(
@@ -31,6 +45,8 @@ class PoolStats {
     initStat(requestCountStat_, requestsCountStatName_);
     initStat(finalResultErrorStat_, finalResultErrorStatName_);
     initStat(nConnectionsStat_, nConnectionsStatName_);
+    initStat(requestBytesStat_, requestBytesStatName_);
+    initStat(replyBytesStat_, replyBytesStatName_);
   }
 
   std::vector<stat_t> getStats() const {
@@ -44,6 +60,8 @@ class PoolStats {
     return {requestCountStat_,
             finalResultErrorStat_,
             nConnectionsStat_,
+            requestBytesStat_,
+            replyBytesStat_,
             std::move(durationStat),
             std::move(totalDurationStat)};
   }
@@ -56,6 +74,20 @@ class PoolStats {
     finalResultErrorStat_.data.uint64 += amount;
   }
 
+  /**
+   * Exact serialized sizes of the request body sent and the reply body
+   * received (after compression, i.e. bytes on the wire), for bandwidth
+   * attribution. Both are already computed on the serialization path, so
+   * accounting costs just these additions.
+   */
+  void addRequestBytes(uint64_t bytes) {
+    requestBytesStat_.data.uint64 += bytes;
+  }
+
+  void addReplyBytes(uint64_t bytes) {
+    replyBytesStat_.data.uint64 += bytes;
+  }
+
   void addDurationSample(int64_t duration) {
     durationUsStat_.insertSample(duration);
   }
@@ -68,6 +100,26 @@ class PoolStats {
     totalDurationUsStat_.insertSample(duration);
   }
 
+  /**
+   * Record every "sampleRate"th request duration into the latency
+   * histogram. A sampleRate of 0 disables recording (the default), so the
+   * histogram costs nothing unless explicitly turned on.
+   */
+  void addDurationHistogramSample(int64_t durationUs, uint64_t sampleRate) {
+    if (sampleRate == 0 || ++samplesSeen_ % sampleRate != 0) {
+      return;
+    }
+    durationUsHistogram_.insertSample(durationUs);
+  }
+
+  const LatencyHistogram& durationUsHistogram() const {
+    return durationUsHistogram_;
+  }
+
+  folly::StringPiece poolName() const {
+    return poolName_;
+  }
+
  private:
   void initStat(stat_t& stat, folly::StringPiece name) const {
     stat.name = name;
@@ -77,16 +129,23 @@ class PoolStats {
     stat.data.uint64 = 0;
   }
 
+  const std::string poolName_;
   const std::string requestsCountStatName_;
   const std::string finalResultErrorStatName_;
   const std::string nConnectionsStatName_;
+  const std::string requestBytesStatName_;
+  const std::string replyBytesStatName_;
   const std::string durationUsStatName_;
   const std::string totalDurationUsStatName_;
   stat_t nConnectionsStat_;
   stat_t requestCountStat_;
   stat_t finalResultErrorStat_;
+  stat_t requestBytesStat_;
+  stat_t replyBytesStat_;
   ExponentialSmoothData<64> totalDurationUsStat_;
   ExponentialSmoothData<64> durationUsStat_;
+  LatencyHistogram durationUsHistogram_;
+  uint64_t samplesSeen_{0};
 };
 
 } // namespace mcrouter
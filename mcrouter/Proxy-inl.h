@@ -9,6 +9,7 @@
 
 #include "mcrouter/McrouterFiberContext.h"
 #include "mcrouter/ProxyRequestContextTyped.h"
+#include "mcrouter/lib/AuxiliaryCPUThreadPool.h"
 #include "mcrouter/lib/MessageQueue.h"
 #include "mcrouter/lib/carbon/RoutingGroups.h"
 #include "mcrouter/lib/carbon/Stats.h"
@@ -81,12 +82,17 @@ Proxy<RouterInfo>::addRouteTask(
   requestStats_.template bump<Request>(carbon::RouterStatTypes::Incoming);
 
   auto funcCtx = sharedCtx;
+  const int64_t deadlineBudgetMs = getRouterOptions().deadline_budget_ms;
 
   fiberManager().addTaskFinally(
-      [&req, ctx = std::move(funcCtx)]() mutable {
+      [&req, ctx = std::move(funcCtx), deadlineBudgetMs]() mutable {
         try {
           auto& proute = ctx->proxyRoute();
           fiber_local<RouterInfo>::setSharedCtx(std::move(ctx));
+          if (deadlineBudgetMs > 0) {
+            fiber_local<RouterInfo>::setDeadlineUs(
+                nowUs() + deadlineBudgetMs * 1000);
+          }
           return proute.route(req);
         } catch (const std::exception& e) {
           auto err = folly::sformat(
@@ -184,6 +190,14 @@ Proxy<RouterInfo>::Proxy(
     size_t id,
     folly::VirtualEventBase& evb)
     : ProxyBase(rtr, id, evb, RouterInfo()) {
+  std::function<uint64_t(const ProxyMessage&)> drainSortKey;
+  if (router().opts().client_queue_dispatch_sorting) {
+    // Non-request messages carry id 0 and sort ahead of requests, which
+    // group by carbon operation.
+    drainSortKey = [](const ProxyMessage& message) {
+      return uint64_t(message.reqTypeId);
+    };
+  }
   messageQueue_ = std::make_unique<MessageQueue<ProxyMessage>>(
       router().opts().client_queue_size,
       [this](ProxyMessage&& message) {
@@ -209,7 +223,12 @@ Proxy<RouterInfo>::Proxy(
               &flushCallback_, true /* thisIteration */);
         }
         return false;
-      });
+      },
+      router().opts().proxy_busy_poll_us,
+      std::move(drainSortKey));
+
+  stats().setValue(
+      fiber_local_context_bytes_stat, fiber_local<RouterInfo>::contextSize());
 }
 
 template <class RouterInfo>
@@ -223,6 +242,10 @@ Proxy<RouterInfo>* Proxy<RouterInfo>::createProxy(
   eventBase.runInEventBaseThread([proxyPtr, &eventBase]() {
     proxyPtr->messageQueue_->attachEventBase(eventBase);
 
+    proxyPtr->captureThreadAllocationCounters();
+
+    proxyPtr->startCpuSampling();
+
     dynamic_cast<folly::fibers::EventBaseLoopController&>(
         proxyPtr->fiberManager().loopController())
         .attachEventBase(eventBase);
@@ -233,6 +256,13 @@ Proxy<RouterInfo>* Proxy<RouterInfo>::createProxy(
     if (connectionResetInterval.count() > 0) {
       proxyPtr->destinationMap()->setResetTimer(connectionResetInterval);
     }
+
+    std::chrono::milliseconds keepWarmInterval{
+        proxyPtr->router().opts().keep_warm_connection_interval_ms};
+
+    if (keepWarmInterval.count() > 0) {
+      proxyPtr->destinationMap()->setWarmUpTimer(keepWarmInterval);
+    }
   });
 
   // We want proxy life-time to be tied to VirtualEventBase.
@@ -247,8 +277,32 @@ Proxy<RouterInfo>* Proxy<RouterInfo>::createProxy(
 template <class RouterInfo>
 std::shared_ptr<ProxyConfig<RouterInfo>> Proxy<RouterInfo>::getConfigUnsafe()
     const {
-  std::lock_guard<SFRReadLock> lg(const_cast<SFRLock&>(configLock_).readLock());
-  return config_;
+  /* The version cache below is owned by the proxy thread. Other threads
+     get here too — route-tree construction reads the live config for
+     pool reuse from the config thread and the auxiliary build pool — so
+     anyone else takes a locked copy and leaves the cache alone. */
+  if (UNLIKELY(!const_cast<Proxy<RouterInfo>*>(this)
+                    ->eventBase()
+                    .getEventBase()
+                    .isInEventBaseThread())) {
+    std::lock_guard<SFRReadLock> lg(
+        const_cast<SFRLock&>(configLock_).readLock());
+    return config_;
+  }
+  /* On the proxy thread the cache needs no synchronization; in the
+     steady state config access is one acquire load plus a copy of a
+     proxy-local shared_ptr, with no RMW on the shared lock word. */
+  if (UNLIKELY(
+          cachedConfigVersion_ !=
+          configVersion_.load(std::memory_order_acquire))) {
+    std::lock_guard<SFRReadLock> lg(
+        const_cast<SFRLock&>(configLock_).readLock());
+    cachedConfig_ = config_;
+    /* Re-read under the lock: the writer bumps the version while holding
+       the write lock, so this snapshot is consistent with config_. */
+    cachedConfigVersion_ = configVersion_.load(std::memory_order_relaxed);
+  }
+  return cachedConfig_;
 }
 
 template <class RouterInfo>
@@ -266,7 +320,16 @@ std::shared_ptr<ProxyConfig<RouterInfo>> Proxy<RouterInfo>::swapConfig(
     std::shared_ptr<ProxyConfig<RouterInfo>> newConfig) {
   std::lock_guard<SFRWriteLock> lg(configLock_.writeLock());
   auto old = std::move(config_);
+  if (old) {
+    // Requests created before this point keep routing through the old
+    // tree until they complete; the flag makes the last of them release
+    // the tree off the proxy thread (see ~ProxyRequestContextTyped).
+    old->markRetired();
+  }
   config_ = std::move(newConfig);
+  configVersion_.store(
+      configVersion_.load(std::memory_order_relaxed) + 1,
+      std::memory_order_release);
   return old;
 }
 
@@ -300,13 +363,35 @@ template <class RouterInfo>
 void Proxy<RouterInfo>::messageReady(ProxyMessage::Type t, void* data) {
   switch (t) {
     case ProxyMessage::Type::REQUEST: {
+      LoopSliceGuard guard(*this, loop_slice_message_queue_us_stat);
       auto preq = reinterpret_cast<ProxyRequestContext*>(data);
       preq->startProcessing();
     } break;
 
     case ProxyMessage::Type::OLD_CONFIG: {
+      // Separate bucket: config reclamation stalls are the classic
+      // offender and should not hide among request drains.
+      LoopSliceGuard guard(*this, loop_slice_config_us_stat);
       auto oldConfig = reinterpret_cast<old_config_req_t<RouterInfo>*>(data);
-      delete oldConfig;
+      // Refresh the request-path cache so its reference to the retired
+      // config is dropped at this reclamation point rather than lingering
+      // until the next request.
+      getConfigUnsafe();
+      // Tearing down a large route handle tree here would stall the
+      // request loop for the duration of the destructor storm. Offload it
+      // to the auxiliary CPU pool: shutdown waits for these tasks, and
+      // DestinationRoute hands destination references back to this thread,
+      // preserving the proxy-thread destruction invariant.
+      if (auto threadPool = AuxiliaryCPUThreadPoolSingleton::try_get()) {
+        auto& instance = router();
+        instance.incPendingConfigReclamations();
+        threadPool->getThreadPool().add([oldConfig, &instance]() {
+          delete oldConfig;
+          instance.decPendingConfigReclamations();
+        });
+      } else {
+        delete oldConfig;
+      }
     } break;
 
     case ProxyMessage::Type::SHUTDOWN:
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -65,11 +66,19 @@ struct ProxyMessage {
   enum class Type { REQUEST, OLD_CONFIG, SHUTDOWN };
 
   Type type{Type::REQUEST};
+  /* Carbon type id of the request carried by a REQUEST message, 0 when
+     unknown or not a request. Lives in the enqueue-side padding so the
+     drain loop can group same-operation requests without touching the
+     (likely cold) request context. */
+  uint32_t reqTypeId{0};
   void* data{nullptr};
 
   constexpr ProxyMessage() = default;
 
   ProxyMessage(Type t, void* d) noexcept : type(t), data(d) {}
+
+  ProxyMessage(Type t, void* d, uint32_t reqTypeId_) noexcept
+      : type(t), reqTypeId(reqTypeId_), data(d) {}
 };
 
 template <class RouterInfo>
@@ -78,8 +87,12 @@ class Proxy : public ProxyBase {
   ~Proxy() override;
 
   /**
-   * Access to config - can only be called on the proxy thread
-   * and the resulting shared_ptr can only be detroyed on the proxy thread.
+   * Access to config. On the proxy thread this is served from an
+   * unsynchronized proxy-local cache and the resulting shared_ptr can
+   * only be destroyed on the proxy thread. Any other thread gets a copy
+   * taken under the config lock; such a copy must not outlive the
+   * reconfiguration that took it (config_ itself holds the reference
+   * that keeps its destruction on the proxy thread).
    */
   std::shared_ptr<ProxyConfig<RouterInfo>> getConfigUnsafe() const;
 
@@ -140,6 +153,20 @@ class Proxy : public ProxyBase {
   SFRLock configLock_;
   std::shared_ptr<ProxyConfig<RouterInfo>> config_;
 
+  /** Bumped under the write lock on every swapConfig() */
+  std::atomic<uint64_t> configVersion_{0};
+
+  /**
+   * Proxy-thread-owned cache of config_, refreshed only when the version
+   * changes. Lets the request path skip the read-lock RMW on the shared
+   * lock word and keeps all shared_ptr refcount traffic on proxy-local
+   * cachelines. Mutable because getConfigUnsafe() is const; only ever
+   * touched from the proxy's EventBase thread (getConfigUnsafe routes
+   * all other threads through the config lock).
+   */
+  mutable std::shared_ptr<ProxyConfig<RouterInfo>> cachedConfig_;
+  mutable uint64_t cachedConfigVersion_{std::numeric_limits<uint64_t>::max()};
+
   typename RouterInfo::RouterStats requestStats_;
 
   std::unique_ptr<MessageQueue<ProxyMessage>> messageQueue_;
@@ -33,6 +33,8 @@ ProxyBase::ProxyBase(
           getFiberManagerOptions(router_.opts())),
       asyncLog_(router_.opts()),
       stats_(router_.getStatsEnabledPools()),
+      traceSpans_(router_, id_),
+      cpuSampleCallback_(*this),
       flushCallback_(*this),
       destinationMap_(std::make_unique<ProxyDestinationMap>(this)) {
   // Setup a full random seed sequence
@@ -7,6 +7,10 @@
  */
 #include "ProxyBase.h"
 
+#include <glog/logging.h>
+
+#include <folly/memory/Malloc.h>
+
 #include "mcrouter/CarbonRouterInstanceBase.h"
 #include "mcrouter/config-impl.h"
 #include "mcrouter/config.h"
@@ -20,6 +24,24 @@ const McrouterOptions& ProxyBase::getRouterOptions() const {
   return router_.opts();
 }
 
+void ProxyBase::captureThreadAllocationCounters() {
+  if (!folly::usingJEMalloc()) {
+    return;
+  }
+  // jemalloc hands out stable pointers to the calling thread's cumulative
+  // counters, so we can grab them once and read them from the stats thread.
+  uint64_t* ptr = nullptr;
+  size_t len = sizeof(ptr);
+  if (mallctl("thread.allocatedp", &ptr, &len, nullptr, 0) == 0) {
+    threadAllocatedBytes_ = ptr;
+  }
+  ptr = nullptr;
+  len = sizeof(ptr);
+  if (mallctl("thread.deallocatedp", &ptr, &len, nullptr, 0) == 0) {
+    threadDeallocatedBytes_ = ptr;
+  }
+}
+
 folly::fibers::FiberManager::Options ProxyBase::getFiberManagerOptions(
     const McrouterOptions& opts) {
   folly::fibers::FiberManager::Options fmOpts;
@@ -31,6 +53,66 @@ folly::fibers::FiberManager::Options ProxyBase::getFiberManagerOptions(
   return fmOpts;
 }
 
+void ProxyBase::startCpuSampling() {
+  eventBase().getEventBase().runBeforeLoop(&cpuSampleCallback_);
+}
+
+void ProxyBase::CpuSampleCallback::runLoopCallback() noexcept {
+  // Sampling the thread CPU clock more often than this adds syscall
+  // cost without improving the stat (it's exported once a second).
+  constexpr uint64_t kCpuSamplePeriodUs = 10 * 1000;
+
+  const auto now = static_cast<uint64_t>(nowUs());
+  if (lastLoopUs_ != 0) {
+    proxy_.stats().loopDurationUs().insertSample(now - lastLoopUs_);
+  }
+  lastLoopUs_ = now;
+
+  if (now - lastCpuSampleUs_ >= kCpuSamplePeriodUs) {
+    // Recalibrate the cycle counter against the wall clock over the
+    // sample window, for LoopSliceGuard's cycles -> us conversion.
+    const auto nowCycles = cycles::getCpuCycles();
+    if (lastCpuSampleCycles_ != 0 && now > lastCpuSampleUs_) {
+      proxy_.cyclesPerUs_ =
+          static_cast<double>(nowCycles - lastCpuSampleCycles_) /
+          (now - lastCpuSampleUs_);
+    }
+    lastCpuSampleCycles_ = nowCycles;
+    lastCpuSampleUs_ = now;
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+      proxy_.threadCpuTimeUs_.store(
+          static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000,
+          std::memory_order_relaxed);
+    }
+  }
+
+  // runBeforeLoop deregisters the callback each time; re-arm for the
+  // next iteration.
+  proxy_.eventBase().getEventBase().runBeforeLoop(this);
+}
+
+ProxyBase::LoopSliceGuard::~LoopSliceGuard() {
+  const double cyclesPerUs = proxy_.cyclesPerUs_;
+  if (cyclesPerUs <= 0) {
+    // First calibration window hasn't closed yet.
+    return;
+  }
+  const auto durationUs = static_cast<uint64_t>(
+      (cycles::getCpuCycles() - startCycles_) / cyclesPerUs);
+  proxy_.stats().increment(bucketStat_, durationUs);
+
+  const auto thresholdUs =
+      proxy_.getRouterOptions().proxy_loop_slice_threshold_us;
+  if (thresholdUs > 0 && durationUs >= thresholdUs) {
+    proxy_.stats().increment(loop_stalls_stat);
+    LOG_EVERY_N(WARNING, 100)
+        << "Proxy " << proxy_.getId() << " event loop stalled for "
+        << durationUs << "us in " << proxy_.stats().getStat(bucketStat_).name
+        << " (every request on this thread waited)";
+  }
+}
+
 void ProxyBase::FlushCallback::runLoopCallback() noexcept {
   // Always reschedlue until the end of event loop.
   if (!rescheduled_) {
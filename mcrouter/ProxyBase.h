@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <random>
@@ -17,6 +18,9 @@
 
 #include "mcrouter/AsyncLog.h"
 #include "mcrouter/ProxyStats.h"
+#include "mcrouter/lib/Clocks.h"
+#include "mcrouter/RouteHandleProfiler.h"
+#include "mcrouter/TraceSpanCollector.h"
 #include "mcrouter/config.h"
 
 namespace facebook {
@@ -93,6 +97,17 @@ class ProxyBase {
     return statsContainer_.get();
   }
 
+  RouteHandleProfiler& routeHandleProfiler() {
+    return routeHandleProfiler_;
+  }
+  const RouteHandleProfiler& routeHandleProfiler() const {
+    return routeHandleProfiler_;
+  }
+
+  TraceSpanCollector& traceSpans() {
+    return traceSpans_;
+  }
+
   /** Will let through requests from the above queue if we have capacity */
   virtual void pump() = 0;
 
@@ -110,6 +125,82 @@ class ProxyBase {
     return flushList_;
   }
 
+  /**
+   * Captures pointers to jemalloc's cumulative thread.allocated and
+   * thread.deallocated counters of the calling thread. Must be called from
+   * this proxy's event base thread. No-op if the binary is not running with
+   * jemalloc.
+   */
+  void captureThreadAllocationCounters();
+
+  /**
+   * Cumulative bytes allocated/deallocated by this proxy's event base
+   * thread, or 0 if unavailable. May be read from other threads; the
+   * counters are plain uint64 updated by jemalloc, so values can lag by
+   * a few operations.
+   */
+  uint64_t threadAllocatedBytes() const {
+    return threadAllocatedBytes_ ? *threadAllocatedBytes_ : 0;
+  }
+  uint64_t threadDeallocatedBytes() const {
+    return threadDeallocatedBytes_ ? *threadDeallocatedBytes_ : 0;
+  }
+
+  /**
+   * Starts sampling this proxy thread's CPU clock and event loop
+   * iteration durations at loop boundaries. Must be called from this
+   * proxy's event base thread.
+   */
+  void startCpuSampling();
+
+  /**
+   * Cumulative CPU time consumed by this proxy's event base thread in
+   * microseconds, as of the most recent loop-boundary sample. Readable
+   * from any thread; 0 until the first sample.
+   */
+  uint64_t threadCpuTimeUs() const {
+    return threadCpuTimeUs_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * RAII timer for an event loop slice that mcrouter itself runs on the
+   * proxy thread (message queue drain, config reclamation). Measures
+   * with the cpu cycle counter - no syscall per slice; cycles are
+   * converted to us with a calibration maintained at loop boundaries -
+   * and adds the duration to bucketStat. A slice exceeding
+   * --proxy-loop-slice-threshold-us additionally bumps loop_stalls and
+   * logs a rate-limited warning naming the bucket, attributing the stall
+   * every request on this thread just suffered. Slices ending before the
+   * first calibration window closes (~10ms after startup) are dropped.
+   */
+  class LoopSliceGuard {
+   public:
+    LoopSliceGuard(ProxyBase& proxy, stat_name_t bucketStat)
+        : proxy_(proxy),
+          bucketStat_(bucketStat),
+          startCycles_(cycles::getCpuCycles()) {}
+
+    LoopSliceGuard(const LoopSliceGuard&) = delete;
+    LoopSliceGuard& operator=(const LoopSliceGuard&) = delete;
+
+    ~LoopSliceGuard();
+
+   private:
+    ProxyBase& proxy_;
+    const stat_name_t bucketStat_;
+    const uint64_t startCycles_;
+  };
+
+  /**
+   * Number of requests this proxy is currently processing or has queued
+   * behind the inflight limit. Readable from any thread; used for
+   * load-aware placement of new clients.
+   */
+  size_t requestsInFlight() const {
+    return numRequestsProcessing_.load(std::memory_order_relaxed) +
+        numRequestsWaiting_.load(std::memory_order_relaxed);
+  }
+
  private:
   CarbonRouterInstanceBase& router_;
   const size_t id_{0};
@@ -123,6 +214,36 @@ class ProxyBase {
 
   ProxyStats stats_;
   std::unique_ptr<ProxyStatsContainer> statsContainer_;
+  RouteHandleProfiler routeHandleProfiler_;
+  TraceSpanCollector traceSpans_;
+
+  const uint64_t* threadAllocatedBytes_{nullptr};
+  const uint64_t* threadDeallocatedBytes_{nullptr};
+
+  std::atomic<uint64_t> threadCpuTimeUs_{0};
+
+  // Cycle counter ticks per microsecond on this thread's cpu, measured
+  // by CpuSampleCallback over its sample window. 0 until the first
+  // window closes. Only touched from the proxy thread.
+  double cyclesPerUs_{0};
+
+  /**
+   * Runs at every event loop boundary: feeds the iteration duration
+   * into stats and periodically refreshes threadCpuTimeUs_ from
+   * CLOCK_THREAD_CPUTIME_ID (a syscall, so amortized rather than read
+   * per iteration).
+   */
+  class CpuSampleCallback : public folly::EventBase::LoopCallback {
+   public:
+    explicit CpuSampleCallback(ProxyBase& proxy) : proxy_(proxy) {}
+    void runLoopCallback() noexcept override final;
+
+   private:
+    ProxyBase& proxy_;
+    uint64_t lastLoopUs_{0};
+    uint64_t lastCpuSampleUs_{0};
+    uint64_t lastCpuSampleCycles_{0};
+  } cpuSampleCallback_;
 
   static folly::fibers::FiberManager::Options getFiberManagerOptions(
       const McrouterOptions& opts);
@@ -157,10 +278,11 @@ class ProxyBase {
    * fiber stacks.
    */
 
-  /** Number of requests processing */
-  size_t numRequestsProcessing_{0};
+  /** Number of requests processing. Atomic only so that other threads can
+      read it for requestsInFlight(); all writes are on the proxy thread. */
+  std::atomic<size_t> numRequestsProcessing_{0};
   /** Number of waiting requests */
-  size_t numRequestsWaiting_{0};
+  std::atomic<size_t> numRequestsWaiting_{0};
 
   friend class ProxyRequestContext;
 };
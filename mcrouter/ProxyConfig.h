@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -66,9 +67,33 @@ class ProxyConfig {
     return accessPoints_;
   }
 
+  /**
+   * poolName -> hash of the pool's JSON at the time this config was built.
+   * Used to detect unchanged pools across reconfigurations.
+   */
+  const folly::StringKeyedUnorderedMap<size_t>& getPoolHashes() const {
+    return poolHashes_;
+  }
+
   size_t calcNumClients() const;
 
+  /**
+   * True once a newer config has displaced this one (see
+   * Proxy::swapConfig). In-flight requests keep routing through a
+   * retired tree until they complete; the flag tells whoever drops the
+   * last reference to release it off the proxy thread.
+   */
+  bool retired() const {
+    return retired_.load(std::memory_order_relaxed);
+  }
+
+  void markRetired() {
+    retired_.store(true, std::memory_order_relaxed);
+  }
+
  private:
+  std::atomic<bool> retired_{false};
+
   // This map (accessPoints_) needs to be destroyed as the last object in the
   // config (after all RouteHandles) because its keys are being referenced
   // by object in the Config.
@@ -84,6 +109,7 @@ class ProxyConfig {
   folly::StringKeyedUnorderedMap<
       std::shared_ptr<typename RouterInfo::RouteHandleIf>>
       asyncLogRoutes_;
+  folly::StringKeyedUnorderedMap<size_t> poolHashes_;
 
   /**
    * Parses config and creates ProxyRoute
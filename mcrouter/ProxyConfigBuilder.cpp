@@ -7,6 +7,14 @@
  */
 #include "ProxyConfigBuilder.h"
 
+#include <algorithm>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
 #include <folly/json.h>
 
 #include "mcrouter/ConfigApi.h"
@@ -14,7 +22,9 @@
 #include "mcrouter/Proxy.h"
 #include "mcrouter/ProxyConfig.h"
 #include "mcrouter/config.h"
+#include "mcrouter/lib/config/CompiledConfig.h"
 #include "mcrouter/lib/config/ConfigPreprocessor.h"
+#include "mcrouter/lib/config/ImportResolverIf.h"
 #include "mcrouter/lib/fbi/cpp/globals.h"
 #include "mcrouter/lib/fbi/cpp/util.h"
 #include "mcrouter/routes/McImportResolver.h"
@@ -23,6 +33,88 @@ namespace facebook {
 namespace memcache {
 namespace mcrouter {
 
+namespace {
+
+/**
+ * The expanded config is fully determined by the config source and the
+ * global params (imported contents are covered separately through the
+ * preprocessor's import trace), so this hash keys the preprocess cache.
+ */
+std::string preprocessCacheKey(
+    folly::StringPiece jsonC,
+    const folly::StringKeyedUnorderedMap<folly::dynamic>& globalParams) {
+  std::vector<std::string> params;
+  params.reserve(globalParams.size());
+  for (const auto& param : globalParams) {
+    params.push_back(
+        folly::to<std::string>(param.first, "=", folly::toJson(param.second)));
+  }
+  std::sort(params.begin(), params.end());
+  return Md5Hash(folly::to<std::string>(jsonC, "|", folly::join(";", params)));
+}
+
+/**
+ * Loads the cached preprocessed config, revalidating the imports it was
+ * expanded with by content hash.
+ *
+ * @return  The cached result, or nullptr if the cache is missing, stale
+ *          or malformed.
+ */
+folly::dynamic loadPreprocessCache(
+    const std::string& path,
+    const std::string& cacheKey,
+    ImportResolverIf& importResolver) {
+  std::string contents;
+  if (!folly::readFile(path.c_str(), contents)) {
+    return nullptr;
+  }
+  try {
+    // The artifact is binary (see CompiledConfig.h), so a cache hit
+    // skips JSON parsing entirely; unreadable or old-format files are
+    // treated as a miss.
+    auto cache = parseCompiledConfig(contents);
+    if (cache["key"].getString() != cacheKey) {
+      return nullptr;
+    }
+    for (const auto& import : cache["imports"].items()) {
+      // Empty hash means the import failed last time and the macro's
+      // default value was used; it has to fail the same way now.
+      std::string hash;
+      try {
+        hash = Md5Hash(importResolver.import(import.first.getString()));
+      } catch (const std::exception&) {
+      }
+      if (hash != import.second.getString()) {
+        return nullptr;
+      }
+    }
+    auto result = cache["result"];
+    return result.isObject() ? result : nullptr;
+  } catch (const std::exception& e) {
+    VLOG(1) << "Invalid preprocessed config cache '" << path
+            << "': " << e.what();
+    return nullptr;
+  }
+}
+
+void storePreprocessCache(
+    const std::string& path,
+    const std::string& cacheKey,
+    const ConfigPreprocessor::ImportTrace& importTrace,
+    const folly::dynamic& result) {
+  folly::dynamic imports = folly::dynamic::object;
+  for (const auto& import : importTrace) {
+    imports[import.first] = import.second;
+  }
+  folly::dynamic cache = folly::dynamic::object("key", cacheKey)(
+      "imports", std::move(imports))("result", result);
+  if (!atomicallyWriteFileToDisk(compileConfig(cache), path)) {
+    LOG(WARNING) << "Error writing preprocessed config cache to " << path;
+  }
+}
+
+} // anonymous namespace
+
 ProxyConfigBuilder::ProxyConfigBuilder(
     const McrouterOptions& opts,
     ConfigApi& configApi,
@@ -44,8 +136,26 @@ ProxyConfigBuilder::ProxyConfigBuilder(
     globalParams.emplace(param.first, param.second);
   }
 
-  json_ = ConfigPreprocessor::getConfigWithoutMacros(
-      jsonC, importResolver, std::move(globalParams));
+  const auto& cacheFile = opts.config_preprocess_cache_file;
+  std::string cacheKey;
+  if (!cacheFile.empty()) {
+    cacheKey = preprocessCacheKey(jsonC, globalParams);
+    json_ = loadPreprocessCache(cacheFile, cacheKey, importResolver);
+  }
+  if (json_.isNull()) {
+    ConfigPreprocessor::ImportTrace importTrace;
+    json_ = ConfigPreprocessor::getConfigWithoutMacros(
+        jsonC,
+        importResolver,
+        std::move(globalParams),
+        /* nestedLimit */ 250,
+        cacheFile.empty() ? nullptr : &importTrace);
+    if (!cacheFile.empty()) {
+      storePreprocessCache(cacheFile, cacheKey, importTrace, json_);
+    }
+  } else {
+    VLOG(1) << "Reusing cached preprocessed config from " << cacheFile;
+  }
 
   poolFactory_ = std::make_unique<PoolFactory>(json_, configApi);
 
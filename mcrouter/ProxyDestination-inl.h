@@ -23,9 +23,11 @@ ReplyT<Request> ProxyDestination::send(
     const Request& request,
     DestinationRequestCtx& requestContext,
     std::chrono::milliseconds timeout,
-    RpcStatsContext& rpcStatsContext) {
+    RpcStatsContext& rpcStatsContext,
+    SerializedRequestBodyCache* bodyCache) {
   proxy.destinationMap()->markAsActive(*this);
-  auto reply = getAsyncMcClient().sendSync(request, timeout, &rpcStatsContext);
+  auto reply = getAsyncMcClient().sendSync(
+      request, timeout, &rpcStatsContext, bodyCache);
   onReply(
       reply.result(), requestContext, rpcStatsContext, request.isBufferDirty());
   return reply;
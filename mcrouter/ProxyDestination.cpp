@@ -43,6 +43,13 @@ constexpr double kProbeJitterDelta = kProbeJitterMax - kProbeJitterMin;
 // Jitters for closing rxmiting connections will be between 1 and
 // kReconnectionHoldoffFactor.
 constexpr uint32_t kReconnectionHoldoffFactor = 25;
+// Percentile estimation walks histogram buckets, so evaluate the latency
+// TKO condition at most this often rather than on every reply.
+constexpr uint64_t kLatencyTkoCheckIntervalUs = 100 * 1000;
+// Pre-compression bytes of compressed replies over which compression
+// savings are evaluated before deciding to keep or drop compression for
+// a connection. Large enough to ride out a few incompressible values.
+constexpr uint64_t kCompressionWindowBytes = 1024 * 1024;
 
 static_assert(
     kProbeJitterMax >= kProbeJitterMin,
@@ -83,6 +90,12 @@ void ProxyDestination::startSendingProbes() {
   probeTimer_ = folly::AsyncTimeout::make(proxy.eventBase(), [this]() noexcept {
     // Note that the previous probe might still be in flight
     if (!probeInflight_) {
+      if (!proxy.router().tryTakeProbeToken()) {
+        // Over the instance-wide probe budget; retry after backoff.
+        proxy.stats().increment(probes_rate_limited_stat);
+        scheduleNextProbe();
+        return;
+      }
       probeInflight_ = true;
       ++stats_.probesSent;
       proxy.fiberManager().addTask([selfPtr = selfPtr_]() mutable {
@@ -110,6 +123,31 @@ void ProxyDestination::stopSendingProbes() {
   probeTimer_.reset();
 }
 
+void ProxyDestination::warmUp() {
+  // Real traffic keeps the connection warm on its own, and probes of
+  // TKO'd destinations already reconnect; only ping when nothing else
+  // is exercising the connection.
+  if (warmUpInflight_ || probeInflight_ || tracker->isTko() ||
+      getPendingRequestCount() > 0 || getInflightRequestCount() > 0) {
+    return;
+  }
+  warmUpInflight_ = true;
+  proxy.fiberManager().addTask([selfPtr = selfPtr_]() mutable {
+    auto pdstn = selfPtr.lock();
+    if (pdstn == nullptr) {
+      return;
+    }
+    pdstn->proxy.destinationMap()->markAsActive(*pdstn);
+    // Will reconnect if connection was closed. Version commands
+    // shouldn't take much longer than establishing a connection, so
+    // just using shortestConnectTimeout_ here.
+    auto reply = pdstn->getAsyncMcClient().sendSync(
+        McVersionRequest(), pdstn->shortestConnectTimeout_);
+    pdstn->handleTko(reply.result(), /* is_probe_req */ false);
+    pdstn->warmUpInflight_ = false;
+  });
+}
+
 void ProxyDestination::handleTko(const mc_res_t result, bool is_probe_req) {
   if (proxy.router().opts().disable_tko_tracking) {
     return;
@@ -119,11 +157,13 @@ void ProxyDestination::handleTko(const mc_res_t result, bool is_probe_req) {
     if (isHardTkoErrorResult(result)) {
       if (tracker->recordHardFailure(this, result)) {
         onTkoEvent(TkoLogEvent::MarkHardTko, result);
+        health_.recordTko(true);
         startSendingProbes();
       }
     } else if (isSoftTkoErrorResult(result)) {
       if (tracker->recordSoftFailure(this, result)) {
         onTkoEvent(TkoLogEvent::MarkSoftTko, result);
+        health_.recordTko(true);
         startSendingProbes();
       }
     }
@@ -133,6 +173,7 @@ void ProxyDestination::handleTko(const mc_res_t result, bool is_probe_req) {
   if (tracker->isTko()) {
     if (is_probe_req && tracker->recordSuccess(this)) {
       onTkoEvent(TkoLogEvent::UnMarkTko, result);
+      health_.recordTko(false);
       stopSendingProbes();
     }
     return;
@@ -222,10 +263,18 @@ void ProxyDestination::onReply(
     stats_.results = std::make_unique<std::array<uint64_t, mc_nres>>();
   }
   ++(*stats_.results)[result];
-  destreqCtx.endTime = nowUs();
+  // Network latency samples feed failover and TKO decisions; keep them on
+  // the precise clock rather than the coarse ticker.
+  destreqCtx.endTime = nowUsPrecise();
 
   int64_t latency = destreqCtx.endTime - destreqCtx.startTime;
   stats_.avgLatency.insertSample(latency);
+  stats_.latencyUsHistogram.insertSample(latency);
+  health_.recordReply(
+      result,
+      /* slowLatency */ static_cast<double>(latency) >
+          2 * stats_.avgLatency.value(),
+      rpcStatsContext.serverLoad.percentLoad());
 
   if (accessPoint_->compressed()) {
     if (rpcStatsContext.usedCodecId > 0) {
@@ -239,6 +288,7 @@ void ProxyDestination::onReply(
     proxy.stats().increment(
         reply_traffic_after_compression_stat,
         rpcStatsContext.replySizeAfterCompression);
+    handleCompressionEfficiency(rpcStatsContext);
   }
 
   proxy.stats().increment(destination_reqs_total_sum_stat);
@@ -247,6 +297,106 @@ void ProxyDestination::onReply(
   }
 
   handleRxmittingConnection(result, latency);
+  handleLatencyTko(destreqCtx.endTime);
+}
+
+void ProxyDestination::handleLatencyTko(uint64_t nowUs) {
+  const auto multiplier = proxy.router().opts().latency_tko_multiplier;
+  if (multiplier == 0) {
+    return;
+  }
+  if (tracker->isTko()) {
+    latencyTkoExceededSinceUs_ = 0;
+    return;
+  }
+  if (nowUs < latencyTkoLastCheckUs_ + kLatencyTkoCheckIntervalUs) {
+    return;
+  }
+  latencyTkoLastCheckUs_ = nowUs;
+
+  auto* poolStats = proxy.stats().getPoolStats(stats_.poolStatIndex_);
+  if (poolStats == nullptr) {
+    latencyTkoExceededSinceUs_ = 0;
+    return;
+  }
+  const auto poolMedianUs =
+      poolStats->durationUsHistogram().estimatePercentile(50.0);
+  if (poolMedianUs == 0) {
+    // Pool histogram is empty (latency-histogram-sample-rate is off or the
+    // pool hasn't seen traffic yet): nothing to compare against.
+    latencyTkoExceededSinceUs_ = 0;
+    return;
+  }
+  if (stats_.latencyUsHistogram.estimatePercentile(95.0) <
+      multiplier * poolMedianUs) {
+    latencyTkoExceededSinceUs_ = 0;
+    return;
+  }
+  if (latencyTkoExceededSinceUs_ == 0) {
+    latencyTkoExceededSinceUs_ = nowUs;
+    return;
+  }
+  if (nowUs - latencyTkoExceededSinceUs_ <
+      proxy.router().opts().latency_tko_window_ms * 1000) {
+    return;
+  }
+  latencyTkoExceededSinceUs_ = 0;
+
+  // The sustained window stands in for failures-until-tko consecutive
+  // errors, so feed the tracker enough soft failures in one go to cross
+  // its threshold. Bound the loop by the threshold: concurrent successes
+  // from other proxies may reset the count, in which case we simply retry
+  // on a later check while the condition persists.
+  const auto threshold = proxy.router().opts().failures_until_tko;
+  for (int i = 0; i < threshold && !tracker->isTko(); ++i) {
+    if (tracker->recordSoftFailure(this, mc_res_timeout)) {
+      onTkoEvent(TkoLogEvent::MarkSoftTko, mc_res_timeout);
+      health_.recordTko(true);
+      startSendingProbes();
+      proxy.stats().increment(latency_tko_marks_stat);
+      break;
+    }
+  }
+}
+
+void ProxyDestination::handleCompressionEfficiency(
+    const RpcStatsContext& rpcStatsContext) {
+  const auto minSavingsPct =
+      proxy.router().opts().compression_auto_disable_savings_pct;
+  if (minSavingsPct == 0 || compressionDisabled_) {
+    return;
+  }
+  // Only replies the server actually compressed count: codec CPU is only
+  // spent on those, and the server already skips replies it deems not
+  // worth compressing.
+  if (rpcStatsContext.usedCodecId == 0 ||
+      rpcStatsContext.replySizeBeforeCompression == 0) {
+    return;
+  }
+  compressionWindowBytesBefore_ += rpcStatsContext.replySizeBeforeCompression;
+  compressionWindowBytesAfter_ += rpcStatsContext.replySizeAfterCompression;
+  if (compressionWindowBytesBefore_ < kCompressionWindowBytes) {
+    return;
+  }
+  const uint64_t savedBytes =
+      compressionWindowBytesBefore_ > compressionWindowBytesAfter_
+      ? compressionWindowBytesBefore_ - compressionWindowBytesAfter_
+      : 0;
+  if (savedBytes * 100 < minSavingsPct * compressionWindowBytesBefore_) {
+    // Compressed replies aren't shrinking enough to pay for the codec
+    // CPU on either side; stop advertising codecs so the server sends
+    // this connection's replies uncompressed from here on.
+    compressionDisabled_ = true;
+    if (client_) {
+      client_->disableCompression();
+    }
+    proxy.stats().increment(compression_auto_disables_stat);
+    VLOG(1) << "Disabling compression for " << pdstnKey_ << ": saved "
+            << savedBytes << " of " << compressionWindowBytesBefore_
+            << " bytes over the last window";
+  }
+  compressionWindowBytesBefore_ = 0;
+  compressionWindowBytesAfter_ = 0;
 }
 
 size_t ProxyDestination::getPendingRequestCount() const {
@@ -375,6 +525,14 @@ void ProxyDestination::initializeAsyncMcClient() {
   options.numConnectTimeoutRetries = opts.connect_timeout_retries;
   options.connectTimeout = shortestConnectTimeout_;
   options.writeTimeout = shortestWriteTimeout_;
+  options.writeFlushDelay =
+      std::chrono::microseconds(opts.destination_flush_delay_us);
+  options.writeFlushAlign = opts.destination_flush_align;
+  options.writeFlushJitter =
+      std::chrono::microseconds(opts.destination_flush_jitter_us);
+  options.maxPacingRateBytesPerSec = opts.destination_max_pacing_rate;
+  options.maxInflightBytes = opts.target_max_inflight_bytes;
+  options.tcpZeroCopyThresholdBytes = opts.target_tcp_zero_copy_threshold;
   options.routerInfoName = routerInfoName_;
   options.payloadFormat = opts.use_compact_serialization
       ? PayloadFormat::CompactProtocolCompatibility
@@ -413,6 +571,12 @@ void ProxyDestination::initializeAsyncMcClient() {
     client_ = std::move(client);
   }
 
+  // A fresh client advertises the full codec range again, so compression
+  // gets another chance after an auto-disable on the old connection.
+  compressionDisabled_ = false;
+  compressionWindowBytesBefore_ = 0;
+  compressionWindowBytesAfter_ = 0;
+
   client_->setFlushList(&proxy.flushList());
 
   client_->setRequestStatusCallbacks(
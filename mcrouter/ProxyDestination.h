@@ -15,7 +15,9 @@
 #include <folly/Range.h>
 #include <folly/SpinLock.h>
 
+#include "mcrouter/DestinationHealth.h"
 #include "mcrouter/ExponentialSmoothData.h"
+#include "mcrouter/LatencyHistogram.h"
 #include "mcrouter/TkoLog.h"
 #include "mcrouter/config.h"
 #include "mcrouter/lib/Operation.h"
@@ -31,6 +33,7 @@ namespace memcache {
 struct AccessPoint;
 class AsyncMcClient;
 struct RpcStatsContext;
+struct SerializedRequestBodyCache;
 
 namespace mcrouter {
 
@@ -58,6 +61,11 @@ class ProxyDestination {
   struct Stats {
     State state{State::kNew};
     ExponentialSmoothData<16> avgLatency;
+    // Full latency distribution, so routes and stats can query tail
+    // percentiles that the smoothed average hides. Written from the
+    // proxy thread only; cross-thread reads (stats polling) are
+    // approximate, like the rest of the stats pipeline.
+    LatencyHistogram latencyUsHistogram;
     std::unique_ptr<std::array<uint64_t, mc_nres>> results;
     size_t probesSent{0};
     double retransPerKByte{0.0};
@@ -83,13 +91,17 @@ class ProxyDestination {
    * @param requestContext      Context about this request.
    * @param timeout             The timeout of this call.
    * @param rpcStatsContext     Output argument with stats about the RPC
+   * @param bodyCache           Optional serialized-body cache shared across
+   *                            resends of the same request (see
+   *                            SerializedRequestBodyCache); caret only.
    */
   template <class Request>
   ReplyT<Request> send(
       const Request& request,
       DestinationRequestCtx& requestContext,
       std::chrono::milliseconds timeout,
-      RpcStatsContext& rpcStatsContext);
+      RpcStatsContext& rpcStatsContext,
+      SerializedRequestBodyCache* bodyCache = nullptr);
 
   // returns true if okay to send req using this client
   bool maySend(mc_res_t& tkoReason) const;
@@ -101,6 +113,14 @@ class ProxyDestination {
     return stats_;
   }
 
+  /**
+   * Fused availability score for this destination in [0.0, 1.0]; see
+   * DestinationHealth. 1.0 is fully healthy, 0.0 is TKO.
+   */
+  double availabilityScore() const {
+    return health_.score();
+  }
+
   const std::shared_ptr<const AccessPoint>& accessPoint() const {
     return accessPoint_;
   }
@@ -138,15 +158,29 @@ class ProxyDestination {
   const folly::StringPiece routerInfoName_;
 
   Stats stats_;
+  DestinationHealth health_;
 
   uint64_t lastRetransCycles_{0}; // Cycles when restransmits were last fetched
   uint64_t rxmitsToCloseConnection_{0};
   uint64_t lastConnCloseCycles_{0}; // Cycles when connection was last closed
 
+  // When the latency TKO condition was last evaluated, and since when it
+  // has held continuously (0 if it doesn't hold). See handleLatencyTko().
+  uint64_t latencyTkoLastCheckUs_{0};
+  uint64_t latencyTkoExceededSinceUs_{0};
+
+  // Pre/post-compression bytes of compressed replies accumulated over
+  // the current measurement window; see handleCompressionEfficiency().
+  uint64_t compressionWindowBytesBefore_{0};
+  uint64_t compressionWindowBytesAfter_{0};
+  bool compressionDisabled_{false};
+
   int probe_delay_next_ms{0};
   bool probeInflight_{false};
-  // The string is stored in ProxyDestinationMap::destinations_
-  folly::StringPiece pdstnKey_; ///< consists of ap, server_timeout
+  bool warmUpInflight_{false};
+  // Interned (ap, server_timeout) id, key in ProxyDestinationMap
+  uint64_t pdstnId_{0};
+  std::string pdstnKey_; ///< human-readable form of ap, server_timeout
 
   std::unique_ptr<folly::AsyncTimeout> probeTimer_;
 
@@ -172,6 +206,14 @@ class ProxyDestination {
   void startSendingProbes();
   void stopSendingProbes();
 
+  /**
+   * Pings the destination with a version command, establishing the
+   * connection if it is closed. No-op if there is traffic (or an earlier
+   * warm-up ping) in flight. Called by ProxyDestinationMap's warm up
+   * timer on the proxy thread.
+   */
+  void warmUp();
+
   void scheduleNextProbe();
 
   void handleTko(const mc_res_t result, bool is_probe_req);
@@ -198,6 +240,21 @@ class ProxyDestination {
 
   void handleRxmittingConnection(const mc_res_t result, uint64_t latency);
 
+  /**
+   * Marks this destination soft TKO if its tail latency has stayed above
+   * latency_tko_multiplier times the pool median for latency_tko_window_ms,
+   * so probes and failover engage before hard timeouts accumulate.
+   */
+  void handleLatencyTko(uint64_t nowUs);
+
+  /**
+   * Tracks how well replies from this destination actually compress and
+   * stops advertising codecs on the connection once the measured savings
+   * stay below compression_auto_disable_savings_pct, so incompressible
+   * workloads don't keep paying codec CPU.
+   */
+  void handleCompressionEfficiency(const RpcStatsContext& rpcStatsContext);
+
   bool latencyAboveThreshold(uint64_t latency);
 
   void onTransitionToState(State state);
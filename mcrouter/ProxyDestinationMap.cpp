@@ -19,6 +19,7 @@
 #include "mcrouter/ProxyDestination.h"
 #include "mcrouter/lib/fbi/cpp/util.h"
 #include "mcrouter/lib/network/AccessPoint.h"
+#include "mcrouter/lib/network/DnsResolutionCache.h"
 
 namespace facebook {
 namespace memcache {
@@ -38,6 +39,20 @@ std::string genProxyDestinationKey(
   }
 }
 
+uint64_t genProxyDestinationId(
+    const AccessPoint& ap,
+    std::chrono::milliseconds timeout) {
+  if (ap.getProtocol() == mc_ascii_protocol) {
+    // Distinct timeouts need distinct destinations for ASCII (see
+    // genProxyDestinationKey); ids are well below 2^32, so the
+    // timeout-qualified keys can't collide with the plain ones.
+    return (static_cast<uint64_t>(ap.uniqueId()) << 32) |
+        (static_cast<uint64_t>(timeout.count()) & 0xffffffffu);
+  } else {
+    return ap.uniqueId();
+  }
+}
+
 } // anonymous
 
 struct ProxyDestinationMap::StateList {
@@ -58,13 +73,34 @@ std::shared_ptr<ProxyDestination> ProxyDestinationMap::emplace(
     uint64_t qosClass,
     uint64_t qosPath,
     folly::StringPiece routerInfoName) {
+  auto id = genProxyDestinationId(*ap, timeout);
+  {
+    std::lock_guard<std::mutex> lck(destinationsLock_);
+    if (auto destination = find(id)) {
+      return destination;
+    }
+  }
+  // We run at configuration time, before the new config is swapped in:
+  // start resolving the hostname now so the first connect (and every
+  // reconnect, via the periodic refresh) finds the address cached.
+  if (!ap->isUnixDomainSocket()) {
+    if (auto dnsCache = DnsResolutionCacheSingleton::try_get_fast()) {
+      dnsCache->preResolve(ap->getHost());
+    }
+  }
   auto key = genProxyDestinationKey(*ap, timeout);
   auto destination = ProxyDestination::create(
       *proxy_, std::move(ap), timeout, qosClass, qosPath, routerInfoName);
   {
     std::lock_guard<std::mutex> lck(destinationsLock_);
-    auto destIt = destinations_.emplace(key, destination);
-    destination->pdstnKey_ = destIt.first->first;
+    auto destIt = destinations_.emplace(id, destination);
+    if (!destIt.second) {
+      // The existing entry may hold an expired weak_ptr from a destination
+      // that was removed after the lookup above.
+      destIt.first->second = destination;
+    }
+    destination->pdstnId_ = id;
+    destination->pdstnKey_ = std::move(key);
   }
 
   // Update shared area of ProxyDestinations with same key from different
@@ -82,17 +118,17 @@ std::shared_ptr<ProxyDestination> ProxyDestinationMap::emplace(
 std::shared_ptr<ProxyDestination> ProxyDestinationMap::find(
     const AccessPoint& ap,
     std::chrono::milliseconds timeout) const {
-  auto key = genProxyDestinationKey(ap, timeout);
+  auto id = genProxyDestinationId(ap, timeout);
   {
     std::lock_guard<std::mutex> lck(destinationsLock_);
-    return find(key);
+    return find(id);
   }
 }
 
 // Note: caller must be holding destionationsLock_.
 std::shared_ptr<ProxyDestination> ProxyDestinationMap::find(
-    const std::string& key) const {
-  auto it = destinations_.find(key);
+    uint64_t id) const {
+  auto it = destinations_.find(id);
   if (it == destinations_.end()) {
     return nullptr;
   }
@@ -107,7 +143,7 @@ void ProxyDestinationMap::removeDestination(ProxyDestination& destination) {
   }
   {
     std::lock_guard<std::mutex> lck(destinationsLock_);
-    destinations_.erase(destination.pdstnKey_);
+    destinations_.erase(destination.pdstnId_);
   }
 }
 
@@ -152,6 +188,46 @@ void ProxyDestinationMap::scheduleTimer(bool initialAttempt) {
   }
 }
 
+void ProxyDestinationMap::setWarmUpTimer(std::chrono::milliseconds interval) {
+  assert(interval.count() > 0);
+  warmUpInterval_ = static_cast<uint32_t>(interval.count());
+  warmUpTimer_ =
+      folly::AsyncTimeout::make(proxy_->eventBase(), [this]() noexcept {
+        warmUpConnections();
+        scheduleWarmUpTimer(false /* initialAttempt */);
+      });
+  scheduleWarmUpTimer(true /* initialAttempt */);
+}
+
+void ProxyDestinationMap::scheduleWarmUpTimer(bool initialAttempt) {
+  if (!warmUpTimer_->scheduleTimeout(warmUpInterval_)) {
+    MC_LOG_FAILURE(
+        proxy_->router().opts(),
+        memcache::failure::Category::kSystemError,
+        "failed to {}schedule connection warm up timer",
+        initialAttempt ? "" : "re-");
+  }
+}
+
+void ProxyDestinationMap::warmUpConnections() {
+  // We run on the proxy thread here, so released references don't need
+  // to be bounced through the event base like in
+  // foreachDestinationSynced().
+  std::vector<std::shared_ptr<ProxyDestination>> toWarmUp;
+  {
+    std::lock_guard<std::mutex> lock(destinationsLock_);
+    toWarmUp.reserve(destinations_.size());
+    for (auto& it : destinations_) {
+      if (auto dst = it.second.lock()) {
+        toWarmUp.push_back(std::move(dst));
+      }
+    }
+  }
+  for (auto& dst : toWarmUp) {
+    dst->warmUp();
+  }
+}
+
 void ProxyDestinationMap::releaseProxyDestinationRef(
     std::shared_ptr<const ProxyDestination>&& destination) {
   ProxyBase& proxy = destination->proxy;
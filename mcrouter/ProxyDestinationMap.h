@@ -15,7 +15,6 @@
 #include <vector>
 
 #include <folly/Range.h>
-#include <folly/experimental/StringKeyedUnorderedMap.h>
 #include <folly/io/async/AsyncTimeout.h>
 
 namespace facebook {
@@ -88,8 +87,17 @@ class ProxyDestinationMap {
   void setResetTimer(std::chrono::milliseconds interval);
 
   /**
-   * Calls f(Key, const ProxyDestination&) for each destination stored
-   * in ProxyDestinationMap. The whole map is locked during the call.
+   * Set timer which periodically pings stored destinations, eagerly
+   * establishing their connections and keeping established ones warm.
+   * @param interval timer interval, should be greater than zero.
+   */
+  void setWarmUpTimer(std::chrono::milliseconds interval);
+
+  /**
+   * Calls f(key, const ProxyDestination&) for each destination stored
+   * in ProxyDestinationMap, where key is the destination's
+   * human-readable (ap, server_timeout) form. The whole map is locked
+   * during the call.
    *
    * TODO: replace with getStats()
    */
@@ -98,7 +106,7 @@ class ProxyDestinationMap {
     std::lock_guard<std::mutex> lock(destinationsLock_);
     for (auto& it : destinations_) {
       if (std::shared_ptr<const ProxyDestination> dst = it.second.lock()) {
-        f(it.first, *dst);
+        f(folly::StringPiece(dst->pdstnKey_), *dst);
         // Disposal of the ProxyDestination object should execute on the proxy
         // thread to prevent races in accessing members of ProxyDestination
         // that are only accessed within eventbase-executed methods.
@@ -113,7 +121,13 @@ class ProxyDestinationMap {
   struct StateList;
 
   ProxyBase* proxy_;
-  folly::StringKeyedUnorderedMap<std::weak_ptr<ProxyDestination>> destinations_;
+  // Keyed by the interned (AccessPoint::uniqueId(), timeout) id, so
+  // reconfigurations look destinations up without building and hashing
+  // host:port strings.
+  std::unordered_map<uint64_t, std::weak_ptr<ProxyDestination>> destinations_;
+  // Guards destinations_ against cross-thread readers (stats collection via
+  // foreachDestinationSynced). find/emplace run at (re)configuration time
+  // only; the per-request path never takes this lock.
   mutable std::mutex destinationsLock_;
 
   std::unique_ptr<StateList> active_;
@@ -122,12 +136,15 @@ class ProxyDestinationMap {
   uint32_t inactivityTimeout_;
   std::unique_ptr<folly::AsyncTimeout> resetTimer_;
 
+  uint32_t warmUpInterval_{0};
+  std::unique_ptr<folly::AsyncTimeout> warmUpTimer_;
+
   /**
    * If ProxyDestination is already stored in this object - returns it;
    * otherwise, returns nullptr.
    * Note: caller must be holding destionationsLock_.
    */
-  std::shared_ptr<ProxyDestination> find(const std::string& key) const;
+  std::shared_ptr<ProxyDestination> find(uint64_t id) const;
 
   /**
    * Schedules timeout for resetting inactive connections.
@@ -136,6 +153,19 @@ class ProxyDestinationMap {
    */
   void scheduleTimer(bool initialAttempt);
 
+  /**
+   * Schedules timeout for warming up connections.
+   *
+   * @param initial  true iff this an initial attempt to schedule timer.
+   */
+  void scheduleWarmUpTimer(bool initialAttempt);
+
+  /**
+   * Pings every stored destination that has no traffic in flight.
+   * Must be called on the proxy thread.
+   */
+  void warmUpConnections();
+
   /*
    * Releases the shared_ptr reference on the destination's event-base.
    */
@@ -40,7 +40,7 @@ ProxyRequestContext::~ProxyRequestContext() {
 
   if (requester_) {
     if (requester_->maxOutstanding() != 0) {
-      counting_sem_post(requester_->outstandingReqsSem(), 1);
+      counting_sem_sharded_post(requester_->outstandingReqsSem(), 1);
     }
   }
 
@@ -12,6 +12,7 @@
 
 #include <folly/Range.h>
 #include <folly/fibers/FiberManager.h>
+#include <folly/memory/Arena.h>
 
 #include "mcrouter/ProxyRequestPriority.h"
 #include "mcrouter/config-impl.h"
@@ -134,6 +135,18 @@ class ProxyRequestContext {
     return finalResult_;
   }
 
+  /**
+   * Bump arena for transient allocations with request lifetime (failover
+   * policy state, temporary request copies, log contexts). All memory is
+   * reclaimed at once when this context is destroyed; destructors are not
+   * run, so only use it for trivially destructible state or via
+   * folly::StlAllocator-backed containers that are themselves
+   * arena-allocated. The first block is not allocated until first use.
+   */
+  folly::SysArena& requestArena() {
+    return requestArena_;
+  }
+
  protected:
   /**
    * The function that will be called when all replies (including async)
@@ -171,6 +184,10 @@ class ProxyRequestContext {
 
   uint64_t senderIdForTest_{0};
 
+  // 512 bytes covers typical route-handle transients; larger requests chain
+  // additional blocks.
+  folly::SysArena requestArena_{512};
+
   std::string userIpAddr_;
 
   ProxyRequestPriority priority_{ProxyRequestPriority::kCritical};
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+/**
+ * Thread-local freelist of raw memory blocks for proxy request contexts.
+ *
+ * Contexts are allocated once per request and freed once the reply is
+ * delivered, so at steady state on a proxy thread the malloc/free pair per
+ * request collapses into a pop/push on this list.  Blocks freed on a thread
+ * other than the allocating one simply land on the freeing thread's list,
+ * where subsequent allocations on that thread (e.g. the server request
+ * path) pick them up.
+ *
+ * The list is capped; blocks beyond the cap go back to the allocator, so a
+ * thread that only ever frees (and never allocates) contexts holds a
+ * bounded amount of memory.
+ */
+template <class T>
+class ProxyRequestContextPool {
+ public:
+  static void* allocate() {
+    auto& blocks = freeBlocks();
+    if (!blocks.empty()) {
+      void* p = blocks.back();
+      blocks.pop_back();
+      return p;
+    }
+    return ::operator new(sizeof(T));
+  }
+
+  static void deallocate(void* p) noexcept {
+    if (p == nullptr) {
+      return;
+    }
+    auto& blocks = freeBlocks();
+    if (blocks.size() < kMaxPooledBlocks) {
+      blocks.push_back(p);
+      return;
+    }
+    ::operator delete(p);
+  }
+
+ private:
+  static constexpr size_t kMaxPooledBlocks = 1024;
+
+  struct Freelist {
+    std::vector<void*> blocks;
+
+    ~Freelist() {
+      for (auto p : blocks) {
+        ::operator delete(p);
+      }
+    }
+  };
+
+  static std::vector<void*>& freeBlocks() {
+    thread_local Freelist list;
+    return list.blocks;
+  }
+};
+
+/**
+ * Mixin providing pooled operator new/delete for a concrete proxy request
+ * context type.  Deleting through a ProxyRequestContext* finds these
+ * overloads via the virtual destructor.
+ */
+template <class Derived>
+class ProxyRequestContextPooled {
+ public:
+  static void* operator new(size_t bytes) {
+    assert(bytes == sizeof(Derived));
+    return ProxyRequestContextPool<Derived>::allocate();
+  }
+
+  static void operator delete(void* p) {
+    ProxyRequestContextPool<Derived>::deallocate(p);
+  }
+};
+
+} // mcrouter
+} // memcache
+} // facebook
@@ -5,7 +5,12 @@
  *  file in the root directory of this source tree.
  *
  */
+#include <folly/Likely.h>
+
+#include "mcrouter/CarbonRouterInstanceBase.h"
 #include "mcrouter/Proxy.h"
+#include "mcrouter/ProxyRequestContextPool.h"
+#include "mcrouter/lib/AuxiliaryCPUThreadPool.h"
 #include "mcrouter/lib/McKey.h"
 #include "mcrouter/lib/fbi/cpp/TypeList.h"
 #include "mcrouter/lib/network/CarbonMessageList.h"
@@ -19,10 +24,17 @@ namespace detail {
 
 /**
  * Implementation class for storing the callback along with the context.
+ *
+ * Contexts are allocated from a thread-local pool (see
+ * ProxyRequestContextPool.h), so the steady-state per-request malloc/free
+ * pair disappears.  The class must stay final for the pool's size
+ * assumption to hold.
  */
 template <class RouterInfo, class Request, class F>
-class ProxyRequestContextTypedWithCallback
-    : public ProxyRequestContextTyped<RouterInfo, Request> {
+class ProxyRequestContextTypedWithCallback final
+    : public ProxyRequestContextTyped<RouterInfo, Request>,
+      public ProxyRequestContextPooled<
+          ProxyRequestContextTypedWithCallback<RouterInfo, Request, F>> {
  public:
   ProxyRequestContextTypedWithCallback(
       Proxy<RouterInfo>& pr,
@@ -150,6 +162,27 @@ void ProxyRequestContextTyped<RouterInfo, Request>::sendReply(
   }
 }
 
+template <class RouterInfo, class Request>
+ProxyRequestContextTyped<RouterInfo, Request>::~ProxyRequestContextTyped() {
+  // A request that survives a config swap may hold the last reference to
+  // the retired tree, and we're destroyed on the proxy thread. Hand the
+  // reference to the auxiliary CPU pool so a potential destructor storm
+  // happens off the request path, mirroring OLD_CONFIG reclamation in
+  // Proxy::messageReady. If the pool is already gone (shutdown), release
+  // inline; nothing is latency-sensitive anymore at that point.
+  if (UNLIKELY(config_ && config_->retired())) {
+    if (auto threadPool = AuxiliaryCPUThreadPoolSingleton::try_get()) {
+      auto& instance = this->proxy_.router();
+      instance.incPendingConfigReclamations();
+      threadPool->getThreadPool().add(
+          [config = std::move(config_), &instance]() mutable {
+            config.reset();
+            instance.decPendingConfigReclamations();
+          });
+    }
+  }
+}
+
 template <class RouterInfo, class Request>
 void ProxyRequestContextTyped<RouterInfo, Request>::startProcessing() {
   std::unique_ptr<ProxyRequestContextTyped<RouterInfo, Request>> self(this);
@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <type_traits>
+
 #include <folly/Utility.h>
 
 #include "mcrouter/ProxyRequestContext.h"
@@ -40,6 +42,19 @@ struct RouterAdditionalLogger<
   using type = typename RouterInfo::AdditionalLogger;
 };
 
+/**
+ * Loggers opt out of per-request logging entirely by declaring
+ * 'static constexpr bool enabled = false'; loggers that don't declare
+ * the flag are treated as enabled.
+ */
+template <class Logger, class U = void>
+struct AdditionalLoggerEnabled : std::true_type {};
+template <class Logger>
+struct AdditionalLoggerEnabled<
+    Logger,
+    typename Void<decltype(Logger::enabled)>::type>
+    : std::integral_constant<bool, Logger::enabled> {};
+
 } // detail
 
 template <class RouterInfo>
@@ -123,7 +138,14 @@ class ProxyRequestContextWithInfo : public ProxyRequestContext {
 
     if (auto poolStats = proxy_.stats().getPoolStats(poolStatIndex)) {
       poolStats->incrementRequestCount(1);
+      // Exact wire sizes already computed during (de)serialization; zero
+      // for locally synthesized replies, which put no bytes on the wire.
+      poolStats->addRequestBytes(rpcStatsContext.requestBodySize);
+      poolStats->addReplyBytes(rpcStatsContext.replySizeAfterCompression);
       poolStats->addDurationSample(endTimeUs - startTimeUs);
+      poolStats->addDurationHistogramSample(
+          endTimeUs - startTimeUs,
+          proxy_.router().opts().latency_histogram_sample_rate);
     }
     RequestLoggerContext loggerContext(
         poolName,
@@ -136,8 +158,10 @@ class ProxyRequestContextWithInfo : public ProxyRequestContext {
         rpcStatsContext);
     assert(logger_.hasValue());
     logger_->template log<Request>(loggerContext);
-    assert(additionalLogger_.hasValue());
-    additionalLogger_->log(request, reply, loggerContext);
+    if (detail::AdditionalLoggerEnabled<AdditionalLogger>::value) {
+      assert(additionalLogger_.hasValue());
+      additionalLogger_->log(request, reply, loggerContext);
+    }
   }
 
  private:
@@ -150,8 +174,11 @@ class ProxyRequestContextWithInfo : public ProxyRequestContext {
       ProxyRequestPriority priority__)
       : ProxyRequestContext(pr, priority__),
         proxy_(pr),
-        logger_(folly::in_place, pr),
-        additionalLogger_(folly::in_place, *this) {}
+        logger_(folly::in_place, pr) {
+    if (detail::AdditionalLoggerEnabled<AdditionalLogger>::value) {
+      additionalLogger_.emplace(*this);
+    }
+  }
 
   Proxy<RouterInfo>& proxy_;
 
@@ -203,6 +230,8 @@ class ProxyRequestContextTyped
 
   void startProcessing() final;
 
+  ~ProxyRequestContextTyped() override;
+
   const ProxyConfig<RouterInfo>& proxyConfig() const {
     assert(!this->recording());
     return *config_;
@@ -27,15 +27,19 @@ void ProxyStats::aggregate(size_t statId) {
     ++numBinsUsed_;
   }
 
+  // The owning proxy thread updates these counters with relaxed atomics
+  // and no lock, so read and reset them the same way (see stat_incr()).
   for (int j = 0; j < num_stats; ++j) {
     if (stats_[j].group & rate_stats) {
       statsNumWithinWindow_[j] -= statsBin_[j][statId];
-      statsBin_[j][statId] = stats_[j].data.uint64;
+      statsBin_[j][statId] =
+          __atomic_load_n(&stats_[j].data.uint64, __ATOMIC_RELAXED);
       statsNumWithinWindow_[j] += statsBin_[j][statId];
-      stats_[j].data.uint64 = 0;
+      __atomic_store_n(&stats_[j].data.uint64, 0, __ATOMIC_RELAXED);
     } else if (stats_[j].group & (max_stats | max_max_stats)) {
-      statsBin_[j][statId] = stats_[j].data.uint64;
-      stats_[j].data.uint64 = 0;
+      statsBin_[j][statId] =
+          __atomic_load_n(&stats_[j].data.uint64, __ATOMIC_RELAXED);
+      __atomic_store_n(&stats_[j].data.uint64, 0, __ATOMIC_RELAXED);
     }
   }
 }
@@ -44,6 +48,15 @@ std::unique_lock<std::mutex> ProxyStats::lock() const {
   return std::unique_lock<std::mutex>(mutex_);
 }
 
+std::vector<uint64_t> ProxyStats::snapshotCounters() const {
+  std::vector<uint64_t> values(num_stats);
+  auto guard = lock();
+  for (size_t i = 0; i < num_stats; ++i) {
+    values[i] = stat_get_uint64(stats_, static_cast<stat_name_t>(i));
+  }
+  return values;
+}
+
 } // namespace mcrouter
 } // namespace memcache
 } // namespace facebook
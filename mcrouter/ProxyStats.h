@@ -40,6 +40,10 @@ class ProxyStats {
     return durationUs_;
   }
 
+  ExponentialSmoothData<64>& loopDurationUs() {
+    return loopDurationUs_;
+  }
+
   ExponentialSmoothData<64>& durationGetUs() {
     return durationGetUs_;
   }
@@ -141,6 +145,14 @@ class ProxyStats {
   uint64_t getValue(stat_name_t stat) const {
     return stat_get_uint64(stats_, stat);
   }
+
+  /**
+   * Binary snapshot of all raw counter values, indexed by stat_name_t.
+   * Takes the stats lock only for the duration of the copy, so pollers that
+   * don't need the string-formatted reply can read all counters without
+   * stalling this proxy for longer than a memcpy.
+   */
+  std::vector<uint64_t> snapshotCounters() const;
   uint64_t getConfigAge(uint64_t now) const {
     return stat_get_config_age(stats_, now);
   }
@@ -173,6 +185,19 @@ class ProxyStats {
     return &poolStats_[idx];
   }
 
+  /**
+   * Returns pointer to the pool stats entry with the given pool name, or
+   * nullptr if this proxy doesn't track stats for that pool.
+   */
+  const PoolStats* getPoolStatsByName(folly::StringPiece poolName) const {
+    for (const auto& poolStats : poolStats_) {
+      if (poolStats.poolName() == poolName) {
+        return &poolStats;
+      }
+    }
+    return nullptr;
+  }
+
  private:
   mutable std::mutex mutex_;
   stat_t stats_[num_stats]{};
@@ -180,6 +205,10 @@ class ProxyStats {
   std::vector<PoolStats> poolStats_;
 
   ExponentialSmoothData<64> durationUs_;
+  // Wall time between consecutive event loop iterations (includes time
+  // parked in epoll, so saturation shows up as iterations that are both
+  // long and all-CPU; see proxy_threads_cpu_time_us).
+  ExponentialSmoothData<64> loopDurationUs_;
   // Duration microseconds, broken down by get-like request type
   ExponentialSmoothData<64> durationGetUs_;
   // Duration microseconds, broken down by update-like request type
@@ -15,10 +15,15 @@ namespace mcrouter {
 
 inline ProxyThread::ProxyThread(
     const CarbonRouterInstanceBase& router,
-    size_t /* id */) {
+    size_t id) {
   thread_.start();
-  getEventBase().runInEventBaseThreadAndWait(
-      [&] { mcrouterSetThisThreadName(router.opts(), "mcrpxy"); });
+  getEventBase().runInEventBaseThreadAndWait([&] {
+    mcrouterSetThisThreadName(router.opts(), "mcrpxy");
+    // Pin before binding the arena so the arena's first chunks are
+    // faulted in on the node the thread will run on.
+    mcrouterBindThisThreadToNumaNode(router.opts(), id);
+    mcrouterBindThisThreadToNewArena(router.opts());
+  });
 }
 
 inline void ProxyThread::stopAndJoin() noexcept {
@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2016-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+
+#include <folly/Range.h>
+#include <folly/experimental/StringKeyedUnorderedMap.h>
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+/**
+ * Aggregates sampled route handle paths, flamegraph style: each sample is
+ * a folded root-to-leaf path of route handle names ("proxy;failover|...")
+ * weighted by the sampled request's duration. Since requests run on
+ * fibers, native profilers only see trampolines; this keys samples on the
+ * route handle chain instead, which maps directly back to config
+ * subtrees.
+ *
+ * shouldSample() is called per request by the owning proxy thread and is
+ * a couple of comparisons; the mutex is only taken when a sample actually
+ * fires (at most the configured rate) and when dumping.
+ */
+class RouteHandleProfiler {
+ public:
+  /**
+   * Rate-limiting check, called on the hot path by the owning proxy
+   * thread only. Returns true at most "hz" times per second.
+   *
+   * @param nowUs  Current time, in us (same clock throughout).
+   * @param hz     Target sample rate; 0 disables sampling.
+   */
+  bool shouldSample(int64_t nowUs, uint64_t hz) {
+    if (hz == 0 || nowUs < nextSampleUs_) {
+      return false;
+    }
+    nextSampleUs_ = nowUs + 1000000 / hz;
+    return true;
+  }
+
+  /**
+   * Record one folded path with the given weight (request duration in us).
+   */
+  void recordPath(folly::StringPiece foldedPath, uint64_t weightUs) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = weightByPath_.find(foldedPath);
+    if (it != weightByPath_.end()) {
+      it->second += weightUs;
+    } else {
+      weightByPath_.emplace(foldedPath, weightUs);
+    }
+  }
+
+  /**
+   * Copy of the aggregated weights, keyed by folded path. Safe to call
+   * from any thread.
+   */
+  folly::StringKeyedUnorderedMap<uint64_t> getWeights() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return weightByPath_;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    weightByPath_.clear();
+  }
+
+ private:
+  // Written by the owning proxy thread only; no synchronization needed.
+  int64_t nextSampleUs_{0};
+
+  mutable std::mutex mutex_;
+  folly::StringKeyedUnorderedMap<uint64_t> weightByPath_;
+};
+
+} // namespace mcrouter
+} // namespace memcache
+} // namespace facebook
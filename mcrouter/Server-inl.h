@@ -66,7 +66,9 @@ void serverLoop(
   worker.setOnRequest(RequestHandlerType(
       *routerClient,
       standaloneOpts.retain_source_ip,
-      standaloneOpts.enable_pass_through_mode));
+      standaloneOpts.enable_pass_through_mode,
+      router.opts().trace_sample_rate,
+      standaloneOpts.server_strip_reply_fields));
 
   worker.setOnConnectionAccepted(
       [proxy,
@@ -139,6 +141,10 @@ bool runServer(
 
   opts.numThreads = mcrouterOpts.num_proxies;
   opts.numListeningSockets = mcrouterOpts.num_listening_sockets;
+  if (standaloneOpts.per_worker_listening_sockets) {
+    opts.numListeningSockets = opts.numThreads;
+    opts.perWorkerListeningSockets = true;
+  }
   opts.worker.tcpZeroCopyThresholdBytes =
       standaloneOpts.tcp_zero_copy_threshold;
 
@@ -151,10 +157,18 @@ bool runServer(
   }
 
   opts.tcpListenBacklog = standaloneOpts.tcp_listen_backlog;
+  opts.tcpDeferAcceptTimeout = standaloneOpts.tcp_defer_accept_timeout;
+  opts.loadAwareAcceptSteering = standaloneOpts.load_aware_accept_steering;
   opts.worker.defaultVersionHandler = false;
   opts.worker.maxInFlight = standaloneOpts.max_client_outstanding_reqs;
+  opts.worker.maxInFlightBytes =
+      standaloneOpts.max_client_outstanding_reqs_bytes;
+  opts.worker.maxParseAheadBytes = standaloneOpts.client_parse_ahead_bytes;
+  opts.worker.multiOpStreaming = standaloneOpts.multiget_streaming;
   opts.worker.sendTimeout =
       std::chrono::milliseconds{standaloneOpts.client_timeout_ms};
+  opts.worker.connectionIdleTimeout =
+      std::chrono::seconds{standaloneOpts.client_idle_timeout_s};
   if (!mcrouterOpts.debug_fifo_root.empty()) {
     opts.worker.debugFifoPath = getServerDebugFifoFullPath(mcrouterOpts);
   }
@@ -162,6 +176,7 @@ bool runServer(
   if (standaloneOpts.server_load_interval_ms > 0) {
     opts.cpuControllerOpts.dataCollectionInterval =
         std::chrono::milliseconds(standaloneOpts.server_load_interval_ms);
+    opts.cpuControllerOpts.cpuShedLimit = standaloneOpts.server_cpu_shed_limit;
   }
 
   /* Default to one read per event to help latency-sensitive workloads.
@@ -209,6 +224,9 @@ bool runServer(
       preRunCb(*router);
     }
 
+    // Readiness gate: bind/listen happens inside spawn(), so the listen
+    // socket only opens once the router is initialized with a live config
+    // and clients never reach an unconfigured instance.
     folly::Baton<> shutdownBaton;
     server.spawn(
         [router, &standaloneOpts](
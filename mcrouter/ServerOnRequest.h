@@ -0,0 +1,231 @@
+/*
+ *  Copyright (c) 2015-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <limits>
+
+#include <folly/Likely.h>
+#include <folly/Random.h>
+
+#include "mcrouter/CarbonRouterClient.h"
+#include "mcrouter/config.h"
+#include "mcrouter/lib/carbon/Artillery.h"
+#include "mcrouter/lib/carbon/RoutingGroups.h"
+#include "mcrouter/lib/network/AsyncMcServer.h"
+#include "mcrouter/lib/network/AsyncMcServerWorker.h"
+#include "mcrouter/lib/network/CaretHeader.h"
+#include "mcrouter/lib/network/CpuController.h"
+#include "mcrouter/lib/network/McServerRequestContext.h"
+#include "mcrouter/lib/network/gen/Memcache.h"
+#include "mcrouter/lib/network/gen/MemcacheRoutingGroups.h"
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+template <class Request>
+struct ServerRequestContext {
+  McServerRequestContext ctx;
+  Request req;
+  folly::IOBuf reqBuffer;
+
+  ServerRequestContext(
+      McServerRequestContext&& ctx_,
+      Request&& req_,
+      const folly::IOBuf* reqBuffer_)
+      : ctx(std::move(ctx_)),
+        req(std::move(req_)),
+        reqBuffer(reqBuffer_ ? reqBuffer_->cloneAsValue() : folly::IOBuf()) {}
+};
+
+namespace detail {
+
+/**
+ * Maps a request type onto its CPU admission class (see CpuOpClass).
+ */
+template <class Request>
+constexpr CpuOpClass cpuOpClass() {
+  return carbon::DeleteLike<Request>::value
+      ? CpuOpClass::kDelete
+      : carbon::GetLike<Request>::value
+          ? CpuOpClass::kGet
+          : carbon::UpdateLike<Request>::value ? CpuOpClass::kUpdate
+                                               : CpuOpClass::kOther;
+}
+
+/**
+ * Clears reply fields that bandwidth-sensitive deployments told us their
+ * clients never read. Caret doesn't serialize fields holding their
+ * default value, so zeroing flags here removes them from the wire
+ * entirely. Gets replies are left alone: the cas token is their point.
+ */
+inline void stripReplyFields(McGetReply& reply) {
+  reply.flags() = 0;
+}
+
+inline void stripReplyFields(McLeaseGetReply& reply) {
+  reply.flags() = 0;
+}
+
+template <class Reply>
+void stripReplyFields(Reply&) {}
+
+} // detail
+
+template <class RouterInfo>
+class ServerOnRequest {
+ public:
+  template <class Request>
+  using ReplyFunction =
+      void (*)(McServerRequestContext&& ctx, ReplyT<Request>&& reply);
+
+  ServerOnRequest(
+      CarbonRouterClient<RouterInfo>& client,
+      bool retainSourceIp,
+      bool enablePassThroughMode,
+      uint64_t traceSampleRate = 0,
+      bool stripReplyFields = false)
+      : client_(client),
+        retainSourceIp_(retainSourceIp),
+        enablePassThroughMode_(enablePassThroughMode),
+        traceSampleRate_(traceSampleRate),
+        stripReplyFields_(stripReplyFields) {}
+
+  template <class Request>
+  void onRequest(
+      McServerRequestContext&& ctx,
+      Request&& req,
+      const UmbrellaMessageInfo* headerInfo,
+      const folly::IOBuf* reqBuffer) {
+    using Reply = ReplyT<Request>;
+    send(
+        std::move(ctx),
+        std::move(req),
+        &McServerRequestContext::reply<Reply>,
+        headerInfo,
+        reqBuffer);
+  }
+  template <class Request>
+  void onRequest(McServerRequestContext&& ctx, Request&& req) {
+    using Reply = ReplyT<Request>;
+    send(std::move(ctx), std::move(req), &McServerRequestContext::reply<Reply>);
+  }
+
+  void onRequest(McServerRequestContext&& ctx, McVersionRequest&&) {
+    McVersionReply reply(mc_res_ok);
+    reply.value() =
+        folly::IOBuf(folly::IOBuf::COPY_BUFFER, MCROUTER_PACKAGE_STRING);
+
+    McServerRequestContext::reply(std::move(ctx), std::move(reply));
+  }
+
+  void onRequest(McServerRequestContext&& ctx, McQuitRequest&&) {
+    McServerRequestContext::reply(std::move(ctx), McQuitReply(mc_res_ok));
+  }
+
+  void onRequest(McServerRequestContext&& ctx, McShutdownRequest&&) {
+    McServerRequestContext::reply(std::move(ctx), McShutdownReply(mc_res_ok));
+  }
+
+  template <class Request>
+  void send(
+      McServerRequestContext&& ctx,
+      Request&& req,
+      ReplyFunction<Request> replyFn,
+      const UmbrellaMessageInfo* headerInfo = nullptr,
+      const folly::IOBuf* reqBuffer = nullptr) {
+    // CPU-based admission control: when the server is over its CPU
+    // limit, shed the most expensive operation classes first (deletes
+    // are always admitted). Admitted requests report their handler
+    // duration back so per-class costs track the live workload.
+    constexpr auto opClass = detail::cpuOpClass<Request>();
+    CpuController* cpuController = nullptr;
+    if (const auto& cpu = ctx.session().getCpuController()) {
+      if (UNLIKELY(cpu->admissionEnabled())) {
+        if (!cpu->shouldAdmit(opClass)) {
+          replyFn(std::move(ctx), ReplyT<Request>(mc_res_busy));
+          return;
+        }
+        cpuController = cpu.get();
+      }
+    }
+    const int64_t admittedUs = cpuController ? nowUs() : 0;
+
+    // We just reuse buffers iff:
+    //  1) enablePassThroughMode_ is true.
+    //  2) headerInfo is not NULL.
+    //  3) reqBuffer is not NULL.
+    const folly::IOBuf* reusableRequestBuffer =
+        (enablePassThroughMode_ && headerInfo) ? reqBuffer : nullptr;
+
+    auto rctx = std::make_unique<ServerRequestContext<Request>>(
+        std::move(ctx), std::move(req), reusableRequestBuffer);
+    auto& reqRef = rctx->req;
+    auto& sessionRef = rctx->ctx.session();
+
+    // if we are reusing the request buffer, adjust the start offset and set
+    // it to the request.
+    if (reusableRequestBuffer) {
+      auto& reqBufferRef = rctx->reqBuffer;
+      reqBufferRef.trimStart(headerInfo->headerSize);
+      reqRef.setSerializedBuffer(reqBufferRef);
+    }
+
+    // Start a trace on every Nth request that didn't arrive with one.
+    // The context string survives request copies all the way to
+    // DestinationRoute, where it's stamped into the Caret header of
+    // downstream sends and spans are recorded.
+    if (UNLIKELY(traceSampleRate_ != 0) && reqRef.traceContext().empty() &&
+        ++requestsSinceSampled_ >= traceSampleRate_) {
+      requestsSinceSampled_ = 0;
+      reqRef.setTraceContext(carbon::tracing::deserializeTraceContext(
+          {folly::Random::rand64(1, std::numeric_limits<uint64_t>::max()),
+           folly::Random::rand64(1, std::numeric_limits<uint64_t>::max())}));
+    }
+
+    auto cb = [
+      sctx = std::move(rctx),
+      replyFn,
+      cpuController,
+      opClass,
+      admittedUs,
+      stripFields = stripReplyFields_
+    ](const Request&, ReplyT<Request>&& reply) {
+      if (UNLIKELY(cpuController != nullptr)) {
+        // The session (owned via sctx->ctx) keeps the controller alive.
+        cpuController->reportOpCost(opClass, nowUs() - admittedUs);
+      }
+      if (UNLIKELY(stripFields)) {
+        detail::stripReplyFields(reply);
+      }
+      replyFn(std::move(sctx->ctx), std::move(reply));
+    };
+
+    if (retainSourceIp_) {
+      auto peerIp = sessionRef.getSocketAddress().getAddressStr();
+      client_.send(reqRef, std::move(cb), peerIp);
+    } else {
+      client_.send(reqRef, std::move(cb));
+    }
+  }
+
+ private:
+  CarbonRouterClient<RouterInfo>& client_;
+  bool retainSourceIp_{false};
+  bool enablePassThroughMode_{false};
+  // Sample 1 in traceSampleRate_ requests for tracing; 0 disables.
+  // Per worker thread, so no synchronization is needed on the counter.
+  const uint64_t traceSampleRate_{0};
+  uint64_t requestsSinceSampled_{0};
+  // Drop fields clients don't consume from replies before serialization
+  // (see detail::stripReplyFields above).
+  const bool stripReplyFields_{false};
+};
+} // mcrouter
+} // memcache
+} // facebook
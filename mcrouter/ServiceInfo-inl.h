@@ -8,6 +8,7 @@
 #pragma once
 
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -34,6 +35,7 @@
 #include "mcrouter/options.h"
 #include "mcrouter/routes/ProxyRoute.h"
 #include "mcrouter/standalone_options.h"
+#include "mcrouter/stats.h"
 
 namespace facebook {
 namespace memcache {
@@ -190,6 +192,17 @@ struct ServiceInfo<RouterInfo>::ServiceInfoImpl {
       routeHandlesCommandDispatcher_;
   mutable detail::RouteCommandDispatcher<RouterInfo> routeCommandDispatcher_;
 
+  // Precomputed introspection state. ServiceInfo lives and dies with its
+  // config, so anything derived purely from the config can be computed
+  // once at swap time instead of per query.
+  std::string poolsDump_;
+  // Route handle tree dumps are deterministic for a given config; memoize
+  // them so tooling that polls the same keys doesn't pay for a traversal
+  // and string assembly on every query. Only accessed from the proxy
+  // thread, like the rest of this class.
+  static constexpr size_t kMaxRouteHandlesCacheSize = 1000;
+  mutable std::unordered_map<std::string, std::string> routeHandlesCache_;
+
   ServiceInfoImpl(
       Proxy<RouterInfo>& proxy,
       const ProxyConfig<RouterInfo>& config);
@@ -294,6 +307,12 @@ ServiceInfo<RouterInfo>::ServiceInfoImpl::ServiceInfoImpl(
         auto requestName = args[0];
         auto key = args[1];
 
+        auto cacheKey = folly::to<std::string>(requestName, ",", key);
+        auto cached = routeHandlesCache_.find(cacheKey);
+        if (cached != routeHandlesCache_.end()) {
+          return cached->second;
+        }
+
         auto typeId = carbon::getTypeIdByName(
             requestName, typename RouterInfo::RoutableRequests());
 
@@ -303,9 +322,30 @@ ServiceInfo<RouterInfo>::ServiceInfoImpl::ServiceInfoImpl(
           throw std::runtime_error(
               folly::sformat("route: unknown request {}", requestName));
         }
+        if (routeHandlesCache_.size() >= kMaxRouteHandlesCacheSize) {
+          routeHandlesCache_.clear();
+        }
+        routeHandlesCache_.emplace(std::move(cacheKey), res);
         return res;
       });
 
+  // Precompute the pool -> servers table; see poolsDump_.
+  {
+    folly::dynamic poolsJson = folly::dynamic::object;
+    for (const auto& it : config.getAccessPoints()) {
+      folly::dynamic servers = folly::dynamic::array;
+      for (const auto& ap : it.second) {
+        servers.push_back(ap->toHostPortString());
+      }
+      poolsJson[it.first] = std::move(servers);
+    }
+    poolsDump_ = toPrettySortedJson(poolsJson);
+  }
+  commands_.emplace(
+      "pools", [this](const std::vector<folly::StringPiece>& /* args */) {
+        return poolsDump_;
+      });
+
   commands_.emplace(
       "config_md5_digest",
       [&config](const std::vector<folly::StringPiece>& /* args */) {
@@ -335,11 +375,91 @@ ServiceInfo<RouterInfo>::ServiceInfoImpl::ServiceInfoImpl(
         return toPrettySortedJson(builder.preprocessedConfig());
       });
 
+  commands_.emplace(
+      "pool_latency_percentile",
+      [this](const std::vector<folly::StringPiece>& args) {
+        if (args.size() != 2) {
+          throw std::runtime_error(
+              "pool_latency_percentile: 2 args expected (pool, percentile)");
+        }
+        auto& router = proxy_.router();
+        if (router.opts().latency_histogram_sample_rate == 0) {
+          throw std::runtime_error(
+              "pool_latency_percentile: histograms disabled"
+              " (see latency-histogram-sample-rate)");
+        }
+        auto poolName = args[0];
+        auto percentile = folly::to<double>(args[1]);
+
+        // Merge the per-proxy-thread histograms. Reads may race with the
+        // owning threads' increments; like the rest of the stats pipeline
+        // this yields an estimate, which is all monitoring needs.
+        LatencyHistogram merged;
+        bool found = false;
+        for (size_t i = 0; i < router.opts().num_proxies; ++i) {
+          if (const auto* poolStats =
+                  router.getProxyBase(i)->stats().getPoolStatsByName(
+                      poolName)) {
+            merged.accumulate(poolStats->durationUsHistogram());
+            found = true;
+          }
+        }
+        if (!found) {
+          throw std::runtime_error(
+              "pool_latency_percentile: no stats tracked for pool " +
+              poolName.str() + " (see pool-stats-config-file)");
+        }
+        return folly::to<std::string>(merged.estimatePercentile(percentile));
+      });
+
+  commands_.emplace(
+      "route_handle_profile",
+      [this](const std::vector<folly::StringPiece>& args) {
+        auto& router = proxy_.router();
+        if (args.size() == 1 && args[0] == "clear") {
+          for (size_t i = 0; i < router.opts().num_proxies; ++i) {
+            router.getProxyBase(i)->routeHandleProfiler().clear();
+          }
+          return std::string("cleared");
+        }
+        if (!args.empty()) {
+          throw std::runtime_error(
+              "route_handle_profile: expected no args or 'clear'");
+        }
+        if (router.opts().route_handle_profiler_hz == 0) {
+          throw std::runtime_error(
+              "route_handle_profile: profiler disabled"
+              " (see route-handle-profiler-hz)");
+        }
+
+        // Merge per-proxy profiles into flamegraph folded format:
+        // one "path weight" line per route handle path, sorted so
+        // repeated queries diff cleanly.
+        std::map<std::string, uint64_t> merged;
+        for (size_t i = 0; i < router.opts().num_proxies; ++i) {
+          for (const auto& it :
+               router.getProxyBase(i)->routeHandleProfiler().getWeights()) {
+            merged[it.first.str()] += it.second;
+          }
+        }
+        std::string str;
+        for (const auto& it : merged) {
+          str.append(folly::sformat("{} {}\n", it.first, it.second));
+        }
+        return str;
+      });
+
   commands_.emplace(
       "hostid", [](const std::vector<folly::StringPiece>& /* args */) {
         return folly::to<std::string>(globals::hostid());
       });
 
+  commands_.emplace(
+      "stats_schema",
+      [](const std::vector<folly::StringPiece>& /* args */) {
+        return stats_schema_dump();
+      });
+
   commands_.emplace(
       "verbosity", [](const std::vector<folly::StringPiece>& args) {
         if (args.size() == 1) {
@@ -12,12 +12,14 @@
 #include <sys/types.h>
 #include <time.h>
 
+#include <array>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include <folly/Conv.h>
+#include <folly/io/IOBuf.h>
 
 #include "mcrouter/CarbonRouterInstance.h"
 #include "mcrouter/McrouterLogFailure.h"
@@ -25,6 +27,10 @@
 #include "mcrouter/Server.h"
 #include "mcrouter/StandaloneConfig.h"
 #include "mcrouter/config.h"
+#include "mcrouter/lib/Ch3HashFunc.h"
+#include "mcrouter/lib/network/McAsciiParser.h"
+#include "mcrouter/lib/network/McSerializedRequest.h"
+#include "mcrouter/lib/network/gen/Memcache.h"
 #include "mcrouter/options.h"
 #include "mcrouter/standalone_options.h"
 #include "mcrouter/stats.h"
@@ -178,12 +184,71 @@ void validateConfigAndExit(const McrouterOptions& libmcrouterOptions) {
   _exit(0);
 }
 
+/**
+ * Runs synthetic traffic through the hot request-processing code paths
+ * (ascii request parser, ascii/caret serializers, consistent hashing)
+ * before the listen socket opens. After a restart these paths are cold:
+ * code pages are not faulted in, branch predictors are untrained and
+ * lazily initialized statics have not been constructed, so the first
+ * real requests pay extra latency. Everything here stays in-process;
+ * nothing is sent to real destinations.
+ */
+void warmUpRequestPaths(size_t numRequests) {
+  struct WarmUpOnRequest {
+    template <class Request>
+    void onRequest(Request&&, bool) {}
+    void multiOpEnd() {}
+  };
+
+  WarmUpOnRequest onRequest;
+  McServerAsciiParser parser(onRequest);
+
+  // Representative request shapes: single get, multiget, set, delete.
+  const std::array<folly::StringPiece, 4> asciiRequests{
+      {"get warmup:key:0\r\n",
+       "get warmup:key:0 warmup:key:1 warmup:key:2 warmup:key:3\r\n",
+       "set warmup:key:0 0 0 10\r\nwarmupdata\r\n",
+       "delete warmup:key:0\r\n"}};
+  // A few pool sizes so more than one furc_hash tree depth is exercised.
+  const std::array<Ch3HashFunc, 3> hashFuncs{
+      {Ch3HashFunc(2), Ch3HashFunc(25), Ch3HashFunc(500)}};
+
+  size_t sink = 0;
+  for (size_t i = 0; i < numRequests; ++i) {
+    auto buffer =
+        folly::IOBuf::copyBuffer(asciiRequests[i % asciiRequests.size()]);
+    parser.consume(*buffer);
+
+    const auto key = folly::to<std::string>("warmup:key:", i % 16);
+    McGetRequest get(key);
+    McSerializedRequest asciiGet(
+        get, i, mc_ascii_protocol, CodecIdRange::Empty);
+    McSerializedRequest caretGet(
+        get, i, mc_caret_protocol, CodecIdRange::Empty);
+    McSetRequest set(key);
+    set.value() = folly::IOBuf(folly::IOBuf::COPY_BUFFER, "warmupdata");
+    McSerializedRequest asciiSet(
+        set, i, mc_ascii_protocol, CodecIdRange::Empty);
+    McSerializedRequest caretSet(
+        set, i, mc_caret_protocol, CodecIdRange::Empty);
+
+    for (const auto& hashFunc : hashFuncs) {
+      sink += hashFunc(key);
+    }
+  }
+  // Keep the hash results observable so the loop is not optimized away.
+  VLOG(1) << "Warmup pass done, checksum " << sink;
+}
+
 template <class RouterInfo, template <class> class RequestHandler>
 void run(
     const McrouterOptions& libmcrouterOptions,
     const McrouterStandaloneOptions& standaloneOptions,
     StandalonePreRunCb preRunCb) {
   LOG(INFO) << "Starting " << RouterInfo::name << " router";
+  if (standaloneOptions.startup_warmup_requests > 0) {
+    warmUpRequestPaths(standaloneOptions.startup_warmup_requests);
+  }
   if (!runServer<RouterInfo, RequestHandler>(
           libmcrouterOptions, standaloneOptions, std::move(preRunCb))) {
     exit(kExitStatusTransientError);
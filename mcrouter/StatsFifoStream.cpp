@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include "StatsFifoStream.h"
+
+#include <sys/uio.h>
+
+#include <chrono>
+#include <cstring>
+
+#include <folly/Varint.h>
+
+#include "mcrouter/CarbonRouterInstanceBase.h"
+#include "mcrouter/OptionsUtil.h"
+#include "mcrouter/lib/debug/Fifo.h"
+#include "mcrouter/lib/debug/FifoManager.h"
+#include "mcrouter/options.h"
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+namespace {
+
+bool isNumericStat(const stat_t& stat) {
+  return stat.type == stat_uint64 || stat.type == stat_int64 ||
+      stat.type == stat_double;
+}
+
+uint64_t rawValue(const stat_t& stat) {
+  switch (stat.type) {
+    case stat_uint64:
+      return stat.data.uint64;
+    case stat_int64:
+      return static_cast<uint64_t>(stat.data.int64);
+    case stat_double: {
+      uint64_t bits;
+      static_assert(
+          sizeof(bits) == sizeof(stat.data.dbl), "unexpected double size");
+      std::memcpy(&bits, &stat.data.dbl, sizeof(bits));
+      return bits;
+    }
+    default:
+      return 0;
+  }
+}
+
+} // anonymous namespace
+
+StatsFifoStream::StatsFifoStream(CarbonRouterInstanceBase& router) {
+  const auto& opts = router.opts();
+  if (opts.debug_fifo_root.empty()) {
+    return;
+  }
+  if (auto fifoManager = FifoManager::getInstance()) {
+    fifo_ = fifoManager->fetchThreadLocal(getStatsDebugFifoFullPath(opts));
+  }
+}
+
+void StatsFifoStream::writeSnapshot(const std::vector<stat_t>& stats) {
+  if (!fifo_) {
+    return;
+  }
+  if (!fifo_->isConnected()) {
+    // Forget the baseline so the next subscriber starts from a full
+    // snapshot.
+    havePrev_ = false;
+    return;
+  }
+
+  bool full = !havePrev_;
+  if (prevValues_.size() != stats.size()) {
+    prevValues_.assign(stats.size(), 0);
+    full = true;
+  }
+
+  std::vector<uint8_t> body;
+  body.reserve(stats.size() * 4);
+  uint8_t varintBuf[folly::kMaxVarintLength64];
+  uint32_t numEntries = 0;
+  for (size_t i = 0; i < stats.size(); ++i) {
+    if (!isNumericStat(stats[i])) {
+      continue;
+    }
+    const uint64_t cur = rawValue(stats[i]);
+    if (!full && cur == prevValues_[i]) {
+      continue;
+    }
+    const uint64_t prev = full ? 0 : prevValues_[i];
+    auto len = folly::encodeVarint(i, varintBuf);
+    body.insert(body.end(), varintBuf, varintBuf + len);
+    len = folly::encodeVarint(
+        folly::encodeZigZag(static_cast<int64_t>(cur - prev)), varintBuf);
+    body.insert(body.end(), varintBuf, varintBuf + len);
+    prevValues_[i] = cur;
+    ++numEntries;
+  }
+
+  static const uint64_t schemaHash = stats_schema_hash();
+
+  StatsSnapshotHeader header;
+  header.setFullSnapshot(full);
+  header.setNumEntries(numEntries);
+  header.setSchemaHash(schemaHash);
+  header.setTimestampMs(std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::system_clock::now().time_since_epoch())
+                            .count());
+
+  struct iovec iov[2];
+  iov[0].iov_base = &header;
+  iov[0].iov_len = sizeof(header);
+  iov[1].iov_base = body.data();
+  iov[1].iov_len = body.size();
+  if (fifo_->write(iov, body.empty() ? 1 : 2)) {
+    havePrev_ = true;
+  } else {
+    // Pipe full or reader gone; resend absolute values next time so the
+    // subscriber never applies deltas to a snapshot it missed.
+    havePrev_ = false;
+  }
+}
+
+} // namespace mcrouter
+} // namespace memcache
+} // namespace facebook
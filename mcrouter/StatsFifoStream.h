@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <folly/Portability.h>
+#include <folly/lang/Bits.h>
+
+#include "mcrouter/stats.h"
+
+namespace facebook {
+namespace memcache {
+
+class Fifo;
+
+namespace mcrouter {
+
+class CarbonRouterInstanceBase;
+
+/**
+ * Header of one binary stats snapshot, written to the stats debug fifo.
+ * All fields are little-endian. The header is followed by numEntries()
+ * entries, each a varint-encoded stat id (index into stat_list.h order)
+ * followed by a zig-zag varint delta of the stat's raw 64-bit value
+ * relative to the previous snapshot. In a full snapshot (sent to a newly
+ * connected subscriber) deltas are relative to zero, i.e. absolute
+ * values. stat_double values travel as their IEEE-754 bit pattern.
+ */
+struct FOLLY_PACK_ATTR StatsSnapshotHeader {
+ public:
+  constexpr static uint8_t kFlagFullSnapshot = 0x1;
+
+  uint32_t magic() const {
+    return folly::Endian::little(magic_);
+  }
+  uint8_t version() const {
+    return version_;
+  }
+  bool fullSnapshot() const {
+    return flags_ & kFlagFullSnapshot;
+  }
+  uint32_t numEntries() const {
+    return folly::Endian::little(numEntries_);
+  }
+  uint64_t timestampMs() const {
+    return folly::Endian::little(timestampMs_);
+  }
+  uint64_t schemaHash() const {
+    return folly::Endian::little(schemaHash_);
+  }
+
+  void setFullSnapshot(bool val) {
+    flags_ = val ? (flags_ | kFlagFullSnapshot) : (flags_ & ~kFlagFullSnapshot);
+  }
+  void setNumEntries(uint32_t val) {
+    numEntries_ = folly::Endian::little(val);
+  }
+  void setTimestampMs(uint64_t val) {
+    timestampMs_ = folly::Endian::little(val);
+  }
+  void setSchemaHash(uint64_t val) {
+    schemaHash_ = folly::Endian::little(val);
+  }
+
+ private:
+  uint32_t magic_ = folly::Endian::little<uint32_t>(0xfacb57a7);
+  uint8_t version_{2};
+  uint8_t flags_{0};
+  uint16_t padding_{0};
+  uint32_t numEntries_{0};
+  uint64_t timestampMs_{0};
+  // Version 2: hash of the stat schema (stats_schema_hash()), so a
+  // subscriber can verify its cached id -> name mapping matches this
+  // binary before applying entries.
+  uint64_t schemaHash_{0};
+};
+
+/**
+ * Pushes periodic binary stats snapshots to a debug fifo, so local
+ * subscribers (e.g. a telemetry agent) can follow counters without
+ * polling and re-parsing the JSON stats files. Stats are identified by
+ * their stat_list.h index, not by name; only entries whose value changed
+ * since the last snapshot are sent, and a full snapshot is sent whenever
+ * a subscriber (re)connects. Writes are best effort, like all fifo
+ * debug output: with no subscriber attached the cost is one flag check.
+ *
+ * Driven by McrouterLogger at stats-logging-interval cadence; not
+ * thread safe, must be called from the logger thread only.
+ */
+class StatsFifoStream {
+ public:
+  explicit StatsFifoStream(CarbonRouterInstanceBase& router);
+
+  /**
+   * Writes the current stats snapshot to the fifo, if a subscriber is
+   * connected.
+   */
+  void writeSnapshot(const std::vector<stat_t>& stats);
+
+ private:
+  std::shared_ptr<Fifo> fifo_;
+  // Raw 64-bit values of the previous snapshot, indexed by stat id.
+  std::vector<uint64_t> prevValues_;
+  bool havePrev_{false};
+};
+
+} // namespace mcrouter
+} // namespace memcache
+} // namespace facebook
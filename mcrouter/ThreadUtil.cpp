@@ -7,7 +7,16 @@
  */
 #include "ThreadUtil.h"
 
+#include <pthread.h>
+#include <sched.h>
+
+#include <string>
+#include <vector>
+
+#include <folly/FileUtil.h>
 #include <folly/Format.h>
+#include <folly/String.h>
+#include <folly/memory/Malloc.h>
 #include <folly/system/ThreadName.h>
 
 #include "mcrouter/options.h"
@@ -16,6 +25,68 @@ namespace facebook {
 namespace memcache {
 namespace mcrouter {
 
+namespace {
+
+/**
+ * Parses a sysfs cpulist ("0-7,16-23") into a cpu_set_t.
+ *
+ * @return false if the list is empty or malformed.
+ */
+bool parseCpuList(folly::StringPiece cpulist, cpu_set_t& cpus) {
+  CPU_ZERO(&cpus);
+  std::vector<folly::StringPiece> ranges;
+  folly::split(',', folly::trimWhitespace(cpulist), ranges);
+  for (auto range : ranges) {
+    try {
+      size_t first, last;
+      auto dash = range.find('-');
+      if (dash == std::string::npos) {
+        first = last = folly::to<size_t>(range);
+      } else {
+        first = folly::to<size_t>(range.subpiece(0, dash));
+        last = folly::to<size_t>(range.subpiece(dash + 1));
+      }
+      if (first > last || last >= CPU_SETSIZE) {
+        return false;
+      }
+      for (size_t cpu = first; cpu <= last; ++cpu) {
+        CPU_SET(cpu, &cpus);
+      }
+    } catch (const std::exception&) {
+      return false;
+    }
+  }
+  return CPU_COUNT(&cpus) > 0;
+}
+
+/**
+ * Reads the CPUs of each online NUMA node from sysfs. Empty if the host
+ * has a single node or the topology cannot be read.
+ */
+std::vector<cpu_set_t> readNumaTopology() {
+  std::vector<cpu_set_t> nodes;
+  for (size_t node = 0;; ++node) {
+    std::string cpulist;
+    auto path =
+        folly::format("/sys/devices/system/node/node{}/cpulist", node).str();
+    if (!folly::readFile(path.c_str(), cpulist)) {
+      break;
+    }
+    cpu_set_t cpus;
+    if (!parseCpuList(cpulist, cpus)) {
+      LOG(WARNING) << "Unable to parse " << path << ": '" << cpulist << "'";
+      return {};
+    }
+    nodes.push_back(cpus);
+  }
+  if (nodes.size() < 2) {
+    return {};
+  }
+  return nodes;
+}
+
+} // anonymous namespace
+
 void mcrouterSetThisThreadName(
     const McrouterOptions& opts,
     folly::StringPiece prefix) {
@@ -24,6 +95,51 @@ void mcrouterSetThisThreadName(
     LOG(WARNING) << "Unable to set thread name to " << name;
   }
 }
+
+void mcrouterBindThisThreadToNewArena(const McrouterOptions& opts) {
+  if (!opts.jemalloc_per_proxy_arena) {
+    return;
+  }
+  if (!folly::usingJEMalloc()) {
+    LOG(WARNING) << "--jemalloc-per-proxy-arena is set, but the binary is not"
+                    " running with jemalloc";
+    return;
+  }
+  unsigned arena = 0;
+  size_t len = sizeof(arena);
+  if (mallctl("arenas.create", &arena, &len, nullptr, 0) != 0) {
+    LOG(WARNING) << "Unable to create a dedicated jemalloc arena";
+    return;
+  }
+  if (mallctl("thread.arena", nullptr, nullptr, &arena, sizeof(arena)) != 0) {
+    LOG(WARNING) << "Unable to bind thread to jemalloc arena " << arena;
+  }
+}
+
+void mcrouterBindThisThreadToNumaNode(
+    const McrouterOptions& opts,
+    size_t proxyId) {
+  if (!opts.numa_aware_proxy_threads) {
+    return;
+  }
+  // The topology is fixed for the lifetime of the process.
+  static const std::vector<cpu_set_t> nodes = readNumaTopology();
+  if (nodes.empty()) {
+    LOG_FIRST_N(WARNING, 1)
+        << "--numa-aware-proxy-threads is set, but the host has a single"
+           " NUMA node or its topology could not be read; not pinning";
+    return;
+  }
+  size_t node = proxyId % nodes.size();
+  auto rv = pthread_setaffinity_np(
+      pthread_self(), sizeof(cpu_set_t), &nodes[node]);
+  if (rv != 0) {
+    LOG(WARNING) << "Unable to pin proxy " << proxyId << " to NUMA node "
+                 << node << ": " << folly::errnoStr(rv);
+    return;
+  }
+  VLOG(1) << "Pinned proxy " << proxyId << " to NUMA node " << node;
+}
 }
 }
 } // facebook::memcache::mcrouter
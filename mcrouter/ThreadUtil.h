@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <cstddef>
+
 #include <folly/Range.h>
 
 namespace facebook {
@@ -19,6 +21,25 @@ namespace mcrouter {
 void mcrouterSetThisThreadName(
     const McrouterOptions& opts,
     folly::StringPiece prefix);
+
+/**
+ * If opts.jemalloc_per_proxy_arena is set and the binary is running with
+ * jemalloc, creates a dedicated jemalloc arena and binds the calling thread
+ * to it. On failure logs a warning and leaves the thread on its default
+ * arena.
+ */
+void mcrouterBindThisThreadToNewArena(const McrouterOptions& opts);
+
+/**
+ * If opts.numa_aware_proxy_threads is set, pins the calling thread to the
+ * CPUs of NUMA node (proxyId % number of nodes), so proxy threads are
+ * spread evenly across nodes and their on-thread allocations are
+ * node-local under the kernel's first-touch policy. On single-node hosts
+ * or if the topology cannot be read, logs once and does nothing.
+ */
+void mcrouterBindThisThreadToNumaNode(
+    const McrouterOptions& opts,
+    size_t proxyId);
 }
 }
 } // facebook::memcache::mcrouter
@@ -20,6 +20,13 @@ struct TkoCounters {
   std::atomic<size_t> softTkos{0};
   std::atomic<size_t> hardTkos{0};
 
+  TkoCounters() = default;
+
+  // Copyable so that aggregated per-shard snapshots can be returned by value.
+  TkoCounters(const TkoCounters& other)
+      : softTkos(other.softTkos.load(std::memory_order_relaxed)),
+        hardTkos(other.hardTkos.load(std::memory_order_relaxed)) {}
+
   size_t totalTko() const {
     return softTkos + hardTkos;
   }
@@ -41,7 +41,7 @@ struct TkoLog {
   size_t probesSent{0};
   double avgLatency{0.0};
   const AccessPoint& accessPoint;
-  const TkoCounters& globalTkos;
+  const TkoCounters globalTkos;
 };
 } // namespace mcrouter
 } // namespace memcache
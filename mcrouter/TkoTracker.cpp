@@ -11,6 +11,7 @@
 #include <functional>
 
 #include <folly/MapUtil.h>
+#include <folly/hash/Hash.h>
 
 #include "mcrouter/ProxyDestination.h"
 #include "mcrouter/TkoCounters.h"
@@ -21,9 +22,11 @@ namespace mcrouter {
 
 TkoTracker::TkoTracker(
     size_t tkoThreshold,
-    TkoTrackerMap& trackerMap)
+    TkoTrackerMap& trackerMap,
+    TkoCounters& shardTkos)
     : tkoThreshold_(tkoThreshold),
-      trackerMap_(trackerMap) {}
+      trackerMap_(trackerMap),
+      shardTkos_(shardTkos) {}
 
 bool TkoTracker::isHardTko() const {
   uintptr_t curSumFailures = sumFailures_;
@@ -35,17 +38,17 @@ bool TkoTracker::isSoftTko() const {
   return (curSumFailures > tkoThreshold_ && curSumFailures % 2 == 0);
 }
 
-const TkoCounters& TkoTracker::globalTkos() const {
-  return trackerMap_.globalTkos_;
+TkoCounters TkoTracker::globalTkos() const {
+  return trackerMap_.globalTkos();
 }
 
 void TkoTracker::incrementSoftTkoCount() {
-  trackerMap_.globalTkos_.softTkos++;
+  shardTkos_.softTkos++;
 }
 
 void TkoTracker::decrementSoftTkoCount() {
   // Decrement the counter and ensure we haven't gone below 0
-  size_t oldSoftTkos = trackerMap_.globalTkos_.softTkos.fetch_sub(1);
+  size_t oldSoftTkos = shardTkos_.softTkos.fetch_sub(1);
   assert(oldSoftTkos != 0);
 }
 
@@ -121,7 +124,7 @@ bool TkoTracker::recordHardFailure(ProxyDestination* pdstn, mc_res_t result) {
     // convert to hard failure
     sumFailures_ |= 1;
     decrementSoftTkoCount();
-    ++trackerMap_.globalTkos_.hardTkos;
+    ++shardTkos_.hardTkos;
     // We've already been marked responsible
     return false;
   }
@@ -129,7 +132,7 @@ bool TkoTracker::recordHardFailure(ProxyDestination* pdstn, mc_res_t result) {
   // If the call below succeeds we marked the box TKO and took responsibility.
   bool success = setSumFailures(reinterpret_cast<uintptr_t>(pdstn) | 1);
   if (success) {
-    ++trackerMap_.globalTkos_.hardTkos;
+    ++shardTkos_.hardTkos;
     tkoReason_.store(result, std::memory_order_relaxed);
   }
   return success;
@@ -148,7 +151,7 @@ bool TkoTracker::recordSuccess(ProxyDestination* pdstn) {
       decrementSoftTkoCount();
     }
     if (isHardTko()) {
-      --trackerMap_.globalTkos_.hardTkos;
+      --shardTkos_.hardTkos;
     }
     sumFailures_ = 0;
     consecutiveFailureCount_ = 0;
@@ -181,22 +184,33 @@ TkoTracker::~TkoTracker() {
   trackerMap_.removeTracker(key_);
 }
 
+TkoTrackerMap::Shard& TkoTrackerMap::shardFor(folly::StringPiece key) {
+  return shards_[folly::hash::fnv64_buf(key.data(), key.size()) % kShards];
+}
+
+const TkoTrackerMap::Shard& TkoTrackerMap::shardFor(
+    folly::StringPiece key) const {
+  return shards_[folly::hash::fnv64_buf(key.data(), key.size()) % kShards];
+}
+
 void TkoTrackerMap::updateTracker(
     ProxyDestination& pdstn,
     const size_t tkoThreshold) {
   auto key = pdstn.accessPoint()->toHostPortString();
+  auto& shard = shardFor(key);
 
-  // This shared pointer has to be destroyed after releasing "mx_".
+  // This shared pointer has to be destroyed after releasing the shard lock.
   // The reason is that when "tracker" goes out of scope, we might destroy
-  // the TkoTracker it points to, which would again try to lock "mx_"
+  // the TkoTracker it points to, which would again try to lock the shard
   // (triggering an UB).
   std::shared_ptr<TkoTracker> tracker;
   {
-    std::lock_guard<std::mutex> lock(mx_);
-    auto it = trackers_.find(key);
-    if (it == trackers_.end() || (tracker = it->second.lock()) == nullptr) {
-      tracker.reset(new TkoTracker(tkoThreshold, *this));
-      auto trackerIt = trackers_.emplace(key, tracker);
+    std::lock_guard<std::mutex> lock(shard.mx);
+    auto it = shard.trackers.find(key);
+    if (it == shard.trackers.end() ||
+        (tracker = it->second.lock()) == nullptr) {
+      tracker.reset(new TkoTracker(tkoThreshold, *this, shard.tkos));
+      auto trackerIt = shard.trackers.emplace(key, tracker);
       if (!trackerIt.second) {
         trackerIt.first->second = tracker;
       }
@@ -219,6 +233,23 @@ TkoTrackerMap::getSuspectServers() const {
   return result;
 }
 
+std::pair<bool, size_t> TkoTrackerMap::getServerHealth(
+    folly::StringPiece host) const {
+  bool isTko = false;
+  size_t failures = 0;
+  foreachTkoTracker(
+      [&isTko, &failures, host](
+          folly::StringPiece key, const TkoTracker& tracker) mutable {
+        // Destination keys embed the host (possibly bracketed for ipv6)
+        // followed by port, protocol etc.; substring match covers both.
+        if (key.find(host) != folly::StringPiece::npos) {
+          isTko = isTko || tracker.isTko();
+          failures = std::max(failures, tracker.consecutiveFailureCount());
+        }
+      });
+  return std::make_pair(isTko, failures);
+}
+
 size_t TkoTrackerMap::getSuspectServersCount() const {
   size_t result = 0;
   foreachTkoTracker(
@@ -236,17 +267,18 @@ void TkoTrackerMap::foreachTkoTracker(
   // we release the lock. This is done to avoid the following race:
   // After successfully locking the weak_ptr, we might become the last
   // holder of the shared_ptr to TkoTracker. If that's the case, it would
-  // trigger destruction of TkoTracker, which would try to grab "mx_" and
-  // remove itself from the map.
+  // trigger destruction of TkoTracker, which would try to grab the shard
+  // lock and remove itself from the map.
   // If we didn't have the lock, this would case two issues:
-  //  - We would try to lock "mx_" again from the same thread (which is UB).
-  //  - We would change "trackers_" while iterating over it.
+  //  - We would try to lock the shard again from the same thread (which is
+  //    UB).
+  //  - We would change the shard's "trackers" while iterating over it.
   std::vector<std::shared_ptr<TkoTracker>> lockedTrackers;
-  lockedTrackers.reserve(trackers_.size());
 
-  {
-    std::lock_guard<std::mutex> lock(mx_);
-    for (const auto& it : trackers_) {
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mx);
+    lockedTrackers.reserve(lockedTrackers.size() + shard.trackers.size());
+    for (const auto& it : shard.trackers) {
       if (auto tracker = it.second.lock()) {
         func(it.first, *tracker);
         lockedTrackers.emplace_back(std::move(tracker));
@@ -255,11 +287,21 @@ void TkoTrackerMap::foreachTkoTracker(
   }
 }
 
+TkoCounters TkoTrackerMap::globalTkos() const {
+  TkoCounters result;
+  for (const auto& shard : shards_) {
+    result.softTkos += shard.tkos.softTkos.load(std::memory_order_relaxed);
+    result.hardTkos += shard.tkos.hardTkos.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
 void TkoTrackerMap::removeTracker(folly::StringPiece key) noexcept {
-  std::lock_guard<std::mutex> lock(mx_);
-  auto it = trackers_.find(key);
-  if (it != trackers_.end()) {
-    trackers_.erase(it);
+  auto& shard = shardFor(key);
+  std::lock_guard<std::mutex> lock(shard.mx);
+  auto it = shard.trackers.find(key);
+  if (it != shard.trackers.end()) {
+    shard.trackers.erase(it);
   }
 }
 
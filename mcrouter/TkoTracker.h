@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <functional>
 #include <memory>
@@ -89,9 +90,10 @@ class TkoTracker {
   }
 
   /**
-   * @return number of TKO destinations for current router
+   * @return number of TKO destinations for current router, aggregated
+   *         across all TkoTrackerMap shards.
    */
-  const TkoCounters& globalTkos() const;
+  TkoCounters globalTkos() const;
 
   /**
    * Can be called from any proxy thread.
@@ -148,10 +150,12 @@ class TkoTracker {
   ~TkoTracker();
 
  private:
-  // The string is stored in TkoTrackerMap::trackers_
+  // The string is stored in the owning TkoTrackerMap shard.
   folly::StringPiece key_;
   const size_t tkoThreshold_;
   TkoTrackerMap& trackerMap_;
+  // TKO counters of the owning TkoTrackerMap shard.
+  TkoCounters& shardTkos_;
 
   /**
    * sumFailures_ is used for a few things depending on the state of the
@@ -190,11 +194,15 @@ class TkoTracker {
   bool isResponsible(ProxyDestination* pdstn) const;
 
   /**
-   * @param tkoThreshold    Require this many soft failures to mark
-   *                        the destination TKO.
-   * @param globalTkoStats  Number of TKO destination for current router.
+   * @param tkoThreshold  Require this many soft failures to mark
+   *                      the destination TKO.
+   * @param trackerMap    Owning map.
+   * @param shardTkos     TKO counters of the owning map shard.
    */
-  TkoTracker(size_t tkoThreshold, TkoTrackerMap& trackerMap);
+  TkoTracker(
+      size_t tkoThreshold,
+      TkoTrackerMap& trackerMap,
+      TkoCounters& shardTkos);
 
   friend class TkoTrackerMap;
 };
@@ -228,16 +236,38 @@ class TkoTrackerMap {
   std::unordered_map<std::string, std::pair<bool, size_t>> getSuspectServers()
       const;
 
-  const TkoCounters& globalTkos() const {
-    return globalTkos_;
-  }
+  /**
+   * Aggregated health of a server across all its trackers (there is one
+   * per distinct timeout for ascii destinations).
+   *
+   * @param host  hostname or ip as it appears in destination keys.
+   * @return  (is any tracker for the server TKO,
+   *           highest consecutive failure count among them).
+   *          (false, 0) for unknown servers.
+   */
+  std::pair<bool, size_t> getServerHealth(folly::StringPiece host) const;
+
+  /**
+   * @return  total number of boxes marked as TKO, aggregated across shards.
+   */
+  TkoCounters globalTkos() const;
 
  private:
-  mutable std::mutex mx_;
-  folly::StringKeyedUnorderedMap<std::weak_ptr<TkoTracker>> trackers_;
+  // Sharded by destination key hash so that proxy threads recording
+  // failures for different destinations don't convoy on a single lock.
+  constexpr static size_t kShards = 16;
+
+  struct alignas(64) Shard {
+    mutable std::mutex mx;
+    folly::StringKeyedUnorderedMap<std::weak_ptr<TkoTracker>> trackers;
+    // Number of boxes in this shard marked as TKO.
+    TkoCounters tkos;
+  };
+
+  std::array<Shard, kShards> shards_;
 
-  // Total number of boxes marked as TKO.
-  TkoCounters globalTkos_;
+  Shard& shardFor(folly::StringPiece key);
+  const Shard& shardFor(folly::StringPiece key) const;
 
   void removeTracker(folly::StringPiece key) noexcept;
 
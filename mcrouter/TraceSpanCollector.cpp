@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2016-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include "mcrouter/TraceSpanCollector.h"
+
+#include <fcntl.h>
+
+#include <memory>
+
+#include <folly/Conv.h>
+#include <folly/File.h>
+#include <folly/FileUtil.h>
+#include <folly/json.h>
+#include <glog/logging.h>
+
+#include "mcrouter/AsyncWriter.h"
+#include "mcrouter/CarbonRouterInstanceBase.h"
+#include "mcrouter/OptionsUtil.h"
+#include "mcrouter/options.h"
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+namespace {
+
+std::string buildTraceFilePath(const McrouterOptions& opts) {
+  if (opts.trace_sample_rate == 0 || opts.stats_root.empty()) {
+    return "";
+  }
+  return folly::to<std::string>(
+      opts.stats_root, "/", getStatPrefix(opts), ".traces");
+}
+
+} // anonymous namespace
+
+constexpr size_t TraceSpanCollector::kMaxBufferedSpans;
+
+TraceSpanCollector::TraceSpanCollector(
+    CarbonRouterInstanceBase& router,
+    size_t proxyId)
+    : router_(router),
+      proxyId_(proxyId),
+      traceFilePath_(buildTraceFilePath(router.opts())) {
+  if (enabled()) {
+    spans_.reserve(kMaxBufferedSpans);
+  }
+}
+
+void TraceSpanCollector::record(TraceSpan span) {
+  if (!enabled()) {
+    return;
+  }
+  spans_.push_back(std::move(span));
+  if (spans_.size() >= kMaxBufferedSpans) {
+    flush();
+  }
+}
+
+void TraceSpanCollector::flush() {
+  auto statsLogger = router_.statsLogWriter();
+  if (!statsLogger) {
+    spans_.clear();
+    return;
+  }
+  // shared_ptr only because AsyncWriter takes a copyable std::function.
+  auto batch = std::make_shared<std::vector<TraceSpan>>();
+  batch->reserve(kMaxBufferedSpans);
+  batch->swap(spans_);
+  const auto scheduled = statsLogger->run(
+      [batch = std::move(batch), path = traceFilePath_, proxyId = proxyId_]() {
+        std::string out;
+        for (const auto& span : *batch) {
+          folly::dynamic json = folly::dynamic::object
+              ("trace_id", span.traceId.first)
+              ("node_id", span.traceId.second)
+              ("proxy_id", proxyId)
+              ("request", span.requestName)
+              ("destination", span.destination)
+              ("start_time_us", span.startTimeUs)
+              ("duration_us", span.durationUs)
+              ("result", mc_res_to_string(span.result));
+          out += folly::toJson(json);
+          out += '\n';
+        }
+        try {
+          folly::File file(path, O_CREAT | O_WRONLY | O_APPEND);
+          // One writeFull per batch, so lines from different proxies
+          // never interleave mid-record.
+          folly::writeFull(file.fd(), out.data(), out.size());
+        } catch (const std::exception& e) {
+          VLOG(1) << "Failed to write trace spans to " << path << ": "
+                  << e.what();
+        }
+      });
+  if (!scheduled) {
+    VLOG(1) << "Trace span batch dropped: stats log writer queue is full";
+  }
+}
+
+} // mcrouter
+} // memcache
+} // facebook
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2016-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mcrouter/lib/mc/msg.h"
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+class CarbonRouterInstanceBase;
+
+/**
+ * One downstream hop of a sampled request: which destination served it,
+ * when the send started and how long it took. The trace/node id pair is
+ * the same one stamped into the Caret header, so spans from the client,
+ * mcrouter and the server can be joined on it.
+ */
+struct TraceSpan {
+  std::pair<uint64_t, uint64_t> traceId{0, 0};
+  const char* requestName{""};
+  std::string destination;
+  int64_t startTimeUs{0};
+  int64_t durationUs{0};
+  mc_res_t result{mc_res_unknown};
+};
+
+/**
+ * Fixed-capacity span buffer owned by one proxy thread. DestinationRoute
+ * appends a span for every reply to a sampled request (see
+ * --trace-sample-rate); full batches are handed to the stats AsyncWriter,
+ * which appends them as JSON lines to <stats-root>/<stat prefix>.traces.
+ * The request path therefore pays an in-memory append and an occasional
+ * batch handoff, never a disk write.
+ *
+ * record() must only be called from the owning proxy thread; the writes
+ * happen on the stats log writer thread.
+ */
+class TraceSpanCollector {
+ public:
+  TraceSpanCollector(CarbonRouterInstanceBase& router, size_t proxyId);
+
+  /**
+   * Tells whether spans should be collected at all, i.e. sampling is
+   * configured and there is a stats root to write traces under.
+   */
+  bool enabled() const {
+    return !traceFilePath_.empty();
+  }
+
+  void record(TraceSpan span);
+
+ private:
+  // Spans buffered in memory before a batch is handed to the writer.
+  static constexpr size_t kMaxBufferedSpans = 1024;
+
+  void flush();
+
+  CarbonRouterInstanceBase& router_;
+  const size_t proxyId_;
+  // Empty when tracing is disabled.
+  const std::string traceFilePath_;
+  std::vector<TraceSpan> spans_;
+};
+
+} // mcrouter
+} // memcache
+} // facebook
@@ -7,6 +7,13 @@
  */
 #include "Clocks.h"
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <folly/system/ThreadName.h>
+
 namespace facebook {
 namespace memcache {
 namespace cycles {
@@ -32,5 +39,61 @@ uint64_t getCpuCycles() noexcept {
 }
 
 } // cycles
+
+namespace coarse {
+
+namespace {
+
+constexpr auto kTickInterval = std::chrono::microseconds(100);
+
+int64_t preciseNowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// The ticker thread is the only writer; keep the value on its own
+// cacheline so readers don't share it with the ticker bookkeeping below.
+alignas(64) std::atomic<int64_t> coarseNowUs{0};
+
+std::mutex tickerLock;
+size_t tickerRefCount{0};
+std::atomic<bool> tickerStop{false};
+std::thread tickerThread;
+
+} // anonymous
+
+int64_t nowUs() noexcept {
+  return coarseNowUs.load(std::memory_order_relaxed);
+}
+
+TickerGuard::TickerGuard() {
+  std::lock_guard<std::mutex> lock(tickerLock);
+  if (tickerRefCount++ == 0) {
+    coarseNowUs.store(preciseNowUs(), std::memory_order_relaxed);
+    tickerStop.store(false, std::memory_order_relaxed);
+    tickerThread = std::thread([]() {
+      folly::setThreadName("mcr-coarse-clk");
+      while (!tickerStop.load(std::memory_order_relaxed)) {
+        coarseNowUs.store(preciseNowUs(), std::memory_order_relaxed);
+        /* sleep override */
+        std::this_thread::sleep_for(kTickInterval);
+      }
+    });
+  }
+}
+
+TickerGuard::~TickerGuard() {
+  std::lock_guard<std::mutex> lock(tickerLock);
+  if (--tickerRefCount == 0) {
+    tickerStop.store(true, std::memory_order_relaxed);
+    tickerThread.join();
+    // Let nowUs() report that no ticker is running, so callers fall back
+    // to precise clock reads instead of seeing a frozen timestamp.
+    coarseNowUs.store(0, std::memory_order_relaxed);
+  }
+}
+
+} // coarse
 } // memcache
 } // facebook
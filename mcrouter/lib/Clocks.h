@@ -26,5 +26,34 @@ namespace cycles {
 uint64_t getCpuCycles() noexcept;
 
 } // cycles
+
+namespace coarse {
+
+/**
+ * Returns coarse monotonic time in microseconds, read as a single relaxed
+ * atomic load with no system call. The value is refreshed by a process-wide
+ * ticker thread roughly every 100us, so it may lag a precise clock read by
+ * up to one tick.
+ * Returns 0 if no ticker is running (see TickerGuard); callers are expected
+ * to fall back to a precise clock read in that case.
+ * Thread-safe.
+ */
+int64_t nowUs() noexcept;
+
+/**
+ * Keeps the process-wide ticker thread updating the coarse clock while at
+ * least one guard is alive. Guards are refcounted, so multiple router
+ * instances share a single ticker thread.
+ */
+class TickerGuard {
+ public:
+  TickerGuard();
+  ~TickerGuard();
+
+  TickerGuard(const TickerGuard&) = delete;
+  TickerGuard& operator=(const TickerGuard&) = delete;
+};
+
+} // coarse
 } // memcache
 } // facebook
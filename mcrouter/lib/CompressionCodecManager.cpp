@@ -39,13 +39,9 @@ bool isApplicable(const CompressionCodec* codec, const size_t bodySize) {
  ***************************/
 CompressionCodecManager::CompressionCodecManager(
     std::unordered_map<uint32_t, CodecConfigPtr> codecConfigs)
-    : codecConfigs_(std::move(codecConfigs)), compressionCodecMap_([this]() {
-        return folly::fibers::runInMainContext(
-            [this]() { return buildCodecMap(); });
-      }) {
+    : codecConfigs_(std::move(codecConfigs)) {
   // Validate all dictionaries
   std::vector<uint32_t> badCodecConfigs;
-  int64_t largestId = 0;
   for (const auto& it : codecConfigs_) {
     auto codecId = it.first;
     const auto& config = it.second;
@@ -58,7 +54,6 @@ CompressionCodecManager::CompressionCodecManager(
           codecId,
           config->filteringOptions,
           config->compressionLevel);
-      largestId = std::max<int64_t>(largestId, codecId);
     } catch (const std::exception& e) {
       badCodecConfigs.push_back(codecId);
       LOG(ERROR) << "Compression codec config [" << codecId << "] is invalid.";
@@ -68,29 +63,72 @@ CompressionCodecManager::CompressionCodecManager(
     codecConfigs_.erase(id);
   }
 
-  if (!codecConfigs_.empty()) {
-    // Get the longest contiguous range ending in 'largestId'
+  recomputeCodecRange();
+}
+
+void CompressionCodecManager::recomputeCodecRange() {
+  if (codecConfigs_.empty()) {
     smallestCodecId_ = 0;
-    for (int64_t i = largestId - 1; i >= 0; --i) {
-      const auto& it = codecConfigs_.find(i);
-      if (it == codecConfigs_.end()) {
-        smallestCodecId_ = i + 1;
-        break;
-      }
-    }
-    size_ = largestId - smallestCodecId_ + 1;
-    LOG(INFO) << "Using " << size_ << " compression codecs (range: ["
-              << smallestCodecId_ << ", " << largestId << "])";
-  } else {
+    size_ = 0;
     LOG(WARNING) << "No valid compression codec found. Compression disabled.";
+    return;
+  }
+
+  int64_t largestId = 0;
+  for (const auto& it : codecConfigs_) {
+    largestId = std::max<int64_t>(largestId, it.first);
   }
+
+  // Get the longest contiguous range ending in 'largestId'
+  smallestCodecId_ = 0;
+  for (int64_t i = largestId - 1; i >= 0; --i) {
+    const auto& it = codecConfigs_.find(i);
+    if (it == codecConfigs_.end()) {
+      smallestCodecId_ = i + 1;
+      break;
+    }
+  }
+  size_ = largestId - smallestCodecId_ + 1;
+  LOG(INFO) << "Using " << size_ << " compression codecs (range: ["
+            << smallestCodecId_ << ", " << largestId << "])";
+}
+
+void CompressionCodecManager::updateCodecConfig(CodecConfigPtr config) {
+  // Throws if the dictionary is invalid; never poison the active configs.
+  createCompressionCodec(
+      config->codecType,
+      folly::IOBuf::wrapBuffer(
+          config->dictionary.data(), config->dictionary.size()),
+      config->id,
+      config->filteringOptions,
+      config->compressionLevel);
+
+  {
+    folly::SharedMutex::WriteHolder wlock(configLock_);
+    auto id = config->id;
+    codecConfigs_[id] = std::move(config);
+    recomputeCodecRange();
+  }
+  version_.fetch_add(1, std::memory_order_release);
 }
 
 const CompressionCodecMap* CompressionCodecManager::getCodecMap() const {
-  return compressionCodecMap_.get();
+  auto& tlMap = *compressionCodecMap_;
+  const auto version = version_.load(std::memory_order_acquire);
+  if (!tlMap.map || tlMap.version != version) {
+    auto newMap = folly::fibers::runInMainContext(
+        [this]() { return buildCodecMap(); });
+    if (tlMap.map) {
+      tlMap.retired.push_back(std::move(tlMap.map));
+    }
+    tlMap.map.reset(newMap);
+    tlMap.version = version;
+  }
+  return tlMap.map.get();
 }
 
-CompressionCodecMap* CompressionCodecManager::buildCodecMap() {
+CompressionCodecMap* CompressionCodecManager::buildCodecMap() const {
+  folly::SharedMutex::ReadHolder rlock(configLock_);
   if (size_ == 0) {
     return new CompressionCodecMap();
   }
@@ -7,12 +7,14 @@
  */
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <limits>
 #include <memory>
 #include <unordered_map>
 #include <vector>
 
+#include <folly/SharedMutex.h>
 #include <folly/ThreadLocal.h>
 
 #include "mcrouter/lib/Compression.h"
@@ -60,16 +62,43 @@ class CompressionCodecManager {
    */
   const CompressionCodecMap* getCodecMap() const;
 
+  /**
+   * Register or replace one codec config at runtime (e.g. with a freshly
+   * trained dictionary, see CompressionDictionaryTrainer) without a config
+   * push. Threads lazily rebuild their codec map on the next getCodecMap()
+   * call. The caller is responsible for only using codec ids the peer also
+   * knows the dictionary for.
+   * Note: thread-safe.
+   *
+   * @throws std::exception if the config's dictionary is invalid.
+   */
+  void updateCodecConfig(CodecConfigPtr config);
+
  private:
+  struct ThreadLocalMap {
+    std::unique_ptr<CompressionCodecMap> map;
+    // Superseded maps of this thread. Sessions cache raw CompressionCodecMap
+    // pointers, so retired maps must stay alive; updates are rare (training
+    // cadence) and maps are small, so this stays tiny.
+    std::vector<std::unique_ptr<CompressionCodecMap>> retired;
+    uint64_t version{0};
+  };
+
+  // Guards codecConfigs_ and the codec id range below.
+  mutable folly::SharedMutex configLock_;
   // Storage of compression codec configs (codecId -> codecConfig).
   std::unordered_map<uint32_t, CodecConfigPtr> codecConfigs_;
   // ThreadLocal of compression codec map, as codecs are not thread-safe.
-  folly::ThreadLocal<CompressionCodecMap> compressionCodecMap_;
+  folly::ThreadLocal<ThreadLocalMap> compressionCodecMap_;
   // Codec id range
   uint32_t smallestCodecId_{0};
   uint32_t size_{0};
+  // Bumped on every config update; threads with a stale version rebuild.
+  std::atomic<uint64_t> version_{1};
 
-  CompressionCodecMap* buildCodecMap();
+  CompressionCodecMap* buildCodecMap() const;
+  // Recomputes smallestCodecId_/size_. configLock_ must be held exclusively.
+  void recomputeCodecRange();
 };
 
 /**
@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include "CompressionDictionaryTrainer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#include <folly/Format.h>
+#include <folly/Random.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+
+#if FOLLY_HAVE_LIBZSTD && !defined(DISABLE_COMPRESSION)
+#include <zdict.h>
+#endif
+
+namespace facebook {
+namespace memcache {
+
+namespace {
+
+// zstd needs a reasonable spread of samples to produce a dictionary that
+// generalizes; below this we'd rather keep sampling than train on noise.
+constexpr size_t kMinSamplesToTrain = 64;
+
+} // anonymous namespace
+
+CompressionDictionaryTrainer::CompressionDictionaryTrainer(
+    size_t samplesPerTypeId,
+    size_t maxSampleSize,
+    size_t dictionarySize)
+    : samplesPerTypeId_(samplesPerTypeId),
+      maxSampleSize_(maxSampleSize),
+      dictionarySize_(dictionarySize) {
+  assert(samplesPerTypeId_ >= kMinSamplesToTrain);
+  assert(maxSampleSize_ > 0);
+  assert(dictionarySize_ > 0);
+}
+
+void CompressionDictionaryTrainer::sample(
+    size_t typeId,
+    const folly::IOBuf& value) {
+  if (value.empty()) {
+    return;
+  }
+  auto& reservoir = getReservoir(typeId);
+
+  // Vitter's algorithm R: the i-th value replaces a random slot with
+  // probability capacity/i, which keeps the reservoir a uniform sample.
+  // The rejected (common) case never takes the lock.
+  const auto seen = reservoir.seen.fetch_add(1, std::memory_order_relaxed) + 1;
+  size_t slot;
+  if (seen <= samplesPerTypeId_) {
+    slot = seen - 1;
+  } else {
+    slot = folly::Random::rand64(seen);
+    if (slot >= samplesPerTypeId_) {
+      return;
+    }
+  }
+
+  folly::io::Cursor cursor(&value);
+  auto data = cursor.peekBytes();
+  std::string copy;
+  copy.reserve(std::min(value.computeChainDataLength(), maxSampleSize_));
+  while (!data.empty() && copy.size() < maxSampleSize_) {
+    const auto toCopy = std::min(data.size(), maxSampleSize_ - copy.size());
+    copy.append(reinterpret_cast<const char*>(data.data()), toCopy);
+    cursor.skip(toCopy);
+    data = cursor.peekBytes();
+  }
+
+  std::lock_guard<std::mutex> guard(reservoir.lock);
+  if (slot < reservoir.samples.size()) {
+    reservoir.samples[slot] = std::move(copy);
+  } else if (reservoir.samples.size() < samplesPerTypeId_) {
+    reservoir.samples.push_back(std::move(copy));
+  }
+}
+
+bool CompressionDictionaryTrainer::hasEnoughSamples(size_t typeId) const {
+  const auto* reservoir = findReservoir(typeId);
+  if (reservoir == nullptr) {
+    return false;
+  }
+  std::lock_guard<std::mutex> guard(reservoir->lock);
+  return reservoir->samples.size() >= kMinSamplesToTrain;
+}
+
+uint64_t CompressionDictionaryTrainer::valuesSeen(size_t typeId) const {
+  const auto* reservoir = findReservoir(typeId);
+  return reservoir == nullptr
+      ? 0
+      : reservoir->seen.load(std::memory_order_relaxed);
+}
+
+std::string CompressionDictionaryTrainer::trainDictionary(
+    size_t typeId) const {
+#if FOLLY_HAVE_LIBZSTD && !defined(DISABLE_COMPRESSION)
+  std::vector<std::string> samples;
+  if (const auto* reservoir = findReservoir(typeId)) {
+    std::lock_guard<std::mutex> guard(reservoir->lock);
+    samples = reservoir->samples;
+  }
+  if (samples.size() < kMinSamplesToTrain) {
+    throw std::runtime_error(folly::sformat(
+        "Not enough samples to train dictionary for type id {}: {} < {}",
+        typeId,
+        samples.size(),
+        kMinSamplesToTrain));
+  }
+
+  std::string buffer;
+  std::vector<size_t> sampleSizes;
+  sampleSizes.reserve(samples.size());
+  for (const auto& s : samples) {
+    buffer.append(s);
+    sampleSizes.push_back(s.size());
+  }
+
+  std::string dictionary;
+  dictionary.resize(dictionarySize_);
+  const auto bytes = ZDICT_trainFromBuffer(
+      &dictionary.front(),
+      dictionary.size(),
+      buffer.data(),
+      sampleSizes.data(),
+      sampleSizes.size());
+  if (ZDICT_isError(bytes)) {
+    throw std::runtime_error(folly::sformat(
+        "Failed to train dictionary for type id {}: {}",
+        typeId,
+        ZDICT_getErrorName(bytes)));
+  }
+  dictionary.resize(bytes);
+  return dictionary;
+#else
+  throw std::runtime_error(folly::sformat(
+      "Cannot train dictionary for type id {}: "
+      "mcrouter was compiled without zstd",
+      typeId));
+#endif // FOLLY_HAVE_LIBZSTD && !defined(DISABLE_COMPRESSION)
+}
+
+CompressionDictionaryTrainer::Reservoir&
+CompressionDictionaryTrainer::getReservoir(size_t typeId) {
+  {
+    folly::SharedMutex::ReadHolder rlock(reservoirsLock_);
+    auto it = reservoirs_.find(typeId);
+    if (it != reservoirs_.end()) {
+      return *it->second;
+    }
+  }
+  folly::SharedMutex::WriteHolder wlock(reservoirsLock_);
+  auto& reservoir = reservoirs_[typeId];
+  if (!reservoir) {
+    reservoir = std::make_unique<Reservoir>(samplesPerTypeId_);
+  }
+  return *reservoir;
+}
+
+const CompressionDictionaryTrainer::Reservoir*
+CompressionDictionaryTrainer::findReservoir(size_t typeId) const {
+  folly::SharedMutex::ReadHolder rlock(reservoirsLock_);
+  auto it = reservoirs_.find(typeId);
+  return it == reservoirs_.end() ? nullptr : it->second.get();
+}
+
+} // memcache
+} // facebook
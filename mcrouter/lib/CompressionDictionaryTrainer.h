@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/SharedMutex.h>
+
+namespace folly {
+class IOBuf;
+} // folly
+
+namespace facebook {
+namespace memcache {
+
+/**
+ * Collects a uniform reservoir of value samples per type id and trains zstd
+ * dictionaries from them, so fresh dictionaries for CodecConfig can be
+ * produced from live traffic instead of offline dumps.
+ *
+ * sample() is safe to call concurrently from many threads and is designed
+ * for the reply hot path: once a reservoir is full, most calls are a single
+ * atomic increment plus a random draw, and the lock is only taken for the
+ * (increasingly rare) accepted samples.
+ *
+ * trainDictionary() is CPU-heavy (can take hundreds of ms) and must be run
+ * on a worker pool such as AuxiliaryCPUThreadPool, never on a proxy thread.
+ *
+ * Note that a trained dictionary is only usable on the wire once both peers
+ * have it: register it here under a codec id the peer also knows (normally
+ * by distributing it through the compression config) before relying on it.
+ */
+class CompressionDictionaryTrainer {
+ public:
+  /**
+   * @param samplesPerTypeId  Reservoir capacity for each type id.
+   * @param maxSampleSize     Values are truncated to this many bytes before
+   *                          being stored; bounds the memory footprint.
+   * @param dictionarySize    Upper bound of a trained dictionary, in bytes.
+   */
+  explicit CompressionDictionaryTrainer(
+      size_t samplesPerTypeId = 1000,
+      size_t maxSampleSize = 4 * 1024,
+      size_t dictionarySize = 64 * 1024);
+
+  /**
+   * Offer one value for sampling. Every value seen so far has an equal
+   * chance of being in the reservoir (approximately so under concurrency).
+   *
+   * @param typeId  Type id of the message the value belongs to.
+   * @param value   The uncompressed value; not owned, copied if accepted.
+   */
+  void sample(size_t typeId, const folly::IOBuf& value);
+
+  /**
+   * @return true if the reservoir for this type id has enough samples for
+   *         trainDictionary() to succeed.
+   */
+  bool hasEnoughSamples(size_t typeId) const;
+
+  /**
+   * Trains a dictionary from the current reservoir of the given type id.
+   * The reservoir keeps sampling while (and after) training runs.
+   *
+   * @return the serialized dictionary, suitable for CodecConfig.
+   * @throw std::runtime_error if there aren't enough samples, training
+   *        fails, or mcrouter was compiled without zstd.
+   */
+  std::string trainDictionary(size_t typeId) const;
+
+  /**
+   * Total number of values offered for this type id so far.
+   */
+  uint64_t valuesSeen(size_t typeId) const;
+
+ private:
+  struct Reservoir {
+    explicit Reservoir(size_t capacity) {
+      samples.reserve(capacity);
+    }
+
+    std::atomic<uint64_t> seen{0};
+    mutable std::mutex lock;
+    std::vector<std::string> samples;
+  };
+
+  const size_t samplesPerTypeId_;
+  const size_t maxSampleSize_;
+  const size_t dictionarySize_;
+
+  mutable folly::SharedMutex reservoirsLock_;
+  std::unordered_map<size_t, std::unique_ptr<Reservoir>> reservoirs_;
+
+  Reservoir& getReservoir(size_t typeId);
+  const Reservoir* findReservoir(size_t typeId) const;
+};
+
+} // memcache
+} // facebook
@@ -68,6 +68,25 @@ class IovecCursor {
    */
   void readInto(uint8_t* dest, size_t size);
 
+  /**
+   * Number of bytes that can be read from the current position without
+   * crossing into the next iovec. Useful for fast paths that want to
+   * operate on raw contiguous memory.
+   */
+  inline size_t peekableLength() const {
+    return curBufLen_;
+  }
+
+  /**
+   * Pointer to the current position inside the current iovec.
+   * Only valid while peekableLength() > 0.
+   */
+  inline const uint8_t* peekableData() const {
+    assert(curBufLen_ > 0);
+    return reinterpret_cast<const uint8_t*>(iov_[iovIndex_].iov_base) +
+        curBufPos_;
+  }
+
   /**
    * Get the total length of this cursor (i.e. the sum of the length of
    * all iovecs).
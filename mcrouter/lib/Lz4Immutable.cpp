@@ -114,6 +114,14 @@ Lz4ImmutableState loadDictionary(std::unique_ptr<folly::IOBuf> dictionary) {
  * Note: cursor will point just past its current position + "count"
  */
 void safeCopy(uint8_t* dest, IovecCursor& source, size_t count) {
+  // Fast path: the entire copy fits in the current iovec, so one plain
+  // memcpy (which the compiler is free to vectorize) does the job.
+  if (count != 0 && LIKELY(count <= source.peekableLength())) {
+    std::memcpy(dest, source.peekableData(), count);
+    source.advance(count);
+    return;
+  }
+
   int64_t left = count;
   uint64_t src;
   do {
@@ -138,6 +146,15 @@ void safeCopy(uint8_t* dest, IovecCursor& source, size_t count) {
  * 7 bytes.
  */
 void wildCopy(uint8_t* dest, IovecCursor& cursor, size_t count) {
+  // Fast path: if the current iovec covers the copy plus the potential
+  // 7-byte overread, copy in one go straight from the buffer.
+  const size_t wildCount = (count + 7) & ~size_t(7);
+  if (LIKELY(wildCount != 0 && wildCount <= cursor.peekableLength())) {
+    std::memcpy(dest, cursor.peekableData(), wildCount);
+    cursor.advance(count);
+    return;
+  }
+
   const uint8_t* destEnd = dest + count;
   do {
     uint64_t src = cursor.read<uint64_t>();
@@ -192,6 +209,41 @@ size_t
 calculateMatchLength(IovecCursor& source, IovecCursor& match, size_t limit) {
   const size_t start = source.tell();
 
+  // Fast path: compare straight from the underlying buffers while both
+  // cursors have contiguous data. The dictionary is always a single
+  // buffer and values usually are too, so this typically runs the whole
+  // match without touching cursor bookkeeping; the 8-byte-at-a-time
+  // XOR/ctz loop over raw pointers is also what the compiler can widen.
+  while (LIKELY(source.tell() < limit - kStepSize - 1)) {
+    const size_t contiguous =
+        std::min(source.peekableLength(), match.peekableLength());
+    size_t wanted = limit - kStepSize - 1 - source.tell();
+    size_t n = std::min(contiguous, wanted);
+    if (n < kStepSize) {
+      break;
+    }
+    const uint8_t* sourceData = source.peekableData();
+    const uint8_t* matchData = match.peekableData();
+    size_t advanced = 0;
+    while (n >= kStepSize) {
+      uint64_t sourceWord;
+      uint64_t matchWord;
+      std::memcpy(&sourceWord, sourceData + advanced, sizeof(uint64_t));
+      std::memcpy(&matchWord, matchData + advanced, sizeof(uint64_t));
+      const uint64_t diff = sourceWord ^ matchWord;
+      if (diff) {
+        advanced += numCommonBytes(diff);
+        source.advance(advanced);
+        match.advance(advanced);
+        return source.tell() - start;
+      }
+      advanced += kStepSize;
+      n -= kStepSize;
+    }
+    source.advance(advanced);
+    match.advance(advanced);
+  }
+
   while (LIKELY(source.tell() < limit - kStepSize - 1)) {
     uint64_t diff = match.peek<uint64_t>() ^ source.peek<uint64_t>();
     if (!diff) {
@@ -7,11 +7,39 @@
  */
 #pragma once
 
+#include <cstdint>
+
 #include "mcrouter/lib/mc/msg.h"
 
 namespace facebook {
 namespace memcache {
 
+namespace detail {
+
+/**
+ * Builds a bitmask with one bit set per listed result, so that
+ * multi-valued result classifiers below compile to a single load+test
+ * instead of a switch. These run several times per reply (failover,
+ * stats, logging), so the constant-time form is worth it.
+ */
+constexpr uint64_t resultMask() {
+  return 0;
+}
+template <class... Rest>
+constexpr uint64_t resultMask(mc_res_t first, Rest... rest) {
+  return (uint64_t(1) << static_cast<unsigned>(first)) | resultMask(rest...);
+}
+
+static_assert(
+    mc_nres <= 64,
+    "mc_res_t no longer fits in a 64-bit classification mask");
+
+inline bool resultInMask(mc_res_t result, uint64_t mask) {
+  return (mask >> static_cast<unsigned>(result)) & 1;
+}
+
+} // namespace detail
+
 inline int resultSeverity(mc_res_t result) {
   switch (result) {
     case mc_res_ok:
@@ -73,20 +101,17 @@ inline bool isErrorResult(const mc_res_t result) {
  * Is this reply an error as far as failover logic is concerned?
  */
 inline bool isFailoverErrorResult(const mc_res_t result) {
-  switch (result) {
-    case mc_res_busy:
-    case mc_res_shutdown:
-    case mc_res_tko:
-    case mc_res_try_again:
-    case mc_res_local_error:
-    case mc_res_connect_error:
-    case mc_res_connect_timeout:
-    case mc_res_timeout:
-    case mc_res_remote_error:
-      return true;
-    default:
-      return false;
-  }
+  constexpr uint64_t kMask = detail::resultMask(
+      mc_res_busy,
+      mc_res_shutdown,
+      mc_res_tko,
+      mc_res_try_again,
+      mc_res_local_error,
+      mc_res_connect_error,
+      mc_res_connect_timeout,
+      mc_res_timeout,
+      mc_res_remote_error);
+  return detail::resultInMask(result, kMask);
 }
 
 /**
@@ -105,14 +130,9 @@ inline bool isSoftTkoErrorResult(const mc_res_t result) {
  * Is this reply a hard TKO error?
  */
 inline bool isHardTkoErrorResult(const mc_res_t result) {
-  switch (result) {
-    case mc_res_connect_error:
-    case mc_res_connect_timeout:
-    case mc_res_shutdown:
-      return true;
-    default:
-      return false;
-  }
+  constexpr uint64_t kMask = detail::resultMask(
+      mc_res_connect_error, mc_res_connect_timeout, mc_res_shutdown);
+  return detail::resultInMask(result, kMask);
 }
 
 /**
@@ -177,15 +197,17 @@ inline bool isDataTimeoutResult(const mc_res_t result) {
  * to reply now.
  */
 inline bool isRedirectResult(const mc_res_t result) {
-  return result == mc_res_busy || result == mc_res_try_again;
+  constexpr uint64_t kMask = detail::resultMask(mc_res_busy, mc_res_try_again);
+  return detail::resultInMask(result, kMask);
 }
 
 /**
  * Was the data found?
  */
 inline bool isHitResult(const mc_res_t result) {
-  return result == mc_res_deleted || result == mc_res_found ||
-      result == mc_res_touched;
+  constexpr uint64_t kMask =
+      detail::resultMask(mc_res_deleted, mc_res_found, mc_res_touched);
+  return detail::resultInMask(result, kMask);
 }
 
 /**
@@ -199,14 +221,18 @@ inline bool isMissResult(const mc_res_t result) {
  * Lease hot miss?
  */
 inline bool isHotMissResult(const mc_res_t result) {
-  return result == mc_res_foundstale || result == mc_res_notfoundhot;
+  constexpr uint64_t kMask =
+      detail::resultMask(mc_res_foundstale, mc_res_notfoundhot);
+  return detail::resultInMask(result, kMask);
 }
 
 /**
  * Was the data stored?
  */
 inline bool isStoredResult(const mc_res_t result) {
-  return result == mc_res_stored || result == mc_res_stalestored;
+  constexpr uint64_t kMask =
+      detail::resultMask(mc_res_stored, mc_res_stalestored);
+  return detail::resultInMask(result, kMask);
 }
 
 inline bool worseThan(mc_res_t first, mc_res_t second) {
@@ -7,6 +7,8 @@
  */
 #include "MessageQueue.h"
 
+#include <algorithm>
+
 namespace facebook {
 namespace memcache {
 
@@ -35,13 +37,33 @@ bool Notifier::shouldNotifyRelaxed() noexcept {
   return false;
 }
 
+bool Notifier::shouldNotifyRelaxed(size_t nMessages) noexcept {
+  if (waitThreshold_ && nowFunc_() - waitStart_ > waitThreshold_) {
+    return shouldNotify();
+  }
+
+  auto period = period_.load();
+  if (!period) {
+    return shouldNotify();
+  }
+  /* Advance the counter once for the whole batch and notify iff the
+     batch crossed a period boundary. */
+  auto counter = counter_.fetch_add(nMessages, std::memory_order_relaxed) +
+      nMessages;
+  if (counter / period != (counter - nMessages) / period) {
+    return shouldNotify();
+  }
+
+  return false;
+}
+
 void Notifier::maybeUpdatePeriod() noexcept {
   if (noNotifyRate_ == 0) {
     return;
   }
 
   auto now = nowFunc_();
-  if (now - lastTimeUsec_ > kUpdatePeriodUsec) {
+  if (now - lastTimeUsec_ > updateWindowUsec_) {
     auto secElapsed = (double)(now - lastTimeUsec_) / 1000000.0;
     size_t notifyEvery = 1000000;
     double msgPerSec = (double)curMessages_ / secElapsed;
@@ -54,6 +76,15 @@ void Notifier::maybeUpdatePeriod() noexcept {
     if (notifyEvery == 1) {
       notifyEvery = 0;
     }
+    auto oldPeriod = period_.load();
+    if (oldPeriod != notifyEvery &&
+        (oldPeriod == 0 || notifyEvery == 0 || oldPeriod > 2 * notifyEvery ||
+         notifyEvery > 2 * oldPeriod)) {
+      /* The rate is shifting; re-evaluate sooner. */
+      updateWindowUsec_ = kMinUpdateWindowUsec;
+    } else {
+      updateWindowUsec_ = std::min(updateWindowUsec_ * 2, kMaxUpdateWindowUsec);
+    }
     period_ = notifyEvery;
     lastTimeUsec_ = now;
     curMessages_ = 0;
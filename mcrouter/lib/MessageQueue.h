@@ -6,9 +6,12 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 
+#include <folly/small_vector.h>
+
 #include <folly/FileUtil.h>
 #include <folly/MPMCQueue.h>
 #include <folly/Random.h>
@@ -16,6 +19,8 @@
 #include <folly/io/async/EventHandler.h>
 #include <folly/io/async/VirtualEventBase.h>
 
+#include "mcrouter/lib/MpscQueue.h"
+
 namespace facebook {
 namespace memcache {
 
@@ -52,8 +57,8 @@ class Notifier {
       NowUsecFunc nowFunc,
       std::function<bool(bool)> postDrainCallback = nullptr) noexcept;
 
-  void bumpMessages() noexcept {
-    ++curMessages_;
+  void bumpMessages(size_t n = 1) noexcept {
+    curMessages_ += n;
   }
 
   size_t currentNotifyPeriod() const noexcept {
@@ -67,6 +72,14 @@ class Notifier {
 
   bool shouldNotifyRelaxed() noexcept;
 
+  /**
+   * Batch version of shouldNotifyRelaxed(): advances the relaxed
+   * notification counter by nMessages at once and returns true iff the
+   * batch crossed a notification period boundary, so an entire batch
+   * costs at most one cross-thread wakeup.
+   */
+  bool shouldNotifyRelaxed(size_t nMessages) noexcept;
+
   // In contrast to shouldNotify()/shouldNotifyRelaxed(), it is only safe to
   // call drainWhileNonEmpty() from a single thread.
   template <class F>
@@ -108,7 +121,12 @@ class Notifier {
   int64_t lastTimeUsec_;
   size_t curMessages_{0};
 
-  static constexpr int64_t kUpdatePeriodUsec = 1000000;
+  /* Adaptive coalescing window: re-evaluate the notification period
+     sooner while the message rate is shifting, back off to the maximum
+     window once it's stable. */
+  static constexpr int64_t kMinUpdateWindowUsec = 125000;
+  static constexpr int64_t kMaxUpdateWindowUsec = 1000000;
+  int64_t updateWindowUsec_{kMaxUpdateWindowUsec};
 
   alignas(folly::hardware_destructive_interference_size)
       std::atomic<size_t> period_{0};
@@ -135,6 +153,8 @@ class MessageQueue {
    *
    * @param capactiy  All queue storage is allocated upfront.
    *   If queue is full, further writes will block.
+   *   If 0, the queue is unbounded: writes go through a lock-free MPSC
+   *   linked queue with per-producer slab allocation and never block.
    * @param onMessage Called on every message from the event base thread.
    * @param noNotifyRate  Request rate at which we stop all per-request
    *   notifications.  At any rate from 0 to noNotifyRate, we linearly
@@ -149,6 +169,19 @@ class MessageQueue {
    *   event is posted.
    * @param postDrainCallback  Callback that will be called during the queue
    *   drain phase. See Notifier for more details.
+   * @param spinPollUs  If non-zero, busy-poll the event loop: after each
+   *   drained message keep the loop non-blocking for this many us, so new
+   *   messages are picked up straight from the queue instead of paying an
+   *   epoll_wait wakeup. Once idle past the budget the loop blocks as
+   *   usual. Only worthwhile when the consumer thread owns a core.
+   * @param drainSortKey  If set, drain() dispatches messages in chunks of
+   *   up to kDispatchSortChunk, stable-sorted by this key, so messages
+   *   with the same key (e.g. the same request operation) run
+   *   back-to-back and share instruction cache footprint. Messages with
+   *   equal keys keep their arrival order; across keys, dispatch order
+   *   within a chunk no longer matches arrival order, including for
+   *   high-priority messages. Only enable when the callback treats
+   *   messages as independent.
    */
   MessageQueue(
       size_t capacity,
@@ -157,14 +190,22 @@ class MessageQueue {
       int64_t waitThreshold,
       Notifier::NowUsecFunc nowFunc,
       std::function<void()> notifyCallback,
-      std::function<bool(bool)> postDrainCallback = nullptr)
-      : queue_(capacity),
+      std::function<bool(bool)> postDrainCallback = nullptr,
+      int64_t spinPollUs = 0,
+      std::function<uint64_t(const T&)> drainSortKey = nullptr)
+      : queue_(capacity > 0 ? capacity : 1),
+        highPriorityQueue_(capacity > 0 ? capacity : 1),
+        mpscQueue_(capacity == 0 ? std::make_unique<MpscQueue<T>>() : nullptr),
+        mpscHighPriorityQueue_(
+            capacity == 0 ? std::make_unique<MpscQueue<T>>() : nullptr),
         onMessage_(std::move(onMessage)),
         notifier_(
             noNotifyRate,
             waitThreshold,
             nowFunc,
             std::move(postDrainCallback)),
+        spinPollInterval_(spinPollUs),
+        drainSortKey_(std::move(drainSortKey)),
         handler_(*this),
         notifyCallback_(std::move(notifyCallback)) {
     efd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE);
@@ -191,6 +232,12 @@ class MessageQueue {
           });
     }
 
+    if (spinPollInterval_.count() > 0) {
+      spinTimeout_ =
+          folly::AsyncTimeout::make(evb.getEventBase(), []() noexcept {});
+      spinDeadline_ = std::chrono::steady_clock::now() + spinPollInterval_;
+    }
+
     class MessageQueueDrainCallback : public folly::EventBase::LoopCallback {
      public:
       MessageQueueDrainCallback(folly::EventBase& evb__, MessageQueue& queue)
@@ -200,6 +247,7 @@ class MessageQueue {
 
       void runLoopCallback() noexcept override {
         queue_.drain();
+        queue_.maybeSpinPoll();
         evb_.runBeforeLoop(this);
       }
 
@@ -229,6 +277,27 @@ class MessageQueue {
     notifier_.drainWhileNonEmpty([this]() { drainImpl(); });
   }
 
+  /**
+   * Must be called from the event base thread. Implements the busy-poll
+   * window: while messages keep arriving, a zero timeout is kept scheduled
+   * so the event loop polls instead of blocking; once the queue has been
+   * idle for the spin budget the timeout is left unscheduled and the loop
+   * goes back to sleeping in epoll_wait.
+   */
+  void maybeSpinPoll() {
+    if (!spinTimeout_) {
+      return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (drainedMessages_ != spinLastDrained_) {
+      spinLastDrained_ = drainedMessages_;
+      spinDeadline_ = now + spinPollInterval_;
+    }
+    if (now <= spinDeadline_) {
+      spinTimeout_->scheduleTimeout(std::chrono::milliseconds(0));
+    }
+  }
+
   ~MessageQueue() {
     if (queueDrainCallback_) {
       queueDrainCallback_->cancelLoopCallback();
@@ -248,7 +317,7 @@ class MessageQueue {
    */
   template <class... Args>
   void blockingWrite(Args&&... args) noexcept {
-    queue_.blockingWrite(std::forward<Args>(args)...);
+    writeImpl(false /* highPriority */, std::forward<Args>(args)...);
     if (notifier_.shouldNotify()) {
       doNotify();
     }
@@ -256,15 +325,64 @@ class MessageQueue {
 
   template <class... Args>
   void blockingWriteRelaxed(Args&&... args) noexcept {
-    queue_.blockingWrite(std::forward<Args>(args)...);
+    writeImpl(false /* highPriority */, std::forward<Args>(args)...);
     if (notifier_.shouldNotifyRelaxed()) {
       doNotify();
     }
   }
 
+  /**
+   * Same as blockingWriteRelaxed(), except the message goes into the
+   * high-priority lane: drain() hands it to the callback ahead of any
+   * queued normal-priority messages (subject to the starvation bound,
+   * see drainImpl()). Ordering is FIFO within each lane only.
+   */
+  template <class... Args>
+  void blockingWriteRelaxedHighPriority(Args&&... args) noexcept {
+    writeImpl(true /* highPriority */, std::forward<Args>(args)...);
+    if (notifier_.shouldNotifyRelaxed()) {
+      doNotify();
+    }
+  }
+
+  /**
+   * Put a batch of elements into the queue with at most one notification
+   * for the whole batch. Can be called from any thread.
+   * Will block if the queue is full until the reader catches up.
+   *
+   * Equivalent to calling blockingWriteRelaxed() on every element of
+   * [begin, end), except that the relaxed notification counter is
+   * advanced once for the entire batch, so a batch costs at most one
+   * eventfd write no matter how many messages it carries.
+   */
+  template <class InputIt>
+  void blockingWriteBatchRelaxed(
+      InputIt begin,
+      InputIt end,
+      bool highPriority = false) noexcept {
+    size_t n = 0;
+    for (auto it = begin; it != end; ++it, ++n) {
+      writeImpl(highPriority, std::move(*it));
+    }
+    if (n != 0 && notifier_.shouldNotifyRelaxed(n)) {
+      doNotify();
+    }
+  }
+
  private:
   static constexpr int64_t kWakeupEveryMs = 2;
+  /* A drain lets at most this many consecutive high-priority messages
+     through before it checks the normal lane, bounding starvation when
+     producers keep the high-priority lane non-empty. */
+  static constexpr size_t kHighPriorityBurst = 64;
+  /* Sorted dispatch (see drainSortKey) groups at most this many messages
+     per sorting pass. */
+  static constexpr size_t kDispatchSortChunk = 128;
   folly::MPMCQueue<T> queue_;
+  folly::MPMCQueue<T> highPriorityQueue_;
+  /* Non-null iff constructed with capacity 0 (unbounded MPSC mode). */
+  std::unique_ptr<MpscQueue<T>> mpscQueue_;
+  std::unique_ptr<MpscQueue<T>> mpscHighPriorityQueue_;
   std::function<void(T&&)> onMessage_;
   Notifier notifier_;
 
@@ -279,6 +397,13 @@ class MessageQueue {
     MessageQueue& parent_;
   };
 
+  const std::chrono::microseconds spinPollInterval_;
+  const std::function<uint64_t(const T&)> drainSortKey_;
+  size_t drainedMessages_{0};
+  size_t spinLastDrained_{0};
+  std::chrono::steady_clock::time_point spinDeadline_;
+  std::unique_ptr<folly::AsyncTimeout> spinTimeout_;
+
   EventHandler handler_;
   std::unique_ptr<folly::AsyncTimeout> waitTimeout_;
   std::function<void()> notifyCallback_;
@@ -302,20 +427,92 @@ class MessageQueue {
     }
   }
 
+  template <class... Args>
+  void writeImpl(bool highPriority, Args&&... args) noexcept {
+    if (mpscQueue_) {
+      (highPriority ? *mpscHighPriorityQueue_ : *mpscQueue_)
+          .push(std::forward<Args>(args)...);
+    } else {
+      (highPriority ? highPriorityQueue_ : queue_)
+          .blockingWrite(std::forward<Args>(args)...);
+    }
+  }
+
+  bool readImpl(bool highPriority, T& message) {
+    if (mpscQueue_) {
+      return (highPriority ? *mpscHighPriorityQueue_ : *mpscQueue_)
+          .tryPop(message);
+    }
+    return (highPriority ? highPriorityQueue_ : queue_).read(message);
+  }
+
+  bool readNext(T& message, size_t& highStreak) {
+    // High-priority lane first; after kHighPriorityBurst consecutive
+    // high-priority messages let one normal message through so the
+    // normal lane can't starve.
+    if (highStreak < kHighPriorityBurst &&
+        readImpl(true /* highPriority */, message)) {
+      ++highStreak;
+      return true;
+    }
+    if (readImpl(false /* highPriority */, message)) {
+      highStreak = 0;
+      return true;
+    }
+    if (readImpl(true /* highPriority */, message)) {
+      // Normal lane is empty, so the streak cap is moot.
+      highStreak = 0;
+      return true;
+    }
+    return false;
+  }
+
+  void dispatch(T&& message) {
+    onMessage_(std::move(message));
+    notifier_.bumpMessages();
+    ++drainedMessages_;
+  }
+
   void drainImpl() {
     T message;
-    while (queue_.read(message)) {
-      onMessage_(std::move(message));
-      notifier_.bumpMessages();
+    size_t highStreak = 0;
+    if (!drainSortKey_) {
+      while (readNext(message, highStreak)) {
+        dispatch(std::move(message));
+      }
+      return;
+    }
+    // Sorted dispatch: gather a chunk, group it by key, dispatch, repeat.
+    // The chunk bounds both the latency added before the first message of
+    // a pass runs and how far dispatch order can drift from arrival order.
+    folly::small_vector<T, 16> chunk;
+    bool more = true;
+    while (more) {
+      chunk.clear();
+      while (chunk.size() < kDispatchSortChunk &&
+             (more = readNext(message, highStreak))) {
+        chunk.push_back(std::move(message));
+      }
+      std::stable_sort(
+          chunk.begin(), chunk.end(), [this](const T& a, const T& b) {
+            return drainSortKey_(a) < drainSortKey_(b);
+          });
+      for (auto& m : chunk) {
+        dispatch(std::move(m));
+      }
     }
   }
 
   std::shared_ptr<folly::EventBase::LoopCallback> queueDrainCallback_;
 };
 
-// Static member definition
+// Static member definitions
 template <class T>
 constexpr int64_t MessageQueue<T>::kWakeupEveryMs;
+template <class T>
+constexpr size_t MessageQueue<T>::kHighPriorityBurst;
+template <class T>
+constexpr size_t MessageQueue<T>::kDispatchSortChunk;
 
 } // memcache
 } // facebook
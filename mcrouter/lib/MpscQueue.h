@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <utility>
+
+#include <folly/concurrency/CacheLocality.h>
+
+namespace facebook {
+namespace memcache {
+
+/**
+ * Unbounded lock-free multi-producer single-consumer queue.
+ *
+ * Producers enqueue with a single atomic pointer exchange (no CAS loop,
+ * so producers never contend on retries); the consumer pops in FIFO order
+ * and must always be the same single thread.
+ *
+ * Nodes are carved out of per-producer thread-local slabs, so the enqueue
+ * hot path does not hit malloc.  A slab is freed once the consumer has
+ * released every node carved from it, so slabs may outlive the producer
+ * thread that created them.
+ */
+template <class T>
+class MpscQueue {
+ public:
+  MpscQueue() {
+    auto stub = new Node();
+    head_.store(stub, std::memory_order_relaxed);
+    tail_ = stub;
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  ~MpscQueue() {
+    T value;
+    while (tryPop(value)) {
+    }
+    releaseNode(tail_);
+  }
+
+  /**
+   * Enqueue a new element. Can be called from any thread; never blocks.
+   */
+  template <class... Args>
+  void push(Args&&... args) {
+    auto node = allocNode();
+    new (&node->storage) T(std::forward<Args>(args)...);
+    node->next.store(nullptr, std::memory_order_relaxed);
+    auto prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  /**
+   * Dequeue an element in FIFO order. May only be called from the single
+   * consumer thread.
+   *
+   * @return true iff an element was dequeued into value.
+   */
+  bool tryPop(T& value) {
+    auto next = tail_->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return false;
+    }
+    value = std::move(*next->get());
+    next->get()->~T();
+    releaseNode(tail_);
+    tail_ = next;
+    return true;
+  }
+
+ private:
+  struct Slab;
+
+  struct Node {
+    std::atomic<Node*> next{nullptr};
+    Slab* slab{nullptr};
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+    T* get() {
+      return reinterpret_cast<T*>(&storage);
+    }
+  };
+
+  static constexpr size_t kSlabSize = 64;
+
+  struct Slab {
+    /* Nodes still to be released by the consumer (plus the ones not yet
+       carved out by the owning producer). */
+    std::atomic<size_t> live{kSlabSize};
+    Node nodes[kSlabSize];
+  };
+
+  struct ProducerState {
+    Slab* slab{nullptr};
+    size_t nextNode{kSlabSize};
+
+    ~ProducerState() {
+      /* A fully carved slab is owned by the consumer; only return the
+         uncarved nodes of a partial slab so the consumer can free it. */
+      if (slab != nullptr && nextNode < kSlabSize) {
+        auto unused = kSlabSize - nextNode;
+        if (slab->live.fetch_sub(unused, std::memory_order_acq_rel) ==
+            unused) {
+          delete slab;
+        }
+      }
+    }
+  };
+
+  Node* allocNode() {
+    thread_local ProducerState state;
+    if (state.nextNode == kSlabSize) {
+      state.slab = new Slab();
+      state.nextNode = 0;
+    }
+    auto node = &state.slab->nodes[state.nextNode++];
+    node->slab = state.slab;
+    return node;
+  }
+
+  static void releaseNode(Node* node) {
+    if (node->slab == nullptr) {
+      /* The initial stub node is allocated standalone. */
+      delete node;
+      return;
+    }
+    auto slab = node->slab;
+    if (slab->live.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete slab;
+    }
+  }
+
+  alignas(folly::hardware_destructive_interference_size)
+      std::atomic<Node*> head_;
+  alignas(folly::hardware_destructive_interference_size) Node* tail_;
+};
+
+} // memcache
+} // facebook
@@ -9,6 +9,8 @@
 
 #include <folly/Range.h>
 
+#include "mcrouter/lib/RendezvousHashHelper.h"
+
 namespace facebook {
 namespace memcache {
 
@@ -21,6 +23,8 @@ namespace memcache {
  */
 class RendezvousHashFunc {
  public:
+  using Iterator = RendezvousIterator<uint64_t>;
+
   /**
    * @param endpoints  A list of backend servers
    */
@@ -28,6 +32,17 @@ class RendezvousHashFunc {
 
   size_t operator()(folly::StringPiece key) const;
 
+  /**
+   * Iterates over all pool indices in descending score order for the
+   * given key. The first element equals operator()(key); subsequent
+   * elements are the failover choices, produced without rescoring.
+   */
+  Iterator begin(folly::StringPiece key) const;
+
+  Iterator end() const {
+    return Iterator();
+  }
+
   static const char* type() {
     return "Rendezvous";
   }
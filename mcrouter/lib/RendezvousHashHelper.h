@@ -9,6 +9,11 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
 namespace facebook {
 namespace memcache {
 
@@ -40,5 +45,64 @@ inline double convertInt64ToDouble01(const uint64_t value) {
   return (value & fiftyThreeOnes) / fiftyThreeZeros;
 }
 
+/**
+ * Yields pool indices in descending rendezvous score order.
+ *
+ * Scores are computed once by the owning hash function when the iterator
+ * is created; each increment pops the next-best choice off a heap in
+ * O(log n) instead of rescoring the whole pool, which makes walking
+ * failover choices cheap.
+ *
+ * Comparison is only meaningful between iterators over the same key
+ * (in particular, against the past-the-end iterator).
+ */
+template <class Score>
+class RendezvousIterator {
+ public:
+  using ScoreAndIndex = std::pair<Score, size_t>;
+
+  /**
+   * Past-the-end iterator.
+   */
+  RendezvousIterator() = default;
+
+  explicit RendezvousIterator(std::vector<ScoreAndIndex> scores)
+      : heap_(std::move(scores)) {
+    std::make_heap(heap_.begin(), heap_.end(), Compare());
+  }
+
+  size_t operator*() const {
+    assert(!heap_.empty());
+    return heap_.front().second;
+  }
+
+  RendezvousIterator& operator++() {
+    assert(!heap_.empty());
+    std::pop_heap(heap_.begin(), heap_.end(), Compare());
+    heap_.pop_back();
+    return *this;
+  }
+
+  bool operator==(const RendezvousIterator& other) const {
+    return heap_.size() == other.heap_.size();
+  }
+
+  bool operator!=(const RendezvousIterator& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  struct Compare {
+    bool operator()(const ScoreAndIndex& a, const ScoreAndIndex& b) const {
+      /* Max-heap by score; prefer the lower index on equal scores so
+         the first choice matches operator() of the hash function. */
+      return a.first < b.first ||
+          (a.first == b.first && a.second > b.second);
+    }
+  };
+
+  std::vector<ScoreAndIndex> heap_;
+};
+
 } // namespace memcache
 } // namespace facebook
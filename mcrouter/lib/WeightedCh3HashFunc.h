@@ -6,7 +6,10 @@
  */
 #pragma once
 
+#include <folly/Likely.h>
+
 #include "mcrouter/lib/WeightedChHashFuncBase.h"
+#include "mcrouter/lib/fbi/hash.h"
 
 namespace facebook {
 namespace memcache {
@@ -71,7 +74,12 @@ class WeightedCh3HashFunc : public WeightedChHashFuncBase {
       : WeightedChHashFuncBase(json, n) {}
 
   size_t operator()(folly::StringPiece key) const {
-    return hash(key, weights_);
+    if (LIKELY(allWeightsOne_)) {
+      /* All weights at 1.0 degenerate to plain CH3 (see note above),
+         so skip the rejection loop and its extra hash per request. */
+      return furc_hash(key.data(), key.size(), weights_->size());
+    }
+    return hash(key, *weights_);
   }
 
   static const char* type() {
@@ -65,7 +65,7 @@ class WeightedCh4HashFunc : public WeightedChHashFuncBase {
       : WeightedChHashFuncBase(json, n) {}
 
   size_t operator()(folly::StringPiece key) const {
-    return hash(key, weights_);
+    return hash(key, *weights_);
   }
 
   static const char* type() {
@@ -6,6 +6,8 @@
  */
 #include "mcrouter/lib/WeightedChHashFuncBase.h"
 
+#include <mutex>
+
 #include <folly/dynamic.h>
 #include "mcrouter/lib/fbi/cpp/util.h"
 
@@ -39,5 +41,43 @@ std::vector<double> WeightedChHashFuncBase::parseWeights(
   return weights;
 }
 
+std::shared_ptr<const std::vector<double>> WeightedChHashFuncBase::internWeights(
+    std::vector<double> weights) {
+  // Entries are held by weak_ptr, so a weight vector lives exactly as
+  // long as some hash function references it; expired entries are swept
+  // on the next miss.
+  static std::mutex cacheMutex;
+  static std::unordered_map<std::string, std::weak_ptr<const std::vector<double>>>
+      cache;
+
+  std::string key(
+      reinterpret_cast<const char*>(weights.data()),
+      weights.size() * sizeof(double));
+
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  auto it = cache.find(key);
+  if (it != cache.end()) {
+    if (auto shared = it->second.lock()) {
+      return shared;
+    }
+  }
+  for (auto sweepIt = cache.begin(); sweepIt != cache.end();) {
+    sweepIt =
+        sweepIt->second.expired() ? cache.erase(sweepIt) : std::next(sweepIt);
+  }
+  auto shared = std::make_shared<const std::vector<double>>(std::move(weights));
+  cache[std::move(key)] = shared;
+  return shared;
+}
+
+bool WeightedChHashFuncBase::allWeightsOne(const std::vector<double>& weights) {
+  for (const auto weight : weights) {
+    if (weight != 1.0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 } // namespace memcache
 } // namespace facebook
@@ -6,6 +6,7 @@
  */
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 
 #include <folly/Range.h>
@@ -24,7 +25,8 @@ class WeightedChHashFuncBase {
    *                 Pool size is taken to be weights.size()
    */
   explicit WeightedChHashFuncBase(std::vector<double> weights)
-      : weights_(std::move(weights)) {}
+      : weights_(internWeights(std::move(weights))),
+        allWeightsOne_(allWeightsOne(*weights_)) {}
 
   /**
    * @param json  Json object of the following format:
@@ -34,13 +36,14 @@ class WeightedChHashFuncBase {
    * @param n     Number of servers in the config.
    */
   WeightedChHashFuncBase(const folly::dynamic& json, size_t n)
-      : weights_(parseWeights(json, n)) {}
+      : weights_(internWeights(parseWeights(json, n))),
+        allWeightsOne_(allWeightsOne(*weights_)) {}
 
   /**
    * @return Saved weights.
    */
   const std::vector<double>& weights() const {
-    return weights_;
+    return *weights_;
   }
 
   static std::vector<double> parseWeights(const folly::dynamic& json, size_t n);
@@ -48,7 +51,23 @@ class WeightedChHashFuncBase {
  protected:
   static constexpr size_t kNumTries = 32;
 
-  const std::vector<double> weights_;
+  static bool allWeightsOne(const std::vector<double>& weights);
+
+  /**
+   * Returns a shared copy of the given weight vector, deduplicated
+   * process-wide by content. Every proxy thread builds an identical
+   * hash function from the same pool json on every reconfigure;
+   * interning keeps one read-only copy per distinct pool instead of
+   * one per thread, so threads share cache lines on the request path.
+   */
+  static std::shared_ptr<const std::vector<double>> internWeights(
+      std::vector<double> weights);
+
+  const std::shared_ptr<const std::vector<double>> weights_;
+  // Precomputed at config time: with every weight at 1.0 the rejection
+  // loop always accepts the first candidate, so derived hash functions
+  // can skip it (and the extra per-request hash it costs) entirely.
+  const bool allWeightsOne_;
 };
 
 } // namespace memcache
@@ -68,5 +68,21 @@ size_t WeightedRendezvousHashFunc::operator()(folly::StringPiece key) const {
 
   return maxScorePos;
 }
+
+WeightedRendezvousHashFunc::Iterator WeightedRendezvousHashFunc::begin(
+    folly::StringPiece key) const {
+  const uint64_t keyHash =
+      murmur_hash_64A(key.data(), key.size(), kRendezvousExtraHashSeed);
+
+  std::vector<Iterator::ScoreAndIndex> scores;
+  scores.reserve(endpointHashes_.size());
+  for (size_t pos = 0; pos < endpointHashes_.size(); ++pos) {
+    const uint64_t scoreInt = hash128to64(endpointHashes_[pos], keyHash);
+    const double score = endpointWeights_[pos] *
+        (1.0 / (-std::log(convertInt64ToDouble01(scoreInt))));
+    scores.emplace_back(score, pos);
+  }
+  return Iterator(std::move(scores));
+}
 } // namespace memcache
 } // namespace facebook
@@ -10,6 +10,8 @@
 #include <folly/Range.h>
 #include <folly/dynamic.h>
 
+#include "mcrouter/lib/RendezvousHashHelper.h"
+
 namespace facebook {
 namespace memcache {
 
@@ -35,8 +37,22 @@ class WeightedRendezvousHashFunc {
       const std::vector<folly::StringPiece>& endpoints,
       const folly::dynamic& json);
 
+  using Iterator = RendezvousIterator<double>;
+
   size_t operator()(folly::StringPiece key) const;
 
+  /**
+   * Iterates over all pool indices in descending weighted score order
+   * for the given key. The first element equals operator()(key);
+   * subsequent elements are the failover choices, produced without
+   * rescoring.
+   */
+  Iterator begin(folly::StringPiece key) const;
+
+  Iterator end() const {
+    return Iterator();
+  }
+
   static const char* type() {
     return "WeightedRendezvous";
   }
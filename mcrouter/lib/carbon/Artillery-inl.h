@@ -9,7 +9,11 @@
 
 #include "mcrouter/lib/carbon/RequestReplyUtil.h"
 
-#ifndef LIBMC_FBTRACE_DISABLE
+#ifdef LIBMC_FBTRACE_DISABLE
+#include <cstdlib>
+
+#include <folly/Format.h>
+#else
 #include "mcrouter/lib/carbon/facebook/ArtilleryUtil.h"
 #endif
 
@@ -18,14 +22,36 @@ namespace tracing {
 
 #ifdef LIBMC_FBTRACE_DISABLE
 
+// Without the fbtrace libraries a trace context is simply
+// "<traceId>:<nodeId>" in hex, matching the two Caret header fields the
+// ids travel in. This is enough to stitch spans across hops.
+
 inline std::pair<uint64_t, uint64_t> serializeTraceContext(
     const std::string& traceContext) {
-  return {0, 0};
+  const auto pos = traceContext.find(':');
+  if (pos == std::string::npos) {
+    return {0, 0};
+  }
+  char* end = nullptr;
+  const uint64_t traceId = std::strtoull(traceContext.c_str(), &end, 16);
+  if (end != traceContext.c_str() + pos) {
+    return {0, 0};
+  }
+  const uint64_t nodeId =
+      std::strtoull(traceContext.c_str() + pos + 1, &end, 16);
+  if (*end != '\0') {
+    return {0, 0};
+  }
+  return {traceId, nodeId};
 }
 
 inline std::string deserializeTraceContext(
     std::pair<uint64_t, uint64_t> serializedTraceId) {
-  return "";
+  if (serializedTraceId.first == 0 && serializedTraceId.second == 0) {
+    return "";
+  }
+  return folly::sformat(
+      "{:x}:{:x}", serializedTraceId.first, serializedTraceId.second);
 }
 
 #else
@@ -217,7 +217,13 @@ class CarbonProtocolReader {
   }
 
   void readRawInto(std::string& s) {
-    s = cursor_.readFixedString(readVarint<uint32_t>());
+    // Read in place instead of assigning a freshly allocated string, so
+    // deserializing into a recycled message object reuses its capacity.
+    const auto len = readVarint<uint32_t>();
+    s.resize(len);
+    if (len > 0) {
+      cursor_.pull(&s[0], len);
+    }
   }
 
   void readRawInto(folly::IOBuf& buf) {
@@ -40,4 +40,53 @@ void CarbonQueueAppenderStorage::coalesce() {
   iovs_[1] = {const_cast<uint8_t*>(head_->data()), head_->length()};
 }
 
+std::unique_ptr<folly::IOBuf>
+CarbonQueueAppenderStorage::createOwnedIOBufChain() {
+  const auto iovsAndCount = getIovecs();
+  const struct iovec* iovs = iovsAndCount.first;
+  const size_t iovsCount = iovsAndCount.second;
+
+  std::unique_ptr<folly::IOBuf> chain;
+  for (size_t i = 0; i < iovsCount; ++i) {
+    const auto* base = static_cast<const uint8_t*>(iovs[i].iov_base);
+    const size_t len = iovs[i].iov_len;
+    if (len == 0) {
+      continue;
+    }
+
+    std::unique_ptr<folly::IOBuf> piece;
+    if (head_) {
+      // Large appended buffers (keys and values) are views into head_;
+      // share their ownership instead of copying the data.
+      const folly::IOBuf* buf = head_.get_pointer();
+      do {
+        if (buf->isManagedOne() && base >= buf->data() &&
+            base + len <= buf->data() + buf->length()) {
+          piece = buf->cloneOne();
+          piece->trimStart(base - buf->data());
+          piece->trimEnd(piece->length() - len);
+          break;
+        }
+        buf = buf->next();
+      } while (buf != head_.get_pointer());
+    }
+    if (!piece) {
+      // Header and other small bits live in storage_, and unmanaged buffers
+      // cannot have their lifetime extended, so those must be copied.
+      piece = folly::IOBuf::copyBuffer(base, len);
+    }
+
+    if (!chain) {
+      chain = std::move(piece);
+    } else {
+      chain->prependChain(std::move(piece));
+    }
+  }
+
+  if (!chain) {
+    chain = folly::IOBuf::create(0);
+  }
+  return chain;
+}
+
 } // carbon
@@ -9,6 +9,7 @@
 
 #include <sys/uio.h>
 
+#include <memory>
 #include <type_traits>
 #include <utility>
 
@@ -25,6 +26,11 @@ namespace carbon {
 
 class CarbonQueueAppenderStorage {
  public:
+  // Largest buffer append() copies into internal storage instead of
+  // keeping an IOBuf reference; also used by size estimators to tell
+  // the two apart (see SerializedSize.h).
+  static constexpr size_t kInlineIOBufLen{128};
+
   CarbonQueueAppenderStorage() {
     iovs_[0] = {storage_, 0};
   }
@@ -37,7 +43,7 @@ class CarbonQueueAppenderStorage {
     // IOBuf copy is a very expensive procedure (64 bytes object + atomic
     // operation), avoid incuring that cost for small buffers.
     if (!buf.empty() && !buf.isChained() && buf.length() <= kInlineIOBufLen &&
-        storageIdx_ + buf.length() <= sizeof(storage_)) {
+        storageIdx_ + buf.length() <= storageSize_) {
       push(buf.data(), buf.length());
       return;
     }
@@ -87,7 +93,7 @@ class CarbonQueueAppenderStorage {
 
     assert(nIovsUsed_ < kMaxIovecs);
 
-    if (storageIdx_ + len <= sizeof(storage_)) {
+    if (storageIdx_ + len <= storageSize_) {
       if (!canUsePreviousIov_) {
         // Note, we will be updating iov_len once we're done with this iovec,
         // i.e. in finalizeLastIovec()
@@ -121,6 +127,13 @@ class CarbonQueueAppenderStorage {
   }
 
   void reset() {
+    // Keep a moderately sized heap buffer for the next message; hand
+    // back outsized ones so pooled storages don't pin peak allocations.
+    if (heapStorage_ && storageSize_ > kMaxRetainedStorageSize) {
+      heapStorage_.reset();
+      storage_ = inlineStorage_;
+      storageSize_ = sizeof(inlineStorage_);
+    }
     storageIdx_ = kMaxHeaderLength;
     head_.clear();
     // Reserve first element of iovs_ for header, which won't be filled in
@@ -131,6 +144,27 @@ class CarbonQueueAppenderStorage {
     headerOverlap_ = 0;
   }
 
+  /**
+   * Hint with an upper bound of the bytes the message will write through
+   * internal storage (see SerializedSizeEstimate::dataSize), so a message
+   * known to exceed the inline buffer gets one exactly sized heap buffer
+   * up front instead of spilling into a heap IOBuf copy per overflowing
+   * chunk. Must be called right after construction or reset(), before
+   * any data is appended; a hint that fits the current buffer is a no-op,
+   * and an under-estimate just falls back to the spill path.
+   */
+  void reserve(size_t dataSizeEstimate) {
+    const size_t needed = dataSizeEstimate + kMaxHeaderLength;
+    if (needed <= storageSize_) {
+      return;
+    }
+    assert(nIovsUsed_ == 1 && storageIdx_ == kMaxHeaderLength);
+    heapStorage_ = std::make_unique<uint8_t[]>(needed);
+    storage_ = heapStorage_.get();
+    storageSize_ = needed;
+    iovs_[0] = {storage_, 0};
+  }
+
   std::pair<const struct iovec*, size_t> getIovecs() {
     finalizeLastIovec();
     return iovs_[0].iov_len == 0 ? std::make_pair(iovs_ + 1, nIovsUsed_ - 1)
@@ -177,9 +211,22 @@ class CarbonQueueAppenderStorage {
     return applyZeroCopy_;
   }
 
+  /**
+   * Builds an IOBuf chain covering exactly the serialized data described by
+   * getIovecs().  Segments backed by head_ share ownership of the underlying
+   * buffers (no data copy for keys/values); small iovecs pointing into
+   * internal storage are copied.  The resulting chain therefore stays valid
+   * even after this storage is destroyed, which is required for zero copy
+   * writes where the kernel may reference the pages after the request
+   * completes or times out.
+   */
+  std::unique_ptr<folly::IOBuf> createOwnedIOBufChain();
+
  private:
   static constexpr size_t kMaxIovecs{32};
-  static constexpr size_t kInlineIOBufLen{128};
+  // Heap storage above this size is released in reset() instead of
+  // being retained for the next message.
+  static constexpr size_t kMaxRetainedStorageSize{4096};
 
   static constexpr size_t kMaxAdditionalFields = 6;
   static constexpr size_t kMaxHeaderLength = 1 /* magic byte */ +
@@ -196,8 +243,12 @@ class CarbonQueueAppenderStorage {
   size_t tcpZeroCopyThreshold_{0};
 
   // Buffer used for non-IOBuf data, e.g., ints, strings, and protocol
-  // data
-  uint8_t storage_[512 + kMaxHeaderLength];
+  // data. storage_ normally points at inlineStorage_; reserve() swaps in
+  // an exactly sized heap buffer for messages known to be bigger.
+  uint8_t inlineStorage_[512 + kMaxHeaderLength];
+  std::unique_ptr<uint8_t[]> heapStorage_;
+  uint8_t* storage_{inlineStorage_};
+  size_t storageSize_{sizeof(inlineStorage_)};
 
   // The first iovec in iovs_ points to Caret message header data, and nothing
   // else. The remaining iovecs are used for the message body. Note that we do
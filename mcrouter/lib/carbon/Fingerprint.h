@@ -0,0 +1,216 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <type_traits>
+
+#include <folly/Optional.h>
+#include <folly/Range.h>
+#include <folly/hash/SpookyHashV2.h>
+#include <folly/io/IOBuf.h>
+
+#include "mcrouter/lib/carbon/CarbonQueueAppender.h"
+#include "mcrouter/lib/carbon/Fields.h"
+#include "mcrouter/lib/carbon/Keys.h"
+#include "mcrouter/lib/carbon/SerializationTraits.h"
+
+namespace carbon {
+
+/**
+ * 64-bit fingerprint of a message's serialized content, computed with a
+ * field walk only (no serialization).  Two messages of the same type with
+ * equal fingerprints serialize to the same bytes, so a cached serialized
+ * body may be reused when the fingerprint matches (see
+ * SerializedRequestBodyCache).
+ *
+ * Buffers the serializer copies into its storage (keys, strings, values
+ * up to the inline threshold) are hashed by content.  Larger managed
+ * buffers are appended by reference on both the fresh and the cached
+ * path, so for those hashing the (pointer, length) identity of each
+ * chain segment is exact: a matching identity means the cached body
+ * references the very same memory a fresh serialization would.  The
+ * snapshot's clone keeps that memory alive, so a recycled allocation
+ * can never alias a cached segment.
+ *
+ * Returns none for messages carrying fields the walk cannot observe
+ * (user types and maps serialized through their own traits); such
+ * messages must not use a serialized-body cache.
+ */
+template <class Message>
+folly::Optional<uint64_t> messageFingerprint(const Message& message);
+
+namespace detail {
+
+class FingerprintVisitor {
+ public:
+  template <class T>
+  bool enterMixin(uint16_t /* id */, folly::StringPiece /* name */, const T&) {
+    return true;
+  }
+
+  bool leaveMixin() {
+    return true;
+  }
+
+  template <class T>
+  bool visitField(uint16_t id, folly::StringPiece /* name */, const T& value) {
+    combine(id);
+    addValue(value);
+    return exact_;
+  }
+
+  folly::Optional<uint64_t> moveOutput() {
+    if (!exact_) {
+      return folly::none;
+    }
+    return hash_;
+  }
+
+ private:
+  // Arbitrary odd seed; only consistency within a process run matters.
+  uint64_t hash_{0x9e3779b97f4a7c15};
+  bool exact_{true};
+
+  void combine(uint64_t value) {
+    hash_ = folly::hash::SpookyHashV2::Hash64(&value, sizeof(value), hash_);
+  }
+
+  void addBytes(folly::StringPiece bytes) {
+    combine(bytes.size());
+    hash_ =
+        folly::hash::SpookyHashV2::Hash64(bytes.data(), bytes.size(), hash_);
+  }
+
+  void addValue(const folly::IOBuf& value) {
+    if (!value.isChained() &&
+        value.length() <= CarbonQueueAppenderStorage::kInlineIOBufLen) {
+      // Copied into the appender's storage; content is what ends up on
+      // the wire.
+      addBytes(folly::StringPiece(
+          reinterpret_cast<const char*>(value.data()), value.length()));
+      return;
+    }
+    const folly::IOBuf* buf = &value;
+    do {
+      if (buf->isManagedOne()) {
+        // Referenced, not copied, by both the serializer and the body
+        // snapshot; identity of the segment is exact (see above).
+        combine(reinterpret_cast<uintptr_t>(buf->data()));
+        combine(buf->length());
+      } else {
+        // Unmanaged buffers are copied into the snapshot, so only their
+        // content identifies what the cached body holds.
+        addBytes(folly::StringPiece(
+            reinterpret_cast<const char*>(buf->data()), buf->length()));
+      }
+      buf = buf->next();
+    } while (buf != &value);
+  }
+
+  template <class T>
+  void addValue(const Keys<T>& value) {
+    // Keys are bounded in length; always hash by content.
+    addBytes(value.fullKey());
+  }
+
+  void addValue(bool value) {
+    combine(value ? 1 : 0);
+  }
+
+  template <class T>
+  void addValue(const folly::Optional<T>& value) {
+    combine(value.hasValue() ? 1 : 0);
+    if (value.hasValue()) {
+      addValue(*value);
+    }
+  }
+
+  template <class T>
+  typename std::enable_if<std::is_arithmetic<T>::value>::type addValue(
+      const T& value) {
+    combine(static_cast<uint64_t>(value));
+  }
+
+  template <class T>
+  typename std::enable_if<!std::is_arithmetic<T>::value>::type addValue(
+      const T& value) {
+    addValue2(value);
+  }
+
+  template <class T>
+  typename std::enable_if<std::is_enum<T>::value>::type addValue2(
+      const T& value) {
+    combine(static_cast<uint64_t>(
+        static_cast<typename std::underlying_type<T>::type>(value)));
+  }
+
+  template <class T>
+  typename std::enable_if<!std::is_enum<T>::value>::type addValue2(
+      const T& value) {
+    addValue3(value);
+  }
+
+  template <class T>
+  typename std::enable_if<IsCarbonStruct<T>::value>::type addValue3(
+      const T& value) {
+    combine(0x5354 /* struct begin */);
+    value.visitFields(*this);
+    combine(0x5345 /* struct end */);
+  }
+
+  template <class T>
+  typename std::enable_if<!IsCarbonStruct<T>::value>::type addValue3(
+      const T& value) {
+    addValue4(value);
+  }
+
+  template <class T>
+  typename std::enable_if<std::is_convertible<T, folly::StringPiece>::value>::
+      type
+      addValue4(const T& value) {
+    addBytes(folly::StringPiece(value));
+  }
+
+  template <class T>
+  typename std::enable_if<!std::is_convertible<T, folly::StringPiece>::value>::
+      type
+      addValue4(const T& value) {
+    addValue5(value);
+  }
+
+  template <class T>
+  typename std::enable_if<IsLinearContainer<T>::value>::type addValue5(
+      const T& value) {
+    for (auto it = SerializationTraits<T>::begin(value);
+         it != SerializationTraits<T>::end(value);
+         ++it) {
+      combine(0x4954 /* item */);
+      addValue(*it);
+    }
+  }
+
+  template <class T>
+  typename std::enable_if<!IsLinearContainer<T>::value>::type addValue5(
+      const T& /* value */) {
+    // Thrift wrapper structs, maps and user types serialize through
+    // their own traits; the walk cannot see their content, so no
+    // fingerprint can vouch for a cached body.
+    exact_ = false;
+  }
+};
+
+} // namespace detail
+
+template <class Message>
+folly::Optional<uint64_t> messageFingerprint(const Message& message) {
+  detail::FingerprintVisitor visitor;
+  message.visitFields(visitor);
+  return visitor.moveOutput();
+}
+
+} // namespace carbon
@@ -21,6 +21,13 @@ namespace carbon {
 
 class NoopAdditionalLogger {
  public:
+  /**
+   * Routers whose AdditionalLogger declares enabled = false never have the
+   * logger constructed or its log() arguments marshaled; the call site
+   * folds away at compile time.
+   */
+  static constexpr bool enabled{false};
+
   explicit NoopAdditionalLogger(
       const facebook::memcache::mcrouter::ProxyRequestContext&) {}
 
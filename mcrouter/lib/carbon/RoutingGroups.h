@@ -89,6 +89,22 @@ struct ArithmeticLike {
 template <typename Request = void>
 using ArithmeticLikeT = typename ArithmeticLike<Request>::Type;
 
+/**
+ * @class HighPriority
+ * @tparam Request Request type
+ * @brief Utility class to check if Request should jump ahead of normal
+ *        traffic in intra-process queues.
+ *
+ * Delete-like requests are high priority by default: queueing an
+ * invalidation behind a burst of bulk reads widens the consistency
+ * window, while the reverse only delays data that is already stale.
+ * Specialize for individual request types to override.
+ */
+template <typename Request = void>
+struct HighPriority {
+  static const bool value = DeleteLike<Request>::value;
+};
+
 /**
  * @class OtherThan
  * @tparam Request Request type
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2016-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "mcrouter/lib/RequestLoggerContext.h"
+#include "mcrouter/lib/mc/msg.h"
+
+// Forward declaration
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+class ProxyRequestContext;
+} // mcrouter
+} // memcache
+} // facebook
+
+namespace carbon {
+
+/**
+ * Drop-in for RouterInfo::AdditionalLogger that keeps a sample of recent
+ * replies in a per-thread ring buffer for post-hoc inspection (each proxy
+ * owns its event base thread, so per-thread is per-proxy).
+ *
+ * One reply in kSampleEvery is recorded as a small POD entry; the rest
+ * cost one counter increment. The ring overwrites in place and never
+ * allocates after the first sample on a thread.
+ */
+class SampledAdditionalLogger {
+ public:
+  static constexpr bool enabled{true};
+
+  struct Entry {
+    int64_t endTimeUs{0};
+    int64_t durationUs{0};
+    mc_res_t replyResult{mc_res_unknown};
+    bool isNormalRequest{false};
+  };
+
+  static constexpr size_t kRingSize = 1024; // must be a power of two
+  static constexpr uint32_t kSampleEvery = 64;
+
+  explicit SampledAdditionalLogger(
+      const facebook::memcache::mcrouter::ProxyRequestContext&) {}
+
+  template <class Request>
+  void log(
+      const Request&,
+      const typename Request::reply_type&,
+      const facebook::memcache::mcrouter::RequestLoggerContext& ctx) {
+    auto& ring = threadRing();
+    if (++ring.seen % kSampleEvery != 0) {
+      return;
+    }
+    auto& entry = ring.entries[ring.next++ & (kRingSize - 1)];
+    entry.endTimeUs = ctx.endTimeUs;
+    entry.durationUs = ctx.endTimeUs - ctx.startTimeUs;
+    entry.replyResult = ctx.replyResult;
+    entry.isNormalRequest = ctx.requestClass.isNormal();
+  }
+
+  /**
+   * Visits the samples recorded on the calling thread, oldest first.
+   */
+  template <class F>
+  static void forEachSample(F&& f) {
+    const auto& ring = threadRing();
+    const size_t count = std::min(ring.next, kRingSize);
+    for (size_t i = ring.next - count; i != ring.next; ++i) {
+      f(ring.entries[i & (kRingSize - 1)]);
+    }
+  }
+
+ private:
+  struct Ring {
+    std::array<Entry, kRingSize> entries;
+    uint64_t seen{0};
+    size_t next{0};
+  };
+
+  static Ring& threadRing() {
+    static thread_local Ring ring;
+    return ring;
+  }
+};
+
+} // carbon
@@ -0,0 +1,199 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <string>
+#include <type_traits>
+
+#include <folly/Optional.h>
+#include <folly/Range.h>
+#include <folly/Varint.h>
+#include <folly/io/IOBuf.h>
+
+#include "mcrouter/lib/carbon/CarbonQueueAppender.h"
+#include "mcrouter/lib/carbon/Fields.h"
+#include "mcrouter/lib/carbon/Keys.h"
+#include "mcrouter/lib/carbon/SerializationTraits.h"
+
+namespace carbon {
+
+/**
+ * Upper-bound estimate of a message's serialized size, split by where
+ * the bytes end up during serialization:
+ *
+ *  - dataSize: bytes written through the appender's internal storage
+ *    (field headers, varints, strings and small buffers). This is what
+ *    CarbonQueueAppenderStorage::reserve() wants.
+ *  - referencedSize: bytes of large IOBuf fields (keys and values),
+ *    which are appended by reference and never copied into storage.
+ *
+ * The estimate is computed with a field walk only (no serialization),
+ * so it costs a few adds per field. It deliberately over-counts
+ * variable-length integers at their maximum encoded size; an
+ * over-estimate merely reserves a little extra space, while an
+ * under-estimate just falls back to the append path's per-chunk copies.
+ */
+struct SerializedSizeEstimate {
+  size_t dataSize{0};
+  size_t referencedSize{0};
+
+  size_t total() const {
+    return dataSize + referencedSize;
+  }
+};
+
+template <class Message>
+SerializedSizeEstimate estimateSerializedSize(const Message& message);
+
+namespace detail {
+
+class SerializedSizeVisitor {
+ public:
+  template <class T>
+  bool enterMixin(uint16_t /* id */, folly::StringPiece /* name */, const T&) {
+    return true;
+  }
+
+  bool leaveMixin() {
+    return true;
+  }
+
+  template <class T>
+  bool visitField(uint16_t /* id */, folly::StringPiece /* name */,
+                  const T& value) {
+    estimate_.dataSize += kMaxFieldHeader;
+    addValue(value);
+    return true;
+  }
+
+  SerializedSizeEstimate moveOutput() {
+    return estimate_;
+  }
+
+ private:
+  // Field type + two-byte id, plus a length varint for var-size fields.
+  static constexpr size_t kMaxFieldHeader =
+      3 + folly::kMaxVarintLength32;
+  // Struct begin/end delimiters of a nested struct.
+  static constexpr size_t kStructOverhead = 2;
+
+  SerializedSizeEstimate estimate_;
+
+  void addBlob(size_t length) {
+    // Small buffers are copied into the appender's storage; larger ones
+    // are appended by reference (see CarbonQueueAppenderStorage).
+    if (length <= CarbonQueueAppenderStorage::kInlineIOBufLen) {
+      estimate_.dataSize += length;
+    } else {
+      estimate_.referencedSize += length;
+    }
+  }
+
+  void addValue(const folly::IOBuf& value) {
+    addBlob(value.computeChainDataLength());
+  }
+
+  template <class T>
+  void addValue(const Keys<T>& value) {
+    addBlob(value.fullKey().size());
+  }
+
+  void addValue(bool /* value */) {
+    // Encoded entirely in the field type.
+  }
+
+  template <class T>
+  void addValue(const folly::Optional<T>& value) {
+    if (value.hasValue()) {
+      addValue(*value);
+    }
+  }
+
+  template <class T>
+  typename std::enable_if<std::is_arithmetic<T>::value>::type addValue(
+      const T& /* value */) {
+    estimate_.dataSize += folly::kMaxVarintLength64;
+  }
+
+  template <class T>
+  typename std::enable_if<!std::is_arithmetic<T>::value>::type addValue(
+      const T& value) {
+    addValue2(value);
+  }
+
+  template <class T>
+  typename std::enable_if<std::is_enum<T>::value>::type addValue2(
+      const T& /* value */) {
+    estimate_.dataSize += folly::kMaxVarintLength64;
+  }
+
+  template <class T>
+  typename std::enable_if<!std::is_enum<T>::value>::type addValue2(
+      const T& value) {
+    addValue3(value);
+  }
+
+  template <class T>
+  typename std::enable_if<IsCarbonStruct<T>::value>::type addValue3(
+      const T& value) {
+    const auto nested = estimateSerializedSize(value);
+    estimate_.dataSize += nested.dataSize + kStructOverhead;
+    estimate_.referencedSize += nested.referencedSize;
+  }
+
+  template <class T>
+  typename std::enable_if<!IsCarbonStruct<T>::value>::type addValue3(
+      const T& value) {
+    addValue4(value);
+  }
+
+  template <class T>
+  typename std::enable_if<std::is_convertible<T, folly::StringPiece>::value>::
+      type
+      addValue4(const T& value) {
+    // Strings always go through the appender's storage.
+    estimate_.dataSize += folly::StringPiece(value).size();
+  }
+
+  template <class T>
+  typename std::enable_if<!std::is_convertible<T, folly::StringPiece>::value>::
+      type
+      addValue4(const T& value) {
+    addValue5(value);
+  }
+
+  template <class T>
+  typename std::enable_if<IsLinearContainer<T>::value>::type addValue5(
+      const T& value) {
+    for (auto it = SerializationTraits<T>::begin(value);
+         it != SerializationTraits<T>::end(value);
+         ++it) {
+      estimate_.dataSize += kMaxFieldHeader;
+      addValue(*it);
+    }
+  }
+
+  template <class T>
+  typename std::enable_if<!IsLinearContainer<T>::value>::type addValue5(
+      const T& /* value */) {
+    // Thrift wrapper structs, maps and user types serialize through
+    // their own traits; we can't see their size without serializing, so
+    // they contribute nothing. Under-estimating is safe (see above).
+  }
+};
+
+} // namespace detail
+
+template <class Message>
+SerializedSizeEstimate estimateSerializedSize(const Message& message) {
+  detail::SerializedSizeVisitor visitor;
+  message.visitFields(visitor);
+  return visitor.moveOutput();
+}
+
+} // namespace carbon
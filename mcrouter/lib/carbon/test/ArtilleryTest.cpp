@@ -0,0 +1,35 @@
+/*
+ *  Copyright (c) 2016-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include "mcrouter/lib/carbon/Artillery.h"
+
+using namespace carbon::tracing;
+
+#ifdef LIBMC_FBTRACE_DISABLE
+
+TEST(Artillery, roundTrip) {
+  const std::pair<uint64_t, uint64_t> ids{0x1234abcdull, 0xff00ff00ff00ull};
+  auto context = deserializeTraceContext(ids);
+  EXPECT_FALSE(context.empty());
+  EXPECT_EQ(ids, serializeTraceContext(context));
+}
+
+TEST(Artillery, zeroIdsHaveNoContext) {
+  EXPECT_EQ("", deserializeTraceContext({0, 0}));
+}
+
+TEST(Artillery, malformedContext) {
+  const std::pair<uint64_t, uint64_t> none{0, 0};
+  EXPECT_EQ(none, serializeTraceContext(""));
+  EXPECT_EQ(none, serializeTraceContext("no-separator"));
+  EXPECT_EQ(none, serializeTraceContext("12ab:34cd:extra"));
+  EXPECT_EQ(none, serializeTraceContext("xyz:12"));
+}
+
+#endif
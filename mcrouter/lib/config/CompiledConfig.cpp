@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include "CompiledConfig.h"
+
+#include <cstring>
+
+#include "mcrouter/lib/fbi/cpp/util.h"
+
+namespace facebook {
+namespace memcache {
+
+namespace {
+
+constexpr uint32_t kCompiledConfigMagic = 0x4d435243; // "CRCM"
+constexpr uint32_t kCompiledConfigVersion = 1;
+
+enum class Tag : uint8_t {
+  Null = 0,
+  False = 1,
+  True = 2,
+  Int = 3,
+  Double = 4,
+  String = 5,
+  Array = 6,
+  Object = 7,
+};
+
+template <class T>
+void appendRaw(std::string& buf, T value) {
+  buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+T readRaw(folly::StringPiece& buf) {
+  checkLogic(buf.size() >= sizeof(T), "Compiled config: truncated buffer");
+  T value;
+  std::memcpy(&value, buf.data(), sizeof(T));
+  buf.advance(sizeof(T));
+  return value;
+}
+
+void appendValue(std::string& buf, const folly::dynamic& value) {
+  switch (value.type()) {
+    case folly::dynamic::NULLT:
+      buf.push_back(static_cast<char>(Tag::Null));
+      break;
+    case folly::dynamic::BOOL:
+      buf.push_back(
+          static_cast<char>(value.getBool() ? Tag::True : Tag::False));
+      break;
+    case folly::dynamic::INT64:
+      buf.push_back(static_cast<char>(Tag::Int));
+      appendRaw(buf, static_cast<uint64_t>(value.getInt()));
+      break;
+    case folly::dynamic::DOUBLE:
+      buf.push_back(static_cast<char>(Tag::Double));
+      appendRaw(buf, value.getDouble());
+      break;
+    case folly::dynamic::STRING: {
+      buf.push_back(static_cast<char>(Tag::String));
+      const auto& str = value.getString();
+      appendRaw(buf, static_cast<uint32_t>(str.size()));
+      buf.append(str);
+      break;
+    }
+    case folly::dynamic::ARRAY:
+      buf.push_back(static_cast<char>(Tag::Array));
+      appendRaw(buf, static_cast<uint32_t>(value.size()));
+      for (const auto& item : value) {
+        appendValue(buf, item);
+      }
+      break;
+    case folly::dynamic::OBJECT:
+      buf.push_back(static_cast<char>(Tag::Object));
+      appendRaw(buf, static_cast<uint32_t>(value.size()));
+      for (const auto& item : value.items()) {
+        checkLogic(
+            item.first.isString(), "Compiled config: object key not a string");
+        appendValue(buf, item.first);
+        appendValue(buf, item.second);
+      }
+      break;
+  }
+}
+
+folly::dynamic readValue(folly::StringPiece& buf) {
+  const auto tag = static_cast<Tag>(readRaw<uint8_t>(buf));
+  switch (tag) {
+    case Tag::Null:
+      return nullptr;
+    case Tag::False:
+      return false;
+    case Tag::True:
+      return true;
+    case Tag::Int:
+      return static_cast<int64_t>(readRaw<uint64_t>(buf));
+    case Tag::Double:
+      return readRaw<double>(buf);
+    case Tag::String: {
+      auto size = readRaw<uint32_t>(buf);
+      checkLogic(buf.size() >= size, "Compiled config: truncated string");
+      folly::dynamic result = std::string(buf.data(), size);
+      buf.advance(size);
+      return result;
+    }
+    case Tag::Array: {
+      auto size = readRaw<uint32_t>(buf);
+      auto result = folly::dynamic::array();
+      for (uint32_t i = 0; i < size; ++i) {
+        result.push_back(readValue(buf));
+      }
+      return result;
+    }
+    case Tag::Object: {
+      auto size = readRaw<uint32_t>(buf);
+      folly::dynamic result = folly::dynamic::object;
+      for (uint32_t i = 0; i < size; ++i) {
+        auto key = readValue(buf);
+        checkLogic(
+            key.isString(), "Compiled config: object key not a string");
+        result[std::move(key)] = readValue(buf);
+      }
+      return result;
+    }
+  }
+  throwLogic(
+      "Compiled config: invalid type tag {}", static_cast<uint32_t>(tag));
+}
+
+} // anonymous namespace
+
+std::string compileConfig(const folly::dynamic& config) {
+  std::string buf;
+  appendRaw(buf, kCompiledConfigMagic);
+  appendRaw(buf, kCompiledConfigVersion);
+  appendValue(buf, config);
+  return buf;
+}
+
+folly::dynamic parseCompiledConfig(folly::StringPiece buf) {
+  checkLogic(
+      readRaw<uint32_t>(buf) == kCompiledConfigMagic,
+      "Compiled config: magic mismatch");
+  checkLogic(
+      readRaw<uint32_t>(buf) == kCompiledConfigVersion,
+      "Compiled config: version mismatch");
+  auto result = readValue(buf);
+  checkLogic(buf.empty(), "Compiled config: trailing bytes");
+  return result;
+}
+
+} // memcache
+} // facebook
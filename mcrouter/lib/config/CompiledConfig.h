@@ -0,0 +1,48 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <string>
+
+#include <folly/Range.h>
+#include <folly/dynamic.h>
+
+namespace facebook {
+namespace memcache {
+
+/**
+ * Versioned binary serialization of a folly::dynamic tree, used for
+ * compiled config artifacts. Loading it is a single pass over the buffer
+ * with no string escape processing, so it is much cheaper than parsing
+ * the equivalent JSON on startup.
+ *
+ * Layout: u32 magic, u32 version, then one value. Values are a type tag
+ * byte followed by the payload: null and bools carry no payload (the tag
+ * encodes true/false), ints are u64, doubles 8 raw bytes, strings u32
+ * length plus bytes, arrays/objects u32 element count followed by the
+ * items (objects store alternating string keys and values). Integers are
+ * in host byte order: the artifact is a per-host cache, not an
+ * interchange format.
+ */
+
+/**
+ * Serializes a dynamic into the compiled config format.
+ */
+std::string compileConfig(const folly::dynamic& config);
+
+/**
+ * Parses a compiled config artifact.
+ *
+ * @return  The deserialized dynamic.
+ * @throws  std::logic_error if the buffer is not a compiled config of
+ *          the current version or is truncated/corrupt.
+ */
+folly::dynamic parseCompiledConfig(folly::StringPiece buf);
+
+} // memcache
+} // facebook
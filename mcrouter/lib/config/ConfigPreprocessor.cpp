@@ -479,11 +479,14 @@ class ConfigPreprocessor::BuiltIns {
     dynamic result = nullptr;
     try {
       auto jsonC = importResolver.import(pathStr);
+      p.importTrace_.emplace_back(pathStr.str(), Md5Hash(jsonC));
       // result may contain comments, macros, etc.
       result =
           p.expandMacros(parseJsonString(stripComments(jsonC)), Context(p));
     } catch (const std::exception& e) {
       if (auto defaultVal = ctx.tryExpandRawArg("default")) {
+        // Empty hash: the import failed and the default was used.
+        p.importTrace_.emplace_back(pathStr.str(), std::string());
         p.importCache_.emplace(pathStr, *defaultVal);
         return std::move(*defaultVal);
       }
@@ -1806,6 +1809,7 @@ dynamic ConfigPreprocessor::replaceParams(
     StringPiece str,
     const Context& context) const {
   string buf;
+  buf.reserve(str.size());
   while (!str.empty()) {
     auto pos = unescapeUntil(str, buf, '%');
     if (pos == string::npos) {
@@ -1939,8 +1943,18 @@ dynamic ConfigPreprocessor::expandMacros(dynamic json, const Context& context)
   NestedLimitGuard nestedGuard(nestedLimit_);
 
   if (json.isString()) {
+    const auto sp = json.stringPiece();
+    // Fast path: a plain string with no macro call, parameter or escape
+    // needs no expansion. The vast majority of string nodes in a large
+    // config land here, so hand the node back instead of rebuilding the
+    // string byte by byte in replaceParams().
+    if ((sp.empty() || sp[0] != '@') &&
+        sp.find('%') == StringPiece::npos &&
+        sp.find('\\') == StringPiece::npos) {
+      return json;
+    }
     // look for macros in string
-    return expandStringMacro(json.stringPiece(), context);
+    return expandStringMacro(sp, context);
   } else if (json.isObject()) {
     folly::Optional<Context> extContext;
     if (auto jVars = json.get_ptr("vars")) {
@@ -2065,8 +2079,8 @@ void ConfigPreprocessor::parseMacroDefs(dynamic jmacros) {
       parseMacroDef(it.first, it.second);
     }
   } else { // array
-    for (const auto& it : macros) {
-      parseMacroDefs(it);
+    for (auto& it : macros) {
+      parseMacroDefs(std::move(it));
     }
   }
 }
@@ -2075,7 +2089,8 @@ dynamic ConfigPreprocessor::getConfigWithoutMacros(
     StringPiece jsonC,
     ImportResolverIf& importResolver,
     folly::StringKeyedUnorderedMap<dynamic> globalParams,
-    size_t nestedLimit) {
+    size_t nestedLimit,
+    ImportTrace* importTrace) {
   auto config = parseJsonString(stripComments(jsonC));
   checkLogic(config.isObject(), "config is not an object");
 
@@ -2088,7 +2103,11 @@ dynamic ConfigPreprocessor::getConfigWithoutMacros(
     config.erase("macros");
   }
 
-  return prep.expandMacros(std::move(config), Context(prep));
+  auto result = prep.expandMacros(std::move(config), Context(prep));
+  if (importTrace) {
+    *importTrace = std::move(prep.importTrace_);
+  }
+  return result;
 }
 
 } // memcache
@@ -10,6 +10,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <folly/dynamic.h>
@@ -26,6 +27,13 @@ class ImportResolverIf;
  */
 class ConfigPreprocessor {
  public:
+  /**
+   * List of (path, md5 of imported content) pairs, in the order imports
+   * were resolved. An empty md5 marks an import that failed and fell
+   * back to its default value.
+   */
+  using ImportTrace = std::vector<std::pair<std::string, std::string>>;
+
   /**
    * Method to expand macros and get resulting dynamic object.
    *
@@ -34,6 +42,11 @@ class ConfigPreprocessor {
    * @param globalParams parameters available in all macros. Should not have
    *                     macros.
    * @param nestedLimit maximum number of nested macros/objects.
+   * @param importTrace if not null, filled with the paths and content
+   *                    hashes of all @import macros resolved during
+   *                    expansion. The expanded result is fully determined
+   *                    by (jsonC, globalParams, imported contents), so
+   *                    the trace lets callers validate a cached result.
    *
    * @return JSON without macros
    * @throws std::logic_error/folly::ParseError if jsonC is invalid
@@ -42,7 +55,8 @@ class ConfigPreprocessor {
       folly::StringPiece jsonC,
       ImportResolverIf& importResolver,
       folly::StringKeyedUnorderedMap<folly::dynamic> globalParams,
-      size_t nestedLimit = 250);
+      size_t nestedLimit = 250,
+      ImportTrace* importTrace = nullptr);
 
  private:
   /**
@@ -68,6 +82,7 @@ class ConfigPreprocessor {
   folly::StringKeyedUnorderedMap<std::unique_ptr<Macro>> macros_;
   folly::StringKeyedUnorderedMap<std::unique_ptr<Const>> consts_;
   folly::StringKeyedUnorderedMap<folly::dynamic> importCache_;
+  ImportTrace importTrace_;
   folly::StringKeyedUnorderedMap<
       std::function<folly::dynamic(folly::dynamic&&, const Context&)>>
       builtInCalls_;
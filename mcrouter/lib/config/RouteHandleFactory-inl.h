@@ -101,7 +101,15 @@ RouteHandleFactory<RouteHandleIf>::createList(const folly::dynamic& json) {
       checkLogic(jType, "No type field in RouteHandle json object");
       checkLogic(
           jType->isString(), "Type field in RouteHandle is not a string");
-      return provider_.create(*this, jType->stringPiece(), json);
+      auto consedIt = consed_.find(json);
+      if (consedIt != consed_.end()) {
+        // Structurally identical definition seen before: reuse the
+        // whole subtree instead of building a copy.
+        return consedIt->second;
+      }
+      auto ret = provider_.create(*this, jType->stringPiece(), json);
+      consed_.emplace(json, ret);
+      return ret;
     }
   } else if (json.isString()) {
     if (json.empty()) {
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include <folly/Range.h>
@@ -82,6 +83,11 @@ class RouteHandleFactory {
   folly::StringKeyedUnorderedMap<folly::dynamic> registered_;
   /// Named routes we've already parsed
   folly::StringKeyedUnorderedMap<std::vector<RouteHandlePtr>> seen_;
+  /// Hash-consing of anonymous route handles: identical definitions
+  /// produce one shared subtree, turning the tree into a DAG. Keyed by
+  /// the full JSON definition, which (together with the name-memoization
+  /// above) fully determines the constructed subtree.
+  std::unordered_map<folly::dynamic, std::vector<RouteHandlePtr>> consed_;
   /// Thread where route handles created by this factory will be used
   size_t threadId_;
 
@@ -0,0 +1,63 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <folly/json.h>
+
+#include "mcrouter/lib/config/CompiledConfig.h"
+
+using facebook::memcache::compileConfig;
+using facebook::memcache::parseCompiledConfig;
+
+TEST(CompiledConfigTest, round_trip) {
+  folly::dynamic config = folly::dynamic::object(
+      "pools",
+      folly::dynamic::object(
+          "A",
+          folly::dynamic::object(
+              "servers",
+              folly::dynamic::array("10.0.0.1:11211", "10.0.0.2:11211"))))(
+      "int", 42)("negative", -7)("double", 0.25)("bool", true)(
+      "null", nullptr)("escapes", "quotes \" and \\ and \n tabs\t");
+
+  auto parsed = parseCompiledConfig(compileConfig(config));
+  EXPECT_EQ(config, parsed);
+
+  // Types survive exactly: ints don't become doubles and vice versa.
+  EXPECT_TRUE(parsed["int"].isInt());
+  EXPECT_TRUE(parsed["double"].isDouble());
+  EXPECT_TRUE(parsed["null"].isNull());
+}
+
+TEST(CompiledConfigTest, empty_containers) {
+  folly::dynamic config = folly::dynamic::object(
+      "emptyObject", folly::dynamic::object)(
+      "emptyArray", folly::dynamic::array())("emptyString", "");
+
+  EXPECT_EQ(config, parseCompiledConfig(compileConfig(config)));
+}
+
+TEST(CompiledConfigTest, rejects_corrupt_input) {
+  auto compiled = compileConfig(folly::dynamic::object("key", "value"));
+
+  // Not a compiled config at all (e.g. an old JSON cache file).
+  EXPECT_THROW(
+      parseCompiledConfig("{\"key\": \"value\"}"), std::logic_error);
+
+  // Every strict prefix is rejected as truncated.
+  for (size_t len = 0; len < compiled.size(); ++len) {
+    EXPECT_THROW(
+        parseCompiledConfig(folly::StringPiece(compiled.data(), len)),
+        std::logic_error);
+  }
+
+  // Trailing bytes are rejected too.
+  EXPECT_THROW(parseCompiledConfig(compiled + "x"), std::logic_error);
+}
@@ -154,3 +154,26 @@ TEST(ConfigPreprocessorTest, comments) {
 
   EXPECT_EQ(orig, expand);
 }
+
+TEST(ConfigPreprocessorTest, import_trace) {
+  MockImportResolver resolver;
+
+  const std::string config =
+      "{\"a\": \"@import(test)\","
+      " \"b\": \"@import(do_not_exist,fallback)\"}";
+
+  ConfigPreprocessor::ImportTrace trace;
+  auto json = ConfigPreprocessor::getConfigWithoutMacros(
+      config, resolver, kGlobalParams, 250, &trace);
+
+  EXPECT_EQ("mock_test", json["a"].getString());
+  EXPECT_EQ("fallback", json["b"].getString());
+
+  ASSERT_EQ(2, trace.size());
+  EXPECT_EQ("test", trace[0].first);
+  EXPECT_EQ(facebook::memcache::Md5Hash("\"mock_test\""), trace[0].second);
+  // Failed imports that fell back to their default are marked with an
+  // empty hash.
+  EXPECT_EQ("do_not_exist", trace[1].first);
+  EXPECT_TRUE(trace[1].second.empty());
+}
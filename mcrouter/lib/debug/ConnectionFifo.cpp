@@ -16,6 +16,11 @@ namespace memcache {
 
 namespace {
 
+// Capture quota per session: at most kSessionQuotaBytes may be written
+// by a single connection within each kSessionQuotaWindowUs window.
+constexpr uint64_t kSessionQuotaBytes = 1024 * 1024;
+constexpr uint64_t kSessionQuotaWindowUs = 1000 * 1000;
+
 uint64_t timeSinceEpoch() {
   using namespace std::chrono;
   return duration_cast<microseconds>(steady_clock::now().time_since_epoch())
@@ -181,11 +186,14 @@ bool ConnectionFifo::startMessage(
   if (!isConnected()) {
     return false;
   }
+  currentFilter_ = debugFifo_->filter();
+  dropCurrentMessage_ =
+      currentFilter_ && !currentFilter_->matchesTypeId(typeId);
   currentMessageHeader_.setDirection(direction);
   currentMessageHeader_.setTypeId(typeId);
   currentMessageHeader_.setTimeUs(timeSinceEpoch());
   nextPacketId_ = 0;
-  return true;
+  return !dropCurrentMessage_;
 }
 
 bool ConnectionFifo::writeData(const void* buf, size_t len) noexcept {
@@ -246,10 +254,31 @@ bool ConnectionFifo::writeData(
   // | PACKET HEADER | PACKET BODY |
   // -------------------------------
 
-  if (!isConnected() || iovcnt == 0) {
+  if (!isConnected() || iovcnt == 0 || dropCurrentMessage_) {
     return false;
   }
 
+  // Evaluate the reader's data pattern against the first chunk of the
+  // message, before anything is copied into the pipe. Serialized
+  // requests carry the key near the front, so for key-prefix filters a
+  // single look at the first chunk decides the whole message.
+  if (nextPacketId_ == 0 && currentFilter_ &&
+      !currentFilter_->matchesData(iov, iovcnt)) {
+    dropCurrentMessage_ = true;
+    return false;
+  }
+
+  if (nextPacketId_ == 0) {
+    // The sequence number is consumed even if the message ends up
+    // dropped, so that the reader sees the loss as a gap.
+    currentMessageHeader_.setMsgSequenceId(debugFifo_->allocateSequenceId());
+    if (!checkSessionQuota(currentMessageHeader_.timeUs())) {
+      dropCurrentMessage_ = true;
+      debugFifo_->countDroppedMessage();
+      return false;
+    }
+  }
+
   PipeIov pipeIov;
   IovecIterator iovIter(iov, iovcnt);
 
@@ -280,9 +309,15 @@ bool ConnectionFifo::writeData(
 
     // Write to pipe
     if (!debugFifo_->write(pipeIov.iov(), pipeIov.size())) {
+      // Suppress the rest of this message - a partial tail is useless to
+      // the reader - and account the loss.
+      dropCurrentMessage_ = true;
+      debugFifo_->countDroppedMessage();
       return false;
     }
 
+    quotaRemainingBytes_ -=
+        std::min<uint64_t>(quotaRemainingBytes_, packetSize);
     ++nextPacketId_;
     packetSize = 0;
     pipeIov.reset();
@@ -292,5 +327,13 @@ bool ConnectionFifo::writeData(
   return true;
 }
 
+bool ConnectionFifo::checkSessionQuota(uint64_t nowUs) noexcept {
+  if (nowUs - quotaWindowStartUs_ >= kSessionQuotaWindowUs) {
+    quotaWindowStartUs_ = nowUs;
+    quotaRemainingBytes_ = kSessionQuotaBytes;
+  }
+  return quotaRemainingBytes_ > 0;
+}
+
 } // memcache
 } // facebook
@@ -12,6 +12,7 @@
 
 #include "mcrouter/lib/debug/ConnectionFifoProtocol.h"
 #include "mcrouter/lib/debug/Fifo.h"
+#include "mcrouter/lib/debug/FifoFilter.h"
 
 namespace facebook {
 namespace memcache {
@@ -50,6 +51,10 @@ class ConnectionFifo {
   /**
    * Starts a new message.
    *
+   * Returns false if the reader's capture filter (if any) rejects the
+   * given type id; subsequent writeData() calls for this message are
+   * then no-ops.
+   *
    * @param direction   Whether the data was received or sent by connection.
    * @param typeId      Id of the type of the message.
    */
@@ -57,7 +62,7 @@ class ConnectionFifo {
 
   /**
    * Writes data to the FIFO, but only if there is reader (i.e. mcpiper)
-   * connected to it.
+   * connected to it and the message passes the reader's capture filter.
    *
    * Before writting data to the fifo, a new message must be started
    * (i.e. startMessage() should be called).
@@ -69,6 +74,20 @@ class ConnectionFifo {
   std::shared_ptr<Fifo> debugFifo_;
   MessageHeader currentMessageHeader_;
   uint32_t nextPacketId_{0};
+  // Capture filter of the current message, snapped at startMessage().
+  std::shared_ptr<const FifoFilter> currentFilter_;
+  bool dropCurrentMessage_{false};
+  // Per-session capture quota (token bucket), so that one busy connection
+  // cannot evict every other session's traffic from the shared fifo.
+  // Only touched from this connection's thread.
+  uint64_t quotaRemainingBytes_{0};
+  uint64_t quotaWindowStartUs_{0};
+
+  /**
+   * Refills the quota bucket if the current window has elapsed and tells
+   * whether this session may start another message.
+   */
+  bool checkSessionQuota(uint64_t nowUs) noexcept;
 };
 
 } // memcache
@@ -65,13 +65,16 @@ folly::SocketAddress MessageHeader::getPeerAddress() {
   switch (v) {
     case 1:
       return sizeof(MessageHeader) - sizeof(localPort_) - sizeof(direction_) -
-          sizeof(typeId_) - sizeof(timeUs_) - kRouterNameMaxSize;
+          sizeof(typeId_) - sizeof(timeUs_) - kRouterNameMaxSize -
+          sizeof(msgSequenceId_);
     case 2:
       return sizeof(MessageHeader) - sizeof(typeId_) - sizeof(timeUs_) -
-          kRouterNameMaxSize;
+          kRouterNameMaxSize - sizeof(msgSequenceId_);
     case 3:
-      return sizeof(MessageHeader) - kRouterNameMaxSize;
+      return sizeof(MessageHeader) - kRouterNameMaxSize - sizeof(msgSequenceId_);
     case 4:
+      return sizeof(MessageHeader) - sizeof(msgSequenceId_);
+    case 5:
       return sizeof(MessageHeader);
     default:
       throw std::logic_error(folly::sformat("Invalid version {}", v));
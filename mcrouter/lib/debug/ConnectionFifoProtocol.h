@@ -62,6 +62,9 @@ struct FOLLY_PACK_ATTR MessageHeader {
   const char* routerName() const {
     return routerName_;
   }
+  uint64_t msgSequenceId() const {
+    return folly::Endian::little(msgSequenceId_);
+  }
 
   char* peerAddressModifiable() {
     return peerAddress_;
@@ -87,6 +90,9 @@ struct FOLLY_PACK_ATTR MessageHeader {
   char* routerNameModifiable() {
     return routerName_;
   }
+  void setMsgSequenceId(uint64_t val) {
+    msgSequenceId_ = folly::Endian::little(val);
+  }
 
   folly::SocketAddress getLocalAddress();
   folly::SocketAddress getPeerAddress();
@@ -98,7 +104,7 @@ struct FOLLY_PACK_ATTR MessageHeader {
  private:
   // Control fields
   uint32_t magic_ = folly::Endian::little<uint32_t>(0xfaceb00c);
-  uint8_t version_{4};
+  uint8_t version_{5};
 
   // Peer address fields
   char peerAddress_[kAddressMaxSize]{'\0'}; // 0-terminated string of address
@@ -120,6 +126,11 @@ struct FOLLY_PACK_ATTR MessageHeader {
   uint64_t timeUs_{0};
 
   char routerName_[kRouterNameMaxSize]{'\0'}; // 0-terminated string of address
+
+  // Sequence number of this message within its fifo. Allocated for every
+  // message that reaches the fifo, whether or not it could be written, so
+  // gaps observed by the reader measure dropped messages.
+  uint64_t msgSequenceId_{0};
 };
 
 /**
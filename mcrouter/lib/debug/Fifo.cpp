@@ -92,6 +92,9 @@ bool Fifo::tryConnect() noexcept {
 
   int fd = folly::openNoInt(path_.c_str(), O_WRONLY | O_NONBLOCK);
   if (fd >= 0) {
+    // Load the filter before publishing the fd, so that writers never
+    // observe a connected fifo without the reader's filter in place.
+    loadFilter();
     fd_.store(fd);
     return true;
   }
@@ -99,11 +102,24 @@ bool Fifo::tryConnect() noexcept {
   return false;
 }
 
+void Fifo::loadFilter() noexcept {
+  std::shared_ptr<const FifoFilter> filter;
+  std::string spec;
+  if (folly::readFile(FifoFilter::getFilterPath(path_).c_str(), spec)) {
+    filter = FifoFilter::fromString(spec);
+    if (filter) {
+      VLOG(1) << "Using pushed-down filter for debug fifo \"" << path_ << "\"";
+    }
+  }
+  filter_ = std::move(filter);
+}
+
 void Fifo::disconnect() noexcept {
   auto oldFd = fd_.exchange(-1);
   if (oldFd >= 0) {
     close(oldFd);
   }
+  filter_ = nullptr;
 }
 
 bool Fifo::write(void* buf, size_t len) noexcept {
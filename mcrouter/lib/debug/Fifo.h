@@ -10,8 +10,14 @@
 #include <sys/uio.h>
 
 #include <atomic>
+#include <memory>
 #include <string>
 
+#include <folly/SharedMutex.h>
+#include <folly/Synchronized.h>
+
+#include "mcrouter/lib/debug/FifoFilter.h"
+
 namespace facebook {
 namespace memcache {
 
@@ -65,6 +71,41 @@ class Fifo {
   bool write(const struct iovec* iov, size_t iovcnt) noexcept;
   bool write(void* buf, size_t len) noexcept;
 
+  /**
+   * Returns the capture filter pushed down by the currently connected
+   * reader, or nullptr if everything should be captured. The filter is
+   * loaded from "{path}.filter" when the reader connects (see
+   * FifoFilter) and cleared on disconnect.
+   */
+  std::shared_ptr<const FifoFilter> filter() const noexcept {
+    return filter_.copy();
+  }
+
+  /**
+   * Allocates the sequence number for the next message written to this
+   * fifo. Every message that passes the reader's filter consumes one,
+   * even if it is subsequently dropped, so readers can measure loss by
+   * watching for gaps.
+   */
+  uint64_t allocateSequenceId() noexcept {
+    return nextSequenceId_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Records that a message could not be (fully) written - e.g. the pipe
+   * was full or a session exceeded its capture quota.
+   */
+  void countDroppedMessage() noexcept {
+    droppedMessages_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Number of messages dropped since this fifo was created.
+   */
+  uint64_t droppedMessages() const noexcept {
+    return droppedMessages_.load(std::memory_order_relaxed);
+  }
+
  private:
   /**
    * Creates a fifo on the given path.
@@ -77,12 +118,24 @@ class Fifo {
   const std::string path_;
   // Fifo file descriptor.
   std::atomic<int> fd_{-1};
+  // Capture filter of the currently connected reader (may be null).
+  folly::Synchronized<std::shared_ptr<const FifoFilter>, folly::SharedMutex>
+      filter_;
+  // Sequence number of the next message (shared by all writers).
+  std::atomic<uint64_t> nextSequenceId_{0};
+  // Messages that writers had to drop (pipe full, quota exceeded).
+  std::atomic<uint64_t> droppedMessages_{0};
 
   /**
    * Disconnects the pipe.
    */
   void disconnect() noexcept;
 
+  /**
+   * Loads the reader's filter spec file, if present.
+   */
+  void loadFilter() noexcept;
+
   friend class FifoManager;
 };
 
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2015-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include "FifoFilter.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include <folly/Conv.h>
+#include <folly/Format.h>
+#include <folly/String.h>
+
+namespace facebook {
+namespace memcache {
+
+bool FifoFilter::matchesTypeId(uint32_t msgTypeId) const noexcept {
+  if (typeId == 0 || msgTypeId == typeId) {
+    return true;
+  }
+  // Request type ids are odd and the paired reply is the next even id,
+  // so a request filter captures the reply as well.
+  return (typeId % 2 == 1) && msgTypeId == typeId + 1;
+}
+
+bool FifoFilter::matchesData(const struct iovec* iov, size_t iovcnt) const {
+  if (dataPattern.empty()) {
+    return true;
+  }
+
+  const folly::StringPiece pattern(dataPattern);
+  // Last pattern.size() - 1 bytes seen so far, so that occurrences
+  // straddling iovec boundaries are found.
+  std::string carry;
+  for (size_t i = 0; i < iovcnt; ++i) {
+    folly::StringPiece buf(
+        reinterpret_cast<const char*>(iov[i].iov_base), iov[i].iov_len);
+
+    if (!carry.empty()) {
+      auto window = carry;
+      window.append(buf.data(), std::min(buf.size(), pattern.size() - 1));
+      if (window.find(pattern) != std::string::npos) {
+        return true;
+      }
+    }
+    if (buf.find(pattern) != folly::StringPiece::npos) {
+      return true;
+    }
+
+    if (i + 1 < iovcnt && pattern.size() > 1) {
+      const size_t keep = pattern.size() - 1;
+      if (buf.size() >= keep) {
+        carry.assign(buf.data() + buf.size() - keep, keep);
+      } else {
+        carry.append(buf.data(), buf.size());
+        if (carry.size() > keep) {
+          carry.erase(0, carry.size() - keep);
+        }
+      }
+    }
+  }
+  return false;
+}
+
+std::string FifoFilter::toString() const {
+  std::string spec;
+  if (typeId != 0) {
+    spec += folly::sformat("type_id = {}\n", typeId);
+  }
+  if (!dataPattern.empty()) {
+    spec += folly::sformat("data_pattern = {}\n", dataPattern);
+  }
+  return spec;
+}
+
+std::shared_ptr<const FifoFilter> FifoFilter::fromString(
+    folly::StringPiece spec) {
+  auto filter = std::make_shared<FifoFilter>();
+
+  std::vector<folly::StringPiece> lines;
+  folly::split('\n', spec, lines);
+  for (const auto line : lines) {
+    auto pos = line.find('=');
+    if (pos == folly::StringPiece::npos) {
+      continue;
+    }
+    auto name = folly::trimWhitespace(line.subpiece(0, pos));
+    auto value = folly::trimWhitespace(line.subpiece(pos + 1));
+    if (name == "type_id") {
+      try {
+        filter->typeId = folly::to<uint32_t>(value);
+      } catch (const std::exception&) {
+        VLOG(1) << "Invalid type_id in fifo filter spec: " << value;
+      }
+    } else if (name == "data_pattern") {
+      filter->dataPattern = value.str();
+    }
+  }
+
+  if (filter->empty()) {
+    return nullptr;
+  }
+  return filter;
+}
+
+std::string FifoFilter::getFilterPath(folly::StringPiece fifoPath) {
+  return folly::to<std::string>(fifoPath, kFifoFilterSuffix);
+}
+
+} // memcache
+} // facebook
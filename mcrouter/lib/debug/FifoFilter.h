@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2015-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <sys/uio.h>
+
+#include <memory>
+#include <string>
+
+#include <folly/Range.h>
+
+namespace facebook {
+namespace memcache {
+
+/**
+ * Suffix appended to a fifo path to form the path of its filter spec.
+ */
+constexpr folly::StringPiece kFifoFilterSuffix{".filter"};
+
+/**
+ * Capture filter for a debug fifo, pushed down from the fifo reader
+ * (i.e. mcpiper) to the proxy that writes the fifo.
+ *
+ * The reader describes the traffic it is interested in by placing a
+ * small spec file next to the fifo ("{fifoPath}.filter", see
+ * getFilterPath()) before opening the fifo for reading. The proxy loads
+ * the spec when it connects to the fifo and evaluates it before copying
+ * any message data into the pipe, so the capture cost is proportional to
+ * the matched traffic rather than to the full connection throughput.
+ *
+ * Filtering is best effort and conservative on the proxy side: a message
+ * that passes the filter may still be discarded by the reader (e.g. the
+ * data pattern matched inside a value rather than a key), but the reader
+ * re-applies its own filters anyway. If the spec file is absent or
+ * malformed, everything is captured, which keeps old readers working
+ * unchanged.
+ */
+class FifoFilter {
+ public:
+  /**
+   * Id of the request type to capture (as passed to
+   * ConnectionFifo::startMessage()). 0 means any type. Requests have odd
+   * type ids and their replies the following even id, so a request type
+   * id also matches the corresponding reply type.
+   */
+  uint32_t typeId{0};
+
+  /**
+   * Raw bytes that must appear somewhere in the serialized message.
+   * Empty means any data. Keys appear verbatim on the wire in all
+   * supported protocols, so a key prefix works as a pattern; matches
+   * inside values are possible and show up as extra captured messages.
+   */
+  std::string dataPattern;
+
+  /**
+   * Whether this filter accepts anything at all beyond "capture
+   * everything".
+   */
+  bool empty() const noexcept {
+    return typeId == 0 && dataPattern.empty();
+  }
+
+  /**
+   * Tells whether a message with the given type id may match this filter.
+   */
+  bool matchesTypeId(uint32_t msgTypeId) const noexcept;
+
+  /**
+   * Tells whether the serialized message data matches dataPattern.
+   * Handles patterns that straddle iovec boundaries.
+   */
+  bool matchesData(const struct iovec* iov, size_t iovcnt) const;
+
+  /**
+   * Serializes this filter in the spec file format, suitable for
+   * writing to getFilterPath(fifoPath).
+   */
+  std::string toString() const;
+
+  /**
+   * Parses a filter spec ("name = value" lines, names "type_id" and
+   * "data_pattern"; unknown names and blank lines are ignored).
+   *
+   * @return  The parsed filter, or nullptr if the spec has no
+   *          constraints (or is malformed), i.e. everything should be
+   *          captured.
+   */
+  static std::shared_ptr<const FifoFilter> fromString(folly::StringPiece spec);
+
+  /**
+   * Path of the filter spec file for the given fifo path.
+   */
+  static std::string getFilterPath(folly::StringPiece fifoPath);
+};
+
+} // memcache
+} // facebook
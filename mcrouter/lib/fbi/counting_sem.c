@@ -144,3 +144,132 @@ void counting_sem_post(counting_sem_t* sem, int32_t n) {
     fbi_futex_wake(&sem->cnt, 1);
   }
 }
+
+/*
+ * Sharded semaphore.
+ *
+ * Shard counts never go negative: only blocking waits on a plain
+ * counting_sem set the -1 state, and the sharded code only uses the
+ * nonblocking acquire on individual shards. Blocking is implemented with
+ * the (waiters, seq) eventcount instead, so a post to any shard can wake
+ * a sleeper regardless of which shard it last inspected.
+ */
+
+static uint32_t counting_sem_home_shard(void) {
+  static __thread uint32_t shard = UINT32_MAX;
+  if (shard == UINT32_MAX) {
+    static uint32_t next_thread = 0;
+    shard = __sync_fetch_and_add(&next_thread, 1) % COUNTING_SEM_NUM_SHARDS;
+  }
+  return shard;
+}
+
+/*
+ * Acquire up to n tokens, home shard first, then stealing the remainder
+ * from the other shards in one batched sweep.
+ */
+static int32_t counting_sem_sharded_try(counting_sem_sharded_t* sem,
+                                        int32_t n) {
+  uint32_t home = counting_sem_home_shard();
+  int32_t total;
+  uint32_t i;
+
+  total = counting_sem_lazy_nonblocking(&sem->shards[home].sem, n);
+  for (i = 1; i < COUNTING_SEM_NUM_SHARDS && total < n; i++) {
+    counting_sem_t* shard =
+        &sem->shards[(home + i) % COUNTING_SEM_NUM_SHARDS].sem;
+    total += counting_sem_lazy_nonblocking(shard, n - total);
+  }
+  return total;
+}
+
+void counting_sem_sharded_init(counting_sem_sharded_t* sem, int32_t val) {
+  int32_t base, extra;
+  uint32_t i;
+
+  val = MAX(val, 0);
+  base = val / COUNTING_SEM_NUM_SHARDS;
+  extra = val % COUNTING_SEM_NUM_SHARDS;
+  for (i = 0; i < COUNTING_SEM_NUM_SHARDS; i++) {
+    counting_sem_init(&sem->shards[i].sem,
+                      base + (i < (uint32_t)extra ? 1 : 0));
+  }
+  sem->waiters = 0;
+  sem->seq = 0;
+}
+
+int32_t counting_sem_sharded_value(counting_sem_sharded_t* sem) {
+  int64_t total = 0;
+  uint32_t i;
+
+  for (i = 0; i < COUNTING_SEM_NUM_SHARDS; i++) {
+    total += counting_sem_value(&sem->shards[i].sem);
+  }
+  return MIN(total, INT32_MAX);
+}
+
+int32_t counting_sem_sharded_lazy_nonblocking(counting_sem_sharded_t* sem,
+                                              int32_t n) {
+  if (n <= 0) {
+    return 0;
+  }
+  return counting_sem_sharded_try(sem, n);
+}
+
+int32_t counting_sem_sharded_lazy_wait(counting_sem_sharded_t* sem,
+                                       int32_t n) {
+  int32_t m;
+  uint32_t seq;
+
+  if (n <= 0) {
+    return 0;
+  }
+
+  for (;;) {
+    m = counting_sem_sharded_try(sem, n);
+    if (m > 0) {
+      break;
+    }
+
+    /*
+     * Register as a waiter (full barrier), then recheck: a post that
+     * missed our registration must have left its tokens visible by now.
+     */
+    __sync_fetch_and_add(&sem->waiters, 1);
+    seq = ACCESS_ONCE(sem->seq);
+    m = counting_sem_sharded_try(sem, n);
+    if (m == 0) {
+      fbi_futex_wait(&sem->seq, seq);
+    }
+    __sync_fetch_and_sub(&sem->waiters, 1);
+    if (m > 0) {
+      break;
+    }
+  }
+
+  /*
+   * Tokens may remain (we took fewer than were posted) while other
+   * waiters sleep; pass the wakeup along.
+   */
+  if (ACCESS_ONCE(sem->waiters) > 0 && counting_sem_sharded_value(sem) > 0) {
+    __sync_fetch_and_add(&sem->seq, 1);
+    fbi_futex_wake(&sem->seq, 1);
+  }
+
+  return m;
+}
+
+void counting_sem_sharded_post(counting_sem_sharded_t* sem, int32_t n) {
+  if (n <= 0) {
+    return;
+  }
+
+  counting_sem_post(&sem->shards[counting_sem_home_shard()].sem, n);
+
+  /* The post above is a full barrier, so either the waiter's recheck sees
+     the tokens or we see its registration here. */
+  if (ACCESS_ONCE(sem->waiters) > 0) {
+    __sync_fetch_and_add(&sem->seq, 1);
+    fbi_futex_wake(&sem->seq, 1);
+  }
+}
@@ -82,4 +82,63 @@ int32_t counting_sem_lazy_nonblocking(counting_sem_t* sem, int32_t n);
  */
 void counting_sem_post(counting_sem_t* sem, int32_t n);
 
+/**
+ * A sharded counting semaphore.
+ *
+ * Same lazy semantics as counting_sem_t, but the value is spread over
+ * several cacheline-padded shards. Each thread is assigned a home shard;
+ * the common acquire/release is a CAS on that shard alone, so threads
+ * hammering the semaphore don't contend on a single futex word. When the
+ * home shard runs dry, the acquirer steals the remainder from the other
+ * shards in one batched sweep, which also rebalances tokens toward the
+ * threads actually using them (posts go to the poster's home shard).
+ *
+ * The cap stays strict: the total number of tokens is always the sum of
+ * the shard values. Blocked waiters sleep on a separate eventcount word
+ * (seq) that post() bumps whenever waiters are registered.
+ */
+#define COUNTING_SEM_NUM_SHARDS 8
+
+typedef struct counting_sem_shard_s {
+  counting_sem_t sem;
+  char pad[64 - sizeof(counting_sem_t)];
+} __attribute__((aligned(64))) counting_sem_shard_t;
+
+typedef struct counting_sem_sharded_s {
+  counting_sem_shard_t shards[COUNTING_SEM_NUM_SHARDS];
+  /** Number of threads blocked waiting for tokens. */
+  int32_t waiters;
+  /** Eventcount (futex word); bumped by post() when waiters are present. */
+  uint32_t seq;
+} counting_sem_sharded_t;
+
+/**
+ * Initialize the semaphore, distributing val over the shards.
+ * If val < 0, semaphore will be initialized with 0.
+ */
+void counting_sem_sharded_init(counting_sem_sharded_t* sem, int32_t val);
+
+/**
+ * Returns current semaphore value (sum over all shards).
+ */
+int32_t counting_sem_sharded_value(counting_sem_sharded_t* sem);
+
+/**
+ * Same contract as counting_sem_lazy_wait().
+ */
+int32_t counting_sem_sharded_lazy_wait(counting_sem_sharded_t* sem, int32_t n);
+
+/**
+ * Same contract as counting_sem_lazy_nonblocking().
+ */
+int32_t counting_sem_sharded_lazy_nonblocking(
+    counting_sem_sharded_t* sem,
+    int32_t n);
+
+/**
+ * Increments the caller's home shard by n.
+ * Does nothing if n <= 0.
+ */
+void counting_sem_sharded_post(counting_sem_sharded_t* sem, int32_t n);
+
 __END_DECLS
@@ -58,7 +58,10 @@ class ObjectPool {
     // First check the free list
     auto* obj = getFromFreeList();
     if (obj == nullptr) {
+      ++misses_;
       obj = std::allocator_traits<Allocator>::allocate(allocator_, 1);
+    } else {
+      ++hits_;
     }
 
     if (obj == nullptr) {
@@ -105,6 +108,33 @@ class ObjectPool {
     }
   }
 
+  /// Number of allocations served from the free list.
+  size_t hitCount() const {
+    return hits_;
+  }
+
+  /// Number of allocations that fell through to the allocator.
+  size_t missCount() const {
+    return misses_;
+  }
+
+  /// Current number of cached objects in the free list.
+  size_t freeListSize() const {
+    return freeList_.size();
+  }
+
+  /// Shrinks the free list down to at most maxToKeep cached objects,
+  /// returning the rest to the allocator. Intended to be called
+  /// periodically so a pool that grew during a burst doesn't hold on to
+  /// the memory forever once the load subsides.
+  void trim(size_t maxToKeep) {
+    while (freeList_.size() > maxToKeep) {
+      std::allocator_traits<Allocator>::deallocate(
+          allocator_, freeList_.back(), 1);
+      freeList_.pop_back();
+    }
+  }
+
  private:
   class RecacheDeleter {
    public:
@@ -193,6 +223,9 @@ class ObjectPool {
 
   // Maximum number of objects that can be stored within the pool
   const size_t maxCapacity_;
+
+  size_t hits_{0}; // Allocations served from the free list
+  size_t misses_{0}; // Allocations that went to the allocator
 };
 
 /// ThreadSafeObjectPool, as the name suggests, is a thread safe version of
@@ -234,6 +267,12 @@ class ThreadSafeObjectPool {
     return objectPool.free(obj);
   }
 
+  /// See ObjectPool::trim().
+  void trim(size_t maxToKeep) {
+    std::lock_guard<std::mutex> lg(mtx);
+    objectPool.trim(maxToKeep);
+  }
+
  private:
   ObjectPool<T, Allocator> objectPool; // Object pool used for allocations
   std::mutex mtx; // Mutex for mutual exclusion
@@ -125,3 +125,46 @@ TEST(ObjectPool, ThrowingType) {
   EXPECT_EQ(TestAllocator<TestTypeThrowing>::nAllocations, 1);
   EXPECT_EQ(TestAllocator<TestTypeThrowing>::nDeAllocations, 0);
 }
+
+TEST(ObjectPool, HitMissStats) {
+  ObjectPool<TestType> pool(4);
+
+  EXPECT_EQ(0, pool.hitCount());
+  EXPECT_EQ(0, pool.missCount());
+
+  auto* vala = pool.alloc();
+  auto* valb = pool.alloc();
+  EXPECT_EQ(0, pool.hitCount());
+  EXPECT_EQ(2, pool.missCount());
+
+  pool.free(vala);
+  pool.free(valb);
+  EXPECT_EQ(2, pool.freeListSize());
+
+  vala = pool.alloc();
+  EXPECT_EQ(1, pool.hitCount());
+  EXPECT_EQ(2, pool.missCount());
+  pool.free(vala);
+}
+
+TEST(ObjectPool, Trim) {
+  ObjectPool<TestType, TestAllocator<TestType>> pool(8);
+  auto deallocationsBefore = TestAllocator<TestType>::nDeAllocations;
+
+  TestType* objs[4];
+  for (auto& obj : objs) {
+    obj = pool.alloc();
+  }
+  for (auto* obj : objs) {
+    pool.free(obj);
+  }
+  EXPECT_EQ(4, pool.freeListSize());
+
+  pool.trim(1);
+  EXPECT_EQ(1, pool.freeListSize());
+  EXPECT_EQ(deallocationsBefore + 3, TestAllocator<TestType>::nDeAllocations);
+
+  // Trimming below the current size is a no-op.
+  pool.trim(2);
+  EXPECT_EQ(1, pool.freeListSize());
+}
@@ -89,3 +89,92 @@ TEST(counting_semaphore, nonblocking) {
 
   EXPECT_EQ(INIT, counting_sem_value(&sem));
 }
+
+static counting_sem_sharded_t sharded_sem;
+
+void consume_sharded(int id, int X) {
+  int n = X;
+  while (n > 0) {
+    unsigned m = counting_sem_sharded_lazy_wait(&sharded_sem, n);
+    n -= m;
+    VLOG(1) << "c " << id << " consumed " << m << ", remaining " << n;
+  }
+  VLOG(1) << "consumer " << id << " done";
+}
+
+void consume_sharded_nonblocking(int id, int X) {
+  int n = X;
+  while (n > 0) {
+    unsigned m = counting_sem_sharded_lazy_nonblocking(&sharded_sem, n);
+    n -= m;
+    VLOG(1) << "c " << id << " consumed " << m << ", remaining " << n;
+  }
+  VLOG(1) << "consumer " << id << " done";
+}
+
+void produce_sharded(int id, int Y) {
+  for (int i = 0; i < Y; ++i) {
+    counting_sem_sharded_post(&sharded_sem, 1);
+  }
+  VLOG(1) << "producer " << id << " done";
+}
+
+TEST(counting_semaphore_sharded, initDistribution) {
+  // Initial value is spread over shards but the total is preserved,
+  // including values smaller than the shard count.
+  for (int init : {0, 1, COUNTING_SEM_NUM_SHARDS - 1,
+                   COUNTING_SEM_NUM_SHARDS + 3, 1000}) {
+    counting_sem_sharded_init(&sharded_sem, init);
+    EXPECT_EQ(init, counting_sem_sharded_value(&sharded_sem));
+  }
+}
+
+TEST(counting_semaphore_sharded, drainAcrossShards) {
+  // A single consumer must be able to take tokens parked on any shard.
+  int INIT = 100;
+  counting_sem_sharded_init(&sharded_sem, INIT);
+  EXPECT_EQ(INIT, counting_sem_sharded_lazy_wait(&sharded_sem, INIT));
+  EXPECT_EQ(0, counting_sem_sharded_value(&sharded_sem));
+  EXPECT_EQ(0, counting_sem_sharded_lazy_nonblocking(&sharded_sem, 1));
+}
+
+TEST(counting_semaphore_sharded, basic) {
+  // Same producer/consumer stress as above, on the sharded semaphore
+  int X = 523, Y = 345, INIT = 3;
+
+  counting_sem_sharded_init(&sharded_sem, INIT);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < Y; ++i) {
+    threads.push_back(std::thread{&consume_sharded, i, X});
+  }
+  for (int i = 0; i < X; ++i) {
+    threads.push_back(std::thread{&produce_sharded, i, Y});
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(INIT, counting_sem_sharded_value(&sharded_sem));
+}
+
+TEST(counting_semaphore_sharded, nonblocking) {
+  int X = 523, Y = 345, INIT = 3;
+
+  counting_sem_sharded_init(&sharded_sem, INIT);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < X; ++i) {
+    threads.push_back(std::thread{&produce_sharded, i, Y});
+  }
+  for (int i = 0; i < Y; ++i) {
+    threads.push_back(std::thread{&consume_sharded_nonblocking, i, X});
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(INIT, counting_sem_sharded_value(&sharded_sem));
+}
@@ -7,8 +7,11 @@
  */
 #include "AccessPoint.h"
 
+#include <mutex>
+
 #include <folly/Conv.h>
 #include <folly/IPAddress.h>
+#include <folly/experimental/StringKeyedUnorderedMap.h>
 
 #include "mcrouter/lib/fbi/cpp/util.h"
 
@@ -156,6 +159,22 @@ void AccessPoint::disableCompression() {
   compressed_ = false;
 }
 
+uint32_t AccessPoint::uniqueId() const {
+  // One table for the process: ids must agree across proxy threads so
+  // they can key shared maps.  All callers run at configuration time, so
+  // serializing them on one lock is fine; the lock also makes the cached
+  // uniqueId_ safe to read from any thread.
+  static auto& table = *new folly::StringKeyedUnorderedMap<uint32_t>();
+  static auto& tableLock = *new std::mutex();
+
+  std::lock_guard<std::mutex> lock(tableLock);
+  if (uniqueId_ == 0) {
+    auto id = static_cast<uint32_t>(table.size() + 1);
+    uniqueId_ = table.emplace(toString(), id).first->second;
+  }
+  return uniqueId_;
+}
+
 std::string AccessPoint::toHostPortString() const {
   if (isV6_) {
     return folly::to<std::string>("[", host_, "]:", port_);
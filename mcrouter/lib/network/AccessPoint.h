@@ -74,6 +74,15 @@ struct AccessPoint {
     return unixDomainSocket_;
   }
 
+  /**
+   * Small process-wide integer id of this access point: equal access
+   * points (same serialized form) get equal ids, interned on first use.
+   * Lets config-time maps key on an integer instead of hashing host:port
+   * strings.  Must only be called once the access point is fully
+   * configured; later set*() calls do not re-intern.
+   */
+  uint32_t uniqueId() const;
+
   /**
    * @return [host]:port if address is IPv6, host:port otherwise
    */
@@ -90,12 +99,18 @@ struct AccessPoint {
     securityMech_ = mech;
   }
 
+  void setCompression(bool compressed) {
+    compressed_ = compressed;
+  }
+
   void setPort(uint16_t port) {
     port_ = port;
   }
 
  private:
   std::string host_;
+  // Lazily interned by uniqueId(); 0 means not interned yet.
+  mutable uint32_t uniqueId_{0};
   uint16_t port_;
   mc_protocol_t protocol_ : 8;
   SecurityMech securityMech_{SecurityMech::NONE};
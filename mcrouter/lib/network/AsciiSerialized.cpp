@@ -8,10 +8,13 @@
 
 #include "mcrouter/lib/IOBufUtil.h"
 #include "mcrouter/lib/McResUtil.h"
+#include "mcrouter/lib/network/AsciiIntegerWriter.h"
 
 namespace facebook {
 namespace memcache {
 
+using detail::writeDecimal;
+
 size_t AsciiSerializedRequest::getSize() const {
   return iovsTotalLen_;
 }
@@ -30,25 +33,38 @@ void AsciiSerializedRequest::addString(folly::StringPiece str) {
   addString(folly::ByteRange(str));
 }
 
+void AsciiSerializedRequest::addValue(folly::IOBuf& value) {
+  // The trailing "\r\n" still needs one iovec after the value.
+  if (value.isChained() &&
+      iovsCount_ + value.countChainElements() + 1 > kMaxIovs) {
+    value.coalesce();
+  }
+  for (const auto range : value) {
+    if (!range.empty()) {
+      addString(range);
+    }
+  }
+}
+
 template <class Request>
 void AsciiSerializedRequest::keyValueRequestCommon(
     folly::StringPiece prefix,
     const Request& request) {
-  auto value = coalesceAndGetRange(const_cast<folly::IOBuf&>(request.value()));
-  auto len = snprintf(
-      printBuffer_,
-      kMaxBufferLength,
-      " %lu %d %zd\r\n",
-      request.flags(),
-      request.exptime(),
-      value.size());
-  assert(len > 0 && static_cast<size_t>(len) < kMaxBufferLength);
+  auto& value = const_cast<folly::IOBuf&>(request.value());
+  char* p = printBuffer_;
+  *p++ = ' ';
+  p = writeDecimal(p, request.flags());
+  *p++ = ' ';
+  p = writeDecimal(p, request.exptime());
+  *p++ = ' ';
+  p = writeDecimal(p, value.computeChainDataLength());
+  *p++ = '\r';
+  *p++ = '\n';
+  assert(static_cast<size_t>(p - printBuffer_) < kMaxBufferLength);
   addStrings(
-      prefix,
-      request.key().fullKey(),
-      folly::StringPiece(printBuffer_, static_cast<size_t>(len)),
-      value,
-      "\r\n");
+      prefix, request.key().fullKey(), folly::StringPiece(printBuffer_, p));
+  addValue(value);
+  addString("\r\n");
 }
 
 // Get-like ops.
@@ -69,19 +85,21 @@ void AsciiSerializedRequest::prepareImpl(const McLeaseGetRequest& request) {
 }
 
 void AsciiSerializedRequest::prepareImpl(const McGatRequest& request) {
-  auto len = snprintf(printBuffer_, kMaxBufferLength, "%d ", request.exptime());
+  char* p = writeDecimal(printBuffer_, request.exptime());
+  *p++ = ' ';
   addStrings(
       "gat ",
-      folly::StringPiece(printBuffer_, static_cast<size_t>(len)),
+      folly::StringPiece(printBuffer_, p),
       request.key().fullKey(),
       "\r\n");
 }
 
 void AsciiSerializedRequest::prepareImpl(const McGatsRequest& request) {
-  auto len = snprintf(printBuffer_, kMaxBufferLength, "%d ", request.exptime());
+  char* p = writeDecimal(printBuffer_, request.exptime());
+  *p++ = ' ';
   addStrings(
       "gats ",
-      folly::StringPiece(printBuffer_, static_cast<size_t>(len)),
+      folly::StringPiece(printBuffer_, p),
       request.key().fullKey(),
       "\r\n");
 }
@@ -108,72 +126,78 @@ void AsciiSerializedRequest::prepareImpl(const McPrependRequest& request) {
 }
 
 void AsciiSerializedRequest::prepareImpl(const McCasRequest& request) {
-  auto value = coalesceAndGetRange(const_cast<folly::IOBuf&>(request.value()));
-  auto len = snprintf(
-      printBuffer_,
-      kMaxBufferLength,
-      " %lu %d %zd %lu\r\n",
-      request.flags(),
-      request.exptime(),
-      value.size(),
-      request.casToken());
-  assert(len > 0 && static_cast<size_t>(len) < kMaxBufferLength);
+  auto& value = const_cast<folly::IOBuf&>(request.value());
+  char* p = printBuffer_;
+  *p++ = ' ';
+  p = writeDecimal(p, request.flags());
+  *p++ = ' ';
+  p = writeDecimal(p, request.exptime());
+  *p++ = ' ';
+  p = writeDecimal(p, value.computeChainDataLength());
+  *p++ = ' ';
+  p = writeDecimal(p, request.casToken());
+  *p++ = '\r';
+  *p++ = '\n';
+  assert(static_cast<size_t>(p - printBuffer_) < kMaxBufferLength);
   addStrings(
-      "cas ",
-      request.key().fullKey(),
-      folly::StringPiece(printBuffer_, static_cast<size_t>(len)),
-      value,
-      "\r\n");
+      "cas ", request.key().fullKey(), folly::StringPiece(printBuffer_, p));
+  addValue(value);
+  addString("\r\n");
 }
 
 void AsciiSerializedRequest::prepareImpl(const McLeaseSetRequest& request) {
-  auto value = coalesceAndGetRange(const_cast<folly::IOBuf&>(request.value()));
-  auto len = snprintf(
-      printBuffer_,
-      kMaxBufferLength,
-      " %lu %lu %d %zd\r\n",
-      request.leaseToken(),
-      request.flags(),
-      request.exptime(),
-      value.size());
-  assert(len > 0 && static_cast<size_t>(len) < kMaxBufferLength);
+  auto& value = const_cast<folly::IOBuf&>(request.value());
+  char* p = printBuffer_;
+  *p++ = ' ';
+  p = writeDecimal(p, request.leaseToken());
+  *p++ = ' ';
+  p = writeDecimal(p, request.flags());
+  *p++ = ' ';
+  p = writeDecimal(p, request.exptime());
+  *p++ = ' ';
+  p = writeDecimal(p, value.computeChainDataLength());
+  *p++ = '\r';
+  *p++ = '\n';
+  assert(static_cast<size_t>(p - printBuffer_) < kMaxBufferLength);
   addStrings(
       "lease-set ",
       request.key().fullKey(),
-      folly::StringPiece(printBuffer_, static_cast<size_t>(len)),
-      value,
-      "\r\n");
+      folly::StringPiece(printBuffer_, p));
+  addValue(value);
+  addString("\r\n");
 }
 
 // Arithmetic ops.
 void AsciiSerializedRequest::prepareImpl(const McIncrRequest& request) {
-  auto len =
-      snprintf(printBuffer_, kMaxBufferLength, " %lu\r\n", request.delta());
-  assert(len > 0 && static_cast<size_t>(len) < kMaxBufferLength);
+  char* p = printBuffer_;
+  *p++ = ' ';
+  p = writeDecimal(p, request.delta());
+  *p++ = '\r';
+  *p++ = '\n';
   addStrings(
-      "incr ",
-      request.key().fullKey(),
-      folly::StringPiece(printBuffer_, static_cast<size_t>(len)));
+      "incr ", request.key().fullKey(), folly::StringPiece(printBuffer_, p));
 }
 
 void AsciiSerializedRequest::prepareImpl(const McDecrRequest& request) {
-  auto len =
-      snprintf(printBuffer_, kMaxBufferLength, " %lu\r\n", request.delta());
-  assert(len > 0 && static_cast<size_t>(len) < kMaxBufferLength);
+  char* p = printBuffer_;
+  *p++ = ' ';
+  p = writeDecimal(p, request.delta());
+  *p++ = '\r';
+  *p++ = '\n';
   addStrings(
-      "decr ",
-      request.key().fullKey(),
-      folly::StringPiece(printBuffer_, static_cast<size_t>(len)));
+      "decr ", request.key().fullKey(), folly::StringPiece(printBuffer_, p));
 }
 
 // Delete op.
 void AsciiSerializedRequest::prepareImpl(const McDeleteRequest& request) {
   addStrings("delete ", request.key().fullKey());
   if (request.exptime() != 0) {
-    auto len =
-        snprintf(printBuffer_, kMaxBufferLength, " %d\r\n", request.exptime());
-    assert(len > 0 && static_cast<size_t>(len) < kMaxBufferLength);
-    addString(folly::StringPiece(printBuffer_, static_cast<size_t>(len)));
+    char* p = printBuffer_;
+    *p++ = ' ';
+    p = writeDecimal(p, request.exptime());
+    *p++ = '\r';
+    *p++ = '\n';
+    addString(folly::StringPiece(printBuffer_, p));
   } else {
     addString("\r\n");
   }
@@ -181,13 +205,13 @@ void AsciiSerializedRequest::prepareImpl(const McDeleteRequest& request) {
 
 // Touch op.
 void AsciiSerializedRequest::prepareImpl(const McTouchRequest& request) {
-  auto len =
-      snprintf(printBuffer_, kMaxBufferLength, " %u\r\n", request.exptime());
-  assert(len > 0 && static_cast<size_t>(len) < kMaxBufferLength);
+  char* p = printBuffer_;
+  *p++ = ' ';
+  p = writeDecimal(p, request.exptime());
+  *p++ = '\r';
+  *p++ = '\n';
   addStrings(
-      "touch ",
-      request.key().fullKey(),
-      folly::StringPiece(printBuffer_, static_cast<size_t>(len)));
+      "touch ", request.key().fullKey(), folly::StringPiece(printBuffer_, p));
 }
 
 // Version op.
@@ -200,9 +224,10 @@ void AsciiSerializedRequest::prepareImpl(const McVersionRequest&) {
 void AsciiSerializedRequest::prepareImpl(const McFlushAllRequest& request) {
   addString("flush_all");
   if (request.delay() != 0) {
-    auto len = snprintf(printBuffer_, kMaxBufferLength, " %u", request.delay());
-    assert(len > 0 && static_cast<size_t>(len) < kMaxBufferLength);
-    addString(folly::StringPiece(printBuffer_, static_cast<size_t>(len)));
+    char* p = printBuffer_;
+    *p++ = ' ';
+    p = writeDecimal(p, request.delay());
+    addString(folly::StringPiece(printBuffer_, p));
   }
   addString("\r\n");
 }
@@ -225,6 +250,22 @@ void AsciiSerializedReply::addString(folly::StringPiece str) {
   addString(folly::ByteRange(str));
 }
 
+void AsciiSerializedReply::addValueAndCrlf() {
+  if (iobuf_.hasValue()) {
+    // The trailing "\r\n" still needs one iovec after the value.
+    if (iobuf_->isChained() &&
+        iovsCount_ + iobuf_->countChainElements() + 1 > kMaxIovs) {
+      iobuf_->coalesce();
+    }
+    for (const auto range : *iobuf_) {
+      if (!range.empty()) {
+        addString(range);
+      }
+    }
+  }
+  addString("\r\n");
+}
+
 void AsciiSerializedReply::handleError(
     mc_res_t result,
     uint16_t errorCode,
@@ -285,25 +326,23 @@ void AsciiSerializedReply::prepareImpl(
       }
       addString("END\r\n");
     } else {
-      const auto valueStr = coalesceAndGetRange(reply.value());
-
-      const auto len = snprintf(
-          printBuffer_,
-          kMaxBufferLength,
-          " %lu %zu\r\n",
-          reply.flags(),
-          valueStr.size());
-      assert(len > 0);
-      assert(static_cast<size_t>(len) < kMaxBufferLength);
-
-      addStrings(
-          "VALUE ",
-          key,
-          folly::StringPiece(printBuffer_, static_cast<size_t>(len)));
+      const size_t valueLen = reply.value().hasValue()
+          ? reply.value()->computeChainDataLength()
+          : 0;
+
+      char* p = printBuffer_;
+      *p++ = ' ';
+      p = writeDecimal(p, reply.flags());
+      *p++ = ' ';
+      p = writeDecimal(p, valueLen);
+      *p++ = '\r';
+      *p++ = '\n';
+      assert(static_cast<size_t>(p - printBuffer_) < kMaxBufferLength);
+
+      addStrings("VALUE ", key, folly::StringPiece(printBuffer_, p));
       assert(!iobuf_.hasValue());
-      // value was coalesced in coalesceAndGetRange()
       iobuf_ = std::move(reply.value());
-      addStrings(valueStr, "\r\n");
+      addValueAndCrlf();
     }
   } else if (isErrorResult(reply.result())) {
     handleError(
@@ -319,25 +358,24 @@ void AsciiSerializedReply::prepareImpl(
     McGetsReply&& reply,
     folly::StringPiece key) {
   if (isHitResult(reply.result())) {
-    const auto valueStr = coalesceAndGetRange(reply.value());
-    const auto len = snprintf(
-        printBuffer_,
-        kMaxBufferLength,
-        " %lu %zu %lu\r\n",
-        reply.flags(),
-        valueStr.size(),
-        reply.casToken());
-    assert(len > 0);
-    assert(static_cast<size_t>(len) < kMaxBufferLength);
-
-    addStrings(
-        "VALUE ",
-        key,
-        folly::StringPiece(printBuffer_, static_cast<size_t>(len)));
+    const size_t valueLen = reply.value().hasValue()
+        ? reply.value()->computeChainDataLength()
+        : 0;
+    char* p = printBuffer_;
+    *p++ = ' ';
+    p = writeDecimal(p, reply.flags());
+    *p++ = ' ';
+    p = writeDecimal(p, valueLen);
+    *p++ = ' ';
+    p = writeDecimal(p, reply.casToken());
+    *p++ = '\r';
+    *p++ = '\n';
+    assert(static_cast<size_t>(p - printBuffer_) < kMaxBufferLength);
+
+    addStrings("VALUE ", key, folly::StringPiece(printBuffer_, p));
     assert(!iobuf_.hasValue());
-    // value was coalesced in coalescedAndGetRange()
     iobuf_ = std::move(reply.value());
-    addStrings(valueStr, "\r\n");
+    addValueAndCrlf();
   } else if (isErrorResult(reply.result())) {
     handleError(
         reply.result(),
@@ -406,40 +444,37 @@ void AsciiSerializedReply::prepareImpl(
 void AsciiSerializedReply::prepareImpl(
     McLeaseGetReply&& reply,
     folly::StringPiece key) {
-  const auto valueStr = coalesceAndGetRange(reply.value());
+  const size_t valueLen = reply.value().hasValue()
+      ? reply.value()->computeChainDataLength()
+      : 0;
 
   if (reply.result() == mc_res_found) {
-    const auto len = snprintf(
-        printBuffer_,
-        kMaxBufferLength,
-        " %lu %zu\r\n",
-        reply.flags(),
-        valueStr.size());
-    assert(len > 0);
-    assert(static_cast<size_t>(len) < kMaxBufferLength);
-
-    addStrings(
-        "VALUE ",
-        key,
-        folly::StringPiece(printBuffer_, static_cast<size_t>(len)));
+    char* p = printBuffer_;
+    *p++ = ' ';
+    p = writeDecimal(p, reply.flags());
+    *p++ = ' ';
+    p = writeDecimal(p, valueLen);
+    *p++ = '\r';
+    *p++ = '\n';
+    assert(static_cast<size_t>(p - printBuffer_) < kMaxBufferLength);
+
+    addStrings("VALUE ", key, folly::StringPiece(printBuffer_, p));
     assert(!iobuf_.hasValue());
-    // value was coalesced in coalescedAndGetRange()
     iobuf_ = std::move(reply.value());
-    addStrings(valueStr, "\r\n");
+    addValueAndCrlf();
   } else if (reply.result() == mc_res_notfound) {
-    const auto len = snprintf(
-        printBuffer_,
-        kMaxBufferLength,
-        " %lu %lu %zu\r\n",
-        reply.leaseToken(),
-        reply.flags(),
-        valueStr.size());
-    addStrings(
-        "LVALUE ",
-        key,
-        folly::StringPiece(printBuffer_, static_cast<size_t>(len)));
+    char* p = printBuffer_;
+    *p++ = ' ';
+    p = writeDecimal(p, reply.leaseToken());
+    *p++ = ' ';
+    p = writeDecimal(p, reply.flags());
+    *p++ = ' ';
+    p = writeDecimal(p, valueLen);
+    *p++ = '\r';
+    *p++ = '\n';
+    addStrings("LVALUE ", key, folly::StringPiece(printBuffer_, p));
     iobuf_ = std::move(reply.value());
-    addStrings(valueStr, "\r\n");
+    addValueAndCrlf();
   } else if (reply.result() == mc_res_notfoundhot) {
     addString("NOT_FOUND_HOT\r\n");
   } else if (isErrorResult(reply.result())) {
@@ -468,25 +503,23 @@ void AsciiSerializedReply::prepareImpl(
       }
       addString("END\r\n");
     } else {
-      const auto valueStr = coalesceAndGetRange(reply.value());
-
-      const auto len = snprintf(
-          printBuffer_,
-          kMaxBufferLength,
-          " %lu %zu\r\n",
-          reply.flags(),
-          valueStr.size());
-      assert(len > 0);
-      assert(static_cast<size_t>(len) < kMaxBufferLength);
-
-      addStrings(
-          "VALUE ",
-          key,
-          folly::StringPiece(printBuffer_, static_cast<size_t>(len)));
+      const size_t valueLen = reply.value().hasValue()
+          ? reply.value()->computeChainDataLength()
+          : 0;
+
+      char* p = printBuffer_;
+      *p++ = ' ';
+      p = writeDecimal(p, reply.flags());
+      *p++ = ' ';
+      p = writeDecimal(p, valueLen);
+      *p++ = '\r';
+      *p++ = '\n';
+      assert(static_cast<size_t>(p - printBuffer_) < kMaxBufferLength);
+
+      addStrings("VALUE ", key, folly::StringPiece(printBuffer_, p));
       assert(!iobuf_.hasValue());
-      // value was coalesced in coalesceAndGetRange()
       iobuf_ = std::move(reply.value());
-      addStrings(valueStr, "\r\n");
+      addValueAndCrlf();
     }
   } else if (isErrorResult(reply.result())) {
     handleError(
@@ -502,25 +535,24 @@ void AsciiSerializedReply::prepareImpl(
     McGatsReply&& reply,
     folly::StringPiece key) {
   if (isHitResult(reply.result())) {
-    const auto valueStr = coalesceAndGetRange(reply.value());
-    const auto len = snprintf(
-        printBuffer_,
-        kMaxBufferLength,
-        " %lu %zu %lu\r\n",
-        reply.flags(),
-        valueStr.size(),
-        reply.casToken());
-    assert(len > 0);
-    assert(static_cast<size_t>(len) < kMaxBufferLength);
-
-    addStrings(
-        "VALUE ",
-        key,
-        folly::StringPiece(printBuffer_, static_cast<size_t>(len)));
+    const size_t valueLen = reply.value().hasValue()
+        ? reply.value()->computeChainDataLength()
+        : 0;
+    char* p = printBuffer_;
+    *p++ = ' ';
+    p = writeDecimal(p, reply.flags());
+    *p++ = ' ';
+    p = writeDecimal(p, valueLen);
+    *p++ = ' ';
+    p = writeDecimal(p, reply.casToken());
+    *p++ = '\r';
+    *p++ = '\n';
+    assert(static_cast<size_t>(p - printBuffer_) < kMaxBufferLength);
+
+    addStrings("VALUE ", key, folly::StringPiece(printBuffer_, p));
     assert(!iobuf_.hasValue());
-    // value was coalesced in coalescedAndGetRange()
     iobuf_ = std::move(reply.value());
-    addStrings(valueStr, "\r\n");
+    addValueAndCrlf();
   } else if (isErrorResult(reply.result())) {
     handleError(
         reply.result(),
@@ -626,10 +658,10 @@ void AsciiSerializedReply::prepareArithmeticLike(
     std::string&& message,
     const char* requestName) {
   if (isStoredResult(result)) {
-    const auto len = snprintf(printBuffer_, kMaxBufferLength, "%lu\r\n", delta);
-    assert(len > 0);
-    assert(static_cast<size_t>(len) < kMaxBufferLength);
-    addString(folly::StringPiece(printBuffer_, static_cast<size_t>(len)));
+    char* p = writeDecimal(printBuffer_, delta);
+    *p++ = '\r';
+    *p++ = '\n';
+    addString(folly::StringPiece(printBuffer_, p));
   } else if (isMissResult(result)) {
     addString("NOT_FOUND\r\n");
   } else if (isErrorResult(result)) {
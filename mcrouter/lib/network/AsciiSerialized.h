@@ -50,7 +50,8 @@ class AsciiSerializedRequest {
  private:
   // We need at most 5 iovecs (lease-set):
   //   command + key + printBuffer + value + "\r\n"
-  static constexpr size_t kMaxIovs = 8;
+  // plus room for a chained value to be emitted segment by segment.
+  static constexpr size_t kMaxIovs = 16;
   // The longest print buffer we need is for lease-set/cas operations.
   // It requires 2 uint64, 2 uint32 + 4 spaces + "\r\n" + '\0' = 67 chars.
   static constexpr size_t kMaxBufferLength = 80;
@@ -63,6 +64,14 @@ class AsciiSerializedRequest {
   void addString(folly::ByteRange range);
   void addString(folly::StringPiece str);
 
+  /**
+   * Adds the value, emitting one iovec per chain segment so that values
+   * chained by the parser (e.g. when a request spanned reads) go to the
+   * wire without being copied. Coalesces only if the chain does not fit
+   * in the remaining iovecs.
+   */
+  void addValue(folly::IOBuf& value);
+
   template <class Arg1, class Arg2>
   void addStrings(Arg1&& arg1, Arg2&& arg2);
   template <class Arg, class... Args>
@@ -173,6 +182,13 @@ class AsciiSerializedReply {
   void addString(folly::ByteRange range);
   void addString(folly::StringPiece str);
 
+  /**
+   * Adds the value owned by iobuf_, one iovec per chain segment, followed
+   * by the trailing "\r\n". Coalesces only if the chain does not fit in
+   * the remaining iovecs.
+   */
+  void addValueAndCrlf();
+
   template <class Arg1, class Arg2>
   void addStrings(Arg1&& arg1, Arg2&& arg2);
   template <class Arg, class... Args>
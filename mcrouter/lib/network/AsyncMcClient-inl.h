@@ -39,14 +39,19 @@ template <class Request>
 ReplyT<Request> AsyncMcClient::sendSync(
     const Request& request,
     std::chrono::milliseconds timeout,
-    RpcStatsContext* rpcContext) {
-  return base_->sendSync(request, timeout, rpcContext);
+    RpcStatsContext* rpcContext,
+    SerializedRequestBodyCache* bodyCache) {
+  return base_->sendSync(request, timeout, rpcContext, bodyCache);
 }
 
 inline void AsyncMcClient::setThrottle(size_t maxInflight, size_t maxPending) {
   base_->setThrottle(maxInflight, maxPending);
 }
 
+inline void AsyncMcClient::disableCompression() {
+  base_->disableCompression();
+}
+
 inline size_t AsyncMcClient::getPendingRequestCount() const {
   return base_->getPendingRequestCount();
 }
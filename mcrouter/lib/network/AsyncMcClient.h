@@ -101,12 +101,15 @@ class AsyncMcClient {
    * @param rpcContext    Output argument that can be used to return information
    *                      about the reply received. If nullptr, it will be
    *                      ignored (i.e. no information is going be sent back up)
+   * @param bodyCache     Optional serialized-body cache shared across resends
+   *                      of the same request; see SerializedRequestBodyCache.
    */
   template <class Request>
   ReplyT<Request> sendSync(
       const Request& request,
       std::chrono::milliseconds timeout,
-      RpcStatsContext* rpcContext = nullptr);
+      RpcStatsContext* rpcContext = nullptr,
+      SerializedRequestBodyCache* bodyCache = nullptr);
 
   /**
    * Set throttling options.
@@ -128,6 +131,14 @@ class AsyncMcClient {
    */
   void setThrottle(size_t maxInflight, size_t maxPending);
 
+  /**
+   * Stop advertising compression codecs to the server. Codecs are
+   * advertised per request, so this takes effect with the next request
+   * sent; replies to requests already serialized may still arrive
+   * compressed. There is no way to re-enable compression on this client.
+   */
+  void disableCompression();
+
   /**
    * Get the number of requests in pending queue. Those requests have not been
    * sent to the network yet, this means that in case of remote error we can
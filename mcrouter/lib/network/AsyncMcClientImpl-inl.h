@@ -15,7 +15,8 @@ template <class Request>
 ReplyT<Request> AsyncMcClientImpl::sendSync(
     const Request& request,
     std::chrono::milliseconds timeout,
-    RpcStatsContext* rpcContext) {
+    RpcStatsContext* rpcContext,
+    SerializedRequestBodyCache* bodyCache) {
   DestructorGuard dg(this);
 
   assert(folly::fibers::onFiber());
@@ -41,7 +42,9 @@ ReplyT<Request> AsyncMcClientImpl::sendSync(
       [](ParserT& parser) { parser.expectNext<Request>(); },
       requestStatusCallbacks_.onStateChange,
       supportedCompressionCodecs_,
-      connectionOptions_.payloadFormat);
+      connectionOptions_.payloadFormat,
+      connectionOptions_.tcpZeroCopyThresholdBytes,
+      bodyCache);
   sendCommon(ctx);
 
   // Wait for the reply.
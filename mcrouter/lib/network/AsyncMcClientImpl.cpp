@@ -10,6 +10,8 @@
 
 #include <memory>
 
+#include <folly/Hash.h>
+#include <folly/Random.h>
 #include <folly/SingletonThreadLocal.h>
 #include <folly/container/EvictingCacheMap.h>
 #include <folly/io/async/AsyncSSLSocket.h>
@@ -17,6 +19,7 @@
 
 #include "mcrouter/lib/debug/FifoManager.h"
 #include "mcrouter/lib/fbi/cpp/LogFailure.h"
+#include "mcrouter/lib/network/DnsResolutionCache.h"
 #include "mcrouter/lib/network/McFizzClient.h"
 #include "mcrouter/lib/network/McSSLUtil.h"
 #include "mcrouter/lib/network/SocketConnector.h"
@@ -26,7 +29,12 @@ namespace facebook {
 namespace memcache {
 
 constexpr size_t kReadBufferSizeMin = 256;
-constexpr size_t kReadBufferSizeMax = 4096;
+/* Large enough that read-ahead for a deep pipeline of small replies fits
+   in one read; only materialized when the adapted size or hint asks. */
+constexpr size_t kReadBufferSizeMax = 16384;
+/* Rough size of a small (e.g. miss or hit-with-short-value) reply, used
+   to size read-ahead from the number of replies outstanding. */
+constexpr size_t kReadAheadBytesPerReply = 128;
 constexpr size_t kStackIovecs = 128;
 constexpr size_t kMaxBatchSize = 24576 /* 24KB */;
 
@@ -91,6 +99,16 @@ void AsyncMcClientImpl::WriterLoop::runLoopCallback() noexcept {
     client_.eventBase_.runInLoop(this, /* thisIteration */ true);
     return;
   }
+  if (client_.shouldDelayFlush()) {
+    // Adaptive batching: keep waiting (up to the configured bound) while
+    // the pending queue is still growing, to build a larger writev batch.
+    if (client_.flushList_) {
+      client_.flushList_->push_back(*this);
+    } else {
+      client_.eventBase_.runInLoop(this, /* thisIteration */ true);
+    }
+    return;
+  }
   rescheduled_ = false;
   client_.pushMessages();
 }
@@ -111,6 +129,14 @@ AsyncMcClientImpl::AsyncMcClientImpl(
     supportedCompressionCodecs_ =
         connectionOptions_.compressionCodecMap->getIdRange();
   }
+  if (connectionOptions_.writeFlushAlign &&
+      connectionOptions_.writeFlushDelay.count() > 0) {
+    // All connections to the same box hash to the same phase, in every
+    // proxy thread of this process.
+    flushPhaseUs_ =
+        folly::Hash()(connectionOptions_.accessPoint->getHost()) %
+        connectionOptions_.writeFlushDelay.count();
+  }
 }
 
 std::shared_ptr<AsyncMcClientImpl> AsyncMcClientImpl::create(
@@ -182,6 +208,10 @@ void AsyncMcClientImpl::setThrottle(size_t maxInflight, size_t maxPending) {
   maxPending_ = maxPending;
 }
 
+void AsyncMcClientImpl::disableCompression() {
+  supportedCompressionCodecs_ = CodecIdRange::Empty;
+}
+
 void AsyncMcClientImpl::sendCommon(McClientRequestContextBase& req) {
   switch (req.reqContext.serializationResult()) {
     case McSerializedRequest::Result::OK:
@@ -211,9 +241,20 @@ size_t AsyncMcClientImpl::getNumToSend() const {
       numToSend = std::min(numToSend, maxInflight_ - getInflightRequestCount());
     }
   }
+  if (numToSend != 0 && inflightBytesLimitReached()) {
+    numToSend = 0;
+  }
   return numToSend;
 }
 
+bool AsyncMcClientImpl::inflightBytesLimitReached() const {
+  // The window can only be full while requests are inflight, so replies
+  // always drain it and a request larger than the whole window is still
+  // sent once the connection is idle.
+  const auto limit = connectionOptions_.maxInflightBytes;
+  return limit != 0 && queue_.getInflightRequestBytes() >= limit;
+}
+
 void AsyncMcClientImpl::scheduleNextWriterLoop() {
   if (connectionState_ == ConnectionState::UP &&
       !writer_.isLoopCallbackScheduled() &&
@@ -230,10 +271,63 @@ void AsyncMcClientImpl::cancelWriterCallback() {
   writer_.cancelLoopCallback();
 }
 
+bool AsyncMcClientImpl::shouldDelayFlush() noexcept {
+  if (connectionState_ != ConnectionState::UP) {
+    return false;
+  }
+  const int64_t nowUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch())
+                            .count();
+  const int64_t jitterUs = connectionOptions_.writeFlushJitter.count();
+  if (jitterUs > 0) {
+    // Jittered mode: hold the flush for a random fraction of the window,
+    // so that clients of the same hot box don't all release their writes
+    // at the same instant (incast at the destination's switch port).
+    if (flushDeadlineUs_ == 0) {
+      flushDeadlineUs_ = nowUs + folly::Random::rand64(1, jitterUs + 1);
+      return true;
+    }
+    return nowUs < flushDeadlineUs_;
+  }
+  const auto maxDelay = connectionOptions_.writeFlushDelay;
+  if (maxDelay.count() == 0) {
+    return false;
+  }
+  const auto pending = getNumToSend();
+  if (connectionOptions_.writeFlushAlign) {
+    // Aligned mode: hold every flush to the next tick of the host's
+    // grid, regardless of queue growth, so that proxy threads writing to
+    // the same box flush together.
+    if (flushDeadlineUs_ == 0) {
+      const int64_t period = maxDelay.count();
+      flushDeadlineUs_ =
+          ((nowUs - flushPhaseUs_) / period + 1) * period + flushPhaseUs_;
+    }
+    return nowUs < flushDeadlineUs_;
+  }
+  if (flushDeadlineUs_ == 0) {
+    if (pending < 2) {
+      // Not enough traffic to justify gambling on a batch.
+      return false;
+    }
+    flushDeadlineUs_ = nowUs + maxDelay.count();
+    flushLastPending_ = pending;
+    return true;
+  }
+  if (nowUs >= flushDeadlineUs_ || pending <= flushLastPending_) {
+    // Hard latency bound hit, or the queue stopped growing.
+    return false;
+  }
+  flushLastPending_ = pending;
+  return true;
+}
+
 void AsyncMcClientImpl::pushMessages() {
   DestructorGuard dg(this);
 
   assert(connectionState_ == ConnectionState::UP);
+  flushDeadlineUs_ = 0;
+  flushLastPending_ = 0;
   auto numToSend = getNumToSend();
   // Call batch status callback
   if (requestStatusCallbacks_.onWrite && numToSend > 0) {
@@ -259,11 +353,44 @@ void AsyncMcClientImpl::pushMessages() {
     return connectionState_ == ConnectionState::UP;
   };
 
+  const bool zeroCopyEnabled = connectionOptions_.tcpZeroCopyThresholdBytes > 0;
+  auto sendAloneFun = [this, zeroCopyEnabled](
+                          McClientRequestContextBase& req,
+                          const struct iovec* iov,
+                          size_t iovCnt,
+                          bool last) {
+    req.isBatchTail = true;
+    if (zeroCopyEnabled && req.reqContext.shouldApplyZeroCopy()) {
+      // The chain shares ownership of the serialized buffers, so the pages
+      // the kernel references stay alive until the write completes even if
+      // the request times out and its context is destroyed.
+      socket_->writeChain(
+          this,
+          req.reqContext.createOwnedIOBufChain(),
+          last ? folly::WriteFlags::WRITE_MSG_ZEROCOPY
+               : folly::WriteFlags::WRITE_MSG_ZEROCOPY |
+                   folly::WriteFlags::CORK);
+    } else {
+      socket_->writev(
+          this,
+          iov,
+          iovCnt,
+          last ? folly::WriteFlags::NONE : folly::WriteFlags::CORK);
+    }
+    return connectionState_ == ConnectionState::UP;
+  };
+
   while (getPendingRequestCount() != 0 && numToSend > 0 &&
          /* we might be already not UP, because of failed writev */
          connectionState_ == ConnectionState::UP) {
     auto& req = queue_.peekNextPending();
 
+    if (numToSend > 1 && inflightBytesLimitReached()) {
+      // The byte window filled up mid-batch. Make this request the last one
+      // of this run, so the batch accumulated so far gets flushed.
+      numToSend = 1;
+    }
+
     auto iov = req.reqContext.getIovs();
     auto iovcnt = req.reqContext.getIovsCount();
     if (debugFifo_.isConnected()) {
@@ -284,7 +411,7 @@ void AsyncMcClientImpl::pushMessages() {
       // Req is either too big to batch or it's the last one, so just send it
       // alone.
       queue_.markNextAsSending();
-      sendBatchFun(&req, iov, iovcnt, numToSend == 1);
+      sendAloneFun(req, iov, iovcnt, numToSend == 1);
     } else {
       auto size = calculateIovecsTotalSize(iov, iovcnt);
 
@@ -301,7 +428,7 @@ void AsyncMcClientImpl::pushMessages() {
       if (size >= kMaxBatchSize || (iovsUsed == 0 && numToSend == 1)) {
         // Req is either too big to batch or it's the last one, so just send it
         // alone.
-        sendBatchFun(&req, iov, iovcnt, numToSend == 1);
+        sendAloneFun(req, iov, iovcnt, numToSend == 1);
       } else {
         memcpy(iovecs.data() + iovsUsed, iov, sizeof(struct iovec) * iovcnt);
         iovsUsed += iovcnt;
@@ -485,6 +612,15 @@ folly::AsyncSocket::OptionMap createSocketOptions(
         connectionOptions.qosPath);
   }
 
+#ifdef SO_MAX_PACING_RATE
+  if (connectionOptions.maxPacingRateBytesPerSec > 0) {
+    folly::AsyncSocket::OptionMap::key_type key;
+    key.level = SOL_SOCKET;
+    key.optname = SO_MAX_PACING_RATE;
+    options[key] = connectionOptions.maxPacingRateBytesPerSec;
+  }
+#endif // SO_MAX_PACING_RATE
+
   return options;
 }
 } // anonymous namespace
@@ -493,7 +629,11 @@ folly::AsyncTransportWrapper::UniquePtr AsyncMcClientImpl::createTransport() {
   const auto mech = connectionOptions_.accessPoint->getSecurityMech();
   folly::AsyncTransportWrapper::UniquePtr result;
   if (mech == SecurityMech::NONE) {
-    result.reset(new folly::AsyncSocket(&eventBase_));
+    auto* asyncSock = new folly::AsyncSocket(&eventBase_);
+    if (connectionOptions_.tcpZeroCopyThresholdBytes > 0) {
+      asyncSock->setZeroCopy(true);
+    }
+    result.reset(asyncSock);
     return result;
   }
   // creating a secure transport - make sure it isn't over a unix domain sock
@@ -577,10 +717,22 @@ void AsyncMcClientImpl::attemptConnection() {
       if (connectionOptions_.accessPoint->isUnixDomainSocket()) {
         address.setFromPath(connectionOptions_.accessPoint->getHost());
       } else {
-        address = folly::SocketAddress(
-            connectionOptions_.accessPoint->getHost(),
-            connectionOptions_.accessPoint->getPort(),
-            /* allowNameLookup */ true);
+        const auto& host = connectionOptions_.accessPoint->getHost();
+        folly::Optional<folly::IPAddress> cachedAddress;
+        if (auto dnsCache = DnsResolutionCacheSingleton::try_get_fast()) {
+          cachedAddress = dnsCache->lookup(host);
+        }
+        if (cachedAddress) {
+          // Resolved in the background; no blocking getaddrinfo call on
+          // this thread.
+          address = folly::SocketAddress(
+              *cachedAddress, connectionOptions_.accessPoint->getPort());
+        } else {
+          address = folly::SocketAddress(
+              host,
+              connectionOptions_.accessPoint->getPort(),
+              /* allowNameLookup */ true);
+        }
       }
     } catch (const std::system_error& e) {
       LOG_FAILURE(
@@ -825,6 +977,10 @@ void AsyncMcClientImpl::processShutdown(folly::StringPiece errorMessage) {
 }
 
 void AsyncMcClientImpl::getReadBuffer(void** bufReturn, size_t* lenReturn) {
+  /* With many replies outstanding, ask the parser for enough room that a
+     batched burst lands in one read instead of one read per buffer. */
+  parser_->setReadAheadHint(
+      getInflightRequestCount() * kReadAheadBytesPerReply);
   curBuffer_ = parser_->getReadBuffer();
   *bufReturn = curBuffer_.first;
   *lenReturn = curBuffer_.second;
@@ -74,10 +74,13 @@ class AsyncMcClientImpl : public folly::DelayedDestruction,
   ReplyT<Request> sendSync(
       const Request& request,
       std::chrono::milliseconds timeout,
-      RpcStatsContext* rpcContext);
+      RpcStatsContext* rpcContext,
+      SerializedRequestBodyCache* bodyCache = nullptr);
 
   void setThrottle(size_t maxInflight, size_t maxPending);
 
+  void disableCompression();
+
   size_t getPendingRequestCount() const;
   size_t getInflightRequestCount() const;
 
@@ -164,6 +167,12 @@ class AsyncMcClientImpl : public folly::DelayedDestruction,
   } writer_;
   FlushList* flushList_{nullptr};
 
+  // Adaptive flush batching state (see shouldDelayFlush()).
+  int64_t flushDeadlineUs_{0};
+  size_t flushLastPending_{0};
+  // Phase of the destination host's flush grid (writeFlushAlign mode).
+  int64_t flushPhaseUs_{0};
+
   // Retransmission values
   uint32_t lastRetrans_{0}; // last known value of the no. of retransmissions
   uint64_t lastKBytes_{0}; // last known number of kBs sent
@@ -193,10 +202,16 @@ class AsyncMcClientImpl : public folly::DelayedDestruction,
   // Write some requests from sendQueue_ to the socket, until max inflight limit
   // is reached or queue is empty.
   void pushMessages();
+  // @return true if the flush should be delayed to accumulate a larger
+  // batch (see ConnectionOptions::writeFlushDelay).
+  bool shouldDelayFlush() noexcept;
   // Schedule next writer loop if it's not scheduled.
   void scheduleNextWriterLoop();
   void cancelWriterCallback();
   size_t getNumToSend() const;
+  // @return true if ConnectionOptions::maxInflightBytes is set and the
+  // inflight byte window is full, i.e. no new requests should be written.
+  bool inflightBytesLimitReached() const;
 
   void attemptConnection();
 
@@ -6,14 +6,17 @@
  */
 #include "AsyncMcServer.h"
 
+#include <netinet/tcp.h>
 #include <signal.h>
 #include <sys/resource.h>
 #include <sys/time.h>
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <cstdio>
 #include <future>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -23,6 +26,7 @@
 #include <folly/IPAddress.h>
 #include <folly/SharedMutex.h>
 #include <folly/String.h>
+#include <folly/net/NetOps.h>
 #include <folly/io/async/AsyncServerSocket.h>
 #include <folly/io/async/EventBase.h>
 #include <folly/io/async/SSLContext.h>
@@ -284,24 +288,17 @@ class McServerThread {
     void connectionAccepted(
         int fd,
         const folly::SocketAddress& /* clientAddr */) noexcept final {
-      if (secure_) {
-        const auto& server = mcServerThread_->server_;
-        auto& opts = server.opts_;
-        auto contextPair = getServerContexts(
-            opts.pemCertPath,
-            opts.pemKeyPath,
-            opts.pemCaPath,
-            opts.sslRequirePeerCerts,
-            server.getTicketKeySeeds());
-
-        if (contextPair.first) {
-          mcServerThread_->worker_.addSecureClientSocket(
-              fd, std::move(contextPair));
-        } else {
-          ::close(fd);
-        }
+      auto* target = mcServerThread_;
+      if (target->server_.opts_.loadAwareAcceptSteering) {
+        target = target->pickTargetThread();
+      }
+      target->pendingAccepts_.fetch_add(1, std::memory_order_relaxed);
+      if (target == mcServerThread_) {
+        target->acceptConnection(fd, secure_);
       } else {
-        mcServerThread_->worker_.addClientSocket(fd);
+        target->evb_->runInEventBaseThread([target, fd, secure = secure_]() {
+          target->acceptConnection(fd, secure);
+        });
       }
     }
     void acceptError(const std::exception& ex) noexcept final {
@@ -323,6 +320,13 @@ class McServerThread {
   bool reusePort_{false};
   std::thread thread_;
 
+  /**
+   * Connections steered to this thread but not yet handed to its worker.
+   * Bumped on the accepting thread, drained on this thread's EventBase;
+   * lets pickTargetThread() see placements that are still in flight.
+   */
+  std::atomic<size_t> pendingAccepts_{0};
+
   folly::AsyncServerSocket::UniquePtr socket_;
   folly::AsyncServerSocket::UniquePtr sslSocket_;
   std::vector<folly::Executor::KeepAlive<folly::EventBase>> acceptorsKeepAlive_;
@@ -330,6 +334,51 @@ class McServerThread {
 
   AsyncMcServer::LoopFn fn_;
 
+  /**
+   * Hands a newly accepted connection to this thread's worker.
+   * Must run on this thread's EventBase.
+   */
+  void acceptConnection(int fd, bool secure) {
+    pendingAccepts_.fetch_sub(1, std::memory_order_relaxed);
+    if (secure) {
+      const auto& server = server_;
+      auto& opts = server.opts_;
+      auto contextPair = getServerContexts(
+          opts.pemCertPath,
+          opts.pemKeyPath,
+          opts.pemCaPath,
+          opts.sslRequirePeerCerts,
+          server.getTicketKeySeeds());
+
+      if (contextPair.first) {
+        worker_.addSecureClientSocket(fd, std::move(contextPair));
+      } else {
+        ::close(fd);
+      }
+    } else {
+      worker_.addClientSocket(fd);
+    }
+  }
+
+  /**
+   * Picks the thread with the fewest open plus in-flight connections.
+   * Counters are read with relaxed atomics, so the answer may be slightly
+   * stale; that only costs an occasional suboptimal placement.
+   */
+  McServerThread* pickTargetThread() {
+    McServerThread* best = this;
+    size_t bestConns = std::numeric_limits<size_t>::max();
+    for (auto& t : server_.threads_) {
+      const size_t conns = t->worker_.numConnections() +
+          t->pendingAccepts_.load(std::memory_order_relaxed);
+      if (conns < bestConns) {
+        bestConns = conns;
+        best = t.get();
+      }
+    }
+    return best;
+  }
+
   /**
    * Start accepting new connections.
    *
@@ -421,6 +470,16 @@ class McServerThread {
 
     if (socket_) {
       socket_->listen(server_.opts_.tcpListenBacklog);
+      if (opts.tcpDeferAcceptTimeout > 0 && opts.unixDomainSockPath.empty()) {
+        const int timeout = opts.tcpDeferAcceptTimeout;
+        for (auto s : socket_->getNetworkSockets()) {
+          if (folly::netops::setsockopt(
+                  s, IPPROTO_TCP, TCP_DEFER_ACCEPT, &timeout, sizeof(timeout)) !=
+              0) {
+            PLOG(WARNING) << "Failed to set TCP_DEFER_ACCEPT";
+          }
+        }
+      }
       socket_->startAccepting();
       socket_->attachEventBase(evb_.get());
     }
@@ -435,16 +494,41 @@ class McServerThread {
       sslSocket_->attachEventBase(evb_.get());
     }
 
-    for (auto& t : server_.threads_) {
+    if (opts.perWorkerListeningSockets) {
+      // Every worker accepts exclusively from its own SO_REUSEPORT socket;
+      // the kernel spreads incoming connections across the listeners, so
+      // accepted fds never leave this thread.
+      if (socket_ != nullptr) {
+        socket_->addAcceptCallback(&acceptCallback_, evb_.get());
+      }
+      if (sslSocket_ != nullptr) {
+        sslSocket_->addAcceptCallback(&sslAcceptCallback_, evb_.get());
+      }
+    } else if (opts.loadAwareAcceptSteering) {
+      // A single accept callback on this thread steers each connection to
+      // the least-loaded worker, instead of letting AsyncServerSocket hand
+      // connections out round-robin across per-worker callbacks.
       if (socket_ != nullptr) {
-        socket_->addAcceptCallback(&t->acceptCallback_, t->evb_.get());
+        socket_->addAcceptCallback(&acceptCallback_, evb_.get());
       }
       if (sslSocket_ != nullptr) {
-        sslSocket_->addAcceptCallback(&t->sslAcceptCallback_, t->evb_.get());
+        sslSocket_->addAcceptCallback(&sslAcceptCallback_, evb_.get());
       }
-      if (socket_ != nullptr || sslSocket_ != nullptr || t.get() != this) {
+      for (auto& t : server_.threads_) {
         acceptorsKeepAlive_.emplace_back(getKeepAliveToken(t->evb_.get()));
       }
+    } else {
+      for (auto& t : server_.threads_) {
+        if (socket_ != nullptr) {
+          socket_->addAcceptCallback(&t->acceptCallback_, t->evb_.get());
+        }
+        if (sslSocket_ != nullptr) {
+          sslSocket_->addAcceptCallback(&t->sslAcceptCallback_, t->evb_.get());
+        }
+        if (socket_ != nullptr || sslSocket_ != nullptr || t.get() != this) {
+          acceptorsKeepAlive_.emplace_back(getKeepAliveToken(t->evb_.get()));
+        }
+      }
     }
   }
 };
@@ -570,6 +654,15 @@ AsyncMcServer::AsyncMcServer(Options opts) : opts_(std::move(opts)) {
         opts_.numListeningSockets));
   }
 
+  if (opts_.perWorkerListeningSockets &&
+      opts_.numListeningSockets != opts_.numThreads) {
+    throw std::invalid_argument(folly::sformat(
+        "perWorkerListeningSockets requires numListeningSockets ({}) == "
+        "numThreads ({})",
+        opts_.numListeningSockets,
+        opts_.numThreads));
+  }
+
   threadsSpawnController_ = std::make_unique<McServerThreadSpawnController>(
       opts_.numListeningSockets);
   size_t id;
@@ -579,7 +672,7 @@ AsyncMcServer::AsyncMcServer(Options opts) : opts_(std::move(opts)) {
         McServerThread::Acceptor,
         *this,
         /*id*/ id,
-        (opts_.numListeningSockets > 1)));
+        (opts_.numListeningSockets > 1 || opts_.perWorkerListeningSockets)));
   }
   // Now the rest
   for (; id < opts_.numThreads; ++id) {
@@ -66,6 +66,25 @@ class AsyncMcServer {
      */
     int tcpListenBacklog{SOMAXCONN};
 
+    /**
+     * TCP_DEFER_ACCEPT timeout in seconds for plain-text listen sockets.
+     * When > 0, the kernel only wakes the acceptor thread once the first
+     * request bytes have arrived, saving one epoll wakeup plus the
+     * associated read syscall returning EAGAIN per accepted connection.
+     * 0 leaves the socket option untouched.
+     */
+    int tcpDeferAcceptTimeout{0};
+
+    /**
+     * If enabled, each accepted connection is handed to the worker with
+     * the fewest open connections, instead of AsyncServerSocket's strict
+     * round-robin.  Long-lived clients close unevenly over time, so
+     * round-robin placement slowly drifts into per-worker imbalance.
+     * Steering happens at accept time only; established sessions are
+     * never migrated between workers.
+     */
+    bool loadAwareAcceptSteering{false};
+
     /**
      * The list of addresses to listen on.
      * If this is used, existingSocketFd must be unset (-1).
@@ -120,6 +139,16 @@ class AsyncMcServer {
      */
     size_t numListeningSockets{1};
 
+    /**
+     * If enabled, every worker thread owns its own SO_REUSEPORT listen
+     * socket and accepts exclusively from it, letting the kernel spread
+     * incoming connections across the listeners.  Accepted fds never cross
+     * threads, which removes the single accept queue bottleneck during
+     * mass reconnects.  Requires numListeningSockets == numThreads and
+     * takes precedence over loadAwareAcceptSteering.
+     */
+    bool perWorkerListeningSockets{false};
+
     /**
      * Worker-specific options
      */
@@ -20,10 +20,30 @@
 namespace facebook {
 namespace memcache {
 
+namespace {
+// One idle generation tick per second; see ConnectionTracker.
+constexpr uint32_t kIdleGenerationTickMs = 1000;
+} // anonymous namespace
+
 AsyncMcServerWorker::AsyncMcServerWorker(
     AsyncMcServerWorkerOptions opts,
     folly::EventBase& eventBase)
-    : opts_(std::move(opts)), eventBase_(eventBase), tracker_(opts_.maxConns) {}
+    : opts_(std::move(opts)),
+      eventBase_(eventBase),
+      tracker_(opts_.maxConns, opts_.connectionIdleTimeout.count()) {
+  // Recency tracking is generation based (see ConnectionTracker): the
+  // tick below is the only timer involved, regardless of how many
+  // sessions this worker carries. No timer at all if neither eviction
+  // nor idle closing is enabled.
+  if (opts_.maxConns != 0 || opts_.connectionIdleTimeout.count() != 0) {
+    idleGenerationTimer_ =
+        folly::AsyncTimeout::make(eventBase_, [this]() noexcept {
+          tracker_.advanceGeneration();
+          idleGenerationTimer_->scheduleTimeout(kIdleGenerationTickMs);
+        });
+    idleGenerationTimer_->scheduleTimeout(kIdleGenerationTickMs);
+  }
+}
 
 bool AsyncMcServerWorker::addSecureClientSocket(
     int fd,
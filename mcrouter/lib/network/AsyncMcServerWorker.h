@@ -12,6 +12,7 @@
 
 #include <folly/Optional.h>
 #include <folly/io/async/AsyncSocket.h>
+#include <folly/io/async/AsyncTimeout.h>
 #include <folly/io/async/AsyncTransport.h>
 
 #include "mcrouter/lib/network/AsyncMcServerWorkerOptions.h"
@@ -197,6 +198,14 @@ class AsyncMcServerWorker {
    */
   bool writesPending() const;
 
+  /**
+   * Number of open connections handled by this worker.
+   * Safe to call from any thread.
+   */
+  size_t numConnections() const {
+    return tracker_.numConnections();
+  }
+
  private:
   bool addClientSocket(
       folly::AsyncTransportWrapper::UniquePtr socket,
@@ -214,6 +223,10 @@ class AsyncMcServerWorker {
   /* Open sessions and closing sessions that still have pending writes */
   ConnectionTracker tracker_;
 
+  /* Drives ConnectionTracker::advanceGeneration once per second; only
+     created when eviction or idle closing is enabled */
+  std::unique_ptr<folly::AsyncTimeout> idleGenerationTimer_;
+
   AsyncMcServerWorker(const AsyncMcServerWorker&) = delete;
   AsyncMcServerWorker& operator=(const AsyncMcServerWorker&) = delete;
 
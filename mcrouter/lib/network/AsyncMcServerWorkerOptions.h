@@ -62,11 +62,46 @@ struct AsyncMcServerWorkerOptions {
    */
   size_t maxInFlight{0};
 
+  /**
+   * Maximum number of unreplied request bytes allowed before we stop
+   * reading from client sockets. Unlike maxInFlight, this weighs each
+   * request by its size, so a handful of multi-megabyte sets applies
+   * backpressure just like thousands of small requests would.
+   * If 0, there is no limit.
+   */
+  size_t maxInFlightBytes{0};
+
+  /**
+   * While dispatch is throttled by maxInFlight/maxInFlightBytes, keep
+   * reading and parsing up to this many request bytes into ready-to-go
+   * requests instead of leaving them in kernel buffers, so they dispatch
+   * immediately when the throttle lifts. Only effective on the caret
+   * protocol (ascii multi-op parsing can't be safely deferred).
+   * If 0, parse-ahead is disabled and throttling stops reads entirely.
+   */
+  size_t maxParseAheadBytes{0};
+
+  /**
+   * If true, ascii multiget hits are written out (in request order) as
+   * each sub-request completes, instead of being held until the whole
+   * multiget finishes. END (or an error) is still written last. Clients
+   * that consume incrementally see fast keys at their own latency
+   * rather than at the slowest sub-request's.
+   */
+  bool multiOpStreaming{false};
+
   /**
    * Max connections used at any moment.
    */
   size_t maxConns{0};
 
+  /**
+   * Close client connections that had no activity for this long.
+   * Enforced with one-second granularity. If 0, idle connections are
+   * never closed.
+   */
+  std::chrono::seconds connectionIdleTimeout{0};
+
   /**
    * Smallest allowed buffer size.
    */
@@ -8,6 +8,8 @@
 #pragma once
 
 #include "mcrouter/lib/carbon/Artillery.h"
+#include "mcrouter/lib/carbon/Fingerprint.h"
+#include "mcrouter/lib/carbon/SerializedSize.h"
 #include "mcrouter/lib/network/CarbonMessageDispatcher.h"
 #include "mcrouter/lib/network/UmbrellaProtocol.h"
 
@@ -38,7 +40,8 @@ bool CaretSerializedMessage::prepare(
     const CodecIdRange& supportedCodecs,
     const struct iovec*& iovOut,
     size_t& niovOut,
-    PayloadFormat payloadFormat) noexcept {
+    PayloadFormat payloadFormat,
+    SerializedRequestBodyCache* bodyCache) noexcept {
   return fill(
       req,
       reqId,
@@ -47,7 +50,8 @@ bool CaretSerializedMessage::prepare(
       supportedCodecs,
       iovOut,
       niovOut,
-      payloadFormat);
+      payloadFormat,
+      bodyCache);
 }
 
 template <class Reply>
@@ -80,10 +84,44 @@ bool CaretSerializedMessage::fill(
     const CodecIdRange& supportedCodecs,
     const struct iovec*& iovOut,
     size_t& niovOut,
-    PayloadFormat payloadFormat) {
+    PayloadFormat payloadFormat,
+    SerializedRequestBodyCache* bodyCache) {
   // Serialize body into storage_. Note we must defer serialization of header.
   try {
-    serializeCarbonRequest(message, storage_, payloadFormat);
+    folly::Optional<uint64_t> fingerprint;
+    if (bodyCache) {
+      // Validate reuse against the message content itself, not the call
+      // site: arbitrary route trees may mutate the request between
+      // attempts. Messages whose fields the fingerprint walk cannot
+      // observe get no caching at all.
+      fingerprint = carbon::messageFingerprint(message);
+      if (!fingerprint.hasValue()) {
+        bodyCache = nullptr;
+      }
+    }
+    if (bodyCache && bodyCache->body && bodyCache->typeId == typeId &&
+        bodyCache->payloadFormat == payloadFormat &&
+        bodyCache->fingerprint == fingerprint.value()) {
+      // Resend of an unchanged request: splice the cached body in and
+      // skip serialization; only the header below is built fresh.
+      storage_.append(*bodyCache->body);
+    } else {
+      if (payloadFormat == PayloadFormat::Carbon) {
+        // Give messages that won't fit the inline buffer (long keys,
+        // many fields) one exactly sized buffer up front.
+        storage_.reserve(carbon::estimateSerializedSize(message).dataSize);
+      }
+      serializeCarbonRequest(message, storage_, payloadFormat);
+      if (bodyCache) {
+        // Snapshot the body for subsequent resends. Must happen before
+        // the header is filled in: reportHeaderSize() may fold header
+        // bytes into the first body iovec.
+        bodyCache->body = storage_.createOwnedIOBufChain();
+        bodyCache->fingerprint = fingerprint.value();
+        bodyCache->typeId = typeId;
+        bodyCache->payloadFormat = payloadFormat;
+      }
+    }
   } catch (const std::exception& e) {
     LOG(ERROR) << "Failed to serialize: " << e.what();
     return false;
@@ -111,6 +149,9 @@ bool CaretSerializedMessage::fill(
     size_t& niovOut) {
   // Serialize and (maybe) compress body of message.
   try {
+    // Replies with long inline payloads (e.g. error message strings)
+    // overflow the inline buffer; presize it from the field walk.
+    storage_.reserve(carbon::estimateSerializedSize(message).dataSize);
     serializeCarbonStruct(message, storage_);
   } catch (const std::exception& e) {
     LOG(ERROR) << "Failed to serialize: " << e.what();
@@ -146,16 +187,37 @@ inline bool CaretSerializedMessage::maybeCompress(
     return false;
   }
 
+  // Values that arrive already compressed (clients increasingly compress
+  // large values themselves) defeat whole-body compression: the attempt
+  // below runs the full codec only to be thrown away by the size check.
+  // After a run of wasted attempts, stop trying for a while, retrying
+  // occasionally in case the workload shifts. Counters are per worker
+  // thread; a mixed workload resets the streak on every success, so the
+  // backoff only engages when incompressible replies dominate.
+  constexpr uint32_t kWastedAttemptsBeforeBackoff = 16;
+  constexpr uint32_t kBackoffAttempts = 256;
+  static thread_local uint32_t consecutiveWastedAttempts = 0;
+  static thread_local uint32_t attemptsToSkip = 0;
+  if (attemptsToSkip > 0) {
+    --attemptsToSkip;
+    return false;
+  }
+
   static constexpr size_t kCompressionOverhead = 4;
   try {
     const auto iovs = storage_.getIovecs();
     auto compressedBuf = codec->compress(iovs.first, iovs.second);
     auto compressedSize = compressedBuf->computeChainDataLength();
     if ((compressedSize + kCompressionOverhead) < uncompressedSize) {
+      consecutiveWastedAttempts = 0;
       storage_.reset();
       storage_.append(*compressedBuf);
       return true;
     }
+    if (++consecutiveWastedAttempts >= kWastedAttemptsBeforeBackoff) {
+      consecutiveWastedAttempts = 0;
+      attemptsToSkip = kBackoffAttempts;
+    }
   } catch (const std::exception& e) {
     LOG(ERROR) << "Error compressing reply: " << e.what();
   }
@@ -0,0 +1,185 @@
+/*
+ *  Copyright (c) Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include <folly/Range.h>
+#include <folly/Varint.h>
+
+#include "mcrouter/lib/Compression.h"
+#include "mcrouter/lib/CompressionCodecManager.h"
+#include "mcrouter/lib/carbon/CarbonQueueAppender.h"
+#include "mcrouter/lib/network/ConnectionOptions.h"
+#include "mcrouter/lib/network/ServerLoad.h"
+#include "mcrouter/lib/network/UmbrellaProtocol.h"
+
+namespace facebook {
+namespace memcache {
+
+struct CodecIdRange;
+class CompressionCodec;
+
+/**
+ * Owned copy of a serialized caret request body, reusable across resends
+ * of an unchanged request (failover attempts, connection-error retries).
+ * Only the body is shared: the header (reqId, advertised codecs) is
+ * rebuilt for every send. Reuse is validated against the request content
+ * itself: the body is keyed on typeId, payloadFormat and a fingerprint
+ * of the message's fields (see carbon::messageFingerprint), so any
+ * mutation between attempts — a per-child exptime or key rewrite, a
+ * routing prefix strip, a failover tag — forces a fresh serialization
+ * without the routes involved having to know about the cache.
+ */
+struct SerializedRequestBodyCache {
+  std::unique_ptr<folly::IOBuf> body;
+  uint64_t fingerprint{0};
+  uint32_t typeId{0};
+  PayloadFormat payloadFormat{PayloadFormat::Carbon};
+};
+
+/**
+ * Class for serializing requests in the form of Carbon structs.
+ */
+class CaretSerializedMessage {
+ public:
+  CaretSerializedMessage() = default;
+
+  CaretSerializedMessage(const CaretSerializedMessage&) = delete;
+  CaretSerializedMessage& operator=(const CaretSerializedMessage&) = delete;
+  CaretSerializedMessage(CaretSerializedMessage&&) noexcept = delete;
+  CaretSerializedMessage& operator=(CaretSerializedMessage&&) = delete;
+
+  void clear() {
+    storage_.reset();
+  }
+
+  /**
+   * Prepare requests for serialization for an Operation
+   *
+   * @param req               Request
+   * @param reqId             Request id.
+   * @param supportedCodecs   Range of supported compression codecs.
+   * @param iovOut            Set to the beginning of array of ivecs that
+   *                          reference serialized data.
+   * @param niovOut           Number of valid iovecs referenced by iovOut.
+   * @param bodyCache         If non-null, a matching cached body is reused
+   *                          instead of re-serializing, and a fresh
+   *                          serialization populates the cache.
+   *
+   * @return true iff message was successfully prepared.
+   */
+  template <class Request>
+  bool prepare(
+      const Request& req,
+      size_t reqId,
+      const CodecIdRange& supportedCodecs,
+      const struct iovec*& iovOut,
+      size_t& niovOut,
+      PayloadFormat payloadFormat = PayloadFormat::Carbon,
+      SerializedRequestBodyCache* bodyCache = nullptr) noexcept;
+
+  /**
+   * Prepare replies for serialization
+   *
+   * @param reply                 TypedReply.
+   * @param reqId                 Request id.
+   * @param supportedCodecs       Range of supported codecs.
+   * @param compressionCodecMap   Map of available codecs.
+   * @param serverLoad            Represents load on the server.
+   * @param iovOut                Will be set to the beginning of
+   *                              array of iovecs
+   * @param niovOut               Number of valid iovecs referenced by iovOut.
+   *
+   * @return true if message was successfully prepared.
+   */
+  template <class Reply>
+  bool prepare(
+      Reply&& reply,
+      size_t reqId,
+      const CodecIdRange& supportedCodecs,
+      const CompressionCodecMap* compressionCodecMap,
+      ServerLoad serverLoad,
+      const struct iovec*& iovOut,
+      size_t& niovOut) noexcept;
+
+  /**
+   * Returns the size of the message without the header.
+   */
+  size_t getSizeNoHeader() {
+    return storage_.computeBodySize();
+  }
+
+  // Enable zero copy if an IOBuf exceeds this size threshold
+  void setTCPZeroCopyThreshold(size_t threshold) {
+    storage_.setTCPZeroCopyThreshold(threshold);
+  }
+
+  // Indicates if storage has been marked for zero copy
+  bool shouldApplyZeroCopy() const {
+    return storage_.shouldApplyZeroCopy();
+  }
+
+  // IOBuf chain sharing ownership of the serialized data; stays valid after
+  // this message is destroyed.  Used for zero copy writes.
+  std::unique_ptr<folly::IOBuf> createOwnedIOBufChain() {
+    return storage_.createOwnedIOBufChain();
+  }
+
+ private:
+  carbon::CarbonQueueAppenderStorage storage_;
+
+  template <class Request>
+  bool fill(
+      const Request& message,
+      uint32_t reqId,
+      size_t typeId,
+      std::pair<uint64_t, uint64_t> traceId,
+      const CodecIdRange& supportedCodecs,
+      const struct iovec*& iovOut,
+      size_t& niovOut,
+      PayloadFormat payloadFormat,
+      SerializedRequestBodyCache* bodyCache);
+
+  template <class Reply>
+  bool fill(
+      const Reply& message,
+      uint32_t reqId,
+      size_t typeId,
+      std::pair<uint64_t, uint64_t> traceId,
+      const CodecIdRange& supportedCodecs,
+      const CompressionCodecMap* compressionCodecMap,
+      ServerLoad serverLoad,
+      const struct iovec*& iovOut,
+      size_t& niovOut);
+
+  void fillImpl(
+      UmbrellaMessageInfo& info,
+      uint32_t reqId,
+      size_t typeId,
+      std::pair<uint64_t, uint64_t> traceId,
+      ServerLoad serverLoad,
+      const struct iovec*& iovOut,
+      size_t& niovOut);
+
+  /**
+   * Compress body of message in storage_
+   *
+   * @param codec             Compression codec to use in compression.
+   * @param uncompressedSize  Original (uncompressed) size of the body of the
+   *                          message.
+   * @return                  True if compression succeeds. Otherwise, false.
+   */
+  bool maybeCompress(CompressionCodec* codec, size_t uncompressedSize);
+};
+
+} // namespace memcache
+} // namespace facebook
+
+#include "CaretSerializedMessage-inl.h"
@@ -145,8 +145,10 @@ void ClientMcParser<Callback>::forwardCaretReply(
   cur += offset;
   carbon::CarbonProtocolReader reader(cur);
   reply.deserialize(reader);
-  reply.setTraceContext(
-      carbon::tracing::deserializeTraceContext(headerInfo.traceId));
+  if (headerInfo.traceId.first != 0 || headerInfo.traceId.second != 0) {
+    reply.setTraceContext(
+        carbon::tracing::deserializeTraceContext(headerInfo.traceId));
+  }
 
   callback_.replyReady(std::move(reply), reqId, getReplyStats(headerInfo));
 }
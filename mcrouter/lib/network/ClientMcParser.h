@@ -69,6 +69,15 @@ class ClientMcParser : private McParser::ParserCallback {
     parser_.setProtocol(protocol);
   }
 
+  /**
+   * Hints how many bytes of replies are expected to be in flight; see
+   * McParser::setReadAheadHint(). Only affects the binary protocols;
+   * the ascii parser manages its own buffer.
+   */
+  void setReadAheadHint(size_t bytes) {
+    parser_.setReadAheadHint(bytes);
+  }
+
  private:
   McParser parser_;
   McClientAsciiParser asciiParser_;
@@ -98,6 +98,54 @@ struct ConnectionOptions {
    */
   std::chrono::milliseconds writeTimeout{0};
 
+  /**
+   * Maximum time to delay flushing pending requests in order to build
+   * larger writev batches (adaptive Nagle-like batching).  The flush is
+   * delayed only while new requests keep arriving, and never beyond this
+   * bound, so it trades at most writeFlushDelay of latency for fewer
+   * syscalls under load.  0 disables the extra delay (flush at the end of
+   * the current event loop iteration, as before).
+   */
+  std::chrono::microseconds writeFlushDelay{0};
+
+  /**
+   * When set (and writeFlushDelay is non-zero), flushes are aligned to a
+   * process-wide time grid with period writeFlushDelay and a phase
+   * derived from the destination host.  Connections to the same box in
+   * different proxy threads then flush at the same instants, so the
+   * destination sees fewer, larger packets instead of several small ones
+   * per window.  Worst-case added latency is one writeFlushDelay period.
+   */
+  bool writeFlushAlign{false};
+
+  /**
+   * When non-zero, each flush is held for a uniformly random delay in
+   * (0, writeFlushJitter] before hitting the wire.  This is the inverse
+   * of writeFlushAlign: it spreads writes from the many clients of a hot
+   * destination across the window instead of letting their event loops
+   * synchronize, avoiding incast drops at the destination's switch port.
+   * Takes precedence over writeFlushDelay/writeFlushAlign when set.
+   */
+  std::chrono::microseconds writeFlushJitter{0};
+
+  /**
+   * If non-zero, sets SO_MAX_PACING_RATE (bytes per second) on the
+   * socket where the platform supports it, so the kernel paces the
+   * connection's packets out over time instead of releasing each writev
+   * batch as a line-rate burst.  Complements writeFlushJitter at a finer
+   * (per-packet) granularity.  Ignored if the sockopt is unavailable.
+   */
+  size_t maxPacingRateBytesPerSec{0};
+
+  /**
+   * Maximum total number of serialized request body bytes allowed to be
+   * inflight (being written or awaiting a reply) at any moment.  Bounds the
+   * pipeline by bytes rather than request count, so a handful of large
+   * requests cannot monopolize the connection the way they could under a
+   * pure request-count throttle.  0 means no byte limit.
+   */
+  size_t maxInflightBytes{0};
+
   /**
    * Informs whether QoS is enabled.
    */
@@ -146,6 +194,14 @@ struct ConnectionOptions {
    * The payload format.
    */
   PayloadFormat payloadFormat{PayloadFormat::Carbon};
+
+  /**
+   * If a request contains a buffer (e.g. the value of a set) whose size is
+   * >= tcpZeroCopyThresholdBytes, the write will use the TCP zero copy
+   * optimization on TX.  Only applied to caret connections.
+   * If 0, the tcp zero copy optimization will not be applied.
+   */
+  size_t tcpZeroCopyThresholdBytes{0};
 };
 } // namespace memcache
 } // namespace facebook
@@ -10,7 +10,10 @@
 namespace facebook {
 namespace memcache {
 
-ConnectionTracker::ConnectionTracker(size_t maxConns) : maxConns_(maxConns) {}
+ConnectionTracker::ConnectionTracker(
+    size_t maxConns,
+    uint32_t idleTimeoutGenerations)
+    : maxConns_(maxConns), idleTimeoutGenerations_(idleTimeoutGenerations) {}
 
 McServerSession& ConnectionTracker::add(
     folly::AsyncTransportWrapper::UniquePtr transport,
@@ -31,9 +34,29 @@ McServerSession& ConnectionTracker::add(
       &sessions_,
       compressionCodecMap);
 
+  session.setIdleGeneration(generation_);
+  numConns_.fetch_add(1, std::memory_order_relaxed);
   return session;
 }
 
+void ConnectionTracker::advanceGeneration() {
+  ++generation_;
+  if (idleTimeoutGenerations_ == 0) {
+    return;
+  }
+  // Batch closure of everything that sat out the full idle window.
+  // Closing a session might cause it to remove itself from sessions_,
+  // so we should be careful with the iterator.
+  auto it = sessions_.begin();
+  while (it != sessions_.end()) {
+    auto& session = *it;
+    ++it;
+    if (generation_ - session.idleGeneration() > idleTimeoutGenerations_) {
+      session.beginClose("Closing idle connection");
+    }
+  }
+}
+
 void ConnectionTracker::closeAll() {
   // Closing a session might cause it to remove itself from sessions_,
   // so we should be careful with the iterator
@@ -55,22 +78,37 @@ bool ConnectionTracker::writesPending() const {
 }
 
 void ConnectionTracker::touch(McServerSession& session) {
-  static uint64_t numCalls = 0;
-  // Find the connection and bring it to the front of the LRU.
-  // Do it only once in 16 requests because it's still expensive.
-  if (((numCalls++) & 15) || !session.isLinked()) {
-    return;
-  }
-  sessions_.erase(sessions_.iterator_to(session));
-  sessions_.push_front(session);
+  // Just stamp the current generation; no list maintenance on the
+  // request path. evict() and advanceGeneration() consume the stamps.
+  session.setIdleGeneration(generation_);
 }
 
 void ConnectionTracker::evict() {
   if (sessions_.empty()) {
     return;
   }
-  auto& session = sessions_.back();
-  session.close();
+  // The list is in accept/re-file order, not strict LRU. Clock-style
+  // scan: sessions at the back that were active within the last
+  // generation get a second chance (re-filed to the front); close the
+  // first one that wasn't. The scan is bounded so that an all-active
+  // tail degrades to closing the oldest-filed session.
+  constexpr size_t kMaxEvictScan = 16;
+  for (size_t scanned = 0; scanned < kMaxEvictScan && sessions_.size() > 1;
+       ++scanned) {
+    auto& session = sessions_.back();
+    if (generation_ - session.idleGeneration() <= 1) {
+      // Degrade the stamp while re-filing so one rotation of the scan
+      // can't re-grant the second chance; the arithmetic is modular, so
+      // this is safe near generation zero too.
+      session.setIdleGeneration(generation_ - 2);
+      sessions_.erase(sessions_.iterator_to(session));
+      sessions_.push_front(session);
+      continue;
+    }
+    session.close();
+    return;
+  }
+  sessions_.back().close();
 }
 
 void ConnectionTracker::onAccepted(McServerSession& session) {
@@ -101,6 +139,7 @@ void ConnectionTracker::onCloseFinish(
   if (session.isLinked()) {
     sessions_.erase(sessions_.iterator_to(session));
   }
+  numConns_.fetch_sub(1, std::memory_order_relaxed);
 }
 
 void ConnectionTracker::onShutdown() {
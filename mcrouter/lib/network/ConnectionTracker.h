@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <memory>
 
@@ -16,16 +17,31 @@ namespace facebook {
 namespace memcache {
 
 /**
- * Single threaded list of connections with LRU eviction logic.
+ * Single threaded list of connections with approximate-LRU eviction and
+ * idle sweeping.
+ *
+ * Recency is tracked with generation stamps rather than list splices:
+ * activity just stores the current generation on the session, and the
+ * owner advances the generation via advanceGeneration() (one timer tick,
+ * typically per second) which also batch-closes sessions idle for the
+ * whole configured window. This keeps the per-request cost at a single
+ * write regardless of connection count.
  */
 class ConnectionTracker : public McServerSession::StateCallback {
  public:
   /**
    * Creates a new tracker with `maxConns` connections. Once there are
    * more than `maxConns` connections (sessions), ConnectionTracker will close
-   * the oldest one. If `maxConns` is 0, it will not close connections.
+   * the least recently active one. If `maxConns` is 0, it will not close
+   * connections on overflow.
+   *
+   * `idleTimeoutGenerations` is the idle window measured in generation
+   * ticks: sessions that saw no activity for more than that many ticks
+   * are closed by advanceGeneration(). 0 disables idle closing.
    */
-  explicit ConnectionTracker(size_t maxConns = 0);
+  explicit ConnectionTracker(
+      size_t maxConns = 0,
+      uint32_t idleTimeoutGenerations = 0);
 
   // See AsyncMcServerWorker.h for details about the callbacks
   void setOnConnectionAccepted(std::function<void(McServerSession&)> cb) {
@@ -67,19 +83,37 @@ class ConnectionTracker : public McServerSession::StateCallback {
    */
   void closeAll();
 
+  /**
+   * Advances the idle generation by one tick and batch-closes sessions
+   * that have been idle for more than the configured window. Meant to be
+   * driven by a periodic timer owned by the caller.
+   */
+  void advanceGeneration();
+
   /**
    * Check if we have pending writes on any connection (session)
    */
   bool writesPending() const;
 
+  /**
+   * Number of tracked connections (sessions).
+   * Safe to call from any thread; all other methods are single threaded.
+   */
+  size_t numConnections() const {
+    return numConns_.load(std::memory_order_relaxed);
+  }
+
  private:
   McServerSession::Queue sessions_;
+  std::atomic<size_t> numConns_{0};
   std::function<void(McServerSession&)> onAccepted_;
   std::function<void(McServerSession&)> onWriteQuiescence_;
   std::function<void(McServerSession&)> onCloseStart_;
   std::function<void(McServerSession&, bool onAcceptedCalled)> onCloseFinish_;
   std::function<void()> onShutdown_;
   size_t maxConns_{0};
+  uint32_t idleTimeoutGenerations_{0};
+  uint64_t generation_{0};
 
   void touch(McServerSession& session);
 
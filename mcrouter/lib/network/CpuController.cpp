@@ -7,10 +7,12 @@
  */
 #include "CpuController.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include <folly/File.h>
 #include <folly/FileUtil.h>
+#include <folly/Random.h>
 
 namespace facebook {
 namespace memcache {
@@ -43,15 +45,92 @@ bool readProcStat(std::vector<uint64_t>& curArray) {
   return true;
 }
 
+// How far a shed-level adjustment moves per collection tick. Small
+// steps trade reaction time for stability under a noisy CPU signal.
+constexpr double kShedLevelStep = 0.05;
+
+// The level only backs off once the CPU is this many percentage points
+// below the limit; inside the band it holds steady. Without the band
+// the controller flip-flops every tick right at the limit, since
+// shedding itself lowers the CPU reading.
+constexpr double kShedHysteresisPct = 5.0;
+
+// Weight of a new duration sample in the per-class cost EWMA.
+constexpr double kCostSampleWeight = 1.0 / 16.0;
+
 } // namespace
 
 CpuController::CpuController(
     const CpuControllerOptions& opts,
     folly::EventBase& evb)
-    : evb_(evb), dataCollectionInterval_(opts.dataCollectionInterval) {
+    : evb_(evb),
+      dataCollectionInterval_(opts.dataCollectionInterval),
+      cpuShedLimit_(opts.cpuShedLimit) {
   assert(opts.shouldEnable());
 }
 
+bool CpuController::shouldAdmit(CpuOpClass opClass) const noexcept {
+  if (opClass == CpuOpClass::kDelete) {
+    return true;
+  }
+  const auto level = shedLevel_.load(std::memory_order_relaxed);
+  if (level <= 0.0) {
+    return true;
+  }
+
+  double maxCostUs = 0.0;
+  for (size_t i = 0; i < kNumCpuOpClasses; ++i) {
+    if (i != static_cast<size_t>(CpuOpClass::kDelete)) {
+      maxCostUs =
+          std::max(maxCostUs, opCostUs_[i].load(std::memory_order_relaxed));
+    }
+  }
+  const auto costUs =
+      opCostUs_[static_cast<size_t>(opClass)].load(std::memory_order_relaxed);
+  // Until costs have been learned, treat every class as expensive.
+  const double weight =
+      (maxCostUs > 0.0 && costUs > 0.0) ? costUs / maxCostUs : 1.0;
+
+  /**
+   * Map the shed level to a per-class drop probability such that the
+   * most expensive class (weight 1) sheds first: a class only starts
+   * dropping once the level exceeds 1 - weight, and reaches 100% drop
+   * at level 1. E.g. with weight 0.25, nothing is dropped until the
+   * level passes 0.75.
+   */
+  const auto dropProbability = (level - (1.0 - weight)) / weight;
+  if (dropProbability <= 0.0) {
+    return true;
+  }
+  return folly::Random::randDouble01() >= std::min(dropProbability, 1.0);
+}
+
+void CpuController::reportOpCost(
+    CpuOpClass opClass,
+    uint64_t durationUs) noexcept {
+  auto& cell = opCostUs_[static_cast<size_t>(opClass)];
+  // Load/store rather than a CAS loop: a racy update loses one sample,
+  // which the EWMA doesn't care about.
+  const auto prev = cell.load(std::memory_order_relaxed);
+  const auto next = prev == 0.0
+      ? static_cast<double>(durationUs)
+      : prev + (static_cast<double>(durationUs) - prev) * kCostSampleWeight;
+  cell.store(next, std::memory_order_relaxed);
+}
+
+void CpuController::updateShedLevel(double cpuUtil) noexcept {
+  if (!admissionEnabled()) {
+    return;
+  }
+  auto level = shedLevel_.load(std::memory_order_relaxed);
+  if (cpuUtil > cpuShedLimit_) {
+    level = std::min(1.0, level + kShedLevelStep);
+  } else if (cpuUtil < cpuShedLimit_ - kShedHysteresisPct) {
+    level = std::max(0.0, level - kShedLevelStep);
+  }
+  shedLevel_.store(level, std::memory_order_relaxed);
+}
+
 void CpuController::start() {
   stopController_ = false;
   auto self = shared_from_this();
@@ -102,6 +181,8 @@ void CpuController::cpuLoggingFn() {
   }
   if (stopController_) {
     update(0.0);
+    // Don't keep shedding off stale data once the controller stops.
+    shedLevel_.store(0.0, std::memory_order_relaxed);
     return;
   }
   update(cpuUtil);
@@ -112,6 +193,7 @@ void CpuController::cpuLoggingFn() {
 
 void CpuController::update(double cpuUtil) {
   percentLoad_.store(cpuUtil);
+  updateShedLevel(cpuUtil);
 }
 
 } // namespace memcache
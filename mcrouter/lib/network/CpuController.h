@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
 
 #include <folly/io/async/EventBase.h>
@@ -23,11 +25,32 @@ struct CpuControllerOptions {
    */
   std::chrono::milliseconds dataCollectionInterval{0};
 
+  /**
+   * CPU utilization percentage above which the server starts shedding
+   * requests, most expensive operation classes first.
+   * 0 disables admission control; load is still collected and exported.
+   */
+  double cpuShedLimit{0.0};
+
   bool shouldEnable() const noexcept {
     return dataCollectionInterval.count() > 0;
   }
 };
 
+/**
+ * Operation classes for CPU-based admission control. Costs are learned
+ * per class from observed handler durations; deletes are never shed,
+ * since dropping them hurts consistency far more than the CPU they cost.
+ */
+enum class CpuOpClass : uint8_t {
+  kDelete = 0,
+  kGet,
+  kUpdate,
+  kOther,
+};
+
+constexpr size_t kNumCpuOpClasses = 4;
+
 class CpuController : public std::enable_shared_from_this<CpuController> {
  public:
   CpuController(const CpuControllerOptions& opts, folly::EventBase& evb);
@@ -39,6 +62,42 @@ class CpuController : public std::enable_shared_from_this<CpuController> {
     return ServerLoad::fromPercentLoad(percentLoad_.load());
   }
 
+  bool admissionEnabled() const noexcept {
+    return cpuShedLimit_ > 0.0;
+  }
+
+  /**
+   * Decides whether a request of the given class may start right now.
+   * Deletes are always admitted. For everything else the current shed
+   * level is weighted by the class's learned cost relative to the most
+   * expensive class, so cheap work is only shed once shedding all of
+   * the expensive work wasn't enough to get under the CPU limit.
+   */
+  bool shouldAdmit(CpuOpClass opClass) const noexcept;
+
+  /**
+   * Feeds one observed handler duration into the per-class cost
+   * estimate (an approximate EWMA; safe to call from any thread).
+   */
+  void reportOpCost(CpuOpClass opClass, uint64_t durationUs) noexcept;
+
+  /**
+   * Moves the shed level towards the configured CPU limit: up when the
+   * sample is above the limit, down when it is below the limit by more
+   * than a hysteresis band, unchanged inside the band so the controller
+   * doesn't oscillate. Normally driven by the collection loop; public
+   * so the policy is testable without scraping /proc/stat.
+   */
+  void updateShedLevel(double cpuUtil) noexcept;
+
+  /**
+   * Fraction [0, 1] of the weighted request volume currently being
+   * shed; 0 when the server is under its CPU limit.
+   */
+  double shedLevel() const noexcept {
+    return shedLevel_.load(std::memory_order_relaxed);
+  }
+
   void start();
   void stop();
 
@@ -52,7 +111,11 @@ class CpuController : public std::enable_shared_from_this<CpuController> {
   folly::EventBase& evb_;
   std::vector<uint64_t> prev_{8};
   std::chrono::milliseconds dataCollectionInterval_;
+  const double cpuShedLimit_{0.0};
   std::atomic<double> percentLoad_{0.0};
+  std::atomic<double> shedLevel_{0.0};
+  // Learned average handler duration per operation class, in us.
+  std::array<std::atomic<double>, kNumCpuOpClasses> opCostUs_{};
   std::atomic<bool> stopController_{false};
   bool firstLoop_{true};
 };
@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include "DnsResolutionCache.h"
+
+#include <folly/SocketAddress.h>
+#include <glog/logging.h>
+
+#include "mcrouter/lib/AuxiliaryIOThreadPool.h"
+
+namespace facebook {
+namespace memcache {
+
+namespace {
+
+folly::Singleton<DnsResolutionCache> gDnsResolutionCache;
+
+folly::Optional<folly::IPAddress> resolveHost(const std::string& host) {
+  try {
+    folly::SocketAddress address(host, 0, /* allowNameLookup */ true);
+    return address.getIPAddress();
+  } catch (const std::exception& e) {
+    VLOG(2) << "DNS resolution of " << host << " failed: " << e.what();
+    return folly::none;
+  }
+}
+
+} // anonymous
+
+constexpr uint32_t DnsResolutionCache::kRefreshIntervalMs;
+
+folly::Optional<folly::IPAddress> DnsResolutionCache::lookup(
+    folly::StringPiece host) const {
+  auto snapshot = snapshot_.load(std::memory_order_acquire);
+  if (!snapshot) {
+    return folly::none;
+  }
+  auto it = snapshot->find(host);
+  if (it == snapshot->end()) {
+    return folly::none;
+  }
+  return it->second;
+}
+
+void DnsResolutionCache::preResolve(std::string host) {
+  if (folly::IPAddress::validate(host)) {
+    // IP literals don't involve DNS at all.
+    return;
+  }
+  if (lookup(host)) {
+    // Already cached; the periodic refresh keeps it current.
+    return;
+  }
+  auto auxPool = mcrouter::AuxiliaryIOThreadPoolSingleton::try_get_fast();
+  if (!auxPool) {
+    // Shutting down; the connect path will resolve synchronously.
+    return;
+  }
+  auxPool->getThreadPool().add([host = std::move(host)]() {
+    if (auto cache = DnsResolutionCacheSingleton::try_get_fast()) {
+      cache->resolveNow(host);
+    }
+  });
+  scheduleRefresh();
+}
+
+bool DnsResolutionCache::resolveNow(const std::string& host) {
+  auto address = resolveHost(host);
+  if (!address) {
+    // Keep whatever we had; stale beats unresolvable.
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(updateLock_);
+  auto old = snapshot_.load(std::memory_order_acquire);
+  auto next = old ? std::make_shared<Map>(*old) : std::make_shared<Map>();
+  auto res = next->emplace(host, *address);
+  if (!res.second) {
+    res.first->second = *address;
+  }
+  snapshot_.store(std::move(next), std::memory_order_release);
+  return true;
+}
+
+void DnsResolutionCache::refreshAll() {
+  // The snapshot is immutable, so resolving against it while resolveNow
+  // publishes new ones is safe; a host added mid-refresh is picked up on
+  // the next tick.
+  auto snapshot = snapshot_.load(std::memory_order_acquire);
+  if (!snapshot) {
+    return;
+  }
+  for (const auto& it : *snapshot) {
+    resolveNow(it.first.str());
+  }
+}
+
+void DnsResolutionCache::scheduleRefresh() {
+  {
+    std::lock_guard<std::mutex> lock(updateLock_);
+    if (refreshScheduled_) {
+      return;
+    }
+    refreshScheduled_ = true;
+  }
+  scheduleNextTick();
+}
+
+void DnsResolutionCache::scheduleNextTick() {
+  auto auxPool = mcrouter::AuxiliaryIOThreadPoolSingleton::try_get_fast();
+  if (!auxPool) {
+    return;
+  }
+  auto* evb = auxPool->getThreadPool().getEventBase();
+  evb->runInEventBaseThread([evb]() {
+    evb->runAfterDelay(
+        []() {
+          // Fetched through the singleton so a cache torn down during
+          // shutdown simply stops refreshing.
+          if (auto cache = DnsResolutionCacheSingleton::try_get_fast()) {
+            cache->refreshAll();
+            cache->scheduleNextTick();
+          }
+        },
+        kRefreshIntervalMs);
+  });
+}
+
+} // memcache
+} // facebook
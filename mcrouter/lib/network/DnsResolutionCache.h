@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <folly/IPAddress.h>
+#include <folly/Optional.h>
+#include <folly/Range.h>
+#include <folly/Singleton.h>
+#include <folly/concurrency/AtomicSharedPtr.h>
+#include <folly/experimental/StringKeyedUnorderedMap.h>
+
+namespace facebook {
+namespace memcache {
+
+/**
+ * Process-wide cache of hostname resolutions.
+ *
+ * Without it, every (re)connect resolves synchronously on the proxy
+ * event base, so a DNS hiccup shows up as a connect latency spike and,
+ * via connect timeouts, as TKO false positives.  Instead, destination
+ * hostnames are resolved in the background on the auxiliary IO thread
+ * pool: once when the destination is configured (before the new config
+ * is swapped in) and periodically thereafter.  The connect path reads a
+ * snapshot without taking any lock and only falls back to a synchronous
+ * lookup for hosts the cache hasn't resolved yet.
+ *
+ * On a failed re-resolution the last known address is kept: a stale
+ * address is strictly better than turning the DNS outage into a
+ * destination outage.
+ */
+class DnsResolutionCache {
+ public:
+  DnsResolutionCache() : snapshot_(nullptr) {}
+
+  /**
+   * @return the cached address of host, or none if the cache doesn't
+   *         have one (unknown host, IP literal, resolution still in
+   *         flight).  Lock-free; safe to call on the connect path.
+   */
+  folly::Optional<folly::IPAddress> lookup(folly::StringPiece host) const;
+
+  /**
+   * Starts resolving host in the background on the auxiliary IO thread
+   * pool and arms the periodic refresh.  No-op for IP literals and for
+   * hosts that are already cached.  Called at configuration time, so
+   * connects issued after the config swap find the address ready.
+   */
+  void preResolve(std::string host);
+
+  /**
+   * Resolves host on the calling thread and stores the result.
+   *
+   * @return true if resolution succeeded.
+   */
+  bool resolveNow(const std::string& host);
+
+ private:
+  using Map = folly::StringKeyedUnorderedMap<folly::IPAddress>;
+
+  /**
+   * Re-resolves every cached host.  Runs on the auxiliary IO thread
+   * pool every kRefreshIntervalMs once any host is cached.
+   */
+  void refreshAll();
+
+  void scheduleRefresh();
+  void scheduleNextTick();
+
+  // Readers load the current snapshot without taking any lock; writers
+  // (auxiliary IO threads) rebuild it under updateLock_.
+  folly::atomic_shared_ptr<const Map> snapshot_;
+  std::mutex updateLock_;
+  bool refreshScheduled_{false};
+
+  static constexpr uint32_t kRefreshIntervalMs = 30 * 1000;
+};
+
+using DnsResolutionCacheSingleton = folly::Singleton<DnsResolutionCache>;
+
+} // memcache
+} // facebook
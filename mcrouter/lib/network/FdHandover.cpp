@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "FdHandover.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace facebook {
+namespace memcache {
+
+namespace {
+
+/* Payloads are identifying metadata, not bulk data; cap them so the
+   receiver can use a fixed buffer and a short read means a bad peer. */
+constexpr size_t kMaxPayloadSize = 8192;
+
+} // anonymous
+
+bool sendFdHandover(int channelFd, int fd, folly::StringPiece payload) {
+  if (fd < 0 || payload.empty() || payload.size() > kMaxPayloadSize) {
+    errno = EINVAL;
+    return false;
+  }
+
+  struct iovec iov;
+  iov.iov_base = const_cast<char*>(payload.data());
+  iov.iov_len = payload.size();
+
+  char control[CMSG_SPACE(sizeof(int))];
+  memset(control, 0, sizeof(control));
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+  ssize_t sent;
+  do {
+    sent = sendmsg(channelFd, &msg, 0);
+  } while (sent == -1 && errno == EINTR);
+
+  return sent == static_cast<ssize_t>(payload.size());
+}
+
+int recvFdHandover(int channelFd, std::string& payload) {
+  char buf[kMaxPayloadSize];
+
+  struct iovec iov;
+  iov.iov_base = buf;
+  iov.iov_len = sizeof(buf);
+
+  char control[CMSG_SPACE(sizeof(int))];
+  memset(control, 0, sizeof(control));
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t received;
+  do {
+    received = recvmsg(channelFd, &msg, MSG_CMSG_CLOEXEC);
+  } while (received == -1 && errno == EINTR);
+
+  if (received == 0) {
+    /* Peer closed the channel: end of handover. */
+    errno = 0;
+    return -1;
+  }
+  if (received == -1) {
+    return -1;
+  }
+
+  int fd = -1;
+  for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+        cmsg->cmsg_len == CMSG_LEN(sizeof(int))) {
+      memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+      break;
+    }
+  }
+
+  if (fd < 0 || (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    errno = EPROTO;
+    return -1;
+  }
+
+  payload.assign(buf, received);
+  return fd;
+}
+
+} // memcache
+} // facebook
@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <string>
+
+#include <folly/Range.h>
+
+namespace facebook {
+namespace memcache {
+
+/**
+ * SCM_RIGHTS handover of connected sockets between processes.
+ *
+ * Counterpart of the listen-socket takeover AsyncMcServer supports via
+ * existingSocketFd, but for destination connections: during a graceful
+ * binary restart the predecessor can pass its established plain-TCP
+ * destination fds to the successor over a local socket, together with a
+ * small payload identifying what the fd is connected to (e.g. the
+ * serialized AccessPoint), so the successor can resume on warm
+ * connections instead of reconnecting the whole tier at once.
+ *
+ * Each message carries exactly one fd and one payload. The channel must
+ * be a connected unix domain socket (e.g. one end of a socketpair or an
+ * abstract-namespace connection to the successor).
+ */
+
+/**
+ * Sends fd plus payload over channelFd as a single message.
+ *
+ * @param channelFd  Connected AF_UNIX socket.
+ * @param fd         The fd to pass; the caller keeps its own copy open.
+ * @param payload    Identifying metadata; must be non-empty and small
+ *                   enough to send in one datagram (a few KB).
+ *
+ * @return true on success, false otherwise with errno set.
+ */
+bool sendFdHandover(int channelFd, int fd, folly::StringPiece payload);
+
+/**
+ * Receives one fd plus its payload from channelFd.
+ *
+ * @param channelFd  Connected AF_UNIX socket.
+ * @param payload    Overwritten with the received metadata.
+ *
+ * @return the received fd (owned by the caller), or -1 on error / clean
+ *         channel shutdown with errno set (0 on clean shutdown).
+ */
+int recvFdHandover(int channelFd, std::string& payload);
+
+} // memcache
+} // facebook
@@ -7,7 +7,14 @@
  */
 #include "McAsciiParser.h"
 
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include <folly/String.h>
+#include <folly/small_vector.h>
 
 #include "mcrouter/lib/fbi/cpp/LogFailure.h"
 
@@ -16,6 +23,98 @@ namespace memcache {
 
 constexpr size_t kProtocolTailContextLength = 128;
 
+namespace {
+
+/**
+ * @return pointer to the first byte in [begin, end) that cannot be part of
+ *         an ascii key, i.e. any byte c with (unsigned)c <= 0x20 (space,
+ *         CR, LF or another control character). Matches the ragel key
+ *         class (any+ -- (cntrl | space)).
+ */
+const char* findKeyEnd(const char* begin, const char* end) {
+#ifdef __SSE2__
+  const __m128i kSpace = _mm_set1_epi8(0x20);
+  const __m128i kDel = _mm_set1_epi8(0x7F);
+  for (; begin + 16 <= end; begin += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+    /* (unsigned)c <= 0x20  <=>  min(c, 0x20) == c, byte-wise unsigned.
+       DEL (0x7F) also ends a key, matching the grammar's
+       (any+ -- (cntrl | space)) production. */
+    __m128i spaceOrCtrl = _mm_cmpeq_epi8(_mm_min_epu8(chunk, kSpace), chunk);
+    __m128i del = _mm_cmpeq_epi8(chunk, kDel);
+    int mask = _mm_movemask_epi8(_mm_or_si128(spaceOrCtrl, del));
+    if (mask != 0) {
+      return begin + __builtin_ctz(mask);
+    }
+  }
+#endif
+  while (begin != end && static_cast<unsigned char>(*begin) > 0x20 &&
+         static_cast<unsigned char>(*begin) != 0x7F) {
+    ++begin;
+  }
+  return begin;
+}
+
+} // anonymous
+
+bool McServerAsciiParser::tryConsumeMultiGetFast(folly::IOBuf& buffer) {
+  constexpr folly::StringPiece kGetPrefix{"get "};
+
+  const char* data = reinterpret_cast<const char*>(buffer.data());
+  const char* end = data + buffer.length();
+  if (buffer.length() < kGetPrefix.size() ||
+      memcmp(data, kGetPrefix.data(), kGetPrefix.size()) != 0) {
+    return false;
+  }
+
+  const char* lineStart = data + kGetPrefix.size();
+  const char* nl = static_cast<const char*>(
+      memchr(lineStart, '\n', end - lineStart));
+  if (nl == nullptr) {
+    // The request line is split across reads; the state machine knows how
+    // to keep partial progress.
+    return false;
+  }
+  const char* lineEnd = (nl > lineStart && nl[-1] == '\r') ? nl - 1 : nl;
+
+  // Tokenize and validate the whole line before emitting anything, so
+  // that malformed lines go through the state machine and produce exactly
+  // the same error as before.
+  folly::small_vector<std::pair<const char*, const char*>, 16> keys;
+  const char* pos = lineStart;
+  while (true) {
+    while (pos != lineEnd && *pos == ' ') {
+      ++pos;
+    }
+    if (pos == lineEnd) {
+      break;
+    }
+    const char* keyEnd = findKeyEnd(pos, lineEnd);
+    if (keyEnd == pos || (keyEnd != lineEnd && *keyEnd != ' ')) {
+      // Control character inside the line.
+      return false;
+    }
+    keys.emplace_back(pos, keyEnd);
+    pos = keyEnd;
+  }
+  if (keys.empty()) {
+    return false;
+  }
+
+  for (const auto& keyRange : keys) {
+    McGetRequest req;
+    folly::IOBuf keyBuf;
+    buffer.cloneOneInto(keyBuf);
+    trimIOBufToRange(keyBuf, keyRange.first, keyRange.second);
+    req.key() = std::move(keyBuf);
+    callback_->onRequest(std::move(req));
+  }
+  callback_->multiOpEnd();
+
+  buffer.trimStart(nl + 1 - data);
+  return true;
+}
+
 McAsciiParserBase::State McClientAsciiParser::consume(folly::IOBuf& buffer) {
   assert(state_ == State::PARTIAL);
   assert(!hasReadBuffer());
@@ -232,6 +232,18 @@ class McServerAsciiParser : public McAsciiParserBase {
   void consumeFlushRe(folly::IOBuf& buffer);
   void consumeFlushAll(folly::IOBuf& buffer);
 
+  /**
+   * Fast path for the dominant production: a complete "get <key>+\r\n"
+   * line at the front of the buffer. Scans for token boundaries 16 bytes
+   * at a time instead of driving the state machine one byte per
+   * transition, and emits the requests directly.
+   *
+   * @return true iff the line was fully consumed (buffer trimmed past it).
+   *         false means no byte was consumed and the caller must run the
+   *         regular state machine (partial line, unusual bytes, other ops).
+   */
+  bool tryConsumeMultiGetFast(folly::IOBuf& buffer);
+
   void finishReq();
 
   std::unique_ptr<detail::CallbackBase<McRequestList>> callback_;
@@ -1212,6 +1212,13 @@ McAsciiParserBase::State McServerAsciiParser::consume(folly::IOBuf& buffer) {
   while (p_ != pe_) {
     // Initialize operation parser.
     if (state_ == State::UNINIT) {
+      // Complete multiget lines skip the state machine entirely.
+      if (tryConsumeMultiGetFast(buffer)) {
+        p_ = reinterpret_cast<const char*>(buffer.data());
+        pe_ = p_ + buffer.length();
+        continue;
+      }
+
       savedCs_ = mc_ascii_req_type_en_command;
       errorCs_ = mc_ascii_req_type_error;
 
@@ -48,8 +48,17 @@ McClientRequestContextBase::McClientRequestContextBase(
     InitializerFuncPtr initializer,
     const std::function<void(int pendingDiff, int inflightDiff)>& onStateChange,
     const CodecIdRange& supportedCodecs,
-    PayloadFormat payloadFormat)
-    : reqContext(request, reqid, protocol, supportedCodecs, payloadFormat),
+    PayloadFormat payloadFormat,
+    size_t tcpZeroCopyThreshold,
+    SerializedRequestBodyCache* bodyCache)
+    : reqContext(
+          request,
+          reqid,
+          protocol,
+          supportedCodecs,
+          payloadFormat,
+          tcpZeroCopyThreshold,
+          bodyCache),
       id(reqid),
       queue_(queue),
       replyType_(typeid(ReplyT<Request>)),
@@ -118,7 +127,9 @@ McClientRequestContext<Request>::McClientRequestContext(
     McClientRequestContextBase::InitializerFuncPtr func,
     const std::function<void(int pendingDiff, int inflightDiff)>& onStateChange,
     const CodecIdRange& supportedCodecs,
-    PayloadFormat payloadFormat)
+    PayloadFormat payloadFormat,
+    size_t tcpZeroCopyThreshold,
+    SerializedRequestBodyCache* bodyCache)
     : McClientRequestContextBase(
           request,
           reqid,
@@ -128,7 +139,9 @@ McClientRequestContext<Request>::McClientRequestContext(
           std::move(func),
           onStateChange,
           supportedCodecs,
-          payloadFormat),
+          payloadFormat,
+          tcpZeroCopyThreshold,
+          bodyCache),
       requestTraceContext_(request.traceContext())
 #ifndef LIBMC_FBTRACE_DISABLE
       ,
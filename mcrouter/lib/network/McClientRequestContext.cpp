@@ -21,6 +21,12 @@ void McClientRequestContextBase::replyError(
   baton_.post();
 }
 
+void McClientRequestContextBase::setState(ReqState newState) {
+  fireStateChangeCallbacks(state_, newState);
+  queue_.onStateChange(*this, state_, newState);
+  state_ = newState;
+}
+
 void McClientRequestContextBase::fireStateChangeCallbacks(
     ReqState old,
     ReqState current) const {
@@ -97,6 +103,30 @@ size_t McClientRequestContextQueue::getInflightRequestCount() const noexcept {
   return repliedQueue_.size() + writeQueue_.size() + pendingReplyQueue_.size();
 }
 
+size_t McClientRequestContextQueue::getInflightRequestBytes() const noexcept {
+  return inflightBytes_;
+}
+
+void McClientRequestContextQueue::onStateChange(
+    McClientRequestContextBase& req,
+    State old,
+    State current) {
+  auto isInflight = [](State state) {
+    return state == State::WRITE_QUEUE || state == State::PENDING_REPLY_QUEUE ||
+        state == State::REPLIED_QUEUE;
+  };
+
+  if (isInflight(old) == isInflight(current)) {
+    return;
+  }
+  if (isInflight(current)) {
+    inflightBytes_ += req.reqContext.getBodySize();
+  } else {
+    assert(inflightBytes_ >= req.reqContext.getBodySize());
+    inflightBytes_ -= req.reqContext.getBodySize();
+  }
+}
+
 void McClientRequestContextQueue::failAllSent(
     mc_res_t error,
     folly::StringPiece errorMessage) {
@@ -99,7 +99,9 @@ class McClientRequestContextBase
       const std::function<void(int pendingDiff, int inflightDiff)>&
           onStateChange,
       const CodecIdRange& supportedCodecs,
-      PayloadFormat payloadFormat);
+      PayloadFormat payloadFormat,
+      size_t tcpZeroCopyThreshold = 0,
+      SerializedRequestBodyCache* bodyCache = nullptr);
 
   virtual void sendTraceOnReply() = 0;
 
@@ -111,10 +113,7 @@ class McClientRequestContextBase
     return state_;
   }
 
-  void setState(ReqState newState) {
-    fireStateChangeCallbacks(state_, newState);
-    state_ = newState;
-  }
+  void setState(ReqState newState);
 
   folly::fibers::Baton baton_;
   McClientRequestContextQueue& queue_;
@@ -189,7 +188,9 @@ class McClientRequestContext : public McClientRequestContextBase {
       const std::function<void(int pendingDiff, int inflightDiff)>&
           onStateChange,
       const CodecIdRange& supportedCodecs,
-      PayloadFormat payloadFormat);
+      PayloadFormat payloadFormat,
+      size_t tcpZeroCopyThreshold = 0,
+      SerializedRequestBodyCache* bodyCache = nullptr);
 
   std::string getContextTypeStr() const final;
 
@@ -222,6 +223,12 @@ class McClientRequestContextQueue {
   size_t getPendingRequestCount() const noexcept;
   size_t getInflightRequestCount() const noexcept;
 
+  /**
+   * Total number of serialized request body bytes that are currently
+   * inflight (i.e. being written to the socket or awaiting a reply).
+   */
+  size_t getInflightRequestBytes() const noexcept;
+
   /**
    * Fails all requests that were already sent (i.e. pending reply) with a given
    * error code.
@@ -305,10 +312,15 @@ class McClientRequestContextQueue {
   // Friend to allow access to remove* mothods.
   template <class Request>
   friend class McClientRequestContext;
+  // Friend to allow setState() to call onStateChange().
+  friend class McClientRequestContextBase;
 
   using State = McClientRequestContextBase::ReqState;
 
   bool outOfOrder_{false};
+  // Sum of serialized body sizes of requests in write, pending reply and
+  // replied queues. Maintained by onStateChange().
+  size_t inflightBytes_{0};
   // Queue of requests, that are queued to be sent.
   McClientRequestContextBase::Queue pendingQueue_;
   // Queue of requests, that are currently being written to the socket.
@@ -332,6 +344,12 @@ class McClientRequestContextQueue {
       mc_res_t error,
       folly::StringPiece errorMessage);
 
+  /**
+   * Keeps inflightBytes_ in sync with request state transitions. Called by
+   * McClientRequestContextBase::setState() on every transition.
+   */
+  void onStateChange(McClientRequestContextBase& req, State old, State current);
+
   McClientRequestContextBase::UnorderedSet::iterator getContextById(
       uint64_t id);
   void removeFromSet(McClientRequestContextBase& req);
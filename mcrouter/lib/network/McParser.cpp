@@ -80,6 +80,7 @@ McParser::McParser(
     const bool useJemallocNodumpAllocator,
     ConnectionFifo* debugFifo)
     : callback_(callback),
+      minBufferSize_(minBufferSize),
       bufferSize_(minBufferSize),
       maxBufferSize_(maxBufferSize),
       debugFifo_(debugFifo),
@@ -94,28 +95,65 @@ void McParser::reset() {
   readBuffer_.clear();
 }
 
+void McParser::adjustBufferSize() {
+  if (bytesPerReadEwma_ + bytesPerReadEwma_ / 4 >= bufferSize_) {
+    /* Reads keep (nearly) filling the buffer, so it's limiting read size:
+       grow eagerly */
+    bufferSize_ = std::min(maxBufferSize_, bufferSize_ * 2);
+  } else if (
+      bufferSize_ > minBufferSize_ && bytesPerReadEwma_ < bufferSize_ / 4) {
+    /* Most of the buffer goes unused: shrink, but lazily, so short idle
+       periods on a bulk connection don't throw the size away */
+    auto curCycles = cycles::getCpuCycles();
+    if (curCycles > lastShrinkCycles_ + kAdjustBufferSizeCpuCycles) {
+      lastShrinkCycles_ = curCycles;
+      bufferSize_ = std::max(minBufferSize_, bufferSize_ / 2);
+      if (readBuffer_.length() == 0) {
+        readBuffer_ = folly::IOBuf(folly::IOBuf::CREATE, bufferSize_);
+        readBufferIsNodump_ = false;
+      }
+    }
+  }
+}
+
 std::pair<void*, size_t> McParser::getReadBuffer() {
   assert(!readBuffer_.isChained());
   readBuffer_.unshareOne();
+  adjustBufferSize();
+  /* The caller may know more data is coming than the adapted size would
+     fetch in one read (e.g. many replies outstanding); honor that for
+     this read only. */
+  const size_t targetSize =
+      std::min(maxBufferSize_, std::max(bufferSize_, readAheadHint_));
+  readAheadHint_ = 0;
   if (!readBuffer_.length()) {
     assert(readBuffer_.capacity() > 0);
     /* If we read everything, reset pointers to 0 and re-use the buffer */
     readBuffer_.clear();
+    if (readBuffer_.tailroom() < targetSize) {
+      readBuffer_.reserve(0, targetSize);
+      readBufferIsNodump_ = false;
+    }
   } else if (readBuffer_.headroom() > 0) {
     /* Move partially read data to the beginning */
     readBuffer_.retreat(readBuffer_.headroom());
-  } else {
+  } else if (readBuffer_.tailroom() < targetSize) {
     /* Reallocate more space if necessary */
-    readBuffer_.reserve(0, bufferSize_);
+    readBuffer_.reserve(0, targetSize);
+    readBufferIsNodump_ = false;
   }
   return std::make_pair(readBuffer_.writableTail(), readBuffer_.tailroom());
 }
 
 bool McParser::readUmbrellaOrCaretData() {
+  // Pipelined bursts commonly put dozens of frames in the buffer per
+  // read; everything in the loop below runs once per frame, so the
+  // protocol is resolved once out here.
+  const bool isUmbrella = (protocol_ == mc_umbrella_protocol_DONOTUSE);
   while (readBuffer_.length() > 0) {
     // Parse header
     UmbrellaParseStatus parseStatus;
-    if (protocol_ == mc_umbrella_protocol_DONOTUSE) {
+    if (isUmbrella) {
       parseStatus = umbrellaParseHeader(
           readBuffer_.data(), readBuffer_.length(), umMsgInfo_);
     } else {
@@ -141,7 +179,7 @@ bool McParser::readUmbrellaOrCaretData() {
     // Case 1: Entire message (and possibly part of next) is in the buffer
     if (readBuffer_.length() >= messageSize) {
       if (UNLIKELY(debugFifo_ && debugFifo_->isConnected())) {
-        if (protocol_ == mc_umbrella_protocol_DONOTUSE) {
+        if (isUmbrella) {
           const auto mc_op = umbrellaDetermineOperation(
               readBuffer_.data(), umMsgInfo_.headerSize);
           umMsgInfo_.typeId = mcOpToRequestTypeId(mc_op);
@@ -157,7 +195,7 @@ bool McParser::readUmbrellaOrCaretData() {
       }
 
       bool cbStatus;
-      if (protocol_ == mc_umbrella_protocol_DONOTUSE) {
+      if (isUmbrella) {
         cbStatus = callback_.umMessageReady(umMsgInfo_, readBuffer_);
       } else {
         cbStatus = callback_.caretMessageReady(umMsgInfo_, readBuffer_);
@@ -186,10 +224,15 @@ bool McParser::readUmbrellaOrCaretData() {
       readBuffer_.reserve(
           0 /* minHeadroom */,
           bufferSize_ - readBuffer_.length() /* minTailroom */);
+      readBufferIsNodump_ = false;
     }
 #ifdef FOLLY_JEMALLOC_NODUMP_ALLOCATOR_SUPPORTED
-    if (useJemallocNodumpAllocator_) {
+    if (useJemallocNodumpAllocator_ && !readBufferIsNodump_) {
+      // Copy once per (re)allocation, not once per read: a multi-MB body
+      // arriving in small reads used to be re-copied into a fresh nodump
+      // buffer on every loop, quadratic in the value size.
       readBuffer_ = copyToNodumpBuffer(umMsgInfo_, readBuffer_);
+      readBufferIsNodump_ = true;
     }
 #endif
     return true;
@@ -203,6 +246,7 @@ bool McParser::readUmbrellaOrCaretData() {
       lastShrinkCycles_ = curCycles;
       bufferSize_ = maxBufferSize_;
       readBuffer_ = folly::IOBuf(folly::IOBuf::CREATE, bufferSize_);
+      readBufferIsNodump_ = false;
     }
   }
   return true;
@@ -211,6 +255,7 @@ bool McParser::readUmbrellaOrCaretData() {
 bool McParser::readDataAvailable(size_t len) {
   // Caller is responsible for ensuring the read buffer has enough tailroom
   readBuffer_.append(len);
+  bytesPerReadEwma_ = (bytesPerReadEwma_ * 7 + len) / 8;
   if (UNLIKELY(readBuffer_.length() == 0)) {
     return true;
   }
@@ -119,6 +119,18 @@ class McParser {
     debugFifo_ = fifo;
   }
 
+  /**
+   * Hints how many bytes the caller expects to arrive, e.g. estimated
+   * from the number of outstanding replies on the connection. The next
+   * getReadBuffer() offers at least this much tailroom (capped at
+   * maxBufferSize), so a burst of replies lands in one read instead of
+   * several buffer-sized ones. The hint does not affect bufferSize_
+   * adaptation and is cleared once consumed.
+   */
+  void setReadAheadHint(size_t bytes) {
+    readAheadHint_ = bytes;
+  }
+
  private:
   bool seenFirstByte_{false};
   bool outOfOrder_{false};
@@ -126,9 +138,20 @@ class McParser {
   mc_protocol_t protocol_{mc_unknown_protocol};
 
   ParserCallback& callback_;
+  size_t minBufferSize_{256};
   size_t bufferSize_{256};
   size_t maxBufferSize_{4096};
 
+  /**
+   * Exponentially weighted moving average of bytes obtained per read.
+   * Used to adapt bufferSize_ to the connection's observed throughput,
+   * so chatty and bulk clients on the same port each get a fitting size.
+   */
+  size_t bytesPerReadEwma_{0};
+
+  /** One-shot expected-bytes hint for the next getReadBuffer() */
+  size_t readAheadHint_{0};
+
   ConnectionFifo* debugFifo_{nullptr};
 
   uint64_t lastShrinkCycles_{0};
@@ -145,7 +168,20 @@ class McParser {
    */
   bool useJemallocNodumpAllocator_{false};
 
+  /**
+   * True while readBuffer_'s memory came from the nodump allocator.
+   * Lets us copy a large in-flight message into a nodump buffer once,
+   * instead of once per read while its body trickles in.
+   */
+  bool readBufferIsNodump_{false};
+
   bool readUmbrellaOrCaretData();
+
+  /**
+   * Grow or shrink bufferSize_ within [minBufferSize_, maxBufferSize_]
+   * based on bytesPerReadEwma_.
+   */
+  void adjustBufferSize();
 };
 
 inline McParser::ParserCallback::~ParserCallback() {}
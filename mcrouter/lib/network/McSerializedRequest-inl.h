@@ -59,7 +59,9 @@ McSerializedRequest::McSerializedRequest(
     size_t reqId,
     mc_protocol_t protocol,
     const CodecIdRange& compressionCodecs,
-    PayloadFormat payloadFormat)
+    PayloadFormat payloadFormat,
+    size_t tcpZeroCopyThreshold,
+    SerializedRequestBodyCache* bodyCache)
     : protocol_(protocol), typeId_(Request::typeId) {
   switch (protocol_) {
     case mc_ascii_protocol:
@@ -77,13 +79,15 @@ McSerializedRequest::McSerializedRequest(
       if (detail::getKeySize(req) > MC_KEY_MAX_LEN_UMBRELLA) {
         return;
       }
+      caretRequest_.setTCPZeroCopyThreshold(tcpZeroCopyThreshold);
       if (!caretRequest_.prepare(
               req,
               reqId,
               compressionCodecs,
               iovsBegin_,
               iovsCount_,
-              payloadFormat)) {
+              payloadFormat,
+              bodyCache)) {
         result_ = Result::ERROR;
       }
       break;
@@ -36,6 +36,12 @@ class McSerializedRequest {
    * @param protocol          Protocol to serialize the request.
    * @param supportedCodecs   Range of supported compression codecs.
    *                          Only used for caret.
+   * @param tcpZeroCopyThreshold  If > 0, mark the request for zero copy
+   *                          writes when it contains a buffer of at least
+   *                          that many bytes.  Only used for caret.
+   * @param bodyCache         Optional serialized-body cache shared across
+   *                          resends of the same request; see
+   *                          SerializedRequestBodyCache. Only used for caret.
    */
   template <class Request>
   McSerializedRequest(
@@ -43,7 +49,9 @@ class McSerializedRequest {
       size_t reqId,
       mc_protocol_t protocol,
       const CodecIdRange& supportedCodecs,
-      PayloadFormat payloadFormat = PayloadFormat::Carbon);
+      PayloadFormat payloadFormat = PayloadFormat::Carbon,
+      size_t tcpZeroCopyThreshold = 0,
+      SerializedRequestBodyCache* bodyCache = nullptr);
 
   ~McSerializedRequest();
 
@@ -66,6 +74,24 @@ class McSerializedRequest {
     return typeId_;
   }
 
+  /**
+   * True if the request was marked for zero copy writes, i.e. it is a caret
+   * request containing a buffer of at least tcpZeroCopyThreshold bytes.
+   */
+  bool shouldApplyZeroCopy() const {
+    return protocol_ == mc_caret_protocol && caretRequest_.shouldApplyZeroCopy();
+  }
+
+  /**
+   * IOBuf chain sharing ownership of the serialized data.  Unlike the iovecs,
+   * the chain stays valid after this request is destroyed, so the kernel can
+   * keep referencing the pages during a zero copy write.  Caret only.
+   */
+  std::unique_ptr<folly::IOBuf> createOwnedIOBufChain() {
+    assert(protocol_ == mc_caret_protocol);
+    return caretRequest_.createOwnedIOBufChain();
+  }
+
   size_t getBodySize();
 
  private:
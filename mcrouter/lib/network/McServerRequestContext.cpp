@@ -41,6 +41,7 @@ McServerRequestContext::McServerRequestContext(
       noReply_(other.noReply_),
       replied_(other.replied_),
       reqid_(other.reqid_),
+      inFlightBytes_(other.inFlightBytes_),
       asciiState_(std::move(other.asciiState_)) {
   other.session_ = nullptr;
 }
@@ -52,6 +53,7 @@ McServerRequestContext& McServerRequestContext::operator=(
   reqid_ = other.reqid_;
   noReply_ = other.noReply_;
   replied_ = other.replied_;
+  inFlightBytes_ = other.inFlightBytes_;
   asciiState_ = std::move(other.asciiState_);
 
   other.session_ = nullptr;
@@ -63,10 +65,20 @@ McServerRequestContext::~McServerRequestContext() {
   if (session_) {
     /* Check that a reply was returned */
     assert(replied_);
+    if (inFlightBytes_ > 0) {
+      session_->creditInFlightBytes(inFlightBytes_);
+    }
     session_->onTransactionCompleted(hasParent() || isEndContext_);
   }
 }
 
+void McServerRequestContext::chargeInFlightBytes(size_t bytes) {
+  if (session_ && bytes > 0) {
+    inFlightBytes_ = bytes;
+    session_->chargeInFlightBytes(bytes);
+  }
+}
+
 // Note: defined in .cpp in order to avoid circular dependency between
 // McServerRequestContext.h and MultiOpParent.h.
 bool McServerRequestContext::moveReplyToParent(
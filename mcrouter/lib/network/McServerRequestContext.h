@@ -68,6 +68,9 @@ class McServerRequestContext {
   bool replied_{false};
 
   uint64_t reqid_;
+  // Bytes charged against the session's in-flight byte budget; credited
+  // back when the transaction completes.
+  size_t inFlightBytes_{0};
   struct AsciiState {
     std::shared_ptr<MultiOpParent> parent_;
     folly::Optional<folly::IOBuf> key_;
@@ -111,6 +114,12 @@ class McServerRequestContext {
   }
   bool isParentError() const;
 
+  /**
+   * Charges the given number of bytes against the session's in-flight
+   * byte budget for the lifetime of this transaction.
+   */
+  void chargeInFlightBytes(size_t bytes);
+
   // Whether or not *this is used to mark the end of a multi-get request
   bool isEndContext() const {
     return isEndContext_;
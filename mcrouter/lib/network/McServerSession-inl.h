@@ -33,13 +33,30 @@ void McServerSession::asciiRequestReady(
   }
 
   if (carbon::GetLike<Request>::value && !currentMultiop_) {
-    currentMultiop_ = std::make_shared<MultiOpParent>(*this, tailReqid_++);
+    // Reuse the previous operation's parent (object plus shared_ptr
+    // control block) once every one of its sub-requests has released
+    // it. One multiget usually completes before the next one starts on
+    // a session, so steady-state multigets allocate nothing here.
+    if (multiOpParentCache_ && multiOpParentCache_.use_count() == 1) {
+      multiOpParentCache_->reset(tailReqid_++);
+      currentMultiop_ = multiOpParentCache_;
+    } else {
+      currentMultiop_ = std::make_shared<MultiOpParent>(
+          *this, tailReqid_++, options_.multiOpStreaming);
+      multiOpParentCache_ = currentMultiop_;
+    }
   }
   uint64_t reqid;
   reqid = tailReqid_++;
 
   McServerRequestContext ctx(*this, reqid, noreply, currentMultiop_);
 
+  // The value dominates the memory footprint of large requests; the
+  // exact wire size is not available at this layer.
+  if (const auto* value = carbon::valuePtrUnsafe(req)) {
+    ctx.chargeInFlightBytes(value->computeChainDataLength());
+  }
+
   ctx.asciiKey().emplace(req.key().raw().cloneOneAsValue());
 
   if (result == mc_res_bad_key) {
@@ -65,6 +82,9 @@ void McServerSession::umbrellaRequestReady(Request&& req, uint64_t reqid) {
   }
 
   McServerRequestContext ctx(*this, reqid);
+  if (const auto* value = carbon::valuePtrUnsafe(req)) {
+    ctx.chargeInFlightBytes(value->computeChainDataLength());
+  }
 
   umbrellaRequestReadyImpl(std::move(ctx), std::move(req));
 }
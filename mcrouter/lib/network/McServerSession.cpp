@@ -8,6 +8,7 @@
 
 #include <memory>
 
+#include <folly/ScopeGuard.h>
 #include <folly/io/async/AsyncSSLSocket.h>
 #include <folly/small_vector.h>
 
@@ -134,22 +135,65 @@ SecurityMech McServerSession::securityMech() const noexcept {
   return SecurityMech::NONE;
 }
 
+bool McServerSession::parseAheadEnabled() const {
+  return options_.maxParseAheadBytes > 0 &&
+      parser_.protocol() == mc_caret_protocol;
+}
+
 void McServerSession::pause(PauseReason reason) {
   pauseState_ |= static_cast<uint64_t>(reason);
 
+  if (pauseState_ == PAUSE_THROTTLED && parseAheadEnabled() &&
+      parseAheadBytes_ < options_.maxParseAheadBytes) {
+    /* Only dispatch is throttled and there's parse-ahead budget left:
+       keep reading, caretRequestReady() queues parsed requests instead
+       of dispatching them. */
+    return;
+  }
   transport_->setReadCB(nullptr);
 }
 
 void McServerSession::resume(PauseReason reason) {
   pauseState_ &= ~static_cast<uint64_t>(reason);
 
+  if (!(pauseState_ & PAUSE_THROTTLED) && !parseAheadQueue_.empty()) {
+    /* May throttle again partway through, setting PAUSE_THROTTLED. */
+    drainParseAhead();
+  }
+
   /* Client can half close the socket and in those cases there is
      no point in enabling reads */
-  if (!pauseState_ && state_ == STREAMING && transport_->good()) {
+  const bool canRead = pauseState_ == 0 ||
+      (pauseState_ == PAUSE_THROTTLED && parseAheadEnabled() &&
+       parseAheadBytes_ < options_.maxParseAheadBytes);
+  if (canRead && state_ == STREAMING && transport_->good()) {
     transport_->setReadCB(this);
   }
 }
 
+void McServerSession::drainParseAhead() {
+  if (drainingParseAhead_) {
+    /* Dispatching below can complete a transaction synchronously, whose
+       resume() would recurse back in here. */
+    return;
+  }
+  drainingParseAhead_ = true;
+  SCOPE_EXIT {
+    drainingParseAhead_ = false;
+  };
+  DestructorGuard dg(this);
+
+  while (!parseAheadQueue_.empty() && !(pauseState_ & PAUSE_THROTTLED) &&
+         state_ == STREAMING) {
+    auto req = std::move(parseAheadQueue_.front());
+    parseAheadQueue_.pop_front();
+    const size_t wireSize = req.headerInfo.headerSize + req.headerInfo.bodySize;
+    assert(parseAheadBytes_ >= wireSize);
+    parseAheadBytes_ -= wireSize;
+    dispatchCaretRequest(req.headerInfo, *req.body);
+  }
+}
+
 void McServerSession::onTransactionStarted(bool isSubRequest) {
   ++inFlight_;
   if (options_.maxInFlight > 0 && !isSubRequest) {
@@ -187,7 +231,9 @@ void McServerSession::onTransactionCompleted(bool isSubRequest) {
   --inFlight_;
   if (options_.maxInFlight > 0 && !isSubRequest) {
     assert(realRequestsInFlight_ > 0);
-    if (--realRequestsInFlight_ < options_.maxInFlight) {
+    if (--realRequestsInFlight_ < options_.maxInFlight &&
+        (options_.maxInFlightBytes == 0 ||
+         inFlightBytes_ < options_.maxInFlightBytes)) {
       resume(PAUSE_THROTTLED);
     }
   }
@@ -195,6 +241,26 @@ void McServerSession::onTransactionCompleted(bool isSubRequest) {
   checkClosed();
 }
 
+void McServerSession::chargeInFlightBytes(size_t bytes) {
+  inFlightBytes_ += bytes;
+  if (options_.maxInFlightBytes > 0 &&
+      inFlightBytes_ >= options_.maxInFlightBytes) {
+    DestructorGuard dg(this);
+    pause(PAUSE_THROTTLED);
+  }
+}
+
+void McServerSession::creditInFlightBytes(size_t bytes) {
+  assert(inFlightBytes_ >= bytes);
+  inFlightBytes_ -= bytes;
+  if (options_.maxInFlightBytes > 0 &&
+      inFlightBytes_ < options_.maxInFlightBytes &&
+      (options_.maxInFlight == 0 ||
+       realRequestsInFlight_ < options_.maxInFlight)) {
+    resume(PAUSE_THROTTLED);
+  }
+}
+
 void McServerSession::reply(std::unique_ptr<WriteBuffer> wb, uint64_t reqid) {
   DestructorGuard dg(this);
 
@@ -204,15 +270,27 @@ void McServerSession::reply(std::unique_ptr<WriteBuffer> wb, uint64_t reqid) {
     if (reqid == headReqid_) {
       /* head of line reply, write it and all contiguous blocked replies */
       queueWrite(std::move(wb));
-      auto it = blockedReplies_.find(++headReqid_);
-      while (it != blockedReplies_.end()) {
-        queueWrite(std::move(it->second));
-        blockedReplies_.erase(it);
-        it = blockedReplies_.find(++headReqid_);
+      ++headReqid_;
+      if (!blockedReplies_.empty()) {
+        /* drop the (empty) slot of the reply just written, then drain the
+           window in a single pass until the next hole.  An engaged slot
+           holding null is a parked noReply reply (e.g. a multiget miss):
+           it consumes its reqid, and queueWrite(nullptr) writes nothing. */
+        blockedReplies_.pop_front();
+        while (!blockedReplies_.empty() &&
+               blockedReplies_.front().hasValue()) {
+          queueWrite(std::move(blockedReplies_.front().value()));
+          blockedReplies_.pop_front();
+          ++headReqid_;
+        }
       }
     } else {
-      /* can't write this reply now, save for later */
-      blockedReplies_.emplace(reqid, std::move(wb));
+      /* can't write this reply now, save it in its window slot */
+      const size_t offset = reqid - headReqid_;
+      if (offset >= blockedReplies_.size()) {
+        blockedReplies_.resize(offset + 1);
+      }
+      blockedReplies_[offset] = std::move(wb);
     }
   }
 }
@@ -353,7 +431,27 @@ void McServerSession::caretRequestReady(
     return;
   }
 
+  if ((pauseState_ & PAUSE_THROTTLED) && parseAheadEnabled()) {
+    /* Dispatch is throttled; queue the parsed request so it goes out the
+       moment the throttle lifts, instead of paying parse latency then.
+       clone() shares the parser's buffer, so this copies no data. */
+    parseAheadBytes_ += headerInfo.headerSize + headerInfo.bodySize;
+    parseAheadQueue_.push_back(ParsedRequest{headerInfo, reqBody.clone()});
+    if (parseAheadBytes_ >= options_.maxParseAheadBytes) {
+      /* Budget exhausted; stop reading until dispatch resumes. */
+      transport_->setReadCB(nullptr);
+    }
+    return;
+  }
+
+  dispatchCaretRequest(headerInfo, reqBody);
+}
+
+void McServerSession::dispatchCaretRequest(
+    const UmbrellaMessageInfo& headerInfo,
+    const folly::IOBuf& reqBody) {
   McServerRequestContext ctx(*this, headerInfo.reqId);
+  ctx.chargeInFlightBytes(headerInfo.headerSize + headerInfo.bodySize);
 
   if (McVersionRequest::typeId == headerInfo.typeId &&
       options_.defaultVersionHandler) {
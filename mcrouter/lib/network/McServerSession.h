@@ -6,8 +6,11 @@
  */
 #pragma once
 
+#include <deque>
+
 #include <fizz/server/AsyncFizzServer.h>
 #include <folly/IntrusiveList.h>
+#include <folly/Optional.h>
 #include <folly/io/async/AsyncSSLSocket.h>
 #include <folly/io/async/AsyncSocket.h>
 #include <folly/io/async/AsyncTransport.h>
@@ -43,6 +46,7 @@ class McServerSession
       private folly::AsyncTransportWrapper::WriteCallback {
  private:
   folly::SafeIntrusiveListHook hook_;
+  uint64_t idleGeneration_{0};
 
  public:
   using Queue =
@@ -111,6 +115,17 @@ class McServerSession
     return hook_.is_linked();
   }
 
+  /**
+   * Activity generation stamp maintained by the session's owner for
+   * idle tracking (see ConnectionTracker). Opaque to the session.
+   */
+  uint64_t idleGeneration() const noexcept {
+    return idleGeneration_;
+  }
+  void setIdleGeneration(uint64_t generation) noexcept {
+    idleGeneration_ = generation;
+  }
+
   /**
    * Creates a new session.
    * Sessions manage their own lifetime.
@@ -307,6 +322,14 @@ class McServerSession
    */
   size_t realRequestsInFlight_{0};
 
+  /**
+   * Total request bytes of alive McTransactions, as charged by
+   * chargeInFlightBytes(). Used together with realRequestsInFlight_ to
+   * make throttling decisions: a few huge sets should apply the same
+   * backpressure as many small requests.
+   */
+  size_t inFlightBytes_{0};
+
   struct SendWritesCallback : public folly::EventBase::LoopCallback {
     explicit SendWritesCallback(McServerSession& session) : session_(session) {}
     void runLoopCallback() noexcept final {
@@ -324,9 +347,21 @@ class McServerSession
     PAUSE_USER = 1 << 2,
   };
 
-  /* Reads are enabled iff pauseState_ == 0 */
+  /* Reads are enabled iff pauseState_ == 0, or iff only PAUSE_THROTTLED
+     is set and parse-ahead still has budget (see pause()). */
   uint64_t pauseState_{0};
 
+  /* Caret requests parsed while dispatch was throttled, oldest first.
+     Bodies share the parser's buffers (no copy); parseAheadBytes_ holds
+     their wire size against options_.maxParseAheadBytes. */
+  struct ParsedRequest {
+    UmbrellaMessageInfo headerInfo;
+    std::unique_ptr<folly::IOBuf> body;
+  };
+  std::deque<ParsedRequest> parseAheadQueue_;
+  size_t parseAheadBytes_{0};
+  bool drainingParseAhead_{false};
+
   // Compression
   const CompressionCodecMap* compressionCodecMap_{nullptr};
   CodecIdRange codecIdRange_ = CodecIdRange::Empty;
@@ -337,14 +372,26 @@ class McServerSession
 
   /* headReqid_ <= tailReqid_.  Since we must output replies sequentially,
      headReqid_ tracks the last reply id we're allowed to sent out.
-     Out of order replies are stalled in the blockedReplies_ queue. */
+     Out of order replies are stalled in the blockedReplies_ window: since
+     reqids are assigned sequentially, slot i holds the reply for
+     headReqid_ + i (slot 0 is always empty — the head reply is written
+     straight through).  An ascii multiget fans a dense burst of reqids
+     through here, so indexing by offset avoids a hash map operation per
+     sub-reply.  Slots are Optional because a parked reply may itself be
+     null (noReply ops, multiget misses): an engaged null slot consumes
+     its reqid and writes nothing, while an empty slot is a hole the
+     drain must stop at. */
   uint64_t headReqid_{0}; /**< Id of next unblocked reply */
   uint64_t tailReqid_{0}; /**< Id to assign to next request */
-  std::unordered_map<uint64_t, std::unique_ptr<WriteBuffer>> blockedReplies_;
+  std::deque<folly::Optional<std::unique_ptr<WriteBuffer>>> blockedReplies_;
 
   /* If non-null, a multi-op operation is being parsed.*/
   std::shared_ptr<MultiOpParent> currentMultiop_;
 
+  /* Retains the last multi-op parent so the next operation on this
+     session can reuse the allocation once all sub-requests released it. */
+  std::shared_ptr<MultiOpParent> multiOpParentCache_;
+
   folly::SocketAddress socketAddress_;
 
   /**
@@ -407,6 +454,28 @@ class McServerSession
       const UmbrellaMessageInfo& headerInfo,
       const folly::IOBuf& reqBody);
 
+  /**
+   * The dispatch half of caretRequestReady(): creates the request
+   * context and hands the request to the application. Runs either
+   * straight from the parser or from drainParseAhead().
+   */
+  void dispatchCaretRequest(
+      const UmbrellaMessageInfo& headerInfo,
+      const folly::IOBuf& reqBody);
+
+  /**
+   * True if this session may keep parsing requests while dispatch is
+   * throttled: a budget is configured and the protocol is caret (ascii
+   * multi-op parser state makes deferred dispatch unsafe).
+   */
+  bool parseAheadEnabled() const;
+
+  /**
+   * Dispatches queued parse-ahead requests until the queue is empty or
+   * dispatch gets throttled again.
+   */
+  void drainParseAhead();
+
   void processConnectionControlMessage(const UmbrellaMessageInfo& headerInfo);
 
   void parseError(mc_res_t result, folly::StringPiece reason);
@@ -463,6 +532,14 @@ class McServerSession
   void onTransactionStarted(bool isSubRequest);
   void onTransactionCompleted(bool isSubRequest);
 
+  /**
+   * Byte-weighted admission, mirroring the request-count throttle above.
+   * Called by McServerRequestContext when a transaction's size is known
+   * (charge) and when it completes (credit).
+   */
+  void chargeInFlightBytes(size_t bytes);
+  void creditInFlightBytes(size_t bytes);
+
   void writeToDebugFifo(const WriteBuffer* wb) noexcept;
 
   /**
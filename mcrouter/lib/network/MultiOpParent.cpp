@@ -10,8 +10,17 @@
 namespace facebook {
 namespace memcache {
 
-MultiOpParent::MultiOpParent(McServerSession& session, uint64_t blockReqid)
-    : session_(session), block_(session, blockReqid, true /* noReply */) {}
+MultiOpParent::MultiOpParent(
+    McServerSession& session,
+    uint64_t blockReqid,
+    bool streaming)
+    : streaming_(streaming),
+      session_(session),
+      block_(session, blockReqid, true /* noReply */) {
+  if (streaming_) {
+    unblock();
+  }
+}
 
 bool MultiOpParent::reply(
     mc_res_t result,
@@ -39,6 +48,17 @@ bool MultiOpParent::reply(
   return stolen;
 }
 
+void MultiOpParent::reset(uint64_t blockReqid) {
+  assert(waiting_ == 0);
+  reply_.clear();
+  error_ = false;
+  block_ = McServerRequestContext(session_, blockReqid, true /* noReply */);
+  end_.clear();
+  if (streaming_) {
+    unblock();
+  }
+}
+
 void MultiOpParent::recordEnd(uint64_t reqid) {
   end_ = McServerRequestContext(
       session_,
@@ -56,8 +76,17 @@ void MultiOpParent::release() {
     reply_.emplace(mc_res_found);
   }
   McServerRequestContext::reply(std::move(*end_), std::move(*reply_));
-  // It doesn't really matter what reply type we use for the multi-op
-  // blocking context
+  if (!streaming_) {
+    // It doesn't really matter what reply type we use for the multi-op
+    // blocking context
+    McServerRequestContext::reply(std::move(block_), McGetReply());
+  }
+}
+
+void MultiOpParent::unblock() {
+  // Streaming mode: let sub-replies through immediately instead of
+  // holding them behind the head-of-line blocking context until the
+  // whole multi-op completes.
   McServerRequestContext::reply(std::move(block_), McGetReply());
 }
 }
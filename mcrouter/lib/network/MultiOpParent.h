@@ -43,10 +43,20 @@ class McServerSession;
  * write anything to the transport (same as if 'noreply' was set).
  *
  * Finally the end context will write out the stored error reply.
+ *
+ * In streaming mode the block_ctx is released right away, so each hit
+ * is written (in request order) as soon as it completes; only END and
+ * any error reply wait for the whole operation. An error observed after
+ * some hits were already flushed is still reported in place of END, but
+ * can no longer retract what's on the wire - that's the tradeoff for
+ * not gating fast sub-requests on the slowest one.
  */
 class MultiOpParent {
  public:
-  MultiOpParent(McServerSession& session, uint64_t blockReqid);
+  MultiOpParent(
+      McServerSession& session,
+      uint64_t blockReqid,
+      bool streaming = false);
 
   /**
    * Examine the reply result of one of the sub-requests. If it's an error
@@ -78,16 +88,26 @@ class MultiOpParent {
     return error_;
   }
 
+  /**
+   * Reinitialize this parent for a new multi-op operation on the same
+   * session, as if freshly constructed with the given block request id.
+   * Only valid once every sub-request of the previous operation has
+   * released its reference.
+   */
+  void reset(uint64_t blockReqid);
+
  private:
   size_t waiting_{0};
   folly::Optional<McGetReply> reply_;
   bool error_{false};
+  const bool streaming_;
 
   McServerSession& session_;
   McServerRequestContext block_;
   folly::Optional<McServerRequestContext> end_;
 
   void release();
+  void unblock();
 };
 }
 } // facebook::memcache
@@ -6,6 +6,8 @@
  */
 #include "ThreadLocalSSLContextProvider.h"
 
+#include <array>
+#include <memory>
 #include <unordered_map>
 
 #include <folly/Singleton.h>
@@ -16,6 +18,7 @@
 #include <folly/ssl/Init.h>
 #include <wangle/client/persistence/SharedMutexCacheLockGuard.h>
 #include <wangle/client/ssl/SSLSessionCacheData.h>
+#include <wangle/client/ssl/SSLSessionCallbacks.h>
 #include <wangle/client/ssl/SSLSessionPersistentCache.h>
 #include <wangle/ssl/SSLCacheOptions.h>
 #include <wangle/ssl/SSLContextConfig.h>
@@ -214,16 +217,69 @@ class SSLTicketCache
   }
 };
 
+// Ticket cache sharded by session identity. All proxy threads share one
+// process-wide cache (so a session established on any thread resumes on
+// every thread); sharding keeps them from serializing on a single LRU
+// lock during handshake storms, e.g. right after a restart.
+class ShardedSSLTicketCache : public wangle::SSLSessionCallbacks {
+ public:
+  ShardedSSLTicketCache() {
+    for (auto& shard : shards_) {
+      auto cacheLayer = std::make_shared<TicketCacheLayer>(
+          wangle::PersistentCacheConfig::Builder()
+              .setCapacity(kShardCapacity)
+              .build());
+      cacheLayer->init();
+      shard = std::make_unique<SSLTicketCache>(std::move(cacheLayer));
+    }
+  }
+
+  void setSSLSession(const std::string& identity, wangle::SSLSessionPtr session)
+      noexcept override {
+    shardFor(identity).setSSLSession(identity, std::move(session));
+  }
+
+  wangle::SSLSessionPtr getSSLSession(const std::string& identity) const
+      noexcept override {
+    return shardFor(identity).getSSLSession(identity);
+  }
+
+  bool removeSSLSession(const std::string& identity) noexcept override {
+    return shardFor(identity).removeSSLSession(identity);
+  }
+
+  bool supportsPersistence() const noexcept override {
+    // Same answer for every shard; preserves whatever the underlying
+    // cache reports.
+    return shards_[0]->supportsPersistence();
+  }
+
+  size_t size() const override {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+      total += shard->size();
+    }
+    return total;
+  }
+
+ private:
+  constexpr static size_t kShards = 16;
+  // Sized so the total cache covers destination counts of our largest
+  // pools; a session per destination host is what makes resumption hit.
+  constexpr static size_t kShardCapacity = 128;
+
+  SSLTicketCache& shardFor(const std::string& identity) const {
+    return *shards_[folly::Hash()(identity) % kShards];
+  }
+
+  std::array<std::unique_ptr<SSLTicketCache>, kShards> shards_;
+};
+
 // global thread safe ticket cache
 // TODO(jmswen) Try to come up with a cleaner approach here that doesn't require
 // leaking.
-folly::LeakySingleton<SSLTicketCache> ticketCache([] {
-  // create cache layer of max size 100;
-  auto cacheLayer = std::make_shared<TicketCacheLayer>(
-      wangle::PersistentCacheConfig::Builder().setCapacity(100).build());
-  cacheLayer->init();
-  return new SSLTicketCache(std::move(cacheLayer));
-});
+folly::LeakySingleton<ShardedSSLTicketCache> ticketCache(
+    [] { return new ShardedSSLTicketCache(); });
 
 std::shared_ptr<SSLContext> createServerSSLContext(
     folly::StringPiece pemCertPath,
@@ -535,6 +535,71 @@ inline void parseFieldImpl(
   }
 }
 
+/**
+ * Dispatches one entry to the field handler appropriate for the
+ * operation/message pair. Control fields (reqid, op, fbtrace) are no-ops
+ * here; callers handle them before getting to this switch.
+ */
+template <class Op, class Message>
+void parseDataField(
+    Op,
+    Message& message,
+    size_t tag,
+    const folly::IOBuf& source,
+    const uint8_t* body,
+    const um_elist_entry_t& entry) {
+  using Handler = FieldPolicyHandler<typename TagSet<Op, Message>::Tags>;
+  switch (tag) {
+    case msg_cas:
+      Handler::parseField(Op(), CasTag(), message, source, body, entry);
+      break;
+    case msg_delta:
+      Handler::parseField(Op(), DeltaTag(), message, source, body, entry);
+      break;
+    case msg_err_code:
+      Handler::parseField(Op(), ErrCodeTag(), message, source, body, entry);
+      break;
+    case msg_exptime:
+      Handler::parseField(Op(), ExptimeTag(), message, source, body, entry);
+      break;
+    case msg_flags:
+      Handler::parseField(Op(), FlagsTag(), message, source, body, entry);
+      break;
+    case msg_lease_id:
+      Handler::parseField(Op(), LeaseTokenTag(), message, source, body, entry);
+      break;
+    case msg_number:
+      Handler::parseField(Op(), NumberTag(), message, source, body, entry);
+      break;
+    case msg_result:
+      Handler::parseField(Op(), ResultTag(), message, source, body, entry);
+      break;
+    case msg_value:
+      Handler::parseField(Op(), ValueTag(), message, source, body, entry);
+      break;
+#ifndef LIBMC_FBTRACE_DISABLE
+    case msg_fbtrace:
+      // Handled by the caller where fbtrace makes sense.
+      break;
+#endif
+    case msg_key:
+      Handler::parseField(Op(), KeyTag(), message, source, body, entry);
+      break;
+    case msg_op:
+      // Handled by the caller.
+      break;
+    case msg_reqid:
+      // Handled by the caller.
+      break;
+    case msg_stats:
+      // We never expect stats.
+      break;
+    default:;
+      // Silently ignore all other fields.
+      break;
+  }
+}
+
 template <class Message, class Op>
 void umbrellaParseMessage(
     Message& message,
@@ -550,62 +615,12 @@ void umbrellaParseMessage(
       header + nheader) {
     throw std::runtime_error("Invalid number of entries");
   }
-  using Handler = FieldPolicyHandler<typename TagSet<Op, Message>::Tags>;
   for (size_t i = 0; i < nentries; ++i) {
     // Process entries in the reverse order, since it's easier to handle
     // double fields that way.
     auto& entry = msg->entries[nentries - i - 1];
     size_t tag = folly::Endian::big((uint16_t)entry.tag);
-    switch (tag) {
-      case msg_cas:
-        Handler::parseField(Op(), CasTag(), message, source, body, entry);
-        break;
-      case msg_delta:
-        Handler::parseField(Op(), DeltaTag(), message, source, body, entry);
-        break;
-      case msg_err_code:
-        Handler::parseField(Op(), ErrCodeTag(), message, source, body, entry);
-        break;
-      case msg_exptime:
-        Handler::parseField(Op(), ExptimeTag(), message, source, body, entry);
-        break;
-      case msg_flags:
-        Handler::parseField(Op(), FlagsTag(), message, source, body, entry);
-        break;
-      case msg_lease_id:
-        Handler::parseField(
-            Op(), LeaseTokenTag(), message, source, body, entry);
-        break;
-      case msg_number:
-        Handler::parseField(Op(), NumberTag(), message, source, body, entry);
-        break;
-      case msg_result:
-        Handler::parseField(Op(), ResultTag(), message, source, body, entry);
-        break;
-      case msg_value:
-        Handler::parseField(Op(), ValueTag(), message, source, body, entry);
-        break;
-#ifndef LIBMC_FBTRACE_DISABLE
-      case msg_fbtrace:
-        // For requests, we should have previously parsed fbtrace.
-        break;
-#endif
-      case msg_key:
-        Handler::parseField(Op(), KeyTag(), message, source, body, entry);
-        break;
-      case msg_op:
-        // For requests, we should have previously parsed operation.
-        break;
-      case msg_reqid:
-        // ReqId is parsed prior to calling this function.
-        break;
-      case msg_stats:
-        // We never expect stats.
-        break;
-      default:;
-        // Silently ignore all other fields.
-        break;
-    }
+    parseDataField(Op(), message, tag, source, body, entry);
   }
 }
 
@@ -769,46 +784,59 @@ Request umbrellaParseRequest(
     throw std::runtime_error("Invalid number of entries");
   }
 
-  // In first pass, only look for msg_reqid or msg_op. Then, we'll dispatch
-  // to the appropriate field handlers in umbrellaParseMessage().
+  // Single pass over the entry list: control fields (reqid, op, fbtrace)
+  // are picked up inline, everything else goes to the per-field handlers.
+  // Entries are processed in reverse order; see umbrellaParseMessage().
   for (size_t i = 0; i < nentries; ++i) {
-    const auto& entry = msg->entries[i];
+    const auto& entry = msg->entries[nentries - i - 1];
     const size_t tag = folly::Endian::big((uint16_t)entry.tag);
 
-    if (tag == msg_reqid) {
-      const size_t val = folly::Endian::big((uint64_t)entry.data.val);
-      if (val == 0) {
-        throw std::runtime_error("invalid reqid");
-      }
-      reqidOut = val;
-    }
-
-    if (tag == msg_op) {
-      const size_t val = folly::Endian::big((uint64_t)entry.data.val);
-      if (val >= UM_NOPS) {
-        throw std::runtime_error("op out of range");
-      }
-      op = static_cast<mc_op_t>(umbrella_op_to_mc[val]);
-      assert(op == Op::mc_op);
-    }
+    switch (tag) {
+      case msg_reqid: {
+        const size_t val = folly::Endian::big((uint64_t)entry.data.val);
+        if (val == 0) {
+          throw std::runtime_error("invalid reqid");
+        }
+        // We iterate in reverse, so the first reqid seen is the last one
+        // on the wire, matching the old forward scan.
+        if (reqidOut == 0) {
+          reqidOut = val;
+        }
+      } break;
+
+      case msg_op: {
+        const size_t val = folly::Endian::big((uint64_t)entry.data.val);
+        if (val >= UM_NOPS) {
+          throw std::runtime_error("op out of range");
+        }
+        op = static_cast<mc_op_t>(umbrella_op_to_mc[val]);
+        assert(op == Op::mc_op);
+      } break;
 
 #ifndef LIBMC_FBTRACE_DISABLE
-    if (tag == msg_fbtrace) {
-      const auto off = folly::Endian::big((uint32_t)entry.data.str.offset);
-      const auto len = folly::Endian::big((uint32_t)entry.data.str.len) - 1;
-
-      if (len > FBTRACE_METADATA_SZ) {
-        throw std::runtime_error("Fbtrace metadata too large");
-      }
-      if (off + len > nbody || off + len < off) {
-        throw std::runtime_error("Fbtrace metadata field invalid");
-      }
-      auto fbtraceInfo = new_mc_fbtrace_info(0);
-      memcpy(fbtraceInfo->metadata, body + off, len);
-      req.setFbtraceInfo(fbtraceInfo);
-      break;
-    }
+      case msg_fbtrace: {
+        if (req.fbtraceInfo() != nullptr) {
+          break;
+        }
+        const auto off = folly::Endian::big((uint32_t)entry.data.str.offset);
+        const auto len = folly::Endian::big((uint32_t)entry.data.str.len) - 1;
+
+        if (len > FBTRACE_METADATA_SZ) {
+          throw std::runtime_error("Fbtrace metadata too large");
+        }
+        if (off + len > nbody || off + len < off) {
+          throw std::runtime_error("Fbtrace metadata field invalid");
+        }
+        auto fbtraceInfo = new_mc_fbtrace_info(0);
+        memcpy(fbtraceInfo->metadata, body + off, len);
+        req.setFbtraceInfo(fbtraceInfo);
+      } break;
 #endif
+
+      default:
+        detail::parseDataField(Op(), req, tag, source, body, entry);
+        break;
+    }
   }
 
   if (op == mc_op_unknown) {
@@ -819,9 +847,6 @@ Request umbrellaParseRequest(
     throw std::runtime_error("Request missing reqid");
   }
 
-  // Fill in request-specific fields in second pass
-  detail::umbrellaParseMessage(req, Op(), source, header, nheader, body, nbody);
-
   return req;
 }
 }
@@ -8,6 +8,7 @@
 
 #include <folly/Expected.h>
 #include <folly/GroupVarint.h>
+#include <folly/Likely.h>
 #include <folly/Range.h>
 #include <folly/Varint.h>
 #include <folly/io/IOBuf.h>
@@ -155,6 +156,36 @@ size_t serializeAdditionalFields(
   return buf - destination;
 }
 
+/**
+ * Decodes one varint without per-byte bounds checks. The caller must
+ * guarantee that at least folly::kMaxVarintLength64 bytes are readable
+ * at 'p'. The first two bytes are unrolled since almost all caret
+ * additional fields (types and common values) fit in them.
+ *
+ * @return false if the varint is malformed (no terminating byte within
+ *         the maximum encoded length).
+ */
+inline bool decodeVarintUnchecked(const uint8_t*& p, uint64_t& value) {
+  value = *p++;
+  if (LIKELY(value < 0x80)) {
+    return true;
+  }
+  value &= 0x7f;
+  uint64_t b = *p++;
+  value |= (b & 0x7f) << 7;
+  if (LIKELY(b < 0x80)) {
+    return true;
+  }
+  for (int shift = 14; shift <= 63; shift += 7) {
+    b = *p++;
+    value |= (b & 0x7f) << shift;
+    if (b < 0x80) {
+      return true;
+    }
+  }
+  return false;
+}
+
 } // anonymous namespace
 
 UmbrellaParseStatus umbrellaParseHeader(
@@ -232,17 +263,33 @@ UmbrellaParseStatus caretParseHeader(
   resetAdditionalFields(headerInfo);
   for (uint32_t i = 0; i < additionalFields; i++) {
     size_t fieldType;
-    if (auto maybeFieldType = folly::tryDecodeVarint(range)) {
-      fieldType = *maybeFieldType;
-    } else {
-      return UmbrellaParseStatus::NOT_ENOUGH_DATA;
-    }
-
     size_t fieldValue;
-    if (auto maybeFieldValue = folly::tryDecodeVarint(range)) {
-      fieldValue = *maybeFieldValue;
+    if (LIKELY(range.size() >= 2 * folly::kMaxVarintLength64)) {
+      // Fast path: the pair is known to fit in the buffer, so decode it
+      // without the per-byte bounds checks of tryDecodeVarint().
+      auto* p = reinterpret_cast<const uint8_t*>(range.begin());
+      uint64_t type64;
+      uint64_t value64;
+      if (UNLIKELY(
+              !decodeVarintUnchecked(p, type64) ||
+              !decodeVarintUnchecked(p, value64))) {
+        return UmbrellaParseStatus::MESSAGE_PARSE_ERROR;
+      }
+      range.advance(reinterpret_cast<const char*>(p) - range.begin());
+      fieldType = type64;
+      fieldValue = value64;
     } else {
-      return UmbrellaParseStatus::NOT_ENOUGH_DATA;
+      if (auto maybeFieldType = folly::tryDecodeVarint(range)) {
+        fieldType = *maybeFieldType;
+      } else {
+        return UmbrellaParseStatus::NOT_ENOUGH_DATA;
+      }
+
+      if (auto maybeFieldValue = folly::tryDecodeVarint(range)) {
+        fieldValue = *maybeFieldValue;
+      } else {
+        return UmbrellaParseStatus::NOT_ENOUGH_DATA;
+      }
     }
 
     if (fieldType >
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <string>
 
 #include <folly/io/IOBuf.h>
@@ -155,6 +156,10 @@ class WriteBufferQueue {
     assert(
         tlFreeStack_ == &initFreeStack(protocol) &&
         "protocol changed or called from a different thread");
+    ++outstanding_;
+    if (outstanding_ > peakOutstanding_) {
+      peakOutstanding_ = outstanding_;
+    }
     if (tlFreeStack_->empty()) {
       return std::make_unique<WriteBuffer>(protocol);
     } else {
@@ -172,7 +177,8 @@ class WriteBufferQueue {
     bool done = false;
     do {
       assert(!empty());
-      if (tlFreeStack_->size() < kMaxFreeQueueSz) {
+      onBufferReleased();
+      if (tlFreeStack_->size() < freeStackLimit()) {
         auto& wb = tlFreeStack_->pushFront(queue_.popFront());
         done = wb.isEndOfBatch();
         wb.clear();
@@ -192,7 +198,8 @@ class WriteBufferQueue {
     bool done = false;
     do {
       assert(!zeroCopyQueue_.empty());
-      if (tlFreeStack_->size() < kMaxFreeQueueSz) {
+      onBufferReleased();
+      if (tlFreeStack_->size() < freeStackLimit()) {
         auto& wb = tlFreeStack_->pushFront(
             zeroCopyQueue_.extractAndAdvanceIterator(it));
         done = wb.isEndOfBatch();
@@ -213,10 +220,35 @@ class WriteBufferQueue {
 
  private:
   constexpr static size_t kMaxFreeQueueSz = 50;
+  constexpr static size_t kPeakDecayEvery = 4096;
+
+  /**
+   * How many buffers the thread-local freelist may hold.  A statically
+   * capped freelist forces one malloc/free pair per reply beyond the cap
+   * for sessions with deep pipelines (e.g. large multigets), so we let it
+   * grow to the recent peak of buffers in flight and decay the peak as
+   * traffic subsides.
+   */
+  size_t freeStackLimit() const noexcept {
+    return std::max(kMaxFreeQueueSz, peakOutstanding_);
+  }
+
+  void onBufferReleased() noexcept {
+    assert(outstanding_ > 0);
+    --outstanding_;
+    if (++releasesSincePeakDecay_ >= kPeakDecayEvery) {
+      releasesSincePeakDecay_ = 0;
+      // Decay towards the current level of traffic.
+      peakOutstanding_ = outstanding_ + (peakOutstanding_ - outstanding_) / 2;
+    }
+  }
 
   WriteBuffer::List* tlFreeStack_{nullptr};
   WriteBuffer::List queue_;
   WriteBuffer::List zeroCopyQueue_;
+  size_t outstanding_{0};
+  size_t peakOutstanding_{0};
+  size_t releasesSincePeakDecay_{0};
 
   static WriteBuffer::List& initFreeStack(mc_protocol_t protocol) noexcept;
 
@@ -178,4 +178,22 @@ TEST(AccessPoint, port_override) {
   EXPECT_TRUE(ap->useSsl());
 }
 
+TEST(AccessPoint, unique_id) {
+  auto ap1 = AccessPoint::create("127.0.0.1:12345", mc_ascii_protocol);
+  auto ap2 = AccessPoint::create("127.0.0.1:12345", mc_ascii_protocol);
+  auto ap3 = AccessPoint::create("127.0.0.1:12346", mc_ascii_protocol);
+  ASSERT_TRUE(ap1 != nullptr && ap2 != nullptr && ap3 != nullptr);
+
+  // Equal access points share an id; ids are stable across calls.
+  EXPECT_GT(ap1->uniqueId(), 0);
+  EXPECT_EQ(ap1->uniqueId(), ap2->uniqueId());
+  EXPECT_EQ(ap1->uniqueId(), ap1->uniqueId());
+  EXPECT_NE(ap1->uniqueId(), ap3->uniqueId());
+
+  // Different protocol means a different serialized form.
+  auto ap4 = AccessPoint::create("127.0.0.1:12345", mc_caret_protocol);
+  ASSERT_TRUE(ap4 != nullptr);
+  EXPECT_NE(ap1->uniqueId(), ap4->uniqueId());
+}
+
 } // anonymous
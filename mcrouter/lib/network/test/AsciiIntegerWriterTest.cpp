@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "mcrouter/lib/network/AsciiIntegerWriter.h"
+
+using facebook::memcache::detail::writeDecimal;
+
+namespace {
+
+template <class T>
+std::string write(T value) {
+  char buf[24];
+  char* end = writeDecimal(buf, value);
+  return std::string(buf, end);
+}
+
+} // anonymous namespace
+
+TEST(AsciiIntegerWriter, unsignedValues) {
+  EXPECT_EQ("0", write(uint64_t(0)));
+  EXPECT_EQ("7", write(uint64_t(7)));
+  EXPECT_EQ("10", write(uint64_t(10)));
+  EXPECT_EQ("99", write(uint64_t(99)));
+  EXPECT_EQ("100", write(uint64_t(100)));
+  EXPECT_EQ("12345678", write(uint64_t(12345678)));
+  EXPECT_EQ(
+      "18446744073709551615",
+      write(std::numeric_limits<uint64_t>::max()));
+  EXPECT_EQ("4294967295", write(std::numeric_limits<uint32_t>::max()));
+}
+
+TEST(AsciiIntegerWriter, signedValues) {
+  EXPECT_EQ("0", write(int64_t(0)));
+  EXPECT_EQ("-1", write(int64_t(-1)));
+  EXPECT_EQ("-12345", write(int32_t(-12345)));
+  EXPECT_EQ(
+      "9223372036854775807", write(std::numeric_limits<int64_t>::max()));
+  EXPECT_EQ(
+      "-9223372036854775808", write(std::numeric_limits<int64_t>::min()));
+  EXPECT_EQ("-2147483648", write(std::numeric_limits<int32_t>::min()));
+}
+
+TEST(AsciiIntegerWriter, matchesSnprintf) {
+  char expected[24];
+  for (uint64_t v = 0; v < 2000; ++v) {
+    snprintf(expected, sizeof(expected), "%lu", v);
+    EXPECT_EQ(expected, write(v));
+  }
+}
@@ -8,6 +8,7 @@
 #include <sys/uio.h>
 
 #include <cstring>
+#include <memory>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -16,6 +17,7 @@
 #include <folly/io/IOBuf.h>
 
 #include "mcrouter/lib/carbon/CarbonQueueAppender.h"
+#include "mcrouter/lib/carbon/SerializedSize.h"
 #include "mcrouter/lib/network/UmbrellaProtocol.h"
 #include "mcrouter/lib/network/gen/Memcache.h"
 #include "mcrouter/lib/network/test/gen/CarbonTest.h"
@@ -70,6 +72,50 @@ TEST(CarbonQueueAppenderTest, longString) {
   EXPECT_EQ(message, inputReply.message());
 }
 
+TEST(CarbonQueueAppenderTest, ownedIOBufChain) {
+  auto storage = std::make_unique<carbon::CarbonQueueAppenderStorage>();
+  storage->setTCPZeroCopyThreshold(512);
+  McGetReply reply(mc_res_found);
+
+  // Large enough to live in the IOBuf chain rather than internal storage.
+  const std::string message(1024, 'a');
+  reply.message() = message;
+
+  carbon::CarbonProtocolWriter writer(*storage);
+  reply.serialize(writer);
+
+  UmbrellaMessageInfo info;
+  info.bodySize = storage->computeBodySize();
+  info.typeId = 123;
+  info.reqId = 456;
+  info.traceId = {17, 18};
+
+  size_t headerSize = caretPrepareHeader(
+      info, reinterpret_cast<char*>(storage->getHeaderBuf()));
+  storage->reportHeaderSize(headerSize);
+
+  EXPECT_TRUE(storage->shouldApplyZeroCopy());
+
+  // Capture the data described by the iovecs for comparison.
+  std::string expected;
+  const auto iovs = storage->getIovecs();
+  for (size_t i = 0; i < iovs.second; ++i) {
+    const struct iovec* iov = iovs.first + i;
+    expected.append(reinterpret_cast<const char*>(iov->iov_base), iov->iov_len);
+  }
+
+  auto chain = storage->createOwnedIOBufChain();
+  // The chain must survive destruction of the storage it was built from.
+  storage.reset();
+
+  EXPECT_EQ(expected.size(), chain->computeChainDataLength());
+  chain->coalesce();
+  EXPECT_EQ(
+      expected,
+      std::string(reinterpret_cast<const char*>(chain->data()),
+                  chain->length()));
+}
+
 namespace {
 void writeToBuf(folly::IOBuf& dest, const char* src, size_t len) {
   dest = folly::IOBuf(folly::IOBuf::CREATE, len);
@@ -205,3 +251,73 @@ TEST(CarbonQueueAppender, manyFields) {
   EXPECT_STREQ(str1, reinterpret_cast<const char*>(manyFields2.buf39().data()));
   EXPECT_STREQ(str2, reinterpret_cast<const char*>(manyFields2.buf40().data()));
 }
+
+TEST(CarbonQueueAppenderTest, reserveFromEstimate) {
+  carbon::CarbonQueueAppenderStorage storage;
+  McGetReply reply(mc_res_remote_error);
+
+  // Long enough that the unreserved path would spill out of the internal
+  // 512B buffer into a heap IOBuf copy.
+  const std::string message(2048, 'a');
+  reply.message() = message;
+
+  const auto estimate = carbon::estimateSerializedSize(reply);
+  EXPECT_GE(estimate.dataSize, message.size());
+  EXPECT_EQ(0, estimate.referencedSize);
+
+  storage.reserve(estimate.dataSize);
+  carbon::CarbonProtocolWriter writer(storage);
+  reply.serialize(writer);
+
+  // The estimate is an upper bound on what was actually written.
+  EXPECT_LE(storage.computeBodySize(), estimate.total());
+
+  UmbrellaMessageInfo info;
+  info.bodySize = storage.computeBodySize();
+  info.typeId = 123;
+  info.reqId = 456;
+  info.traceId = {17, 18};
+  size_t headerSize =
+      caretPrepareHeader(info, reinterpret_cast<char*>(storage.getHeaderBuf()));
+  storage.reportHeaderSize(headerSize);
+
+  // Everything fits the presized buffer: header and body share one iovec.
+  const auto iovs = storage.getIovecs();
+  EXPECT_EQ(1, iovs.second);
+
+  folly::IOBuf input(folly::IOBuf::CREATE, 4096);
+  for (size_t i = 0; i < iovs.second; ++i) {
+    const struct iovec* iov = iovs.first + i;
+    std::memcpy(input.writableTail(), iov->iov_base, iov->iov_len);
+    input.append(iov->iov_len);
+  }
+
+  UmbrellaMessageInfo inputHeader;
+  caretParseHeader((uint8_t*)input.data(), input.length(), inputHeader);
+  McGetReply inputReply;
+  auto inputBody = folly::IOBuf::wrapBuffer(
+      input.data() + inputHeader.headerSize, inputHeader.bodySize);
+  carbon::CarbonProtocolReader reader(folly::io::Cursor(inputBody.get()));
+  inputReply.deserialize(reader);
+
+  EXPECT_EQ(mc_res_remote_error, inputReply.result());
+  EXPECT_EQ(message, inputReply.message());
+}
+
+TEST(CarbonQueueAppenderTest, estimateLargeValueReferenced) {
+  McSetRequest request("someKey");
+  const std::string value(1 << 20, 'v');
+  request.value() = folly::IOBuf(folly::IOBuf::COPY_BUFFER, value);
+
+  // Large values are appended by reference during serialization; they
+  // must not inflate the storage reservation.
+  const auto estimate = carbon::estimateSerializedSize(request);
+  EXPECT_GE(estimate.referencedSize, value.size());
+  EXPECT_LT(estimate.dataSize, 128);
+
+  carbon::CarbonQueueAppenderStorage storage;
+  storage.reserve(estimate.dataSize);
+  carbon::CarbonProtocolWriter writer(storage);
+  request.serialize(writer);
+  EXPECT_LE(storage.computeBodySize(), estimate.total());
+}
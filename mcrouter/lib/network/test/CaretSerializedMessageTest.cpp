@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <folly/io/IOBuf.h>
+
+#include "mcrouter/lib/network/CaretSerializedMessage.h"
+#include "mcrouter/lib/network/gen/MemcacheMessages.h"
+
+using namespace facebook::memcache;
+
+namespace {
+
+/**
+ * Serializes req and returns the full message (header + body) as a
+ * string. A non-null bodyCache is consulted and populated the same way
+ * the client send path does it.
+ */
+template <class Request>
+std::string serialize(
+    const Request& req,
+    uint32_t reqId,
+    SerializedRequestBodyCache* bodyCache = nullptr) {
+  CaretSerializedMessage msg;
+  const struct iovec* iovs;
+  size_t niovs;
+  EXPECT_TRUE(msg.prepare(
+      req,
+      reqId,
+      CodecIdRange::Empty,
+      iovs,
+      niovs,
+      PayloadFormat::Carbon,
+      bodyCache));
+  std::string out;
+  for (size_t i = 0; i < niovs; ++i) {
+    out.append(static_cast<const char*>(iovs[i].iov_base), iovs[i].iov_len);
+  }
+  return out;
+}
+
+McSetRequest makeSetRequest(folly::StringPiece key, size_t valueSize) {
+  McSetRequest req(key);
+  req.value() = folly::IOBuf(folly::IOBuf::COPY_BUFFER,
+                             std::string(valueSize, 'v'));
+  req.exptime() = 300;
+  req.flags() = 8;
+  return req;
+}
+
+} // anonymous
+
+TEST(CaretSerializedMessage, cachedResendMatchesFreshSerialization) {
+  auto req = makeSetRequest("test:key:1", 1000);
+
+  SerializedRequestBodyCache cache;
+  auto first = serialize(req, 100, &cache);
+  EXPECT_EQ(serialize(req, 100), first);
+  ASSERT_NE(nullptr, cache.body.get());
+
+  // The resend must splice the cached body, and the result must be
+  // byte-identical to serializing from scratch (with the new reqId).
+  auto resend = serialize(req, 101, &cache);
+  EXPECT_EQ(serialize(req, 101), resend);
+}
+
+TEST(CaretSerializedMessage, mutationBetweenAttemptsForcesReserialization) {
+  auto req = makeSetRequest("test:key:1", 1000);
+
+  SerializedRequestBodyCache cache;
+  serialize(req, 100, &cache);
+  ASSERT_NE(nullptr, cache.body.get());
+
+  // A wrapper route on a failover child may resend a mutated copy; the
+  // cached body of the original must not be spliced into it.
+  auto mutated = req;
+  mutated.exptime() = 10;
+  EXPECT_EQ(serialize(mutated, 101), serialize(mutated, 101, &cache));
+
+  auto rekeyed = req;
+  rekeyed.key() = "test:key:other";
+  EXPECT_EQ(serialize(rekeyed, 102), serialize(rekeyed, 102, &cache));
+
+  // Values larger than the inline threshold are referenced, not copied;
+  // replacing one must still miss the cache.
+  auto revalued = req;
+  revalued.value() = folly::IOBuf(folly::IOBuf::COPY_BUFFER,
+                                  std::string(1000, 'w'));
+  EXPECT_EQ(serialize(revalued, 103), serialize(revalued, 103, &cache));
+
+  // And the unchanged original still round-trips correctly afterwards.
+  EXPECT_EQ(serialize(req, 104), serialize(req, 104, &cache));
+}
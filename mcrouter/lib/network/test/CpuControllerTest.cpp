@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2016-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <folly/io/async/EventBase.h>
+
+#include "mcrouter/lib/network/CpuController.h"
+
+using namespace facebook::memcache;
+
+namespace {
+
+std::shared_ptr<CpuController> makeController(double cpuShedLimit) {
+  static folly::EventBase evb;
+  CpuControllerOptions opts;
+  opts.dataCollectionInterval = std::chrono::milliseconds(1000);
+  opts.cpuShedLimit = cpuShedLimit;
+  // Never started: the tests drive updateShedLevel() directly.
+  return std::make_shared<CpuController>(opts, evb);
+}
+
+void raiseShedLevelToMax(CpuController& controller) {
+  for (size_t i = 0; i < 50; ++i) {
+    controller.updateShedLevel(100.0);
+  }
+  EXPECT_DOUBLE_EQ(1.0, controller.shedLevel());
+}
+
+} // anonymous namespace
+
+TEST(CpuController, admitsEverythingUnderLimit) {
+  auto controller = makeController(80.0);
+  EXPECT_DOUBLE_EQ(0.0, controller->shedLevel());
+  EXPECT_TRUE(controller->shouldAdmit(CpuOpClass::kGet));
+  EXPECT_TRUE(controller->shouldAdmit(CpuOpClass::kUpdate));
+  EXPECT_TRUE(controller->shouldAdmit(CpuOpClass::kOther));
+  EXPECT_TRUE(controller->shouldAdmit(CpuOpClass::kDelete));
+}
+
+TEST(CpuController, disabledWithoutLimit) {
+  auto controller = makeController(0.0);
+  EXPECT_FALSE(controller->admissionEnabled());
+  controller->updateShedLevel(100.0);
+  EXPECT_DOUBLE_EQ(0.0, controller->shedLevel());
+}
+
+TEST(CpuController, shedLevelHysteresis) {
+  auto controller = makeController(80.0);
+
+  controller->updateShedLevel(90.0);
+  const auto raised = controller->shedLevel();
+  EXPECT_GT(raised, 0.0);
+
+  // Within the hysteresis band below the limit the level holds steady.
+  controller->updateShedLevel(78.0);
+  EXPECT_DOUBLE_EQ(raised, controller->shedLevel());
+
+  // Well below the limit it backs off.
+  controller->updateShedLevel(50.0);
+  EXPECT_LT(controller->shedLevel(), raised);
+}
+
+TEST(CpuController, deletesAreExempt) {
+  auto controller = makeController(80.0);
+  raiseShedLevelToMax(*controller);
+  for (size_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(controller->shouldAdmit(CpuOpClass::kDelete));
+  }
+}
+
+TEST(CpuController, fullShedDropsNonDeletes) {
+  auto controller = makeController(80.0);
+  raiseShedLevelToMax(*controller);
+  // At level 1 the drop probability of every non-delete class is 1.
+  EXPECT_FALSE(controller->shouldAdmit(CpuOpClass::kGet));
+  EXPECT_FALSE(controller->shouldAdmit(CpuOpClass::kUpdate));
+  EXPECT_FALSE(controller->shouldAdmit(CpuOpClass::kOther));
+}
+
+TEST(CpuController, cheapClassesShedLast) {
+  auto controller = makeController(80.0);
+  // Learn that gets are 10x cheaper than everything else.
+  for (size_t i = 0; i < 100; ++i) {
+    controller->reportOpCost(CpuOpClass::kGet, 100);
+    controller->reportOpCost(CpuOpClass::kOther, 1000);
+  }
+
+  // Level 0.5: gets (weight 0.1) only start shedding at level 0.9, so
+  // they are still deterministically admitted.
+  for (size_t i = 0; i < 10; ++i) {
+    controller->updateShedLevel(100.0);
+  }
+  EXPECT_NEAR(0.5, controller->shedLevel(), 1e-9);
+  for (size_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(controller->shouldAdmit(CpuOpClass::kGet));
+  }
+}
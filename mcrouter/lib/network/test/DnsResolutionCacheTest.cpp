@@ -0,0 +1,47 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include "mcrouter/lib/network/DnsResolutionCache.h"
+
+using namespace facebook::memcache;
+
+TEST(DnsResolutionCache, lookupUnknown) {
+  DnsResolutionCache cache;
+  EXPECT_FALSE(cache.lookup("unknown.example.invalid").hasValue());
+}
+
+TEST(DnsResolutionCache, ipLiteralsNotCached) {
+  DnsResolutionCache cache;
+  // preResolve returns before scheduling anything for IP literals, so
+  // the lookup below can't race with a background resolution.
+  cache.preResolve("127.0.0.1");
+  cache.preResolve("::1");
+  EXPECT_FALSE(cache.lookup("127.0.0.1").hasValue());
+  EXPECT_FALSE(cache.lookup("::1").hasValue());
+}
+
+TEST(DnsResolutionCache, resolveAndLookup) {
+  DnsResolutionCache cache;
+  ASSERT_TRUE(cache.resolveNow("localhost"));
+  auto address = cache.lookup("localhost");
+  ASSERT_TRUE(address.hasValue());
+  EXPECT_TRUE(address->isLoopback());
+
+  // Repeated resolution overwrites in place instead of growing the map.
+  ASSERT_TRUE(cache.resolveNow("localhost"));
+  EXPECT_TRUE(cache.lookup("localhost").hasValue());
+}
+
+TEST(DnsResolutionCache, failedResolutionKeepsLastAddress) {
+  DnsResolutionCache cache;
+  ASSERT_TRUE(cache.resolveNow("localhost"));
+  EXPECT_FALSE(cache.resolveNow("unknown.example.invalid"));
+  // The earlier entry must survive the failed resolution.
+  EXPECT_TRUE(cache.lookup("localhost").hasValue());
+}
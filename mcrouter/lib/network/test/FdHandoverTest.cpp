@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "mcrouter/lib/network/FdHandover.h"
+
+using namespace facebook::memcache;
+
+TEST(FdHandover, passFdWithPayload) {
+  int channel[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, channel));
+
+  int pipeFds[2];
+  ASSERT_EQ(0, pipe(pipeFds));
+
+  EXPECT_TRUE(sendFdHandover(channel[0], pipeFds[1], "127.0.0.1:11211:TCP"));
+
+  std::string payload;
+  int received = recvFdHandover(channel[1], payload);
+  ASSERT_GE(received, 0);
+  EXPECT_NE(pipeFds[1], received); // a new fd referring to the same file
+  EXPECT_EQ("127.0.0.1:11211:TCP", payload);
+
+  // The received fd must be usable in place of the original
+  EXPECT_EQ(5, write(received, "hello", 5));
+  char buf[8];
+  EXPECT_EQ(5, read(pipeFds[0], buf, 5));
+  EXPECT_EQ("hello", std::string(buf, 5));
+
+  // Passed fds must not leak across exec
+  EXPECT_NE(0, fcntl(received, F_GETFD) & FD_CLOEXEC);
+
+  close(received);
+  close(pipeFds[0]);
+  close(pipeFds[1]);
+  close(channel[0]);
+  close(channel[1]);
+}
+
+TEST(FdHandover, channelShutdown) {
+  int channel[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, channel));
+
+  close(channel[0]);
+
+  std::string payload;
+  errno = EINVAL;
+  EXPECT_EQ(-1, recvFdHandover(channel[1], payload));
+  EXPECT_EQ(0, errno); // clean shutdown, not an error
+
+  close(channel[1]);
+}
+
+TEST(FdHandover, invalidArguments) {
+  int channel[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, channel));
+
+  EXPECT_FALSE(sendFdHandover(channel[0], -1, "payload"));
+  EXPECT_EQ(EINVAL, errno);
+  EXPECT_FALSE(sendFdHandover(channel[0], channel[1], ""));
+  EXPECT_EQ(EINVAL, errno);
+
+  close(channel[0]);
+  close(channel[1]);
+}
@@ -339,6 +339,10 @@ void getLikeTest(std::string opCmd) {
 
   TestRunner().expectError().run(opCmd + "no:space:before:key\r\n");
 
+  // DEL is rejected by the key grammar like any other control character;
+  // this also pins down the fast multiget scanner's byte classes.
+  TestRunner().expectError().run(opCmd + " bad\x7Fkey\r\n");
+
   // Missing key.
   TestRunner().expectError().run(opCmd + "\r\n").run(opCmd + "   \r\n");
 }
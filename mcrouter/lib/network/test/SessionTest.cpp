@@ -10,7 +10,9 @@
 
 #include <gtest/gtest.h>
 
+#include "mcrouter/lib/CompressionCodecManager.h"
 #include "mcrouter/lib/network/AsyncMcServerWorkerOptions.h"
+#include "mcrouter/lib/network/McSerializedRequest.h"
 #include "mcrouter/lib/network/test/SessionTestHarness.h"
 
 using namespace facebook::memcache;
@@ -112,6 +114,216 @@ TEST(Session, throttleBigPacket) {
   t.closeSession();
 }
 
+TEST(Session, throttleByBytes) {
+  AsyncMcServerWorkerOptions opts;
+  opts.maxInFlightBytes = 10;
+  SessionTestHarness t(opts);
+
+  /* The first set's 12-byte value exceeds the byte cap by itself, so
+     reads pause and later packets stay unread until it is replied. */
+  t.pause();
+  t.inputPackets(
+      "set key1 0 0 12\r\nbigbigvalue1\r\n", "get key2\r\n", "get key3\r\n");
+
+  EXPECT_TRUE(t.flushWrites().empty());
+  EXPECT_EQ(vector<string>({"key1"}), t.pausedKeys());
+
+  /* Replying to the set credits its bytes back; the small gets are read
+     and do not trip the byte throttle. */
+  t.resume(1);
+
+  EXPECT_EQ(vector<string>({"NOT_STORED\r\n"}), t.flushWrites());
+  EXPECT_EQ(vector<string>({"key2", "key3"}), t.pausedKeys());
+
+  t.resume();
+  EXPECT_EQ(
+      vector<string>(
+          {"VALUE key2 0 10\r\nkey2_value\r\nEND\r\nVALUE key3 0 10\r\nkey3_value"
+           "\r\nEND\r\n"}),
+      t.flushWrites());
+  EXPECT_TRUE(t.pausedKeys().empty());
+
+  t.closeSession();
+}
+
+namespace {
+
+std::string serializeCaretRequest(const McGetRequest& req, size_t reqId) {
+  McSerializedRequest serialized(
+      req, reqId, mc_caret_protocol, CodecIdRange::Empty);
+  EXPECT_EQ(
+      McSerializedRequest::Result::OK, serialized.serializationResult());
+  std::string out;
+  const struct iovec* iovs = serialized.getIovs();
+  for (size_t i = 0; i < serialized.getIovsCount(); ++i) {
+    out.append(
+        reinterpret_cast<const char*>(iovs[i].iov_base), iovs[i].iov_len);
+  }
+  return out;
+}
+
+bool writesContain(
+    const std::vector<std::string>& writes,
+    folly::StringPiece needle) {
+  for (const auto& w : writes) {
+    if (w.find(needle.str()) != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // anonymous
+
+TEST(Session, caretOutOfOrderReplies) {
+  AsyncMcServerWorkerOptions opts;
+  SessionTestHarness t(opts);
+
+  t.pause();
+  t.inputPackets(
+      serializeCaretRequest(McGetRequest("key1"), 100),
+      serializeCaretRequest(McGetRequest("key2"), 101));
+  EXPECT_EQ(vector<string>({"key1", "key2"}), t.pausedKeys());
+
+  /* Caret clients match replies by reqid, so replies are written as they
+     complete: the second reply must not be blocked behind the
+     still-outstanding first request. */
+  t.replyTo("key2");
+  auto writes = t.flushWrites();
+  EXPECT_TRUE(writesContain(writes, "key2_value"));
+  EXPECT_FALSE(writesContain(writes, "key1_value"));
+
+  t.replyTo("key1");
+  EXPECT_TRUE(writesContain(t.flushWrites(), "key1_value"));
+
+  t.closeSession();
+}
+
+TEST(Session, caretParseAhead) {
+  AsyncMcServerWorkerOptions opts;
+  opts.maxInFlight = 1;
+  opts.maxParseAheadBytes = 1024;
+  SessionTestHarness t(opts);
+
+  t.pause();
+  t.inputPackets(
+      serializeCaretRequest(McGetRequest("key1"), 100),
+      serializeCaretRequest(McGetRequest("key2"), 101),
+      serializeCaretRequest(McGetRequest("key3"), 102));
+
+  /* Dispatch throttles after key1, but key2 and key3 are still parsed
+     and wait ready in the session instead of in kernel buffers. */
+  EXPECT_EQ(vector<string>({"key1"}), t.pausedKeys());
+
+  /* Completing key1 dispatches key2 straight from the parse-ahead
+     queue; key3 stays queued since the in-flight limit is 1. */
+  t.resume(1);
+  EXPECT_TRUE(writesContain(t.flushWrites(), "key1_value"));
+  EXPECT_EQ(vector<string>({"key2"}), t.pausedKeys());
+
+  t.resume();
+  auto writes = t.flushWrites();
+  EXPECT_TRUE(writesContain(writes, "key2_value"));
+  EXPECT_TRUE(writesContain(writes, "key3_value"));
+  EXPECT_TRUE(t.pausedKeys().empty());
+
+  t.closeSession();
+}
+
+TEST(Session, caretParseAheadBudget) {
+  AsyncMcServerWorkerOptions opts;
+  opts.maxInFlight = 1;
+  /* One queued request exhausts the budget, so key3 stays unread. */
+  opts.maxParseAheadBytes = 1;
+  SessionTestHarness t(opts);
+
+  t.pause();
+  t.inputPackets(
+      serializeCaretRequest(McGetRequest("key1"), 100),
+      serializeCaretRequest(McGetRequest("key2"), 101),
+      serializeCaretRequest(McGetRequest("key3"), 102));
+
+  EXPECT_EQ(vector<string>({"key1"}), t.pausedKeys());
+
+  /* Everything still flows once the throttle lifts. */
+  t.resume();
+  auto writes = t.flushWrites();
+  EXPECT_TRUE(writesContain(writes, "key1_value"));
+  EXPECT_TRUE(writesContain(writes, "key2_value"));
+  EXPECT_TRUE(writesContain(writes, "key3_value"));
+  EXPECT_TRUE(t.pausedKeys().empty());
+
+  t.closeSession();
+}
+
+TEST(Session, asciiInOrderReplies) {
+  AsyncMcServerWorkerOptions opts;
+  SessionTestHarness t(opts);
+
+  t.pause();
+  t.inputPackets("get key1\r\n", "get key2\r\n");
+  EXPECT_EQ(vector<string>({"key1", "key2"}), t.pausedKeys());
+
+  /* Ascii clients can't match replies to requests by id, so the second
+     reply stays blocked until the first one completes. */
+  t.replyTo("key2");
+  EXPECT_TRUE(t.flushWrites().empty());
+
+  t.replyTo("key1");
+  auto writes = t.flushWrites();
+  EXPECT_TRUE(writesContain(writes, "key1_value"));
+  EXPECT_TRUE(writesContain(writes, "key2_value"));
+
+  t.closeSession();
+}
+
+TEST(Session, multiGetMissOutOfOrder) {
+  AsyncMcServerWorkerOptions opts;
+  SessionTestHarness t(opts);
+
+  t.pause();
+  t.inputPackets("get key1 key2\r\n");
+  EXPECT_EQ(vector<string>({"key1", "key2"}), t.pausedKeys());
+
+  /* A multiget miss parks a null reply in the in-order window behind
+     key1; it must consume its slot rather than read as a hole, or the
+     window never drains and END is never written. */
+  t.missTo("key2");
+  EXPECT_TRUE(t.flushWrites().empty());
+
+  t.replyTo("key1");
+  auto writes = t.flushWrites();
+  EXPECT_TRUE(writesContain(writes, "key1_value"));
+  EXPECT_FALSE(writesContain(writes, "key2"));
+  EXPECT_TRUE(writesContain(writes, "END"));
+
+  t.closeSession();
+}
+
+TEST(Session, streamingMultiGet) {
+  AsyncMcServerWorkerOptions opts;
+  opts.multiOpStreaming = true;
+  SessionTestHarness t(opts);
+
+  t.pause();
+  t.inputPackets("get key1 key2\r\n");
+  EXPECT_EQ(vector<string>({"key1", "key2"}), t.pausedKeys());
+
+  /* With streaming on, a completed hit is written out right away; only
+     END waits for the whole multiget. */
+  t.replyTo("key1");
+  auto writes = t.flushWrites();
+  EXPECT_TRUE(writesContain(writes, "key1_value"));
+  EXPECT_FALSE(writesContain(writes, "END"));
+
+  t.replyTo("key2");
+  writes = t.flushWrites();
+  EXPECT_TRUE(writesContain(writes, "key2_value"));
+  EXPECT_TRUE(writesContain(writes, "END"));
+
+  t.closeSession();
+}
+
 TEST(Session, quit) {
   AsyncMcServerWorkerOptions opts;
   SessionTestHarness t(opts);
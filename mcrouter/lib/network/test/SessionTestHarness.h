@@ -11,7 +11,6 @@
 #include <memory>
 #include <string>
 
-#include <folly/Function.h>
 #include <folly/Range.h>
 #include <folly/io/async/AsyncTransport.h>
 #include <folly/io/async/EventBase.h>
@@ -110,6 +109,39 @@ class SessionTestHarness {
     flushSavedInputs();
   }
 
+  /**
+   * Reply immediately to the accumulated request with the given key,
+   * regardless of arrival order. No-op if no such request is paused.
+   */
+  void replyTo(folly::StringPiece key) {
+    for (auto it = transactions_.begin(); it != transactions_.end(); ++it) {
+      if ((*it)->key() == key) {
+        (*it)->reply();
+        transactions_.erase(it);
+        break;
+      }
+    }
+    /* flush writes on the socket */
+    eventBase_.loopOnce();
+  }
+
+  /**
+   * Reply with a miss (notfound) to the accumulated request with the
+   * given key, regardless of arrival order. No-op if no such request is
+   * paused.
+   */
+  void missTo(folly::StringPiece key) {
+    for (auto it = transactions_.begin(); it != transactions_.end(); ++it) {
+      if ((*it)->key() == key) {
+        (*it)->replyMiss();
+        transactions_.erase(it);
+        break;
+      }
+    }
+    /* flush writes on the socket */
+    eventBase_.loopOnce();
+  }
+
   /**
    * Initiate session close
    */
@@ -142,24 +174,30 @@ class SessionTestHarness {
    public:
     virtual std::string key() const = 0;
     virtual void reply() = 0;
+    virtual void replyMiss() = 0;
     virtual ~TransactionIf() = 0;
   };
 
   template <class Request>
   class Transaction : public TransactionIf {
    public:
-    Transaction(Request&& req, folly::Function<void(const Request&)> replyFn)
-        : req_(std::move(req)), replyFn_(std::move(replyFn)) {}
+    Transaction(McServerRequestContext&& ctx, Request&& req)
+        : ctx_(std::move(ctx)), req_(std::move(req)) {}
     std::string key() const final {
       return req_.key().fullKey().str();
     }
     void reply() final {
-      replyFn_(req_);
+      McServerRequestContext::reply(
+          std::move(ctx_), createReply(DefaultReply, req_));
+    }
+    void replyMiss() final {
+      McServerRequestContext::reply(
+          std::move(ctx_), ReplyT<Request>(mc_res_notfound));
     }
 
    private:
+    McServerRequestContext ctx_;
     const Request req_;
-    folly::Function<void(const Request&)> replyFn_;
   };
 
   std::deque<std::unique_ptr<TransactionIf>> transactions_;
@@ -205,12 +243,8 @@ class SessionTestHarness {
   std::unique_ptr<Transaction<Request>> makeTransaction(
       McServerRequestContext&& ctx,
       Request&& req) {
-    auto replyFn = [ctx = std::move(ctx)](const Request& req) mutable {
-      McServerRequestContext::reply(
-          std::move(ctx), createReply(DefaultReply, req));
-    };
     return std::make_unique<Transaction<Request>>(
-        std::move(req), std::move(replyFn));
+        std::move(ctx), std::move(req));
   }
 
   std::unique_ptr<Transaction<McGetRequest>> makeTransaction(
@@ -0,0 +1,156 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include <folly/io/IOBuf.h>
+
+#include "mcrouter/lib/IOBufUtil.h"
+#include "mcrouter/lib/network/CaretHeader.h"
+#include "mcrouter/lib/network/UmbrellaProtocol.h"
+#include "mcrouter/lib/network/gen/MemcacheMessages.h"
+
+using namespace facebook::memcache;
+
+namespace {
+
+UmbrellaMessageInfo makeInfo() {
+  UmbrellaMessageInfo info;
+  info.bodySize = 1234;
+  info.typeId = 7;
+  info.reqId = 4242;
+  info.version = UmbrellaVersion::TYPED_MESSAGE;
+  info.traceId = {123456789, 987654321};
+  info.supportedCodecsFirstId = 64;
+  info.supportedCodecsSize = 8;
+  info.usedCodecId = 65;
+  info.uncompressedBodySize = 5678;
+  info.dropProbability = 100;
+  info.serverLoad = ServerLoad(54321);
+  return info;
+}
+
+} // anonymous namespace
+
+TEST(CaretHeader, round_trip_with_additional_fields) {
+  auto info = makeInfo();
+
+  char buf[kMaxHeaderLength];
+  auto headerSize = caretPrepareHeader(info, buf);
+  ASSERT_LE(headerSize, sizeof(buf));
+
+  UmbrellaMessageInfo parsed;
+  auto status = caretParseHeader(
+      reinterpret_cast<const uint8_t*>(buf), headerSize, parsed);
+  ASSERT_EQ(UmbrellaParseStatus::OK, status);
+
+  EXPECT_EQ(info.bodySize, parsed.bodySize);
+  EXPECT_EQ(info.typeId, parsed.typeId);
+  EXPECT_EQ(info.reqId, parsed.reqId);
+  EXPECT_EQ(headerSize, parsed.headerSize);
+  EXPECT_EQ(info.traceId, parsed.traceId);
+  EXPECT_EQ(info.supportedCodecsFirstId, parsed.supportedCodecsFirstId);
+  EXPECT_EQ(info.supportedCodecsSize, parsed.supportedCodecsSize);
+  EXPECT_EQ(info.usedCodecId, parsed.usedCodecId);
+  EXPECT_EQ(info.uncompressedBodySize, parsed.uncompressedBodySize);
+  EXPECT_EQ(info.dropProbability, parsed.dropProbability);
+  EXPECT_EQ(info.serverLoad.raw(), parsed.serverLoad.raw());
+}
+
+TEST(CaretHeader, round_trip_no_additional_fields) {
+  UmbrellaMessageInfo info;
+  info.bodySize = 10;
+  info.typeId = 1;
+  info.reqId = 1;
+  info.version = UmbrellaVersion::TYPED_MESSAGE;
+
+  char buf[kMaxHeaderLength];
+  auto headerSize = caretPrepareHeader(info, buf);
+
+  UmbrellaMessageInfo parsed;
+  auto status = caretParseHeader(
+      reinterpret_cast<const uint8_t*>(buf), headerSize, parsed);
+  ASSERT_EQ(UmbrellaParseStatus::OK, status);
+  EXPECT_EQ(info.bodySize, parsed.bodySize);
+  EXPECT_EQ(info.typeId, parsed.typeId);
+  EXPECT_EQ(info.reqId, parsed.reqId);
+  EXPECT_EQ(0, parsed.traceId.first);
+  EXPECT_EQ(0, parsed.usedCodecId);
+}
+
+TEST(CaretHeader, truncated_header_needs_more_data) {
+  auto info = makeInfo();
+
+  char buf[kMaxHeaderLength];
+  auto headerSize = caretPrepareHeader(info, buf);
+
+  // Every strict prefix must report NOT_ENOUGH_DATA, never parse
+  // fields from past the end of the buffer. This exercises both the
+  // checked slow path and the length guard of the unchecked fast path.
+  for (size_t len = 0; len < headerSize; ++len) {
+    UmbrellaMessageInfo parsed;
+    EXPECT_EQ(
+        UmbrellaParseStatus::NOT_ENOUGH_DATA,
+        caretParseHeader(reinterpret_cast<const uint8_t*>(buf), len, parsed));
+  }
+}
+
+TEST(CaretHeader, bad_magic_is_rejected) {
+  auto info = makeInfo();
+
+  char buf[kMaxHeaderLength];
+  auto headerSize = caretPrepareHeader(info, buf);
+  buf[0] = '}';
+
+  UmbrellaMessageInfo parsed;
+  EXPECT_EQ(
+      UmbrellaParseStatus::MESSAGE_PARSE_ERROR,
+      caretParseHeader(
+          reinterpret_cast<const uint8_t*>(buf), headerSize, parsed));
+}
+
+TEST(UmbrellaRequest, request_round_trip) {
+  McSetRequest req("test:key");
+  req.value() = folly::IOBuf(folly::IOBuf::COPY_BUFFER, "some value");
+  req.flags() = 0xf00d;
+  req.exptime() = 3600;
+
+  UmbrellaSerializedMessage serialized;
+  const struct iovec* iovs;
+  size_t niovs;
+  ASSERT_TRUE(serialized.prepare(req, 4242 /* reqid */, iovs, niovs));
+
+  folly::IOBuf wire(folly::IOBuf::CREATE, 1024);
+  for (size_t i = 0; i < niovs; ++i) {
+    std::memcpy(wire.writableTail(), iovs[i].iov_base, iovs[i].iov_len);
+    wire.append(iovs[i].iov_len);
+  }
+
+  UmbrellaMessageInfo info;
+  ASSERT_EQ(
+      UmbrellaParseStatus::OK,
+      umbrellaParseHeader(wire.data(), wire.length(), info));
+
+  uint64_t reqid = 0;
+  auto parsed = umbrellaParseRequest<McSetRequest>(
+      wire,
+      wire.data(),
+      info.headerSize,
+      wire.data() + info.headerSize,
+      info.bodySize,
+      reqid);
+
+  EXPECT_EQ(4242, reqid);
+  EXPECT_EQ("test:key", parsed.key().fullKey().str());
+  EXPECT_EQ(0xf00d, parsed.flags());
+  EXPECT_EQ(3600, parsed.exptime());
+  EXPECT_EQ(
+      "some value",
+      coalesceAndGetRange(parsed.value()).str());
+}
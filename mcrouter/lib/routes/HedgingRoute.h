@@ -0,0 +1,165 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <folly/Optional.h>
+#include <folly/fibers/AddTasks.h>
+#include <folly/fibers/Baton.h>
+
+#include "mcrouter/lib/McResUtil.h"
+#include "mcrouter/lib/Operation.h"
+#include "mcrouter/lib/RouteHandleTraverser.h"
+
+namespace facebook {
+namespace memcache {
+
+/**
+ * Hedged variant of AllFastestRoute.
+ *
+ * Sends the request to the first child immediately.  If no reply arrives
+ * within a delay derived from the first child's recent tail latency, sends
+ * one extra copy to the second child and returns whichever non-error reply
+ * comes back first.  The extra copies are limited to a percentage of all
+ * requests (the hedging budget), so this captures most of the tail-latency
+ * win of all-fastest at a small fraction of its backend cost.  As with
+ * all-fastest, the losing request completes asynchronously; there is no way
+ * to retract a request that is already on the wire.
+ *
+ * Route handles are per proxy thread, so the latency estimate and budget
+ * counters are thread-confined and need no synchronization.
+ */
+template <class RouteHandleIf>
+class HedgingRoute {
+ public:
+  static std::string routeName() {
+    return "all-fastest-hedged";
+  }
+
+  template <class Request>
+  void traverse(
+      const Request& req,
+      const RouteHandleTraverser<RouteHandleIf>& t) const {
+    t(children_, req);
+  }
+
+  HedgingRoute(
+      std::vector<std::shared_ptr<RouteHandleIf>> rh,
+      size_t budgetPercent,
+      std::chrono::microseconds minDelay,
+      std::chrono::microseconds maxDelay)
+      : children_(std::move(rh)),
+        budgetPercent_(budgetPercent),
+        minDelayUs_(minDelay.count()),
+        maxDelayUs_(maxDelay.count()),
+        stats_(std::make_shared<Stats>()) {
+    assert(children_.size() >= 2);
+  }
+
+  template <class Request>
+  ReplyT<Request> route(const Request& req) const {
+    using Reply = ReplyT<Request>;
+
+    ++stats_->requests;
+    const uint64_t delayUs =
+        std::min(std::max(stats_->tailLatencyUs, minDelayUs_), maxDelayUs_);
+
+    auto reqCopy = std::make_shared<Request>(req);
+    auto state = std::make_shared<State>();
+    auto stats = stats_;
+
+    // Tasks return folly::none when they decided not to send anything.
+    std::vector<std::function<folly::Optional<Reply>()>> funcs;
+    funcs.reserve(2);
+
+    auto primary = children_[0];
+    funcs.push_back([primary, reqCopy, state, stats]() {
+      const auto start = std::chrono::steady_clock::now();
+      auto reply = primary->route(*reqCopy);
+      state->primaryDone = true;
+      stats->recordLatency(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - start)
+              .count());
+      return folly::Optional<Reply>(std::move(reply));
+    });
+
+    auto secondary = children_[1];
+    const auto budgetPercent = budgetPercent_;
+    funcs.push_back(
+        [secondary, reqCopy, state, stats, delayUs, budgetPercent]()
+            -> folly::Optional<Reply> {
+          folly::fibers::Baton sleepBaton;
+          sleepBaton.try_wait_for(std::chrono::microseconds(delayUs));
+          if (state->primaryDone || !stats->tryConsumeHedge(budgetPercent)) {
+            return folly::none;
+          }
+          return folly::Optional<Reply>(secondary->route(*reqCopy));
+        });
+
+    auto taskIt = folly::fibers::addTasks(funcs.begin(), funcs.end());
+    folly::Optional<Reply> lastError;
+    while (true) {
+      auto result = taskIt.awaitNext();
+      if (result.hasValue()) {
+        if (!isFailoverErrorResult(result->result())) {
+          return std::move(result).value();
+        }
+        lastError = std::move(result);
+      }
+      if (!taskIt.hasNext()) {
+        // The primary task always produces a reply, so by the time all
+        // tasks are drained we have at least an error to return.
+        return std::move(lastError).value();
+      }
+    }
+  }
+
+ private:
+  struct State {
+    bool primaryDone{false};
+  };
+
+  struct Stats {
+    uint64_t requests{0};
+    uint64_t hedges{0};
+    // Decaying-max estimate of the primary child's tail latency: jumps to
+    // any slower sample and decays by 1/256 per sample otherwise, so it
+    // stays near the high percentiles of the recent latency distribution.
+    uint64_t tailLatencyUs{0};
+
+    void recordLatency(uint64_t sampleUs) {
+      if (sampleUs >= tailLatencyUs) {
+        tailLatencyUs = sampleUs;
+      } else {
+        tailLatencyUs -= tailLatencyUs / 256;
+      }
+    }
+
+    bool tryConsumeHedge(size_t budgetPercent) {
+      if ((hedges + 1) * 100 > requests * budgetPercent) {
+        return false;
+      }
+      ++hedges;
+      return true;
+    }
+  };
+
+  const std::vector<std::shared_ptr<RouteHandleIf>> children_;
+  const size_t budgetPercent_;
+  const uint64_t minDelayUs_;
+  const uint64_t maxDelayUs_;
+  // Shared with detached fibers that may outlive a config reload.
+  const std::shared_ptr<Stats> stats_;
+};
+}
+} // facebook::memcache
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -42,6 +43,10 @@ namespace memcache {
  * to both from_ and to_ route handle. For delete requests, returns
  * reply from worst among two replies.
  * 4. After (start_time + 2*interval), sends all requests to to_ route handle.
+ *
+ * Once phase 4 is reached the route latches that fact, so requests arriving
+ * after the migration completed cost a single relaxed load plus an indirect
+ * call instead of a time read and phase arithmetic on every request forever.
  */
 template <class RouteHandleIf, typename TimeProvider>
 class MigrateRoute {
@@ -54,7 +59,13 @@ class MigrateRoute {
   void traverse(
       const Request& req,
       const RouteHandleTraverser<RouteHandleIf>& t) const {
-    auto mask = routeMask(tp_(), req);
+    if (migrated_.load(std::memory_order_relaxed)) {
+      t(*to_, req);
+      return;
+    }
+    const time_t now = tp_();
+    maybeLatchMigrated(now);
+    auto mask = routeMask(now, req);
     if (mask & kFromMask) {
       t(*from_, req);
     }
@@ -73,13 +84,18 @@ class MigrateRoute {
         to_(std::move(th)),
         startTimeSec_(start_time_sec),
         intervalSec_(interval_sec),
+        endTimeSec_(start_time_sec + 2 * interval_sec),
         tp_(tp) {
     assert(from_ != nullptr);
     assert(to_ != nullptr);
   }
 
   McLeaseSetReply route(const McLeaseSetRequest& req) const {
+    if (migrated_.load(std::memory_order_relaxed)) {
+      return to_->route(req);
+    }
     const time_t now = tp_();
+    maybeLatchMigrated(now);
     auto mask = routeMask(now, req);
     switch (mask) {
       case kFromMask:
@@ -111,7 +127,12 @@ class MigrateRoute {
       carbon::OtherThanT<Request, McLeaseSetRequest> = 0) const {
     using Reply = ReplyT<Request>;
 
-    auto mask = routeMask(tp_(), req);
+    if (migrated_.load(std::memory_order_relaxed)) {
+      return to_->route(req);
+    }
+    const time_t now = tp_();
+    maybeLatchMigrated(now);
+    auto mask = routeMask(now, req);
 
     switch (mask) {
       case kFromMask:
@@ -144,7 +165,19 @@ class MigrateRoute {
   const std::shared_ptr<RouteHandleIf> to_;
   time_t startTimeSec_;
   time_t intervalSec_;
+  const time_t endTimeSec_;
   const TimeProvider tp_;
+  // Set once the route becomes equivalent to to_ for every request type.
+  mutable std::atomic<bool> migrated_{false};
+
+  // Lease invalidations may still be sent up to 10 seconds past a key's
+  // migration time (see the lease-set overload of route() above), so only
+  // latch the flag once that grace period is over as well.
+  void maybeLatchMigrated(time_t now) const {
+    if (now >= endTimeSec_ + 10) {
+      migrated_.store(true, std::memory_order_relaxed);
+    }
+  }
 
   template <class Request>
   int routeMask(time_t now, const Request&, carbon::DeleteLikeT<Request> = 0)
@@ -153,7 +186,7 @@ class MigrateRoute {
       return kFromMask;
     }
 
-    if (now < (startTimeSec_ + 2 * intervalSec_)) {
+    if (now < endTimeSec_) {
       return kFromMask | kToMask;
     }
 
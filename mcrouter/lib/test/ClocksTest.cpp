@@ -0,0 +1,42 @@
+/*
+ *  Copyright (c) Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "mcrouter/lib/Clocks.h"
+
+using namespace facebook::memcache;
+
+TEST(CoarseClock, zeroWithoutTicker) {
+  EXPECT_EQ(0, coarse::nowUs());
+}
+
+TEST(CoarseClock, ticksWhileGuardAlive) {
+  coarse::TickerGuard guard;
+
+  const auto first = coarse::nowUs();
+  EXPECT_GT(first, 0);
+
+  /* sleep override */
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  const auto second = coarse::nowUs();
+  EXPECT_GT(second, first);
+}
+
+TEST(CoarseClock, refcountedGuards) {
+  coarse::TickerGuard outer;
+  {
+    coarse::TickerGuard inner;
+    EXPECT_GT(coarse::nowUs(), 0);
+  }
+  // Ticker must survive destruction of the inner guard.
+  EXPECT_GT(coarse::nowUs(), 0);
+}
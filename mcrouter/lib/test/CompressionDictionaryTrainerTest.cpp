@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <folly/Format.h>
+#include <folly/io/IOBuf.h>
+
+#include "mcrouter/lib/CompressionDictionaryTrainer.h"
+
+namespace facebook {
+namespace memcache {
+namespace test {
+
+namespace {
+
+std::unique_ptr<folly::IOBuf> makeValue(size_t seed) {
+  auto str = folly::sformat(
+      "VALUE user:{} 0 32\r\n"
+      "{{\"id\":{},\"name\":\"user{}\",\"score\":{}}}\r\n"
+      "END\r\n",
+      seed,
+      seed,
+      seed,
+      seed * 7);
+  return folly::IOBuf::copyBuffer(str);
+}
+
+} // anonymous namespace
+
+TEST(CompressionDictionaryTrainer, reservoirFillsUp) {
+  CompressionDictionaryTrainer trainer(
+      /* samplesPerTypeId */ 100, /* maxSampleSize */ 1024);
+
+  EXPECT_FALSE(trainer.hasEnoughSamples(1));
+  EXPECT_EQ(0, trainer.valuesSeen(1));
+
+  for (size_t i = 0; i < 200; ++i) {
+    trainer.sample(1, *makeValue(i));
+  }
+
+  EXPECT_TRUE(trainer.hasEnoughSamples(1));
+  EXPECT_EQ(200, trainer.valuesSeen(1));
+
+  // Other type ids are independent.
+  EXPECT_FALSE(trainer.hasEnoughSamples(2));
+}
+
+TEST(CompressionDictionaryTrainer, emptyValuesIgnored) {
+  CompressionDictionaryTrainer trainer(/* samplesPerTypeId */ 100);
+
+  folly::IOBuf empty;
+  trainer.sample(1, empty);
+  EXPECT_EQ(0, trainer.valuesSeen(1));
+}
+
+TEST(CompressionDictionaryTrainer, trainWithoutSamplesThrows) {
+  CompressionDictionaryTrainer trainer(/* samplesPerTypeId */ 100);
+
+  trainer.sample(1, *makeValue(0));
+  EXPECT_THROW(trainer.trainDictionary(1), std::runtime_error);
+}
+
+#if FOLLY_HAVE_LIBZSTD && !defined(DISABLE_COMPRESSION)
+
+TEST(CompressionDictionaryTrainer, trainProducesUsableDictionary) {
+  CompressionDictionaryTrainer trainer(
+      /* samplesPerTypeId */ 500,
+      /* maxSampleSize */ 1024,
+      /* dictionarySize */ 16 * 1024);
+
+  for (size_t i = 0; i < 500; ++i) {
+    trainer.sample(1, *makeValue(i));
+  }
+
+  auto dictionary = trainer.trainDictionary(1);
+  EXPECT_FALSE(dictionary.empty());
+  EXPECT_LE(dictionary.size(), 16 * 1024);
+}
+
+#endif // FOLLY_HAVE_LIBZSTD && !defined(DISABLE_COMPRESSION)
+
+} // test
+} // memcache
+} // facebook
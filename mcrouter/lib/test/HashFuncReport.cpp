@@ -0,0 +1,216 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include "HashFuncReport.h"
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <memory>
+
+#include <folly/Benchmark.h>
+#include <folly/Range.h>
+
+#include "mcrouter/lib/Ch3HashFunc.h"
+#include "mcrouter/lib/RendezvousHashFunc.h"
+#include "mcrouter/lib/WeightedCh4HashFunc.h"
+#include "mcrouter/lib/fbi/WeightedFurcHash.h"
+
+namespace facebook {
+namespace memcache {
+namespace test {
+
+namespace {
+
+using Hasher = std::function<size_t(folly::StringPiece)>;
+
+// Builds a hasher for the given topology, so the same factory can be
+// re-invoked for the add/remove-a-host variants of the pool.
+using HasherFactory = std::function<
+    Hasher(const std::vector<std::string>&, const std::vector<double>&)>;
+
+std::vector<size_t> hashAll(const Hasher& hasher,
+                            const std::vector<std::string>& keys) {
+  std::vector<size_t> indices;
+  indices.reserve(keys.size());
+  for (const auto& key : keys) {
+    indices.push_back(hasher(key));
+  }
+  return indices;
+}
+
+double measureKeysPerSec(const Hasher& hasher,
+                         const std::vector<std::string>& keys,
+                         size_t passes) {
+  using Clock = std::chrono::steady_clock;
+  std::chrono::nanoseconds best = std::chrono::nanoseconds::max();
+  for (size_t pass = 0; pass < std::max<size_t>(passes, 1); ++pass) {
+    size_t sink = 0;
+    const auto start = Clock::now();
+    for (const auto& key : keys) {
+      sink += hasher(key);
+    }
+    const auto elapsed =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - start);
+    folly::doNotOptimizeAway(sink);
+    best = std::min(best, elapsed);
+  }
+  if (best.count() <= 0) {
+    return 0.0;
+  }
+  return keys.size() * 1e9 / best.count();
+}
+
+folly::dynamic distributionReport(const std::vector<size_t>& indices,
+                                  size_t poolSize) {
+  std::vector<uint64_t> counts(poolSize, 0);
+  for (auto index : indices) {
+    ++counts.at(index);
+  }
+
+  const double mean =
+      poolSize ? static_cast<double>(indices.size()) / poolSize : 0.0;
+  uint64_t peak = 0;
+  double sumSquaredDelta = 0.0;
+  folly::dynamic jCounts = folly::dynamic::array;
+  for (auto count : counts) {
+    peak = std::max(peak, count);
+    const double delta = count - mean;
+    sumSquaredDelta += delta * delta;
+    jCounts.push_back(count);
+  }
+
+  folly::dynamic report = folly::dynamic::object;
+  report["counts"] = std::move(jCounts);
+  report["peak_to_mean"] = mean > 0.0 ? peak / mean : 0.0;
+  report["coeff_of_variation"] =
+      mean > 0.0 ? std::sqrt(sumSquaredDelta / poolSize) / mean : 0.0;
+  return report;
+}
+
+folly::dynamic remapReport(const std::vector<size_t>& before,
+                           const std::vector<size_t>& after) {
+  size_t remapped = 0;
+  for (size_t i = 0; i < before.size(); ++i) {
+    if (before[i] != after[i]) {
+      ++remapped;
+    }
+  }
+  folly::dynamic report = folly::dynamic::object;
+  // Every remapped key is a cache miss after the topology change.
+  report["cache_misses"] = remapped;
+  report["remap_fraction"] =
+      before.empty() ? 0.0 : static_cast<double>(remapped) / before.size();
+  return report;
+}
+
+folly::dynamic evaluateHashFunc(folly::StringPiece name,
+                                const HasherFactory& factory,
+                                const std::vector<std::string>& servers,
+                                const std::vector<double>& weights,
+                                const std::vector<std::string>& keys,
+                                const HashReportOptions& options) {
+  auto hasher = factory(servers, weights);
+  const auto baseline = hashAll(hasher, keys);
+
+  folly::dynamic report = folly::dynamic::object;
+  report["name"] = name;
+  report["keys_per_sec"] =
+      measureKeysPerSec(hasher, keys, options.timingPasses);
+  report["distribution"] = distributionReport(baseline, servers.size());
+
+  // Simulated host add: append one full-weight host.
+  auto addedServers = servers;
+  addedServers.push_back("added.host");
+  auto addedWeights = weights;
+  addedWeights.push_back(1.0);
+  report["host_added"] =
+      remapReport(baseline, hashAll(factory(addedServers, addedWeights), keys));
+
+  // Simulated host removal: drop the last host.
+  if (servers.size() > 1) {
+    auto removedServers = servers;
+    removedServers.pop_back();
+    auto removedWeights = weights;
+    removedWeights.pop_back();
+    auto removed = remapReport(
+        baseline, hashAll(factory(removedServers, removedWeights), keys));
+    // Keys filed on the removed host are misses no matter where they land.
+    size_t evacuated = 0;
+    for (auto index : baseline) {
+      if (index == servers.size() - 1) {
+        ++evacuated;
+      }
+    }
+    removed["evacuated_keys"] = evacuated;
+    report["host_removed"] = std::move(removed);
+  }
+
+  return report;
+}
+
+} // anonymous namespace
+
+folly::dynamic runHashFuncReport(
+    const std::vector<std::string>& servers,
+    std::vector<double> weights,
+    const std::vector<std::string>& keys,
+    const HashReportOptions& options) {
+  weights.resize(servers.size(), 1.0);
+
+  std::vector<std::pair<folly::StringPiece, HasherFactory>> factories;
+  factories.emplace_back(
+      Ch3HashFunc::type(),
+      [](const std::vector<std::string>& s, const std::vector<double>&) {
+        return Hasher(Ch3HashFunc(s.size()));
+      });
+  factories.emplace_back(
+      WeightedCh4HashFunc::type(),
+      [](const std::vector<std::string>&, const std::vector<double>& w) {
+        auto func = std::make_shared<WeightedCh4HashFunc>(w);
+        return Hasher(
+            [func](folly::StringPiece key) { return (*func)(key); });
+      });
+  factories.emplace_back(
+      RendezvousHashFunc::type(),
+      [](const std::vector<std::string>& s, const std::vector<double>&) {
+        // RendezvousHashFunc hashes the endpoint names at construction
+        // time only, so the StringPieces need not outlive this factory.
+        std::vector<folly::StringPiece> endpoints(s.begin(), s.end());
+        auto func = std::make_shared<RendezvousHashFunc>(endpoints);
+        return Hasher(
+            [func](folly::StringPiece key) { return (*func)(key); });
+      });
+  factories.emplace_back(
+      "WeightedFurcHash",
+      [](const std::vector<std::string>&, const std::vector<double>& w) {
+        auto funcWeights = std::make_shared<std::vector<double>>(w);
+        return Hasher([funcWeights](folly::StringPiece key) {
+          return facebook::mcrouter::weightedFurcHash(
+              key,
+              folly::Range<const double*>(
+                  funcWeights->data(), funcWeights->size()));
+        });
+      });
+
+  folly::dynamic functions = folly::dynamic::array;
+  for (const auto& entry : factories) {
+    functions.push_back(evaluateHashFunc(
+        entry.first, entry.second, servers, weights, keys, options));
+  }
+
+  folly::dynamic report = folly::dynamic::object;
+  report["pool_size"] = servers.size();
+  report["num_keys"] = keys.size();
+  report["functions"] = std::move(functions);
+  return report;
+}
+
+} // namespace test
+} // namespace memcache
+} // namespace facebook
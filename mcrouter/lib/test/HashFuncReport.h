@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <folly/dynamic.h>
+
+namespace facebook {
+namespace memcache {
+namespace test {
+
+struct HashReportOptions {
+  // Passes over the corpus when measuring keys/sec; the fastest pass is
+  // reported so scheduling noise only ever makes a function look slower.
+  size_t timingPasses{3};
+};
+
+/**
+ * Evaluates every pool hash function (Ch3, WeightedCh4, Rendezvous and
+ * raw weightedFurcHash) against a pool and a key corpus, and reports per
+ * function:
+ *
+ *   - keys/sec over the corpus,
+ *   - distribution skew (peak-to-mean ratio and coefficient of variation
+ *     of per-host key counts, plus the raw counts),
+ *   - remap fraction and cache-miss counts when a host is appended to the
+ *     pool and when the last host is removed.
+ *
+ * The result is machine-readable (folly::dynamic, serializable as json),
+ * so ring migrations can be compared from data rather than folklore.
+ *
+ * @param servers  Pool hosts; only the size matters for Ch3/WeightedCh4,
+ *                 Rendezvous hashes the names themselves.
+ * @param weights  Per-host weights in [0.0, 1.0]; resized with 1.0 to
+ *                 match servers.
+ * @param keys     Key corpus to hash.
+ */
+folly::dynamic runHashFuncReport(
+    const std::vector<std::string>& servers,
+    std::vector<double> weights,
+    const std::vector<std::string>& keys,
+    const HashReportOptions& options = HashReportOptions());
+
+} // namespace test
+} // namespace memcache
+} // namespace facebook
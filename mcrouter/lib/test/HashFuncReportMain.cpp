@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <folly/json.h>
+
+#include "mcrouter/lib/test/HashFuncReport.h"
+
+/**
+ * Hash function evaluation harness.
+ *
+ * Given a pool definition and a key corpus, emits a json report with
+ * keys/sec, distribution skew and remap/cache-miss behavior under host
+ * add/remove for each pool hash function.  Typical use:
+ *
+ *   hash_func_report --pool-json pool.json --key-corpus keys.txt
+ *
+ * where pool.json looks like a pool definition:
+ *
+ *   {"servers": ["host1:11211", ...], "weights": [1.0, ...]}
+ *
+ * ("weights" is optional and defaults to 1.0 everywhere) and keys.txt
+ * has one key per line.  Without --key-corpus a synthetic corpus of
+ * --num-synthetic-keys keys is used.
+ */
+
+DEFINE_string(pool_json, "", "Path to the pool definition json");
+DEFINE_string(key_corpus, "", "Path to a file with one key per line");
+DEFINE_int32(
+    num_synthetic_keys,
+    1000000,
+    "Size of the generated corpus when --key-corpus is not given");
+DEFINE_int32(timing_passes, 3, "Passes over the corpus when timing");
+
+namespace {
+
+std::vector<std::string> loadKeyCorpus() {
+  std::vector<std::string> keys;
+  if (!FLAGS_key_corpus.empty()) {
+    std::string contents;
+    if (!folly::readFile(FLAGS_key_corpus.c_str(), contents)) {
+      LOG(FATAL) << "Failed to read key corpus " << FLAGS_key_corpus;
+    }
+    folly::split('\n', contents, keys, /* ignoreEmpty */ true);
+  } else {
+    keys.reserve(FLAGS_num_synthetic_keys);
+    for (int32_t i = 0; i < FLAGS_num_synthetic_keys; ++i) {
+      keys.push_back("synthetic:key:" + folly::to<std::string>(i));
+    }
+  }
+  return keys;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+
+  if (FLAGS_pool_json.empty()) {
+    LOG(FATAL) << "--pool-json is required";
+  }
+  std::string poolContents;
+  if (!folly::readFile(FLAGS_pool_json.c_str(), poolContents)) {
+    LOG(FATAL) << "Failed to read pool definition " << FLAGS_pool_json;
+  }
+  const auto pool = folly::parseJson(poolContents);
+
+  std::vector<std::string> servers;
+  for (const auto& server : pool["servers"]) {
+    servers.push_back(server.asString());
+  }
+  if (servers.empty()) {
+    LOG(FATAL) << "Pool definition has no servers";
+  }
+  std::vector<double> weights;
+  if (auto* jWeights = pool.get_ptr("weights")) {
+    for (const auto& weight : *jWeights) {
+      weights.push_back(weight.asDouble());
+    }
+  }
+
+  facebook::memcache::test::HashReportOptions options;
+  options.timingPasses = FLAGS_timing_passes;
+
+  const auto report = facebook::memcache::test::runHashFuncReport(
+      servers, std::move(weights), loadKeyCorpus(), options);
+  std::cout << folly::toPrettyJson(report) << std::endl;
+  return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <folly/Conv.h>
+
+#include "mcrouter/lib/test/HashFuncReport.h"
+#include "mcrouter/lib/test/HashTestUtil.h"
+
+using namespace facebook::memcache;
+
+namespace {
+
+std::vector<std::string> genKeys(size_t n) {
+  std::vector<std::string> keys;
+  keys.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    keys.push_back("mykey:" + folly::to<std::string>(i));
+  }
+  return keys;
+}
+
+} // namespace
+
+TEST(HashFuncReport, basic) {
+  constexpr size_t kPoolSize = 10;
+  constexpr size_t kNumKeys = 10000;
+  auto servers = test::genEndpoints(kPoolSize).first;
+
+  test::HashReportOptions options;
+  options.timingPasses = 1;
+  auto report = test::runHashFuncReport(
+      servers, std::vector<double>(kPoolSize, 1.0), genKeys(kNumKeys), options);
+
+  EXPECT_EQ(kPoolSize, report["pool_size"].asInt());
+  EXPECT_EQ(kNumKeys, report["num_keys"].asInt());
+  EXPECT_EQ(4, report["functions"].size());
+
+  for (const auto& func : report["functions"]) {
+    SCOPED_TRACE(func["name"].asString());
+    EXPECT_GT(func["keys_per_sec"].asDouble(), 0.0);
+
+    // Each key lands on exactly one host.
+    const auto& counts = func["distribution"]["counts"];
+    EXPECT_EQ(kPoolSize, counts.size());
+    size_t total = 0;
+    for (const auto& count : counts) {
+      total += count.asInt();
+    }
+    EXPECT_EQ(kNumKeys, total);
+    // With uniform weights no host should see more than twice its share.
+    EXPECT_LT(func["distribution"]["peak_to_mean"].asDouble(), 2.0);
+
+    // All four functions are consistent: adding one host to a pool of 10
+    // should move roughly 1/11 of the keys, far from a full reshuffle.
+    const auto addFraction = func["host_added"]["remap_fraction"].asDouble();
+    EXPECT_GT(addFraction, 0.0);
+    EXPECT_LT(addFraction, 0.3);
+
+    // Removing a host must remap at least the keys it held.
+    EXPECT_GE(
+        func["host_removed"]["cache_misses"].asInt(),
+        func["host_removed"]["evacuated_keys"].asInt());
+    EXPECT_GT(func["host_removed"]["evacuated_keys"].asInt(), 0);
+    EXPECT_LT(func["host_removed"]["remap_fraction"].asDouble(), 0.3);
+  }
+}
+
+TEST(HashFuncReport, deterministicDistribution) {
+  auto servers = test::genEndpoints(7).first;
+  auto keys = genKeys(2000);
+
+  test::HashReportOptions options;
+  options.timingPasses = 1;
+  auto first =
+      test::runHashFuncReport(servers, std::vector<double>(), keys, options);
+  auto second =
+      test::runHashFuncReport(servers, std::vector<double>(), keys, options);
+
+  // keys/sec varies run to run, but the distribution and remap numbers
+  // must not; they are what migration decisions get made from.
+  for (size_t i = 0; i < first["functions"].size(); ++i) {
+    const auto& lhs = first["functions"][i];
+    const auto& rhs = second["functions"][i];
+    SCOPED_TRACE(lhs["name"].asString());
+    EXPECT_EQ(lhs["distribution"], rhs["distribution"]);
+    EXPECT_EQ(lhs["host_added"], rhs["host_added"]);
+    EXPECT_EQ(lhs["host_removed"], rhs["host_removed"]);
+  }
+}
@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "mcrouter/lib/McKey.h"
+
+using namespace facebook::memcache;
+
+TEST(McKey, basic) {
+  EXPECT_EQ(mc_req_err_valid, isKeyValid<true>("sample"));
+  EXPECT_EQ(mc_req_err_no_key, isKeyValid<true>(""));
+  EXPECT_EQ(
+      mc_req_err_key_too_long,
+      isKeyValid<true>(std::string(MC_KEY_MAX_LEN + 1, 'x')));
+  EXPECT_EQ(
+      mc_req_err_valid, isKeyValid<true>(std::string(MC_KEY_MAX_LEN, 'x')));
+}
+
+TEST(McKey, spaceAndCtrl) {
+  EXPECT_EQ(mc_req_err_space_or_ctrl, isKeyValid<true>("a b"));
+  EXPECT_EQ(mc_req_err_space_or_ctrl, isKeyValid<true>("a\tb"));
+  EXPECT_EQ(mc_req_err_space_or_ctrl, isKeyValid<true>("a\nb"));
+  EXPECT_EQ(mc_req_err_space_or_ctrl, isKeyValid<true>("a\x7f"));
+  EXPECT_EQ(mc_req_err_space_or_ctrl, isKeyValid<true>(std::string(1, '\x01')));
+  // Bytes above 0x7F are valid key characters.
+  EXPECT_EQ(mc_req_err_valid, isKeyValid<true>("\x80\xff"));
+  // No space/ctrl check for non-memcache keys.
+  EXPECT_EQ(mc_req_err_valid, isKeyValid<false>("a b\n"));
+}
+
+TEST(McKey, vectorBoundary) {
+  // Exercise all positions relative to the 16-byte vector chunks.
+  for (size_t len = 1; len <= 64; ++len) {
+    std::string key(len, 'x');
+    EXPECT_EQ(mc_req_err_valid, isKeyValid<true>(key)) << len;
+    for (size_t pos = 0; pos < len; ++pos) {
+      std::string bad = key;
+      bad[pos] = ' ';
+      EXPECT_EQ(mc_req_err_space_or_ctrl, isKeyValid<true>(bad))
+          << len << " " << pos;
+      bad[pos] = '\x7f';
+      EXPECT_EQ(mc_req_err_space_or_ctrl, isKeyValid<true>(bad))
+          << len << " " << pos;
+    }
+  }
+}
@@ -25,6 +25,39 @@ TEST(McResUtil, mc_res_from_string) {
   ASSERT_EQ(mc_res_from_string(resStr3.c_str()), mc_res_notfound);
 }
 
+TEST(McResUtil, classificationMasks) {
+  // The mask-based classifiers must agree with the per-value definitions.
+  for (int i = 0; i < mc_nres; ++i) {
+    const auto res = static_cast<mc_res_t>(i);
+    EXPECT_EQ(
+        res == mc_res_busy || res == mc_res_shutdown || res == mc_res_tko ||
+            res == mc_res_try_again || res == mc_res_local_error ||
+            res == mc_res_connect_error || res == mc_res_connect_timeout ||
+            res == mc_res_timeout || res == mc_res_remote_error,
+        isFailoverErrorResult(res))
+        << mc_res_to_string(res);
+    EXPECT_EQ(
+        res == mc_res_connect_error || res == mc_res_connect_timeout ||
+            res == mc_res_shutdown,
+        isHardTkoErrorResult(res))
+        << mc_res_to_string(res);
+    EXPECT_EQ(
+        res == mc_res_busy || res == mc_res_try_again, isRedirectResult(res))
+        << mc_res_to_string(res);
+    EXPECT_EQ(
+        res == mc_res_deleted || res == mc_res_found || res == mc_res_touched,
+        isHitResult(res))
+        << mc_res_to_string(res);
+    EXPECT_EQ(
+        res == mc_res_foundstale || res == mc_res_notfoundhot,
+        isHotMissResult(res))
+        << mc_res_to_string(res);
+    EXPECT_EQ(
+        res == mc_res_stored || res == mc_res_stalestored, isStoredResult(res))
+        << mc_res_to_string(res);
+  }
+}
+
 } // namespace test
 } // namespace memcache
 } // namespace facebook
@@ -310,3 +310,50 @@ TEST(migrateRouteTest, leases) {
     }
   });
 }
+
+TEST(migrateRouteTest, latchesAfterMigrationCompletes) {
+  vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(
+          GetRouteTestData(mc_res_found, "a"),
+          UpdateRouteTestData(),
+          DeleteRouteTestData(mc_res_deleted)),
+      make_shared<TestHandle>(
+          GetRouteTestData(mc_res_found, "b"),
+          UpdateRouteTestData(),
+          DeleteRouteTestData(mc_res_notfound)),
+  };
+  auto route_handles = get_route_handles(test_handles);
+
+  TestFiberManager fm;
+  fm.run([&]() {
+    const time_t start_time = 100;
+    auto interval = 10;
+    int time_reads = 0;
+    auto tp_func = [&]() {
+      ++time_reads;
+      // Well past the end of the migration and the lease grace period.
+      return start_time + 2 * interval + 100;
+    };
+    TestRouteHandle<MigrateRoute<TestRouteHandleIf, decltype(tp_func)>> rh(
+        route_handles[0], route_handles[1], start_time, interval, tp_func);
+
+    // The first request reads the clock and latches phase 4.
+    auto reply = rh.route(McGetRequest("key_get"));
+    EXPECT_EQ("b", carbon::valueRangeSlow(reply).str());
+    EXPECT_EQ(1, time_reads);
+
+    // After that, routing no longer consults the time provider at all.
+    rh.route(McGetRequest("key_get"));
+    rh.route(McDeleteRequest("key_del"));
+    int cnt = 0;
+    RouteHandleTraverser<TestRouteHandleIf> t{
+        [&cnt](const TestRouteHandleIf&) { ++cnt; }};
+    rh.traverse(McGetRequest("key_get"), t);
+    EXPECT_EQ(1, cnt);
+    EXPECT_EQ(1, time_reads);
+    EXPECT_EQ(vector<string>{}, test_handles[0]->saw_keys);
+    EXPECT_EQ(
+        (vector<string>{"key_get", "key_get", "key_del"}),
+        test_handles[1]->saw_keys);
+  });
+}
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "mcrouter/lib/MpscQueue.h"
+
+using namespace facebook::memcache;
+
+TEST(MpscQueue, fifoSingleProducer) {
+  MpscQueue<int> queue;
+  for (int i = 0; i < 1000; ++i) {
+    queue.push(i);
+  }
+  int value;
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(MpscQueue, emptyPop) {
+  MpscQueue<int> queue;
+  int value;
+  EXPECT_FALSE(queue.tryPop(value));
+  queue.push(42);
+  ASSERT_TRUE(queue.tryPop(value));
+  EXPECT_EQ(42, value);
+  EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(MpscQueue, multiProducer) {
+  constexpr size_t kProducers = 8;
+  constexpr size_t kPerProducer = 10000;
+
+  MpscQueue<std::pair<size_t, size_t>> queue;
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < kProducers; ++p) {
+    producers.emplace_back([p, &queue]() {
+      for (size_t i = 0; i < kPerProducer; ++i) {
+        queue.push(std::make_pair(p, i));
+      }
+    });
+  }
+
+  std::vector<size_t> nextExpected(kProducers, 0);
+  size_t popped = 0;
+  std::pair<size_t, size_t> value;
+  while (popped < kProducers * kPerProducer) {
+    if (queue.tryPop(value)) {
+      /* Per-producer order must be preserved. */
+      EXPECT_EQ(nextExpected[value.first]++, value.second);
+      ++popped;
+    }
+  }
+  EXPECT_FALSE(queue.tryPop(value));
+
+  for (auto& t : producers) {
+    t.join();
+  }
+}
+
+TEST(MpscQueue, destroyNonEmpty) {
+  MpscQueue<std::string> queue;
+  for (int i = 0; i < 100; ++i) {
+    queue.push(std::string(1000, 'x'));
+  }
+  /* Remaining elements must be destroyed with the queue. */
+}
@@ -73,6 +73,28 @@ TEST(RendezvousHashFunc, rendezvous_10) {
           {947, 1026, 1028, 981, 1016, 970, 1013, 939, 1023, 1057}));
 }
 
+TEST(RendezvousHashFunc, iterator) {
+  const size_t n = 343;
+  auto func = genRendezvousHashFunc(n);
+
+  for (size_t i = 0; i < 100; ++i) {
+    auto key = "mykey:" + folly::to<std::string>(i);
+
+    // First choice matches operator(); all indices show up exactly once.
+    std::vector<bool> seen(n, false);
+    size_t count = 0;
+    for (auto it = func.begin(key); it != func.end(); ++it) {
+      if (count == 0) {
+        EXPECT_EQ(func(key), *it);
+      }
+      EXPECT_FALSE(seen[*it]);
+      seen[*it] = true;
+      ++count;
+    }
+    EXPECT_EQ(n, count);
+  }
+}
+
 TEST(RendezvousHashFunc, rendezvous_rehash) {
   const uint32_t n = 499;
   auto combined = test::genEndpoints(n);
@@ -19,6 +19,7 @@
 #include "mcrouter/lib/routes/AllInitialRoute.h"
 #include "mcrouter/lib/routes/AllMajorityRoute.h"
 #include "mcrouter/lib/routes/AllSyncRoute.h"
+#include "mcrouter/lib/routes/HedgingRoute.h"
 #include "mcrouter/lib/routes/NullRoute.h"
 #include "mcrouter/lib/routes/SelectionRoute.h"
 #include "mcrouter/lib/test/RouteHandleTestUtil.h"
@@ -285,6 +286,89 @@ TEST(routeHandleTest, allFastest) {
   }
 }
 
+TEST(routeHandleTest, hedgingSlowPrimary) {
+  TestFiberManager fm;
+
+  vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "a")),
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "b"))};
+
+  TestRouteHandle<HedgingRoute<TestRouteHandleIf>> rh(
+      get_route_handles(test_handles),
+      /* budgetPercent */ 100,
+      /* minDelay */ std::chrono::microseconds(0),
+      /* maxDelay */ std::chrono::microseconds(0));
+
+  test_handles[0]->pause();
+
+  fm.runAll({[&]() {
+    auto reply = rh.route(McGetRequest("key"));
+
+    /* Primary is paused, so the hedged copy should win */
+    EXPECT_EQ(mc_res_found, reply.result());
+    EXPECT_EQ("b", carbon::valueRangeSlow(reply).str());
+    EXPECT_EQ(vector<string>{"key"}, test_handles[1]->saw_keys);
+
+    test_handles[0]->unpause();
+  }});
+
+  /* Primary completes in the background */
+  EXPECT_EQ(vector<string>{"key"}, test_handles[0]->saw_keys);
+}
+
+TEST(routeHandleTest, hedgingFastPrimary) {
+  TestFiberManager fm;
+
+  vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "a")),
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "b"))};
+
+  TestRouteHandle<HedgingRoute<TestRouteHandleIf>> rh(
+      get_route_handles(test_handles),
+      /* budgetPercent */ 100,
+      /* minDelay */ std::chrono::microseconds(0),
+      /* maxDelay */ std::chrono::microseconds(0));
+
+  fm.run([&]() {
+    auto reply = rh.route(McGetRequest("key"));
+
+    /* Primary replies immediately, so no hedged copy should be sent */
+    EXPECT_EQ(mc_res_found, reply.result());
+    EXPECT_EQ("a", carbon::valueRangeSlow(reply).str());
+    EXPECT_EQ(vector<string>{"key"}, test_handles[0]->saw_keys);
+    EXPECT_EQ(vector<string>{}, test_handles[1]->saw_keys);
+  });
+}
+
+TEST(routeHandleTest, hedgingBudgetExhausted) {
+  TestFiberManager fm;
+
+  vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "a")),
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "b"))};
+
+  TestRouteHandle<HedgingRoute<TestRouteHandleIf>> rh(
+      get_route_handles(test_handles),
+      /* budgetPercent */ 5,
+      /* minDelay */ std::chrono::microseconds(0),
+      /* maxDelay */ std::chrono::microseconds(0));
+
+  test_handles[0]->pause();
+
+  fm.runAll(
+      {[&]() {
+         auto reply = rh.route(McGetRequest("key"));
+
+         /* The budget doesn't allow a hedge yet, so we should have waited
+            for the primary */
+         EXPECT_EQ(mc_res_found, reply.result());
+         EXPECT_EQ("a", carbon::valueRangeSlow(reply).str());
+         EXPECT_EQ(vector<string>{"key"}, test_handles[0]->saw_keys);
+         EXPECT_EQ(vector<string>{}, test_handles[1]->saw_keys);
+       },
+       [&]() { test_handles[0]->unpause(); }});
+}
+
 class HashFunc {
  public:
   explicit HashFunc(size_t n) : n_(n) {}
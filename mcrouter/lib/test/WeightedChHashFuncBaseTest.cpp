@@ -8,8 +8,10 @@
 
 #include <gtest/gtest.h>
 
+#include <folly/Conv.h>
 #include <folly/json.h>
 
+#include "mcrouter/lib/WeightedCh3HashFunc.h"
 #include "mcrouter/lib/WeightedChHashFuncBase.h"
 
 using namespace facebook::memcache;
@@ -73,3 +75,26 @@ TEST(WeightedChHashFuncBase, parseWeightsTest) {
     }
   }
 }
+
+/// The all-weights-1.0 fast path must return the same indices as the
+/// full rejection-loop algorithm.
+TEST(WeightedChHashFuncBase, allWeightsOneFastPath) {
+  const size_t n = 97;
+  WeightedCh3HashFunc func(std::vector<double>(n, 1.0));
+  for (size_t i = 0; i < 1000; ++i) {
+    const auto key = folly::to<std::string>("key:", i);
+    ASSERT_EQ(WeightedCh3HashFunc::hash(key, func.weights()), func(key));
+  }
+}
+
+/// Hash functions built from equal weight vectors share one interned copy.
+TEST(WeightedChHashFuncBase, weightsInterned) {
+  const std::vector<double> weights{0.25, 0.5, 0.75, 1.0};
+  WeightedCh3HashFunc a{std::vector<double>(weights)};
+  WeightedCh3HashFunc b{std::vector<double>(weights)};
+  EXPECT_EQ(&a.weights(), &b.weights());
+
+  WeightedCh3HashFunc c{std::vector<double>{0.25, 0.5, 0.75, 0.99}};
+  EXPECT_NE(&a.weights(), &c.weights());
+  EXPECT_EQ(weights, a.weights());
+}
@@ -48,6 +48,31 @@ TEST(WeightedRendezvousHashFunc, basic) {
   EXPECT_EQ(func343("mykey"), 302);
 }
 
+TEST(WeightedRendezvousHashFunc, iterator) {
+  auto endpoints = genEndpoints(50);
+  std::vector<double> weights(50, 0.5);
+  weights[7] = 1.0;
+  auto jWeights = genWeights(endpoints.second, weights);
+  auto func = WeightedRendezvousHashFunc(endpoints.second, jWeights);
+
+  for (size_t i = 0; i < 100; ++i) {
+    auto key = "mykey:" + folly::to<std::string>(i);
+
+    // First choice matches operator(); all indices show up exactly once.
+    std::vector<bool> seen(50, false);
+    size_t count = 0;
+    for (auto it = func.begin(key); it != func.end(); ++it) {
+      if (count == 0) {
+        EXPECT_EQ(func(key), *it);
+      }
+      EXPECT_FALSE(seen[*it]);
+      seen[*it] = true;
+      ++count;
+    }
+    EXPECT_EQ(50, count);
+  }
+}
+
 TEST(WeightedRendezvousHashFunc, rendezvous_3) {
   // 3 endpoints with same weights.
   auto endpoints3 = genEndpoints(3);
@@ -76,6 +76,86 @@ MCROUTER_OPTION_TOGGLE(
     no_short,
     "Enable using the asynclog version 2.0")
 
+MCROUTER_OPTION_TOGGLE(
+    use_asynclog_version3,
+    false,
+    "use-asynclog-version3",
+    no_short,
+    "Enable the asynclog version 3.0 binary spool format with group"
+    " commit. Takes precedence over use-asynclog-version2.")
+
+MCROUTER_OPTION_INTEGER(
+    size_t,
+    asynclog_batch_size,
+    64,
+    "asynclog-batch-size",
+    no_short,
+    "Only used with use-asynclog-version3. Number of spool entries that"
+    " are group-committed with a single write.")
+
+MCROUTER_OPTION_INTEGER(
+    unsigned int,
+    asynclog_flush_interval_ms,
+    10,
+    "asynclog-flush-interval-ms",
+    no_short,
+    "Only used with use-asynclog-version3. Maximum age of a buffered"
+    " spool entry before the batch is flushed.")
+
+MCROUTER_OPTION_INTEGER(
+    size_t,
+    asynclog_preallocate_kb,
+    0,
+    "asynclog-preallocate-kb",
+    no_short,
+    "Only used with use-asynclog-version3. If non-zero, reserve this much"
+    " space (best effort, size unchanged) for each new spool file so"
+    " appends don't block on block allocation.")
+
+MCROUTER_OPTION_TOGGLE(
+    asynclog_dedup_deletes,
+    false,
+    "asynclog-dedup-deletes",
+    no_short,
+    "Suppress spooling a delete for the same destination, pool and key"
+    " more than once per asynclog file window. During outages most"
+    " spooled deletes repeat the same hot keys and replay hammers the"
+    " recovered box with redundant work. Uses a bloom filter, so with"
+    " very low probability a distinct delete can be wrongly suppressed;"
+    " leave disabled if every spooled delete must be replayed.")
+
+MCROUTER_OPTION_INTEGER(
+    unsigned int,
+    asynclog_grace_window_ms,
+    0,
+    "asynclog-grace-window-ms",
+    no_short,
+    "If non-zero, hold failed deletes in memory for this long and replay"
+    " them directly once the destination recovers, spooling to disk only"
+    " if it is still unreachable afterwards. Entries buffered in memory"
+    " are lost if mcrouter exits within the window. (0 to disable)")
+
+MCROUTER_OPTION_TOGGLE(
+    asynclog_replay,
+    false,
+    "asynclog-replay",
+    no_short,
+    "Replay version 3 asynclog spool files through this router's own"
+    " route tree from a background thread, unlinking each file once"
+    " fully replayed. Replay pace follows the destination's live health"
+    " and pauses while it is TKO or soft errors rise, so recovery isn't"
+    " fought by an out-of-band replayer.")
+
+MCROUTER_OPTION_INTEGER(
+    size_t,
+    asynclog_replay_rate,
+    1000,
+    "asynclog-replay-rate",
+    no_short,
+    "Only used with asynclog-replay. Maximum replayed deletes per second"
+    " against a fully healthy destination; scaled down as soft errors"
+    " rise.")
+
 MCROUTER_OPTION_INTEGER(
     size_t,
     num_proxies,
@@ -92,13 +172,49 @@ MCROUTER_OPTION_INTEGER(
     no_short,
     "adjust how many listening sockets to use. Must be <= num_proxies")
 
+MCROUTER_OPTION_INTEGER(
+    size_t,
+    elastic_proxy_min_active,
+    0,
+    "elastic-proxy-min-active",
+    no_short,
+    "Enable elastic proxy scaling: keep at least this many proxies"
+    " active for new client placement and park the rest while load is"
+    " low, concentrating off-peak traffic on fewer threads. Parked"
+    " proxies keep serving clients already placed on them and unpark"
+    " within tens of milliseconds under load. Only affects clients"
+    " placed via nextProxyIndex(); has no effect on standalone mcrouter,"
+    " where every server thread is pinned to its own proxy."
+    " (0 to disable)")
+
+MCROUTER_OPTION_INTEGER(
+    size_t,
+    elastic_proxy_park_max_requests,
+    4,
+    "elastic-proxy-park-max-requests",
+    no_short,
+    "Park one more proxy after a sustained period (about a second) in"
+    " which every active proxy has fewer than this many requests in"
+    " flight. Requires --elastic-proxy-min-active.")
+
+MCROUTER_OPTION_INTEGER(
+    size_t,
+    elastic_proxy_unpark_min_requests,
+    32,
+    "elastic-proxy-unpark-min-requests",
+    no_short,
+    "Unpark a proxy as soon as the average requests in flight across"
+    " active proxies exceeds this. Requires --elastic-proxy-min-active.")
+
 MCROUTER_OPTION_INTEGER(
     size_t,
     client_queue_size,
     1024,
     no_long,
     no_short,
-    "McrouterClient -> ProxyThread queue size.")
+    "McrouterClient -> ProxyThread queue size."
+    "  If 0, the queue is unbounded (lock-free MPSC mode) and sends never"
+    " block on a full queue.")
 
 MCROUTER_OPTION_INTEGER(
     size_t,
@@ -120,6 +236,43 @@ MCROUTER_OPTION_INTEGER(
     "Force client queue notification if last drain was at least this long ago."
     "  If 0, this logic is disabled.")
 
+MCROUTER_OPTION_TOGGLE(
+    client_queue_dispatch_sorting,
+    false,
+    "client-queue-dispatch-sorting",
+    no_short,
+    "Dispatch client queue messages in chunks grouped by request operation"
+    " instead of strict arrival order, so same-operation requests run"
+    " back-to-back and share instruction cache footprint. Requests with"
+    " the same operation keep their order; across operations, requests may"
+    " begin routing out of arrival order within a chunk, so clients that"
+    " pipeline dependent operations without waiting for replies should"
+    " leave this off.")
+
+MCROUTER_OPTION_INTEGER(
+    size_t,
+    proxy_busy_poll_us,
+    0,
+    "proxy-busy-poll-us",
+    no_short,
+    "If non-zero, proxy event loops busy-poll for this many microseconds"
+    " after the last drained client queue message before going back to"
+    " sleeping in epoll_wait, trading CPU for wakeup latency on the"
+    " request path. Only sensible when cores are dedicated to mcrouter."
+    "  If 0, this logic is disabled.")
+
+MCROUTER_OPTION_INTEGER(
+    size_t,
+    proxy_loop_slice_threshold_us,
+    50000,
+    "proxy-loop-slice-threshold-us",
+    no_short,
+    "Instrumented event loop slices (message queue drain, config"
+    " reclamation) that run longer than this stall every request on the"
+    " proxy thread; count them in the loop_stalls stat and log a"
+    " rate-limited warning naming the offender."
+    "  If 0, the watchdog is disabled.")
+
 MCROUTER_OPTION_INTEGER(
     size_t,
     big_value_split_threshold,
@@ -135,8 +288,9 @@ MCROUTER_OPTION_INTEGER(
     10,
     "big-value-batch-size",
     no_short,
-    "If nonzero, big value chunks are written/read in batches of at most"
-    " this size.  Used to prevent queue build up with really large values")
+    "If nonzero, at most this many big value chunks are written/read"
+    " concurrently per request.  Used to prevent queue build up with really"
+    " large values")
 
 MCROUTER_OPTION_INTEGER(
     size_t,
@@ -240,6 +394,49 @@ MCROUTER_OPTION_INTEGER(
     "Maximum number of non-blocking event loops before we flush batched "
     "requests")
 
+MCROUTER_OPTION_INTEGER(
+    unsigned int,
+    destination_flush_delay_us,
+    0,
+    "destination-flush-delay-us",
+    no_short,
+    "Maximum time (in us) to delay flushing writes to a destination while"
+    " new requests keep arriving, to build larger batches and cut syscalls"
+    " per request under load. 0 to disable the extra delay.")
+
+MCROUTER_OPTION_TOGGLE(
+    destination_flush_align,
+    false,
+    "destination-flush-align",
+    no_short,
+    "Align destination flushes to a process-wide time grid (period"
+    " destination-flush-delay-us, phase derived from the destination host),"
+    " so that proxy threads talking to the same box flush together and the"
+    " destination sees fewer, larger packets. Requires a non-zero"
+    " destination-flush-delay-us.")
+
+MCROUTER_OPTION_INTEGER(
+    unsigned int,
+    destination_flush_jitter_us,
+    0,
+    "destination-flush-jitter-us",
+    no_short,
+    "Delay each flush to a destination by a uniformly random time up to"
+    " this many us, to desynchronize the many mcrouter hosts writing to a"
+    " hot destination and avoid incast drops at its switch port. The"
+    " inverse of destination-flush-align; takes precedence over"
+    " destination-flush-delay-us. 0 to disable.")
+
+MCROUTER_OPTION_INTEGER(
+    size_t,
+    destination_max_pacing_rate,
+    0,
+    "destination-max-pacing-rate",
+    no_short,
+    "If non-zero, set SO_MAX_PACING_RATE (bytes/sec) on destination"
+    " sockets where supported, so the kernel spreads each write batch out"
+    " over time instead of sending it as a line-rate burst. 0 to disable.")
+
 MCROUTER_OPTION_INTEGER(
     unsigned int,
     reset_inactive_connection_interval,
@@ -249,6 +446,18 @@ MCROUTER_OPTION_INTEGER(
     "Will close open connections without any activity after at most 2 * interval"
     " ms. If value is 0, connections won't be closed.")
 
+MCROUTER_OPTION_INTEGER(
+    unsigned int,
+    keep_warm_connection_interval_ms,
+    0,
+    "keep-warm-connection-interval-ms",
+    no_short,
+    "If non-zero, periodically pings idle destinations (with a version"
+    " command) at this interval, establishing connections eagerly after a"
+    " config swap and keeping established ones warm so requests after an"
+    " idle period don't pay connect/TLS latency. Pinged connections are"
+    " considered active and won't be closed as inactive. 0 to disable.")
+
 MCROUTER_OPTION_INTEGER(
     int,
     tcp_rto_min,
@@ -266,6 +475,26 @@ MCROUTER_OPTION_INTEGER(
     "Maximum inflight requests allowed per target per thread"
     " (0 means no throttling)")
 
+MCROUTER_OPTION_INTEGER(
+    uint64_t,
+    target_max_inflight_bytes,
+    0,
+    "target-max-inflight-bytes",
+    no_short,
+    "Maximum total serialized request bytes allowed inflight per target"
+    " per thread, so a few large requests cannot monopolize a connection"
+    " (0 means no byte limit)")
+
+MCROUTER_OPTION_INTEGER(
+    uint64_t,
+    target_tcp_zero_copy_threshold,
+    0,
+    "target-tcp-zero-copy-threshold",
+    no_short,
+    "Requests to a destination containing a buffer of at least this many"
+    " bytes (e.g. the value of a large set) will use the TCP zero copy"
+    " optimization on TX. 0 disables zero copy.")
+
 MCROUTER_OPTION_INTEGER(
     uint64_t,
     target_max_pending_requests,
@@ -396,6 +625,19 @@ MCROUTER_OPTION_TOGGLE(
     "compression algorithms/dictionaries supported by the client. Only "
     "compresses caret protocol replies.")
 
+MCROUTER_OPTION_INTEGER(
+    uint64_t,
+    compression_auto_disable_savings_pct,
+    0,
+    "compression-auto-disable-savings-pct",
+    no_short,
+    "Minimum percent size reduction that compressed replies from a "
+    "destination must achieve for that connection to keep advertising "
+    "compression codecs. Measured over windows of compressed reply "
+    "traffic; a connection that stays below the threshold stops "
+    "advertising codecs and gets uncompressed replies from then on, "
+    "saving codec CPU on both sides. 0 (default) disables the check.")
+
 MCROUTER_OPTION_GROUP("Routing configuration")
 
 MCROUTER_OPTION_TOGGLE(
@@ -445,6 +687,16 @@ MCROUTER_OPTION_INTEGER(
     "Max age of backup config files that mcrouter is allowed to use"
     " (in seconds). 0 to disable using dumped configs.")
 
+MCROUTER_OPTION_STRING(
+    config_preprocess_cache_file,
+    "",
+    "config-preprocess-cache-file",
+    no_short,
+    "If set, cache the preprocessed (macro-expanded) config in this file,"
+    " keyed by a hash of the config source and global params; imports are"
+    " revalidated by content hash. Reconfigures whose inputs are unchanged"
+    " skip macro expansion entirely. Empty string to disable.")
+
 MCROUTER_OPTION_STRING(
     config_file,
     "",
@@ -514,6 +766,17 @@ MCROUTER_OPTION_INTEGER(
     no_short,
     "Delay between config files change and mcrouter reconfiguration.")
 
+MCROUTER_OPTION_INTEGER(
+    int,
+    reconfiguration_jitter_ms,
+    0,
+    "reconfiguration-jitter-ms",
+    no_short,
+    "Additional random delay in [0, this] before applying a config change."
+    " Each process draws its own delay, so co-hosted mcrouter instances"
+    " that see the same config push spread their reconfiguration CPU cost"
+    " over the window instead of spiking together. (0 to disable)")
+
 MCROUTER_OPTION_INTEGER(
     int,
     post_reconfiguration_delay_ms,
@@ -556,6 +819,15 @@ MCROUTER_OPTION_INTEGER(
     no_short,
     "TKO probe retry max timeout in ms")
 
+MCROUTER_OPTION_INTEGER(
+    int,
+    probe_max_per_second,
+    0,
+    "probe-max-per-second",
+    no_short,
+    "Cap on TKO probes sent per second across the whole router instance, "
+    "bounding probe traffic during large outages. 0 means unlimited.")
+
 MCROUTER_OPTION_INTEGER(
     int,
     failures_until_tko,
@@ -564,6 +836,28 @@ MCROUTER_OPTION_INTEGER(
     no_short,
     "Mark as TKO after this many failures")
 
+MCROUTER_OPTION_INTEGER(
+    uint64_t,
+    latency_tko_multiplier,
+    0,
+    "latency-tko-multiplier",
+    no_short,
+    "If non-zero, mark a destination soft TKO when its p95 reply latency"
+    " stays above this multiple of its pool's median request duration for"
+    " latency-tko-window-ms. Requires pool-stats-config-file and"
+    " latency-histogram-sample-rate, which feed the pool median."
+    " 0 (the default) disables latency-based TKO.")
+
+MCROUTER_OPTION_INTEGER(
+    uint64_t,
+    latency_tko_window_ms,
+    5000,
+    "latency-tko-window-ms",
+    no_short,
+    "How long the latency-tko-multiplier condition must hold before the"
+    " destination is marked soft TKO. Only used when latency-tko-multiplier"
+    " is non-zero.")
+
 MCROUTER_OPTION_TOGGLE(
     allow_only_gets,
     false,
@@ -620,6 +914,61 @@ MCROUTER_OPTION_INTEGER(
     " discarded. Enabled only if value is non-zero and"
     " if proxy-max-throttled-requests is enabled.")
 
+MCROUTER_OPTION_INTEGER(
+    unsigned int,
+    deadline_budget_ms,
+    0,
+    "deadline-budget-ms",
+    no_short,
+    "If non-zero, every request gets a total latency budget of this many ms"
+    " when routing starts. Requests (including failover and shadow sends)"
+    " whose remaining budget is below the destination's smoothed latency are"
+    " dropped with mc_res_busy instead of being sent, shedding work that"
+    " could not reply in time anyway. 0 to disable.")
+
+MCROUTER_OPTION_INTEGER(
+    unsigned int,
+    negative_cache_ttl_ms,
+    0,
+    "negative-cache-ttl-ms",
+    no_short,
+    "If non-zero, each proxy remembers keys whose gets recently missed and"
+    " answers repeated McGetRequests for them with mc_res_notfound for this"
+    " many ms without routing downstream. Sets and deletes routed through the"
+    " same proxy invalidate the entry immediately. Intended to be sub-second."
+    " 0 to disable.")
+
+MCROUTER_OPTION_INTEGER(
+    size_t,
+    negative_cache_entries,
+    16384,
+    "negative-cache-entries",
+    no_short,
+    "Number of slots in the per-proxy negative cache; rounded up to a power"
+    " of two. Only used if negative-cache-ttl-ms is non-zero.")
+
+MCROUTER_OPTION_TOGGLE(
+    coalesce_same_key_deletes,
+    false,
+    "coalesce-same-key-deletes",
+    no_short,
+    "If enabled, a delete whose key already has an identical delete in"
+    " flight to the same destination waits for that delete's reply and"
+    " shares it instead of sending a duplicate. Collapses invalidation"
+    " storms that repeat keys. Note that the duplicate observes the first"
+    " delete's result (e.g. mc_res_deleted rather than mc_res_notfound).")
+
+MCROUTER_OPTION_TOGGLE(
+    collapse_inflight_gets,
+    false,
+    "collapse-inflight-gets",
+    no_short,
+    "If enabled, a get whose key already has an identical get in flight"
+    " to the same destination waits for that get's reply and shares it"
+    " instead of sending a duplicate. Collapses thundering herds on hot"
+    " keys. Note that a collapsed get observes the reply of a request"
+    " sent slightly earlier, so it may miss a concurrent update.")
+
 MCROUTER_OPTION_INTEGER(
     unsigned int,
     connect_timeout_retries,
@@ -642,6 +991,27 @@ MCROUTER_OPTION_TOGGLE(
     " part of any core dump. This is achieved by setting MADV_DONTDUMP on"
     " explicitly created jemalloc arenas. The default value is false.")
 
+MCROUTER_OPTION_TOGGLE(
+    jemalloc_per_proxy_arena,
+    false,
+    "jemalloc-per-proxy-arena",
+    no_short,
+    "Bind each proxy thread to its own explicitly created jemalloc arena."
+    " This keeps request-path allocations of different proxy threads from"
+    " contending on shared arenas and from reusing each other's cache lines."
+    " Has no effect if the binary is not running with jemalloc.")
+
+MCROUTER_OPTION_TOGGLE(
+    numa_aware_proxy_threads,
+    false,
+    "numa-aware-proxy-threads",
+    no_short,
+    "Partition proxy threads across NUMA nodes: proxy i is pinned to the"
+    " CPUs of node (i % number of nodes). With the kernel's first-touch"
+    " policy the thread's on-thread allocations (fiber stacks, parser and"
+    " write buffers) then come from node-local memory. Has no effect on"
+    " single-node hosts or when the NUMA topology cannot be read.")
+
 MCROUTER_OPTION_GROUP("Logging")
 
 MCROUTER_OPTION_STRING(
@@ -666,6 +1036,40 @@ MCROUTER_OPTION_INTEGER(
     no_short,
     "Time in ms between stats reports, or 0 for no logging")
 
+MCROUTER_OPTION_INTEGER(
+    uint64_t,
+    latency_histogram_sample_rate,
+    0,
+    "latency-histogram-sample-rate",
+    no_short,
+    "If non-zero, record every Nth request duration into a per-pool latency"
+    " histogram, queryable via the pool_latency_percentile service command."
+    " Only pools listed in pool-stats-config-file are tracked."
+    " 0 (the default) disables histogram recording.")
+
+MCROUTER_OPTION_INTEGER(
+    uint64_t,
+    route_handle_profiler_hz,
+    0,
+    "route-handle-profiler-hz",
+    no_short,
+    "If non-zero, sample up to this many requests per second per proxy"
+    " thread and aggregate their durations by route handle path, queryable"
+    " via the route_handle_profile service command."
+    " 0 (the default) disables the profiler.")
+
+MCROUTER_OPTION_INTEGER(
+    uint64_t,
+    trace_sample_rate,
+    0,
+    "trace-sample-rate",
+    no_short,
+    "If non-zero, stamp a trace id into roughly 1 in N incoming requests"
+    " that do not already carry one. The id travels in the Caret header to"
+    " downstream servers, and each destination send of a traced request is"
+    " recorded as a span in <stats-root>/<stat prefix>.traces."
+    " 0 (the default) disables trace sampling.")
+
 MCROUTER_OPTION_INTEGER(
     unsigned int,
     logging_rtt_outlier_threshold_us,
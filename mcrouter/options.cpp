@@ -234,6 +234,33 @@ vector<McrouterOptionError> McrouterOptionsBase::updateFromDict(
   return errors;
 }
 
+bool McrouterOptionsBase::isRuntimeMutable(const string& name) {
+  static const unordered_set<string> kRuntimeMutable{
+      "probe_delay_initial_ms",
+      "probe_delay_max_ms",
+      "probe_max_per_second",
+      "proxy_max_inflight_requests",
+      "proxy_max_throttled_requests",
+      "reconfiguration_delay_ms",
+      "reconfiguration_jitter_ms",
+  };
+  return kRuntimeMutable.find(name) != kRuntimeMutable.end();
+}
+
+vector<McrouterOptionError> McrouterOptionsBase::updateRuntimeMutableFromDict(
+    const unordered_map<string, string>& new_opts) {
+  unordered_map<string, string> mutableOpts;
+  for (const auto& kv : new_opts) {
+    if (isRuntimeMutable(kv.first)) {
+      mutableOpts.insert(kv);
+    }
+  }
+  if (mutableOpts.empty()) {
+    return {};
+  }
+  return updateFromDict(mutableOpts);
+}
+
 namespace options {
 
 string substituteTemplates(string str) {
@@ -74,6 +74,25 @@ class McrouterOptionsBase {
   std::vector<McrouterOptionError> updateFromDict(
       const std::unordered_map<std::string, std::string>& new_opts);
 
+  /**
+   * True if the named option may be changed on a live router without a
+   * restart. Only word-sized scalar options that are read at the point of
+   * use (never baked into constructed objects or threads at startup)
+   * qualify: an in-place store is picked up by the next read, and
+   * concurrent readers may briefly see the old value but never a torn one.
+   */
+  static bool isRuntimeMutable(const std::string& name);
+
+  /**
+   * Applies the runtime-mutable subset of new_opts in place; entries for
+   * options that are not runtime-mutable are silently ignored.
+   *
+   * @return errors for entries that named a mutable option but failed to
+   *         parse, in the same format as updateFromDict().
+   */
+  std::vector<McrouterOptionError> updateRuntimeMutableFromDict(
+      const std::unordered_map<std::string, std::string>& new_opts);
+
   virtual ~McrouterOptionsBase() {}
 
   virtual void forEach(std::function<void(
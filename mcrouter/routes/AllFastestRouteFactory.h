@@ -7,11 +7,15 @@
  */
 #pragma once
 
+#include <chrono>
+
 #include <folly/dynamic.h>
 
 #include "mcrouter/lib/config/RouteHandleBuilder.h"
 #include "mcrouter/lib/config/RouteHandleFactory.h"
+#include "mcrouter/lib/fbi/cpp/util.h"
 #include "mcrouter/lib/routes/AllFastestRoute.h"
+#include "mcrouter/lib/routes/HedgingRoute.h"
 #include "mcrouter/lib/routes/NullRoute.h"
 
 namespace facebook {
@@ -35,6 +39,48 @@ typename RouterInfo::RouteHandlePtr makeAllFastestRoute(
       std::move(rh));
 }
 
+template <class RouterInfo>
+typename RouterInfo::RouteHandlePtr makeHedgingRoute(
+    std::vector<typename RouterInfo::RouteHandlePtr> rh,
+    const folly::dynamic& json) {
+  checkLogic(
+      rh.size() >= 2, "AllFastestRoute: hedging requires at least 2 children");
+
+  size_t budgetPercent = 5;
+  if (auto jbudget = json.get_ptr("budget_percent")) {
+    checkLogic(
+        jbudget->isInt() && jbudget->getInt() > 0 &&
+            jbudget->getInt() <= 100,
+        "AllFastestRoute: hedging budget_percent must be an integer in "
+        "(0, 100]");
+    budgetPercent = jbudget->getInt();
+  }
+  uint64_t minDelayUs = 1000;
+  if (auto jminDelay = json.get_ptr("min_delay_us")) {
+    checkLogic(
+        jminDelay->isInt() && jminDelay->getInt() >= 0,
+        "AllFastestRoute: hedging min_delay_us must be a non-negative "
+        "integer");
+    minDelayUs = jminDelay->getInt();
+  }
+  uint64_t maxDelayUs = 50000;
+  if (auto jmaxDelay = json.get_ptr("max_delay_us")) {
+    checkLogic(
+        jmaxDelay->isInt() && jmaxDelay->getInt() > 0,
+        "AllFastestRoute: hedging max_delay_us must be a positive integer");
+    maxDelayUs = jmaxDelay->getInt();
+  }
+  checkLogic(
+      minDelayUs <= maxDelayUs,
+      "AllFastestRoute: hedging min_delay_us must not exceed max_delay_us");
+
+  return makeRouteHandle<typename RouterInfo::RouteHandleIf, HedgingRoute>(
+      std::move(rh),
+      budgetPercent,
+      std::chrono::microseconds(minDelayUs),
+      std::chrono::microseconds(maxDelayUs));
+}
+
 } // detail
 
 template <class RouterInfo>
@@ -46,6 +92,12 @@ typename RouterInfo::RouteHandlePtr makeAllFastestRoute(
     if (auto jchildren = json.get_ptr("children")) {
       children = factory.createList(*jchildren);
     }
+    if (auto jhedging = json.get_ptr("hedging")) {
+      checkLogic(
+          jhedging->isObject(), "AllFastestRoute: hedging must be an object");
+      return detail::makeHedgingRoute<RouterInfo>(
+          std::move(children), *jhedging);
+    }
   } else {
     children = factory.createList(json);
   }
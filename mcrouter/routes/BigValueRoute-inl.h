@@ -68,23 +68,29 @@ BigValueRoute::collectAllByBatches(FuncIt beginF, FuncIt endF) const {
   using Reply = typename std::result_of<
       typename std::iterator_traits<FuncIt>::value_type()>::type;
 
-  auto batchSize = options_.batchSize;
   const size_t rangeSize = std::distance(beginF, endF);
-  if (batchSize == 0) {
-    batchSize = rangeSize;
+  size_t concurrency = options_.batchSize;
+  if (concurrency == 0 || concurrency > rangeSize) {
+    concurrency = rangeSize;
   }
 
-  std::vector<Reply> allReplies;
-  size_t b = 0;
-  size_t e = std::min(rangeSize, batchSize);
-  while (b < rangeSize) {
-    auto replies = folly::fibers::collectAll(beginF + b, beginF + e);
-    for (auto& r : replies) {
-      allReplies.emplace_back(std::move(r));
+  // Sliding window: at most 'concurrency' chunk requests are outstanding,
+  // but a new one is issued as soon as any completes. Fixed batch rounds
+  // would instead stall the whole window on the slowest reply, adding up
+  // to one straggler RTT per round. Replies land in their preallocated
+  // slot, so they come back in order with no reassembly pass.
+  std::vector<Reply> allReplies(rangeSize);
+  // Worker fibers all run on this thread, so plain counters are safe.
+  size_t nextIndex = 0;
+  auto worker = [&allReplies, &nextIndex, rangeSize, beginF]() {
+    while (nextIndex < rangeSize) {
+      const size_t idx = nextIndex++;
+      allReplies[idx] = (*(beginF + idx))();
     }
-    b = e;
-    e = std::min(rangeSize, e + batchSize);
-  }
+  };
+
+  std::vector<std::function<void()>> workers(concurrency, worker);
+  folly::fibers::collectAll(workers.begin(), workers.end());
   return allReplies;
 }
 
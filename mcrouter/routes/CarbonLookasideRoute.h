@@ -6,11 +6,13 @@
  */
 #pragma once
 
+#include <array>
 #include <string>
 #include <utility>
 
 #include <folly/Conv.h>
 #include <folly/Range.h>
+#include <folly/hash/SpookyHashV2.h>
 #include <folly/io/IOBuf.h>
 
 #include "mcrouter/CarbonRouterFactory.h"
@@ -93,11 +95,12 @@ class CarbonLookasideRoute {
  public:
   std::string routeName() const {
     return folly::sformat(
-        "lookaside-cache|name={}|ttl={}{}s|leases={}",
+        "lookaside-cache|name={}|ttl={}{}s|leases={}{}",
         carbonLookasideHelper_.name(),
         ttl_,
         subSecTTL_ ? "m" : "",
-        leaseSettings_.enableLeases ? "true" : "false");
+        leaseSettings_.enableLeases ? "true" : "false",
+        hashedKeys_ ? "|hashed_keys" : "");
   }
 
   /**
@@ -113,6 +116,9 @@ class CarbonLookasideRoute {
    *                      helper.
    * @param keySplitSize  Tells how many different keys we want to have for
    *                      the same request. Useful for dealing with hot keys.
+   * @param hashedKeys    Replace the helper-generated key with a fixed-size
+   *                      hex digest of its 128-bit hash. Bounds the memcache
+   *                      key length regardless of the original key size.
    * @param ttl           TTL of items stored in memcache by this route handle.
    *                      Defaults to use seconds but can be milliseconds when
    *                      the subSecTTL parameter is configured.
@@ -129,6 +135,7 @@ class CarbonLookasideRoute {
       CarbonRouterClient<MemcacheRouterInfo>::Pointer client,
       std::string prefix,
       size_t keySplitSize,
+      bool hashedKeys,
       int32_t ttl,
       bool subSecTTL,
       CarbonLookasideHelper helper,
@@ -137,7 +144,8 @@ class CarbonLookasideRoute {
         router_(std::move(router)),
         client_(std::move(client)),
         keyPrefix_(std::move(prefix)),
-        keySuffix_(buildKeySuffix(keySplitSize)),
+        keySuffix_(buildKeySuffix(keySplitSize, subSecTTL)),
+        hashedKeys_(hashedKeys),
         ttl_(ttl),
         subSecTTL_(subSecTTL),
         carbonLookasideHelper_(std::move(helper)),
@@ -180,7 +188,10 @@ class CarbonLookasideRoute {
   const std::shared_ptr<CarbonRouterInstance<MemcacheRouterInfo>> router_;
   const CarbonRouterClient<MemcacheRouterInfo>::Pointer client_;
   const std::string keyPrefix_;
+  // Everything that follows the helper key. Built once at construction,
+  // including the trailing ":" separating the sub-second ttl bucket.
   const std::string keySuffix_;
+  const bool hashedKeys_;
   const int32_t ttl_;
   const bool subSecTTL_;
   CarbonLookasideHelper carbonLookasideHelper_;
@@ -372,23 +383,48 @@ class CarbonLookasideRoute {
 
   template <typename Request>
   std::string buildKey(const Request& req) {
+    const auto helperKey = carbonLookasideHelper_.buildKey(req);
+    folly::StringPiece body(helperKey);
+    std::array<char, 32> digest;
+    if (hashedKeys_) {
+      digestKey(body, digest);
+      body.reset(digest.data(), digest.size());
+    }
+    // keyPrefix_ and keySuffix_ are constants, so the pieces below are
+    // assembled with a single exactly-sized allocation.
     if (subSecTTL_) {
       return folly::to<std::string>(
-          keyPrefix_,
-          carbonLookasideHelper_.buildKey(req),
-          keySuffix_,
-          ":",
-          getSubSecondTtlKeySuffix());
+          keyPrefix_, body, keySuffix_, getSubSecondTtlKeySuffix());
     }
-    return folly::to<std::string>(
-        keyPrefix_, carbonLookasideHelper_.buildKey(req), keySuffix_);
+    return folly::to<std::string>(keyPrefix_, body, keySuffix_);
   }
 
-  static std::string buildKeySuffix(size_t keySplitSize) {
-    if (keySplitSize <= 1) {
-      return "";
+  /**
+   * Writes the hex digest of a 128-bit hash of key into out. Hex rather
+   * than the raw hash bytes keeps the result safe for the ascii protocol.
+   */
+  static void digestKey(folly::StringPiece key, std::array<char, 32>& out) {
+    uint64_t hash1 = 0;
+    uint64_t hash2 = 0;
+    folly::hash::SpookyHashV2::Hash128(key.data(), key.size(), &hash1, &hash2);
+    static constexpr char kHexChars[] = "0123456789abcdef";
+    size_t pos = 0;
+    for (const auto word : {hash1, hash2}) {
+      for (int shift = 60; shift >= 0; shift -= 4) {
+        out[pos++] = kHexChars[(word >> shift) & 0xf];
+      }
     }
-    return folly::to<std::string>(":ks", globals::hostid() % keySplitSize);
+  }
+
+  static std::string buildKeySuffix(size_t keySplitSize, bool subSecTTL) {
+    std::string suffix;
+    if (keySplitSize > 1) {
+      suffix = folly::to<std::string>(":ks", globals::hostid() % keySplitSize);
+    }
+    if (subSecTTL) {
+      suffix += ":";
+    }
+    return suffix;
   }
 };
 
@@ -400,6 +436,7 @@ class CarbonLookasideRoute {
  *   "child": "PoolRoute|A",
  *   "ttl": 10, // 10 seconds
  *   "key_split_size": 3, // we will have 3 different keys for the same request
+ *   "hashed_keys": false, // replace keys with a fixed-size hash digest
  *   "prefix": "reg",
  *   "flavor": "web",
  *   "helper_config": {
@@ -474,6 +511,14 @@ typename RouterInfo::RouteHandlePtr createCarbonLookasideRoute(
     keySplitSize = jKeySplitSize->getInt();
   }
 
+  bool hashedKeys = false;
+  if (auto jHashedKeys = json.get_ptr("hashed_keys")) {
+    checkLogic(
+        jHashedKeys->isBool(),
+        "CarbonLookasideRoute: 'hashed_keys' is not a bool");
+    hashedKeys = jHashedKeys->getBool();
+  }
+
   LeaseSettings leaseSettings = parseLeaseSettings(json);
 
   auto helperConfig = json.get_ptr("helper_config");
@@ -517,6 +562,7 @@ typename RouterInfo::RouteHandlePtr createCarbonLookasideRoute(
       std::move(client),
       std::move(prefix),
       keySplitSize,
+      hashedKeys,
       ttl,
       subSecTTL,
       std::move(helper),
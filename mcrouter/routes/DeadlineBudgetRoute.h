@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <cassert>
+#include <memory>
+#include <string>
+
+#include <folly/Format.h>
+
+#include "mcrouter/McrouterFiberContext.h"
+#include "mcrouter/config.h"
+#include "mcrouter/lib/Operation.h"
+#include "mcrouter/lib/RouteHandleTraverser.h"
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+/**
+ * Gives the subtree below it a total time budget: on entry the
+ * fiber-local deadline becomes now + budget, and destinations under this
+ * route split whatever remains of it across failover attempts instead of
+ * each spending its full static timeout (see DestinationRoute).
+ *
+ * A tighter deadline already set by an outer route or by
+ * --deadline-budget-ms is never loosened.
+ */
+template <class RouterInfo>
+class DeadlineBudgetRoute {
+ private:
+  using RouteHandleIf = typename RouterInfo::RouteHandleIf;
+
+ public:
+  std::string routeName() const {
+    return folly::sformat("deadline-budget|ms={}", budgetUs_ / 1000);
+  }
+
+  DeadlineBudgetRoute(std::shared_ptr<RouteHandleIf> target, int64_t budgetMs)
+      : target_(std::move(target)), budgetUs_(budgetMs * 1000) {
+    assert(budgetUs_ > 0);
+  }
+
+  template <class Request>
+  void traverse(
+      const Request& req,
+      const RouteHandleTraverser<RouteHandleIf>& t) const {
+    t(*target_, req);
+  }
+
+  template <class Request>
+  ReplyT<Request> route(const Request& req) const {
+    const auto deadlineUs = nowUs() + budgetUs_;
+    const auto outerDeadlineUs = fiber_local<RouterInfo>::getDeadlineUs();
+    if (outerDeadlineUs != 0 && outerDeadlineUs <= deadlineUs) {
+      return target_->route(req);
+    }
+    return fiber_local<RouterInfo>::runWithLocals([this, &req, deadlineUs]() {
+      fiber_local<RouterInfo>::setDeadlineUs(deadlineUs);
+      return target_->route(req);
+    });
+  }
+
+ private:
+  const std::shared_ptr<RouteHandleIf> target_;
+  const int64_t budgetUs_;
+};
+
+} // mcrouter
+} // memcache
+} // facebook
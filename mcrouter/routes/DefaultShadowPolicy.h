@@ -25,6 +25,13 @@ namespace mcrouter {
  */
 class DefaultShadowPolicy {
  public:
+  /**
+   * False since makeAdjustedNormalRequest() returns an unmodified copy:
+   * the normal path can keep routing the caller's request and the copy is
+   * needed only to extend the request's lifetime to the shadow fibers.
+   */
+  static constexpr bool kAdjustsNormalRequest = false;
+
   DefaultShadowPolicy() = default;
 
   explicit DefaultShadowPolicy(CarbonRouterInstanceBase& router)
@@ -48,8 +55,7 @@ class DefaultShadowPolicy {
       return normalReq;
     }
 
-    auto shadowReq = std::make_shared<McLeaseSetRequest>(*normalReq);
-    shadowReq->leaseToken() = router_->shadowLeaseTokenMap().withLock(
+    const auto shadowToken = router_->shadowLeaseTokenMap().withLock(
         [normalToken = normalReq->leaseToken()](const auto& tokenMap) {
           // For now, we assume at most one shadow request per normal request,
           // i.e., there is a mapping from normal lease token -> shadow lease
@@ -58,6 +64,14 @@ class DefaultShadowPolicy {
           auto it = tokenMap.findWithoutPromotion(normalToken);
           return it != tokenMap.end() ? it->second : 0 /* invalid token */;
         });
+    if (shadowToken == normalReq->leaseToken()) {
+      // The adjustment is a no-op; share the normal request instead of
+      // cloning it just to write back the same token.
+      return normalReq;
+    }
+
+    auto shadowReq = std::make_shared<McLeaseSetRequest>(*normalReq);
+    shadowReq->leaseToken() = shadowToken;
     return shadowReq;
   }
 
@@ -7,9 +7,14 @@
  */
 #pragma once
 
+#include <array>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <folly/Format.h>
+#include <folly/Likely.h>
 #include <folly/Optional.h>
 #include <folly/ScopeGuard.h>
 #include <folly/fibers/FiberManager.h>
@@ -19,14 +24,20 @@
 #include "mcrouter/CarbonRouterInstanceBase.h"
 #include "mcrouter/McrouterFiberContext.h"
 #include "mcrouter/McrouterLogFailure.h"
+#include "mcrouter/ProxyBase.h"
 #include "mcrouter/ProxyDestination.h"
 #include "mcrouter/ProxyRequestContext.h"
 #include "mcrouter/config-impl.h"
 #include "mcrouter/config.h"
+#include "mcrouter/lib/McResUtil.h"
 #include "mcrouter/lib/Reply.h"
 #include "mcrouter/lib/RouteHandleTraverser.h"
+#include "mcrouter/lib/carbon/Artillery.h"
+#include "mcrouter/lib/carbon/RoutingGroups.h"
+#include "mcrouter/lib/network/CaretSerializedMessage.h"
 #include "mcrouter/lib/config/RouteHandleBuilder.h"
 #include "mcrouter/lib/fbi/cpp/util.h"
+#include "mcrouter/lib/network/ServerLoad.h"
 #include "mcrouter/lib/network/gen/Memcache.h"
 #include "mcrouter/routes/McrouterRouteHandle.h"
 
@@ -42,6 +53,50 @@ class RouteHandleFactory;
 
 namespace mcrouter {
 
+namespace detail {
+
+/**
+ * Preconstructed "Server unavailable" message for a TKO reason. The TKO
+ * fail path runs for every request to a dead destination during an
+ * outage, so it must not format a message per request.
+ */
+inline const std::string& tkoReplyMessage(mc_res_t reason) {
+  static const auto* messages = [] {
+    auto msgs = new std::array<std::string, mc_nres>();
+    for (size_t i = 0; i < msgs->size(); ++i) {
+      (*msgs)[i] = folly::to<std::string>(
+          "Server unavailable. Reason: ",
+          mc_res_to_string(static_cast<mc_res_t>(i)));
+    }
+    return msgs;
+  }();
+  auto idx = static_cast<size_t>(reason);
+  return (*messages)[idx < messages->size() ? idx : 0];
+}
+
+/**
+ * Minimum number of latency samples before a destination's histogram is
+ * trusted to cap the first attempt of a deadline-budgeted request; below
+ * this the p99 estimate is too noisy and the static timeout applies.
+ */
+constexpr uint64_t kDeadlineSplitMinSamples = 100;
+
+/**
+ * Upper bound on the per-destination table of in-flight collapsible
+ * gets. Past this, new keys lead their own sends instead of being
+ * tracked; a herd on few hot keys never gets near the bound.
+ */
+constexpr size_t kMaxInflightGetKeys = 1024;
+
+/**
+ * Upper bound on asynclog deletes held in memory per destination while
+ * waiting out --asynclog-grace-window-ms. Past this, entries go straight
+ * to the disk spool, same as with the window disabled.
+ */
+constexpr size_t kMaxPendingAsynclogReplays = 1024;
+
+} // namespace detail
+
 /**
  * Routes a request to a single ProxyDestination.
  * This is the lowest level in Mcrouter's RouteHandle tree.
@@ -69,7 +124,7 @@ class DestinationRoute {
       std::chrono::milliseconds timeout,
       bool keepRoutingPrefix)
       : destination_(std::move(destination)),
-        poolName_(poolName),
+        poolName_(poolName.str()),
         indexInPool_(indexInPool),
         poolStatIndex_(poolStatIdx),
         timeout_(timeout),
@@ -77,6 +132,18 @@ class DestinationRoute {
     destination_->setPoolStatsIndex(poolStatIdx);
   }
 
+  ~DestinationRoute() {
+    // Displaced route trees are reclaimed off the proxy thread (see
+    // OLD_CONFIG handling in Proxy::messageReady), but ProxyDestination
+    // must be released on its proxy thread to prevent races on members
+    // that are only accessed in eventbase-executed methods. Hand our
+    // reference back if we're being destroyed elsewhere.
+    auto& evb = destination_->proxy.eventBase();
+    if (!evb.getEventBase().isInEventBaseThread()) {
+      evb.runInEventBaseThread([destination = destination_]() {});
+    }
+  }
+
   template <class Request>
   void traverse(
       const Request&,
@@ -92,12 +159,19 @@ class DestinationRoute {
   }
 
   memcache::McDeleteReply route(const memcache::McDeleteRequest& req) const {
-    auto reply = routeWithDestination(req);
-    if (isFailoverErrorResult(reply.result()) && spool(req)) {
-      reply = createReply(DefaultReply, req);
-      reply.setDestination(destination_->accessPoint());
+    auto& ctx = fiber_local<RouterInfo>::getSharedCtx();
+    if (ctx->proxy().router().opts().coalesce_same_key_deletes) {
+      return routeDeleteCoalesced(req, *ctx);
     }
-    return reply;
+    return routeDelete(req);
+  }
+
+  memcache::McGetReply route(const memcache::McGetRequest& req) const {
+    auto& ctx = fiber_local<RouterInfo>::getSharedCtx();
+    if (ctx->proxy().router().opts().collapse_inflight_gets) {
+      return routeGetCollapsed(req, *ctx);
+    }
+    return routeWithDestination(req);
   }
 
   template <class Request>
@@ -106,13 +180,128 @@ class DestinationRoute {
   }
 
  private:
+  /**
+   * A delete currently in flight to this destination. Waiters park on
+   * their batons until the leader publishes its reply.
+   */
+  struct InflightDelete {
+    memcache::McDeleteReply reply;
+    std::vector<folly::fibers::Baton*> waiters;
+  };
+
+  /**
+   * A get currently in flight to this destination; same leader/waiter
+   * scheme as InflightDelete.
+   */
+  struct InflightGet {
+    memcache::McGetReply reply;
+    std::vector<folly::fibers::Baton*> waiters;
+  };
+
   const std::shared_ptr<ProxyDestination> destination_;
-  const folly::StringPiece poolName_;
+  // Owned copy: this route can outlive the config whose accessPoints_ map
+  // key it was created from (see pool reuse in McRouteHandleProvider).
+  const std::string poolName_;
   const size_t indexInPool_;
   const int32_t poolStatIndex_{-1};
   const std::chrono::milliseconds timeout_;
   size_t pendingShadowReqs_{0};
   const bool keepRoutingPrefix_;
+  // Proxy-thread confined, like pendingShadowReqs_. Keyed by the key as
+  // sent to the destination. Only used with --coalesce-same-key-deletes.
+  mutable std::unordered_map<std::string, std::shared_ptr<InflightDelete>>
+      inflightDeletes_;
+  // Same confinement and keying; only used with --collapse-inflight-gets
+  // and bounded by detail::kMaxInflightGetKeys.
+  mutable std::unordered_map<std::string, std::shared_ptr<InflightGet>>
+      inflightGets_;
+  // Count of asynclog deletes buffered in memory for the grace window.
+  // Shared with the detached replay fibers, which may outlive this route
+  // handle across a reconfiguration.
+  const std::shared_ptr<size_t> pendingAsynclogReplays_{
+      std::make_shared<size_t>(0)};
+
+  memcache::McDeleteReply routeDelete(
+      const memcache::McDeleteRequest& req) const {
+    auto reply = routeWithDestination(req);
+    if (isFailoverErrorResult(reply.result()) && spool(req)) {
+      reply = createReply(DefaultReply, req);
+      reply.setDestination(destination_->accessPoint());
+    }
+    return reply;
+  }
+
+  memcache::McDeleteReply routeDeleteCoalesced(
+      const memcache::McDeleteRequest& req,
+      ProxyRequestContextWithInfo<RouterInfo>& ctx) const {
+    auto key =
+        (keepRoutingPrefix_ ? req.key().fullKey() : req.key().keyWithoutRoute())
+            .str();
+
+    auto it = inflightDeletes_.find(key);
+    if (it != inflightDeletes_.end()) {
+      auto entry = it->second;
+      folly::fibers::Baton baton;
+      entry->waiters.push_back(&baton);
+      baton.wait();
+      ctx.proxy().stats().increment(coalesced_deletes_stat);
+      auto reply = entry->reply;
+      logReply(req, ctx, reply);
+      return reply;
+    }
+
+    auto entry = std::make_shared<InflightDelete>();
+    inflightDeletes_.emplace(key, entry);
+    SCOPE_EXIT {
+      // Erase before posting: deletes arriving after this point must
+      // lead their own send rather than share a published reply.
+      inflightDeletes_.erase(key);
+      for (auto* waiter : entry->waiters) {
+        waiter->post();
+      }
+    };
+    entry->reply = routeDelete(req);
+    return entry->reply;
+  }
+
+  memcache::McGetReply routeGetCollapsed(
+      const memcache::McGetRequest& req,
+      ProxyRequestContextWithInfo<RouterInfo>& ctx) const {
+    auto key =
+        (keepRoutingPrefix_ ? req.key().fullKey() : req.key().keyWithoutRoute())
+            .str();
+
+    auto it = inflightGets_.find(key);
+    if (it != inflightGets_.end()) {
+      auto entry = it->second;
+      folly::fibers::Baton baton;
+      entry->waiters.push_back(&baton);
+      baton.wait();
+      ctx.proxy().stats().increment(collapsed_gets_stat);
+      // Copying the reply clones the value IOBuf, which shares the
+      // underlying buffer; the fanout costs no data copies.
+      auto reply = entry->reply;
+      logReply(req, ctx, reply);
+      return reply;
+    }
+
+    if (inflightGets_.size() >= detail::kMaxInflightGetKeys) {
+      return routeWithDestination(req);
+    }
+
+    auto entry = std::make_shared<InflightGet>();
+    inflightGets_.emplace(key, entry);
+    SCOPE_EXIT {
+      // Erase before posting: gets arriving after this point must lead
+      // their own send rather than share a published reply.
+      inflightGets_.erase(key);
+      for (auto* waiter : entry->waiters) {
+        waiter->post();
+      }
+    };
+    entry->reply = routeWithDestination(req);
+    return entry->reply;
+  }
 
   template <class Request>
   ReplyT<Request> routeWithDestination(const Request& req) const {
@@ -123,15 +312,15 @@ class DestinationRoute {
 
   template <class Request>
   ReplyT<Request> checkAndRoute(const Request& req) const {
+    // The destination is shared across proxies and rarely warm in this
+    // thread's cache; its leading cacheline holds the TKO state read by
+    // maySend() below.  Fetch it under the fiber-local context load.
+    __builtin_prefetch(destination_.get());
     auto& ctx = fiber_local<RouterInfo>::getSharedCtx();
     mc_res_t tkoReason;
     if (!destination_->maySend(tkoReason)) {
       return constructAndLog(
-          req,
-          *ctx,
-          TkoReply,
-          folly::to<std::string>(
-              "Server unavailable. Reason: ", mc_res_to_string(tkoReason)));
+          req, *ctx, TkoReply, detail::tkoReplyMessage(tkoReason));
     }
 
     if (poolStatIndex_ >= 0) {
@@ -147,6 +336,25 @@ class DestinationRoute {
     }
 
     auto proxy = &ctx->proxy();
+
+    const auto deadlineUs = fiber_local<RouterInfo>::getDeadlineUs();
+    if (deadlineUs > 0) {
+      // The caller gives up at the deadline no matter what; if the
+      // remaining budget won't even cover this destination's typical
+      // round trip, sending is wasted work for us and the server.
+      const auto remainingUs = deadlineUs - nowUs();
+      if (remainingUs <=
+          static_cast<int64_t>(destination_->stats().avgLatency.value())) {
+        proxy->stats().increment(deadline_budget_drops_stat);
+        return constructAndLog(
+            req,
+            *ctx,
+            ErrorReply,
+            mc_res_busy,
+            "Dropped: remaining deadline budget below destination latency");
+      }
+    }
+
     if (requestClass.is(RequestClass::kShadow)) {
       if (proxy->router().opts().target_max_shadow_requests > 0 &&
           pendingShadowReqs_ >=
@@ -172,8 +380,21 @@ class DestinationRoute {
       const Request& req,
       ProxyRequestContextWithInfo<RouterInfo>& ctx,
       Args&&... args) const {
-    auto now = nowUs();
     auto reply = createReply<Request>(std::forward<Args>(args)...);
+    logReply(req, ctx, reply);
+    return reply;
+  }
+
+  /**
+   * Logs a reply that was produced locally (not received over the wire)
+   * as if it completed instantaneously.
+   */
+  template <class Request>
+  void logReply(
+      const Request& req,
+      ProxyRequestContextWithInfo<RouterInfo>& ctx,
+      const ReplyT<Request>& reply) const {
+    auto now = nowUs();
     RpcStatsContext rpcContext;
     ctx.onReplyReceived(
         poolName_,
@@ -186,14 +407,15 @@ class DestinationRoute {
         now,
         poolStatIndex_,
         rpcContext);
-    return reply;
   }
 
   template <class Request>
   ReplyT<Request> doRoute(
       const Request& req,
       ProxyRequestContextWithInfo<RouterInfo>& ctx) const {
-    DestinationRequestCtx dctx(nowUs());
+    // Paired with the precise endTime stamp taken when the reply arrives;
+    // sub-tick accuracy matters for destination latency samples.
+    DestinationRequestCtx dctx(nowUsPrecise());
     folly::Optional<Request> newReq;
     folly::StringPiece strippedRoutingPrefix;
     if (!keepRoutingPrefix_ && !req.key().routingPrefix().empty()) {
@@ -210,8 +432,35 @@ class DestinationRoute {
     }
 
     const auto& reqToSend = newReq ? *newReq : req;
+    // Resends of an unchanged request (failover attempts) can reuse the
+    // serialized caret body; the serializer validates the cached body
+    // against a fingerprint of the request content, so the mutations
+    // applied above (or by any wrapper route in between) simply miss the
+    // cache rather than needing to be declared here.
+    auto* bodyCache = fiber_local<RouterInfo>::getSerializedBodyCache();
     RpcStatsContext rpcContext;
-    auto reply = destination_->send(reqToSend, dctx, timeout_, rpcContext);
+    auto reply = destination_->send(
+        reqToSend, dctx, effectiveTimeout(ctx), rpcContext, bodyCache);
+
+    if (UNLIKELY(
+            carbon::GetLike<Request>::value &&
+            isRemoteErrorResult(reply.result()) &&
+            rpcContext.replySizeBeforeCompression == 0)) {
+      /* No reply bytes arrived, so this error was synthesized locally:
+         the connection died under the request (e.g. remote idle-timeout
+         race). The client has already started reconnecting; for
+         idempotent requests one immediate same-fiber retry is safe and
+         far cheaper than taking the failover path. */
+      mc_res_t tkoReason;
+      if (destination_->maySend(tkoReason)) {
+        ctx.proxy().stats().increment(destination_conn_error_retries_stat);
+        rpcContext = RpcStatsContext();
+        dctx = DestinationRequestCtx(nowUsPrecise());
+        reply = destination_->send(
+            reqToSend, dctx, effectiveTimeout(ctx), rpcContext, bodyCache);
+      }
+    }
+
     ctx.onReplyReceived(
         poolName_,
         *destination_->accessPoint(),
@@ -224,10 +473,73 @@ class DestinationRoute {
         poolStatIndex_,
         rpcContext);
 
-    fiber_local<RouterInfo>::setServerLoad(rpcContext.serverLoad);
+    if (rpcContext.serverLoad.isZero()) {
+      // Destination didn't report load with this reply; synthesize one from
+      // the fused availability score so LoadBalancerRoute still weighs
+      // erroring or slow destinations down. A healthy silent server scores
+      // ~1.0 and synthesizes ~zero load, same as before.
+      fiber_local<RouterInfo>::setServerLoad(ServerLoad::fromPercentLoad(
+          (1.0 - destination_->availabilityScore()) * 100.0));
+    } else {
+      fiber_local<RouterInfo>::setServerLoad(rpcContext.serverLoad);
+    }
+
+    // Sampled requests carry a trace context; the ids were serialized
+    // into the Caret header of the send above, and here we record the
+    // mcrouter-side span of this hop.
+    if (UNLIKELY(ctx.proxy().traceSpans().enabled()) &&
+        !reqToSend.traceContext().empty()) {
+      TraceSpan span;
+      span.traceId =
+          carbon::tracing::serializeTraceContext(reqToSend.traceContext());
+      span.requestName = Request::name;
+      span.destination = destination_->accessPoint()->toHostPortString();
+      span.startTimeUs = dctx.startTime;
+      span.durationUs = dctx.endTime - dctx.startTime;
+      span.result = reply.result();
+      ctx.proxy().traceSpans().record(std::move(span));
+    }
     return reply;
   }
 
+  /**
+   * Splits a request deadline across failover attempts.  Without a
+   * deadline, this is the static pool timeout.  With one, the first
+   * attempt is capped at this destination's observed p99 latency, so a
+   * slow host can't burn the entire budget before failover gets a turn,
+   * and failover attempts are capped at whatever budget remains.
+   */
+  std::chrono::milliseconds effectiveTimeout(
+      ProxyRequestContextWithInfo<RouterInfo>& ctx) const {
+    const auto deadlineUs = fiber_local<RouterInfo>::getDeadlineUs();
+    if (deadlineUs == 0) {
+      return timeout_;
+    }
+    auto allowedUs = deadlineUs - nowUs();
+    if (!fiber_local<RouterInfo>::getRequestClass().is(
+            RequestClass::kFailover)) {
+      const auto& histogram = destination_->stats().latencyUsHistogram;
+      if (histogram.totalSamples() >= detail::kDeadlineSplitMinSamples) {
+        // The histogram returns a bucket upper bound, so the estimate
+        // already carries up to 12.5% of slack over the true p99.
+        const auto p99Us =
+            static_cast<int64_t>(histogram.estimatePercentile(99.0));
+        if (p99Us < allowedUs) {
+          allowedUs = p99Us;
+        }
+      }
+    }
+    // checkAndRoute already verified the remaining budget is worth a
+    // send; round the cap up to a whole millisecond, not down to zero.
+    const auto cappedMs = std::chrono::milliseconds(
+        allowedUs > 0 ? (allowedUs + 999) / 1000 : 1);
+    if (cappedMs >= timeout_) {
+      return timeout_;
+    }
+    ctx.proxy().stats().increment(deadline_timeout_trims_stat);
+    return cappedMs;
+  }
+
   template <class Request>
   bool spool(const Request& req) const {
     auto asynclogName = fiber_local<RouterInfo>::getAsynclogName();
@@ -239,18 +551,66 @@ class DestinationRoute {
         keepRoutingPrefix_ ? req.key().fullKey() : req.key().keyWithoutRoute();
 
     auto proxy = &fiber_local<RouterInfo>::getSharedCtx()->proxy();
-    auto& ap = *destination_->accessPoint();
+    const auto graceMs = proxy->router().opts().asynclog_grace_window_ms;
+    if (graceMs == 0 ||
+        *pendingAsynclogReplays_ >= detail::kMaxPendingAsynclogReplays) {
+      spoolToDisk(*proxy, *destination_->accessPoint(), key, asynclogName);
+      return true;
+    }
+
+    // Memory tier: hold the delete for the grace window, then replay it
+    // against the destination directly. Most outages are sub-second
+    // blips, so the common case never touches the disk spool.
+    ++*pendingAsynclogReplays_;
+    folly::fibers::addTask([
+      pending = pendingAsynclogReplays_,
+      destination = destination_,
+      proxy,
+      timeout = timeout_,
+      graceMs,
+      keyStr = key.str(),
+      logName = asynclogName.str()
+    ]() {
+      folly::fibers::Baton timer;
+      timer.timed_wait(std::chrono::milliseconds(graceMs));
+      --*pending;
+      mc_res_t tkoReason;
+      if (destination->maySend(tkoReason)) {
+        memcache::McDeleteRequest retry(keyStr);
+        DestinationRequestCtx dctx(nowUsPrecise());
+        RpcStatsContext rpcContext;
+        auto reply = destination->send(retry, dctx, timeout, rpcContext);
+        if (!isFailoverErrorResult(reply.result())) {
+          proxy->stats().increment(asynclog_replayed_deletes_stat);
+          return;
+        }
+      }
+      // Still down past the window: spill to the disk spool as before.
+      spoolToDisk(*proxy, *destination->accessPoint(), keyStr, logName);
+    });
+    return true;
+  }
+
+  static void spoolToDisk(
+      ProxyBase& proxy,
+      const AccessPoint& ap,
+      folly::StringPiece key,
+      folly::StringPiece asynclogName) {
     folly::fibers::Baton b;
     auto res = false;
-    if (auto asyncWriter = proxy->router().asyncWriter()) {
-      res = asyncWriter->run([&b, &ap, proxy, key, asynclogName]() {
-        proxy->asyncLog().writeDelete(ap, key, asynclogName);
-        b.post();
-      });
+    if (auto writerPool = proxy.router().asyncWriterPool()) {
+      // Shard by proxy id: all writes to this proxy's spool file land on
+      // one writer thread, so the file stays single-writer while other
+      // proxies' spools proceed in parallel.
+      res = writerPool->writer(proxy.getId())
+                .run([&b, &ap, &proxy, key, asynclogName]() {
+                  proxy.asyncLog().writeDelete(ap, key, asynclogName);
+                  b.post();
+                });
     }
     if (!res) {
       MC_LOG_FAILURE(
-          proxy->router().opts(),
+          proxy.router().opts(),
           memcache::failure::Category::kOutOfResources,
           "Could not enqueue asynclog request (key {}, pool {})",
           key,
@@ -258,9 +618,8 @@ class DestinationRoute {
     } else {
       // Don't reply to the user until we safely logged the request to disk
       b.wait();
-      proxy->stats().increment(asynclog_requests_stat);
+      proxy.stats().increment(asynclog_requests_stat);
     }
-    return true;
   }
 };
 
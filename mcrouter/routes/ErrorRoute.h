@@ -38,14 +38,7 @@ class ErrorRoute {
   using RouteHandleIf = typename RouterInfo::RouteHandleIf;
 
   std::string routeName() const {
-    const std::string name = "error";
-    const std::string log = enableLogging_ ? "log" : "no-log";
-    const std::string res = mc_res_to_string(result_);
-    const auto nameWithProps = folly::to<std::string>(name, "|", log, "|", res);
-    if (valueToSet_.empty()) {
-      return nameWithProps;
-    }
-    return folly::to<std::string>(nameWithProps, "|", valueToSet_);
+    return name_;
   }
 
   template <class Request>
@@ -58,7 +51,8 @@ class ErrorRoute {
       mc_res_t result = mc_res_local_error)
       : valueToSet_(std::move(valueToSet)),
         enableLogging_(enableLogging),
-        result_(result) {}
+        result_(result),
+        name_(makeName()) {}
 
   template <class Request>
   ReplyT<Request> route(const Request& req) {
@@ -69,7 +63,7 @@ class ErrorRoute {
         AccessPoint ap;
         RpcStatsContext rpcContext;
         ctx->onReplyReceived(
-            routeName() /* poolName */,
+            name_ /* poolName */,
             ap,
             folly::StringPiece(),
             req,
@@ -88,6 +82,20 @@ class ErrorRoute {
   const std::string valueToSet_;
   const bool enableLogging_;
   const mc_res_t result_;
+  // Interned at construction time: routeName() is reported with every
+  // logged reply, so it must not rebuild the string per request.
+  const std::string name_;
+
+  std::string makeName() const {
+    const std::string name = "error";
+    const std::string log = enableLogging_ ? "log" : "no-log";
+    const std::string res = mc_res_to_string(result_);
+    const auto nameWithProps = folly::to<std::string>(name, "|", log, "|", res);
+    if (valueToSet_.empty()) {
+      return nameWithProps;
+    }
+    return folly::to<std::string>(nameWithProps, "|", valueToSet_);
+  }
 };
 
 template <class RouterInfo>
@@ -13,7 +13,10 @@
 #include <boost/iterator/iterator_facade.hpp>
 
 #include <folly/dynamic.h>
+#include <folly/small_vector.h>
 
+#include "mcrouter/ExponentialSmoothData.h"
+#include "mcrouter/config.h"
 #include "mcrouter/lib/Operation.h"
 #include "mcrouter/lib/fbi/cpp/ParsingUtil.h"
 
@@ -93,6 +96,13 @@ class FailoverLeastFailuresPolicy {
   static constexpr bool optimizeNoFailoverRouteCase = true;
   using RouteHandlePtr = std::shared_ptr<RouteHandleIf>;
 
+  /**
+   * Child try order for one failover. Inline capacity covers the typical
+   * child count, so computing the order on the failover path normally
+   * doesn't allocate.
+   */
+  using Order = folly::small_vector<size_t, 8>;
+
   FailoverLeastFailuresPolicy(
       const std::vector<std::shared_ptr<RouteHandleIf>>& children,
       const folly::dynamic& policyConfig)
@@ -164,7 +174,7 @@ class FailoverLeastFailuresPolicy {
     friend class boost::iterator_core_access;
 
     FailoverLeastFailuresPolicy<RouteHandleIf>& policy_;
-    std::vector<size_t> order_;
+    Order order_;
     size_t id_;
   };
 
@@ -187,10 +197,11 @@ class FailoverLeastFailuresPolicy {
   }
 
  private:
-  std::vector<size_t> getLeastFailureRouteIndices() const {
-    std::vector<size_t> indices;
-    for (size_t i = 0; i < recentErrorCount_.size(); ++i) {
-      indices.push_back(i);
+  Order getLeastFailureRouteIndices() const {
+    Order indices;
+    indices.resize(recentErrorCount_.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+      indices[i] = i;
     }
     // 0th index always goes first.
     std::stable_sort(
@@ -205,8 +216,174 @@ class FailoverLeastFailuresPolicy {
   const std::vector<RouteHandlePtr>& children_;
   size_t maxTries_;
 
+  // Per-child recent error counts, sized once at construction. Like the
+  // rest of the route handle state this is confined to the owning proxy
+  // thread, so plain integers suffice.
   std::vector<size_t> recentErrorCount_;
 };
+
+/**
+ * Orders children by a decayed health score instead of config position.
+ *
+ * Each child's replies feed a latency EWMA and an error-rate EWMA; a
+ * child's score is its smoothed latency inflated by its error rate, so a
+ * child failing every request looks an order of magnitude slower than its
+ * clock time. The order is recomputed at most every 100ms, not per
+ * request, and ties keep config order via stable sort.
+ *
+ * Unlike LeastFailuresPolicy this may demote child 0: a slow-but-alive
+ * primary (e.g. a canary running hot) loses its full share once its score
+ * is measurably worse. Children with no samples yet score best, so new
+ * boxes are tried optimistically.
+ */
+template <typename RouteHandleIf>
+class FailoverLatencyAwarePolicy {
+ public:
+  static constexpr bool optimizeNoFailoverRouteCase = true;
+  using RouteHandlePtr = std::shared_ptr<RouteHandleIf>;
+
+  using Order = folly::small_vector<size_t, 8>;
+
+  FailoverLatencyAwarePolicy(
+      const std::vector<RouteHandlePtr>& children,
+      const folly::dynamic& policyConfig)
+      : children_(children),
+        childStats_(children_.size()),
+        maxTries_(children_.size()) {
+    if (auto jMaxTries = policyConfig.get_ptr("max_tries")) {
+      maxTries_ = static_cast<size_t>(
+          parseInt(*jMaxTries, "max_tries", 1, children_.size()));
+    }
+  }
+
+  class ChildProxy {
+   public:
+    ChildProxy(FailoverLatencyAwarePolicy<RouteHandleIf>& policy, size_t index)
+        : policy_(policy), index_(index) {}
+
+    template <class Request>
+    ReplyT<Request> route(const Request& req) {
+      const auto startUs = nowUs();
+      auto reply = policy_.children_[index_]->route(req);
+      auto& stats = policy_.childStats_[index_];
+      stats.latencyUs.insertSample(static_cast<double>(nowUs() - startUs));
+      stats.errorRate.insertSample(
+          isErrorResult(reply.result()) ? 1.0 : 0.0);
+      return reply;
+    }
+
+   private:
+    FailoverLatencyAwarePolicy<RouteHandleIf>& policy_;
+    size_t index_;
+  };
+
+  class Iterator : public boost::iterator_facade<
+                       Iterator,
+                       ChildProxy,
+                       std::forward_iterator_tag,
+                       ChildProxy> {
+   public:
+    Iterator(FailoverLatencyAwarePolicy<RouteHandleIf>& policy, size_t id)
+        : policy_(policy), id_(id) {
+      if (id_ == 0) {
+        order_ = policy_.getOrder();
+      }
+    }
+
+    size_t getTrueIndex() const {
+      return order_[id_];
+    }
+
+   private:
+    void increment() {
+      ++id_;
+    }
+
+    bool equal(const Iterator& other) const {
+      return id_ == other.id_;
+    }
+
+    ChildProxy dereference() const {
+      return ChildProxy(policy_, order_[id_]);
+    }
+
+    friend class boost::iterator_core_access;
+
+    FailoverLatencyAwarePolicy<RouteHandleIf>& policy_;
+    Order order_;
+    size_t id_;
+  };
+
+  Iterator begin() {
+    return Iterator(*this, 0);
+  }
+
+  Iterator end() {
+    return Iterator(*this, maxTries_);
+  }
+
+  // Returns the stat to increment when failover occurs.
+  stat_name_t getFailoverStat() const {
+    return failover_latency_aware_policy_stat;
+  }
+
+  // Returns the stat when all failover destinations are exhausted.
+  stat_name_t getFailoverFailedStat() const {
+    return failover_latency_aware_policy_failed_stat;
+  }
+
+ private:
+  struct ChildStats {
+    ExponentialSmoothData<64> latencyUs;
+    ExponentialSmoothData<64> errorRate;
+  };
+
+  // Erroring children look up to 10x slower than their clock time, so a
+  // fast-failing child still sorts behind a slow healthy one.
+  static constexpr double kErrorPenalty = 9.0;
+  static constexpr uint64_t kOrderRecomputePeriodUs = 100 * 1000;
+
+  double score(size_t idx) const {
+    const auto& stats = childStats_[idx];
+    // One-microsecond floor keeps the error term effective even for
+    // children whose replies return within the clock granularity.
+    return (stats.latencyUs.value() + 1.0) *
+        (1.0 + kErrorPenalty * stats.errorRate.value());
+  }
+
+  const Order& getOrder() {
+    const auto now = static_cast<uint64_t>(nowUs());
+    if (now >= nextRecomputeUs_) {
+      nextRecomputeUs_ = now + kOrderRecomputePeriodUs;
+      recomputeOrder();
+    }
+    return cachedOrder_;
+  }
+
+  void recomputeOrder() {
+    Order indices;
+    indices.resize(children_.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+      indices[i] = i;
+    }
+    std::stable_sort(
+        indices.begin(), indices.end(), [this](size_t a, size_t b) {
+          return score(a) < score(b);
+        });
+    indices.resize(maxTries_);
+    cachedOrder_ = std::move(indices);
+  }
+
+  const std::vector<RouteHandlePtr>& children_;
+  std::vector<ChildStats> childStats_;
+  size_t maxTries_;
+
+  // Order is confined to the owning proxy thread like the rest of the
+  // route handle state; recomputed lazily on the first failover after the
+  // period elapses.
+  Order cachedOrder_;
+  uint64_t nextRecomputeUs_{0};
+};
 }
 }
 } // facebook::memcache::mcrouter
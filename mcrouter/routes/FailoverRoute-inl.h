@@ -67,6 +67,24 @@ makeFailoverRouteLeastFailures(
       std::move(rh), std::forward<Args>(args)...);
 }
 
+template <
+    class RouterInfo,
+    template <class...> class RouteHandle,
+    class... Args>
+std::shared_ptr<typename RouterInfo::RouteHandleIf>
+makeFailoverRouteLatencyAware(
+    std::vector<std::shared_ptr<typename RouterInfo::RouteHandleIf>> rh,
+    Args&&... args) {
+  if (rh.size() <= 1) {
+    return makeNullOrSingletonRoute(std::move(rh));
+  }
+
+  using FailoverPolicyT =
+      FailoverLatencyAwarePolicy<typename RouterInfo::RouteHandleIf>;
+  return makeRouteHandleWithInfo<RouterInfo, RouteHandle, FailoverPolicyT>(
+      std::move(rh), std::forward<Args>(args)...);
+}
+
 template <
     class RouterInfo,
     template <class...> class RouteHandle,
@@ -87,6 +105,8 @@ makeFailoverRouteWithPolicyAndFailoverError(
   std::unique_ptr<FailoverRateLimiter> rateLimiter;
   bool failoverTagging = false;
   bool enableLeasePairing = false;
+  bool parallelProbe = false;
+  uint32_t parallelProbeDelayUs = detail::kDefaultParallelProbeDelayUs;
   std::string name;
   if (json.isObject()) {
     if (auto jLeasePairing = json.get_ptr("enable_lease_pairing")) {
@@ -110,6 +130,17 @@ makeFailoverRouteWithPolicyAndFailoverError(
     if (auto jFailoverLimit = json.get_ptr("failover_limit")) {
       rateLimiter = std::make_unique<FailoverRateLimiter>(*jFailoverLimit);
     }
+    if (auto jParallelProbe = json.get_ptr("parallel_probe")) {
+      checkLogic(
+          jParallelProbe->isBool(), "Failover: parallel_probe is not bool");
+      parallelProbe = jParallelProbe->getBool();
+    }
+    if (auto jProbeDelay = json.get_ptr("parallel_probe_delay_us")) {
+      checkLogic(
+          jProbeDelay->isInt(),
+          "Failover: parallel_probe_delay_us is not int");
+      parallelProbeDelayUs = jProbeDelay->getInt();
+    }
   }
 
   return makeRouteHandleWithInfo<
@@ -124,6 +155,8 @@ makeFailoverRouteWithPolicyAndFailoverError(
       enableLeasePairing,
       std::move(name),
       policyConfig,
+      parallelProbe,
+      parallelProbeDelayUs,
       std::forward<Args>(args)...);
 }
 
@@ -174,7 +207,8 @@ makeFailoverRouteWithFailoverErrorSettings(
     checkLogic(
         jPolicyType != nullptr,
         "Failover: failover_policy object is missing 'type' field");
-    if (parseString(*jPolicyType, "type") == "LeastFailuresPolicy") {
+    auto policyType = parseString(*jPolicyType, "type");
+    if (policyType == "LeastFailuresPolicy") {
       using FailoverPolicyT =
           FailoverLeastFailuresPolicy<typename RouterInfo::RouteHandleIf>;
       return makeFailoverRouteWithPolicyAndFailoverError<
@@ -187,6 +221,19 @@ makeFailoverRouteWithFailoverErrorSettings(
           *jFailoverPolicy,
           std::move(failoverErrors),
           std::forward<Args>(args)...);
+    } else if (policyType == "LatencyAwarePolicy") {
+      using FailoverPolicyT =
+          FailoverLatencyAwarePolicy<typename RouterInfo::RouteHandleIf>;
+      return makeFailoverRouteWithPolicyAndFailoverError<
+          RouterInfo,
+          RouteHandle,
+          FailoverPolicyT,
+          FailoverErrorsSettingsT>(
+          json,
+          std::move(children),
+          *jFailoverPolicy,
+          std::move(failoverErrors),
+          std::forward<Args>(args)...);
     }
   }
   using FailoverPolicyT =
@@ -7,10 +7,16 @@
  */
 #pragma once
 
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <folly/Optional.h>
+#include <folly/fibers/AddTasks.h>
+#include <folly/fibers/Baton.h>
+
 #include "mcrouter/CarbonRouterInstanceBase.h"
 #include "mcrouter/LeaseTokenMap.h"
 #include "mcrouter/McrouterFiberContext.h"
@@ -20,6 +26,7 @@
 #include "mcrouter/lib/FailoverErrorsSettings.h"
 #include "mcrouter/lib/Operation.h"
 #include "mcrouter/lib/RouteHandleTraverser.h"
+#include "mcrouter/lib/network/CaretSerializedMessage.h"
 #include "mcrouter/lib/network/gen/Memcache.h"
 #include "mcrouter/routes/FailoverPolicy.h"
 #include "mcrouter/routes/FailoverRateLimiter.h"
@@ -49,6 +56,10 @@ inline std::string getFailoverRouteName(std::string name, size_t numTargets) {
       std::move(name), ":failover_targets=", numTargets);
 }
 
+// How long a parallel probe waits for the first failover child before
+// contacting the second one.
+constexpr uint32_t kDefaultParallelProbeDelayUs = 2000;
+
 } // namespace detail
 
 /**
@@ -90,14 +101,18 @@ class FailoverRoute {
       bool failoverTagging,
       bool enableLeasePairing,
       std::string name,
-      const folly::dynamic& policyConfig)
+      const folly::dynamic& policyConfig,
+      bool parallelProbe = false,
+      uint32_t parallelProbeDelayUs = detail::kDefaultParallelProbeDelayUs)
       : name_(detail::getFailoverRouteName(std::move(name), targets.size())),
         targets_(std::move(targets)),
         failoverErrors_(std::move(failoverErrors)),
         rateLimiter_(std::move(rateLimiter)),
         failoverTagging_(failoverTagging),
         failoverPolicy_(targets_, policyConfig),
-        enableLeasePairing_(enableLeasePairing) {
+        enableLeasePairing_(enableLeasePairing),
+        parallelProbe_(parallelProbe),
+        parallelProbeDelayUs_(parallelProbeDelayUs) {
     assert(!targets_.empty());
     assert(!enableLeasePairing_ || !name_.empty());
   }
@@ -170,6 +185,8 @@ class FailoverRoute {
   const bool failoverTagging_{false};
   FailoverPolicyT failoverPolicy_;
   const bool enableLeasePairing_{false};
+  const bool parallelProbe_{false};
+  const uint32_t parallelProbeDelayUs_{detail::kDefaultParallelProbeDelayUs};
 
   template <class Request>
   inline ReplyT<Request> doRoute(const Request& req) {
@@ -234,6 +251,16 @@ class FailoverRoute {
          &conditionalFailover]() {
           fiber_local<RouterInfo>::setFailoverTag(failoverTagging_);
           fiber_local<RouterInfo>::addRequestClass(RequestClass::kFailover);
+          // Failover children can share one serialized body; the
+          // serializer fingerprints the request content per send, so a
+          // child that mutates the request (per-child exptime or key
+          // rewrites are expressible in configs) gets a fresh
+          // serialization instead of the cached bytes.
+          // A stack cache is safe here: sequential sends complete before
+          // this lambda returns, and probeRace swaps in its own
+          // shared-ownership cache for the racing fibers.
+          SerializedRequestBodyCache bodyCache;
+          fiber_local<RouterInfo>::setSerializedBodyCache(&bodyCache);
           auto doFailover = [this, &req, &proxy, &normalReply](
               typename FailoverPolicyT::Iterator& child) {
             auto failoverReply = child->route(req);
@@ -254,7 +281,39 @@ class FailoverRoute {
             childIndex = cur.getTrueIndex();
           };
           auto nx = cur;
-          for (++nx; nx != failoverPolicy_.end(); ++cur, ++nx) {
+          ++nx;
+          // Race the first two failover children, consuming one extra
+          // rate limiter token for the extra in-flight request.
+          if (parallelProbe_ && nx != failoverPolicy_.end() &&
+              (!rateLimiter_ || rateLimiter_->failoverAllowed())) {
+            auto raced = probeRace(req, proxy, normalReply, cur, nx);
+            if (raced.conditionalFailover) {
+              conditionalFailover = true;
+            }
+            if (raced.winner.hasValue()) {
+              if (raced.winnerFromSecond) {
+                cur = nx;
+              }
+              return std::move(raced.winner).value();
+            }
+            // Both probes failed.  If they were the last two children,
+            // return the later error; otherwise keep failing over
+            // sequentially after the raced pair.
+            auto after = nx;
+            ++after;
+            if (after == failoverPolicy_.end()) {
+              if (raced.lastErrorFromSecond) {
+                cur = nx;
+              }
+              proxy.stats().increment(failover_all_failed_stat);
+              proxy.stats().increment(failoverPolicy_.getFailoverFailedStat());
+              return std::move(raced.lastError).value();
+            }
+            cur = after;
+            nx = after;
+            ++nx;
+          }
+          for (; nx != failoverPolicy_.end(); ++cur, ++nx) {
             auto failoverReply = doFailover(cur);
             switch (shouldFailover(failoverReply, req)) {
               case FailoverErrorsSettingsBase::FailoverType::NONE:
@@ -277,6 +336,120 @@ class FailoverRoute {
         });
   }
 
+  /**
+   * Outcome of racing the first two failover children.
+   */
+  template <class Reply>
+  struct ProbeRaceResult {
+    folly::Optional<Reply> winner;
+    folly::Optional<Reply> lastError;
+    bool winnerFromSecond{false};
+    bool lastErrorFromSecond{false};
+    bool conditionalFailover{false};
+  };
+
+  /**
+   * Races the first two failover children with a staggered start: the
+   * second child is contacted only if the first hasn't answered within
+   * parallelProbeDelayUs_.  A child that is timing out thus overlaps the
+   * next attempt instead of preceding it.
+   *
+   * The probe tasks own copies of everything they touch (request, normal
+   * reply, child route handle), since a losing probe may still be in
+   * flight after this method returns with the winner.
+   */
+  template <class Request>
+  ProbeRaceResult<ReplyT<Request>> probeRace(
+      const Request& req,
+      ProxyBase& proxy,
+      const ReplyT<Request>& normalReply,
+      typename FailoverPolicyT::Iterator first,
+      typename FailoverPolicyT::Iterator second) {
+    using Reply = ReplyT<Request>;
+
+    struct State {
+      bool firstDone{false};
+    };
+    auto state = std::make_shared<State>();
+    auto reqCopy = std::make_shared<Request>(req);
+    auto normalCopy = std::make_shared<Reply>(normalReply);
+    const size_t lastChildIndex = targets_.size() - 1;
+
+    // Probe fibers copy the caller's locals, including the serialized-body
+    // cache pointer, but a losing probe may outlive the stack frame that
+    // owns that cache.  Give the raced pair a cache they own jointly.
+    auto bodyCache = std::make_shared<SerializedRequestBodyCache>();
+
+    auto makeProbe = [&proxy, reqCopy, normalCopy, lastChildIndex, bodyCache](
+        std::shared_ptr<RouteHandleIf> child, size_t trueIndex) {
+      return [&proxy,
+              reqCopy,
+              normalCopy,
+              lastChildIndex,
+              bodyCache,
+              child = std::move(child),
+              trueIndex]() {
+        fiber_local<RouterInfo>::setSerializedBodyCache(bodyCache.get());
+        auto failoverReply = child->route(*reqCopy);
+        FailoverContext failoverContext(
+            trueIndex, lastChildIndex, *reqCopy, *normalCopy, failoverReply);
+        logFailover(proxy, failoverContext);
+        carbon::setIsFailoverIfPresent(failoverReply, true);
+        return failoverReply;
+      };
+    };
+
+    // Tasks return folly::none when they decided not to send anything.
+    std::vector<std::function<folly::Optional<Reply>()>> funcs;
+    funcs.reserve(2);
+
+    auto firstProbe =
+        makeProbe(targets_[first.getTrueIndex()], first.getTrueIndex());
+    funcs.push_back([firstProbe, state]() {
+      auto reply = firstProbe();
+      state->firstDone = true;
+      return folly::Optional<Reply>(std::move(reply));
+    });
+
+    auto secondProbe =
+        makeProbe(targets_[second.getTrueIndex()], second.getTrueIndex());
+    const auto delayUs = parallelProbeDelayUs_;
+    funcs.push_back([secondProbe, state, delayUs]() -> folly::Optional<Reply> {
+      folly::fibers::Baton sleepBaton;
+      sleepBaton.try_wait_for(std::chrono::microseconds(delayUs));
+      if (state->firstDone) {
+        return folly::none;
+      }
+      return folly::Optional<Reply>(secondProbe());
+    });
+
+    proxy.stats().increment(failover_parallel_probe_stat);
+
+    ProbeRaceResult<Reply> res;
+    auto taskIt = folly::fibers::addTasks(funcs.begin(), funcs.end());
+    while (taskIt.hasNext()) {
+      auto result = taskIt.awaitNext();
+      const bool fromSecond = taskIt.getTaskID() == 1;
+      if (!result.hasValue()) {
+        continue;
+      }
+      switch (shouldFailover(*result, req)) {
+        case FailoverErrorsSettingsBase::FailoverType::NONE:
+          res.winner = std::move(result);
+          res.winnerFromSecond = fromSecond;
+          return res;
+        case FailoverErrorsSettingsBase::FailoverType::CONDITIONAL:
+          res.conditionalFailover = true;
+          break;
+        default:
+          break;
+      }
+      res.lastError = std::move(result);
+      res.lastErrorFromSecond = fromSecond;
+    }
+    return res;
+  }
+
   template <class Request>
   FailoverErrorsSettingsBase::FailoverType shouldFailover(
       const ReplyT<Request>& reply,
@@ -10,6 +10,7 @@
 #include "mcrouter/lib/FailoverErrorsSettings.h"
 #include "mcrouter/lib/config/RouteHandleBuilder.h"
 #include "mcrouter/lib/config/RouteHandleFactory.h"
+#include "mcrouter/routes/DeadlineBudgetRoute.h"
 #include "mcrouter/routes/FailoverRateLimiter.h"
 #include "mcrouter/routes/FailoverRoute.h"
 #include "mcrouter/routes/ModifyExptimeRoute.h"
@@ -80,10 +81,29 @@ typename RouterInfo::RouteHandlePtr makeFailoverWithExptimeRoute(
     failover = factory.createList(*jfailover);
   }
 
+  // Optional total time budget for the whole failover sequence. With it,
+  // the first attempt is capped near the destination's p99 and each
+  // retry at whatever budget remains (see DeadlineBudgetRoute), instead
+  // of every attempt spending its full static timeout.
+  int64_t deadlineMs = 0;
+  if (auto jdeadline = json.get_ptr("deadline_ms")) {
+    checkLogic(
+        jdeadline->isInt(),
+        "FailoverWithExptimeRoute: deadline_ms is not an integer");
+    deadlineMs = jdeadline->getInt();
+    checkLogic(
+        deadlineMs >= 0, "FailoverWithExptimeRoute: deadline_ms is negative");
+  }
+
   auto children = detail::getFailoverChildren<RouterInfo>(
       std::move(normal), std::move(failover), failoverExptime);
-  return makeFailoverRouteDefault<RouterInfo, FailoverRoute>(
+  auto rh = makeFailoverRouteDefault<RouterInfo, FailoverRoute>(
       json, std::move(children));
+  if (deadlineMs > 0) {
+    rh = makeRouteHandleWithInfo<RouterInfo, DeadlineBudgetRoute>(
+        std::move(rh), deadlineMs);
+  }
+  return rh;
 }
 }
 }
@@ -8,6 +8,7 @@
 
 #include <folly/dynamic.h>
 
+#include "mcrouter/config.h"
 #include "mcrouter/lib/Ch3HashFunc.h"
 #include "mcrouter/lib/Crc32HashFunc.h"
 #include "mcrouter/lib/HashSelector.h"
@@ -21,6 +22,7 @@
 #include "mcrouter/routes/LatestRoute.h"
 #include "mcrouter/routes/LoadBalancerRoute.h"
 #include "mcrouter/routes/McRouteHandleBuilder.h"
+#include "mcrouter/routes/MigrationHashRoute.h"
 #include "mcrouter/routes/ShardHashFunc.h"
 
 namespace facebook {
@@ -42,6 +44,73 @@ typename RouterInfo::RouteHandlePtr createHashRoute(
       createHashSelector<HashFunc>(std::move(salt), std::move(func)));
 }
 
+/**
+ * Builds a MigrationHashRoute from the "migration" sub-object of a
+ * weighted HashRoute config:
+ *
+ *   "migration": {
+ *     "old_weights": [ ... ],      // ring weights before the change
+ *     "start_time": <epoch sec>,
+ *     "interval": <sec>            // optional, default 3600
+ *   }
+ *
+ * 'func' holds the new (post-change) weights from the enclosing config.
+ * If the window is already over when the config is built, this collapses
+ * to a plain hash route over the new ring.
+ */
+template <class RouterInfo, class HashFunc>
+typename RouterInfo::RouteHandlePtr createMigrationHashRoute(
+    const folly::dynamic& jmigration,
+    std::vector<typename RouterInfo::RouteHandlePtr> rh,
+    std::string salt,
+    HashFunc func) {
+  checkLogic(
+      jmigration.isObject(), "HashRoute: migration is not an object");
+
+  auto joldWeights = jmigration.get_ptr("old_weights");
+  checkLogic(
+      joldWeights && joldWeights->isArray(),
+      "HashRoute: migration.old_weights is not an array");
+  checkLogic(
+      joldWeights->size() >= rh.size(),
+      "HashRoute: migration.old_weights array is too small");
+  std::vector<double> oldWeights;
+  oldWeights.reserve(rh.size());
+  for (size_t i = 0; i < rh.size(); ++i) {
+    const auto& jw = (*joldWeights)[i];
+    checkLogic(
+        jw.isNumber(), "HashRoute: migration.old_weights: weight is not a number");
+    oldWeights.push_back(jw.asDouble());
+  }
+
+  auto jstart = jmigration.get_ptr("start_time");
+  checkLogic(
+      jstart && jstart->isInt(),
+      "HashRoute: migration has no/invalid start_time");
+  const time_t startTimeSec = jstart->getInt();
+  time_t intervalSec = 3600;
+  if (auto jinterval = jmigration.get_ptr("interval")) {
+    checkLogic(
+        jinterval->isInt(), "HashRoute: migration.interval is not an integer");
+    intervalSec = jinterval->asInt();
+  }
+
+  if (nowWallSec() >= startTimeSec + intervalSec) {
+    return createHashRoute<RouterInfo, HashFunc>(
+        std::move(rh), std::move(salt), std::move(func));
+  }
+
+  auto oldRing =
+      createHashSelector<HashFunc>(salt, HashFunc(std::move(oldWeights)));
+  auto newRing = createHashSelector<HashFunc>(std::move(salt), std::move(func));
+  return makeRouteHandleWithInfo<RouterInfo, MigrationHashRoute, HashFunc>(
+      std::move(rh),
+      std::move(oldRing),
+      std::move(newRing),
+      startTimeSec,
+      intervalSec);
+}
+
 template <class RouterInfo>
 std::shared_ptr<typename RouterInfo::RouteHandleIf> createHashRoute(
     const folly::dynamic& json,
@@ -76,10 +145,18 @@ std::shared_ptr<typename RouterInfo::RouteHandleIf> createHashRoute(
         std::move(rh), std::move(salt), Crc32HashFunc(n));
   } else if (funcType == WeightedCh3HashFunc::type()) {
     WeightedCh3HashFunc func{json, n};
+    if (auto jmigration = json.get_ptr("migration")) {
+      return createMigrationHashRoute<RouterInfo, WeightedCh3HashFunc>(
+          *jmigration, std::move(rh), std::move(salt), std::move(func));
+    }
     return createHashRoute<RouterInfo, WeightedCh3HashFunc>(
         std::move(rh), std::move(salt), std::move(func));
   } else if (funcType == WeightedCh4HashFunc::type()) {
     WeightedCh4HashFunc func{json, n};
+    if (auto jmigration = json.get_ptr("migration")) {
+      return createMigrationHashRoute<RouterInfo, WeightedCh4HashFunc>(
+          *jmigration, std::move(rh), std::move(salt), std::move(func));
+    }
     return createHashRoute<RouterInfo, WeightedCh4HashFunc>(
         std::move(rh), std::move(salt), std::move(func));
   } else if (funcType == ConstShardHashFunc::type()) {
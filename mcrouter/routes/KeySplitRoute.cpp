@@ -37,6 +37,13 @@ std::shared_ptr<MemcacheRouteHandleIf> makeKeySplitRoute(
 
   size_t replicas = json["replicas"].getInt();
   bool all_sync = json["all_sync"].getBool();
+  bool load_spread_reads = false;
+  if (auto* jLoadSpreadReads = json.get_ptr("load_spread_reads")) {
+    checkLogic(
+        jLoadSpreadReads->isBool(),
+        "KeySplitRoute: load_spread_reads is not a boolean");
+    load_spread_reads = jLoadSpreadReads->getBool();
+  }
   checkLogic(
       replicas >= KeySplitRoute::kMinReplicaCount,
       "KeySplitRoute: there should at least be 2 replicas");
@@ -45,7 +52,7 @@ std::shared_ptr<MemcacheRouteHandleIf> makeKeySplitRoute(
       "KeySplitRoute: there should no more than 1000 replicas");
 
   return std::make_shared<MemcacheRouteHandle<KeySplitRoute>>(
-      factory.create(json["destination"]), replicas, all_sync);
+      factory.create(json["destination"]), replicas, all_sync, load_spread_reads);
 }
 
 } // namespace mcrouter
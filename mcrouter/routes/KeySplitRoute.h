@@ -9,6 +9,7 @@
 #include <folly/Optional.h>
 #include <folly/fibers/AddTasks.h>
 #include <folly/fibers/FiberManager.h>
+#include <folly/hash/Hash.h>
 
 #include "mcrouter/lib/McKey.h"
 #include "mcrouter/lib/McResUtil.h"
@@ -40,10 +41,11 @@ class KeySplitRoute {
   std::string routeName() const {
     uint64_t replicaId = getReplicaId();
     return folly::sformat(
-        "keysplit|replicas={}|all-sync={}|replicaId={}",
+        "keysplit|replicas={}|all-sync={}|replicaId={}|load-spread-reads={}",
         replicas_,
         allSync_,
-        replicaId);
+        replicaId,
+        loadSpreadReads_);
   }
 
   static constexpr size_t kMinReplicaCount = 2;
@@ -53,7 +55,7 @@ class KeySplitRoute {
   void traverse(
       const Request& req,
       const RouteHandleTraverser<MemcacheRouteHandleIf>& t) const {
-    uint64_t replicaId = getReplicaId();
+    uint64_t replicaId = replicaIdFor(req);
     if (shouldAugmentRequest(replicaId)) {
       t(*child_, copyAndAugment(req, replicaId));
     } else {
@@ -64,8 +66,12 @@ class KeySplitRoute {
   KeySplitRoute(
       std::shared_ptr<MemcacheRouteHandleIf> child,
       size_t replicas,
-      bool allSync)
-      : child_(std::move(child)), replicas_(replicas), allSync_(allSync) {
+      bool allSync,
+      bool loadSpreadReads = false)
+      : child_(std::move(child)),
+        replicas_(replicas),
+        allSync_(allSync),
+        loadSpreadReads_(loadSpreadReads) {
     assert(child_ != nullptr);
     assert(replicas_ >= kMinReplicaCount);
     assert(replicas_ <= kMaxReplicaCount);
@@ -84,8 +90,17 @@ class KeySplitRoute {
     }
 
     // always retrieve from 1 replica
-    uint64_t replicaId = getReplicaId();
-    return routeOne(req, replicaId);
+    uint64_t replicaId = replicaIdFor(req);
+    auto reply = routeOne(req, replicaId);
+    // A spread replica may not have this host's writes yet; retry the
+    // write replica so load spreading never manufactures misses. Leases
+    // are excluded: a lease-get and its lease-set must target the same
+    // replica, which replicaIdFor already guarantees.
+    if (std::is_same<Request, McGetRequest>::value &&
+        isMissResult(reply.result()) && replicaId != getReplicaId()) {
+      return routeOne(req, getReplicaId());
+    }
+    return reply;
   }
 
   // Route only if all sync is enabled. Otherwise, route normally
@@ -149,6 +164,7 @@ class KeySplitRoute {
   const std::shared_ptr<MemcacheRouteHandleIf> child_;
   const size_t replicas_{2};
   const bool allSync_{false};
+  const bool loadSpreadReads_{false};
 
   template <class Request>
   bool canAugmentRequest(const Request& req) const {
@@ -200,6 +216,29 @@ class KeySplitRoute {
   uint64_t getReplicaId() const {
     return globals::hostid() % replicas_;
   }
+
+  uint64_t getSpreadReplicaId(folly::StringPiece key) const {
+    // Deterministic per (key, host): different client hosts read a hot
+    // key from different replicas, and a lease-set from this host lands
+    // on the same replica its lease-get used.
+    return folly::hash::hash_combine(
+               globals::hostid(),
+               folly::hash::fnv64_buf(key.data(), key.size())) %
+        replicas_;
+  }
+
+  template <class Request>
+  uint64_t replicaIdFor(const Request& req) const {
+    if (loadSpreadReads_ &&
+        folly::IsOneOf<
+            Request,
+            McGetRequest,
+            McLeaseGetRequest,
+            McLeaseSetRequest>::value) {
+      return getSpreadReplicaId(req.key().fullKey());
+    }
+    return getReplicaId();
+  }
 };
 
 std::shared_ptr<MemcacheRouteHandleIf> makeKeySplitRoute(
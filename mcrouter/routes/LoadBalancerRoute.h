@@ -46,16 +46,18 @@ class LoadBalancerRoute {
   enum class AlgorithmType : std::uint8_t {
     WEIGHTED_HASHING = 1,
     TWO_RANDOM_CHOICES = 2,
+    // Power-of-two-choices on the instantaneous number of outstanding
+    // requests per child, with the server load complement as tie-breaker.
+    TWO_CHOICES_LEAST_OUTSTANDING = 3,
   };
 
   static constexpr folly::StringPiece kWeightedHashing = "weighted-hashing";
   static constexpr folly::StringPiece kTwoRandomChoices = "two-random-choices";
+  static constexpr folly::StringPiece kTwoChoicesLeastOutstanding =
+      "two-choices-least-outstanding";
 
   std::string routeName() const {
-    return folly::to<std::string>(
-        "loadbalancer|",
-        algorithm_ == AlgorithmType::WEIGHTED_HASHING ? kWeightedHashing
-                                                      : kTwoRandomChoices);
+    return folly::to<std::string>("loadbalancer|", algorithmName());
   }
 
   /**
@@ -86,6 +88,7 @@ class LoadBalancerRoute {
         failoverCount_(std::min(failoverCount, children_.size())),
         loadComplements_(children_.size(), 1.0),
         medianLoadScratch_(children_.size()),
+        outstanding_(children_.size(), 0),
         expTimes_(children_.size(), std::chrono::microseconds(0)),
         gen_(seed),
         algorithm_(algorithm) {
@@ -102,7 +105,8 @@ class LoadBalancerRoute {
 
   template <class Request>
   ReplyT<Request> route(const Request& req) {
-    if (algorithm_ == AlgorithmType::TWO_RANDOM_CHOICES) {
+    if (algorithm_ == AlgorithmType::TWO_RANDOM_CHOICES ||
+        algorithm_ == AlgorithmType::TWO_CHOICES_LEAST_OUTSTANDING) {
       return routeTwoRandomChoices(req);
     }
     // first try
@@ -158,6 +162,10 @@ class LoadBalancerRoute {
   std::vector<double> loadComplements_;
   // Scratch space for computing the median of loadComplements_.
   std::vector<double> medianLoadScratch_;
+  // Number of requests currently outstanding towards each child. Route
+  // handle trees are per proxy thread, so plain counters suffice; fibers
+  // only yield at well-defined suspension points.
+  std::vector<uint32_t> outstanding_;
   // Point in time when the loadComplement becomes too old to be trusted.
   std::vector<std::chrono::microseconds> expTimes_;
   // Random Number generator used for TwoRandomChoices algorithm
@@ -200,7 +208,9 @@ class LoadBalancerRoute {
   template <class Request>
   ReplyT<Request> routeTwoRandomChoices(const Request& req) {
     std::pair<size_t, size_t> idxs = selectTwoRandomChoices();
+    ++outstanding_[idxs.first];
     auto rep = children_[idxs.first]->route(req);
+    --outstanding_[idxs.first];
     auto load = mcrouter::fiber_local<RouterInfo>::getServerLoad();
     loadComplements_[idxs.first] = load.complement().percentLoad() / 100;
 
@@ -283,6 +293,18 @@ class LoadBalancerRoute {
       }
     }
 
+    if (algorithm_ == AlgorithmType::TWO_CHOICES_LEAST_OUTSTANDING &&
+        outstanding_[x] != outstanding_[y]) {
+      // Unlike the load complement, which is only as fresh as the last
+      // reply from that child, the outstanding count reacts to queue
+      // buildup immediately. Fall through to the load comparison on ties
+      // (in particular when both children are idle).
+      if (outstanding_[x] < outstanding_[y]) {
+        return std::make_pair<size_t, size_t>(x, y);
+      }
+      return std::make_pair<size_t, size_t>(y, x);
+    }
+
     if (loadComplements_[x] > loadComplements_[y]) {
       return std::make_pair<size_t, size_t>(x, y);
     }
@@ -300,6 +322,18 @@ class LoadBalancerRoute {
     });
   }
 
+  folly::StringPiece algorithmName() const {
+    switch (algorithm_) {
+      case AlgorithmType::WEIGHTED_HASHING:
+        return kWeightedHashing;
+      case AlgorithmType::TWO_RANDOM_CHOICES:
+        return kTwoRandomChoices;
+      case AlgorithmType::TWO_CHOICES_LEAST_OUTSTANDING:
+        return kTwoChoicesLeastOutstanding;
+    }
+    return "unknown";
+  }
+
   double getLoadComplementsMedian() {
     // There are usually < 16 servers so the entire load complements vector
     // fits inside at MOST three cache lines. This is likely better than using
@@ -319,6 +353,9 @@ template <class RouterInfo>
 constexpr folly::StringPiece LoadBalancerRoute<RouterInfo>::kWeightedHashing;
 template <class RouterInfo>
 constexpr folly::StringPiece LoadBalancerRoute<RouterInfo>::kTwoRandomChoices;
+template <class RouterInfo>
+constexpr folly::StringPiece
+    LoadBalancerRoute<RouterInfo>::kTwoChoicesLeastOutstanding;
 
 template <class RouterInfo>
 struct LoadBalancerRouteOptions {
@@ -364,6 +401,11 @@ LoadBalancerRouteOptions<RouterInfo> parseLoadBalancerRouteJson(
         algorithmStr == LoadBalancerRoute<RouterInfo>::kTwoRandomChoices) {
       options.algorithm =
           LoadBalancerRoute<RouterInfo>::AlgorithmType::TWO_RANDOM_CHOICES;
+    } else if (
+        algorithmStr ==
+        LoadBalancerRoute<RouterInfo>::kTwoChoicesLeastOutstanding) {
+      options.algorithm = LoadBalancerRoute<
+          RouterInfo>::AlgorithmType::TWO_CHOICES_LEAST_OUTSTANDING;
     } else {
       throwLogic("Unknown algorithm: {}", algorithmStr);
     }
@@ -5,6 +5,7 @@
  *  file in the root directory of this source tree.
  *
  */
+#include <algorithm>
 #include <memory>
 
 #include <folly/Conv.h>
@@ -13,7 +14,9 @@
 #include "mcrouter/CarbonRouterInstanceBase.h"
 #include "mcrouter/McrouterLogFailure.h"
 #include "mcrouter/PoolFactory.h"
+#include "mcrouter/Proxy.h"
 #include "mcrouter/ProxyBase.h"
+#include "mcrouter/ProxyConfig.h"
 #include "mcrouter/ProxyDestination.h"
 #include "mcrouter/ProxyDestinationMap.h"
 #include "mcrouter/config.h"
@@ -96,6 +99,43 @@ McRouteHandleProvider<RouterInfo>::makePool(
     return existingIt->second;
   }
 
+  // If the live config has a pool with identical JSON, relink its existing
+  // destination handles instead of reconstructing them: much cheaper on
+  // large configs and keeps the underlying ProxyDestinations and their
+  // connections undisturbed. Pools with object-form server entries are
+  // skipped, since those may reference routes defined elsewhere in the
+  // config. Note this runs on the config and auxiliary build threads:
+  // getConfigUnsafe() serves those a copy taken under the config lock.
+  const size_t poolHash = jpool.json.hash();
+  if (const auto currentConfig =
+          static_cast<Proxy<RouterInfo>&>(proxy_).getConfigUnsafe()) {
+    const auto* jServerList = jpool.json.get_ptr("servers");
+    const bool allStringServers = jServerList && jServerList->isArray() &&
+        std::all_of(
+            jServerList->begin(),
+            jServerList->end(),
+            [](const folly::dynamic& server) { return server.isString(); });
+    if (allStringServers) {
+      const auto& prevHashes = currentConfig->getPoolHashes();
+      auto hashIt = prevHashes.find(jpool.name);
+      if (hashIt != prevHashes.end() && hashIt->second == poolHash) {
+        const auto& prevPools = currentConfig->getPools();
+        auto poolIt = prevPools.find(jpool.name);
+        if (poolIt != prevPools.end()) {
+          const auto& prevAccessPoints = currentConfig->getAccessPoints();
+          auto apIt = prevAccessPoints.find(jpool.name);
+          if (apIt != prevAccessPoints.end()) {
+            accessPoints_.emplace(jpool.name.str(), apIt->second);
+          }
+          poolHashes_.emplace(jpool.name.str(), poolHash);
+          return pools_.emplace(jpool.name.str(), poolIt->second)
+              .first->second;
+        }
+      }
+    }
+  }
+  poolHashes_.emplace(jpool.name.str(), poolHash);
+
   auto name = jpool.name.str();
   const auto& json = jpool.json;
   auto& opts = proxy_.router().opts();
@@ -171,6 +211,20 @@ McRouteHandleProvider<RouterInfo>::makePool(
       enableCompression = parseBool(*jCompression, "enable_compression");
     }
 
+    // Locality overrides, for pools that mix nearby (CPU-bound, skip
+    // compression) and remote (bandwidth-bound, compress) destinations.
+    folly::Optional<bool> compressionWithinDc;
+    if (auto jCompression = json.get_ptr("enable_compression_within_dc")) {
+      compressionWithinDc =
+          parseBool(*jCompression, "enable_compression_within_dc");
+    }
+
+    folly::Optional<bool> compressionCrossDc;
+    if (auto jCompression = json.get_ptr("enable_compression_cross_dc")) {
+      compressionCrossDc =
+          parseBool(*jCompression, "enable_compression_cross_dc");
+    }
+
     bool keepRoutingPrefix = false;
     if (auto jKeepRoutingPrefix = json.get_ptr("keep_routing_prefix")) {
       keepRoutingPrefix = parseBool(*jKeepRoutingPrefix, "keep_routing_prefix");
@@ -261,7 +315,8 @@ McRouteHandleProvider<RouterInfo>::makePool(
       checkLogic(ap != nullptr, "invalid server {}", server.stringPiece());
 
       if (withinDcMech.hasValue() || crossDcMech.hasValue() ||
-          withinDcPort.hasValue() || crossDcPort.hasValue()) {
+          withinDcPort.hasValue() || crossDcPort.hasValue() ||
+          compressionWithinDc.hasValue() || compressionCrossDc.hasValue()) {
         bool isInLocalDc = isInLocalDatacenter(ap->getHost());
         if (isInLocalDc) {
           if (withinDcMech.hasValue()) {
@@ -270,6 +325,9 @@ McRouteHandleProvider<RouterInfo>::makePool(
           if (withinDcPort.hasValue()) {
             ap->setPort(withinDcPort.value());
           }
+          if (compressionWithinDc.hasValue()) {
+            ap->setCompression(compressionWithinDc.value());
+          }
         } else {
           if (crossDcMech.hasValue()) {
             ap->setSecurityMech(crossDcMech.value());
@@ -277,6 +335,9 @@ McRouteHandleProvider<RouterInfo>::makePool(
           if (crossDcPort.hasValue()) {
             ap->setPort(crossDcPort.value());
           }
+          if (compressionCrossDc.hasValue()) {
+            ap->setCompression(compressionCrossDc.value());
+          }
         }
       }
 
@@ -301,11 +362,8 @@ McRouteHandleProvider<RouterInfo>::makePool(
       it->second.push_back(ap);
       folly::StringPiece nameSp = it->first;
 
-      auto pdstn = proxy_.destinationMap()->find(*ap, timeout);
-      if (!pdstn) {
-        pdstn = proxy_.destinationMap()->emplace(
-            std::move(ap), timeout, qosClass, qosPath, RouterInfo::name);
-      }
+      auto pdstn = proxy_.destinationMap()->emplace(
+          std::move(ap), timeout, qosClass, qosPath, RouterInfo::name);
       pdstn->updateShortestTimeout(connectTimeout, timeout);
 
       destinations.push_back(makeDestinationRoute<RouterInfo>(
@@ -383,12 +441,25 @@ McRouteHandleProvider<RouterInfo>::makePoolRoute(
     auto asynclogName = poolJson.name;
     bool needAsynclog = true;
     if (json.isObject()) {
+      // Flatten configured-but-no-op wrappers out of the chain: each one
+      // elided is one less virtual hop on every request to this pool.
       if (auto jrates = json.get_ptr("rates")) {
-        route = createRateLimitRoute(std::move(route), RateLimiter(*jrates));
+        RateLimiter rateLimiter(*jrates);
+        if (rateLimiter.hasAnyLimits()) {
+          route = createRateLimitRoute(std::move(route), std::move(rateLimiter));
+        }
       }
       if (auto jsplits = json.get_ptr("shard_splits")) {
-        route = makeShardSplitRoute<RouterInfo>(
-            std::move(route), ShardSplitter(*jsplits));
+        // Identical "shard_splits" blobs resolve to one shared splitter
+        // per router instance instead of one copy per proxy thread.
+        auto splitter = proxy_.router().shardSplitterCache().get(
+            *jsplits, [](const folly::dynamic& splitsJson) {
+              return std::make_shared<const ShardSplitter>(splitsJson);
+            });
+        if (!splitter->noSplits()) {
+          route = makeShardSplitRoute<RouterInfo>(
+              std::move(route), std::move(splitter));
+        }
       }
       if (auto jasynclog = json.get_ptr("asynclog")) {
         needAsynclog = parseBool(*jasynclog, "asynclog");
@@ -29,6 +29,7 @@
 #include "mcrouter/routes/LoadBalancerRoute.h"
 #include "mcrouter/routes/LoggingRoute.h"
 #include "mcrouter/routes/McExtraRouteHandleProvider.h"
+#include "mcrouter/routes/MicroCacheRoute.h"
 #include "mcrouter/routes/MigrateRouteFactory.h"
 #include "mcrouter/routes/MissFailoverRoute.h"
 #include "mcrouter/routes/ModifyExptimeRoute.h"
@@ -36,6 +37,7 @@
 #include "mcrouter/routes/OperationSelectorRoute.h"
 #include "mcrouter/routes/OutstandingLimitRoute.h"
 #include "mcrouter/routes/RandomRouteFactory.h"
+#include "mcrouter/routes/RewriteRoute.h"
 #include "mcrouter/routes/ShadowRoute.h"
 #include "mcrouter/routes/StagingRoute.h"
 
@@ -126,6 +128,7 @@ McRouteHandleProvider<MemcacheRouterInfo>::buildRouteMap() {
       {"LatestRoute", &makeLatestRoute<MemcacheRouterInfo>},
       {"LoadBalancerRoute", &makeLoadBalancerRoute<MemcacheRouterInfo>},
       {"LoggingRoute", &makeLoggingRoute<MemcacheRouterInfo>},
+      {"MicroCacheRoute", &makeMicroCacheRoute<MemcacheRouterInfo>},
       {"MigrateRoute", &makeMigrateRoute<MemcacheRouterInfo>},
       {"MissFailoverRoute", &makeMissFailoverRoute<MemcacheRouterInfo>},
       {"ModifyKeyRoute", &makeModifyKeyRoute<MemcacheRouterInfo>},
@@ -143,6 +146,7 @@ McRouteHandleProvider<MemcacheRouterInfo>::buildRouteMap() {
        [](McRouteHandleFactory& factory, const folly::dynamic& json) {
          return makeRateLimitRoute(factory, json);
        }},
+      {"RewriteRoute", &makeRewriteRoute<MemcacheRouterInfo>},
       {"StagingRoute", &makeStagingRoute},
       {"WarmUpRoute", &makeWarmUpRoute},
   };
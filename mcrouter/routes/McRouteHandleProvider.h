@@ -70,6 +70,10 @@ class McRouteHandleProvider
     return std::move(accessPoints_);
   }
 
+  folly::StringKeyedUnorderedMap<size_t> releasePoolHashes() {
+    return std::move(poolHashes_);
+  }
+
   ~McRouteHandleProvider() override;
 
  private:
@@ -88,6 +92,10 @@ class McRouteHandleProvider
       std::vector<std::shared_ptr<const AccessPoint>>>
       accessPoints_;
 
+  // poolName -> hash of the pool's JSON, used to detect unchanged pools
+  // across reconfigurations.
+  folly::StringKeyedUnorderedMap<size_t> poolHashes_;
+
   const RouteHandleFactoryMap routeMap_;
 
   const std::vector<RouteHandlePtr>& makePool(
@@ -0,0 +1,252 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/Format.h>
+#include <folly/Range.h>
+#include <folly/hash/Hash.h>
+#include <folly/io/IOBuf.h>
+
+#include "mcrouter/config.h"
+#include "mcrouter/lib/McResUtil.h"
+#include "mcrouter/lib/RouteHandleTraverser.h"
+#include "mcrouter/lib/carbon/RoutingGroups.h"
+#include "mcrouter/lib/config/RouteHandleFactory.h"
+#include "mcrouter/lib/fbi/cpp/util.h"
+#include "mcrouter/lib/network/gen/Memcache.h"
+#include "mcrouter/routes/McRouteHandleBuilder.h"
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+/**
+ * Serves very hot keys out of a small in-process cache instead of hitting
+ * the network. Unlike CarbonLookasideRoute, which talks to an external
+ * memcached tier, the cache here lives inside the route handle; since every
+ * proxy thread builds its own route handle tree, the cache is effectively
+ * thread-local and needs no locks.
+ *
+ * Only McGetRequest is served from the cache. Entries are stored on hit
+ * replies from the child and expire after a fixed TTL, which is expected to
+ * be tens of milliseconds: long enough to collapse a hot key's request storm
+ * onto one upstream fetch per TTL window, short enough to keep staleness
+ * negligible. Update- and delete-like requests passing through this handle
+ * invalidate their key before being forwarded, so a client writing through
+ * the same proxy never reads its own stale value.
+ *
+ * Eviction is CLOCK (second chance): a hit only sets a reference bit, so
+ * the per-request cost stays flat no matter how hot the key is, unlike LRU
+ * which would shuffle list links on every hit.
+ */
+template <class RouterInfo>
+class MicroCacheRoute {
+ public:
+  using RouteHandleIf = typename RouterInfo::RouteHandleIf;
+  using RouteHandlePtr = typename RouterInfo::RouteHandlePtr;
+
+  /**
+   * @param child       The route handle requests are forwarded to on a miss
+   * @param ttl         How long a cached value may be served
+   * @param maxEntries  Fixed capacity of the cache
+   */
+  MicroCacheRoute(
+      RouteHandlePtr child,
+      std::chrono::milliseconds ttl,
+      size_t maxEntries)
+      : child_(std::move(child)), ttlUs_(ttl.count() * 1000), slots_(maxEntries) {
+    assert(child_);
+    assert(ttlUs_ > 0);
+    assert(!slots_.empty());
+    index_.reserve(maxEntries);
+  }
+
+  std::string routeName() const {
+    return folly::sformat(
+        "micro-cache|ttl={}ms|max_entries={}", ttlUs_ / 1000, slots_.size());
+  }
+
+  template <class Request>
+  void traverse(
+      const Request& req,
+      const RouteHandleTraverser<RouteHandleIf>& t) const {
+    t(*child_, req);
+  }
+
+  McGetReply route(const McGetRequest& req) {
+    const auto now = nowUs();
+    if (const auto* entry = find(req.key().fullKey(), now)) {
+      McGetReply reply(mc_res_found);
+      reply.value() = entry->value.cloneAsValue();
+      reply.flags() = entry->flags;
+      return reply;
+    }
+    auto reply = child_->route(req);
+    if (isHitResult(reply.result()) && reply.value().hasValue()) {
+      store(req.key().fullKey(), *reply.value(), reply.flags(), now + ttlUs_);
+    }
+    return reply;
+  }
+
+  template <class Request>
+  ReplyT<Request> route(const Request& req) {
+    invalidate(req);
+    return child_->route(req);
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    folly::IOBuf value;
+    uint64_t flags{0};
+    int64_t expiryUs{0};
+    bool referenced{false};
+    bool occupied{false};
+  };
+
+  const RouteHandlePtr child_;
+  const int64_t ttlUs_;
+  /* Sized once in the constructor and never resized, so the StringPieces in
+     index_ pointing at slot keys stay valid until the slot is reused. */
+  std::vector<Entry> slots_;
+  std::unordered_map<folly::StringPiece, size_t, folly::Hash> index_;
+  size_t clockHand_{0};
+
+  template <class Request>
+  void invalidate(const Request& req, carbon::UpdateLikeT<Request> = 0) {
+    erase(req.key().fullKey());
+  }
+
+  template <class Request>
+  void invalidate(const Request& req, carbon::DeleteLikeT<Request> = 0) {
+    erase(req.key().fullKey());
+  }
+
+  template <class Request>
+  void invalidate(
+      const Request&,
+      carbon::OtherThanT<Request, carbon::UpdateLike<>, carbon::DeleteLike<>> =
+          0) {}
+
+  const Entry* find(folly::StringPiece key, int64_t now) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return nullptr;
+    }
+    auto& entry = slots_[it->second];
+    if (entry.expiryUs <= now) {
+      entry.occupied = false;
+      index_.erase(it);
+      return nullptr;
+    }
+    entry.referenced = true;
+    return &entry;
+  }
+
+  void erase(folly::StringPiece key) {
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      slots_[it->second].occupied = false;
+      index_.erase(it);
+    }
+  }
+
+  void store(
+      folly::StringPiece key,
+      const folly::IOBuf& value,
+      uint64_t flags,
+      int64_t expiryUs) {
+    auto it = index_.find(key);
+    size_t pos;
+    if (it != index_.end()) {
+      pos = it->second;
+    } else {
+      pos = evict();
+      auto& entry = slots_[pos];
+      if (entry.occupied) {
+        index_.erase(folly::StringPiece(entry.key));
+      }
+      entry.key = key.str();
+      index_.emplace(folly::StringPiece(entry.key), pos);
+    }
+    auto& entry = slots_[pos];
+    entry.value = value.cloneAsValue();
+    entry.flags = flags;
+    entry.expiryUs = expiryUs;
+    entry.referenced = false;
+    entry.occupied = true;
+  }
+
+  /**
+   * Advances the clock hand to the next victim slot. Referenced slots get a
+   * second chance; after one full sweep every reference bit is clear, so the
+   * scan is bounded by two passes.
+   */
+  size_t evict() {
+    for (size_t i = 0; i < 2 * slots_.size(); ++i) {
+      auto& entry = slots_[clockHand_];
+      const auto pos = clockHand_;
+      clockHand_ = (clockHand_ + 1) % slots_.size();
+      if (!entry.occupied || !entry.referenced) {
+        return pos;
+      }
+      entry.referenced = false;
+    }
+    return clockHand_;
+  }
+};
+
+/**
+ * Creates a MicroCacheRoute from a json config.
+ *
+ * Sample json:
+ * {
+ *   "type": "MicroCacheRoute",
+ *   "child": "PoolRoute|pool_name",
+ *   "ttl_ms": 10,
+ *   "max_entries": 1024
+ * }
+ */
+template <class RouterInfo>
+typename RouterInfo::RouteHandlePtr makeMicroCacheRoute(
+    RouteHandleFactory<typename RouterInfo::RouteHandleIf>& factory,
+    const folly::dynamic& json) {
+  checkLogic(json.isObject(), "MicroCacheRoute: config is not an object.");
+
+  auto jChild = json.get_ptr("child");
+  checkLogic(jChild != nullptr, "MicroCacheRoute: 'child' property is missing.");
+  auto child = factory.create(*jChild);
+
+  auto jTtl = json.get_ptr("ttl_ms");
+  checkLogic(jTtl != nullptr, "MicroCacheRoute: 'ttl_ms' property is missing.");
+  checkLogic(
+      jTtl->isInt() && jTtl->asInt() > 0,
+      "MicroCacheRoute: 'ttl_ms' must be a positive integer.");
+  std::chrono::milliseconds ttl{jTtl->asInt()};
+
+  size_t maxEntries = 1024;
+  if (auto jMaxEntries = json.get_ptr("max_entries")) {
+    checkLogic(
+        jMaxEntries->isInt() && jMaxEntries->asInt() > 0,
+        "MicroCacheRoute: 'max_entries' must be a positive integer.");
+    maxEntries = jMaxEntries->asInt();
+  }
+
+  return makeRouteHandleWithInfo<RouterInfo, MicroCacheRoute>(
+      std::move(child), ttl, maxEntries);
+}
+
+} // namespace mcrouter
+} // namespace memcache
+} // namespace facebook
@@ -9,6 +9,7 @@
 
 #include <folly/dynamic.h>
 
+#include "mcrouter/config.h"
 #include "mcrouter/lib/config/RouteHandleBuilder.h"
 #include "mcrouter/lib/config/RouteHandleFactory.h"
 #include "mcrouter/lib/routes/MigrateRoute.h"
@@ -57,11 +58,19 @@ typename RouterInfo::RouteHandlePtr makeMigrateRoute(
     intervalSec = jinterval->asInt();
   }
 
+  auto from = factory.create(json["from"]);
+  auto to = factory.create(json["to"]);
+
+  // If the migration (including the lease invalidation grace period) already
+  // completed when this config was built, the route is a plain alias for
+  // 'to': return it directly rather than wrapping it. Configs that stay
+  // loaded across the boundary flip in place via the latch in MigrateRoute.
+  if (nowWallSec() >= startTimeSec + 2 * intervalSec + 10) {
+    return to;
+  }
+
   return detail::makeMigrateRoute<RouterInfo>(
-      factory.create(json["from"]),
-      factory.create(json["to"]),
-      startTimeSec,
-      intervalSec);
+      std::move(from), std::move(to), startTimeSec, intervalSec);
 }
 } // mcrouter
 } // memcache
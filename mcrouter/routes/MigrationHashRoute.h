@@ -0,0 +1,205 @@
+/*
+ *  Copyright (c) 2017-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <folly/Conv.h>
+#include <folly/Optional.h>
+#include <folly/fibers/FiberManager.h>
+#include <folly/fibers/WhenN.h>
+
+#include "mcrouter/lib/HashSelector.h"
+#include "mcrouter/lib/McResUtil.h"
+#include "mcrouter/lib/Operation.h"
+#include "mcrouter/lib/Reply.h"
+#include "mcrouter/lib/RouteHandleTraverser.h"
+#include "mcrouter/lib/carbon/RoutingGroups.h"
+#include "mcrouter/routes/TimeProviderFunc.h"
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+/**
+ * Ring-granularity weight migration for weighted hash routes.
+ *
+ * Unlike MigrateRoute, which moves traffic between two separate route
+ * handle trees, both rings here select over the same children; only the
+ * weights differ, so a weight change remaps just the keys whose position
+ * actually moved.
+ *
+ * 1. Before start_time, all requests use the old ring.
+ * 2. During [start_time, start_time + interval):
+ *    - gets hash with the new ring first; on a miss at a position that
+ *      differs from the old ring's position, the get is retried at the
+ *      old position, so keys not yet rewritten keep hitting.
+ *    - deletes go to both positions and the worse reply wins, so stale
+ *      data cannot survive at either position (same rule as
+ *      MigrateRoute).
+ *    - everything else (sets, arithmetic) goes to the new position only,
+ *      warming the new ring as traffic flows.
+ * 3. After the window the route latches and costs the same as a plain
+ *    hash route over the new ring.
+ */
+template <class RouterInfo, class HashFunc>
+class MigrationHashRoute {
+ private:
+  using RouteHandleIf = typename RouterInfo::RouteHandleIf;
+
+ public:
+  std::string routeName() const {
+    return folly::to<std::string>("migration-hash|", HashFunc::type());
+  }
+
+  MigrationHashRoute(
+      std::vector<std::shared_ptr<RouteHandleIf>> children,
+      HashSelector<HashFunc> oldRing,
+      HashSelector<HashFunc> newRing,
+      time_t startTimeSec,
+      time_t intervalSec)
+      : children_(std::move(children)),
+        oldRing_(std::move(oldRing)),
+        newRing_(std::move(newRing)),
+        startTimeSec_(startTimeSec),
+        endTimeSec_(startTimeSec + intervalSec) {
+    assert(!children_.empty());
+  }
+
+  template <class Request>
+  void traverse(
+      const Request& req,
+      const RouteHandleTraverser<RouteHandleIf>& t) const {
+    if (migrated_.load(std::memory_order_relaxed)) {
+      t(*children_[newIndex(req)], req);
+      return;
+    }
+    const time_t now = tp_();
+    maybeLatchMigrated(now);
+    if (now < startTimeSec_) {
+      t(*children_[oldIndex(req)], req);
+      return;
+    }
+    const auto newIdx = newIndex(req);
+    t(*children_[newIdx], req);
+    if (now < endTimeSec_) {
+      const auto oldIdx = oldIndex(req);
+      if (oldIdx != newIdx) {
+        t(*children_[oldIdx], req);
+      }
+    }
+  }
+
+  // Gets try the new position first and fall back to the old one on miss.
+  template <class Request>
+  ReplyT<Request> route(const Request& req, carbon::GetLikeT<Request> = 0)
+      const {
+    if (migrated_.load(std::memory_order_relaxed)) {
+      return children_[newIndex(req)]->route(req);
+    }
+    const time_t now = tp_();
+    maybeLatchMigrated(now);
+    if (now < startTimeSec_) {
+      return children_[oldIndex(req)]->route(req);
+    }
+    const auto newIdx = newIndex(req);
+    auto reply = children_[newIdx]->route(req);
+    if (now < endTimeSec_ && isMissResult(reply.result())) {
+      const auto oldIdx = oldIndex(req);
+      if (oldIdx != newIdx) {
+        return children_[oldIdx]->route(req);
+      }
+    }
+    return reply;
+  }
+
+  // Deletes hit both positions during the window; the worse reply wins.
+  template <class Request>
+  ReplyT<Request> route(const Request& req, carbon::DeleteLikeT<Request> = 0)
+      const {
+    using Reply = ReplyT<Request>;
+
+    if (migrated_.load(std::memory_order_relaxed)) {
+      return children_[newIndex(req)]->route(req);
+    }
+    const time_t now = tp_();
+    maybeLatchMigrated(now);
+    if (now < startTimeSec_) {
+      return children_[oldIndex(req)]->route(req);
+    }
+    const auto newIdx = newIndex(req);
+    const auto oldIdx = now < endTimeSec_ ? oldIndex(req) : newIdx;
+    if (oldIdx == newIdx) {
+      return children_[newIdx]->route(req);
+    }
+
+    auto& oldRh = children_[oldIdx];
+    auto& newRh = children_[newIdx];
+    std::function<Reply()> fs[2]{
+        [&req, &oldRh]() { return oldRh->route(req); },
+        [&req, &newRh]() { return newRh->route(req); }};
+
+    folly::Optional<Reply> reply;
+    folly::fibers::forEach(fs, fs + 2, [&reply](size_t, Reply newReply) {
+      if (!reply || worseThan(newReply.result(), reply.value().result())) {
+        reply = std::move(newReply);
+      }
+    });
+    return std::move(reply.value());
+  }
+
+  // Everything else writes through to the new position.
+  template <class Request>
+  ReplyT<Request> route(
+      const Request& req,
+      carbon::OtherThanT<Request, carbon::GetLike<>, carbon::DeleteLike<>> =
+          0) const {
+    if (!migrated_.load(std::memory_order_relaxed)) {
+      const time_t now = tp_();
+      maybeLatchMigrated(now);
+      if (now < startTimeSec_) {
+        return children_[oldIndex(req)]->route(req);
+      }
+    }
+    return children_[newIndex(req)]->route(req);
+  }
+
+ private:
+  const std::vector<std::shared_ptr<RouteHandleIf>> children_;
+  const HashSelector<HashFunc> oldRing_;
+  const HashSelector<HashFunc> newRing_;
+  const time_t startTimeSec_;
+  const time_t endTimeSec_;
+  const TimeProviderFunc tp_;
+  // Set once the route becomes equivalent to the new ring for every
+  // request type.
+  mutable std::atomic<bool> migrated_{false};
+
+  void maybeLatchMigrated(time_t now) const {
+    if (now >= endTimeSec_) {
+      migrated_.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  template <class Request>
+  size_t oldIndex(const Request& req) const {
+    return oldRing_.select(req, children_.size());
+  }
+
+  template <class Request>
+  size_t newIndex(const Request& req) const {
+    return newRing_.select(req, children_.size());
+  }
+};
+
+} // mcrouter
+} // memcache
+} // facebook
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <folly/Range.h>
+#include <folly/hash/Hash.h>
+#include <folly/lang/Bits.h>
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+/**
+ * A compact per-proxy cache of keys whose gets recently missed. Hot misses
+ * (keys that don't exist but are queried constantly) can then be answered
+ * without routing downstream.
+ *
+ * The cache is a direct-mapped array of (key hash, expiry) buckets: no
+ * allocation after construction and a few loads per lookup. The full 64-bit
+ * hash is stored, so a false hit requires a full hash collision; combined
+ * with the intended sub-second TTL, serving a fabricated miss for a live
+ * key is vanishingly unlikely and short-lived. A colliding store simply
+ * displaces the previous occupant.
+ *
+ * Used only from the owning proxy thread, so there is no synchronization.
+ */
+class NegativeCache {
+ public:
+  /**
+   * @param entries  Number of buckets, rounded up to a power of two.
+   * @param ttl      How long a stored miss may be served; 0 disables the
+   *                 cache entirely.
+   */
+  NegativeCache(size_t entries, std::chrono::milliseconds ttl)
+      : ttlUs_(ttl.count() * 1000),
+        mask_(ttlUs_ > 0 ? folly::nextPowTwo(entries) - 1 : 0),
+        buckets_(mask_ + 1) {}
+
+  bool enabled() const {
+    return ttlUs_ > 0;
+  }
+
+  /**
+   * @return true if a miss for this key was stored and hasn't expired.
+   */
+  bool contains(folly::StringPiece key, int64_t nowUs) const {
+    const auto h = keyHash(key);
+    const auto& bucket = buckets_[h & mask_];
+    return bucket.hash == h && bucket.expiryUs > nowUs;
+  }
+
+  void store(folly::StringPiece key, int64_t nowUs) {
+    const auto h = keyHash(key);
+    auto& bucket = buckets_[h & mask_];
+    bucket.hash = h;
+    bucket.expiryUs = nowUs + ttlUs_;
+  }
+
+  void erase(folly::StringPiece key) {
+    const auto h = keyHash(key);
+    auto& bucket = buckets_[h & mask_];
+    if (bucket.hash == h) {
+      bucket.expiryUs = 0;
+    }
+  }
+
+ private:
+  struct Bucket {
+    uint64_t hash{0};
+    int64_t expiryUs{0};
+  };
+
+  const int64_t ttlUs_;
+  const uint64_t mask_;
+  std::vector<Bucket> buckets_;
+
+  static uint64_t keyHash(folly::StringPiece key) {
+    return folly::Hash()(key);
+  }
+};
+
+} // mcrouter
+} // memcache
+} // facebook
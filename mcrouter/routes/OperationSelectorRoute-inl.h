@@ -27,8 +27,29 @@ typename RouterInfo::RouteHandlePtr makeOperationSelectorRoute(
         typename RouterInfo::RoutableRequests,
         typename RouterInfo::RouteHandlePtr> operationPolicies,
     typename RouterInfo::RouteHandlePtr defaultPolicy) {
-  return makeRouteHandleWithInfo<RouterInfo, OperationSelectorRoute>(
-      std::move(operationPolicies), std::move(defaultPolicy));
+  using Map = carbon::RequestIdMap<
+      typename RouterInfo::RoutableRequests,
+      typename RouterInfo::RouteHandlePtr>;
+
+  if (defaultPolicy) {
+    /* The operation set is fully known here: route every operation without
+       an explicit policy to the default one, so the instantiated route()
+       needs no fallback branches at all. */
+    for (size_t id = Map::kMinId; id <= Map::kMaxId; ++id) {
+      if (!operationPolicies.getById(id)) {
+        auto rh = defaultPolicy;
+        operationPolicies.set(id, std::move(rh));
+      }
+    }
+    return makeRouteHandleWithInfo<
+        RouterInfo,
+        OperationSelectorRoute,
+        std::true_type>(std::move(operationPolicies));
+  }
+  return makeRouteHandleWithInfo<
+      RouterInfo,
+      OperationSelectorRoute,
+      std::false_type>(std::move(operationPolicies));
 }
 
 } // detail
@@ -9,6 +9,7 @@
 
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "mcrouter/lib/Operation.h"
@@ -27,8 +28,13 @@ class RouteHandleFactory;
 
 namespace mcrouter {
 
-/* RouteHandle that can send to a different target based on McOperation id */
-template <class RouterInfo>
+/* RouteHandle that can send to a different target based on McOperation id.
+ *
+ * HaveDefaultPolicy is known at config time: when a default policy exists,
+ * the factory pre-fills every unset operation slot with it and instantiates
+ * the std::true_type specialization, whose route() is an unconditional
+ * lookup with the null checks compiled out. */
+template <class RouterInfo, class HaveDefaultPolicy = std::true_type>
 class OperationSelectorRoute {
  private:
   using RouteHandleIf = typename RouterInfo::RouteHandleIf;
@@ -40,40 +46,32 @@ class OperationSelectorRoute {
     return "operation-selector";
   }
 
-  OperationSelectorRoute(
-      carbon::RequestIdMap<RoutableRequests, RouteHandlePtr> operationPolicies,
-      RouteHandlePtr&& defaultPolicy)
-      : operationPolicies_(std::move(operationPolicies)),
-        defaultPolicy_(std::move(defaultPolicy)) {}
+  explicit OperationSelectorRoute(
+      carbon::RequestIdMap<RoutableRequests, RouteHandlePtr> operationPolicies)
+      : operationPolicies_(std::move(operationPolicies)) {}
 
   template <class Request>
   void traverse(
       const Request& req,
       const RouteHandleTraverser<RouteHandleIf>& t) const {
-    if (const auto& rh =
-            operationPolicies_.template getByRequestType<Request>()) {
+    const auto& rh = operationPolicies_.template getByRequestType<Request>();
+    if (HaveDefaultPolicy::value || rh) {
       t(*rh, req);
-    } else if (defaultPolicy_) {
-      t(*defaultPolicy_, req);
     }
   }
 
   template <class Request>
   ReplyT<Request> route(const Request& req) const {
-    if (const auto& rh =
-            operationPolicies_.template getByRequestType<Request>()) {
+    const auto& rh = operationPolicies_.template getByRequestType<Request>();
+    if (HaveDefaultPolicy::value || rh) {
       return rh->route(req);
-    } else if (defaultPolicy_) {
-      return defaultPolicy_->route(req);
     }
-
     return ReplyT<Request>();
   }
 
  private:
   const carbon::RequestIdMap<RoutableRequests, RouteHandlePtr>
       operationPolicies_;
-  const RouteHandlePtr defaultPolicy_;
 };
 
 template <class RouterInfo>
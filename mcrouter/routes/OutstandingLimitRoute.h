@@ -40,8 +40,18 @@ namespace mcrouter {
 
 /*
  * No more than N requests will be allowed to be concurrently processed by child
- * route. All blocked requests will be sent one request per sender id in
- * round-robin fashion to guarantee fairness.
+ * route.
+ *
+ * Blocked requests are fair-queued per sender id (the client session
+ * identity carried by ProxyRequestContext): each sender has its own wait
+ * queue, and a freed slot is handed to the head of the next sender's
+ * queue in round-robin order, with the sender rotating to the back of
+ * the line while it still has waiters. Since every request occupies
+ * exactly one slot, this is deficit round-robin with a quantum of one:
+ * under saturation an aggressive session is bounded to a 1/k share of
+ * slots against k-1 competing sessions, regardless of how deep its own
+ * queue grows. Requests without a sender id each form their own
+ * single-request queue, i.e. they are served FIFO among themselves.
  */
 template <class RouterInfo>
 class OutstandingLimitRoute {
@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <chrono>
+
 #include <folly/Optional.h>
 
 #include "mcrouter/Proxy.h"
@@ -57,7 +59,11 @@ ProxyRoute<RouterInfo>::ProxyRoute(
     : proxy_(proxy),
       root_(makeRouteHandle<typename RouterInfo::RouteHandleIf, RootRoute>(
           proxy_,
-          routeSelectors)) {
+          routeSelectors)),
+      negativeCache_(
+          proxy_.getRouterOptions().negative_cache_entries,
+          std::chrono::milliseconds(
+              proxy_.getRouterOptions().negative_cache_ttl_ms)) {
   if (proxy_.getRouterOptions().big_value_split_threshold != 0) {
     root_ = detail::wrapWithBigValueRoute(
         std::move(root_), proxy_.getRouterOptions());
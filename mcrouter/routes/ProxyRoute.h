@@ -11,16 +11,21 @@
 #include <string>
 #include <vector>
 
+#include <folly/Likely.h>
+
 #include "mcrouter/McrouterFiberContext.h"
 #include "mcrouter/ProxyDestination.h"
 #include "mcrouter/ProxyDestinationMap.h"
+#include "mcrouter/config.h"
 #include "mcrouter/lib/McOperation.h"
 #include "mcrouter/lib/Reply.h"
 #include "mcrouter/lib/RouteHandleTraverser.h"
+#include "mcrouter/lib/carbon/RoutingGroups.h"
 #include "mcrouter/lib/mc/msg.h"
 #include "mcrouter/lib/network/gen/Memcache.h"
 #include "mcrouter/lib/routes/AllSyncRoute.h"
 #include "mcrouter/routes/BigValueRouteIf.h"
+#include "mcrouter/routes/NegativeCache.h"
 #include "mcrouter/routes/RouteSelectorMap.h"
 #include "mcrouter/stats.h"
 
@@ -55,15 +60,25 @@ class ProxyRoute {
 
   template <class Request>
   ReplyT<Request> route(const Request& req) const {
-    auto reply = root_->route(req);
-
-    auto& requestContext = fiber_local<RouterInfo>::getSharedCtx();
-    requestContext->setFinalResult(reply.result());
+    invalidateNegativeCache(req);
+    return routeImpl(req);
+  }
 
-    if (isErrorResult(reply.result())) {
-      proxy_.stats().increment(final_result_error_stat);
+  McGetReply route(const McGetRequest& req) const {
+    if (!negativeCache_.enabled()) {
+      return routeImpl(req);
+    }
+    const auto now = nowUs();
+    if (negativeCache_.contains(req.key().fullKey(), now)) {
+      proxy_.stats().increment(negative_cache_hits_stat);
+      auto reply = createReply(DefaultReply, req);
+      fiber_local<RouterInfo>::getSharedCtx()->setFinalResult(reply.result());
+      return reply;
+    }
+    auto reply = routeImpl(req);
+    if (reply.result() == mc_res_notfound) {
+      negativeCache_.store(req.key().fullKey(), now);
     }
-
     return reply;
   }
 
@@ -77,6 +92,97 @@ class ProxyRoute {
  private:
   Proxy<RouterInfo>& proxy_;
   std::shared_ptr<typename RouterInfo::RouteHandleIf> root_;
+  // Only touched from the proxy thread; mutable because the RouteHandleIf
+  // adapter calls us through const methods.
+  mutable NegativeCache negativeCache_;
+
+  template <class Request>
+  ReplyT<Request> routeImpl(const Request& req) const {
+    const auto profilerHz = proxy_.router().opts().route_handle_profiler_hz;
+    auto reply = UNLIKELY(
+                     profilerHz != 0 &&
+                     proxy_.routeHandleProfiler().shouldSample(
+                         nowUs(), profilerHz))
+        ? routeSampled(req)
+        : root_->route(req);
+
+    auto& requestContext = fiber_local<RouterInfo>::getSharedCtx();
+    requestContext->setFinalResult(reply.result());
+
+    if (isErrorResult(reply.result())) {
+      proxy_.stats().increment(final_result_error_stat);
+    }
+
+    return reply;
+  }
+
+  /**
+   * Route a sampled request and attribute its duration to the route
+   * handle paths it maps to. The paths come from traverse(), i.e. they
+   * cover the config subtree this request can reach (including e.g.
+   * failover children that ended up not being contacted); native stack
+   * capture can't see through the fiber trampolines, so the route handle
+   * chain is the profile key that maps back to the config.
+   */
+  template <class Request>
+  ReplyT<Request> routeSampled(const Request& req) const {
+    const auto startUs = nowUs();
+    auto reply = root_->route(req);
+    const auto durationUs = static_cast<uint64_t>(nowUs() - startUs);
+
+    // Build folded ("a;b;c") root-to-leaf paths via DFS and record each
+    // leaf path with the request duration as its weight.
+    std::string path = routeName();
+    std::vector<size_t> prefixLengths;
+    bool atLeaf = false;
+    RouteHandleTraverser<typename RouterInfo::RouteHandleIf> t(
+        [&path, &prefixLengths, &atLeaf](
+            const typename RouterInfo::RouteHandleIf& rh) {
+          prefixLengths.push_back(path.size());
+          path.push_back(';');
+          path.append(rh.routeName());
+          atLeaf = true;
+        },
+        [this, &path, &prefixLengths, &atLeaf, durationUs]() {
+          if (atLeaf) {
+            proxy_.routeHandleProfiler().recordPath(path, durationUs);
+            atLeaf = false;
+          }
+          path.resize(prefixLengths.back());
+          prefixLengths.pop_back();
+        });
+    t(*root_, req);
+    return reply;
+  }
+
+  /**
+   * A write routed through this proxy must immediately stop us from serving
+   * a remembered miss for its key, or the writer would fail to read its own
+   * write for up to a TTL.
+   */
+  template <class Request>
+  void invalidateNegativeCache(
+      const Request& req,
+      carbon::UpdateLikeT<Request> = 0) const {
+    if (negativeCache_.enabled()) {
+      negativeCache_.erase(req.key().fullKey());
+    }
+  }
+
+  template <class Request>
+  void invalidateNegativeCache(
+      const Request& req,
+      carbon::DeleteLikeT<Request> = 0) const {
+    if (negativeCache_.enabled()) {
+      negativeCache_.erase(req.key().fullKey());
+    }
+  }
+
+  template <class Request>
+  void invalidateNegativeCache(
+      const Request&,
+      carbon::OtherThanT<Request, carbon::UpdateLike<>, carbon::DeleteLike<>> =
+          0) const {}
 
   std::vector<std::shared_ptr<typename RouterInfo::RouteHandleIf>>
   getAllDestinations() const;
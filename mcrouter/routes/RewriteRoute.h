@@ -0,0 +1,385 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <folly/Conv.h>
+#include <folly/Format.h>
+#include <folly/Optional.h>
+#include <folly/Range.h>
+#include <folly/dynamic.h>
+
+#include "mcrouter/RoutingPrefix.h"
+#include "mcrouter/lib/McKey.h"
+#include "mcrouter/lib/Operation.h"
+#include "mcrouter/lib/Reply.h"
+#include "mcrouter/lib/RouteHandleTraverser.h"
+#include "mcrouter/lib/carbon/RoutingGroups.h"
+#include "mcrouter/lib/config/RouteHandleBuilder.h"
+#include "mcrouter/lib/config/RouteHandleFactory.h"
+#include "mcrouter/lib/fbi/cpp/TypeList.h"
+#include "mcrouter/lib/fbi/cpp/util.h"
+#include "mcrouter/lib/network/CarbonMessageList.h"
+#include "mcrouter/routes/ModifyExptimeRoute.h"
+#include "mcrouter/routes/ModifyKeyRoute.h"
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+/**
+ * Compiled rewrite list for RewriteRoute. Each section is independent;
+ * unset sections leave the corresponding request field untouched.
+ */
+struct RewriteRouteSettings {
+  /* Exptime clamp; semantics of ModifyExptimeRoute. Never applied to
+     delete requests. */
+  folly::Optional<int32_t> exptime;
+  ModifyExptimeAction exptimeAction{ModifyExptimeAction::Set};
+
+  /* Key rewrite; semantics of ModifyKeyRoute. */
+  bool rewriteKey{false};
+  folly::Optional<std::string> routingPrefix;
+  std::string keyPrefix;
+  bool modifyInplace{false};
+  folly::Optional<std::string> keyReplace;
+  std::string keySuffix;
+
+  /* Flag masking: flags = (flags & andMask) | orMask. The defaults are
+     an identity transform. */
+  uint64_t flagsAndMask{std::numeric_limits<uint64_t>::max()};
+  uint64_t flagsOrMask{0};
+
+  bool rewritesFlags() const {
+    return flagsAndMask != std::numeric_limits<uint64_t>::max() ||
+        flagsOrMask != 0;
+  }
+};
+
+/**
+ * Applies a configured list of field rewrites (exptime clamp, key
+ * prefix/suffix munging, flag masking) in a single pass with at most
+ * one request copy, replacing stacks of ModifyExptimeRoute /
+ * ModifyKeyRoute wrappers that each add a route hop and copy the
+ * request. Requests that no rewrite would change are forwarded without
+ * copying.
+ *
+ * Config:
+ *   "target": required child route
+ *   "exptime": {"value": N, "action": "set"|"min" (default "set")}
+ *   "key": same fields as ModifyKeyRoute (set_routing_prefix,
+ *          ensure_key_prefix, replace_key_prefix, set_key_suffix,
+ *          modify_inplace)
+ *   "flags": {"and_mask": M (default all ones), "or_mask": M (default 0)}
+ */
+template <class RouteHandleIf>
+class RewriteRoute {
+ public:
+  std::string routeName() const {
+    std::string name = "rewrite";
+    if (settings_.exptime.hasValue()) {
+      name += folly::sformat(
+          "|exptime-{}={}",
+          detail::actionToString(settings_.exptimeAction),
+          settings_.exptime.value());
+    }
+    if (settings_.rewriteKey) {
+      name += "|key";
+    }
+    if (settings_.rewritesFlags()) {
+      name += folly::sformat(
+          "|flags={:#x}&{:#x}",
+          settings_.flagsAndMask,
+          settings_.flagsOrMask);
+    }
+    return name;
+  }
+
+  RewriteRoute(
+      std::shared_ptr<RouteHandleIf> target,
+      RewriteRouteSettings settings)
+      : target_(std::move(target)), settings_(std::move(settings)) {
+    assert(
+        settings_.exptimeAction != ModifyExptimeAction::Min ||
+        !settings_.exptime.hasValue() || settings_.exptime.value() != 0);
+  }
+
+  template <class Request>
+  void traverse(
+      const Request& req,
+      const RouteHandleTraverser<RouteHandleIf>& t) const {
+    auto cloneReq = req;
+    if (settings_.rewriteKey) {
+      if (auto key = getModifiedKey(req.key())) {
+        cloneReq.key() = key.value();
+      }
+    }
+    applyExptime(cloneReq);
+    applyFlags(cloneReq);
+    t(*target_, cloneReq);
+  }
+
+  template <class Request>
+  ReplyT<Request> route(const Request& req) const {
+    folly::Optional<std::string> newKey;
+    if (settings_.rewriteKey) {
+      newKey = getModifiedKey(req.key());
+      if (newKey.hasValue()) {
+        constexpr bool kIsMemcacheRequest =
+            ListContains<McRequestList, Request>::value;
+        const auto err = isKeyValid<kIsMemcacheRequest>(newKey.value());
+        if (err != mc_req_err_valid) {
+          return createReply<Request>(
+              ErrorReply,
+              "RewriteRoute: invalid key: " +
+                  std::string(mc_req_err_to_string(err)));
+        }
+      }
+    }
+
+    if (!newKey.hasValue() && !needsExptime(req) && !needsFlags(req)) {
+      return target_->route(req);
+    }
+
+    /* The only copy; every rewrite below mutates it in place. */
+    auto mutReq = req;
+    if (newKey.hasValue()) {
+      mutReq.key() = newKey.value();
+    }
+    applyExptime(mutReq);
+    applyFlags(mutReq);
+    return target_->route(mutReq);
+  }
+
+ private:
+  const std::shared_ptr<RouteHandleIf> target_;
+  const RewriteRouteSettings settings_;
+
+  template <class StringLike>
+  folly::Optional<std::string> getModifiedKey(
+      const carbon::Keys<StringLike>& reqKey) const {
+    folly::StringPiece rp = settings_.routingPrefix.hasValue()
+        ? settings_.routingPrefix.value()
+        : reqKey.routingPrefix();
+
+    if (settings_.keyReplace.hasValue() &&
+        reqKey.keyWithoutRoute().startsWith(settings_.keyReplace.value())) {
+      auto keyWithoutRoute = reqKey.keyWithoutRoute();
+      keyWithoutRoute.advance(settings_.keyReplace.value().size());
+      return folly::to<std::string>(
+          rp, settings_.keyPrefix, keyWithoutRoute, settings_.keySuffix);
+    } else if (!reqKey.keyWithoutRoute().startsWith(settings_.keyPrefix)) {
+      auto keyWithoutRoute = reqKey.keyWithoutRoute();
+      if (settings_.modifyInplace &&
+          keyWithoutRoute.size() >= settings_.keyPrefix.size()) {
+        keyWithoutRoute.advance(settings_.keyPrefix.size());
+      }
+      return folly::to<std::string>(
+          rp, settings_.keyPrefix, keyWithoutRoute, settings_.keySuffix);
+    } else if (
+        settings_.routingPrefix.hasValue() && rp != reqKey.routingPrefix()) {
+      return folly::to<std::string>(
+          rp, reqKey.keyWithoutRoute(), settings_.keySuffix);
+    } else if (!settings_.keySuffix.empty()) {
+      return folly::to<std::string>(
+          reqKey.fullKey(), settings_.keySuffix);
+    }
+    return folly::none;
+  }
+
+  template <class Request>
+  typename std::enable_if<
+      Request::hasExptime &&
+          carbon::OtherThan<Request, carbon::DeleteLike<>>::value,
+      bool>::type
+  needsExptime(const Request& req) const {
+    if (!settings_.exptime.hasValue()) {
+      return false;
+    }
+    switch (settings_.exptimeAction) {
+      case ModifyExptimeAction::Set:
+        return req.exptime() != settings_.exptime.value();
+      case ModifyExptimeAction::Min:
+        /* 0 means infinite exptime. */
+        return req.exptime() == 0 ||
+            req.exptime() > settings_.exptime.value();
+    }
+    return false;
+  }
+
+  template <class Request>
+  typename std::enable_if<
+      !Request::hasExptime || carbon::DeleteLike<Request>::value,
+      bool>::type
+  needsExptime(const Request&) const {
+    return false;
+  }
+
+  template <class Request>
+  typename std::enable_if<
+      Request::hasExptime &&
+          carbon::OtherThan<Request, carbon::DeleteLike<>>::value,
+      void>::type
+  applyExptime(Request& req) const {
+    if (needsExptime(req)) {
+      req.exptime() = settings_.exptime.value();
+    }
+  }
+
+  template <class Request>
+  typename std::enable_if<
+      !Request::hasExptime || carbon::DeleteLike<Request>::value,
+      void>::type
+  applyExptime(Request&) const {}
+
+  template <class Request>
+  typename std::enable_if<Request::hasFlags, bool>::type needsFlags(
+      const Request& req) const {
+    const uint64_t flags = req.flags();
+    return ((flags & settings_.flagsAndMask) | settings_.flagsOrMask) !=
+        flags;
+  }
+
+  template <class Request>
+  typename std::enable_if<!Request::hasFlags, bool>::type needsFlags(
+      const Request&) const {
+    return false;
+  }
+
+  template <class Request>
+  typename std::enable_if<Request::hasFlags, void>::type applyFlags(
+      Request& req) const {
+    req.flags() =
+        (req.flags() & settings_.flagsAndMask) | settings_.flagsOrMask;
+  }
+
+  template <class Request>
+  typename std::enable_if<!Request::hasFlags, void>::type applyFlags(
+      Request&) const {}
+};
+
+template <class RouterInfo>
+typename RouterInfo::RouteHandlePtr makeRewriteRoute(
+    RouteHandleFactory<typename RouterInfo::RouteHandleIf>& factory,
+    const folly::dynamic& json) {
+  checkLogic(json.isObject(), "RewriteRoute: should be an object");
+  auto jtarget = json.get_ptr("target");
+  checkLogic(jtarget, "RewriteRoute: no target");
+  auto target = factory.create(*jtarget);
+
+  RewriteRouteSettings settings;
+
+  if (auto jexptime = json.get_ptr("exptime")) {
+    checkLogic(jexptime->isObject(), "RewriteRoute: exptime is not an object");
+    auto jvalue = jexptime->get_ptr("value");
+    checkLogic(jvalue, "RewriteRoute: exptime: no value");
+    checkLogic(jvalue->isInt(), "RewriteRoute: exptime: value is not an int");
+    settings.exptime = jvalue->getInt();
+    if (auto jaction = jexptime->get_ptr("action")) {
+      checkLogic(
+          jaction->isString(),
+          "RewriteRoute: exptime: action is not a string");
+      settings.exptimeAction = detail::stringToAction(jaction->getString());
+    }
+    /* 0 means infinite exptime: min(x, infinity) is a no-op. */
+    if (settings.exptimeAction == ModifyExptimeAction::Min &&
+        settings.exptime.value() == 0) {
+      settings.exptime.clear();
+    }
+  }
+
+  if (auto jkey = json.get_ptr("key")) {
+    checkLogic(jkey->isObject(), "RewriteRoute: key is not an object");
+    settings.rewriteKey = true;
+    if (auto jroutingPrefix = jkey->get_ptr("set_routing_prefix")) {
+      auto rp = jroutingPrefix->stringPiece();
+      if (rp.empty()) {
+        settings.routingPrefix = "";
+      } else {
+        try {
+          settings.routingPrefix = RoutingPrefix(rp).str();
+        } catch (const std::exception& e) {
+          throw std::logic_error(
+              "RewriteRoute: key: set_routing_prefix: " +
+              std::string(e.what()));
+        }
+      }
+    }
+    if (auto jkeyPrefix = jkey->get_ptr("ensure_key_prefix")) {
+      settings.keyPrefix = jkeyPrefix->getString();
+      auto err = isKeyValid<true /* DoSpaceAndCtrlCheck */>(
+          settings.keyPrefix);
+      checkLogic(
+          settings.keyPrefix.empty() || err == mc_req_err_valid,
+          "RewriteRoute: key: invalid key prefix '{}', {}",
+          settings.keyPrefix,
+          mc_req_err_to_string(err));
+    }
+    if (auto jkeyReplace = jkey->get_ptr("replace_key_prefix")) {
+      settings.keyReplace = jkeyReplace->getString();
+      auto err = isKeyValid<true /* DoSpaceAndCtrlCheck */>(
+          settings.keyReplace.value());
+      checkLogic(
+          settings.keyReplace.value().empty() || err == mc_req_err_valid,
+          "RewriteRoute: key: invalid key prefix '{}', {}",
+          settings.keyReplace.value(),
+          mc_req_err_to_string(err));
+    }
+    if (auto jkeySuffix = jkey->get_ptr("set_key_suffix")) {
+      settings.keySuffix = jkeySuffix->getString();
+      auto err = isKeyValid<true /* DoSpaceAndCtrlCheck */>(
+          settings.keySuffix);
+      checkLogic(
+          settings.keySuffix.empty() || err == mc_req_err_valid,
+          "RewriteRoute: key: invalid key suffix '{}', {}",
+          settings.keySuffix,
+          mc_req_err_to_string(err));
+    }
+    if (auto joverwrite = jkey->get_ptr("modify_inplace")) {
+      checkLogic(
+          !settings.keyReplace.hasValue(),
+          "RewriteRoute: key: replace_key_prefix and modify_inplace cannot"
+          " be used together");
+      checkLogic(
+          joverwrite->isBool(),
+          "RewriteRoute: key: modify_inplace is not a bool");
+      settings.modifyInplace = joverwrite->asBool();
+    }
+  }
+
+  if (auto jflags = json.get_ptr("flags")) {
+    checkLogic(jflags->isObject(), "RewriteRoute: flags is not an object");
+    if (auto jandMask = jflags->get_ptr("and_mask")) {
+      checkLogic(
+          jandMask->isInt(), "RewriteRoute: flags: and_mask is not an int");
+      settings.flagsAndMask = jandMask->asInt();
+    }
+    if (auto jorMask = jflags->get_ptr("or_mask")) {
+      checkLogic(
+          jorMask->isInt(), "RewriteRoute: flags: or_mask is not an int");
+      settings.flagsOrMask = jorMask->asInt();
+    }
+  }
+
+  /* All sections absent (or compiled away): nothing to rewrite. */
+  if (!settings.exptime.hasValue() && !settings.rewriteKey &&
+      !settings.rewritesFlags()) {
+    return target;
+  }
+
+  return makeRouteHandle<typename RouterInfo::RouteHandleIf, RewriteRoute>(
+      std::move(target), std::move(settings));
+}
+
+} // mcrouter
+} // memcache
+} // facebook
@@ -40,7 +40,10 @@ class RootRoute {
         rhMap_(
             routeSelectors,
             opts_.default_route,
-            opts_.send_invalid_route_to_default) {}
+            opts_.send_invalid_route_to_default),
+        defaultRouteFastPath_(
+            !opts_.group_remote_errors && !opts_.miss_on_get_errors &&
+            !opts_.allow_only_gets) {}
 
   template <class Request>
   void traverse(
@@ -71,6 +74,24 @@ class RootRoute {
     const auto* rhPtr = rhMap_.getTargetsForKeyFast(
         req.key().routingPrefix(), req.key().routingKey());
 
+    if (LIKELY(rhPtr != nullptr && !rhPtr->empty())) {
+      /* The first handle is about to be chased through a virtual call;
+         its leading cacheline (vtable pointer) is usually cold after the
+         hash-table walk above.  Start the load now so it overlaps with
+         the fast-path checks below. */
+      __builtin_prefetch((*rhPtr)[0].get());
+    }
+
+    /* Common case: a single target and none of the reply-rewriting
+       options in effect, folded into one boolean at construction.
+       Arithmetic requests always mask errors with a default reply, so
+       they stay on the full path (compile-time branch). */
+    if (LIKELY(
+            defaultRouteFastPath_ && !carbon::ArithmeticLike<Request>::value &&
+            rhPtr != nullptr && rhPtr->size() == 1)) {
+      return (*rhPtr)[0]->route(req);
+    }
+
     auto reply = UNLIKELY(rhPtr == nullptr)
         ? routeImpl(
               rhMap_.getTargetsForKeySlow(
@@ -88,6 +109,7 @@ class RootRoute {
  private:
   const McrouterOptions& opts_;
   RouteHandleMap<RouteHandleIf> rhMap_;
+  const bool defaultRouteFastPath_;
 
   template <class Request>
   ReplyT<Request> routeImpl(
@@ -11,6 +11,7 @@
 #include <unordered_set>
 #include <utility>
 
+#include "mcrouter/lib/fbi/cpp/Trie.h"
 #include "mcrouter/routes/PrefixSelectorRoute.h"
 
 namespace facebook {
@@ -71,25 +72,53 @@ RoutePolicyMap<RouteHandleIf>::RoutePolicyMap(
     }
   }
 
-  ut_.emplace("", std::move(wildcards));
+  // Trie with targets for each key prefix, used only during construction.
+  Trie<std::vector<std::shared_ptr<RouteHandleIf>>> ut;
+  ut.emplace("", std::move(wildcards));
   // we iterate over keys in lexicographic order, so all prefixes of key will go
   // before key itself
   for (auto& it : t) {
-    auto existing = ut_.findPrefix(it.first);
+    auto existing = ut.findPrefix(it.first);
     // at least empty string should be there
-    assert(existing != ut_.end());
-    ut_.emplace(it.first, detail::overrideItems(existing->second, it.second));
+    assert(existing != ut.end());
+    ut.emplace(it.first, detail::overrideItems(existing->second, it.second));
   }
-  for (auto& it : ut_) {
-    it.second = detail::orderedUnique(it.second);
+  // Compile the Trie into a flat sorted array; Trie iteration is
+  // lexicographic, so the result is sorted by prefix.
+  for (auto& it : ut) {
+    flatMap_.emplace_back(it.first, detail::orderedUnique(it.second));
   }
+  flatMap_.shrink_to_fit();
 }
 
 template <class RouteHandleIf>
 const std::vector<std::shared_ptr<RouteHandleIf>>&
 RoutePolicyMap<RouteHandleIf>::getTargetsForKey(folly::StringPiece key) const {
-  auto result = ut_.findPrefix(key);
-  return result == ut_.end() ? emptyV_ : result->second;
+  auto comp = [](folly::StringPiece k, const auto& entry) {
+    return k < entry.first;
+  };
+  // Longest prefix match over the sorted prefix array.  Any prefix of key
+  // present in the array sorts at or before key, so start at the
+  // upper bound and move left; whenever the candidate is not a prefix of
+  // key, every prefix of key still to the left is also a prefix of the
+  // candidate, so truncating key to their common prefix is lossless and
+  // lets us skip the whole non-matching subrange with another search.
+  auto it = std::upper_bound(flatMap_.begin(), flatMap_.end(), key, comp);
+  while (it != flatMap_.begin()) {
+    --it;
+    folly::StringPiece prefix = it->first;
+    if (key.startsWith(prefix)) {
+      return it->second;
+    }
+    size_t common = 0;
+    size_t maxCommon = std::min(key.size(), prefix.size());
+    while (common < maxCommon && key[common] == prefix[common]) {
+      ++common;
+    }
+    key = key.subpiece(0, common);
+    it = std::upper_bound(flatMap_.begin(), it, key, comp);
+  }
+  return emptyV_;
 }
 }
 }
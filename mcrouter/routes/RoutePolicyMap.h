@@ -8,12 +8,12 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <folly/Range.h>
 
-#include "mcrouter/lib/fbi/cpp/Trie.h"
-
 namespace facebook {
 namespace memcache {
 namespace mcrouter {
@@ -42,7 +42,8 @@ class PrefixSelectorRoute;
  *    order as in clusters vector passed to constructor. So local clusters
  *    should be at the beggining of vector.
  * 2) use getTargetsForKey to get precalculated vector of targets.
- *    Complexity is O(min(longest key prefix in config, key length))
+ *    Complexity is O(log(number of key prefixes in config) *
+ *    longest key prefix in config)
  */
 template <class RouteHandleIf>
 class RoutePolicyMap {
@@ -61,12 +62,17 @@ class RoutePolicyMap {
  private:
   const std::vector<std::shared_ptr<RouteHandleIf>> emptyV_;
   /**
-   * This Trie contains targets for each key prefix. It is built like this:
+   * Flat array of (key prefix, targets) sorted by prefix, compiled once at
+   * config time.  It is built like this:
    * 1) targets for empty string are wildcards.
    * 2) targets for string of length n+1 S[0..n] are targets for S[0..n-1] with
    *    OperationSelectorRoutes for key prefix == S[0..n] overridden.
+   * The request path does a binary-search longest-prefix-match over this
+   * array instead of chasing Trie node pointers.
    */
-  Trie<std::vector<std::shared_ptr<RouteHandleIf>>> ut_;
+  std::vector<
+      std::pair<std::string, std::vector<std::shared_ptr<RouteHandleIf>>>>
+      flatMap_;
 };
 }
 }
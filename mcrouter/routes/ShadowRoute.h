@@ -102,7 +102,7 @@ class ShadowRoute {
 
         if (!normalReply &&
             shadowPolicy_.template shouldDelayShadow<Request>()) {
-          normalReply = normal_->route(*adjustedNormalReq);
+          normalReply = normal_->route(normalRequest(req, adjustedNormalReq));
         }
 
         dispatchShadowRequest(
@@ -113,9 +113,8 @@ class ShadowRoute {
       }
     }
 
-    return normalReply
-        ? std::move(*normalReply)
-        : normal_->route(adjustedNormalReq ? *adjustedNormalReq : req);
+    return normalReply ? std::move(*normalReply)
+                       : normal_->route(normalRequest(req, adjustedNormalReq));
   }
 
  private:
@@ -123,6 +122,23 @@ class ShadowRoute {
   const ShadowData<RouterInfo> shadowData_;
   ShadowPolicy shadowPolicy_;
 
+  /**
+   * The request the normal path should route. Policies that don't adjust
+   * the normal request keep the caller's request here; the refcounted
+   * copy then exists purely to outlive this frame on the shadow fibers
+   * (the payload bytes of that copy are shared via IOBuf refcounting, so
+   * shadowing a large set copies the message skeleton, not the value).
+   */
+  template <class Request>
+  const Request& normalRequest(
+      const Request& req,
+      const std::shared_ptr<const Request>& adjustedNormalReq) const {
+    if (ShadowPolicy::kAdjustsNormalRequest && adjustedNormalReq) {
+      return *adjustedNormalReq;
+    }
+    return req;
+  }
+
   template <class Request>
   bool shouldShadow(const Request& req, ShadowSettings* settings) const {
     auto& ctx = fiber_local<RouterInfo>::getSharedCtx();
@@ -59,6 +59,12 @@ inline std::unordered_map<uint32_t, uint32_t> prepareMap(
     size_t /* maxShardId */) {
   return std::unordered_map<uint32_t, uint32_t>(numDistinctShards);
 }
+template <>
+inline EytzingerShardMap prepareMap(
+    size_t /* numDistinctShards */,
+    size_t /* maxShardId */) {
+  return EytzingerShardMap();
+}
 
 inline bool containsShard(const std::vector<uint16_t>& vec, size_t shard) {
   return vec.at(shard) != std::numeric_limits<uint16_t>::max();
@@ -68,6 +74,17 @@ inline bool containsShard(
     size_t shard) {
   return (map.find(shard) != map.end());
 }
+inline bool containsShard(const EytzingerShardMap& map, size_t shard) {
+  return map.contains(shard);
+}
+
+// The vector and hash maps are ready for lookups as built; the Eytzinger
+// map needs its layout pass once all shards are known.
+template <class MapType>
+void freezeMap(MapType& /* map */) {}
+inline void freezeMap(EytzingerShardMap& map) {
+  map.freeze();
+}
 
 template <class RouterInfo>
 const folly::dynamic& getPoolJson(
@@ -255,8 +272,10 @@ typename RouterInfo::RouteHandlePtr createShardSelectionRoute(
           destinations.size(),
           shardsJson.size()));
 
-  auto selector = ShardSelector(
-      detail::getShardsMap<MapType>(shardsJson, destinations.size()));
+  auto shardsMap =
+      detail::getShardsMap<MapType>(shardsJson, destinations.size());
+  detail::freezeMap(shardsMap);
+  auto selector = ShardSelector(std::move(shardsMap));
 
   typename RouterInfo::RouteHandlePtr outOfRangeDestination = nullptr;
   if (auto outOfRangeJson = json.get_ptr("out_of_range")) {
@@ -323,6 +342,7 @@ typename RouterInfo::RouteHandlePtr createEagerShardSelectionRoute(
         childrenType);
   }
 
+  detail::freezeMap(shardToDestinationIndexMap);
   ShardSelector selector(std::move(shardToDestinationIndexMap));
 
   typename RouterInfo::RouteHandlePtr outOfRangeDestination = nullptr;
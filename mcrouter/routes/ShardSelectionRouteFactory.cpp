@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <functional>
 
 #include <folly/Random.h>
 #include <folly/dynamic.h>
@@ -103,6 +104,35 @@ std::vector<size_t> parseShardsPerServerJson(const folly::dynamic& jShards) {
 
 } // namespace detail
 
+void EytzingerShardMap::freeze() {
+  std::vector<std::pair<uint32_t, uint32_t>> sorted(
+      staging_.begin(), staging_.end());
+  std::sort(sorted.begin(), sorted.end());
+
+  // 1-indexed layout; index 0 stays unused.
+  keys_.assign(sorted.size() + 1, 0);
+  values_.assign(sorted.size() + 1, kNoDestination);
+
+  // An in-order walk of the implicit tree visits the nodes in ascending
+  // key order, so pairing it with the sorted entries yields the
+  // Eytzinger permutation.
+  size_t pos = 0;
+  std::function<void(size_t)> fillInOrder = [&](size_t k) {
+    if (k >= keys_.size()) {
+      return;
+    }
+    fillInOrder(2 * k);
+    keys_[k] = sorted[pos].first;
+    values_[k] = sorted[pos].second;
+    ++pos;
+    fillInOrder(2 * k + 1);
+  };
+  fillInOrder(1);
+  assert(pos == sorted.size());
+
+  staging_ = std::unordered_map<uint32_t, uint32_t>();
+}
+
 } // namespace mcrouter
 } // namespace memcache
 } // namespace facebook
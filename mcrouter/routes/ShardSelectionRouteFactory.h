@@ -9,6 +9,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
 #include <folly/Range.h>
 #include <folly/dynamic.h>
@@ -20,6 +24,76 @@ namespace facebook {
 namespace memcache {
 namespace mcrouter {
 
+/**
+ * Shard id -> destination index map laid out for lookup speed.
+ *
+ * The two default map types trade memory against speed: the dense
+ * std::vector<uint16_t> is a single indexed load but is sized by the
+ * largest shard id, and std::unordered_map pays a hashed probe with a
+ * cache miss per bucket hop on every request. This map stores the sorted
+ * shard ids in Eytzinger (BFS) order, so a lookup is a short binary
+ * search whose working set is hottest at the top of the array and whose
+ * next candidates are prefetched ahead of the comparison; memory is 8
+ * bytes per distinct shard regardless of the id range. Intended for
+ * sparse id spaces with ~10^5 shards, where the dense vector is too big
+ * and the hash map too slow.
+ *
+ * The build protocol matches the other map types: fill via operator[]
+ * and containsShard() while the config is parsed, then freeze() once
+ * complete (createShardSelectionRoute does this via detail::freezeMap).
+ * lookup() may only be called on a frozen map.
+ */
+class EytzingerShardMap {
+ public:
+  static constexpr uint32_t kNoDestination =
+      std::numeric_limits<uint32_t>::max();
+
+  uint32_t& operator[](uint32_t shardId) {
+    assert(keys_.empty());
+    return staging_[shardId];
+  }
+
+  bool contains(uint32_t shardId) const {
+    return staging_.find(shardId) != staging_.end();
+  }
+
+  /**
+   * Moves the staged entries into the Eytzinger layout and frees the
+   * staging map. Called once, at the end of config parsing.
+   */
+  void freeze();
+
+  /**
+   * Returns the destination index serving shardId, or kNoDestination.
+   */
+  uint32_t lookup(uint32_t shardId) const {
+    assert(!keys_.empty());
+    const size_t n = keys_.size();
+    size_t k = 1;
+    size_t candidate = 0;
+    while (k < n) {
+      // Fetch the great-grandchildren level this probe may land on three
+      // iterations from now; they span at most two adjacent cachelines.
+      __builtin_prefetch(&keys_[std::min(8 * k, n - 1)]);
+      if (keys_[k] >= shardId) {
+        candidate = k;
+      }
+      k = 2 * k + (keys_[k] < shardId);
+    }
+    if (candidate != 0 && keys_[candidate] == shardId) {
+      return values_[candidate];
+    }
+    return kNoDestination;
+  }
+
+ private:
+  // Filled during config parsing, emptied by freeze().
+  std::unordered_map<uint32_t, uint32_t> staging_;
+  // 1-indexed (index 0 unused) so children of node k are 2k and 2k + 1.
+  std::vector<uint32_t> keys_;
+  std::vector<uint32_t> values_;
+};
+
 /**
  * Create a route handle for sharding requests to servers.
  *
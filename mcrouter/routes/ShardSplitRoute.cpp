@@ -7,20 +7,50 @@
  */
 #include "ShardSplitRoute.h"
 
+#include <array>
+#include <cstring>
+
 #include "mcrouter/lib/config/RouteHandleFactory.h"
 
 namespace facebook {
 namespace memcache {
 namespace mcrouter {
 
+namespace {
+
+/**
+ * Two-char suffixes for every split offset ShardSplitter can produce
+ * (splits are capped at 26 * 26 + 1, so offsets are 1..26*26), indexed
+ * by offset - 1. Precomputed once so the per-request path is a copy of
+ * two bytes instead of a div/mod pair.
+ */
+const std::array<std::array<char, 2>, 26 * 26>& splitSuffixTable() {
+  static const auto table = [] {
+    std::array<std::array<char, 2>, 26 * 26> t;
+    for (size_t i = 0; i < t.size(); ++i) {
+      t[i] = {{static_cast<char>('a' + i % 26),
+               static_cast<char>('a' + i / 26)}};
+    }
+    return t;
+  }();
+  return table;
+}
+
+} // anonymous namespace
+
 std::string shardSplitSuffix(size_t offset) {
   if (!offset) {
     return "";
   }
 
   std::string ret;
-  ret.push_back('a' + ((offset - 1) % 26));
-  ret.push_back('a' + ((offset - 1) / 26));
+  if (offset - 1 < splitSuffixTable().size()) {
+    const auto& suffix = splitSuffixTable()[offset - 1];
+    ret.assign(suffix.data(), suffix.size());
+  } else {
+    ret.push_back('a' + ((offset - 1) % 26));
+    ret.push_back('a' + ((offset - 1) / 26));
+  }
   return ret;
 }
 
@@ -35,14 +65,37 @@ std::string createSplitKey(
   }
 
   std::string newKey;
-  newKey.reserve(fullKey.size() + 2);
-  newKey.append(fullKey.begin(), shard.end());
-  newKey.push_back('a' + ((offset - 1) % 26));
-  newKey.push_back('a' + ((offset - 1) / 26));
-  newKey.append(shard.end(), fullKey.end());
+  newKey.resize(fullKey.size() + 2);
+  newKey.resize(writeSplitKey(&newKey[0], fullKey, offset, shard));
   return newKey;
 }
 
+size_t writeSplitKey(
+    char* buf,
+    folly::StringPiece fullKey,
+    size_t offset,
+    folly::StringPiece shard) {
+  if (!offset) {
+    std::memcpy(buf, fullKey.begin(), fullKey.size());
+    return fullKey.size();
+  }
+
+  char* p = buf;
+  std::memcpy(p, fullKey.begin(), shard.end() - fullKey.begin());
+  p += shard.end() - fullKey.begin();
+  if (offset - 1 < splitSuffixTable().size()) {
+    const auto& suffix = splitSuffixTable()[offset - 1];
+    *p++ = suffix[0];
+    *p++ = suffix[1];
+  } else {
+    *p++ = 'a' + ((offset - 1) % 26);
+    *p++ = 'a' + ((offset - 1) / 26);
+  }
+  std::memcpy(p, shard.end(), fullKey.end() - shard.end());
+  p += fullKey.end() - shard.end();
+  return p - buf;
+}
+
 } // detail
 
 } // mcrouter
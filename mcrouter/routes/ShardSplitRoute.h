@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <cassert>
 #include <memory>
 #include <string>
 #include <vector>
@@ -23,6 +24,7 @@
 #include "mcrouter/lib/carbon/RoutingGroups.h"
 #include "mcrouter/lib/fbi/cpp/globals.h"
 #include "mcrouter/lib/fbi/cpp/util.h"
+#include "mcrouter/lib/mc/protocol.h"
 #include "mcrouter/routes/McRouteHandleBuilder.h"
 #include "mcrouter/routes/ShardSplitter.h"
 
@@ -64,6 +66,19 @@ std::string createSplitKey(
     folly::StringPiece fullKey,
     size_t offset,
     folly::StringPiece shard);
+
+/**
+ * Same as createSplitKey(), but writes the split key into a caller
+ * provided buffer instead of allocating a string. 'buf' must have room
+ * for fullKey.size() + 2 bytes.
+ *
+ * @return The length of the split key written to 'buf'.
+ */
+size_t writeSplitKey(
+    char* buf,
+    folly::StringPiece fullKey,
+    size_t offset,
+    folly::StringPiece shard);
 } // detail
 
 /**
@@ -81,8 +96,10 @@ class ShardSplitRoute {
 
   ShardSplitRoute(
       std::shared_ptr<RouteHandleIf> rh,
-      ShardSplitter shardSplitter)
-      : rh_(std::move(rh)), shardSplitter_(std::move(shardSplitter)) {}
+      std::shared_ptr<const ShardSplitter> shardSplitter)
+      : rh_(std::move(rh)), shardSplitter_(std::move(shardSplitter)) {
+    assert(shardSplitter_ != nullptr);
+  }
 
   template <class Request>
   void traverse(
@@ -90,11 +107,11 @@ class ShardSplitRoute {
       const RouteHandleTraverser<RouteHandleIf>& t) const {
     auto* ctx = fiber_local<RouterInfo>::getTraverseCtx();
     if (ctx) {
-      ctx->recordShardSplitter(shardSplitter_);
+      ctx->recordShardSplitter(*shardSplitter_);
     }
 
     folly::StringPiece shard;
-    auto split = shardSplitter_.getShardSplit(req.key().routingKey(), shard);
+    auto split = shardSplitter_->getShardSplit(req.key().routingKey(), shard);
 
     if (split == nullptr) {
       t(*rh_, req);
@@ -124,7 +141,7 @@ class ShardSplitRoute {
   template <class Request>
   ReplyT<Request> route(const Request& req) const {
     folly::StringPiece shard;
-    auto split = shardSplitter_.getShardSplit(req.key().routingKey(), shard);
+    auto split = shardSplitter_->getShardSplit(req.key().routingKey(), shard);
     if (split == nullptr) {
       return rh_->route(req);
     }
@@ -151,7 +168,9 @@ class ShardSplitRoute {
 
  private:
   std::shared_ptr<RouteHandleIf> rh_;
-  const ShardSplitter shardSplitter_;
+  // Shared across proxy threads through the router instance's
+  // shardSplitterCache(); the splitter is immutable once built.
+  const std::shared_ptr<const ShardSplitter> shardSplitter_;
 
   // from request with key 'prefix:shard:suffix' creates a copy of
   // request with key 'prefix:shardXY:suffix'
@@ -159,7 +178,16 @@ class ShardSplitRoute {
   Request splitReq(const Request& req, size_t offset, folly::StringPiece shard)
       const {
     auto reqCopy = req;
-    reqCopy.key() = detail::createSplitKey(req.key().fullKey(), offset, shard);
+    auto fullKey = req.key().fullKey();
+    // Build the split key on the stack: this saves the intermediate
+    // string allocation of createSplitKey() on every split request.
+    char buf[MC_KEY_MAX_LEN + 2];
+    if (fullKey.size() + 2 <= sizeof(buf)) {
+      auto len = detail::writeSplitKey(buf, fullKey, offset, shard);
+      reqCopy.key() = folly::StringPiece(buf, len);
+    } else {
+      reqCopy.key() = detail::createSplitKey(fullKey, offset, shard);
+    }
     return reqCopy;
   }
 };
@@ -167,7 +195,7 @@ class ShardSplitRoute {
 template <class RouterInfo>
 std::shared_ptr<typename RouterInfo::RouteHandleIf> makeShardSplitRoute(
     std::shared_ptr<typename RouterInfo::RouteHandleIf> rh,
-    ShardSplitter shardSplitter) {
+    std::shared_ptr<const ShardSplitter> shardSplitter) {
   return makeRouteHandleWithInfo<RouterInfo, ShardSplitRoute>(
       std::move(rh), std::move(shardSplitter));
 }
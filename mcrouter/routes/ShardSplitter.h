@@ -6,6 +6,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <chrono>
 
 #include <folly/Range.h>
@@ -44,6 +45,14 @@ class ShardSplitter {
           fanoutDeletes_(fanoutDeletes),
           migrating_(true) {}
 
+    ShardSplitInfo(const ShardSplitInfo& other)
+        : oldSplitSize_(other.oldSplitSize_),
+          newSplitSize_(other.newSplitSize_),
+          startTime_(other.startTime_),
+          migrationPeriod_(other.migrationPeriod_),
+          fanoutDeletes_(other.fanoutDeletes_),
+          migrating_(other.migrating_.load()) {}
+
     bool fanoutDeletesEnabled() const {
       return fanoutDeletes_;
     }
@@ -65,7 +74,9 @@ class ShardSplitter {
     const std::chrono::system_clock::time_point startTime_;
     const std::chrono::duration<double> migrationPeriod_;
     const bool fanoutDeletes_;
-    mutable bool migrating_;
+    // Latches to false once the migration period has passed. Atomic
+    // because a ShardSplitter may be shared across proxy threads.
+    mutable std::atomic<bool> migrating_;
   };
 
   explicit ShardSplitter(
@@ -97,6 +108,19 @@ class ShardSplitter {
     return shardSplits_;
   }
 
+  /**
+   * @return true if no shard is ever split, i.e. there are no per-shard
+   *         entries and the default split is the identity.  A splitter
+   *         for which this holds routes every request unchanged, so the
+   *         caller can skip installing ShardSplitRoute altogether.
+   */
+  bool noSplits() const {
+    return shardSplits_.empty() &&
+        !defaultShardSplit_.hasMigrationConfigured() &&
+        defaultShardSplit_.getOldSplitSize() == 1 &&
+        defaultShardSplit_.getNewSplitSize() == 1;
+  }
+
  private:
   ShardSplitInfoMap shardSplits_;
   ShardSplitInfo defaultShardSplit_;
@@ -7,8 +7,11 @@
  */
 #pragma once
 
+#include <limits>
 #include <string>
 
+#include <folly/Likely.h>
+#include <folly/Random.h>
 #include <folly/dynamic.h>
 
 #include "mcrouter/McrouterFiberContext.h"
@@ -58,6 +61,8 @@ namespace mcrouter {
  * "min_requests": Minimum number of requests necessary to start calculating
  *                 the hit rate. Before that number is reached, the destination
  *                 is considered "warm".
+ * "update_interval": Number of hit/miss replies between recomputations of the
+ *                    warmup state and send probability (default 64).
  *
  * To summarize, if a server is being warmed up, the percentage of requests to
  * send to server is calculated by the formula:
@@ -92,8 +97,11 @@ class SlowWarmUpRoute {
   template <class Request>
   ReplyT<Request> route(const Request& req, carbon::GetLikeT<Request> = 0)
       const {
-    auto& proxy = fiber_local<RouterInfo>::getSharedCtx()->proxy();
-    if (warmingUp() && !shouldSendRequest(proxy.randomGenerator())) {
+    // The gate is a single integer compare against a threshold that's
+    // recomputed every updateInterval() counted replies (refreshGate);
+    // warm destinations see only the kAlwaysSend check.
+    if (UNLIKELY(stats_.sendThreshold != kAlwaysSend) &&
+        nextRandom() > stats_.sendThreshold) {
       return fiber_local<RouterInfo>::runWithLocals([this, &req]() {
         fiber_local<RouterInfo>::addRequestClass(RequestClass::kFailover);
         return failoverTarget_->route(req);
@@ -117,14 +125,29 @@ class SlowWarmUpRoute {
       ++stats_.hits;
     } else if (isMissResult(reply.result())) {
       ++stats_.misses;
+    } else {
+      return std::move(reply);
+    }
+    if (UNLIKELY(--stats_.refreshIn == 0)) {
+      refreshGate();
     }
     return std::move(reply);
   }
 
  private:
+  /// sendThreshold value meaning "not warming up, always send".
+  static constexpr uint64_t kAlwaysSend =
+      std::numeric_limits<uint64_t>::max();
+
   struct WarmUpStats {
     uint64_t hits{0};
     uint64_t misses{0};
+    // Probability of sending to the cold target, scaled to 2^64 so the
+    // per-request gate is one compare against a random draw.
+    uint64_t sendThreshold{kAlwaysSend};
+    // Counted replies until the next refreshGate() call. Starts at 1 so
+    // the first counted reply computes the real state.
+    uint64_t refreshIn{1};
     bool enabled{false};
   };
 
@@ -133,13 +156,33 @@ class SlowWarmUpRoute {
   const std::shared_ptr<SlowWarmUpRouteSettings> settings_;
   mutable WarmUpStats stats_;
 
-  bool warmingUp() const {
+  /**
+   * Recomputes the warmup state and the integer sampling gate from the
+   * current hit rate. Runs once every updateInterval() counted replies,
+   * keeping all floating point math off the per-request path.
+   */
+  void refreshGate() const {
+    stats_.refreshIn = settings_->updateInterval();
+    const double rate = hitRate();
     if (stats_.enabled) {
-      stats_.enabled = hitRate() < settings_->disableThreshold();
+      stats_.enabled = rate < settings_->disableThreshold();
+    } else {
+      stats_.enabled = rate < settings_->enableThreshold();
+    }
+    if (!stats_.enabled) {
+      stats_.sendThreshold = kAlwaysSend;
+      return;
+    }
+    const double target = settings_->start() + (rate * settings_->step());
+    if (target >= 1.0) {
+      stats_.sendThreshold = kAlwaysSend;
+    } else if (target <= 0.0) {
+      stats_.sendThreshold = 0;
     } else {
-      stats_.enabled = hitRate() < settings_->enableThreshold();
+      // target < 1.0, so the product is below 2^64 and the cast is safe.
+      stats_.sendThreshold =
+          static_cast<uint64_t>(target * 18446744073709551616.0 /* 2^64 */);
     }
-    return stats_.enabled;
   }
 
   double hitRate() const {
@@ -150,11 +193,17 @@ class SlowWarmUpRoute {
     return stats_.hits / static_cast<double>(total);
   }
 
-  template <class RNG>
-  bool shouldSendRequest(RNG& rng) const {
-    double target = settings_->start() + (hitRate() * settings_->step());
-    return std::generate_canonical<double, std::numeric_limits<double>::digits>(
-               rng) <= target;
+  /**
+   * Cheap per-thread xorshift64* draw; plenty of quality for a sampling
+   * gate and much cheaper than generate_canonical on the shared
+   * mt19937.
+   */
+  static uint64_t nextRandom() {
+    static thread_local uint64_t state = folly::Random::rand64() | 1;
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ull;
   }
 };
 
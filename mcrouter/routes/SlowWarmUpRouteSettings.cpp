@@ -82,6 +82,20 @@ SlowWarmUpRouteSettings::SlowWarmUpRouteSettings(const folly::dynamic& json) {
         "SlowWarmUpSettings: '{}' must be an integer greater than 0",
         minReqsName);
   }
+
+  const std::string updateIntervalName = "update_interval";
+  if (auto updateIntervalPtr = json.get_ptr(updateIntervalName)) {
+    checkLogic(
+        updateIntervalPtr->isInt(),
+        "SlowWarmUpSettings: '{}' must be an integer, but was {}",
+        updateIntervalName,
+        updateIntervalPtr->typeName());
+    updateInterval_ = updateIntervalPtr->getInt();
+    checkLogic(
+        updateInterval_ > 0,
+        "SlowWarmUpSettings: '{}' must be an integer greater than 0",
+        updateIntervalName);
+  }
 }
 }
 }
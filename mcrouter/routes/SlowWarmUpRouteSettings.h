@@ -53,6 +53,10 @@ class SlowWarmUpRouteSettings {
     return minRequests_;
   }
 
+  size_t updateInterval() const {
+    return updateInterval_;
+  }
+
  private:
   // Threshold to start warming up.
   double enableThreshold_{0.7};
@@ -66,6 +70,10 @@ class SlowWarmUpRouteSettings {
 
   // Mininum number of requests to start computing hit rate.
   size_t minRequests_{100};
+
+  // Number of counted replies between recomputations of the warmup
+  // state and sampling gate (see SlowWarmUpRoute::refreshGate).
+  size_t updateInterval_{64};
 };
 }
 }
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <folly/Optional.h>
+#include <folly/ScopeGuard.h>
 #include <folly/fibers/AddTasks.h>
 #include <folly/fibers/FiberManager.h>
 #include <folly/fibers/ForEach.h>
@@ -26,6 +27,17 @@ namespace facebook {
 namespace memcache {
 namespace mcrouter {
 
+namespace detail {
+
+/**
+ * Staging population is best effort: if the staging side is slow enough
+ * that this many detached operations accumulate, new ones are dropped
+ * instead of growing the proxy's fiber count without bound.
+ */
+constexpr size_t kMaxPendingStagingOps = 1024;
+
+} // detail
+
 /**
  * This route handle is similar to WarmUpRoute that will allow a new pool to be
  * staged before moving into production. The difference in this route is that
@@ -109,7 +121,7 @@ class StagingRoute {
     auto reply = warm_->route(req);
 
     if (isHitResult(reply.result())) {
-      folly::fibers::addTask([req, reply, warm = warm_, staging = staging_]() {
+      addStagingTask([req, reply, warm = warm_, staging = staging_]() {
         McMetagetRequest reqMetaget(req.key().fullKey());
         auto metaReply = staging->route(reqMetaget);
         if (metaReply.result() != mc_res_busy &&
@@ -148,8 +160,8 @@ class StagingRoute {
 
     // route a metaget to staging side if we have a hit
     if (isHitResult(reply.result())) {
-      folly::fibers::addTask([staging = staging_,
-                              metaReq = McMetagetRequest(req.key().fullKey())] {
+      addStagingTask([staging = staging_,
+                      metaReq = McMetagetRequest(req.key().fullKey())] {
         staging->route(metaReq);
       });
     }
@@ -176,9 +188,9 @@ class StagingRoute {
     // set the data to the staging side as a normal set
     int32_t exptime = req.exptime();
     if (isStoredResult(reply.result())) {
-      folly::fibers::addTask([staging = staging_,
-                              setReq = createRequestFromReply<McSetRequest>(
-                                  req.key().fullKey(), reply, exptime)]() {
+      addStagingTask([staging = staging_,
+                      setReq = createRequestFromReply<McSetRequest>(
+                          req.key().fullKey(), reply, exptime)]() {
         staging->route(setReq);
       });
     }
@@ -240,7 +252,7 @@ class StagingRoute {
   route(const Request& req) const {
     auto reply = warm_->route(req);
     if (!isErrorResult(reply.result())) {
-      folly::fibers::addTask(
+      addStagingTask(
           [staging = staging_, asyncReq = req]() { staging->route(asyncReq); });
     }
 
@@ -248,9 +260,34 @@ class StagingRoute {
   }
 
  private:
+  // Runs fn on a detached fiber if the staging operation budget allows,
+  // and silently drops it otherwise. Staging traffic never sits on the
+  // main request's critical path, and bounding the number of in-flight
+  // detached operations keeps a slow staging side from piling up fibers.
+  template <class F>
+  void addStagingTask(F&& fn) const {
+    if (*pendingStagingOps_ >= detail::kMaxPendingStagingOps) {
+      return;
+    }
+    ++*pendingStagingOps_;
+    folly::fibers::addTask(
+        [pending = pendingStagingOps_, fn = std::forward<F>(fn)]() {
+          SCOPE_EXIT {
+            --*pending;
+          };
+          fn();
+        });
+  }
+
   // route configuration
   const std::shared_ptr<MemcacheRouteHandleIf> warm_;
   const std::shared_ptr<MemcacheRouteHandleIf> staging_;
+
+  // In-flight detached staging operations. Shared with the detached
+  // fibers, which may outlive this route across a reconfiguration. All
+  // access is confined to the owning proxy thread.
+  const std::shared_ptr<size_t> pendingStagingOps_{
+      std::make_shared<size_t>(0)};
 };
 
 McrouterRouteHandlePtr makeStagingRoute(
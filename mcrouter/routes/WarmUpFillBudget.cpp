@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "WarmUpFillBudget.h"
+
+#include <folly/dynamic.h>
+
+#include "mcrouter/lib/fbi/cpp/util.h"
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+namespace {
+
+uint64_t getPositiveInt(
+    const folly::dynamic& json,
+    const char* name,
+    uint64_t def) {
+  auto valJson = json.get_ptr(name);
+  if (valJson == nullptr) {
+    return def;
+  }
+  checkLogic(valJson->isInt(), "WarmUpFillBudget: {} is not an integer", name);
+  auto val = valJson->getInt();
+  checkLogic(val > 0, "WarmUpFillBudget: {} must be positive", name);
+  return val;
+}
+
+WarmUpFillBudget budgetFromJson(const folly::dynamic& json) {
+  checkLogic(json.isObject(), "WarmUpFillBudget: budget is not an object");
+
+  auto jRate = json.get_ptr("rate_bytes_per_sec");
+  checkLogic(jRate != nullptr, "WarmUpFillBudget: rate_bytes_per_sec not found");
+  checkLogic(
+      jRate->isInt() && jRate->getInt() > 0,
+      "WarmUpFillBudget: rate_bytes_per_sec must be a positive integer");
+  uint64_t rate = jRate->getInt();
+
+  /* default burst: one second worth of fill traffic */
+  uint64_t burst = getPositiveInt(json, "burst_bytes", rate);
+
+  double rampStart = 0.1;
+  if (auto jRamp = json.get_ptr("ramp_start")) {
+    checkLogic(
+        jRamp->isNumber(), "WarmUpFillBudget: ramp_start is not a number");
+    rampStart = jRamp->asDouble();
+    checkLogic(
+        rampStart > 0.0 && rampStart <= 1.0,
+        "WarmUpFillBudget: ramp_start must be in (0, 1] range");
+  }
+
+  size_t minSamples = getPositiveInt(json, "min_samples", 100);
+
+  return WarmUpFillBudget(rate, burst, rampStart, minSamples);
+}
+
+} // anonymous
+
+WarmUpFillBudget::WarmUpFillBudget(const folly::dynamic& json)
+    : WarmUpFillBudget(budgetFromJson(json)) {}
+}
+}
+} // facebook::memcache::mcrouter
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include <folly/TokenBucket.h>
+
+namespace folly {
+struct dynamic;
+} // folly
+
+namespace facebook {
+namespace memcache {
+namespace mcrouter {
+
+/**
+ * Token-bucket byte budget on warm -> cold fill traffic of WarmUpRoute.
+ *
+ * Unthrottled warm-up can saturate the warm cluster's egress while a cold
+ * cluster is brought up. The budget caps fill traffic at a configured
+ * bytes/sec rate and ramps that rate up as the cold side's hit rate grows:
+ * early on, when almost every request misses and would generate a fill,
+ * only a fraction of the budget is available; once the cold side serves
+ * most traffic itself, fills are rare and the full budget is safe.
+ *
+ * Fills are dropped, never delayed: a dropped fill just means the key stays
+ * cold until a later request. Since consume() is all-or-nothing, large
+ * values are the first to be dropped when the bucket runs low, which keeps
+ * small keys warming up while limiting egress.
+ *
+ * Not thread-safe; intended to be owned by a single route handle.
+ */
+class WarmUpFillBudget {
+ public:
+  /**
+   * @param rateBytesPerSec    Maximum fill rate once fully ramped up.
+   * @param burstBytes         Bucket capacity; also bounds the largest
+   *                           single value that can ever be filled.
+   * @param rampStartFraction  Fraction of the rate available at 0% cold
+   *                           hit rate (and before minSamples replies).
+   * @param minSamples         Number of cold replies to observe before
+   *                           computing the hit rate.
+   */
+  WarmUpFillBudget(
+      uint64_t rateBytesPerSec,
+      uint64_t burstBytes,
+      double rampStartFraction,
+      size_t minSamples)
+      : rateBytesPerSec_(rateBytesPerSec),
+        burstBytes_(burstBytes),
+        rampStart_(rampStartFraction),
+        minSamples_(minSamples) {}
+
+  /**
+   * @param json  Budget configuration; must be an object. Format:
+   *                {
+   *                  "rate_bytes_per_sec": [1..INF],
+   *                  "burst_bytes": [1..INF],       // default: 1s of rate
+   *                  "ramp_start": (0..1],          // default: 0.1
+   *                  "min_samples": [1..INF]        // default: 100
+   *                }
+   */
+  explicit WarmUpFillBudget(const folly::dynamic& json);
+
+  /**
+   * Checks a fill of the given size against the budget and consumes it.
+   *
+   * @return true  if the fill fits into the budget and should be sent,
+   *               false if it should be dropped.
+   */
+  bool allowFill(size_t valueBytes) {
+    return bucket_.consume(valueBytes, rateBytesPerSec_ * rampFraction(),
+        burstBytes_);
+  }
+
+  /**
+   * Records the outcome of a get-family request on the cold side,
+   * feeding the hit rate that drives the ramp.
+   */
+  void noteColdReply(bool hit) {
+    ++coldRequests_;
+    if (hit) {
+      ++coldHits_;
+    }
+    if (coldRequests_ >= kDecayWindow) {
+      /* Decay so the hit rate tracks recent traffic */
+      coldRequests_ /= 2;
+      coldHits_ /= 2;
+    }
+  }
+
+ private:
+  static constexpr size_t kDecayWindow = 10000;
+
+  const double rateBytesPerSec_;
+  const double burstBytes_;
+  const double rampStart_;
+  const size_t minSamples_;
+
+  folly::DynamicTokenBucket bucket_;
+  size_t coldRequests_{0};
+  size_t coldHits_{0};
+
+  double rampFraction() const {
+    if (coldRequests_ < minSamples_) {
+      return rampStart_;
+    }
+    double hitRate = static_cast<double>(coldHits_) / coldRequests_;
+    return rampStart_ + (1.0 - rampStart_) * hitRate;
+  }
+};
+}
+}
+} // facebook::memcache::mcrouter
@@ -21,9 +21,13 @@ namespace mcrouter {
 McrouterRouteHandlePtr makeWarmUpRoute(
     McrouterRouteHandlePtr warm,
     McrouterRouteHandlePtr cold,
-    folly::Optional<uint32_t> exptime) {
+    folly::Optional<uint32_t> exptime,
+    std::unique_ptr<WarmUpFillBudget> fillBudget = nullptr) {
   return makeMcrouterRouteHandle<WarmUpRoute>(
-      std::move(warm), std::move(cold), std::move(exptime));
+      std::move(warm),
+      std::move(cold),
+      std::move(exptime),
+      std::move(fillBudget));
 }
 
 McrouterRouteHandlePtr makeWarmUpRoute(
@@ -46,11 +50,16 @@ McrouterRouteHandlePtr makeWarmUpRoute(
   } else if (!enableMetaget) {
     exptime = 0;
   }
+  std::unique_ptr<WarmUpFillBudget> fillBudget;
+  if (auto jfillBudget = json.get_ptr("fill_budget")) {
+    fillBudget = std::make_unique<WarmUpFillBudget>(*jfillBudget);
+  }
 
   return makeWarmUpRoute(
       factory.create(json["warm"]),
       factory.create(json["cold"]),
-      std::move(exptime));
+      std::move(exptime),
+      std::move(fillBudget));
 }
 }
 }
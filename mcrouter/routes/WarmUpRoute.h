@@ -21,6 +21,7 @@
 #include "mcrouter/lib/mc/msg.h"
 #include "mcrouter/lib/network/gen/Memcache.h"
 #include "mcrouter/routes/RoutingUtils.h"
+#include "mcrouter/routes/WarmUpFillBudget.h"
 
 namespace facebook {
 namespace memcache {
@@ -58,6 +59,11 @@ namespace mcrouter {
  * configured with "exptime" field. If the field is not present and
  * "enable_metaget" is true, exptime is fetched from "warm" on every update
  * operation with additional 'metaget' request.
+ *
+ * Warm -> cold fill traffic can be capped with an optional "fill_budget"
+ * field (see WarmUpFillBudget for the format). Fills exceeding the budget
+ * are dropped, protecting the warm cluster's egress while the cold side
+ * has a low hit rate; without the field fills are unlimited.
  */
 template <class RouteHandleIf>
 class WarmUpRoute {
@@ -77,10 +83,12 @@ class WarmUpRoute {
   WarmUpRoute(
       std::shared_ptr<RouteHandleIf> warm,
       std::shared_ptr<RouteHandleIf> cold,
-      folly::Optional<uint32_t> exptime)
+      folly::Optional<uint32_t> exptime,
+      std::unique_ptr<WarmUpFillBudget> fillBudget = nullptr)
       : warm_(std::move(warm)),
         cold_(std::move(cold)),
-        exptime_(std::move(exptime)) {
+        exptime_(std::move(exptime)),
+        fillBudget_(std::move(fillBudget)) {
     assert(warm_ != nullptr);
     assert(cold_ != nullptr);
   }
@@ -88,6 +96,7 @@ class WarmUpRoute {
   //////////////////////////////// get /////////////////////////////////////
   McGetReply route(const McGetRequest& req) {
     auto coldReply = cold_->route(req);
+    noteColdReply(coldReply);
     if (isHitResult(coldReply.result())) {
       return coldReply;
     }
@@ -95,7 +104,8 @@ class WarmUpRoute {
     /* else */
     auto warmReply = warm_->route(req);
     uint32_t exptime = 0;
-    if (isHitResult(warmReply.result()) && getExptimeForCold(req, exptime)) {
+    if (isHitResult(warmReply.result()) && fillAllowed(warmReply) &&
+        getExptimeForCold(req, exptime)) {
       folly::fibers::addTask([cold = cold_,
                               addReq = createRequestFromReply<McAddRequest>(
                                   req.key().fullKey(), warmReply, exptime)]() {
@@ -117,6 +127,7 @@ class WarmUpRoute {
   /////////////////////////////lease_get//////////////////////////////////
   McLeaseGetReply route(const McLeaseGetRequest& req) {
     auto coldReply = cold_->route(req);
+    noteColdReply(coldReply);
     if (isHitResult(coldReply.result()) ||
         isHotMissResult(coldReply.result())) {
       // in case of a hot miss somebody else will set the value
@@ -127,7 +138,7 @@ class WarmUpRoute {
     McGetRequest reqOpGet(req.key().fullKey());
     auto warmReply = warm_->route(reqOpGet);
     uint32_t exptime = 0;
-    if (isHitResult(warmReply.result()) &&
+    if (isHitResult(warmReply.result()) && fillAllowed(warmReply) &&
         getExptimeForCold(reqOpGet, exptime)) {
       // update cold route with lease set
       auto setReq = createRequestFromReply<McLeaseSetRequest>(
@@ -148,6 +159,7 @@ class WarmUpRoute {
   ////////////////////////////////gets////////////////////////////////////
   McGetsReply route(const McGetsRequest& req) {
     auto coldReply = cold_->route(req);
+    noteColdReply(coldReply);
     if (isHitResult(coldReply.result())) {
       return coldReply;
     }
@@ -156,7 +168,8 @@ class WarmUpRoute {
     McGetRequest reqGet(req.key().fullKey());
     auto warmReply = warm_->route(reqGet);
     uint32_t exptime = 0;
-    if (isHitResult(warmReply.result()) && getExptimeForCold(req, exptime)) {
+    if (isHitResult(warmReply.result()) && fillAllowed(warmReply) &&
+        getExptimeForCold(req, exptime)) {
       // update cold route if we have the value
       auto addReq = createRequestFromReply<McAddRequest>(
           req.key().fullKey(), warmReply, exptime);
@@ -170,6 +183,7 @@ class WarmUpRoute {
   //////////////////////////////// gat /////////////////////////////////////
   McGatReply route(const McGatRequest& req) {
     auto coldReply = cold_->route(req);
+    noteColdReply(coldReply);
     if (isHitResult(coldReply.result())) {
       return coldReply;
     }
@@ -177,7 +191,7 @@ class WarmUpRoute {
     // miss: send simple get to warm route
     McGetRequest reqGet(req.key().fullKey());
     auto warmReply = warm_->route(reqGet);
-    if (isHitResult(warmReply.result())) {
+    if (isHitResult(warmReply.result()) && fillAllowed(warmReply)) {
       // update cold route if we have the value
       auto addReq = createRequestFromReply<McAddRequest>(
           req.key().fullKey(), warmReply, req.exptime());
@@ -190,6 +204,7 @@ class WarmUpRoute {
   ////////////////////////////////gats////////////////////////////////////
   McGatsReply route(const McGatsRequest& req) {
     auto coldReply = cold_->route(req);
+    noteColdReply(coldReply);
     if (isHitResult(coldReply.result())) {
       return coldReply;
     }
@@ -197,7 +212,7 @@ class WarmUpRoute {
     // miss: send simple get to warm route
     McGetRequest reqGet(req.key().fullKey());
     auto warmReply = warm_->route(reqGet);
-    if (isHitResult(warmReply.result())) {
+    if (isHitResult(warmReply.result()) && fillAllowed(warmReply)) {
       // update cold route if we have the value
       auto addReq = createRequestFromReply<McAddRequest>(
           req.key().fullKey(), warmReply, req.exptime());
@@ -219,6 +234,24 @@ class WarmUpRoute {
   const std::shared_ptr<RouteHandleIf> warm_;
   const std::shared_ptr<RouteHandleIf> cold_;
   const folly::Optional<uint32_t> exptime_;
+  const std::unique_ptr<WarmUpFillBudget> fillBudget_;
+
+  template <class Reply>
+  void noteColdReply(const Reply& coldReply) {
+    if (fillBudget_) {
+      fillBudget_->noteColdReply(isHitResult(coldReply.result()));
+    }
+  }
+
+  template <class Reply>
+  bool fillAllowed(const Reply& warmReply) {
+    if (!fillBudget_) {
+      return true;
+    }
+    const auto* value = carbon::valuePtrUnsafe(warmReply);
+    return fillBudget_->allowFill(
+        value != nullptr ? value->computeChainDataLength() : 0);
+  }
 
   template <class Request>
   bool getExptimeForCold(const Request& req, uint32_t& exptime) {
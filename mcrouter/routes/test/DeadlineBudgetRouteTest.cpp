@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "mcrouter/lib/network/gen/Memcache.h"
+#include "mcrouter/routes/DeadlineBudgetRoute.h"
+#include "mcrouter/routes/McrouterRouteHandle.h"
+#include "mcrouter/routes/test/RouteHandleTestUtil.h"
+
+using namespace facebook::memcache;
+using namespace facebook::memcache::mcrouter;
+
+namespace {
+
+using FiberManagerContextTag =
+    typename fiber_local<McrouterRouterInfo>::ContextTypeTag;
+
+/**
+ * Records the fiber-local deadline seen below the route under test.
+ */
+class CaptureDeadlineRoute {
+ public:
+  explicit CaptureDeadlineRoute(int64_t& capturedUs)
+      : capturedUs_(capturedUs) {}
+
+  std::string routeName() const {
+    return "capture-deadline";
+  }
+
+  template <class Request>
+  void traverse(
+      const Request&,
+      const RouteHandleTraverser<McrouterRouteHandleIf>&) const {}
+
+  template <class Request>
+  ReplyT<Request> route(const Request&) const {
+    capturedUs_ = fiber_local<McrouterRouterInfo>::getDeadlineUs();
+    return ReplyT<Request>(mc_res_found);
+  }
+
+ private:
+  int64_t& capturedUs_;
+};
+
+} // anonymous
+
+TEST(deadlineBudgetRouteTest, setsDeadline) {
+  int64_t capturedUs = 0;
+  auto capture =
+      std::make_shared<McrouterRouteHandle<CaptureDeadlineRoute>>(capturedUs);
+  McrouterRouteHandle<DeadlineBudgetRoute<McrouterRouterInfo>> rh(
+      std::move(capture), /* budgetMs */ 50);
+
+  TestFiberManager fm{FiberManagerContextTag()};
+  fm.run([&] {
+    mockFiberContext();
+    auto reply = rh.route(McGetRequest("0"));
+    EXPECT_EQ(mc_res_found, reply.result());
+
+    const auto beforeUs = nowUs();
+    EXPECT_GT(capturedUs, 0);
+    EXPECT_LE(capturedUs, beforeUs + 50 * 1000);
+    // The deadline is scoped to the subtree; it must not leak out.
+    EXPECT_EQ(0, fiber_local<McrouterRouterInfo>::getDeadlineUs());
+  });
+}
+
+TEST(deadlineBudgetRouteTest, keepsTighterOuterDeadline) {
+  int64_t capturedUs = 0;
+  auto capture =
+      std::make_shared<McrouterRouteHandle<CaptureDeadlineRoute>>(capturedUs);
+  McrouterRouteHandle<DeadlineBudgetRoute<McrouterRouterInfo>> rh(
+      std::move(capture), /* budgetMs */ 50);
+
+  TestFiberManager fm{FiberManagerContextTag()};
+  fm.run([&] {
+    mockFiberContext();
+    const auto outerUs = nowUs() + 10 * 1000;
+    fiber_local<McrouterRouterInfo>::setDeadlineUs(outerUs);
+    rh.route(McGetRequest("0"));
+    EXPECT_EQ(outerUs, capturedUs);
+  });
+}
+
+TEST(deadlineBudgetRouteTest, tightensLooserOuterDeadline) {
+  int64_t capturedUs = 0;
+  auto capture =
+      std::make_shared<McrouterRouteHandle<CaptureDeadlineRoute>>(capturedUs);
+  McrouterRouteHandle<DeadlineBudgetRoute<McrouterRouterInfo>> rh(
+      std::move(capture), /* budgetMs */ 50);
+
+  TestFiberManager fm{FiberManagerContextTag()};
+  fm.run([&] {
+    mockFiberContext();
+    const auto outerUs = nowUs() + 500 * 1000;
+    fiber_local<McrouterRouterInfo>::setDeadlineUs(outerUs);
+    rh.route(McGetRequest("0"));
+    EXPECT_GT(capturedUs, 0);
+    EXPECT_LT(capturedUs, outerUs);
+    // The outer deadline is restored once the subtree returns.
+    EXPECT_EQ(outerUs, fiber_local<McrouterRouterInfo>::getDeadlineUs());
+  });
+}
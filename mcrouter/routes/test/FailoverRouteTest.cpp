@@ -5,7 +5,9 @@
  *  file in the root directory of this source tree.
  *
  */
+#include <chrono>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -29,13 +31,20 @@ namespace facebook {
 namespace memcache {
 namespace mcrouter {
 
+namespace {
+using FiberManagerContextTag =
+    typename fiber_local<MemcacheRouterInfo>::ContextTypeTag;
+} // anonymous
+
 McrouterRouteHandlePtr makeFailoverRouteInOrder(
     std::vector<McrouterRouteHandlePtr> rh,
     FailoverErrorsSettings failoverErrors,
     std::unique_ptr<FailoverRateLimiter> rateLimiter,
     bool failoverTagging,
     bool enableLeasePairing = false,
-    std::string name = "") {
+    std::string name = "",
+    bool parallelProbe = false,
+    uint32_t parallelProbeDelayUs = detail::kDefaultParallelProbeDelayUs) {
   return makeFailoverRouteInOrder<McrouterRouterInfo, FailoverRoute>(
       std::move(rh),
       std::move(failoverErrors),
@@ -43,7 +52,9 @@ McrouterRouteHandlePtr makeFailoverRouteInOrder(
       failoverTagging,
       enableLeasePairing,
       std::move(name),
-      nullptr);
+      nullptr,
+      parallelProbe,
+      parallelProbeDelayUs);
 }
 }
 }
@@ -533,3 +544,101 @@ TEST(failoverRouteTest, leastFailuresComplex) {
   auto reply7 = rh->route(McGetRequest("0"));
   EXPECT_EQ("c", carbon::valueRangeSlow(reply7).str());
 }
+
+TEST(failoverRouteTest, latencyAwareDemotesErroringPrimary) {
+  std::vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(GetRouteTestData(mc_res_timeout, "a")),
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "b")),
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "c"))};
+
+  mockFiberContext();
+  folly::dynamic json =
+      folly::dynamic::object("type", "LatencyAwarePolicy")("max_tries", 3);
+  auto rh = makeFailoverRouteLatencyAware<McrouterRouterInfo, FailoverRoute>(
+      get_route_handles(test_handles),
+      FailoverErrorsSettings(),
+      nullptr,
+      /* failoverTagging */ false,
+      /* enableLeasePairing */ false,
+      "route01",
+      json);
+
+  // Before any samples the order is config order: the erroring primary is
+  // tried first and the request fails over.
+  auto reply1 = rh->route(McGetRequest("0"));
+  EXPECT_EQ("b", carbon::valueRangeSlow(reply1).str());
+
+  // Feed the error EWMA, then cross the order recompute window.
+  for (int i = 0; i < 20; ++i) {
+    rh->route(McGetRequest("0"));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(110));
+
+  const auto primarySawKeys = test_handles[0]->saw_keys.size();
+  auto reply2 = rh->route(McGetRequest("0"));
+  EXPECT_EQ("b", carbon::valueRangeSlow(reply2).str());
+  // The demoted primary no longer sees the request at all.
+  EXPECT_EQ(primarySawKeys, test_handles[0]->saw_keys.size());
+}
+
+TEST(failoverRouteTest, parallelProbeSecondWins) {
+  std::vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(GetRouteTestData(mc_res_timeout, "a")),
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "b")),
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "c"))};
+
+  auto rh = makeFailoverRouteInOrder(
+      get_route_handles(test_handles),
+      FailoverErrorsSettings(),
+      nullptr,
+      /* failoverTagging */ false,
+      /* enableLeasePairing */ false,
+      "",
+      /* parallelProbe */ true,
+      /* parallelProbeDelayUs */ 0);
+
+  // The first failover child hangs, so the staggered probe should get
+  // the reply from the second one without waiting for the first.
+  test_handles[1]->pause();
+
+  std::string result;
+  TestFiberManager fm{FiberManagerContextTag()};
+  fm.run([&]() {
+    mockFiberContext();
+    auto reply = rh->route(McGetRequest("0"));
+    result = carbon::valueRangeSlow(reply).str();
+    test_handles[1]->unpause();
+  });
+
+  EXPECT_EQ("c", result);
+}
+
+TEST(failoverRouteTest, parallelProbeSkipsSecondIfFirstDone) {
+  std::vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(GetRouteTestData(mc_res_timeout, "a")),
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "b")),
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "c"))};
+
+  auto rh = makeFailoverRouteInOrder(
+      get_route_handles(test_handles),
+      FailoverErrorsSettings(),
+      nullptr,
+      /* failoverTagging */ false,
+      /* enableLeasePairing */ false,
+      "",
+      /* parallelProbe */ true,
+      /* parallelProbeDelayUs */ 0);
+
+  std::string result;
+  TestFiberManager fm{FiberManagerContextTag()};
+  fm.run([&]() {
+    mockFiberContext();
+    auto reply = rh->route(McGetRequest("0"));
+    result = carbon::valueRangeSlow(reply).str();
+  });
+
+  // The first failover child answered right away, so the probe never
+  // contacted the second one.
+  EXPECT_EQ("b", result);
+  EXPECT_TRUE(test_handles[2]->saw_keys.empty());
+}
@@ -7,6 +7,7 @@
  */
 #include <algorithm>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -258,6 +259,58 @@ TEST_F(KeySplitRouteTest, TestLongKey) {
   }
 }
 
+TEST_F(KeySplitRouteTest, LoadSpreadGet) {
+  constexpr size_t numReplicas = 10;
+  globals::HostidMock hostidMock(1);
+
+  auto th = std::make_shared<TestHandle>(GetRouteTestData(mc_res_found, "a"));
+  auto rh = std::make_shared<RouteHandle>(
+      RouteHandle(th->rh, numReplicas, false, true /* loadSpreadReads */));
+
+  // The same (key, host) must always read the same replica.
+  rh->route(McGetRequest("abc"));
+  rh->route(McGetRequest("abc"));
+  ASSERT_EQ(2, th->saw_keys.size());
+  EXPECT_EQ(th->saw_keys[0], th->saw_keys[1]);
+  th->saw_keys.clear();
+
+  // Distinct keys must spread across more than one replica.
+  for (size_t i = 0; i < 32; ++i) {
+    rh->route(McGetRequest(folly::to<std::string>("key", i)));
+  }
+  std::set<std::string> suffixes;
+  for (const auto& key : th->saw_keys) {
+    auto pos = key.find(kMemcacheReplicaSeparator.str());
+    suffixes.insert(pos == std::string::npos ? "0" : key.substr(pos));
+  }
+  EXPECT_GT(suffixes.size(), 1);
+}
+
+TEST_F(KeySplitRouteTest, LoadSpreadGetMissFallback) {
+  constexpr size_t numReplicas = 10;
+  globals::HostidMock hostidMock(0);
+
+  auto th =
+      std::make_shared<TestHandle>(GetRouteTestData(mc_res_notfound, ""));
+  auto rh = std::make_shared<RouteHandle>(
+      RouteHandle(th->rh, numReplicas, false, true /* loadSpreadReads */));
+
+  bool sawFallback = false;
+  for (size_t i = 0; i < 32 && !sawFallback; ++i) {
+    th->saw_keys.clear();
+    auto key = folly::to<std::string>("key", i);
+    rh->route(McGetRequest(key));
+    if (th->saw_keys.size() == 2) {
+      // The spread replica missed; the write replica (id 0 for this
+      // host, i.e. the unmodified key) must be retried.
+      EXPECT_NE(key, th->saw_keys[0]);
+      EXPECT_EQ(key, th->saw_keys[1]);
+      sawFallback = true;
+    }
+  }
+  EXPECT_TRUE(sawFallback);
+}
+
 } // namespace mcrouter
 } // namespace memcache
 } // namespace facebook
@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "mcrouter/lib/network/gen/Memcache.h"
+#include "mcrouter/lib/test/RouteHandleTestUtil.h"
+#include "mcrouter/lib/test/TestRouteHandle.h"
+#include "mcrouter/routes/MicroCacheRoute.h"
+
+using namespace facebook::memcache;
+using namespace facebook::memcache::mcrouter;
+
+using std::make_shared;
+using std::vector;
+
+using TestHandle = TestHandleImpl<TestRouteHandleIf>;
+
+TEST(microCacheRouteTest, servesHitsFromCache) {
+  vector<std::shared_ptr<TestHandle>> test_handles{make_shared<TestHandle>(
+      GetRouteTestData(mc_res_found, "a", /* flags */ 42))};
+
+  TestRouteHandle<MicroCacheRoute<TestRouterInfo>> rh(
+      get_route_handles(test_handles)[0],
+      std::chrono::milliseconds(1000),
+      /* maxEntries */ 16);
+
+  auto first = rh.route(McGetRequest("key"));
+  EXPECT_EQ(mc_res_found, first.result());
+  EXPECT_EQ("a", carbon::valueRangeSlow(first).str());
+
+  auto second = rh.route(McGetRequest("key"));
+  EXPECT_EQ(mc_res_found, second.result());
+  EXPECT_EQ("a", carbon::valueRangeSlow(second).str());
+  EXPECT_EQ(42, second.flags());
+
+  // Only the first get should have reached the child.
+  EXPECT_EQ(vector<std::string>{"key"}, test_handles[0]->saw_keys);
+}
+
+TEST(microCacheRouteTest, missesAreNotCached) {
+  vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(GetRouteTestData(mc_res_notfound, ""))};
+
+  TestRouteHandle<MicroCacheRoute<TestRouterInfo>> rh(
+      get_route_handles(test_handles)[0],
+      std::chrono::milliseconds(1000),
+      /* maxEntries */ 16);
+
+  rh.route(McGetRequest("key"));
+  rh.route(McGetRequest("key"));
+
+  EXPECT_EQ(2, test_handles[0]->saw_keys.size());
+}
+
+TEST(microCacheRouteTest, entriesExpire) {
+  vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "a"))};
+
+  TestRouteHandle<MicroCacheRoute<TestRouterInfo>> rh(
+      get_route_handles(test_handles)[0],
+      std::chrono::milliseconds(10),
+      /* maxEntries */ 16);
+
+  rh.route(McGetRequest("key"));
+  /* sleep override */ std::this_thread::sleep_for(
+      std::chrono::milliseconds(30));
+  rh.route(McGetRequest("key"));
+
+  EXPECT_EQ(2, test_handles[0]->saw_keys.size());
+}
+
+TEST(microCacheRouteTest, writesInvalidate) {
+  vector<std::shared_ptr<TestHandle>> test_handles{make_shared<TestHandle>(
+      GetRouteTestData(mc_res_found, "a"),
+      UpdateRouteTestData(mc_res_stored),
+      DeleteRouteTestData(mc_res_deleted))};
+
+  TestRouteHandle<MicroCacheRoute<TestRouterInfo>> rh(
+      get_route_handles(test_handles)[0],
+      std::chrono::milliseconds(1000),
+      /* maxEntries */ 16);
+
+  rh.route(McGetRequest("key"));
+
+  McSetRequest set("key");
+  set.value() = folly::IOBuf(folly::IOBuf::COPY_BUFFER, "b");
+  rh.route(set);
+
+  // The set must have evicted the cached value, so this get goes upstream.
+  rh.route(McGetRequest("key"));
+  EXPECT_EQ(3, test_handles[0]->saw_keys.size());
+
+  rh.route(McDeleteRequest("key"));
+  rh.route(McGetRequest("key"));
+  EXPECT_EQ(5, test_handles[0]->saw_keys.size());
+}
+
+TEST(microCacheRouteTest, capacityIsBounded) {
+  vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "a"))};
+
+  TestRouteHandle<MicroCacheRoute<TestRouterInfo>> rh(
+      get_route_handles(test_handles)[0],
+      std::chrono::milliseconds(1000),
+      /* maxEntries */ 2);
+
+  rh.route(McGetRequest("k1"));
+  rh.route(McGetRequest("k2"));
+  rh.route(McGetRequest("k3"));
+
+  // Only two entries fit, so at least one of these is a forced miss.
+  rh.route(McGetRequest("k1"));
+  rh.route(McGetRequest("k2"));
+  rh.route(McGetRequest("k3"));
+
+  EXPECT_GE(test_handles[0]->saw_keys.size(), 4);
+  EXPECT_LE(test_handles[0]->saw_keys.size(), 6);
+}
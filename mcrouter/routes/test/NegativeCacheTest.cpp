@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "mcrouter/routes/NegativeCache.h"
+
+using facebook::memcache::mcrouter::NegativeCache;
+
+TEST(NegativeCacheTest, disabledWithZeroTtl) {
+  NegativeCache cache(1024, std::chrono::milliseconds(0));
+  EXPECT_FALSE(cache.enabled());
+
+  cache.store("key", /* nowUs */ 1000);
+  EXPECT_FALSE(cache.contains("key", 1000));
+}
+
+TEST(NegativeCacheTest, storeContainsErase) {
+  NegativeCache cache(1024, std::chrono::milliseconds(100));
+  ASSERT_TRUE(cache.enabled());
+
+  EXPECT_FALSE(cache.contains("key", 1000));
+
+  cache.store("key", 1000);
+  EXPECT_TRUE(cache.contains("key", 1000));
+  EXPECT_FALSE(cache.contains("other", 1000));
+
+  cache.erase("key");
+  EXPECT_FALSE(cache.contains("key", 1000));
+}
+
+TEST(NegativeCacheTest, entriesExpire) {
+  NegativeCache cache(1024, std::chrono::milliseconds(100));
+
+  cache.store("key", 1000);
+  EXPECT_TRUE(cache.contains("key", 1000 + 99 * 1000));
+  EXPECT_FALSE(cache.contains("key", 1000 + 100 * 1000));
+}
+
+TEST(NegativeCacheTest, storeRefreshesExpiry) {
+  NegativeCache cache(1024, std::chrono::milliseconds(100));
+
+  cache.store("key", 1000);
+  cache.store("key", 50 * 1000);
+  EXPECT_TRUE(cache.contains("key", 120 * 1000));
+}
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "mcrouter/lib/network/gen/Memcache.h"
+#include "mcrouter/lib/test/RouteHandleTestUtil.h"
+#include "mcrouter/lib/test/TestRouteHandle.h"
+#include "mcrouter/routes/RewriteRoute.h"
+
+using namespace facebook::memcache;
+using namespace facebook::memcache::mcrouter;
+
+using std::make_shared;
+using std::vector;
+
+using TestHandle = TestHandleImpl<TestRouteHandleIf>;
+
+TEST(rewriteRouteTest, fusedRewrite) {
+  vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(UpdateRouteTestData(mc_res_stored))};
+
+  RewriteRouteSettings settings;
+  settings.exptime = 100;
+  settings.exptimeAction = ModifyExptimeAction::Min;
+  settings.rewriteKey = true;
+  settings.keyPrefix = "foo";
+
+  TestRouteHandle<RewriteRoute<TestRouteHandleIf>> rh(
+      get_route_handles(test_handles)[0], settings);
+
+  McSetRequest req("bar");
+  req.exptime() = 500;
+  auto reply = rh.route(req);
+
+  EXPECT_EQ(mc_res_stored, reply.result());
+  EXPECT_EQ(vector<std::string>{"foobar"}, test_handles[0]->saw_keys);
+  EXPECT_EQ(vector<uint32_t>{100}, test_handles[0]->sawExptimes);
+}
+
+TEST(rewriteRouteTest, passThroughWhenNothingChanges) {
+  vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(UpdateRouteTestData(mc_res_stored))};
+
+  RewriteRouteSettings settings;
+  settings.exptime = 100;
+  settings.exptimeAction = ModifyExptimeAction::Min;
+  settings.rewriteKey = true;
+  settings.keyPrefix = "foo";
+
+  TestRouteHandle<RewriteRoute<TestRouteHandleIf>> rh(
+      get_route_handles(test_handles)[0], settings);
+
+  // Already prefixed and already under the exptime clamp: the request
+  // is forwarded as is.
+  McSetRequest req("foobar");
+  req.exptime() = 50;
+  auto reply = rh.route(req);
+
+  EXPECT_EQ(mc_res_stored, reply.result());
+  EXPECT_EQ(vector<std::string>{"foobar"}, test_handles[0]->saw_keys);
+  EXPECT_EQ(vector<uint32_t>{50}, test_handles[0]->sawExptimes);
+}
+
+TEST(rewriteRouteTest, deleteExptimeUntouched) {
+  vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(DeleteRouteTestData(mc_res_deleted))};
+
+  RewriteRouteSettings settings;
+  settings.exptime = 100;
+  settings.rewriteKey = true;
+  settings.keyPrefix = "foo";
+
+  TestRouteHandle<RewriteRoute<TestRouteHandleIf>> rh(
+      get_route_handles(test_handles)[0], settings);
+
+  // Deletes still get the key rewrite, but never the exptime one.
+  auto reply = rh.route(McDeleteRequest("bar"));
+
+  EXPECT_EQ(mc_res_deleted, reply.result());
+  EXPECT_EQ(vector<std::string>{"foobar"}, test_handles[0]->saw_keys);
+}
+
+TEST(rewriteRouteTest, routeName) {
+  vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(GetRouteTestData(mc_res_found, "a"))};
+
+  RewriteRouteSettings settings;
+  settings.exptime = 10;
+  settings.exptimeAction = ModifyExptimeAction::Min;
+  settings.rewriteKey = true;
+  settings.flagsOrMask = 0x4;
+
+  TestRouteHandle<RewriteRoute<TestRouteHandleIf>> rh(
+      get_route_handles(test_handles)[0], settings);
+
+  EXPECT_EQ("rewrite|exptime-min=10|key|flags=0xffffffffffffffff&0x4",
+            rh.routeName());
+}
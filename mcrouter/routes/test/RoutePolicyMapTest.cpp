@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "mcrouter/routes/PrefixSelectorRoute.h"
+#include "mcrouter/routes/RoutePolicyMap.h"
+
+using namespace facebook::memcache::mcrouter;
+
+namespace {
+
+struct TestHandle {};
+using HandlePtr = std::shared_ptr<TestHandle>;
+using SelectorPtr = std::shared_ptr<PrefixSelectorRoute<TestHandle>>;
+
+SelectorPtr makeSelector(
+    HandlePtr wildcard,
+    std::vector<std::pair<std::string, HandlePtr>> policies) {
+  auto selector = std::make_shared<PrefixSelectorRoute<TestHandle>>();
+  selector->wildcard = std::move(wildcard);
+  for (auto& it : policies) {
+    selector->policies.emplace(it.first, std::move(it.second));
+  }
+  return selector;
+}
+
+} // anonymous namespace
+
+TEST(RoutePolicyMap, wildcardOnly) {
+  auto a = std::make_shared<TestHandle>();
+  RoutePolicyMap<TestHandle> map({makeSelector(a, {})});
+
+  EXPECT_EQ(std::vector<HandlePtr>{a}, map.getTargetsForKey("foo"));
+  EXPECT_EQ(std::vector<HandlePtr>{a}, map.getTargetsForKey(""));
+}
+
+TEST(RoutePolicyMap, longestPrefixMatch) {
+  auto wild = std::make_shared<TestHandle>();
+  auto ab = std::make_shared<TestHandle>();
+  auto abc = std::make_shared<TestHandle>();
+  RoutePolicyMap<TestHandle> map(
+      {makeSelector(wild, {{"ab", ab}, {"abc", abc}})});
+
+  EXPECT_EQ(std::vector<HandlePtr>{wild}, map.getTargetsForKey("a"));
+  EXPECT_EQ(std::vector<HandlePtr>{ab}, map.getTargetsForKey("ab"));
+  EXPECT_EQ(std::vector<HandlePtr>{ab}, map.getTargetsForKey("abd"));
+  EXPECT_EQ(std::vector<HandlePtr>{abc}, map.getTargetsForKey("abc"));
+  EXPECT_EQ(std::vector<HandlePtr>{abc}, map.getTargetsForKey("abcdef"));
+  EXPECT_EQ(std::vector<HandlePtr>{wild}, map.getTargetsForKey("zzz"));
+  // "abb" sorts between "ab" and "abc" but only "ab" is its prefix.
+  EXPECT_EQ(std::vector<HandlePtr>{ab}, map.getTargetsForKey("abb"));
+}
+
+TEST(RoutePolicyMap, multipleClustersOrderedUnique) {
+  auto wild1 = std::make_shared<TestHandle>();
+  auto wild2 = std::make_shared<TestHandle>();
+  auto foo1 = std::make_shared<TestHandle>();
+  RoutePolicyMap<TestHandle> map(
+      {makeSelector(wild1, {{"foo", foo1}}), makeSelector(wild2, {})});
+
+  EXPECT_EQ(
+      (std::vector<HandlePtr>{wild1, wild2}), map.getTargetsForKey("bar"));
+  // Cluster 1's policy overrides only its own slot; order is preserved.
+  EXPECT_EQ(
+      (std::vector<HandlePtr>{foo1, wild2}), map.getTargetsForKey("foobar"));
+}
+
+TEST(RoutePolicyMap, duplicateHandlesCollapsed) {
+  auto shared = std::make_shared<TestHandle>();
+  RoutePolicyMap<TestHandle> map(
+      {makeSelector(shared, {}), makeSelector(shared, {})});
+
+  EXPECT_EQ(std::vector<HandlePtr>{shared}, map.getTargetsForKey("key"));
+}
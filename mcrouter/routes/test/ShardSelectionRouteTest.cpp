@@ -607,6 +607,111 @@ TEST_F(ShardSelectionRouteTest, customOutOfRangeRouteString) {
   EXPECT_EQ(mc_res_notfound, reply.result());
 }
 
+class EytzingerShardSelector {
+ public:
+  explicit EytzingerShardSelector(EytzingerShardMap shardsMap)
+      : shardsMap_(std::move(shardsMap)) {}
+
+  std::string type() const {
+    return "eytzinger-shard-selector";
+  }
+
+  template <class Request>
+  size_t select(const Request& req, size_t /* size */) const {
+    auto destination = shardsMap_.lookup(req.shardId());
+    if (destination == EytzingerShardMap::kNoDestination) {
+      // return a value outside of the range of valid destinations
+      // (i.e. >= size), so that we error the request.
+      return std::numeric_limits<size_t>::max();
+    }
+    return destination;
+  }
+
+ private:
+  const EytzingerShardMap shardsMap_;
+};
+
+TEST(EytzingerShardMapTest, lookup) {
+  EytzingerShardMap map;
+  // Sparse ids, inserted out of order.
+  const std::vector<std::pair<uint32_t, uint32_t>> entries = {
+      {1000000, 3}, {7, 0}, {42, 1}, {99999, 2}, {8, 4}, {43, 5}, {44, 6}};
+  for (const auto& entry : entries) {
+    EXPECT_FALSE(map.contains(entry.first));
+    map[entry.first] = entry.second;
+    EXPECT_TRUE(map.contains(entry.first));
+  }
+  map.freeze();
+
+  for (const auto& entry : entries) {
+    EXPECT_EQ(entry.second, map.lookup(entry.first));
+  }
+  EXPECT_EQ(EytzingerShardMap::kNoDestination, map.lookup(0));
+  EXPECT_EQ(EytzingerShardMap::kNoDestination, map.lookup(6));
+  EXPECT_EQ(EytzingerShardMap::kNoDestination, map.lookup(9));
+  EXPECT_EQ(EytzingerShardMap::kNoDestination, map.lookup(100000));
+  EXPECT_EQ(EytzingerShardMap::kNoDestination, map.lookup(1000001));
+}
+
+TEST(EytzingerShardMapTest, lookupLarge) {
+  EytzingerShardMap map;
+  // Non-power-of-two size exercises an incomplete last tree level.
+  constexpr uint32_t kNumShards = 100001;
+  for (uint32_t i = 0; i < kNumShards; ++i) {
+    map[i * 3] = i % 1000;
+  }
+  map.freeze();
+
+  for (uint32_t i = 0; i < kNumShards; ++i) {
+    EXPECT_EQ(i % 1000, map.lookup(i * 3));
+    EXPECT_EQ(EytzingerShardMap::kNoDestination, map.lookup(i * 3 + 1));
+  }
+}
+
+TEST_F(ShardSelectionRouteTest, routeEytzingerSelector) {
+  constexpr folly::StringPiece kSelectionRouteConfig = R"(
+  {
+    "pool": {
+      "type": "Pool",
+      "name": "SamplePool1",
+      "servers": [
+        {"type": "NullRoute"},
+        {"type": "ErrorRoute"}
+      ],
+      "protocol": "caret",
+      "shards": [
+        [1, 100, 10000],
+        [2, 200, 20000]
+      ]
+    },
+    "out_of_range": "ErrorRoute|Out of range!"
+  }
+  )";
+
+  auto rh = createShardSelectionRoute<
+      HelloGoodbyeRouterInfo,
+      EytzingerShardSelector,
+      EytzingerShardMap>(rhFactory_, folly::parseJson(kSelectionRouteConfig));
+  ASSERT_TRUE(rh);
+  EXPECT_EQ("selection|eytzinger-shard-selector", rh->routeName());
+
+  GoodbyeRequest req;
+  GoodbyeReply reply;
+
+  req.shardId() = 10000;
+  reply = rh->route(req);
+  EXPECT_EQ(mc_res_notfound, reply.result());
+
+  req.shardId() = 200;
+  reply = rh->route(req);
+  EXPECT_EQ(mc_res_local_error, reply.result());
+
+  req.shardId() = 300;
+  reply = rh->route(req);
+  EXPECT_EQ(mc_res_local_error, reply.result());
+  EXPECT_EQ("Out of range!", reply.message());
+}
+
 } // namespace mcrouter
 } // namespace memcache
 } // namespace facebook
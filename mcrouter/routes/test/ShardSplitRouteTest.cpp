@@ -35,7 +35,7 @@ void testDirectOp(ShardSplitter splitter) {
       DeleteRouteTestData(mc_res_found))};
   auto rh = get_route_handles(handles)[0];
   McrouterRouteHandle<ShardSplitRoute<McrouterRouterInfo>> splitRoute(
-      rh, splitter);
+      rh, make_shared<const ShardSplitter>(std::move(splitter)));
 
   TestFiberManager fm{FiberManagerContextTag()};
   fm.run([&] {
@@ -86,7 +86,7 @@ TEST(shardSplitRoute, simpleSplit_deleteFanout) {
   auto rh = get_route_handles(handles)[0];
   ShardSplitter splitter(folly::dynamic::object("123", kNumSplits));
   McrouterRouteHandle<ShardSplitRoute<McrouterRouterInfo>> splitRoute(
-      rh, splitter);
+      rh, make_shared<const ShardSplitter>(std::move(splitter)));
 
   TestFiberManager fm{FiberManagerContextTag()};
   fm.run([&] {
@@ -29,12 +29,15 @@ using FiberManagerContextTag =
 constexpr size_t kNumSplits = 26 * 26 + 1;
 
 template <class Request, class RouterInfo = MemcacheRouterInfo>
-void testShardingForOp(ShardSplitter splitter, uint64_t requestFlags = 0) {
+void testShardingForOp(ShardSplitter splitterConfig, uint64_t requestFlags = 0) {
   using ShardSplitTestHandle =
       TestHandleImpl<typename RouterInfo::RouteHandleIf>;
   using ShardSplitRouteHandle =
       typename RouterInfo::template RouteHandle<ShardSplitRoute<RouterInfo>>;
 
+  auto splitter =
+      std::make_shared<const ShardSplitter>(std::move(splitterConfig));
+
   for (size_t i = 0; i < kNumSplits; ++i) {
     globals::HostidMock hostidMock(i);
 
@@ -15,6 +15,7 @@
 #include "mcrouter/lib/network/gen/Memcache.h"
 #include "mcrouter/lib/test/RouteHandleTestUtil.h"
 #include "mcrouter/lib/test/TestRouteHandle.h"
+#include "mcrouter/routes/WarmUpFillBudget.h"
 #include "mcrouter/routes/WarmUpRoute.h"
 
 using namespace facebook::memcache;
@@ -87,3 +88,49 @@ TEST(warmUpRouteTest, warmUp) {
     EXPECT_EQ(vector<string>{"key_del"}, test_handles[2]->saw_keys);
   });
 }
+
+TEST(warmUpFillBudget, dropsLargeFillsFirst) {
+  /* 100 byte/s budget with a 100 byte burst available up front */
+  WarmUpFillBudget budget(100, 100, 1.0, 1);
+  EXPECT_TRUE(budget.allowFill(60));
+  /* only 40 bytes left: the large fill is dropped... */
+  EXPECT_FALSE(budget.allowFill(60));
+  /* ...while a small one still fits */
+  EXPECT_TRUE(budget.allowFill(30));
+}
+
+TEST(warmUpRouteTest, fillBudget) {
+  vector<std::shared_ptr<TestHandle>> test_handles{
+      make_shared<TestHandle>(
+          GetRouteTestData(mc_res_found, "a"),
+          UpdateRouteTestData(mc_res_stored),
+          DeleteRouteTestData(mc_res_deleted)),
+      make_shared<TestHandle>(
+          GetRouteTestData(mc_res_notfound, ""),
+          UpdateRouteTestData(mc_res_notstored),
+          DeleteRouteTestData(mc_res_notfound)),
+  };
+  auto route_handles = get_route_handles(test_handles);
+
+  TestFiberManager fm;
+
+  fm.run([&]() {
+    /* budget fits exactly one 1-byte fill */
+    TestRouteHandle<WarmUpRoute<TestRouteHandleIf>> rh(
+        route_handles[0],
+        route_handles[1],
+        1,
+        std::make_unique<WarmUpFillBudget>(1, 1, 1.0, 1));
+
+    auto reply1 = rh.route(McGetRequest("key1"));
+    EXPECT_EQ("a", carbon::valueRangeSlow(reply1).str());
+    auto reply2 = rh.route(McGetRequest("key2"));
+    EXPECT_EQ("a", carbon::valueRangeSlow(reply2).str());
+  });
+  fm.run([&]() {
+    /* only the first miss got filled; the second exceeded the budget */
+    EXPECT_EQ(
+        (vector<std::string>{"get", "add", "get"}),
+        test_handles[1]->sawOperations);
+  });
+}
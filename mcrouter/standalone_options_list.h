@@ -119,6 +119,35 @@ MCROUTER_OPTION_INTEGER(
     no_short,
     "TCP listen backlog size")
 
+MCROUTER_OPTION_INTEGER(
+    int,
+    tcp_defer_accept_timeout,
+    0,
+    "tcp-defer-accept-timeout",
+    no_short,
+    "TCP_DEFER_ACCEPT timeout (in seconds) for plain-text listen sockets."
+    " When > 0, the acceptor thread is only woken up once the first request"
+    " bytes arrive. 0 leaves the socket option untouched.")
+
+MCROUTER_OPTION_TOGGLE(
+    load_aware_accept_steering,
+    false,
+    "load-aware-accept-steering",
+    no_short,
+    "Hand each accepted connection to the server thread with the fewest"
+    " open connections instead of round-robin. Helps when long-lived client"
+    " connections close unevenly and leave worker threads imbalanced.")
+
+MCROUTER_OPTION_TOGGLE(
+    per_worker_listening_sockets,
+    false,
+    "per-worker-listening-sockets",
+    no_short,
+    "Give every server thread its own SO_REUSEPORT listen socket, accepting"
+    " independently with kernel-level load spread. Removes the shared accept"
+    " queue bottleneck during mass client reconnects. Overrides"
+    " num-listening-sockets.")
+
 MCROUTER_OPTION_INTEGER(
     uint32_t,
     max_client_outstanding_reqs,
@@ -127,6 +156,28 @@ MCROUTER_OPTION_INTEGER(
     no_short,
     "Maximum requests outstanding per client (0 to disable)")
 
+MCROUTER_OPTION_INTEGER(
+    size_t,
+    max_client_outstanding_reqs_bytes,
+    0,
+    "max-client-outstanding-reqs-bytes",
+    no_short,
+    "Maximum request bytes outstanding per client before reads from its"
+    " socket are paused. Complements max-client-outstanding-reqs by"
+    " weighing requests by size, so large sets cannot balloon memory"
+    " within the request-count limit (0 to disable)")
+
+MCROUTER_OPTION_INTEGER(
+    size_t,
+    client_parse_ahead_bytes,
+    0,
+    "client-parse-ahead-bytes",
+    no_short,
+    "While a client is paused by max-client-outstanding-reqs[-bytes],"
+    " keep parsing up to this many request bytes into ready requests"
+    " instead of leaving them in kernel buffers, so they dispatch the"
+    " moment the throttle lifts. Caret protocol only (0 to disable)")
+
 MCROUTER_OPTION_INTEGER(
     size_t,
     requests_per_read,
@@ -135,6 +186,28 @@ MCROUTER_OPTION_INTEGER(
     no_short,
     "DEPRECATED. Does nothing.")
 
+MCROUTER_OPTION_INTEGER(
+    uint32_t,
+    startup_warmup_requests,
+    0,
+    "startup-warmup-requests",
+    no_short,
+    "If non-zero, run this many synthetic requests through the request"
+    " parser, serializer and consistent hashing code before the listen"
+    " socket opens, so the first real requests do not pay cold-start"
+    " costs (page faults, lazily initialized statics). Nothing is sent"
+    " over the network. 0 (the default) disables the warmup pass.")
+
+MCROUTER_OPTION_TOGGLE(
+    multiget_streaming,
+    false,
+    "multiget-streaming",
+    no_short,
+    "Write ascii multiget hits out (in request order) as each"
+    " sub-request completes instead of holding the whole reply until the"
+    " slowest one finishes. END or an error line is still written last,"
+    " but an error can no longer retract hits already on the wire.")
+
 MCROUTER_OPTION_TOGGLE(
     retain_source_ip,
     false,
@@ -143,6 +216,17 @@ MCROUTER_OPTION_TOGGLE(
     "Look up the source IP address for inbound requests and expose it to"
     " routing logic.")
 
+MCROUTER_OPTION_TOGGLE(
+    server_strip_reply_fields,
+    false,
+    "server-strip-reply-fields",
+    no_short,
+    "Clear the flags field of get and lease-get replies before serializing"
+    " them to clients. Caret omits default-valued fields from the wire, so"
+    " deployments whose clients ignore flags save the bytes entirely."
+    " Only enable when all clients of this server are known not to use"
+    " flags.")
+
 MCROUTER_OPTION_TOGGLE(
     enable_server_compression,
     false,
@@ -159,6 +243,15 @@ MCROUTER_OPTION_INTEGER(
     "Timeout for sending replies back to clients, in milliseconds. "
     "(0 to disable)")
 
+MCROUTER_OPTION_INTEGER(
+    unsigned int,
+    client_idle_timeout_s,
+    0,
+    "client-idle-timeout",
+    no_short,
+    "Close client connections that had no activity for this many "
+    "seconds. (0 to never close idle connections)")
+
 MCROUTER_OPTION_INTEGER(
     uint64_t,
     server_load_interval_ms,
@@ -168,6 +261,17 @@ MCROUTER_OPTION_INTEGER(
     "How often to collect server load data. "
     "(0 to disable exposing server load)")
 
+MCROUTER_OPTION_INTEGER(
+    uint32_t,
+    server_cpu_shed_limit,
+    0,
+    "server-cpu-shed-limit",
+    no_short,
+    "CPU utilization percentage above which the server progressively "
+    "sheds the most expensive request classes (replying busy); deletes "
+    "are never shed. Requires --server-load-interval-ms. "
+    "(0 to disable load shedding)")
+
 MCROUTER_OPTION_INTEGER(
     uint32_t,
     tfo_queue_size,
@@ -21,6 +21,11 @@ STUI(time, 0, 0)
 // how long ago we started up libmcrouter instance
 STUI(uptime, 0, 0)
 #undef GROUP
+#define GROUP detailed_stats
+// sizeof the fiber-local context initialized per request and copied per
+// child fiber (see McrouterFiberContext).
+STUI(fiber_local_context_bytes, 0, 0)
+#undef GROUP
 
 
 /**
@@ -64,6 +69,9 @@ STUI(num_connect_success_after_retrying, 0, 1)
 STUI(num_connect_retries, 0, 1)
 // Connections closed due to retransmits
 STUI(retrans_closed_connections, 0, 1)
+// Destinations marked soft TKO by sustained high latency
+// (see latency-tko-multiplier)
+STUI(latency_tko_marks, 0, 1)
 #undef GROUP
 
 
@@ -110,6 +118,9 @@ STUI(ps_num_major_faults, 0, 0)
 STAT(ps_user_time_sec, stat_double, 0, .dbl = 0.0)
 STAT(ps_system_time_sec, stat_double, 0, .dbl = 0.0)
 STUI(ps_vsize, 0, 0)
+// Bytes of anonymous memory backed by transparent huge pages; shows how
+// much of the heap (fiber stacks, config trees) avoids dTLB pressure.
+STUI(ps_anon_huge_pages, 0, 0)
 #undef GROUP
 
 
@@ -120,6 +131,33 @@ STUI(ps_vsize, 0, 0)
 STUI(fibers_allocated, 0, 0)
 STUI(fibers_pool_size, 0, 0)
 STUI(fibers_stack_high_watermark, 0, 0)
+STUI(fibers_stack_size, 0, 0)
+#undef GROUP
+
+
+/**
+ * Stats about memory allocation. Cumulative bytes allocated/freed by proxy
+ * threads, as reported by jemalloc; 0 when not running with jemalloc.
+ */
+#define GROUP ods_stats
+STUI(proxy_threads_allocated_bytes, 0, 0)
+STUI(proxy_threads_deallocated_bytes, 0, 0)
+// Cumulative CPU time of all proxy threads, sampled in-process at event
+// loop boundaries (CLOCK_THREAD_CPUTIME_ID), and a smoothed event loop
+// iteration duration averaged over proxies. Unlike rusage_* these only
+// cover proxy threads, so they isolate routing cost from auxiliary
+// threads.
+STUI(proxy_threads_cpu_time_us, 0, 0)
+STAT(loop_duration_us, stat_double, 0, .dbl = 0.0)
+// Cumulative time proxy threads spent in the event loop slices mcrouter
+// itself runs, measured with the cpu cycle counter and bucketed by
+// origin (see ProxyBase::LoopSliceGuard). The gap between their sum and
+// proxy_threads_cpu_time_us is time spent in socket IO, timers and
+// library callbacks. loop_stalls counts instrumented slices that ran
+// longer than --proxy-loop-slice-threshold-us.
+STUI(loop_slice_message_queue_us, 0, 1)
+STUI(loop_slice_config_us, 0, 1)
+STUI(loop_stalls, 0, 1)
 #undef GROUP
 
 
@@ -129,6 +167,10 @@ STUI(fibers_stack_high_watermark, 0, 0)
 #define GROUP ods_stats | basic_stats
 // number of requests that were spooled to disk
 STUI(asynclog_requests, 0, 1)
+// Failed deletes that were held in memory for --asynclog-grace-window-ms
+// and successfully replayed once the destination recovered, so they never
+// touched the disk spool.
+STUI(asynclog_replayed_deletes, 0, 1)
 // Proxy requests that are currently being routed.
 STUI(proxy_reqs_processing, 0, 1)
 // Proxy requests queued up and not routed yet
@@ -144,6 +186,24 @@ STUI(dev_null_requests, 0, 1)
 #define GROUP ods_stats | detailed_stats | count_stats
 STUI(rate_limited_log_count, 0, 1)
 STUI(load_balancer_load_reset_count, 0, 1)
+// Sends skipped because the request's remaining deadline budget was
+// below the destination's smoothed latency (see --deadline-budget-ms).
+STUI(deadline_budget_drops, 0, 1)
+// Sends whose timeout was trimmed below the static pool timeout to fit
+// the request's remaining deadline budget (see DeadlineBudgetRoute).
+STUI(deadline_timeout_trims, 0, 1)
+// Gets answered with mc_res_notfound straight from the per-proxy negative
+// cache (see --negative-cache-ttl-ms).
+STUI(negative_cache_hits, 0, 1)
+// Deletes that shared an identical in-flight delete's reply instead of
+// being sent to the destination (see --coalesce-same-key-deletes).
+STUI(coalesced_deletes, 0, 1)
+// Idempotent requests re-sent once on the same destination after the
+// connection died under them without delivering any reply bytes.
+STUI(destination_conn_error_retries, 0, 1)
+// Gets that shared an identical in-flight get's reply instead of being
+// sent to the destination (see --collapse-inflight-gets).
+STUI(collapsed_gets, 0, 1)
 #undef GROUP
 #define GROUP count_stats
 STUI(request_sent_count, 0, 1)
@@ -161,10 +221,13 @@ STUIR(failover_all, 0, 1)
 STUIR(failover_conditional, 0, 1)
 STUIR(failover_all_failed, 0, 1)
 STUIR(failover_rate_limited, 0, 1)
+STUIR(failover_parallel_probe, 0, 1)
 STUIR(failover_inorder_policy, 0, 1)
 STUIR(failover_inorder_policy_failed, 0, 1)
 STUIR(failover_least_failures_policy, 0, 1)
 STUIR(failover_least_failures_policy_failed, 0, 1)
+STUIR(failover_latency_aware_policy, 0, 1)
+STUIR(failover_latency_aware_policy_failed, 0, 1)
 STUIR(failover_custom_policy, 0, 1)
 STUIR(failover_custom_policy_failed, 0, 1)
 #undef GROUP
@@ -179,6 +242,9 @@ STUI(result_data_timeout_count, 0, 1)
 STUI(result_data_timeout_all_count, 0, 1)
 STUI(result_busy_count, 0, 1)
 STUI(result_busy_all_count, 0, 1)
+// TKO probes skipped because the instance-wide probe budget was spent
+// (see --probe-max-per-second).
+STUI(probes_rate_limited, 0, 1)
 STUI(result_tko_count, 0, 1)
 STUI(result_tko_all_count, 0, 1)
 STUI(result_client_error_count, 0, 1)
@@ -263,6 +329,10 @@ STUIR(replies_compressed, 0, 1)
 STUIR(replies_not_compressed, 0, 1)
 STUIR(reply_traffic_before_compression, 0, 1)
 STUIR(reply_traffic_after_compression, 0, 1)
+// Destination connections that stopped advertising compression codecs
+// because measured savings stayed below
+// --compression-auto-disable-savings-pct.
+STUIR(compression_auto_disables, 0, 1)
 #undef GROUP
 #define GROUP ods_stats | detailed_stats
 STAT(retrans_per_kbyte_avg, stat_double, 0, .dbl = 0.0)
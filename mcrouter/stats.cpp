@@ -8,6 +8,7 @@
 #include "stats.h"
 
 #include <dirent.h>
+#include <inttypes.h>
 #include <sys/resource.h>
 #include <sys/types.h>
 #include <time.h>
@@ -21,6 +22,7 @@
 #include <folly/json.h>
 
 #include "mcrouter/CarbonRouterInstanceBase.h"
+#include "mcrouter/LatencyHistogram.h"
 #include "mcrouter/McrouterLogFailure.h"
 #include "mcrouter/ProxyBase.h"
 #include "mcrouter/ProxyDestination.h"
@@ -71,6 +73,7 @@ struct ServerStat {
   bool isSoftTko{false};
   double sumLatencies{0.0};
   size_t cntLatencies{0};
+  LatencyHistogram latencyUsHistogram;
   size_t pendingRequestsCount{0};
   size_t inflightRequestsCount{0};
   double sumRetransPerKByte{0.0};
@@ -81,6 +84,14 @@ struct ServerStat {
   std::string toString() const {
     double avgLatency = cntLatencies == 0 ? 0 : sumLatencies / cntLatencies;
     auto res = folly::format("avg_latency_us:{:.3f}", avgLatency).str();
+    if (latencyUsHistogram.totalSamples() > 0) {
+      folly::format(
+          " p50_latency_us:{} p99_latency_us:{} p999_latency_us:{}",
+          latencyUsHistogram.estimatePercentile(50),
+          latencyUsHistogram.estimatePercentile(99),
+          latencyUsHistogram.estimatePercentile(99.9))
+          .appendTo(res);
+    }
     folly::format(" pending_reqs:{}", pendingRequestsCount).appendTo(res);
     folly::format(" inflight_reqs:{}", inflightRequestsCount).appendTo(res);
     if (isHardTko) {
@@ -208,19 +219,6 @@ uint64_t stats_aggregate_max_max_value(
   return max;
 }
 
-static std::string rate_stat_to_str(ProxyBase* proxy, int idx) {
-  return folly::stringPrintf("%g", stats_rate_value(proxy, idx));
-}
-
-static std::string max_stat_to_str(ProxyBase* proxy, int idx) {
-  return folly::to<std::string>(stats_max_value(proxy, idx));
-}
-
-static std::string max_max_stat_to_str(ProxyBase* proxy, int idx) {
-  return folly::to<std::string>(
-      stats_aggregate_max_max_value(proxy->router(), idx));
-}
-
 /**
  * Write a stat into a buffer.
  *
@@ -275,6 +273,57 @@ uint64_t stat_get_config_age(const stat_t* stats, uint64_t now) {
   return now - lct;
 }
 
+static const char* stat_type_to_string(stat_type_t type) {
+  switch (type) {
+    case stat_string:
+      return "string";
+    case stat_uint64:
+      return "uint64";
+    case stat_int64:
+      return "int64";
+    case stat_double:
+      return "double";
+    default:
+      return "unknown";
+  }
+}
+
+uint64_t stats_schema_hash() {
+  // FNV-1a over "<name> <type>" of every stat in id order, so any
+  // rename, retype or reorder of stat_list.h changes the hash.
+  uint64_t hash = 14695981039346656037ul;
+  auto mix = [&hash](folly::StringPiece piece) {
+    for (const char c : piece) {
+      hash ^= static_cast<uint8_t>(c);
+      hash *= 1099511628211ul;
+    }
+  };
+  std::vector<stat_t> stats(num_stats);
+  init_stats(stats.data());
+  for (const auto& stat : stats) {
+    mix(stat.name);
+    mix(" ");
+    mix(stat_type_to_string(stat.type));
+    mix("\n");
+  }
+  return hash;
+}
+
+std::string stats_schema_dump() {
+  std::vector<stat_t> stats(num_stats);
+  init_stats(stats.data());
+  std::string ret =
+      folly::stringPrintf("hash %016" PRIx64 "\n", stats_schema_hash());
+  for (size_t i = 0; i < stats.size(); ++i) {
+    ret.append(folly::stringPrintf(
+        "%zu %s %s\n",
+        i,
+        stats[i].name.str().c_str(),
+        stat_type_to_string(stats[i].type)));
+  }
+  return ret;
+}
+
 // Returns 0 on success, -1 on failure.  In either case, all fields of
 // *data will be initialized to something.
 static int get_proc_stat(pid_t pid, proc_stat_data_t* data) {
@@ -337,6 +386,28 @@ static int get_proc_stat(pid_t pid, proc_stat_data_t* data) {
   return 0;
 }
 
+// Returns the bytes of anonymous memory currently backed by transparent
+// huge pages, or 0 if the kernel doesn't export the counter.
+static uint64_t get_anon_huge_page_bytes(pid_t pid) {
+  char status_path[32];
+  snprintf(status_path, sizeof(status_path), "/proc/%d/status", pid);
+
+  FILE* status_file = fopen(status_path, "r");
+  if (status_file == nullptr) {
+    return 0;
+  }
+
+  uint64_t kb = 0;
+  char line[128];
+  while (fgets(line, sizeof(line), status_file) != nullptr) {
+    if (sscanf(line, "AnonHugePages: %" SCNu64 " kB", &kb) == 1) {
+      break;
+    }
+  }
+  fclose(status_file);
+  return kb * 1024;
+}
+
 void append_pool_stats(
     CarbonRouterInstanceBase& router,
     std::vector<stat_t>& stats) {
@@ -492,10 +563,16 @@ void prepare_stats(CarbonRouterInstanceBase& router, stat_t* stats) {
   stats[ps_system_time_sec_stat].data.dbl = ps_data.system_time_sec;
   stats[ps_rss_stat].data.uint64 = ps_data.rss;
   stats[ps_vsize_stat].data.uint64 = ps_data.vsize;
+  stats[ps_anon_huge_pages_stat].data.uint64 =
+      get_anon_huge_page_bytes(getpid());
 
   stats[fibers_allocated_stat].data.uint64 = 0;
   stats[fibers_pool_size_stat].data.uint64 = 0;
   stats[fibers_stack_high_watermark_stat].data.uint64 = 0;
+  stats[fibers_stack_size_stat].data.uint64 = router.opts().fibers_stack_size;
+  stats[proxy_threads_allocated_bytes_stat].data.uint64 = 0;
+  stats[proxy_threads_deallocated_bytes_stat].data.uint64 = 0;
+  stats[proxy_threads_cpu_time_us_stat].data.uint64 = 0;
   for (size_t i = 0; i < router.opts().num_proxies; ++i) {
     auto pr = router.getProxyBase(i);
     stats[fibers_allocated_stat].data.uint64 +=
@@ -505,6 +582,13 @@ void prepare_stats(CarbonRouterInstanceBase& router, stat_t* stats) {
     stats[fibers_stack_high_watermark_stat].data.uint64 = std::max(
         stats[fibers_stack_high_watermark_stat].data.uint64,
         pr->fiberManager().stackHighWatermark());
+    stats[proxy_threads_allocated_bytes_stat].data.uint64 +=
+        pr->threadAllocatedBytes();
+    stats[proxy_threads_deallocated_bytes_stat].data.uint64 +=
+        pr->threadDeallocatedBytes();
+    stats[proxy_threads_cpu_time_us_stat].data.uint64 += pr->threadCpuTimeUs();
+    stats[loop_duration_us_stat].data.dbl +=
+        pr->stats().loopDurationUs().value();
     stats[duration_us_stat].data.dbl += pr->stats().durationUs().value();
     stats[duration_get_us_stat].data.dbl += pr->stats().durationGetUs().value();
     stats[duration_update_us_stat].data.dbl +=
@@ -514,7 +598,24 @@ void prepare_stats(CarbonRouterInstanceBase& router, stat_t* stats) {
     stats[client_queue_notify_period_stat].data.dbl += pr->queueNotifyPeriod();
   }
 
+  // The high watermark is sampled (fibers-record-stack-size-every), so by the
+  // time it gets this close to the stack size some unsampled fibers have
+  // likely come even closer.  Guard pages turn an overrun into a crash, so
+  // warn while there is still headroom to raise fibers-stack-size.
+  const uint64_t fiberStackSize = router.opts().fibers_stack_size;
+  const uint64_t fiberStackHighWatermark =
+      stats[fibers_stack_high_watermark_stat].data.uint64;
+  if (fiberStackSize > 0 &&
+      fiberStackHighWatermark >= fiberStackSize - fiberStackSize / 8) {
+    LOG_FIRST_N(WARNING, 1)
+        << "Fiber stack high watermark (" << fiberStackHighWatermark
+        << ") is within 12.5% of fibers-stack-size (" << fiberStackSize
+        << "); a deep route handle tree may overrun its stack."
+        << " Consider raising --fibers-stack-size.";
+  }
+
   if (router.opts().num_proxies > 0) {
+    stats[loop_duration_us_stat].data.dbl /= router.opts().num_proxies;
     stats[duration_us_stat].data.dbl /= router.opts().num_proxies;
     stats[duration_get_us_stat].data.dbl /= router.opts().num_proxies;
     stats[duration_update_us_stat].data.dbl /= router.opts().num_proxies;
@@ -554,11 +655,11 @@ void stat_decr_safe(stat_t* stats, stat_name_t stat_name) {
 void stat_set_uint64(stat_t* stats, stat_name_t stat_num, uint64_t value) {
   stat_t* stat = &stats[stat_num];
   assert(stat->type == stat_uint64);
-  stat->data.uint64 = value;
+  __atomic_store_n(&stat->data.uint64, value, __ATOMIC_RELAXED);
 }
 
 uint64_t stat_get_uint64(const stat_t* stats, stat_name_t stat_num) {
-  return stats[stat_num].data.uint64;
+  return __atomic_load_n(&stats[stat_num].data.uint64, __ATOMIC_RELAXED);
 }
 
 static stat_group_t stat_parse_group_str(folly::StringPiece str) {
@@ -587,8 +688,6 @@ static stat_group_t stat_parse_group_str(folly::StringPiece str) {
  * @param Proxy proxy
  */
 McStatsReply stats_reply(ProxyBase* proxy, folly::StringPiece group_str) {
-  auto lockGuard = proxy->stats().lock();
-
   StatsReply reply;
 
   if (group_str == "version") {
@@ -604,18 +703,39 @@ McStatsReply stats_reply(ProxyBase* proxy, folly::StringPiece group_str) {
   }
 
   std::vector<stat_t> stats(num_stats);
-
-  prepare_stats(proxy->router(), stats.data());
+  std::vector<double> rateValues(num_stats, 0.0);
+  std::vector<uint64_t> aggValues(num_stats, 0);
+
+  {
+    // Hold the stats lock only while snapshotting raw counters. This
+    // request is served on a proxy thread, so formatting the reply under
+    // the lock would let the periodic stats updater (which locks every
+    // proxy in turn) stall this proxy's event loop, and vice versa.
+    auto lockGuard = proxy->stats().lock();
+
+    prepare_stats(proxy->router(), stats.data());
+
+    for (unsigned int ii = 0; ii < num_stats; ii++) {
+      const stat_t* stat = &stats[ii];
+      if (stat->group & groups) {
+        if (stat->group & rate_stats) {
+          rateValues[ii] = stats_rate_value(proxy, ii);
+        } else if (stat->group & max_stats) {
+          aggValues[ii] = stats_max_value(proxy, ii);
+        } else if (stat->group & max_max_stats) {
+          aggValues[ii] = stats_aggregate_max_max_value(proxy->router(), ii);
+        }
+      }
+    }
+  }
 
   for (unsigned int ii = 0; ii < num_stats; ii++) {
     stat_t* stat = &stats[ii];
     if (stat->group & groups) {
       if (stat->group & rate_stats) {
-        reply.addStat(stat->name, rate_stat_to_str(proxy, ii));
-      } else if (stat->group & max_stats) {
-        reply.addStat(stat->name, max_stat_to_str(proxy, ii));
-      } else if (stat->group & max_max_stats) {
-        reply.addStat(stat->name, max_max_stat_to_str(proxy, ii));
+        reply.addStat(stat->name, folly::stringPrintf("%g", rateValues[ii]));
+      } else if (stat->group & (max_stats | max_max_stats)) {
+        reply.addStat(stat->name, folly::to<std::string>(aggValues[ii]));
       } else {
         reply.addStat(stat->name, stat_to_str(stat, nullptr));
       }
@@ -671,6 +791,8 @@ McStatsReply stats_reply(ProxyBase* proxy, folly::StringPiece group_str) {
               stat.sumLatencies += pdstn.stats().avgLatency.value();
               ++stat.cntLatencies;
             }
+            stat.latencyUsHistogram.accumulate(
+                pdstn.stats().latencyUsHistogram);
 
             if (pdstn.stats().retransPerKByte >= 0.0) {
               const auto val = pdstn.stats().retransPerKByte;
@@ -92,8 +92,30 @@ struct stat_t {
 
 void init_stats(stat_t* stats);
 
+/**
+ * Hash of the stat schema: name and type of every stat_list.h entry, in
+ * id order. Consumers of the binary stats snapshots (see StatsFifoStream)
+ * cache the id -> name mapping keyed by this hash and detect schema
+ * drift between binaries without parsing strings.
+ */
+uint64_t stats_schema_hash();
+
+/**
+ * Schema dump for tooling: the schema hash followed by one
+ * "<id> <name> <type>" line per stat, in id order. Exposed through the
+ * stats_schema service command; meant to be fetched once per binary.
+ */
+std::string stats_schema_dump();
+
 inline void stat_incr(stat_t* stats, stat_name_t stat_num, int64_t amount) {
-  stats[stat_num].data.uint64 += amount;
+  // Counters have a single writer (the owning proxy thread) and are read
+  // concurrently by the stats updater thread. Relaxed atomic accesses keep
+  // those reads tear-free without putting a lock prefix on the hot path.
+  auto* counter = &stats[stat_num].data.uint64;
+  __atomic_store_n(
+      counter,
+      __atomic_load_n(counter, __ATOMIC_RELAXED) + amount,
+      __ATOMIC_RELAXED);
 }
 
 inline void stat_decr(stat_t* stats, stat_name_t stat_num, int64_t amount) {
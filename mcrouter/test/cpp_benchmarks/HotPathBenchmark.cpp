@@ -0,0 +1,224 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Range.h>
+#include <folly/fibers/Baton.h>
+#include <folly/init/Init.h>
+#include <folly/io/IOBuf.h>
+
+#include "mcrouter/CarbonRouterClient.h"
+#include "mcrouter/CarbonRouterInstance.h"
+#include "mcrouter/config.h"
+#include "mcrouter/lib/MessageQueue.h"
+#include "mcrouter/lib/RendezvousHashFunc.h"
+#include "mcrouter/lib/WeightedCh3HashFunc.h"
+#include "mcrouter/lib/network/CaretHeader.h"
+#include "mcrouter/lib/network/CaretSerializedMessage.h"
+#include "mcrouter/lib/network/McAsciiParser.h"
+#include "mcrouter/lib/network/UmbrellaProtocol.h"
+#include "mcrouter/lib/network/gen/Memcache.h"
+#include "mcrouter/lib/network/gen/MemcacheRouterInfo.h"
+#include "mcrouter/routes/PrefixSelectorRoute.h"
+#include "mcrouter/routes/RoutePolicyMap.h"
+
+using namespace facebook::memcache;
+using namespace facebook::memcache::mcrouter;
+
+namespace {
+
+constexpr size_t kNumServers = 100;
+
+std::vector<std::string> makeHosts() {
+  std::vector<std::string> hosts;
+  hosts.reserve(kNumServers);
+  for (size_t i = 0; i < kNumServers; ++i) {
+    hosts.push_back(folly::to<std::string>("memcache", i, ".example.com"));
+  }
+  return hosts;
+}
+
+std::vector<std::string> makeKeys() {
+  std::vector<std::string> keys;
+  keys.reserve(1000);
+  for (size_t i = 0; i < 1000; ++i) {
+    keys.push_back(folly::to<std::string>("service:object:", i * 7919));
+  }
+  return keys;
+}
+
+/**
+ * A process-wide router instance routing everything to NullRoute.
+ * There is no transport involved, so the echo benchmark measures the
+ * queue crossing, fiber and routing overhead of the request hot path.
+ */
+CarbonRouterInstance<MemcacheRouterInfo>& benchmarkRouter() {
+  static CarbonRouterInstance<MemcacheRouterInfo>* router = [] {
+    auto opts = defaultTestOptions();
+    opts.config_str = R"({ "route": "NullRoute" })";
+    return CarbonRouterInstance<MemcacheRouterInfo>::init(
+        "hot_path_benchmark", opts);
+  }();
+  return *router;
+}
+
+} // anonymous namespace
+
+BENCHMARK(messageQueueEnqueueDrain, iters) {
+  folly::BenchmarkSuspender susp;
+  size_t drained = 0;
+  MessageQueue<size_t> queue(
+      1024,
+      [&drained](size_t&&) { ++drained; },
+      0 /* noNotifyRate */,
+      0 /* waitThreshold */,
+      []() { return int64_t(0); },
+      nullptr /* notifyCallback */);
+  susp.dismiss();
+
+  for (size_t i = 0; i < iters; ++i) {
+    queue.blockingWriteRelaxed(i);
+    if ((i & 255) == 255) {
+      queue.drain();
+    }
+  }
+  queue.drain();
+  folly::doNotOptimizeAway(drained);
+}
+
+BENCHMARK(weightedCh3Hash, iters) {
+  folly::BenchmarkSuspender susp;
+  WeightedCh3HashFunc func(std::vector<double>(kNumServers, 0.5));
+  auto keys = makeKeys();
+  susp.dismiss();
+
+  size_t sum = 0;
+  for (size_t i = 0; i < iters; ++i) {
+    sum += func(keys[i % keys.size()]);
+  }
+  folly::doNotOptimizeAway(sum);
+}
+
+BENCHMARK(rendezvousHash, iters) {
+  folly::BenchmarkSuspender susp;
+  auto hosts = makeHosts();
+  std::vector<folly::StringPiece> endpoints(hosts.begin(), hosts.end());
+  RendezvousHashFunc func(endpoints);
+  auto keys = makeKeys();
+  susp.dismiss();
+
+  size_t sum = 0;
+  for (size_t i = 0; i < iters; ++i) {
+    sum += func(keys[i % keys.size()]);
+  }
+  folly::doNotOptimizeAway(sum);
+}
+
+BENCHMARK(routePolicyMapLookup, iters) {
+  struct TestHandle {};
+  folly::BenchmarkSuspender susp;
+  auto wildcard = std::make_shared<TestHandle>();
+  auto selector = std::make_shared<PrefixSelectorRoute<TestHandle>>();
+  selector->wildcard = wildcard;
+  for (size_t i = 0; i < 100; ++i) {
+    selector->policies.emplace(
+        folly::to<std::string>("service:prefix", i),
+        std::make_shared<TestHandle>());
+  }
+  RoutePolicyMap<TestHandle> map({selector});
+  auto keys = makeKeys();
+  susp.dismiss();
+
+  size_t found = 0;
+  for (size_t i = 0; i < iters; ++i) {
+    found += map.getTargetsForKey(keys[i % keys.size()]).size();
+  }
+  folly::doNotOptimizeAway(found);
+}
+
+BENCHMARK(caretEncodeGetRequest, iters) {
+  folly::BenchmarkSuspender susp;
+  McGetRequest req("service:object:12345678");
+  susp.dismiss();
+
+  for (size_t i = 0; i < iters; ++i) {
+    CaretSerializedMessage msg;
+    const struct iovec* iovs;
+    size_t niovs;
+    msg.prepare(req, i, CodecIdRange::Empty, iovs, niovs);
+    folly::doNotOptimizeAway(niovs);
+  }
+}
+
+BENCHMARK(caretParseHeader, iters) {
+  folly::BenchmarkSuspender susp;
+  UmbrellaMessageInfo info;
+  info.bodySize = 1234;
+  info.typeId = McGetRequest::typeId;
+  info.reqId = 4242;
+  info.version = UmbrellaVersion::TYPED_MESSAGE;
+  info.traceId = {123456789, 987654321};
+  char buf[kMaxHeaderLength];
+  auto headerSize = caretPrepareHeader(info, buf);
+  susp.dismiss();
+
+  for (size_t i = 0; i < iters; ++i) {
+    UmbrellaMessageInfo parsed;
+    auto status = caretParseHeader(
+        reinterpret_cast<const uint8_t*>(buf), headerSize, parsed);
+    folly::doNotOptimizeAway(status);
+  }
+}
+
+BENCHMARK(asciiParseGetHitReply, iters) {
+  folly::BenchmarkSuspender susp;
+  const std::string value(100, 'x');
+  const auto replyStr =
+      folly::to<std::string>("VALUE key 0 ", value.size(), "\r\n", value,
+                             "\r\nEND\r\n");
+  folly::IOBuf source(folly::IOBuf::WRAP_BUFFER, folly::StringPiece(replyStr));
+  susp.dismiss();
+
+  for (size_t i = 0; i < iters; ++i) {
+    McClientAsciiParser parser;
+    parser.initializeReplyParser<McGetRequest>();
+    auto buf = source.cloneOne();
+    parser.consume(*buf);
+    auto reply = parser.getReply<McGetReply>();
+    folly::doNotOptimizeAway(reply.result());
+  }
+}
+
+BENCHMARK(routerEchoNullRoute, iters) {
+  folly::BenchmarkSuspender susp;
+  auto& router = benchmarkRouter();
+  auto client = router.createClient(0 /* max_outstanding_requests */);
+  const McGetRequest req("service:object:12345678");
+  std::atomic<size_t> remaining(iters);
+  folly::fibers::Baton baton;
+  susp.dismiss();
+
+  for (size_t i = 0; i < iters; ++i) {
+    client->send(req, [&remaining, &baton](const McGetRequest&, McGetReply&&) {
+      if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        baton.post();
+      }
+    });
+  }
+  baton.wait();
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true /* removeFlags */);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,300 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <folly/Format.h>
+#include <folly/Range.h>
+#include <folly/init/Init.h>
+#include <folly/io/IOBuf.h>
+
+#include "mcrouter/lib/network/CaretSerializedMessage.h"
+#include "mcrouter/lib/network/McAsciiParser.h"
+#include "mcrouter/lib/network/McParser.h"
+#include "mcrouter/lib/network/UmbrellaProtocol.h"
+#include "mcrouter/lib/network/gen/Memcache.h"
+
+/**
+ * Parser throughput regression gate, run via "make perf-check".
+ *
+ * Measures messages/sec for the three wire parsers over fixed
+ * production-shape corpora and compares against a stored baseline file
+ * (parser_perf_baseline.txt, committed alongside). The build fails if
+ * any parser is more than --threshold (default 2%) below its baseline.
+ *
+ * Absolute throughput is machine-dependent: the committed baseline is
+ * only meaningful on the machine (or machine class) that recorded it.
+ * Run with --update_baseline once on a quiet box to (re)record, and
+ * again after any intentional parser change.
+ */
+
+DEFINE_string(baseline, "", "Path to the baseline file");
+DEFINE_bool(
+    update_baseline,
+    false,
+    "Record current throughput into the baseline file instead of comparing");
+DEFINE_double(
+    threshold,
+    0.02,
+    "Maximum tolerated fractional throughput drop against the baseline");
+
+using namespace facebook::memcache;
+
+namespace {
+
+/* Key/value size mix modeled on the ascii parser test corpus: mostly
+   small objects with an occasional large value and an occasional miss. */
+const std::vector<size_t> kValueSizes = {16, 100, 100, 100, 500, 4096};
+constexpr size_t kCorpusSize = 64;
+constexpr size_t kTrials = 5;
+constexpr size_t kItersPerTrial = 2000;
+
+std::string makeKey(size_t i) {
+  return folly::sformat("service:object:{}", i * 7919);
+}
+
+/**
+ * Best-of-kTrials messages/sec for a callable that parses the whole
+ * corpus once and returns the number of messages it processed.
+ */
+template <class F>
+double measure(F&& parseCorpusOnce) {
+  // Warmup pass so page faults and lazy statics don't count.
+  parseCorpusOnce();
+  double best = 0;
+  for (size_t trial = 0; trial < kTrials; ++trial) {
+    size_t messages = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kItersPerTrial; ++i) {
+      messages += parseCorpusOnce();
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::max(best, messages / elapsed.count());
+  }
+  return best;
+}
+
+double asciiParseThroughput() {
+  std::vector<std::string> corpus;
+  for (size_t i = 0; i < kCorpusSize; ++i) {
+    if (i % 8 == 7) {
+      corpus.push_back("END\r\n"); // miss
+    } else {
+      const std::string value(kValueSizes[i % kValueSizes.size()], 'x');
+      corpus.push_back(folly::sformat(
+          "VALUE {} 0 {}\r\n{}\r\nEND\r\n", makeKey(i), value.size(), value));
+    }
+  }
+
+  return measure([&corpus]() {
+    size_t messages = 0;
+    for (const auto& replyStr : corpus) {
+      McClientAsciiParser parser;
+      parser.initializeReplyParser<McGetRequest>();
+      folly::IOBuf buf(
+          folly::IOBuf::WRAP_BUFFER, folly::StringPiece(replyStr));
+      parser.consume(buf);
+      auto reply = parser.getReply<McGetReply>();
+      if (reply.result() == mc_res_found || reply.result() == mc_res_notfound) {
+        ++messages;
+      }
+    }
+    return messages;
+  });
+}
+
+/* Counts fully parsed caret messages coming out of McParser. */
+class CountingParserCallback : public McParser::ParserCallback {
+ public:
+  bool umMessageReady(const UmbrellaMessageInfo&, const folly::IOBuf&)
+      final {
+    ++messages;
+    return true;
+  }
+  bool caretMessageReady(const UmbrellaMessageInfo&, const folly::IOBuf&)
+      final {
+    ++messages;
+    return true;
+  }
+  void handleAscii(folly::IOBuf&) final {}
+  void parseError(mc_res_t, folly::StringPiece reason) final {
+    LOG(FATAL) << "parse error in perf corpus: " << reason;
+  }
+
+  size_t messages{0};
+};
+
+/**
+ * One contiguous stream of caret-serialized requests, the same shape a
+ * server read buffer would hold: gets with varying key lengths plus the
+ * occasional set carrying a value.
+ */
+std::string makeCaretCorpus() {
+  std::string stream;
+  for (size_t i = 0; i < kCorpusSize; ++i) {
+    CaretSerializedMessage msg;
+    const struct iovec* iovs;
+    size_t niovs;
+    if (i % 8 == 7) {
+      McSetRequest req(makeKey(i));
+      req.value() = folly::IOBuf(
+          folly::IOBuf::COPY_BUFFER,
+          std::string(kValueSizes[i % kValueSizes.size()], 'x'));
+      CHECK(msg.prepare(req, i, CodecIdRange::Empty, iovs, niovs));
+    } else {
+      McGetRequest req(makeKey(i));
+      CHECK(msg.prepare(req, i, CodecIdRange::Empty, iovs, niovs));
+    }
+    for (size_t j = 0; j < niovs; ++j) {
+      stream.append(
+          reinterpret_cast<const char*>(iovs[j].iov_base), iovs[j].iov_len);
+    }
+  }
+  return stream;
+}
+
+double caretParseThroughput() {
+  const auto stream = makeCaretCorpus();
+
+  return measure([&stream]() {
+    CountingParserCallback cb;
+    McParser parser(cb, 4096, 16384);
+    size_t offset = 0;
+    while (offset < stream.size()) {
+      auto readBuffer = parser.getReadBuffer();
+      auto len = std::min(readBuffer.second, stream.size() - offset);
+      std::memcpy(readBuffer.first, stream.data() + offset, len);
+      CHECK(parser.readDataAvailable(len));
+      offset += len;
+    }
+    return cb.messages;
+  });
+}
+
+double umbrellaParseThroughput() {
+  /* Flattened umbrella-serialized get requests, parsed header + body. */
+  std::vector<std::string> corpus;
+  for (size_t i = 0; i < kCorpusSize; ++i) {
+    UmbrellaSerializedMessage msg;
+    const struct iovec* iovs;
+    size_t niovs;
+    McGetRequest req(makeKey(i));
+    CHECK(msg.prepare(req, i, iovs, niovs));
+    std::string buf;
+    for (size_t j = 0; j < niovs; ++j) {
+      buf.append(
+          reinterpret_cast<const char*>(iovs[j].iov_base), iovs[j].iov_len);
+    }
+    corpus.push_back(std::move(buf));
+  }
+
+  return measure([&corpus]() {
+    size_t messages = 0;
+    for (const auto& str : corpus) {
+      folly::IOBuf source(
+          folly::IOBuf::WRAP_BUFFER, folly::StringPiece(str));
+      UmbrellaMessageInfo info;
+      auto status = umbrellaParseHeader(
+          reinterpret_cast<const uint8_t*>(str.data()), str.size(), info);
+      CHECK(status == UmbrellaParseStatus::OK);
+      uint64_t reqid;
+      auto req = umbrellaParseRequest<McGetRequest>(
+          source,
+          reinterpret_cast<const uint8_t*>(str.data()),
+          info.headerSize,
+          reinterpret_cast<const uint8_t*>(str.data()) + info.headerSize,
+          info.bodySize,
+          reqid);
+      if (!req.key().empty()) {
+        ++messages;
+      }
+    }
+    return messages;
+  });
+}
+
+std::map<std::string, double> readBaseline(const std::string& path) {
+  std::map<std::string, double> baseline;
+  std::ifstream in(path);
+  std::string name;
+  double value;
+  while (in >> name >> value) {
+    if (!name.empty() && name[0] != '#') {
+      baseline[name] = value;
+    } else {
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+  }
+  return baseline;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true /* removeFlags */);
+  CHECK(!FLAGS_baseline.empty()) << "--baseline is required";
+
+  std::map<std::string, double> measured;
+  measured["ascii_get_reply_parse"] = asciiParseThroughput();
+  measured["caret_request_parse"] = caretParseThroughput();
+  measured["umbrella_request_parse"] = umbrellaParseThroughput();
+
+  if (FLAGS_update_baseline) {
+    std::ofstream out(FLAGS_baseline);
+    out << "# Parser throughput baseline (messages/sec), recorded by\n"
+        << "# parser_perf_check --update_baseline. Only meaningful on the\n"
+        << "# machine class that recorded it; re-record after intentional\n"
+        << "# parser changes.\n";
+    for (const auto& it : measured) {
+      out << it.first << " " << folly::sformat("{:.0f}", it.second) << "\n";
+    }
+    LOG(INFO) << "Baseline written to " << FLAGS_baseline;
+    return 0;
+  }
+
+  const auto baseline = readBaseline(FLAGS_baseline);
+  bool failed = false;
+  for (const auto& it : measured) {
+    auto baseIt = baseline.find(it.first);
+    if (baseIt == baseline.end()) {
+      LOG(WARNING) << it.first << ": no baseline entry, skipping ("
+                   << folly::sformat("{:.0f}", it.second) << " msg/s now);"
+                   << " run with --update_baseline to record";
+      continue;
+    }
+    const double delta = it.second / baseIt->second - 1.0;
+    const bool bad = delta < -FLAGS_threshold;
+    failed = failed || bad;
+    LOG(INFO) << folly::sformat(
+        "{}: {:.0f} msg/s, baseline {:.0f} ({:+.1f}%){}",
+        it.first,
+        it.second,
+        baseIt->second,
+        delta * 100,
+        bad ? " REGRESSION" : "");
+  }
+
+  if (failed) {
+    LOG(ERROR) << "Parser throughput regressed more than "
+               << FLAGS_threshold * 100 << "% against " << FLAGS_baseline
+               << ". If the change is intentional, re-record with"
+               << " --update_baseline.";
+    return 1;
+  }
+  return 0;
+}
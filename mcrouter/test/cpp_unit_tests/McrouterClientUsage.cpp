@@ -152,6 +152,82 @@ TEST(CarbonRouterClient, basicUsageRemoteThreadClient) {
   EXPECT_TRUE(replyReceived);
 }
 
+TEST(CarbonRouterClient, remoteThreadBatchUsage) {
+  // Demonstrates sendBatch(): a span of requests submitted at once, with
+  // a single completion callback receiving all replies in request order.
+  auto opts = defaultTestOptions();
+  opts.config_str = R"({ "route": "NullRoute" })";
+
+  auto router = CarbonRouterInstance<MemcacheRouterInfo>::init(
+      "remoteThreadBatchUsage", opts);
+
+  auto client = router->createClient(0 /* max_outstanding_requests */);
+
+  // As with send(), the requests must be kept alive until the callback
+  // has been called.
+  std::vector<McGetRequest> requests;
+  for (size_t i = 0; i < 10; ++i) {
+    requests.emplace_back(folly::to<std::string>("key", i));
+  }
+
+  bool repliesReceived = false;
+  folly::fibers::Baton baton;
+
+  client->sendBatch(
+      requests.begin(),
+      requests.end(),
+      [&baton, &repliesReceived](std::vector<McGetReply>&& replies) {
+        EXPECT_EQ(10, replies.size());
+        for (const auto& reply : replies) {
+          EXPECT_EQ(mc_res_notfound, reply.result());
+        }
+        repliesReceived = true;
+        baton.post();
+      });
+
+  baton.wait();
+  router->shutdown();
+  EXPECT_TRUE(repliesReceived);
+}
+
+TEST(CarbonRouterClient, completionQueueUsage) {
+  // Demonstrates the completion-queue mode: requests are still routed on
+  // the proxy thread, but the callback runs on the caller thread when the
+  // caller drains the queue, instead of on the proxy thread.
+  auto opts = defaultTestOptions();
+  opts.config_str = R"({ "route": "NullRoute" })";
+
+  auto router = CarbonRouterInstance<MemcacheRouterInfo>::init(
+      "completionQueueUsage", opts);
+
+  auto client = router->createClient(0 /* max_outstanding_requests */);
+
+  // The queue is caller-owned and must outlive all outstanding requests.
+  facebook::memcache::mcrouter::ClientCompletionQueue completions(16);
+  client->setCompletionQueue(&completions);
+
+  const McGetRequest req("key");
+  bool replyReceived = false;
+  const auto callerThreadId = std::this_thread::get_id();
+
+  client->send(
+      req,
+      [&replyReceived, callerThreadId](
+          const McGetRequest&, McGetReply&& reply) {
+        EXPECT_EQ(mc_res_notfound, reply.result());
+        EXPECT_EQ(callerThreadId, std::this_thread::get_id());
+        replyReceived = true;
+      });
+
+  // The callback only runs once we drain; poll until the completion shows
+  // up in the queue.
+  while (completions.drain() == 0) {
+    std::this_thread::yield();
+  }
+  router->shutdown();
+  EXPECT_TRUE(replyReceived);
+}
+
 TEST(CarbonRouterClient, remoteThreadStatsRequestUsage) {
   // This test is a lot like the previous one, except this test demonstrates
   // how to collect libmcrouter stats using the McStatsRequest.
@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2016-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <folly/json.h>
+
+#include "mcrouter/AsyncLogFormat.h"
+
+using namespace facebook::memcache::mcrouter::asynclog;
+
+namespace {
+
+Record makeRecord() {
+  Record record;
+  record.timestampMs = 1289416829836ULL;
+  record.port = 11302;
+  record.flavor = "web";
+  record.host = "10.0.0.1";
+  record.pool = "pool_name";
+  record.key = "foo";
+  return record;
+}
+
+} // anonymous namespace
+
+TEST(AsyncLogFormat, round_trip) {
+  std::string buf;
+  appendRecord(makeRecord(), buf);
+
+  Record decoded;
+  size_t consumed = 0;
+  EXPECT_TRUE(decodeRecord(buf, decoded, consumed));
+  EXPECT_EQ(buf.size(), consumed);
+  EXPECT_EQ(1289416829836ULL, decoded.timestampMs);
+  EXPECT_EQ(11302, decoded.port);
+  EXPECT_EQ("web", decoded.flavor);
+  EXPECT_EQ("10.0.0.1", decoded.host);
+  EXPECT_EQ("pool_name", decoded.pool);
+  EXPECT_EQ("foo", decoded.key);
+}
+
+TEST(AsyncLogFormat, multiple_records) {
+  std::string buf;
+  auto record = makeRecord();
+  appendRecord(record, buf);
+  record.key = "bar";
+  appendRecord(record, buf);
+
+  folly::StringPiece remaining(buf);
+  Record decoded;
+  size_t consumed = 0;
+  EXPECT_TRUE(decodeRecord(remaining, decoded, consumed));
+  EXPECT_EQ("foo", decoded.key);
+  remaining.advance(consumed);
+  EXPECT_TRUE(decodeRecord(remaining, decoded, consumed));
+  EXPECT_EQ("bar", decoded.key);
+  remaining.advance(consumed);
+  EXPECT_TRUE(remaining.empty());
+}
+
+TEST(AsyncLogFormat, truncated_tail) {
+  std::string buf;
+  appendRecord(makeRecord(), buf);
+
+  // A crashed writer leaves an incomplete record: any prefix must be
+  // rejected without touching memory past the buffer.
+  Record decoded;
+  size_t consumed = 0;
+  for (size_t len = 0; len < buf.size(); ++len) {
+    EXPECT_FALSE(
+        decodeRecord(folly::StringPiece(buf.data(), len), decoded, consumed));
+  }
+}
+
+TEST(AsyncLogFormat, bad_magic) {
+  std::string buf;
+  appendRecord(makeRecord(), buf);
+  buf[0] ^= 0xff;
+
+  Record decoded;
+  size_t consumed = 0;
+  EXPECT_FALSE(decodeRecord(buf, decoded, consumed));
+}
+
+TEST(AsyncLogFormat, to_dynamic) {
+  auto line = toDynamic(makeRecord());
+  EXPECT_EQ("AS2.0", line[0].getString());
+  EXPECT_DOUBLE_EQ(1289416829.836, line[1].getDouble());
+  EXPECT_EQ("C", line[2].getString());
+  EXPECT_EQ("web", line[3]["f"].getString());
+  EXPECT_EQ("[10.0.0.1]:11302", line[3]["h"].getString());
+  EXPECT_EQ("pool_name", line[3]["p"].getString());
+  EXPECT_EQ("foo", line[3]["k"].getString());
+}
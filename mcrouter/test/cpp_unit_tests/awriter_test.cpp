@@ -240,3 +240,25 @@ TEST(awriter, invalid_fd) {
 
   EXPECT_EQ(testCounter.failure, num_entries);
 }
+
+// Test that the pool maps a shard key to a stable writer and that all
+// writers run the functions handed to them.
+TEST(awriter, pool_sharding) {
+  const size_t num_writers = 3;
+  AsyncWriterPool pool(num_writers, "awriter:pool");
+  EXPECT_EQ(num_writers, pool.numWriters());
+
+  // Same key always lands on the same writer.
+  for (size_t key = 0; key < num_writers; key++) {
+    EXPECT_EQ(&pool.writer(key), &pool.writer(key + num_writers));
+  }
+
+  counts testCounter;
+  const int num_entries = 9;
+  for (int i = 0; i < num_entries; i++) {
+    EXPECT_TRUE(
+        pool.writer(i).run([&testCounter]() { testCounter.cnt.notify(1); }));
+  }
+
+  testCounter.cnt.wait([](int v) { return v >= num_entries; });
+}
@@ -0,0 +1,71 @@
+/*
+ *  Copyright (c) Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <folly/dynamic.h>
+
+#include "mcrouter/ConfigArtifactCache.h"
+
+using facebook::memcache::mcrouter::ConfigArtifactCache;
+
+namespace {
+
+size_t buildCount = 0;
+
+std::shared_ptr<const std::string> buildArtifact(const folly::dynamic& json) {
+  ++buildCount;
+  return std::make_shared<const std::string>(folly::toJson(json));
+}
+
+} // anonymous namespace
+
+TEST(ConfigArtifactCache, dedupes_identical_json) {
+  ConfigArtifactCache<std::string> cache;
+  buildCount = 0;
+
+  folly::dynamic json = folly::dynamic::object("123", 5)("456", 7);
+  auto a = cache.get(json, buildArtifact);
+  auto b = cache.get(json, buildArtifact);
+
+  EXPECT_EQ(1, buildCount);
+  EXPECT_EQ(a.get(), b.get());
+
+  // Key order doesn't matter: the key is the sorted serialization.
+  folly::dynamic reordered = folly::dynamic::object("456", 7)("123", 5);
+  EXPECT_EQ(a.get(), cache.get(reordered, buildArtifact).get());
+  EXPECT_EQ(1, buildCount);
+}
+
+TEST(ConfigArtifactCache, distinct_json_builds_distinct_artifacts) {
+  ConfigArtifactCache<std::string> cache;
+  buildCount = 0;
+
+  auto a = cache.get(folly::dynamic::object("123", 5), buildArtifact);
+  auto b = cache.get(folly::dynamic::object("123", 6), buildArtifact);
+
+  EXPECT_EQ(2, buildCount);
+  EXPECT_NE(a.get(), b.get());
+}
+
+TEST(ConfigArtifactCache, entries_expire_with_last_reference) {
+  ConfigArtifactCache<std::string> cache;
+  buildCount = 0;
+
+  folly::dynamic json = folly::dynamic::object("123", 5);
+  cache.get(json, buildArtifact);
+  EXPECT_EQ(1, buildCount);
+
+  // The artifact was released above, so this is a rebuild, not a hit.
+  auto rebuilt = cache.get(json, buildArtifact);
+  EXPECT_EQ(2, buildCount);
+  EXPECT_EQ(rebuilt.get(), cache.get(json, buildArtifact).get());
+  EXPECT_EQ(2, buildCount);
+}
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include "mcrouter/DestinationHealth.h"
+
+using facebook::memcache::mcrouter::DestinationHealth;
+
+TEST(DestinationHealth, startsFullyHealthy) {
+  DestinationHealth health;
+  EXPECT_DOUBLE_EQ(1.0, health.score());
+}
+
+TEST(DestinationHealth, healthyTrafficKeepsScoreHigh) {
+  DestinationHealth health;
+  for (size_t i = 0; i < 1000; ++i) {
+    health.recordReply(mc_res_found, /* slowLatency */ false, 0.0);
+  }
+  EXPECT_DOUBLE_EQ(1.0, health.score());
+}
+
+TEST(DestinationHealth, errorsDragScoreDown) {
+  DestinationHealth health;
+  for (size_t i = 0; i < 1000; ++i) {
+    health.recordReply(mc_res_timeout, /* slowLatency */ false, 0.0);
+  }
+  EXPECT_GT(0.05, health.score());
+
+  // Recovery as good replies come back.
+  for (size_t i = 0; i < 1000; ++i) {
+    health.recordReply(mc_res_found, /* slowLatency */ false, 0.0);
+  }
+  EXPECT_LT(0.95, health.score());
+}
+
+TEST(DestinationHealth, tkoZeroesScore) {
+  DestinationHealth health;
+  health.recordReply(mc_res_found, /* slowLatency */ false, 0.0);
+  health.recordTko(true);
+  EXPECT_DOUBLE_EQ(0.0, health.score());
+
+  // Untko alone recovers the score; the soft signals were still clean.
+  health.recordTko(false);
+  EXPECT_DOUBLE_EQ(1.0, health.score());
+}
+
+TEST(DestinationHealth, softSignalsScaleByAtMostHalf) {
+  DestinationHealth slow;
+  for (size_t i = 0; i < 1000; ++i) {
+    slow.recordReply(mc_res_found, /* slowLatency */ true, 0.0);
+  }
+  EXPECT_NEAR(0.5, slow.score(), 0.01);
+
+  DestinationHealth loaded;
+  for (size_t i = 0; i < 1000; ++i) {
+    loaded.recordReply(mc_res_found, /* slowLatency */ false, 100.0);
+  }
+  EXPECT_NEAR(0.5, loaded.score(), 0.01);
+
+  // An erroring destination scores below either soft signal alone.
+  DestinationHealth erroring;
+  for (size_t i = 0; i < 1000; ++i) {
+    erroring.recordReply(mc_res_connect_error, /* slowLatency */ false, 0.0);
+  }
+  EXPECT_GT(slow.score(), erroring.score());
+  EXPECT_GT(loaded.score(), erroring.score());
+}
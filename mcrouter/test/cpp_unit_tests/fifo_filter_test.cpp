@@ -0,0 +1,119 @@
+/*
+ *  Copyright (c) 2015-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <folly/Range.h>
+
+#include "mcrouter/lib/debug/FifoFilter.h"
+
+using facebook::memcache::FifoFilter;
+
+namespace {
+
+std::vector<iovec> buildIovs(const std::vector<folly::StringPiece>& bufs) {
+  std::vector<iovec> iovs;
+  for (const auto& buf : bufs) {
+    iovec iov;
+    iov.iov_base = const_cast<char*>(buf.data());
+    iov.iov_len = buf.size();
+    iovs.push_back(iov);
+  }
+  return iovs;
+}
+
+bool matches(const FifoFilter& filter, std::vector<folly::StringPiece> bufs) {
+  auto iovs = buildIovs(bufs);
+  return filter.matchesData(iovs.data(), iovs.size());
+}
+
+} // anonymous namespace
+
+TEST(FifoFilter, matches_type_id) {
+  FifoFilter any;
+  EXPECT_TRUE(any.matchesTypeId(1));
+  EXPECT_TRUE(any.matchesTypeId(2));
+
+  FifoFilter requestFilter;
+  requestFilter.typeId = 3;
+  EXPECT_TRUE(requestFilter.matchesTypeId(3));
+  // Paired reply type is captured too.
+  EXPECT_TRUE(requestFilter.matchesTypeId(4));
+  EXPECT_FALSE(requestFilter.matchesTypeId(1));
+  EXPECT_FALSE(requestFilter.matchesTypeId(5));
+
+  FifoFilter replyFilter;
+  replyFilter.typeId = 4;
+  EXPECT_TRUE(replyFilter.matchesTypeId(4));
+  EXPECT_FALSE(replyFilter.matchesTypeId(3));
+  EXPECT_FALSE(replyFilter.matchesTypeId(5));
+}
+
+TEST(FifoFilter, matches_data) {
+  FifoFilter filter;
+  filter.dataPattern = "foo:bar";
+
+  EXPECT_TRUE(matches(filter, {"get foo:bar:1\r\n"}));
+  EXPECT_FALSE(matches(filter, {"get baz:1\r\n"}));
+  EXPECT_FALSE(matches(filter, {}));
+
+  // Empty pattern matches anything.
+  FifoFilter empty;
+  EXPECT_TRUE(matches(empty, {"get baz:1\r\n"}));
+}
+
+TEST(FifoFilter, matches_data_iovec_boundaries) {
+  FifoFilter filter;
+  filter.dataPattern = "foo:bar";
+
+  // Pattern straddling two iovecs.
+  EXPECT_TRUE(matches(filter, {"get foo:b", "ar:1\r\n"}));
+  // Pattern straddling several tiny iovecs.
+  EXPECT_TRUE(matches(filter, {"get f", "oo", ":", "ba", "r:1\r\n"}));
+  // Almost-matches must not be found.
+  EXPECT_FALSE(matches(filter, {"get foo:b", "az:1\r\n"}));
+
+  // Single-byte pattern.
+  FifoFilter byteFilter;
+  byteFilter.dataPattern = "x";
+  EXPECT_TRUE(matches(byteFilter, {"ab", "xc"}));
+  EXPECT_FALSE(matches(byteFilter, {"ab", "cd"}));
+}
+
+TEST(FifoFilter, spec_round_trip) {
+  FifoFilter filter;
+  filter.typeId = 7;
+  filter.dataPattern = "foo:bar";
+
+  auto parsed = FifoFilter::fromString(filter.toString());
+  ASSERT_TRUE(parsed != nullptr);
+  EXPECT_EQ(7, parsed->typeId);
+  EXPECT_EQ("foo:bar", parsed->dataPattern);
+}
+
+TEST(FifoFilter, spec_parsing) {
+  // No constraints -> nullptr, i.e. capture everything.
+  EXPECT_EQ(nullptr, FifoFilter::fromString(""));
+  EXPECT_EQ(nullptr, FifoFilter::fromString("some garbage\n"));
+  EXPECT_EQ(nullptr, FifoFilter::fromString("type_id = garbage\n"));
+
+  // Unknown names and blank lines are ignored.
+  auto parsed = FifoFilter::fromString(
+      "\nfuture_name = value\n  data_pattern =  foo:bar \n");
+  ASSERT_TRUE(parsed != nullptr);
+  EXPECT_EQ(0, parsed->typeId);
+  EXPECT_EQ("foo:bar", parsed->dataPattern);
+}
+
+TEST(FifoFilter, filter_path) {
+  EXPECT_EQ(
+      "/var/mcrouter/fifos/debug.1234.filter",
+      FifoFilter::getFilterPath("/var/mcrouter/fifos/debug.1234"));
+}
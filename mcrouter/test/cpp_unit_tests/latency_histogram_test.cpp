@@ -0,0 +1,71 @@
+/*
+ *  Copyright (c) 2015-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include "mcrouter/LatencyHistogram.h"
+
+using facebook::memcache::mcrouter::LatencyHistogram;
+
+TEST(LatencyHistogram, empty) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.totalSamples());
+  EXPECT_EQ(0, histogram.estimatePercentile(99.9));
+}
+
+TEST(LatencyHistogram, small_values_exact) {
+  LatencyHistogram histogram;
+  for (uint64_t v = 0; v < 16; ++v) {
+    histogram.insertSample(v);
+  }
+  EXPECT_EQ(16, histogram.totalSamples());
+  EXPECT_EQ(0, histogram.estimatePercentile(0.0));
+  EXPECT_EQ(7, histogram.estimatePercentile(50.0));
+  EXPECT_EQ(15, histogram.estimatePercentile(100.0));
+}
+
+TEST(LatencyHistogram, relative_error_bound) {
+  LatencyHistogram histogram;
+  // p100 must come back within 12.5% of the exact max, at any magnitude.
+  for (uint64_t v = 17; v < (uint64_t(1) << 39); v = v * 2 + 1) {
+    LatencyHistogram single;
+    single.insertSample(v);
+    auto est = single.estimatePercentile(100.0);
+    EXPECT_GE(est, v);
+    EXPECT_LE(est, v + v / 8);
+  }
+}
+
+TEST(LatencyHistogram, tail_percentile) {
+  LatencyHistogram histogram;
+  // 998 fast requests and two slow outliers: p99.9 has to find the outlier
+  // region while p50 stays near the bulk of the distribution.
+  for (int i = 0; i < 998; ++i) {
+    histogram.insertSample(1000);
+  }
+  histogram.insertSample(500000);
+  histogram.insertSample(500000);
+  EXPECT_EQ(1000, histogram.totalSamples());
+  auto p50 = histogram.estimatePercentile(50.0);
+  EXPECT_GE(p50, 1000);
+  EXPECT_LE(p50, 1125);
+  auto p999 = histogram.estimatePercentile(99.9);
+  EXPECT_GE(p999, 500000);
+  EXPECT_LE(p999, 562500);
+}
+
+TEST(LatencyHistogram, accumulate) {
+  LatencyHistogram a;
+  LatencyHistogram b;
+  a.insertSample(100);
+  b.insertSample(200);
+  a.accumulate(b);
+  EXPECT_EQ(2, a.totalSamples());
+  EXPECT_GE(a.estimatePercentile(100.0), 200);
+  // b is untouched.
+  EXPECT_EQ(1, b.totalSamples());
+}
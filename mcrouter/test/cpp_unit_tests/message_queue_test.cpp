@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "mcrouter/lib/MessageQueue.h"
+
+using facebook::memcache::MessageQueue;
+
+namespace {
+
+int64_t nowUs() {
+  return 0;
+}
+
+struct QueueWithLog {
+  std::vector<int> drained;
+  MessageQueue<int> queue;
+
+  explicit QueueWithLog(size_t capacity = 1024)
+      : queue(
+            capacity,
+            [this](int&& value) { drained.push_back(value); },
+            /* noNotifyRate */ 0,
+            /* waitThreshold */ 0,
+            &nowUs,
+            /* notifyCallback */ nullptr) {}
+};
+
+struct SortedQueueWithLog {
+  std::vector<int> drained;
+  MessageQueue<int> queue;
+
+  SortedQueueWithLog()
+      : queue(
+            /* capacity */ 1024,
+            [this](int&& value) { drained.push_back(value); },
+            /* noNotifyRate */ 0,
+            /* waitThreshold */ 0,
+            &nowUs,
+            /* notifyCallback */ nullptr,
+            /* postDrainCallback */ nullptr,
+            /* spinPollUs */ 0,
+            /* drainSortKey: group by ones digit */
+            [](const int& value) { return uint64_t(value % 10); }) {}
+};
+
+} // anonymous namespace
+
+TEST(MessageQueue, drains_in_fifo_order) {
+  QueueWithLog q;
+  for (int i = 0; i < 5; ++i) {
+    q.queue.blockingWriteRelaxed(i);
+  }
+  q.queue.drain();
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), q.drained);
+}
+
+TEST(MessageQueue, high_priority_lane_drains_first) {
+  QueueWithLog q;
+  q.queue.blockingWriteRelaxed(1);
+  q.queue.blockingWriteRelaxed(2);
+  q.queue.blockingWriteRelaxedHighPriority(100);
+  q.queue.blockingWriteRelaxedHighPriority(101);
+  q.queue.drain();
+  EXPECT_EQ((std::vector<int>{100, 101, 1, 2}), q.drained);
+}
+
+TEST(MessageQueue, high_priority_lane_cannot_starve_normal_lane) {
+  // With more than a burst's worth of high-priority messages queued, one
+  // normal message is let through after 64 consecutive high ones.
+  QueueWithLog q;
+  q.queue.blockingWriteRelaxed(-1);
+  for (int i = 0; i < 100; ++i) {
+    q.queue.blockingWriteRelaxedHighPriority(i);
+  }
+  q.queue.drain();
+
+  ASSERT_EQ(101, q.drained.size());
+  EXPECT_EQ(-1, q.drained[64]);
+  for (int i = 0; i < 64; ++i) {
+    EXPECT_EQ(i, q.drained[i]);
+  }
+  for (int i = 65; i < 101; ++i) {
+    EXPECT_EQ(i - 1, q.drained[i]);
+  }
+}
+
+TEST(MessageQueue, sorted_drain_groups_by_key) {
+  SortedQueueWithLog q;
+  q.queue.blockingWriteRelaxed(11);
+  q.queue.blockingWriteRelaxed(22);
+  q.queue.blockingWriteRelaxed(31);
+  q.queue.blockingWriteRelaxed(42);
+  q.queue.blockingWriteRelaxed(51);
+  q.queue.drain();
+  // Grouped by ones digit; arrival order preserved within a group.
+  EXPECT_EQ((std::vector<int>{11, 31, 51, 22, 42}), q.drained);
+}
+
+TEST(MessageQueue, sorted_drain_is_chunked) {
+  // More than one sorting chunk's (128) worth of messages: grouping only
+  // happens within a chunk, so the second chunk's messages all drain
+  // after the first chunk's regardless of key.
+  SortedQueueWithLog q;
+  for (int i = 0; i < 128; ++i) {
+    q.queue.blockingWriteRelaxed(101); // key 1
+  }
+  q.queue.blockingWriteRelaxed(100); // key 0, lands in the second chunk
+  q.queue.drain();
+  ASSERT_EQ(129, q.drained.size());
+  EXPECT_EQ(101, q.drained[0]);
+  EXPECT_EQ(100, q.drained[128]);
+}
+
+TEST(MessageQueue, unbounded_mode_respects_lanes) {
+  QueueWithLog q(/* capacity */ 0);
+  q.queue.blockingWriteRelaxed(1);
+  q.queue.blockingWriteRelaxedHighPriority(100);
+  q.queue.blockingWriteRelaxed(2);
+  q.queue.drain();
+  EXPECT_EQ((std::vector<int>{100, 1, 2}), q.drained);
+}
@@ -50,3 +50,27 @@ TEST(OptionsSetFromDictTest, sanity) {
   /* unchanged */
   EXPECT_TRUE(opts.num_proxies == 4);
 }
+
+TEST(OptionsSetFromDictTest, runtimeMutable) {
+  McrouterOptions opts;
+  unordered_map<string, string> dict;
+
+  /* non-mutable options are silently ignored */
+  dict["num_proxies"] = "4";
+  dict["probe_delay_max_ms"] = "30000";
+  auto e = opts.updateRuntimeMutableFromDict(dict);
+  EXPECT_TRUE(e.empty());
+  EXPECT_TRUE(opts.num_proxies == 1);
+  EXPECT_TRUE(opts.probe_delay_max_ms == 30000);
+
+  /* parse errors for mutable options are surfaced */
+  dict.clear();
+  dict["probe_delay_max_ms"] = "a";
+  e = opts.updateRuntimeMutableFromDict(dict);
+  EXPECT_EQ(e.size(), 1);
+  EXPECT_EQ(e[0].requestedName, "probe_delay_max_ms");
+  EXPECT_TRUE(opts.probe_delay_max_ms == 30000);
+
+  EXPECT_FALSE(McrouterOptions::isRuntimeMutable("num_proxies"));
+  EXPECT_TRUE(McrouterOptions::isRuntimeMutable("probe_delay_max_ms"));
+}
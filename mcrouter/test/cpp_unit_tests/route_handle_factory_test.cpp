@@ -114,3 +114,23 @@ TEST(RouteHandleFactoryTest, sanity) {
     EXPECT_TRUE(isErrorResult(reply.result()));
   });
 }
+
+TEST(RouteHandleFactoryTest, hashConsing) {
+  auto router = getTestRouter();
+  auto proxy = router->getProxy(0);
+  PoolFactory pf(folly::dynamic::object(), router->configApi());
+  McRouteHandleProvider<MemcacheRouterInfo> provider(*proxy, pf);
+  RouteHandleFactory<MemcacheRouteHandleIf> factory(provider, proxy->getId());
+
+  // Structurally identical anonymous definitions share one instance.
+  const auto def = folly::dynamic::object("type", "HashRoute")(
+      "children", folly::dynamic::array("ErrorRoute", "NullRoute"));
+  auto a = factory.create(folly::dynamic(def));
+  auto b = factory.create(folly::dynamic(def));
+  EXPECT_EQ(a.get(), b.get());
+
+  // Different definitions still get distinct instances.
+  auto c = factory.create(folly::dynamic::object("type", "HashRoute")(
+      "children", folly::dynamic::array("ErrorRoute")));
+  EXPECT_NE(a.get(), c.get());
+}
@@ -0,0 +1,42 @@
+/*
+ *  Copyright (c) 2016-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include "mcrouter/RouteHandleProfiler.h"
+
+using facebook::memcache::mcrouter::RouteHandleProfiler;
+
+TEST(RouteHandleProfiler, disabled) {
+  RouteHandleProfiler profiler;
+  EXPECT_FALSE(profiler.shouldSample(1000000, 0));
+  EXPECT_FALSE(profiler.shouldSample(2000000, 0));
+}
+
+TEST(RouteHandleProfiler, rate_limiting) {
+  RouteHandleProfiler profiler;
+  // At 10 Hz samples are at least 100ms apart.
+  EXPECT_TRUE(profiler.shouldSample(1000000, 10));
+  EXPECT_FALSE(profiler.shouldSample(1050000, 10));
+  EXPECT_FALSE(profiler.shouldSample(1099999, 10));
+  EXPECT_TRUE(profiler.shouldSample(1100000, 10));
+}
+
+TEST(RouteHandleProfiler, record_and_clear) {
+  RouteHandleProfiler profiler;
+  profiler.recordPath("proxy;failover|a", 100);
+  profiler.recordPath("proxy;failover|a", 50);
+  profiler.recordPath("proxy;hash|b", 10);
+
+  auto weights = profiler.getWeights();
+  EXPECT_EQ(2, weights.size());
+  EXPECT_EQ(150, weights.at("proxy;failover|a"));
+  EXPECT_EQ(10, weights.at("proxy;hash|b"));
+
+  profiler.clear();
+  EXPECT_TRUE(profiler.getWeights().empty());
+}
@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2016-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <cstdio>
+#include <string>
+
+#include <folly/FileUtil.h>
+#include <folly/Range.h>
+#include <folly/json.h>
+
+#include "mcrouter/AsyncLogFormat.h"
+
+using namespace facebook::memcache::mcrouter;
+
+/**
+ * Dumps asynclog version 3 binary spool files as asynclog version 2.0
+ * JSON lines on stdout, so binary spools can be replayed through
+ * consumers that only understand the JSON formats.
+ */
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s SPOOL_FILE...\n", argv[0]);
+    return 1;
+  }
+
+  int exitCode = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::string contents;
+    if (!folly::readFile(argv[i], contents)) {
+      fprintf(stderr, "%s: can't read %s\n", argv[0], argv[i]);
+      exitCode = 1;
+      continue;
+    }
+
+    folly::StringPiece buf(contents);
+    asynclog::Record record;
+    size_t consumed = 0;
+    while (asynclog::decodeRecord(buf, record, consumed)) {
+      auto line = folly::toJson(asynclog::toDynamic(record));
+      fwrite(line.data(), 1, line.size(), stdout);
+      fputc('\n', stdout);
+      buf.advance(consumed);
+    }
+    if (!buf.empty()) {
+      // A crashed writer can leave a truncated record at the tail; every
+      // complete record before it was already printed.
+      fprintf(
+          stderr,
+          "%s: ignored %zu trailing bytes of %s\n",
+          argv[0],
+          buf.size(),
+          argv[i]);
+      exitCode = 1;
+    }
+  }
+  return exitCode;
+}
@@ -10,14 +10,18 @@
 #include <fcntl.h>
 
 #include <algorithm>
+#include <cstdio>
 #include <cstring>
 #include <vector>
 
 #include <boost/filesystem.hpp>
 #include <boost/regex.hpp>
 
+#include <folly/FileUtil.h>
 #include <folly/io/async/EventBase.h>
 
+#include "mcrouter/lib/debug/FifoFilter.h"
+
 namespace fs = boost::filesystem;
 
 namespace facebook {
@@ -153,6 +157,18 @@ void FifoReadCallback::readDataAvailable(size_t len) noexcept {
 }
 
 void FifoReadCallback::handleMessageHeader(MessageHeader msgHeader) noexcept {
+  if (msgHeader.version() >= 5) {
+    const auto seqId = msgHeader.msgSequenceId();
+    if (seenSequenceId_ && seqId > nextExpectedSequenceId_) {
+      const auto lost = seqId - nextExpectedSequenceId_;
+      lostMessages_ += lost;
+      VLOG(1) << "Fifo \"" << fifoName_ << "\": " << lost
+              << " message(s) dropped by the router (" << lostMessages_
+              << " total)";
+    }
+    seenSequenceId_ = true;
+    nextExpectedSequenceId_ = seqId + 1;
+  }
   from_ = msgHeader.getLocalAddress();
   to_ = msgHeader.getPeerAddress();
   typeId_ = msgHeader.typeId();
@@ -191,6 +207,10 @@ void FifoReadCallback::forwardMessage(
 
 void FifoReadCallback::readEOF() noexcept {
   LOG(INFO) << "Fifo \"" << fifoName_ << "\" disconnected";
+  if (lostMessages_ > 0) {
+    LOG(INFO) << "Fifo \"" << fifoName_ << "\": " << lostMessages_
+              << " message(s) were dropped by the router during this session";
+  }
 }
 
 void FifoReadCallback::readErr(const folly::AsyncSocketException& e) noexcept {
@@ -201,14 +221,24 @@ FifoReaderManager::FifoReaderManager(
     folly::EventBase& evb,
     MessageReadyFn messageReady,
     std::string dir,
-    std::unique_ptr<boost::regex> filenamePattern)
+    std::unique_ptr<boost::regex> filenamePattern,
+    std::string pushdownFilterSpec)
     : evb_(evb),
       messageReady_(std::move(messageReady)),
       directory_(std::move(dir)),
-      filenamePattern_(std::move(filenamePattern)) {
+      filenamePattern_(std::move(filenamePattern)),
+      pushdownFilterSpec_(std::move(pushdownFilterSpec)) {
   runScanDirectory();
 }
 
+FifoReaderManager::~FifoReaderManager() {
+  for (const auto& filterFile : filterFiles_) {
+    if (::remove(filterFile.c_str()) != 0) {
+      PLOG(WARNING) << "Error removing fifo filter file: " << filterFile;
+    }
+  }
+}
+
 std::vector<std::string> FifoReaderManager::getMatchedFiles() const {
   std::vector<std::string> fifos;
 
@@ -224,6 +254,12 @@ std::vector<std::string> FifoReaderManager::getMatchedFiles() const {
           continue;
         }
         auto& path = it->path();
+        if (folly::StringPiece(path.filename().string())
+                .endsWith(kFifoFilterSuffix)) {
+          // Filter spec files live next to the fifos; don't read them
+          // back as fifos.
+          continue;
+        }
         if (!filenamePattern_ || boost::regex_search(
                                      path.filename().string(),
                                      *filenamePattern_,
@@ -245,6 +281,21 @@ void FifoReaderManager::runScanDirectory() {
     if (fifoReaders_.find(fifo) != fifoReaders_.end()) {
       continue;
     }
+    // The filter spec must be in place before we open the fifo: the
+    // router loads it at the moment it manages to connect, which cannot
+    // happen before the read end is open.
+    auto filterPath = FifoFilter::getFilterPath(fifo);
+    if (!pushdownFilterSpec_.empty()) {
+      if (folly::writeFile(pushdownFilterSpec_, filterPath.c_str())) {
+        filterFiles_.push_back(std::move(filterPath));
+      } else {
+        PLOG(WARNING) << "Error writing fifo filter file: " << filterPath;
+      }
+    } else {
+      // Clean up anything a previous reader left behind, so this
+      // session captures everything.
+      ::remove(filterPath.c_str());
+    }
     auto fd = ::open(fifo.c_str(), O_RDONLY | O_NONBLOCK);
     if (fd >= 0) {
       auto pipeReader = folly::AsyncPipeReader::UniquePtr(
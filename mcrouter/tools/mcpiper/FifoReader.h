@@ -85,6 +85,13 @@ class FifoReadCallback : public folly::AsyncReader::ReadCallback {
   // Name of the carbon router.
   std::string carbonRouterName_;
 
+  // Loss accounting, based on the per-message sequence number carried by
+  // protocol version 5+ headers. A gap means the router dropped messages
+  // (fifo full or capture quota exceeded).
+  bool seenSequenceId_{false};
+  uint64_t nextExpectedSequenceId_{0};
+  uint64_t lostMessages_{0};
+
   void forwardMessage(
       const PacketHeader& header,
       std::unique_ptr<folly::IOBuf> buf);
@@ -109,12 +116,23 @@ class FifoReaderManager {
    *                        read from the fifo.
    * @param dir             Directory to watch.
    * @param filenamePattern Regex that file names must match.
+   * @param pushdownFilterSpec  Serialized FifoFilter spec to push down to
+   *                        the fifo writers (see FifoFilter::toString()).
+   *                        For each fifo found, the spec is written to
+   *                        the fifo's filter file before the fifo is
+   *                        opened, so the router evaluates the filter
+   *                        before copying any data. If empty, stale
+   *                        filter files of previous readers are removed
+   *                        instead.
    */
   FifoReaderManager(
       folly::EventBase& evb,
       MessageReadyFn messageReady,
       std::string dir,
-      std::unique_ptr<boost::regex> filenamePattern);
+      std::unique_ptr<boost::regex> filenamePattern,
+      std::string pushdownFilterSpec = "");
+
+  ~FifoReaderManager();
 
   // non-copyable
   FifoReaderManager(const FifoReaderManager&) = delete;
@@ -135,7 +153,10 @@ class FifoReaderManager {
   MessageReadyFn messageReady_;
   const std::string directory_;
   const std::unique_ptr<boost::regex> filenamePattern_;
+  const std::string pushdownFilterSpec_;
   std::unordered_map<std::string, FifoReader> fifoReaders_;
+  // Filter files written by this reader; removed on destruction.
+  std::vector<std::string> filterFiles_;
 
   std::vector<std::string> getMatchedFiles() const;
   void runScanDirectory();
@@ -9,6 +9,7 @@
 
 #include <unordered_set>
 
+#include "mcrouter/lib/debug/FifoFilter.h"
 #include "mcrouter/lib/network/CarbonMessageList.h"
 #include "mcrouter/tools/mcpiper/FifoReader.h"
 #include "mcrouter/tools/mcpiper/MessagePrinter.h"
@@ -134,6 +135,16 @@ void McPiper::run(Settings settings, std::ostream& targetOut) {
     std::cerr << "Filename pattern: " << *filenamePattern << std::endl;
   }
 
+  // Builds the filter spec pushed down to the routers, so that they
+  // evaluate it before copying any data into the fifos.
+  std::string pushdownFilterSpec;
+  if (!settings.keyPattern.empty()) {
+    FifoFilter pushdownFilter;
+    pushdownFilter.dataPattern = settings.keyPattern;
+    pushdownFilterSpec = pushdownFilter.toString();
+    std::cerr << "In-router filter: " << settings.keyPattern << std::endl;
+  }
+
   messagePrinter_ = std::make_unique<MessagePrinter>(
       getOptions(settings, this),
       getFilter(settings),
@@ -183,7 +194,8 @@ void McPiper::run(Settings settings, std::ostream& targetOut) {
       eventBase_,
       fifoReaderCallback,
       settings.fifoRoot,
-      std::move(filenamePattern));
+      std::move(filenamePattern),
+      std::move(pushdownFilterSpec));
 
   while (running_) {
     eventBase_.loopOnce();
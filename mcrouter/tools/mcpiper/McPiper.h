@@ -30,6 +30,7 @@ struct Settings {
   std::string host;
   bool ignoreCase{false};
   bool invertMatch{false};
+  std::string keyPattern;
   uint32_t maxMessages{0};
   uint32_t numAfterMatch{0};
   uint16_t port{0};
@@ -79,6 +79,14 @@ Settings parseOptions(int argc, char** argv) {
       "invert-match,v",
       po::bool_switch(&settings.invertMatch)->default_value(false),
       "Invert match")(
+      "key-pattern,k",
+      po::value<std::string>(&settings.keyPattern),
+      "Only capture messages whose raw data contains this byte pattern "
+      "(typically a key prefix). The filter is pushed down to the "
+      "routers, which then skip copying non-matching traffic into the "
+      "fifos; routers that predate this option ignore it. Note that "
+      "replies that don't echo the pattern (e.g. caret delete replies) "
+      "are not captured.")(
       "max-messages,n",
       po::value<uint32_t>(&settings.maxMessages),
       "Display only <arg> messages and exit.")(
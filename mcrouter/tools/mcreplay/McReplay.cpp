@@ -0,0 +1,335 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include "McReplay.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/FileUtil.h>
+#include <folly/Format.h>
+#include <folly/Range.h>
+#include <folly/fibers/Baton.h>
+
+#include "mcrouter/CarbonRouterClient.h"
+#include "mcrouter/CarbonRouterInstance.h"
+#include "mcrouter/LatencyHistogram.h"
+#include "mcrouter/config.h"
+#include "mcrouter/lib/debug/ConnectionFifoProtocol.h"
+#include "mcrouter/lib/network/CarbonMessageDispatcher.h"
+#include "mcrouter/lib/network/ServerMcParser.h"
+#include "mcrouter/lib/network/gen/Memcache.h"
+#include "mcrouter/lib/network/gen/MemcacheRouterInfo.h"
+#include "mcrouter/lib/network/gen/MemcacheServer.h"
+
+namespace facebook {
+namespace memcache {
+namespace mcreplay {
+
+namespace {
+
+using Client = mcrouter::CarbonRouterClient<MemcacheRouterInfo>;
+
+constexpr size_t kReadBufferSizeMin = 256;
+constexpr size_t kReadBufferSizeMax = 4096;
+
+struct ReplayStats {
+  // Written from the proxy thread only; read after all requests drained.
+  mcrouter::LatencyHistogram latencyUs;
+  std::atomic<size_t> remaining{0};
+  folly::fibers::Baton allDone;
+};
+
+/**
+ * Collects typed requests parsed out of the capture as type-erased send
+ * closures, stamped with the captured send time.
+ */
+class RequestCollector {
+ public:
+  using SendFn = std::function<void(Client&, ReplayStats&)>;
+
+  struct TimedRequest {
+    uint64_t capturedTimeUs;
+    SendFn send;
+  };
+
+  template <class Request>
+  void collect(Request&& req) {
+    // Control operations must not be replayed into a live instance.
+    if (std::is_same<Request, McQuitRequest>::value ||
+        std::is_same<Request, McShutdownRequest>::value ||
+        std::is_same<Request, McStatsRequest>::value ||
+        std::is_same<Request, McVersionRequest>::value) {
+      return;
+    }
+    auto shared = std::make_shared<Request>(std::move(req));
+    requests_.push_back(TimedRequest{
+        currentTimeUs_, [shared](Client& client, ReplayStats& stats) {
+          auto start = mcrouter::nowUs();
+          client.send(
+              *shared,
+              [shared, start, &stats](
+                  const Request&, ReplyT<Request>&&) {
+                stats.latencyUs.insertSample(mcrouter::nowUs() - start);
+                if (stats.remaining.fetch_sub(
+                        1, std::memory_order_acq_rel) == 1) {
+                  stats.allDone.post();
+                }
+              });
+        }});
+  }
+
+  void setCurrentTimeUs(uint64_t timeUs) {
+    currentTimeUs_ = timeUs;
+  }
+
+  std::vector<TimedRequest>& requests() {
+    return requests_;
+  }
+
+ private:
+  uint64_t currentTimeUs_{0};
+  std::vector<TimedRequest> requests_;
+};
+
+/**
+ * ServerMcParser callback that forwards every parsed request to the
+ * collector; parse errors just end the affected connection's stream.
+ */
+struct ParserCallback
+    : public CarbonMessageDispatcher<
+          memcache::detail::MemcacheRequestList,
+          ParserCallback> {
+ public:
+  explicit ParserCallback(RequestCollector& collector)
+      : collector_(collector) {}
+
+  template <class M>
+  void onTypedMessage(
+      const UmbrellaMessageInfo& /* headerInfo */,
+      const folly::IOBuf& /* reqBuffer */,
+      M&& req) {
+    collector_.collect(std::move(req));
+  }
+
+  template <class Request>
+  void onRequest(Request&& req, bool /* noreply */) {
+    collector_.collect(std::move(req));
+  }
+
+  template <class Request>
+  void umbrellaRequestReady(Request&& req, uint64_t /* msgId */) {
+    collector_.collect(std::move(req));
+  }
+
+  void caretRequestReady(
+      const UmbrellaMessageInfo& headerInfo,
+      const folly::IOBuf& buffer) {
+    this->dispatchTypedRequest(headerInfo, buffer);
+  }
+
+  void multiOpEnd() {}
+
+  void parseError(mc_res_t /* result */, folly::StringPiece reason) {
+    VLOG(1) << "Skipping rest of connection stream: " << reason;
+  }
+
+ private:
+  RequestCollector& collector_;
+};
+
+using Parser = ServerMcParser<ParserCallback>;
+
+void feedParser(Parser& parser, folly::ByteRange data) {
+  auto source = data.begin();
+  size_t size = data.size();
+  while (size > 0) {
+    auto buffer = parser.getReadBuffer();
+    size_t numBytes = std::min(buffer.second, size);
+    std::memcpy(buffer.first, source, numBytes);
+    parser.readDataAvailable(numBytes);
+    size -= numBytes;
+    source += numBytes;
+  }
+}
+
+/**
+ * Parses a raw ConnectionFifo stream: MessageHeaders (recognized by
+ * magic) carry type/time/direction for the packets that follow them.
+ * Only received messages with request type ids are replayed.
+ */
+bool parseCaptureFile(const std::string& path, RequestCollector& collector) {
+  std::string contents;
+  if (!folly::readFile(path.c_str(), contents)) {
+    LOG(ERROR) << "Cannot read capture file " << path;
+    return false;
+  }
+
+  folly::StringPiece range(contents);
+  uint32_t typeId = 0;
+  uint64_t timeUs = 0;
+  auto direction = MessageDirection::Sent;
+
+  ParserCallback callback(collector);
+  std::unordered_map<uint64_t, std::unique_ptr<Parser>> parsers;
+
+  const auto kMagic = MessageHeader().magic();
+  while (!range.empty()) {
+    if (range.size() >= sizeof(uint32_t)) {
+      uint32_t magic;
+      std::memcpy(&magic, range.data(), sizeof(uint32_t));
+      if (folly::Endian::little(magic) == kMagic) {
+        const size_t versionOffset = sizeof(uint32_t);
+        if (range.size() <= versionOffset) {
+          break;
+        }
+        const uint8_t version = range.data()[versionOffset];
+        const size_t headerSize = MessageHeader::size(version);
+        if (headerSize > sizeof(MessageHeader) ||
+            range.size() < headerSize) {
+          LOG(WARNING) << "Truncated message header; stopping";
+          break;
+        }
+        MessageHeader header;
+        std::memcpy(&header, range.data(), headerSize);
+        typeId = header.typeId();
+        timeUs = header.timeUs();
+        direction = header.direction();
+        range.advance(headerSize);
+        continue;
+      }
+    }
+
+    if (range.size() < sizeof(PacketHeader)) {
+      break;
+    }
+    PacketHeader packetHeader;
+    std::memcpy(&packetHeader, range.data(), sizeof(PacketHeader));
+    range.advance(sizeof(PacketHeader));
+    if (packetHeader.packetSize() > range.size()) {
+      LOG(WARNING) << "Truncated packet; stopping";
+      break;
+    }
+    folly::ByteRange payload(
+        reinterpret_cast<const uint8_t*>(range.data()),
+        packetHeader.packetSize());
+    range.advance(packetHeader.packetSize());
+
+    // Request type ids are odd; even ones are replies.
+    if (typeId % 2 == 1 && direction == MessageDirection::Received) {
+      auto& parser = parsers[packetHeader.connectionId()];
+      if (!parser || packetHeader.packetId() == 0) {
+        parser = std::make_unique<Parser>(
+            callback, kReadBufferSizeMin, kReadBufferSizeMax);
+      }
+      collector.setCurrentTimeUs(timeUs);
+      feedParser(*parser, payload);
+    }
+  }
+
+  return true;
+}
+
+std::string buildConfig(const ReplaySettings& settings) {
+  if (!settings.configStr.empty()) {
+    return settings.configStr;
+  }
+  return folly::sformat(
+      R"({{"route": {{"type": "PoolRoute", )"
+      R"("pool": {{"name": "replay", "servers": ["{}"]}}}}}})",
+      settings.server);
+}
+
+} // anonymous namespace
+
+int runReplay(const ReplaySettings& settings) {
+  RequestCollector collector;
+  if (!parseCaptureFile(settings.captureFile, collector)) {
+    return 1;
+  }
+  auto& requests = collector.requests();
+  if (requests.empty()) {
+    LOG(ERROR) << "No replayable requests found in "
+               << settings.captureFile;
+    return 1;
+  }
+  LOG(INFO) << "Loaded " << requests.size() << " requests from "
+            << settings.captureFile;
+
+  if (settings.shuffle) {
+    std::mt19937 gen(settings.seed);
+    std::shuffle(requests.begin(), requests.end(), gen);
+  }
+
+  McrouterOptions opts;
+  opts.config_str = buildConfig(settings);
+  opts.stats_logging_interval = 0;
+  opts.asynclog_disable = true;
+
+  auto router =
+      mcrouter::CarbonRouterInstance<MemcacheRouterInfo>::init(
+          "mcreplay", opts);
+  if (router == nullptr) {
+    LOG(ERROR) << "Failed to initialize router (invalid config?)";
+    return 1;
+  }
+  auto client = router->createClient(settings.maxOutstanding);
+
+  ReplayStats stats;
+  const size_t total = requests.size() * settings.repeat;
+  stats.remaining.store(total, std::memory_order_relaxed);
+
+  const double speed = settings.shuffle ? 0.0 : settings.speed;
+  const auto wallStart = std::chrono::steady_clock::now();
+  for (size_t pass = 0; pass < settings.repeat; ++pass) {
+    const auto passStart = std::chrono::steady_clock::now();
+    const uint64_t baseTimeUs = requests.front().capturedTimeUs;
+    for (const auto& request : requests) {
+      if (speed > 0 && request.capturedTimeUs > baseTimeUs) {
+        const auto offsetUs = static_cast<int64_t>(
+            (request.capturedTimeUs - baseTimeUs) / speed);
+        std::this_thread::sleep_until(
+            passStart + std::chrono::microseconds(offsetUs));
+      }
+      request.send(*client, stats);
+    }
+  }
+  stats.allDone.wait();
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - wallStart);
+
+  const double seconds = elapsed.count() / 1e6;
+  std::cout << folly::sformat(
+      "Replayed {} requests in {:.3f}s ({:.0f} req/s)\n",
+      total,
+      seconds,
+      total / std::max(seconds, 1e-9));
+  std::cout << folly::sformat(
+      "latency (us): p50={} p90={} p99={} p99.9={} max~{}\n",
+      stats.latencyUs.estimatePercentile(50),
+      stats.latencyUs.estimatePercentile(90),
+      stats.latencyUs.estimatePercentile(99),
+      stats.latencyUs.estimatePercentile(99.9),
+      stats.latencyUs.estimatePercentile(100));
+
+  router->shutdown();
+  mcrouter::freeAllRouters();
+  return 0;
+}
+
+} // namespace mcreplay
+} // namespace memcache
+} // namespace facebook
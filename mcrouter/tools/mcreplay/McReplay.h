@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace facebook {
+namespace memcache {
+namespace mcreplay {
+
+struct ReplaySettings {
+  /**
+   * File holding a raw ConnectionFifo stream, e.g. produced by
+   * redirecting one of mcrouter's debug fifos to a file.
+   */
+  std::string captureFile;
+
+  /**
+   * Full mcrouter config (JSON) the replayed requests are routed with.
+   * Mutually exclusive with 'server'.
+   */
+  std::string configStr;
+
+  /**
+   * host:port shortcut: replay against a single server (e.g. a
+   * standalone mcrouter over loopback).
+   */
+  std::string server;
+
+  /**
+   * Timing multiplier relative to the captured inter-request gaps.
+   * 1.0 reproduces the original timing, 2.0 replays twice as fast,
+   * 0 replays as fast as the router accepts requests.
+   */
+  double speed{0.0};
+
+  /**
+   * Replay the capture this many times back to back.
+   */
+  size_t repeat{1};
+
+  /**
+   * Seed for the deterministic shuffle; only used when 'shuffle' is set.
+   */
+  uint32_t seed{0};
+
+  /**
+   * Shuffle request order deterministically (destroys captured timing,
+   * implies speed 0).
+   */
+  bool shuffle{false};
+
+  /**
+   * Passed through to CarbonRouterClient: bounds in-flight requests.
+   * 0 means unbounded.
+   */
+  size_t maxOutstanding{1024};
+};
+
+/**
+ * Loads the capture, replays it through an in-process mcrouter instance
+ * and prints throughput and a latency histogram to stdout.
+ *
+ * @return process exit status.
+ */
+int runReplay(const ReplaySettings& settings);
+
+} // namespace mcreplay
+} // namespace memcache
+} // namespace facebook
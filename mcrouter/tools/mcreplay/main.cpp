@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2018-present, Facebook, Inc.
+ *
+ *  This source code is licensed under the MIT license found in the LICENSE
+ *  file in the root directory of this source tree.
+ *
+ */
+#include <iostream>
+
+#include <boost/program_options.hpp>
+
+#include <folly/FileUtil.h>
+#include <folly/Format.h>
+#include <folly/Singleton.h>
+
+#include "mcrouter/tools/mcreplay/McReplay.h"
+
+using namespace facebook::memcache::mcreplay;
+
+namespace {
+
+std::string getUsage(const char* binaryName) {
+  return folly::sformat(
+      "Usage: {} [OPTION]... CAPTURE_FILE\n"
+      "Replay a captured mcrouter debug-fifo stream through an "
+      "in-process mcrouter instance,\n"
+      "reporting throughput and a latency histogram.\n"
+      "The target is given either as a config file (--config) or as a "
+      "single server (--server),\n"
+      "e.g. a standalone mcrouter listening on loopback.\n",
+      binaryName);
+}
+
+ReplaySettings parseOptions(int argc, char** argv) {
+  ReplaySettings settings;
+  std::string configFile;
+
+  namespace po = boost::program_options;
+
+  po::options_description namedOpts("Allowed options");
+  namedOpts.add_options()("help,h", "Print this help message.")(
+      "config,c",
+      po::value<std::string>(&configFile),
+      "Path to the mcrouter config (JSON) used for routing the replayed "
+      "requests.")(
+      "server,s",
+      po::value<std::string>(&settings.server),
+      "host:port to replay against; shortcut for a single-server pool "
+      "config.")(
+      "speed,x",
+      po::value<double>(&settings.speed),
+      "Timing multiplier relative to the captured inter-request gaps: "
+      "1.0 reproduces the original timing, 2.0 replays twice as fast. "
+      "Default (0) replays as fast as possible.")(
+      "repeat,n",
+      po::value<size_t>(&settings.repeat),
+      "Replay the capture this many times back to back (workload "
+      "scaling).")(
+      "shuffle",
+      po::bool_switch(&settings.shuffle)->default_value(false),
+      "Shuffle the request order deterministically (see --seed); "
+      "implies --speed 0.")(
+      "seed",
+      po::value<uint32_t>(&settings.seed),
+      "Seed of the deterministic shuffle.")(
+      "max-outstanding",
+      po::value<size_t>(&settings.maxOutstanding),
+      "Bound on in-flight requests; 0 means unbounded.");
+
+  po::options_description hiddenOpts("Hidden options");
+  hiddenOpts.add_options()(
+      "capture-file",
+      po::value<std::string>(&settings.captureFile),
+      "Capture file");
+  po::positional_options_description posArgs;
+  posArgs.add("capture-file", 1);
+
+  po::options_description allOpts;
+  allOpts.add(namedOpts).add(hiddenOpts);
+
+  po::variables_map vm;
+  try {
+    po::store(
+        po::command_line_parser(argc, argv)
+            .options(allOpts)
+            .positional(posArgs)
+            .run(),
+        vm);
+    po::notify(vm);
+  } catch (const po::error& ex) {
+    std::cerr << "Invalid option: " << ex.what() << std::endl;
+    exit(1);
+  }
+
+  if (vm.count("help")) {
+    std::cout << getUsage(argv[0]) << std::endl << namedOpts << std::endl;
+    exit(0);
+  }
+
+  if (settings.captureFile.empty()) {
+    std::cerr << "Missing capture file." << std::endl
+              << getUsage(argv[0]) << std::endl;
+    exit(1);
+  }
+  if (configFile.empty() == settings.server.empty()) {
+    std::cerr << "Exactly one of --config and --server is required."
+              << std::endl;
+    exit(1);
+  }
+  if (!configFile.empty() &&
+      !folly::readFile(configFile.c_str(), settings.configStr)) {
+    std::cerr << "Cannot read config file " << configFile << std::endl;
+    exit(1);
+  }
+  if (settings.repeat == 0) {
+    settings.repeat = 1;
+  }
+
+  return settings;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  auto settings = parseOptions(argc, argv);
+  return runReplay(settings);
+}